@@ -497,8 +497,8 @@ static CVReturn displayLinkCallback(CVDisplayLinkRef displayLink,
     NSString* modelsDir = @"models/ai";
     
     // Check for required models
-    BOOL faceDetectorExists = [fm fileExistsAtPath:[modelsDir stringByAppendingPathComponent:@"face_detector.onnx"]];
-    BOOL faceMeshExists = [fm fileExistsAtPath:[modelsDir stringByAppendingPathComponent:@"face_mesh.onnx"]];
+    BOOL faceDetectorExists = [fm fileExistsAtPath:[modelsDir stringByAppendingPathComponent:@"face_detector.lnn"]];
+    BOOL faceMeshExists = [fm fileExistsAtPath:[modelsDir stringByAppendingPathComponent:@"face_mesh.lnn"]];
     
     _characterCreatorState.aiModelsReady = faceDetectorExists && faceMeshExists;
     
@@ -713,19 +713,19 @@ static CVReturn displayLinkCallback(CVDisplayLinkRef displayLink,
         if (_characterTextures.isGenerated) {
             // Skin diffuse texture
             if (!_characterTextures.skinDiffuse.pixels.empty()) {
-                mesh.diffuseTexture = _characterTextures.skinDiffuse;
+                mesh.diffuseTexture = luma::makeTexture(_characterTextures.skinDiffuse);
                 mesh.hasDiffuseTexture = true;
             }
             
             // Skin normal map
             if (!_characterTextures.skinNormal.pixels.empty()) {
-                mesh.normalTexture = _characterTextures.skinNormal;
+                mesh.normalTexture = luma::makeTexture(_characterTextures.skinNormal);
                 mesh.hasNormalTexture = true;
             }
             
             // Use roughness as specular (for now)
             if (!_characterTextures.skinRoughness.pixels.empty()) {
-                mesh.specularTexture = _characterTextures.skinRoughness;
+                mesh.specularTexture = luma::makeTexture(_characterTextures.skinRoughness);
                 mesh.hasSpecularTexture = true;
             }
             
@@ -983,12 +983,12 @@ static CVReturn displayLinkCallback(CVDisplayLinkRef displayLink,
                 // Process with AI pipeline
                 if (_character) {
                     luma::PhotoToFacePipeline::Config config;
-                    config.faceDetectorModelPath = "models/ai/face_detector.onnx";
-                    config.faceMeshModelPath = "models/ai/face_mesh.onnx";
-                    config.face3DMMModelPath = "models/ai/3dmm.onnx";
+                    config.faceDetectorModelPath = "models/ai/face_detector.lnn";
+                    config.faceMeshModelPath = "models/ai/face_mesh.lnn";
+                    config.face3DMMModelPath = "models/ai/3dmm.lnn";
                     config.extractTexture = true;
                     config.use3DMM = [[NSFileManager defaultManager] 
-                        fileExistsAtPath:@"models/ai/3dmm.onnx"];
+                        fileExistsAtPath:@"models/ai/3dmm.lnn"];
                     
                     luma::PhotoToFacePipeline pipeline;
                     pipeline.initialize(config);
@@ -1037,7 +1037,7 @@ static CVReturn displayLinkCallback(CVDisplayLinkRef displayLink,
                 NSFileManager* fm = [NSFileManager defaultManager];
                 NSString* modelsDir = @"models/ai";
                 NSString* destPath = [modelsDir stringByAppendingPathComponent:
-                    [NSString stringWithFormat:@"%s.onnx", modelId.c_str()]];
+                    [NSString stringWithFormat:@"%s.lnn", modelId.c_str()]];
                 
                 // Create directory if needed
                 [fm createDirectoryAtPath:modelsDir withIntermediateDirectories:YES attributes:nil error:nil];
@@ -1,5 +1,10 @@
 // Behavior Tree System
 // Hierarchical task execution for AI decision making
+//   - BlackboardSchema interns keys into typed slots once; BBKey<T> reads
+//     and writes are a memcpy at a fixed offset (string keys still work)
+//   - CompiledBehaviorTree flattens a BTNode tree into an array; agents keep
+//     only a small per-node state block, and BTAgentGroup ticks many agents
+//     that share one compiled tree
 #pragma once
 
 #include "engine/foundation/math_types.h"
@@ -9,6 +14,8 @@
 #include <unordered_map>
 #include <functional>
 #include <any>
+#include <cstring>
+#include <type_traits>
 
 namespace luma {
 
@@ -50,40 +57,214 @@ enum class BTNodeType {
 class BTNode;
 class BehaviorTree;
 
+// ===== Blackboard Keys =====
+// Typed handle to a schema slot; copy it into closures instead of strings
+template<typename T>
+struct BBKey {
+    static constexpr uint32_t INVALID = ~0u;
+    uint32_t slot = INVALID;
+    uint32_t offset = INVALID;    // byte offset into Blackboard storage
+    
+    bool valid() const { return slot != INVALID; }
+};
+
+// Key layout shared by all blackboards of one kind of agent. Register keys
+// before creating blackboards; only trivially copyable values get a slot.
+class BlackboardSchema {
+public:
+    // Returns the existing key if the name is already registered with the
+    // same type, an invalid key if it has another type
+    template<typename T>
+    BBKey<T> add(const std::string& name, const T& defaultValue = T()) {
+        static_assert(std::is_trivially_copyable<T>::value, "blackboard slots hold trivially copyable values");
+        static_assert(alignof(T) <= alignof(uint64_t), "blackboard slots are 8-byte aligned");
+        
+        auto it = lookup_.find(name);
+        if (it != lookup_.end()) return find<T>(name);
+        
+        uint32_t offset = (uint32_t)((storageSize_ + alignof(T) - 1) / alignof(T) * alignof(T));
+        storageSize_ = offset + sizeof(T);
+        defaults_.resize((storageSize_ + 7) / 8, 0);
+        std::memcpy(reinterpret_cast<uint8_t*>(defaults_.data()) + offset, &defaultValue, sizeof(T));
+        
+        BBKey<T> key;
+        key.slot = (uint32_t)slots_.size();
+        key.offset = offset;
+        slots_.push_back({name, typeTag<T>(), offset, (uint32_t)sizeof(T)});
+        lookup_[name] = key.slot;
+        return key;
+    }
+    
+    template<typename T>
+    BBKey<T> find(const std::string& name) const {
+        BBKey<T> key;
+        auto it = lookup_.find(name);
+        if (it != lookup_.end() && slots_[it->second].type == typeTag<T>()) {
+            key.slot = it->second;
+            key.offset = slots_[it->second].offset;
+        }
+        return key;
+    }
+    
+    size_t getKeyCount() const { return slots_.size(); }
+    size_t getStorageSize() const { return storageSize_; }
+    
+private:
+    friend class Blackboard;
+    
+    struct Slot {
+        std::string name;
+        const void* type;
+        uint32_t offset;
+        uint32_t size;
+    };
+    
+    // One address per type, used instead of RTTI
+    template<typename T>
+    static const void* typeTag() {
+        static const char tag = 0;
+        return &tag;
+    }
+    
+    std::vector<Slot> slots_;
+    std::unordered_map<std::string, uint32_t> lookup_;
+    std::vector<uint64_t> defaults_;   // initial storage of every blackboard
+    size_t storageSize_ = 0;
+};
+
 // ===== Blackboard (shared data) =====
+// Values of schema keys live in flat storage; other string keys fall back
+// to a map of std::any.
 class Blackboard {
 public:
+    Blackboard() = default;
+    explicit Blackboard(const BlackboardSchema* schema) { setSchema(schema); }
+    
+    void setSchema(const BlackboardSchema* schema) {
+        schema_ = schema;
+        storage_.clear();
+        present_.clear();
+        syncedSlots_ = 0;
+        syncSchema();
+    }
+    const BlackboardSchema* getSchema() const { return schema_; }
+    
+    // ----- Interned keys -----
+    template<typename T>
+    void set(BBKey<T> key, const T& value) {
+        if (key.slot >= syncedSlots_) {
+            syncSchema();
+            if (key.slot >= syncedSlots_) return;  // invalid key
+        }
+        std::memcpy(reinterpret_cast<uint8_t*>(storage_.data()) + key.offset, &value, sizeof(T));
+        present_[key.slot >> 6] |= 1ull << (key.slot & 63);
+    }
+    
+    // The schema default until set
+    template<typename T>
+    T get(BBKey<T> key) const {
+        T value;
+        if (key.slot < syncedSlots_) {
+            std::memcpy(&value, reinterpret_cast<const uint8_t*>(storage_.data()) + key.offset, sizeof(T));
+        } else if (schema_ && key.slot < schema_->slots_.size()) {
+            std::memcpy(&value, reinterpret_cast<const uint8_t*>(schema_->defaults_.data()) + key.offset, sizeof(T));
+        } else {
+            value = T();
+        }
+        return value;
+    }
+    
+    template<typename T>
+    bool has(BBKey<T> key) const { return isSet(key.slot); }
+    
+    template<typename T>
+    void remove(BBKey<T> key) { clearSlot(key.slot); }
+    
+    // ----- String keys (schema slot when name and type match) -----
     template<typename T>
     void set(const std::string& key, const T& value) {
+        if constexpr (std::is_trivially_copyable<T>::value && alignof(T) <= alignof(uint64_t)) {
+            if (schema_) {
+                BBKey<T> slot = schema_->find<T>(key);
+                if (slot.valid()) {
+                    set(slot, value);
+                    return;
+                }
+            }
+        }
         data_[key] = value;
     }
     
     template<typename T>
     T get(const std::string& key, const T& defaultValue = T()) const {
+        if constexpr (std::is_trivially_copyable<T>::value && alignof(T) <= alignof(uint64_t)) {
+            if (schema_) {
+                BBKey<T> slot = schema_->find<T>(key);
+                if (slot.valid()) return has(slot) ? get(slot) : defaultValue;
+            }
+        }
         auto it = data_.find(key);
         if (it != data_.end()) {
-            try {
-                return std::any_cast<T>(it->second);
-            } catch (...) {
-                return defaultValue;
-            }
+            if (const T* value = std::any_cast<T>(&it->second)) return *value;
         }
         return defaultValue;
     }
     
     bool has(const std::string& key) const {
+        if (schema_) {
+            auto it = schema_->lookup_.find(key);
+            if (it != schema_->lookup_.end() && isSet(it->second)) return true;
+        }
         return data_.find(key) != data_.end();
     }
     
     void remove(const std::string& key) {
+        if (schema_) {
+            auto it = schema_->lookup_.find(key);
+            if (it != schema_->lookup_.end()) clearSlot(it->second);
+        }
         data_.erase(key);
     }
     
     void clear() {
         data_.clear();
+        storage_.clear();
+        present_.clear();
+        syncedSlots_ = 0;
+        syncSchema();
     }
     
 private:
+    bool isSet(uint32_t slot) const {
+        return (slot >> 6) < present_.size() && (present_[slot >> 6] >> (slot & 63)) & 1;
+    }
+    
+    // Unsets a slot and restores its default value
+    void clearSlot(uint32_t slot) {
+        if (!isSet(slot)) return;  // also rules out unsynced slots
+        present_[slot >> 6] &= ~(1ull << (slot & 63));
+        const BlackboardSchema::Slot& info = schema_->slots_[slot];
+        std::memcpy(reinterpret_cast<uint8_t*>(storage_.data()) + info.offset,
+                    reinterpret_cast<const uint8_t*>(schema_->defaults_.data()) + info.offset, info.size);
+    }
+    
+    // Picks up keys added to the schema after this blackboard was created
+    void syncSchema() {
+        if (!schema_) return;
+        storage_.resize(schema_->defaults_.size(), 0);
+        for (size_t i = syncedSlots_; i < schema_->slots_.size(); i++) {
+            const BlackboardSchema::Slot& info = schema_->slots_[i];
+            std::memcpy(reinterpret_cast<uint8_t*>(storage_.data()) + info.offset,
+                        reinterpret_cast<const uint8_t*>(schema_->defaults_.data()) + info.offset, info.size);
+        }
+        syncedSlots_ = schema_->slots_.size();
+        present_.resize((syncedSlots_ + 63) / 64, 0);
+    }
+    
+    const BlackboardSchema* schema_ = nullptr;
+    std::vector<uint64_t> storage_;
+    std::vector<uint64_t> present_;   // one bit per schema slot
+    size_t syncedSlots_ = 0;          // schema slots with storage here
     std::unordered_map<std::string, std::any> data_;
 };
 
@@ -239,6 +420,9 @@ public:
         : BTNode(BTNodeType::Parallel, name),
           successPolicy_(successPolicy), failurePolicy_(failurePolicy) {}
     
+    Policy getSuccessPolicy() const { return successPolicy_; }
+    Policy getFailurePolicy() const { return failurePolicy_; }
+    
     BTStatus update(BTContext& context) override {
         int successCount = 0;
         int failureCount = 0;
@@ -335,6 +519,8 @@ public:
     BTRepeater(int count = -1, const std::string& name = "Repeater")
         : BTNode(BTNodeType::Repeater, name), targetCount_(count) {}
     
+    int getCount() const { return targetCount_; }
+    
     void initialize(BTContext& context) override {
         currentCount_ = 0;
         BTNode::initialize(context);
@@ -372,6 +558,8 @@ public:
     BTLimiter(int limit, const std::string& name = "Limiter")
         : BTNode(BTNodeType::Limiter, name), limit_(limit) {}
     
+    int getLimit() const { return limit_; }
+    
     BTStatus update(BTContext& context) override {
         if (runCount_ >= limit_) return BTStatus::Failure;
         if (children_.empty()) return BTStatus::Success;
@@ -405,6 +593,8 @@ public:
     BTAction(ActionFunc func, const std::string& name = "Action")
         : BTNode(BTNodeType::Action, name), action_(func) {}
     
+    const ActionFunc& getFunction() const { return action_; }
+    
     BTStatus update(BTContext& context) override {
         if (action_) {
             return action_(context);
@@ -424,6 +614,8 @@ public:
     BTCondition(ConditionFunc func, const std::string& name = "Condition")
         : BTNode(BTNodeType::Condition, name), condition_(func) {}
     
+    const ConditionFunc& getFunction() const { return condition_; }
+    
     BTStatus update(BTContext& context) override {
         if (condition_) {
             return condition_(context) ? BTStatus::Success : BTStatus::Failure;
@@ -441,6 +633,8 @@ public:
     BTWait(float duration, const std::string& name = "Wait")
         : BTNode(BTNodeType::Wait, name), duration_(duration) {}
     
+    float getDuration() const { return duration_; }
+    
     void initialize(BTContext& context) override {
         elapsed_ = 0.0f;
         BTNode::initialize(context);
@@ -609,6 +803,337 @@ private:
     std::vector<std::unique_ptr<BTNode>> stack_;
 };
 
+// ===== Compiled Behavior Tree =====
+// Running state of one node for one agent
+struct BTNodeState {
+    BTStatus status = BTStatus::Invalid;
+    int32_t counter = 0;    // current child, repeat/run count or picked child
+    float timer = 0.0f;     // Wait elapsed time
+};
+
+// Read-only, flattened copy of a tree built from the stock node classes.
+// Nodes sit in pre-order; all running state lives in caller-owned
+// BTNodeState arrays (getNodeCount() entries per agent), so one compiled
+// tree serves any number of agents. Ticks behave like BTNode::tick.
+class CompiledBehaviorTree {
+public:
+    // Fails on custom node classes, which can't be flattened
+    bool compile(const BTNode* root);
+    
+    size_t getNodeCount() const { return nodes_.size(); }
+    bool empty() const { return nodes_.empty(); }
+    
+    BTStatus tick(BTNodeState* state, BTContext& context) const {
+        return nodes_.empty() ? BTStatus::Invalid : tickNode(0, state, context);
+    }
+    // Same as BTNode::reset on the root
+    void reset(BTNodeState* state) const {
+        if (!nodes_.empty()) resetNode(0, state);
+    }
+    
+    const std::string& getLastError() const { return lastError_; }
+    
+private:
+    struct Node {
+        BTNodeType type;
+        uint32_t end;          // one past the last node of the subtree
+        uint32_t childCount;
+        int32_t param;         // Repeater count, Limiter limit
+        float duration;        // Wait
+        uint32_t function;     // index into actions_ / conditions_
+        BTParallel::Policy successPolicy, failurePolicy;
+    };
+    
+    bool flatten(const BTNode* node);
+    BTStatus tickNode(uint32_t index, BTNodeState* state, BTContext& context) const;
+    void resetNode(uint32_t index, BTNodeState* state) const;
+    
+    std::vector<Node> nodes_;
+    std::vector<BTAction::ActionFunc> actions_;
+    std::vector<BTCondition::ConditionFunc> conditions_;
+    std::string lastError_;
+};
+
+inline bool CompiledBehaviorTree::compile(const BTNode* root) {
+    nodes_.clear();
+    actions_.clear();
+    conditions_.clear();
+    if (!root) {
+        lastError_ = "no root node";
+        return false;
+    }
+    if (!flatten(root)) {
+        nodes_.clear();
+        actions_.clear();
+        conditions_.clear();
+        return false;
+    }
+    return true;
+}
+
+inline bool CompiledBehaviorTree::flatten(const BTNode* node) {
+    uint32_t index = (uint32_t)nodes_.size();
+    Node flat = {};
+    flat.type = node->getType();
+    flat.childCount = (uint32_t)node->getChildCount();
+    
+    // The node type must come with the stock class, whose parameters we copy
+    bool stock = false;
+    switch (flat.type) {
+        case BTNodeType::Sequence: stock = dynamic_cast<const BTSequence*>(node) != nullptr; break;
+        case BTNodeType::Selector: stock = dynamic_cast<const BTSelector*>(node) != nullptr; break;
+        case BTNodeType::RandomSelector: stock = dynamic_cast<const BTRandomSelector*>(node) != nullptr; break;
+        case BTNodeType::Inverter: stock = dynamic_cast<const BTInverter*>(node) != nullptr; break;
+        case BTNodeType::Succeeder: stock = dynamic_cast<const BTSucceeder*>(node) != nullptr; break;
+        case BTNodeType::Log: stock = dynamic_cast<const BTLog*>(node) != nullptr; break;
+        case BTNodeType::Parallel:
+            if (auto* parallel = dynamic_cast<const BTParallel*>(node)) {
+                flat.successPolicy = parallel->getSuccessPolicy();
+                flat.failurePolicy = parallel->getFailurePolicy();
+                stock = true;
+            }
+            break;
+        case BTNodeType::Repeater:
+            if (auto* repeater = dynamic_cast<const BTRepeater*>(node)) {
+                flat.param = repeater->getCount();
+                stock = true;
+            }
+            break;
+        case BTNodeType::Limiter:
+            if (auto* limiter = dynamic_cast<const BTLimiter*>(node)) {
+                flat.param = limiter->getLimit();
+                stock = true;
+            }
+            break;
+        case BTNodeType::Wait:
+            if (auto* wait = dynamic_cast<const BTWait*>(node)) {
+                flat.duration = wait->getDuration();
+                stock = true;
+            }
+            break;
+        case BTNodeType::Action:
+            if (auto* action = dynamic_cast<const BTAction*>(node)) {
+                flat.function = (uint32_t)actions_.size();
+                actions_.push_back(action->getFunction());
+                stock = true;
+            }
+            break;
+        case BTNodeType::Condition:
+            if (auto* condition = dynamic_cast<const BTCondition*>(node)) {
+                flat.function = (uint32_t)conditions_.size();
+                conditions_.push_back(condition->getFunction());
+                stock = true;
+            }
+            break;
+        default:
+            break;
+    }
+    if (!stock) {
+        lastError_ = "can't compile custom node '" + node->getName() + "'";
+        return false;
+    }
+    
+    nodes_.push_back(flat);
+    for (const auto& child : node->getChildren()) {
+        if (!flatten(child.get())) return false;
+    }
+    nodes_[index].end = (uint32_t)nodes_.size();
+    return true;
+}
+
+inline BTStatus CompiledBehaviorTree::tickNode(uint32_t index, BTNodeState* state, BTContext& context) const {
+    const Node& node = nodes_[index];
+    BTNodeState& self = state[index];
+    const uint32_t first = index + 1;
+    
+    // initialize()
+    if (self.status != BTStatus::Running) {
+        switch (node.type) {
+            case BTNodeType::Sequence:
+            case BTNodeType::Selector: self.counter = (int32_t)first; break;
+            case BTNodeType::RandomSelector: if (node.childCount) self.counter = rand() % node.childCount; break;
+            case BTNodeType::Repeater: self.counter = 0; break;
+            case BTNodeType::Wait: self.timer = 0.0f; break;
+            default: break;
+        }
+    }
+    
+    // update()
+    BTStatus status = BTStatus::Failure;
+    switch (node.type) {
+        case BTNodeType::Sequence:
+        case BTNodeType::Selector: {
+            // Sequence stops on the first non-success, Selector on the first non-failure
+            const BTStatus pass = node.type == BTNodeType::Sequence ? BTStatus::Success : BTStatus::Failure;
+            status = pass;
+            while ((uint32_t)self.counter < node.end) {
+                BTStatus child = tickNode((uint32_t)self.counter, state, context);
+                if (child != pass) {
+                    status = child;
+                    break;
+                }
+                self.counter = (int32_t)nodes_[self.counter].end;
+            }
+            break;
+        }
+        case BTNodeType::Parallel: {
+            uint32_t successCount = 0, failureCount = 0;
+            for (uint32_t child = first; child < node.end; child = nodes_[child].end) {
+                BTStatus result = tickNode(child, state, context);
+                if (result == BTStatus::Success) successCount++;
+                else if (result == BTStatus::Failure) failureCount++;
+            }
+            using Policy = BTParallel::Policy;
+            if ((node.failurePolicy == Policy::RequireOne && failureCount > 0) ||
+                (node.failurePolicy == Policy::RequireAll && failureCount == node.childCount)) {
+                status = BTStatus::Failure;
+            } else if ((node.successPolicy == Policy::RequireOne && successCount > 0) ||
+                       (node.successPolicy == Policy::RequireAll && successCount == node.childCount)) {
+                status = BTStatus::Success;
+            } else {
+                status = BTStatus::Running;
+            }
+            break;
+        }
+        case BTNodeType::RandomSelector:
+            if ((uint32_t)self.counter < node.childCount) {
+                uint32_t child = first;
+                for (int32_t i = 0; i < self.counter; i++) child = nodes_[child].end;
+                status = tickNode(child, state, context);
+            }
+            break;
+        case BTNodeType::Inverter:
+            if (node.childCount) {
+                status = tickNode(first, state, context);
+                if (status == BTStatus::Success) status = BTStatus::Failure;
+                else if (status == BTStatus::Failure) status = BTStatus::Success;
+            }
+            break;
+        case BTNodeType::Succeeder:
+            if (node.childCount) tickNode(first, state, context);
+            status = BTStatus::Success;
+            break;
+        case BTNodeType::Repeater:
+            status = BTStatus::Success;
+            if (!node.childCount) break;
+            while (node.param < 0 || self.counter < node.param) {
+                BTStatus child = tickNode(first, state, context);
+                if (child != BTStatus::Success) {
+                    status = child;
+                    break;
+                }
+                self.counter++;
+                resetNode(first, state);
+            }
+            break;
+        case BTNodeType::Limiter:
+            if (self.counter >= node.param) break;
+            status = BTStatus::Success;
+            if (!node.childCount) break;
+            status = tickNode(first, state, context);
+            if (status != BTStatus::Running) self.counter++;
+            break;
+        case BTNodeType::Action:
+            if (actions_[node.function]) status = actions_[node.function](context);
+            break;
+        case BTNodeType::Condition:
+            if (conditions_[node.function]) {
+                status = conditions_[node.function](context) ? BTStatus::Success : BTStatus::Failure;
+            }
+            break;
+        case BTNodeType::Wait:
+            self.timer += context.deltaTime;
+            status = self.timer >= node.duration ? BTStatus::Success : BTStatus::Running;
+            break;
+        case BTNodeType::Log:
+            status = BTStatus::Success;
+            break;
+        default:
+            break;
+    }
+    
+    self.status = status;
+    return status;
+}
+
+inline void CompiledBehaviorTree::resetNode(uint32_t index, BTNodeState* state) const {
+    const Node& node = nodes_[index];
+    state[index].status = BTStatus::Invalid;
+    if (node.type == BTNodeType::Limiter) {
+        state[index].counter = 0;
+    } else if (node.type == BTNodeType::Sequence || node.type == BTNodeType::Selector) {
+        for (uint32_t child = index + 1; child < node.end; child = nodes_[child].end) {
+            resetNode(child, state);
+        }
+    }
+}
+
+// ===== BT Agent Group =====
+// Agents running the same compiled tree; node states are stored back to
+// back so a tick walks one contiguous array
+class BTAgentGroup {
+public:
+    explicit BTAgentGroup(const CompiledBehaviorTree* tree = nullptr) : tree_(tree) {}
+    
+    // Restarts every agent
+    void setTree(const CompiledBehaviorTree* tree) {
+        tree_ = tree;
+        states_.assign(contexts_.size() * nodeCount(), BTNodeState());
+        std::fill(statuses_.begin(), statuses_.end(), BTStatus::Invalid);
+    }
+    const CompiledBehaviorTree* getTree() const { return tree_; }
+    
+    size_t addAgent(Blackboard* blackboard, void* owner = nullptr) {
+        BTContext context;
+        context.blackboard = blackboard;
+        context.owner = owner;
+        contexts_.push_back(context);
+        statuses_.push_back(BTStatus::Invalid);
+        states_.resize(contexts_.size() * nodeCount());
+        return contexts_.size() - 1;
+    }
+    
+    // Moves the last agent into the freed index
+    void removeAgent(size_t index) {
+        if (index >= contexts_.size()) return;
+        size_t last = contexts_.size() - 1;
+        size_t nodes = nodeCount();
+        contexts_[index] = contexts_[last];
+        statuses_[index] = statuses_[last];
+        std::copy(states_.begin() + last * nodes, states_.begin() + (last + 1) * nodes, states_.begin() + index * nodes);
+        contexts_.pop_back();
+        statuses_.pop_back();
+        states_.resize(last * nodes);
+    }
+    
+    size_t getAgentCount() const { return contexts_.size(); }
+    // Update ownerPosition etc. here before tick()
+    BTContext& getContext(size_t index) { return contexts_[index]; }
+    BTStatus getStatus(size_t index) const { return statuses_[index]; }
+    
+    void resetAgent(size_t index) {
+        if (tree_) tree_->reset(&states_[index * nodeCount()]);
+        statuses_[index] = BTStatus::Invalid;
+    }
+    
+    void tick(float dt) {
+        if (!tree_ || tree_->empty()) return;
+        size_t nodes = nodeCount();
+        for (size_t i = 0; i < contexts_.size(); i++) {
+            contexts_[i].deltaTime = dt;
+            statuses_[i] = tree_->tick(&states_[i * nodes], contexts_[i]);
+        }
+    }
+    
+private:
+    size_t nodeCount() const { return tree_ ? tree_->getNodeCount() : 0; }
+    
+    const CompiledBehaviorTree* tree_;
+    std::vector<BTContext> contexts_;
+    std::vector<BTNodeState> states_;
+    std::vector<BTStatus> statuses_;
+};
+
 // ===== Common AI Actions =====
 namespace BTActions {
     // Move to position stored in blackboard
@@ -654,6 +1179,36 @@ namespace BTActions {
             return BTStatus::Success;
         };
     }
+    
+    // ----- Interned-key versions -----
+    inline BTAction::ActionFunc moveTo(BBKey<Vec3> targetKey) {
+        return [targetKey](BTContext& ctx) -> BTStatus {
+            if (!ctx.blackboard->has(targetKey)) return BTStatus::Failure;
+            float dist = (ctx.blackboard->get(targetKey) - ctx.ownerPosition).length();
+            return dist < 0.5f ? BTStatus::Success : BTStatus::Running;
+        };
+    }
+    
+    inline BTCondition::ConditionFunc inRange(BBKey<Vec3> targetKey, float range) {
+        return [targetKey, range](BTContext& ctx) -> bool {
+            if (!ctx.blackboard->has(targetKey)) return false;
+            return (ctx.blackboard->get(targetKey) - ctx.ownerPosition).length() <= range;
+        };
+    }
+    
+    inline BTCondition::ConditionFunc checkBool(BBKey<bool> key, bool expected = true) {
+        return [key, expected](BTContext& ctx) -> bool {
+            return ctx.blackboard->has(key) && ctx.blackboard->get(key) == expected;
+        };
+    }
+    
+    template<typename T>
+    inline BTAction::ActionFunc setValue(BBKey<T> key, const T& value) {
+        return [key, value](BTContext& ctx) -> BTStatus {
+            ctx.blackboard->set(key, value);
+            return BTStatus::Success;
+        };
+    }
 }
 
 }  // namespace luma
@@ -0,0 +1,484 @@
+// Crowd - many navigation agents simulated together
+// Agents are stored SoA and addressed by stable ids (slot + generation).
+// Per update:
+//   1. up to maxPathRequestsPerTick queued path requests are solved (FIFO),
+//      or handed to a NavPathQueryService and collected when done
+//   2. a spatial hash over agent XZ positions is rebuilt
+//   3. parallel: preferred velocity from the path corner, nearest neighbors
+//      from the hash, ORCA velocity, acceleration limit
+//   4. parallel: integrate, advance corners, detect arrival
+#pragma once
+
+#include "nav_agent.h"
+#include "path_query.h"
+#include "rvo.h"
+#include "engine/foundation/worker_pool.h"
+#include <chrono>
+#include <deque>
+
+namespace luma {
+
+// ===== Crowd Settings =====
+struct CrowdSettings {
+    int maxNeighbors = 10;               // <= RVO_MAX_NEIGHBORS
+    float timeHorizon = 1.0f;            // seconds of lookahead for agent avoidance
+    int maxPathRequestsPerTick = 32;     // the rest wait in the queue
+    int threads = 0;                     // 0 = hardware concurrency
+};
+
+struct CrowdStats {
+    double updateMs = 0.0;
+    double pathMs = 0.0;
+    double gridMs = 0.0;
+    double avoidanceMs = 0.0;            // steering + neighbors + ORCA
+    double integrateMs = 0.0;
+    size_t agents = 0;
+    size_t pathsSolved = 0;              // this update
+    size_t pathsQueued = 0;              // still waiting after this update
+    int threads = 1;
+};
+
+// ===== Crowd =====
+class Crowd {
+public:
+    using AgentId = uint32_t;
+    static constexpr AgentId INVALID_AGENT = ~0u;
+
+    explicit Crowd(const CrowdSettings& settings = {}) : settings_(settings), pool_(settings.threads) {
+        settings_.maxNeighbors = std::max(1, std::min(settings_.maxNeighbors, RVO_MAX_NEIGHBORS));
+    }
+
+    ~Crowd() {
+        for (const auto& entry : inFlight_) pathQueries_->cancel(entry.second);
+    }
+
+    Crowd(const Crowd&) = delete;
+    Crowd& operator=(const Crowd&) = delete;
+
+    // nullptr: agents steer straight at their destination
+    void setNavMesh(const NavMesh* navMesh) { navMesh_ = navMesh; }
+    // Solve paths through a query service (cache, clusters, workers) rather
+    // than inline. The service must use the same mesh and outlive the crowd;
+    // its owner keeps calling its update() when it has no worker threads.
+    void setPathQueryService(NavPathQueryService* service);
+    void setMaxPathRequestsPerTick(int count) { settings_.maxPathRequestsPerTick = std::max(1, count); }
+
+    // Agents
+    AgentId addAgent(const Vec3& position, const NavAgentSettings& settings = {});
+    void removeAgent(AgentId id);
+    bool isValid(AgentId id) const { return denseIndex(id) != INVALID_AGENT; }
+    size_t getAgentCount() const { return ids_.size(); }
+    void clear();
+
+    // Queues a path request; the agent waits until it is solved
+    bool setDestination(AgentId id, const Vec3& destination);
+    void stop(AgentId id);
+    void setPosition(AgentId id, const Vec3& position);
+
+    Vec3 getPosition(AgentId id) const;
+    Vec3 getVelocity(AgentId id) const;
+    NavAgentState getState(AgentId id) const;
+    Vec3 getDestination(AgentId id) const;
+
+    void update(float dt);
+
+    const CrowdStats& getStats() const { return stats_; }
+    size_t getPendingPathRequests() const { return pathQueue_.size() + inFlight_.size(); }
+    int getThreadCount() const { return pool_.getThreadCount(); }
+
+private:
+    static constexpr uint32_t kSlotBits = 22;
+    static constexpr uint32_t kSlotMask = (1u << kSlotBits) - 1;
+
+    uint32_t denseIndex(AgentId id) const {
+        uint32_t slot = id & kSlotMask;
+        if (id == INVALID_AGENT || slot >= slotDense_.size() || slotGeneration_[slot] != (id >> kSlotBits)) {
+            return INVALID_AGENT;
+        }
+        return slotDense_[slot];
+    }
+
+    void solvePathRequests();
+    void collectPathQueries();
+    void applyPath(uint32_t index, const NavPath* path);
+    void steerAndAvoid(size_t begin, size_t end, float dt);
+    void integrate(size_t begin, size_t end, float dt);
+
+    struct AgentPath {
+        std::vector<Vec3> corners;
+        uint32_t next = 0;
+    };
+
+    CrowdSettings settings_;
+    const NavMesh* navMesh_ = nullptr;
+
+    // Dense SoA, index = dense agent index
+    std::vector<AgentId> ids_;
+    std::vector<float> px_, py_, pz_;        // position
+    std::vector<float> vx_, vz_;             // velocity
+    std::vector<float> nvx_, nvz_;           // velocity chosen this update
+    std::vector<float> radius_, speed_, acceleration_, stoppingDistance_, neighborDistance_;
+    std::vector<int> priority_;
+    std::vector<uint8_t> avoid_;
+    std::vector<uint8_t> state_;             // NavAgentState
+    std::vector<uint8_t> pathPending_;
+    std::vector<NavPathQueryService::QueryId> pathQuery_;  // query the agent waits for
+    std::vector<Vec3> destination_;
+    std::vector<AgentPath> paths_;
+
+    // Id slots
+    std::vector<uint32_t> slotDense_;
+    std::vector<uint32_t> slotGeneration_;
+    std::vector<uint32_t> freeSlots_;
+
+    std::deque<AgentId> pathQueue_;
+    NavPathQueryService* pathQueries_ = nullptr;
+    std::vector<std::pair<AgentId, NavPathQueryService::QueryId>> inFlight_;
+    NavPathfinder pathfinder_{nullptr};  // keeps its node pool between ticks
+    NavPath pathScratch_;
+    SpatialHashGrid grid_;
+    float maxNeighborDistance_ = 1.0f;
+    uint32_t tick_ = 0;
+    CrowdStats stats_;
+
+    WorkerPool pool_;
+};
+
+// ===== Crowd Implementation =====
+
+inline Crowd::AgentId Crowd::addAgent(const Vec3& position, const NavAgentSettings& settings) {
+    uint32_t slot;
+    if (!freeSlots_.empty()) {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        if (slotDense_.size() >= kSlotMask) return INVALID_AGENT;  // kSlotMask is never a slot
+        slot = (uint32_t)slotDense_.size();
+        slotDense_.push_back(INVALID_AGENT);
+        slotGeneration_.push_back(0);
+    }
+    AgentId id = (slotGeneration_[slot] << kSlotBits) | slot;
+    slotDense_[slot] = (uint32_t)ids_.size();
+
+    ids_.push_back(id);
+    px_.push_back(position.x);
+    py_.push_back(position.y);
+    pz_.push_back(position.z);
+    vx_.push_back(0.0f);
+    vz_.push_back(0.0f);
+    nvx_.push_back(0.0f);
+    nvz_.push_back(0.0f);
+    radius_.push_back(settings.avoidanceRadius);
+    speed_.push_back(settings.speed);
+    acceleration_.push_back(settings.acceleration);
+    stoppingDistance_.push_back(settings.stoppingDistance);
+    // Anything that could reach us within the time horizon
+    neighborDistance_.push_back(settings.avoidanceRadius * 2.0f + settings.speed * settings_.timeHorizon);
+    priority_.push_back(settings.avoidancePriority);
+    avoid_.push_back(settings.avoidObstacles ? 1 : 0);
+    state_.push_back((uint8_t)NavAgentState::Idle);
+    pathPending_.push_back(0);
+    pathQuery_.push_back(NavPathQueryService::INVALID_QUERY);
+    destination_.push_back(position);
+    paths_.emplace_back();
+    return id;
+}
+
+inline void Crowd::removeAgent(AgentId id) {
+    uint32_t index = denseIndex(id);
+    if (index == INVALID_AGENT) return;
+    uint32_t last = (uint32_t)ids_.size() - 1;
+    uint32_t slot = id & kSlotMask;
+    slotDense_[slot] = INVALID_AGENT;
+    slotGeneration_[slot] = (slotGeneration_[slot] + 1) & (~0u >> kSlotBits);
+    freeSlots_.push_back(slot);
+
+    // Swap-remove keeps the arrays dense
+    auto move = [&](auto& v) {
+        if (index != last) v[index] = std::move(v[last]);
+        v.pop_back();
+    };
+    if (index != last) slotDense_[ids_[last] & kSlotMask] = index;
+    move(ids_); move(px_); move(py_); move(pz_); move(vx_); move(vz_); move(nvx_); move(nvz_);
+    move(radius_); move(speed_); move(acceleration_); move(stoppingDistance_); move(neighborDistance_);
+    move(priority_); move(avoid_); move(state_); move(pathPending_); move(pathQuery_);
+    move(destination_); move(paths_);
+    // Its queued path request is skipped when popped
+}
+
+inline void Crowd::clear() {
+    while (!ids_.empty()) removeAgent(ids_.back());
+    pathQueue_.clear();
+    for (const auto& entry : inFlight_) pathQueries_->cancel(entry.second);
+    inFlight_.clear();
+}
+
+inline void Crowd::setPathQueryService(NavPathQueryService* service) {
+    if (service == pathQueries_) return;
+    // Requests in flight go back to the queue
+    for (const auto& entry : inFlight_) {
+        pathQueries_->cancel(entry.second);
+        uint32_t index = denseIndex(entry.first);
+        if (index == INVALID_AGENT || pathQuery_[index] != entry.second) continue;
+        pathQuery_[index] = NavPathQueryService::INVALID_QUERY;
+        if (state_[index] == (uint8_t)NavAgentState::Waiting && !pathPending_[index]) {
+            pathPending_[index] = 1;
+            pathQueue_.push_front(entry.first);
+        }
+    }
+    inFlight_.clear();
+    pathQueries_ = service;
+}
+
+inline bool Crowd::setDestination(AgentId id, const Vec3& destination) {
+    uint32_t index = denseIndex(id);
+    if (index == INVALID_AGENT) return false;
+    destination_[index] = destination;
+    state_[index] = (uint8_t)NavAgentState::Waiting;
+    if (!pathPending_[index]) {
+        pathPending_[index] = 1;
+        pathQueue_.push_back(id);
+    }
+    return true;
+}
+
+inline void Crowd::stop(AgentId id) {
+    uint32_t index = denseIndex(id);
+    if (index == INVALID_AGENT) return;
+    state_[index] = (uint8_t)NavAgentState::Idle;
+    paths_[index].corners.clear();
+    vx_[index] = vz_[index] = 0.0f;
+}
+
+inline void Crowd::setPosition(AgentId id, const Vec3& position) {
+    uint32_t index = denseIndex(id);
+    if (index == INVALID_AGENT) return;
+    px_[index] = position.x;
+    py_[index] = position.y;
+    pz_[index] = position.z;
+}
+
+inline Vec3 Crowd::getPosition(AgentId id) const {
+    uint32_t index = denseIndex(id);
+    return index == INVALID_AGENT ? Vec3(0, 0, 0) : Vec3(px_[index], py_[index], pz_[index]);
+}
+
+inline Vec3 Crowd::getVelocity(AgentId id) const {
+    uint32_t index = denseIndex(id);
+    return index == INVALID_AGENT ? Vec3(0, 0, 0) : Vec3(vx_[index], 0.0f, vz_[index]);
+}
+
+inline NavAgentState Crowd::getState(AgentId id) const {
+    uint32_t index = denseIndex(id);
+    return index == INVALID_AGENT ? NavAgentState::Idle : (NavAgentState)state_[index];
+}
+
+inline Vec3 Crowd::getDestination(AgentId id) const {
+    uint32_t index = denseIndex(id);
+    return index == INVALID_AGENT ? Vec3(0, 0, 0) : destination_[index];
+}
+
+inline void Crowd::solvePathRequests() {
+    stats_.pathsSolved = 0;
+    const bool useService = pathQueries_ && navMesh_ && navMesh_->isValid();
+    if (useService) collectPathQueries();
+    pathfinder_.setNavMesh(navMesh_);
+    size_t handled = 0;
+    while (!pathQueue_.empty() && handled < (size_t)settings_.maxPathRequestsPerTick) {
+        AgentId id = pathQueue_.front();
+        pathQueue_.pop_front();
+        uint32_t index = denseIndex(id);
+        if (index == INVALID_AGENT || !pathPending_[index]) continue;
+        pathPending_[index] = 0;
+        if (state_[index] != (uint8_t)NavAgentState::Waiting) continue;  // stopped meanwhile
+        handled++;
+
+        Vec3 start(px_[index], py_[index], pz_[index]);
+        if (useService) {
+            // Supersedes any query still in flight for this agent
+            NavPathQueryService::QueryId query = pathQueries_->request(start, destination_[index]);
+            pathQuery_[index] = query;
+            inFlight_.push_back({id, query});
+            continue;
+        }
+        stats_.pathsSolved++;
+        if (!navMesh_ || !navMesh_->isValid()) {
+            applyPath(index, nullptr);
+        } else {
+            pathfinder_.findPath(start, destination_[index], pathScratch_);
+            applyPath(index, &pathScratch_);
+        }
+    }
+    stats_.pathsQueued = pathQueue_.size() + inFlight_.size();
+}
+
+inline void Crowd::collectPathQueries() {
+    for (size_t i = 0; i < inFlight_.size();) {
+        auto [id, query] = inFlight_[i];
+        uint32_t index = denseIndex(id);
+        bool current = index != INVALID_AGENT && pathQuery_[index] == query;
+        if (current && !pathQueries_->takeResult(query, pathScratch_)) {
+            i++;  // still running
+            continue;
+        }
+        if (!current) pathQueries_->cancel(query);  // agent removed or re-targeted
+        inFlight_[i] = inFlight_.back();
+        inFlight_.pop_back();
+        if (!current) continue;
+        pathQuery_[index] = NavPathQueryService::INVALID_QUERY;
+        if (state_[index] != (uint8_t)NavAgentState::Waiting) continue;
+        stats_.pathsSolved++;
+        applyPath(index, &pathScratch_);
+    }
+}
+
+// path == nullptr: no navmesh, head straight for the destination
+inline void Crowd::applyPath(uint32_t index, const NavPath* path) {
+    AgentPath& agentPath = paths_[index];
+    agentPath.corners.clear();
+    agentPath.next = 0;
+    if (!path) {
+        agentPath.corners.push_back(destination_[index]);
+    } else if (path->valid) {
+        // The first point is the start position
+        for (size_t p = 1; p < path->points.size(); p++) agentPath.corners.push_back(path->points[p].position);
+    }
+    state_[index] = (uint8_t)(agentPath.corners.empty() ? NavAgentState::Stuck : NavAgentState::Moving);
+}
+
+inline void Crowd::steerAndAvoid(size_t begin, size_t end, float dt) {
+    const int maxNeighbors = settings_.maxNeighbors;
+    for (size_t i = begin; i < end; i++) {
+        // Preferred velocity towards the current corner
+        Vec2 preferred(0.0f, 0.0f);
+        if (state_[i] == (uint8_t)NavAgentState::Moving) {
+            AgentPath& path = paths_[i];
+            const float cornerRadius = std::max(stoppingDistance_[i], radius_[i]);
+            while (path.next + 1 < path.corners.size()) {
+                const Vec3& c = path.corners[path.next];
+                float dx = c.x - px_[i], dz = c.z - pz_[i];
+                if (dx * dx + dz * dz > cornerRadius * cornerRadius) break;
+                path.next++;
+            }
+            const Vec3& corner = path.corners[path.next];
+            Vec2 toCorner(corner.x - px_[i], corner.z - pz_[i]);
+            float distance = toCorner.length();
+            float speed = speed_[i];
+            // Slow down over the braking distance (at least two radii) along
+            // the rest of the path; sqrt keeps the deceleration constant
+            float braking = speed * speed / (2.0f * std::max(acceleration_[i], NAV_EPSILON));
+            float slowDown = std::max(std::max(radius_[i] * 2.0f, stoppingDistance_[i]), braking);
+            const Vec3& goal = path.corners.back();
+            float gx = goal.x - px_[i], gz = goal.z - pz_[i];
+            if (gx * gx + gz * gz < slowDown * slowDown) {
+                float remaining = distance;
+                for (size_t c = path.next + 1; c < path.corners.size(); c++) {
+                    remaining += (path.corners[c] - path.corners[c - 1]).length();
+                }
+                if (remaining < slowDown) speed *= std::sqrt(remaining / slowDown);
+            }
+            if (distance > NAV_EPSILON) preferred = toCorner * (speed / distance);
+            // Tiny deterministic jitter; perfectly symmetric crowds
+            // otherwise settle into a jam where every agent blocks another
+            uint32_t h = (ids_[i] ^ (tick_ * 0x9E3779B9u)) * 0x85EBCA6Bu;
+            h ^= h >> 13;
+            h *= 0xC2B2AE35u;
+            float angle = (float)(h & 0xFFFF) * (6.2831853f / 65536.0f);
+            preferred = preferred + Vec2(std::cos(angle), std::sin(angle)) * (speed * 0.01f);
+        }
+
+        Vec2 chosen = preferred;
+        if (avoid_[i]) {
+            RVONeighborList neighbors;
+            neighbors.capacity = maxNeighbors;
+            const float range = neighborDistance_[i];
+            const float rangeSq = range * range;
+            const float x = px_[i], z = pz_[i];
+            grid_.query(x, z, range, [&](uint32_t j) {
+                if (j == i) return;
+                float dx = px_[j] - x, dz = pz_[j] - z;
+                float distSq = dx * dx + dz * dz;
+                if (distSq > rangeSq) return;
+                RVONeighbor n;
+                n.position = Vec2(px_[j], pz_[j]);
+                n.velocity = Vec2(vx_[j], vz_[j]);
+                n.radius = radius_[j];
+                // Agents that do not avoid leave all of it to us
+                n.responsibility = avoid_[j] ? rvoResponsibility(priority_[i], priority_[j]) : 1.0f;
+                neighbors.insert(n, distSq);
+            });
+            if (neighbors.count > 0) {
+                chosen = computeORCAVelocity(Vec2(x, z), Vec2(vx_[i], vz_[i]), preferred, radius_[i], speed_[i],
+                                             neighbors.items, neighbors.count, settings_.timeHorizon, dt);
+            }
+        }
+
+        // Acceleration limit
+        float dvx = chosen.x - vx_[i], dvz = chosen.y - vz_[i];
+        float dv = std::sqrt(dvx * dvx + dvz * dvz);
+        float maxDv = acceleration_[i] * dt;
+        if (dv > maxDv && dv > 0.0f) {
+            dvx *= maxDv / dv;
+            dvz *= maxDv / dv;
+        }
+        nvx_[i] = vx_[i] + dvx;
+        nvz_[i] = vz_[i] + dvz;
+    }
+}
+
+inline void Crowd::integrate(size_t begin, size_t end, float dt) {
+    for (size_t i = begin; i < end; i++) {
+        vx_[i] = nvx_[i];
+        vz_[i] = nvz_[i];
+        float stepX = vx_[i] * dt, stepZ = vz_[i] * dt;
+        px_[i] += stepX;
+        pz_[i] += stepZ;
+        if (state_[i] != (uint8_t)NavAgentState::Moving) continue;
+
+        const AgentPath& path = paths_[i];
+        const Vec3& corner = path.corners[path.next];
+        float dx = corner.x - px_[i], dz = corner.z - pz_[i];
+        float distance = std::sqrt(dx * dx + dz * dz);
+        // Height follows the corner in proportion to horizontal progress
+        float step = std::sqrt(stepX * stepX + stepZ * stepZ);
+        py_[i] += (corner.y - py_[i]) * std::min(1.0f, step / std::max(distance + step, NAV_EPSILON));
+        if (path.next + 1 == path.corners.size() && distance <= stoppingDistance_[i]) {
+            state_[i] = (uint8_t)NavAgentState::Arrived;
+        }
+    }
+}
+
+inline void Crowd::update(float dt) {
+    auto start = std::chrono::steady_clock::now();
+    auto elapsedMs = [](std::chrono::steady_clock::time_point from) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - from).count();
+    };
+    stats_.agents = ids_.size();
+    stats_.threads = getThreadCount();
+    if (dt <= 0.0f) return;
+    tick_++;
+
+    auto phase = std::chrono::steady_clock::now();
+    solvePathRequests();
+    stats_.pathMs = elapsedMs(phase);
+
+    phase = std::chrono::steady_clock::now();
+    maxNeighborDistance_ = 1.0f;
+    for (float d : neighborDistance_) maxNeighborDistance_ = std::max(maxNeighborDistance_, d);
+    grid_.build(px_.data(), pz_.data(), ids_.size(), maxNeighborDistance_);
+    stats_.gridMs = elapsedMs(phase);
+
+    constexpr size_t kGrain = 256;
+    phase = std::chrono::steady_clock::now();
+    auto steer = [&](size_t begin, size_t end) { steerAndAvoid(begin, end, dt); };
+    pool_.parallelFor(ids_.size(), kGrain, steer);
+    stats_.avoidanceMs = elapsedMs(phase);
+
+    phase = std::chrono::steady_clock::now();
+    auto move = [&](size_t begin, size_t end) { integrate(begin, end, dt); };
+    pool_.parallelFor(ids_.size(), kGrain * 4, move);
+    stats_.integrateMs = elapsedMs(phase);
+    stats_.updateMs = elapsedMs(start);
+}
+
+}  // namespace luma
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "navmesh.h"
+#include "rvo.h"
 #include <functional>
 
 namespace luma {
@@ -25,10 +26,10 @@ struct NavAgentSettings {
     float radius = 0.5f;
     float height = 2.0f;
     
-    // Obstacle avoidance
+    // Obstacle avoidance (ORCA against neighboring agents)
     bool avoidObstacles = true;
-    float avoidanceRadius = 1.0f;
-    int avoidancePriority = 50;
+    float avoidanceRadius = 1.0f;   // Clearance kept from other agents
+    int avoidancePriority = 50;     // Lower = more important, yields less
     
     // Path following
     float pathUpdateInterval = 0.5f;  // Seconds between path updates
@@ -93,6 +94,12 @@ public:
     bool showDebugPath = false;
     
 private:
+    friend class NavAgentManager;
+    
+    // update() = planMovement() + applyMovement(); the manager adjusts
+    // velocity_ for avoidance in between
+    bool planMovement(float dt, const NavMesh& navMesh);
+    void applyMovement(float dt);
     void updateMovement(float dt);
     void updateRotation(float dt);
     bool updatePath(const NavMesh& navMesh);
@@ -159,8 +166,12 @@ inline void NavAgent::resume() {
 }
 
 inline void NavAgent::update(float dt, const NavMesh& navMesh) {
+    if (planMovement(dt, navMesh)) applyMovement(dt);
+}
+
+inline bool NavAgent::planMovement(float dt, const NavMesh& navMesh) {
     if (state_ == NavAgentState::Idle || state_ == NavAgentState::Arrived) {
-        return;
+        return false;
     }
     
     // Update path if needed
@@ -182,11 +193,15 @@ inline void NavAgent::update(float dt, const NavMesh& navMesh) {
     
     if (!currentPath_.valid) {
         state_ = NavAgentState::Stuck;
-        return;
+        return false;
     }
     
-    // Update movement
     updateMovement(dt);
+    return true;
+}
+
+inline void NavAgent::applyMovement(float dt) {
+    position_ = position_ + velocity_ * dt;
     updateRotation(dt);
 }
 
@@ -238,9 +253,6 @@ inline void NavAgent::updateMovement(float dt) {
     }
     
     velocity_ = velocity_ + velocityDiff;
-    
-    // Apply velocity
-    position_ = position_ + velocity_ * dt;
 }
 
 inline void NavAgent::updateRotation(float dt) {
@@ -312,14 +324,21 @@ inline void NavAgent::move(const Vec3& direction, float dt) {
 }
 
 // ===== Nav Agent Manager =====
+// Agents plan their velocities, agents with avoidObstacles then get ORCA
+// adjustments against their neighbors (found through a spatial hash), and
+// finally everyone moves. Large crowds should use Crowd (crowd.h).
 class NavAgentManager {
 public:
     NavAgent* createAgent() {
         agents_.push_back(std::make_unique<NavAgent>());
-        return agents_.back().get();
+        NavAgent* agent = agents_.back().get();
+        byId_[agent->getId()] = agent;
+        return agent;
     }
     
     void destroyAgent(NavAgent* agent) {
+        if (!agent) return;
+        byId_.erase(agent->getId());
         agents_.erase(
             std::remove_if(agents_.begin(), agents_.end(),
                 [agent](const auto& a) { return a.get() == agent; }),
@@ -328,25 +347,97 @@ public:
     }
     
     void update(float dt, const NavMesh& navMesh) {
-        for (auto& agent : agents_) {
-            agent->update(dt, navMesh);
+        active_.resize(agents_.size());
+        bool anyAvoiding = false;
+        for (size_t i = 0; i < agents_.size(); i++) {
+            active_[i] = agents_[i]->planMovement(dt, navMesh) ? 1 : 0;
+            anyAvoiding |= active_[i] && agents_[i]->settings_.avoidObstacles;
+        }
+        if (anyAvoiding && agents_.size() > 1 && dt > 0.0f) avoid(dt);
+        for (size_t i = 0; i < agents_.size(); i++) {
+            if (active_[i]) agents_[i]->applyMovement(dt);
         }
     }
     
+    // Seconds of lookahead for agent-agent avoidance
+    void setAvoidanceTimeHorizon(float seconds) { timeHorizon_ = std::max(0.05f, seconds); }
+    
     const std::vector<std::unique_ptr<NavAgent>>& getAgents() const { return agents_; }
     size_t getAgentCount() const { return agents_.size(); }
     
     NavAgent* getAgentById(uint32_t id) {
-        for (auto& agent : agents_) {
-            if (agent->getId() == id) return agent.get();
-        }
-        return nullptr;
+        auto it = byId_.find(id);
+        return it != byId_.end() ? it->second : nullptr;
     }
     
-    void clear() { agents_.clear(); }
+    void clear() {
+        agents_.clear();
+        byId_.clear();
+    }
     
 private:
+    void avoid(float dt) {
+        const size_t n = agents_.size();
+        xs_.resize(n);
+        zs_.resize(n);
+        float range = 1.0f;
+        for (size_t i = 0; i < n; i++) {
+            const NavAgent& agent = *agents_[i];
+            xs_[i] = agent.position_.x;
+            zs_[i] = agent.position_.z;
+            range = std::max(range, neighborRange(agent.settings_));
+        }
+        grid_.build(xs_.data(), zs_.data(), n, range);
+        
+        // Velocities before this pass, so the result is order-independent
+        velocities_.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            const NavAgent& agent = *agents_[i];
+            velocities_[i] = active_[i] ? Vec2(agent.velocity_.x, agent.velocity_.z) : Vec2(0.0f, 0.0f);
+        }
+        for (size_t i = 0; i < n; i++) {
+            NavAgent& agent = *agents_[i];
+            const NavAgentSettings& settings = agent.settings_;
+            if (!active_[i] || !settings.avoidObstacles) continue;
+            RVONeighborList neighbors;
+            neighbors.capacity = kMaxNeighbors;
+            const float r = neighborRange(settings);
+            grid_.query(xs_[i], zs_[i], r, [&](uint32_t j) {
+                if (j == i) return;
+                float dx = xs_[j] - xs_[i], dz = zs_[j] - zs_[i];
+                float distSq = dx * dx + dz * dz;
+                if (distSq > r * r) return;
+                const NavAgentSettings& other = agents_[j]->settings_;
+                RVONeighbor neighbor;
+                neighbor.position = Vec2(xs_[j], zs_[j]);
+                neighbor.velocity = velocities_[j];
+                neighbor.radius = other.avoidanceRadius;
+                bool reciprocal = active_[j] && other.avoidObstacles;
+                neighbor.responsibility = reciprocal ? rvoResponsibility(settings.avoidancePriority, other.avoidancePriority) : 1.0f;
+                neighbors.insert(neighbor, distSq);
+            });
+            if (neighbors.count == 0) continue;
+            Vec2 v = computeORCAVelocity(Vec2(xs_[i], zs_[i]), velocities_[i], velocities_[i], settings.avoidanceRadius,
+                                         settings.speed, neighbors.items, neighbors.count, timeHorizon_, dt);
+            agent.velocity_ = Vec3(v.x, agent.velocity_.y, v.y);
+        }
+    }
+    
+    float neighborRange(const NavAgentSettings& settings) const {
+        return settings.avoidanceRadius * 2.0f + settings.speed * timeHorizon_;
+    }
+    
+    static constexpr int kMaxNeighbors = 10;
+    
     std::vector<std::unique_ptr<NavAgent>> agents_;
+    std::unordered_map<uint32_t, NavAgent*> byId_;
+    float timeHorizon_ = 1.0f;
+    
+    // Avoidance scratch
+    std::vector<uint8_t> active_;
+    std::vector<float> xs_, zs_;
+    std::vector<Vec2> velocities_;
+    SpatialHashGrid grid_;
 };
 
 // ===== Global Manager =====
@@ -8,6 +8,7 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <queue>
+#include <functional>
 #include <cmath>
 #include <algorithm>
 #include <limits>
@@ -154,6 +155,10 @@ public:
     int addPolygon(const Vec3* vertices, int vertCount, uint8_t areaType = 0);
     void connectPolygons();
     
+    // Replaces the mesh with polygons whose properties and neighbor links
+    // are already filled in (e.g. stitched navmesh tiles)
+    void assign(std::vector<Vec3> vertices, std::vector<NavPoly> polygons);
+    
     // Query
     int findNearestPoly(const Vec3& position, float maxDistance = 10.0f) const;
     Vec3 getClosestPointOnPoly(int polyIndex, const Vec3& position) const;
@@ -180,10 +185,15 @@ public:
         polygons_.clear();
         edges_.clear();
         minBounds_ = maxBounds_ = Vec3(0, 0, 0);
+        version_++;
     }
     
     bool isValid() const { return !polygons_.empty(); }
     
+    // Bumped by every change to polygons or connectivity; lets caches
+    // built from this mesh notice that they are stale
+    uint32_t getVersion() const { return version_; }
+    
 private:
     void calculatePolyProperties(NavPoly& poly);
     void buildEdges();
@@ -197,13 +207,21 @@ private:
     Vec3 maxBounds_ = {0, 0, 0};
     
     NavMeshBuildSettings settings_;
+    uint32_t version_ = 0;
 };
 
 // ===== A* Pathfinder =====
+// Search state lives in a per-pathfinder node pool indexed by polygon.
+// Entries are stamped with a search generation instead of being cleared,
+// so keeping one pathfinder per thread makes repeated queries
+// allocation-free. A pathfinder must not be shared between threads.
 class NavPathfinder {
 public:
     NavPathfinder(const NavMesh* navMesh) : navMesh_(navMesh) {}
     
+    void setNavMesh(const NavMesh* navMesh) { navMesh_ = navMesh; }
+    const NavMesh* getNavMesh() const { return navMesh_; }
+    
     // Find path between two points
     bool findPath(const Vec3& start, const Vec3& end, NavPath& outPath);
     
@@ -211,6 +229,17 @@ public:
     bool findPath(const Vec3& start, const Vec3& end, NavPath& outPath,
                   const std::unordered_map<uint8_t, float>& areaCosts);
     
+    // Polygon corridor from startPoly to endPoly (both included). If
+    // allowed is given, only polygons with allowed[poly] == allowedStamp
+    // are expanded.
+    bool findCorridor(int startPoly, int endPoly, const Vec3& start, const Vec3& end,
+                      std::vector<int>& outCorridor,
+                      const std::unordered_map<uint8_t, float>& areaCosts = {},
+                      const std::vector<uint32_t>* allowed = nullptr, uint32_t allowedStamp = 0);
+    
+    // Path through a corridor: start, shared edge midpoints, end; smoothed
+    void buildPath(const std::vector<int>& corridor, const Vec3& start, const Vec3& end, NavPath& outPath);
+    
     // String pulling (funnel algorithm) for smooth paths
     void smoothPath(NavPath& path);
     
@@ -218,15 +247,35 @@ public:
     void setMaxIterations(int maxIter) { maxIterations_ = maxIter; }
     void setHeuristicWeight(float weight) { heuristicWeight_ = weight; }
     
+    // Polygons expanded by the last search
+    int getLastIterations() const { return lastIterations_; }
+    
 private:
+    struct SearchNode {
+        float gCost = 0.0f;
+        int parent = -1;
+        Vec3 position;
+        uint32_t visited = 0;  // search generation that reached this poly
+        uint32_t closed = 0;   // search generation that expanded it
+    };
+    struct OpenEntry {
+        float fCost;
+        int poly;
+        bool operator>(const OpenEntry& o) const { return fCost > o.fCost; }
+    };
+    
     float heuristic(const Vec3& a, const Vec3& b) const;
     float edgeCost(int polyA, int polyB, const std::unordered_map<uint8_t, float>& areaCosts) const;
-    void reconstructPath(const std::vector<NavNode>& nodes, int endNodeIndex,
-                         const Vec3& start, const Vec3& end, NavPath& outPath);
+    bool sharedEdge(int polyA, int polyB, Vec3& outStart, Vec3& outEnd) const;
     
     const NavMesh* navMesh_;
     int maxIterations_ = 10000;
     float heuristicWeight_ = 1.0f;
+    int lastIterations_ = 0;
+    
+    std::vector<SearchNode> pool_;
+    std::vector<OpenEntry> open_;
+    uint32_t generation_ = 0;
 };
 
 // ===== NavMesh Implementation =====
@@ -311,7 +360,7 @@ inline bool NavMesh::buildFromHeightmap(const float* heightmap, int width, int h
             Vec3 v0 = vertices_[i00];
             Vec3 v1 = vertices_[i10];
             Vec3 v2 = vertices_[i01];
-            Vec3 normal1 = (v1 - v0).cross(v2 - v0).normalized();
+            Vec3 normal1 = (v2 - v0).cross(v1 - v0).normalized();
             float slope1 = std::acos(std::max(-1.0f, std::min(1.0f, normal1.y))) * 180.0f / 3.14159f;
             
             if (slope1 <= settings.agentMaxSlope) {
@@ -370,49 +419,76 @@ inline int NavMesh::addPolygon(const Vec3* verts, int vertCount, uint8_t areaTyp
     
     calculatePolyProperties(poly);
     polygons_.push_back(poly);
+    version_++;
     
     return (int)polygons_.size() - 1;
 }
 
 inline void NavMesh::connectPolygons() {
-    // Find shared edges between polygons
-    for (size_t i = 0; i < polygons_.size(); i++) {
-        NavPoly& polyA = polygons_[i];
-        
-        for (size_t j = i + 1; j < polygons_.size(); j++) {
-            NavPoly& polyB = polygons_[j];
-            
-            // Check for shared edge
-            for (int ai = 0; ai < polyA.vertCount; ai++) {
-                int ai2 = (ai + 1) % polyA.vertCount;
-                int va1 = polyA.indices[ai];
-                int va2 = polyA.indices[ai2];
-                
-                for (int bi = 0; bi < polyB.vertCount; bi++) {
-                    int bi2 = (bi + 1) % polyB.vertCount;
-                    int vb1 = polyB.indices[bi];
-                    int vb2 = polyB.indices[bi2];
-                    
-                    // Check if edges match (in reverse order)
-                    bool match = (va1 == vb2 && va2 == vb1);
-                    
-                    // Or check by position (for separate vertex arrays)
-                    if (!match) {
-                        float d1 = (vertices_[va1] - vertices_[vb2]).length();
-                        float d2 = (vertices_[va2] - vertices_[vb1]).length();
-                        match = (d1 < NAV_EPSILON && d2 < NAV_EPSILON);
-                    }
-                    
-                    if (match) {
-                        polyA.neighbors[ai] = (int)j;
-                        polyB.neighbors[bi] = (int)i;
+    version_++;
+    for (auto& poly : polygons_) {
+        for (int j = 0; j < NAV_MAX_VERTS_PER_POLY; j++) poly.neighbors[j] = -1;
+    }
+    
+    // Weld vertices closer than NAV_EPSILON (for separate vertex arrays);
+    // each vertex checks the 27 quantization cells around it
+    auto cellKey = [](int64_t x, int64_t y, int64_t z) {
+        return (uint64_t)(x * 73856093) ^ (uint64_t)(y * 19349663) ^ (uint64_t)(z * 83492791);
+    };
+    const float inv = 1.0f / NAV_EPSILON;
+    std::unordered_multimap<uint64_t, int> cells;
+    cells.reserve(vertices_.size());
+    std::vector<int> weld(vertices_.size());
+    for (size_t v = 0; v < vertices_.size(); v++) {
+        const Vec3& p = vertices_[v];
+        int64_t cx = (int64_t)std::floor(p.x * inv), cy = (int64_t)std::floor(p.y * inv), cz = (int64_t)std::floor(p.z * inv);
+        int found = -1;
+        for (int64_t dz = -1; dz <= 1 && found < 0; dz++) {
+            for (int64_t dy = -1; dy <= 1 && found < 0; dy++) {
+                for (int64_t dx = -1; dx <= 1 && found < 0; dx++) {
+                    auto range = cells.equal_range(cellKey(cx + dx, cy + dy, cz + dz));
+                    for (auto it = range.first; it != range.second; ++it) {
+                        if ((vertices_[it->second] - p).length() < NAV_EPSILON) {
+                            found = weld[it->second];
+                            break;
+                        }
                     }
                 }
             }
         }
+        weld[v] = found >= 0 ? found : (int)v;
+        cells.emplace(cellKey(cx, cy, cz), (int)v);
+    }
+    
+    // Find shared edges between polygons: an edge matches the reversed
+    // edge of another polygon
+    std::unordered_map<uint64_t, std::pair<int, int>> openEdges;  // (a, b) -> (poly, edge)
+    openEdges.reserve(polygons_.size() * 3);
+    for (size_t i = 0; i < polygons_.size(); i++) {
+        NavPoly& polyA = polygons_[i];
+        for (int e = 0; e < polyA.vertCount; e++) {
+            uint32_t a = (uint32_t)weld[polyA.indices[e]];
+            uint32_t b = (uint32_t)weld[polyA.indices[(e + 1) % polyA.vertCount]];
+            auto it = openEdges.find(((uint64_t)b << 32) | a);
+            if (it != openEdges.end() && it->second.first != (int)i) {
+                polyA.neighbors[e] = it->second.first;
+                polygons_[it->second.first].neighbors[it->second.second] = (int)i;
+                openEdges.erase(it);
+            } else {
+                openEdges[((uint64_t)a << 32) | b] = {(int)i, e};
+            }
+        }
     }
 }
 
+inline void NavMesh::assign(std::vector<Vec3> vertices, std::vector<NavPoly> polygons) {
+    vertices_ = std::move(vertices);
+    polygons_ = std::move(polygons);
+    buildEdges();
+    updateBounds();
+    version_++;
+}
+
 inline void NavMesh::calculatePolyProperties(NavPoly& poly) {
     if (poly.vertCount < 3) return;
     
@@ -436,6 +512,7 @@ inline void NavMesh::calculatePolyProperties(NavPoly& poly) {
 
 inline void NavMesh::buildEdges() {
     edges_.clear();
+    edges_.reserve(polygons_.size() * 3 / 2);
     
     for (size_t i = 0; i < polygons_.size(); i++) {
         const NavPoly& poly = polygons_[i];
@@ -609,90 +686,100 @@ inline bool NavPathfinder::findPath(const Vec3& start, const Vec3& end, NavPath&
         return true;
     }
     
-    // A* search
+    std::vector<int> corridor;
+    if (!findCorridor(startPoly, endPoly, start, end, corridor, areaCosts)) return false;
+    buildPath(corridor, start, end, outPath);
+    
+    return outPath.valid;
+}
+
+inline bool NavPathfinder::findCorridor(int startPoly, int endPoly, const Vec3& start, const Vec3& end,
+                                        std::vector<int>& outCorridor,
+                                        const std::unordered_map<uint8_t, float>& areaCosts,
+                                        const std::vector<uint32_t>* allowed, uint32_t allowedStamp) {
+    outCorridor.clear();
+    lastIterations_ = 0;
+    if (!navMesh_) return false;
     const auto& polygons = navMesh_->getPolygons();
+    const auto& vertices = navMesh_->getVertices();
+    if (startPoly < 0 || endPoly < 0 || startPoly >= (int)polygons.size() || endPoly >= (int)polygons.size()) {
+        return false;
+    }
     
-    std::vector<NavNode> nodes;
-    std::vector<bool> closed(polygons.size(), false);
-    std::priority_queue<NavNode, std::vector<NavNode>, std::greater<NavNode>> openSet;
-    std::unordered_map<int, int> nodeMap;  // polyIndex -> node index
+    if (pool_.size() < polygons.size()) pool_.resize(polygons.size());
+    if (++generation_ == 0) {
+        // Stamps wrapped; old entries could look current
+        for (auto& node : pool_) node.visited = node.closed = 0;
+        generation_ = 1;
+    }
+    const uint32_t gen = generation_;
+    open_.clear();
     
     // Start node
-    NavNode startNode;
-    startNode.polyIndex = startPoly;
-    startNode.position = navMesh_->getClosestPointOnPoly(startPoly, start);
+    SearchNode& startNode = pool_[startPoly];
     startNode.gCost = 0.0f;
-    startNode.hCost = heuristic(startNode.position, end) * heuristicWeight_;
-    nodes.push_back(startNode);
-    nodeMap[startPoly] = 0;
-    openSet.push(startNode);
+    startNode.parent = -1;
+    startNode.position = navMesh_->getClosestPointOnPoly(startPoly, start);
+    startNode.visited = gen;
+    open_.push_back({heuristic(startNode.position, end) * heuristicWeight_, startPoly});
     
     int iterations = 0;
-    int endNodeIndex = -1;
+    bool found = false;
+    auto greater = std::greater<OpenEntry>();
     
-    while (!openSet.empty() && iterations < maxIterations_) {
-        iterations++;
+    while (!open_.empty() && iterations < maxIterations_) {
+        std::pop_heap(open_.begin(), open_.end(), greater);
+        int currentPoly = open_.back().poly;
+        open_.pop_back();
         
-        NavNode current = openSet.top();
-        openSet.pop();
-        
-        if (closed[current.polyIndex]) continue;
-        closed[current.polyIndex] = true;
+        SearchNode& current = pool_[currentPoly];
+        if (current.closed == gen) continue;
+        current.closed = gen;
+        iterations++;
         
         // Found goal
-        if (current.polyIndex == endPoly) {
-            endNodeIndex = nodeMap[current.polyIndex];
+        if (currentPoly == endPoly) {
+            found = true;
             break;
         }
         
         // Expand neighbors
-        const NavPoly& poly = polygons[current.polyIndex];
+        const NavPoly& poly = polygons[currentPoly];
         for (int i = 0; i < poly.vertCount; i++) {
             int neighborIdx = poly.neighbors[i];
-            if (neighborIdx < 0 || closed[neighborIdx]) continue;
-            
-            const NavPoly& neighbor = polygons[neighborIdx];
+            if (neighborIdx < 0) continue;
+            if (allowed && (*allowed)[neighborIdx] != allowedStamp) continue;
+            SearchNode& neighbor = pool_[neighborIdx];
+            if (neighbor.closed == gen) continue;
             
             // Calculate edge midpoint
-            Vec3 edgeStart = navMesh_->getVertices()[poly.indices[i]];
-            Vec3 edgeEnd = navMesh_->getVertices()[poly.indices[(i + 1) % poly.vertCount]];
+            Vec3 edgeStart = vertices[poly.indices[i]];
+            Vec3 edgeEnd = vertices[poly.indices[(i + 1) % poly.vertCount]];
             Vec3 edgeMid = (edgeStart + edgeEnd) * 0.5f;
             
             // Calculate cost
             float moveCost = (edgeMid - current.position).length();
-            moveCost *= edgeCost(current.polyIndex, neighborIdx, areaCosts);
+            moveCost *= edgeCost(currentPoly, neighborIdx, areaCosts);
             float newGCost = current.gCost + moveCost;
             
             // Check if better path
-            auto it = nodeMap.find(neighborIdx);
-            if (it != nodeMap.end()) {
-                if (newGCost >= nodes[it->second].gCost) continue;
-                nodes[it->second].gCost = newGCost;
-                nodes[it->second].parentIndex = nodeMap[current.polyIndex];
-                nodes[it->second].position = edgeMid;
-            } else {
-                NavNode newNode;
-                newNode.polyIndex = neighborIdx;
-                newNode.position = edgeMid;
-                newNode.gCost = newGCost;
-                newNode.hCost = heuristic(neighbor.center, end) * heuristicWeight_;
-                newNode.parentIndex = nodeMap[current.polyIndex];
-                nodes.push_back(newNode);
-                nodeMap[neighborIdx] = (int)nodes.size() - 1;
-            }
+            if (neighbor.visited == gen && newGCost >= neighbor.gCost) continue;
+            neighbor.visited = gen;
+            neighbor.gCost = newGCost;
+            neighbor.parent = currentPoly;
+            neighbor.position = edgeMid;
             
-            NavNode queueNode = nodes[nodeMap[neighborIdx]];
-            openSet.push(queueNode);
+            open_.push_back({newGCost + heuristic(polygons[neighborIdx].center, end) * heuristicWeight_, neighborIdx});
+            std::push_heap(open_.begin(), open_.end(), greater);
         }
     }
+    lastIterations_ = iterations;
     
-    if (endNodeIndex < 0) return false;
+    if (!found) return false;
     
-    // Reconstruct path
-    reconstructPath(nodes, endNodeIndex, start, end, outPath);
-    smoothPath(outPath);
-    
-    return outPath.valid;
+    for (int poly = endPoly; poly >= 0; poly = pool_[poly].parent) outCorridor.push_back(poly);
+    std::reverse(outCorridor.begin(), outCorridor.end());
+    return true;
 }
 
 inline float NavPathfinder::heuristic(const Vec3& a, const Vec3& b) const {
@@ -713,32 +800,33 @@ inline float NavPathfinder::edgeCost(int polyA, int polyB,
     return 1.0f;  // Default cost
 }
 
-inline void NavPathfinder::reconstructPath(const std::vector<NavNode>& nodes, int endNodeIndex,
-                                           const Vec3& start, const Vec3& end, NavPath& outPath) {
-    std::vector<int> nodeIndices;
-    int current = endNodeIndex;
-    
-    while (current >= 0) {
-        nodeIndices.push_back(current);
-        current = nodes[current].parentIndex;
+inline bool NavPathfinder::sharedEdge(int polyA, int polyB, Vec3& outStart, Vec3& outEnd) const {
+    const NavPoly& poly = navMesh_->getPolygons()[polyA];
+    for (int i = 0; i < poly.vertCount; i++) {
+        if (poly.neighbors[i] != polyB) continue;
+        outStart = navMesh_->getVertices()[poly.indices[i]];
+        outEnd = navMesh_->getVertices()[poly.indices[(i + 1) % poly.vertCount]];
+        return true;
     }
-    
-    std::reverse(nodeIndices.begin(), nodeIndices.end());
-    
-    // Build path points
+    return false;
+}
+
+inline void NavPathfinder::buildPath(const std::vector<int>& corridor, const Vec3& start, const Vec3& end,
+                                     NavPath& outPath) {
+    outPath.clear();
+    if (!navMesh_ || corridor.empty()) return;
     const auto& polygons = navMesh_->getPolygons();
     
-    outPath.points.push_back({start, nodes[nodeIndices[0]].polyIndex,
-                             polygons[nodes[nodeIndices[0]].polyIndex].areaType});
-    
-    for (size_t i = 1; i < nodeIndices.size(); i++) {
-        const NavNode& node = nodes[nodeIndices[i]];
-        outPath.points.push_back({node.position, node.polyIndex,
-                                 polygons[node.polyIndex].areaType});
+    outPath.points.push_back({start, corridor.front(), polygons[corridor.front()].areaType});
+    for (size_t i = 1; i < corridor.size(); i++) {
+        Vec3 edgeStart, edgeEnd;
+        if (!sharedEdge(corridor[i - 1], corridor[i], edgeStart, edgeEnd)) {
+            outPath.clear();  // corridor does not match this mesh
+            return;
+        }
+        outPath.points.push_back({(edgeStart + edgeEnd) * 0.5f, corridor[i], polygons[corridor[i]].areaType});
     }
-    
-    outPath.points.push_back({end, nodes[nodeIndices.back()].polyIndex,
-                             polygons[nodes[nodeIndices.back()].polyIndex].areaType});
+    outPath.points.push_back({end, corridor.back(), polygons[corridor.back()].areaType});
     
     // Calculate total length
     outPath.totalLength = 0.0f;
@@ -747,32 +835,90 @@ inline void NavPathfinder::reconstructPath(const std::vector<NavNode>& nodes, in
     }
     
     outPath.valid = true;
+    smoothPath(outPath);
 }
 
 inline void NavPathfinder::smoothPath(NavPath& path) {
     if (path.points.size() < 3) return;
     
-    // Simple line-of-sight smoothing
+    // String pulling over the portals (shared edges) between consecutive
+    // corridor polygons; corners of the result are portal endpoints
+    const auto& polygons = navMesh_->getPolygons();
+    const auto& vertices = navMesh_->getVertices();
+    struct Portal { Vec3 left, right; int poly; uint8_t areaType; };
+    std::vector<Portal> portals;
+    portals.reserve(path.points.size());
+    portals.push_back({path.points[0].position, path.points[0].position,
+                       path.points[0].polyIndex, path.points[0].areaType});
+    for (size_t i = 1; i < path.points.size(); i++) {
+        int from = path.points[i - 1].polyIndex;
+        int to = path.points[i].polyIndex;
+        if (from == to || from < 0 || to < 0) continue;
+        const NavPoly& poly = polygons[from];
+        for (int e = 0; e < poly.vertCount; e++) {
+            if (poly.neighbors[e] != to) continue;
+            Vec3 a = vertices[poly.indices[e]];
+            Vec3 b = vertices[poly.indices[(e + 1) % poly.vertCount]];
+            // Orient by the travel direction out of the current polygon
+            Vec3 mid = (a + b) * 0.5f;
+            Vec3 dir = mid - poly.center;
+            Vec3 rel = a - poly.center;
+            bool aIsLeft = dir.x * rel.z - dir.z * rel.x > 0.0f;
+            portals.push_back({aIsLeft ? a : b, aIsLeft ? b : a, to, polygons[to].areaType});
+            break;
+        }
+    }
+    const PathPoint& last = path.points.back();
+    portals.push_back({last.position, last.position, last.polyIndex, last.areaType});
+    
+    auto triArea2 = [](const Vec3& a, const Vec3& b, const Vec3& c) {
+        return (c.x - a.x) * (b.z - a.z) - (b.x - a.x) * (c.z - a.z);
+    };
+    auto same = [](const Vec3& a, const Vec3& b) {
+        float dx = a.x - b.x, dz = a.z - b.z;
+        return dx * dx + dz * dz < NAV_EPSILON * NAV_EPSILON;
+    };
+    
     std::vector<PathPoint> smoothed;
     smoothed.push_back(path.points[0]);
-    
-    size_t current = 0;
-    while (current < path.points.size() - 1) {
-        size_t farthest = current + 1;
-        
-        // Find farthest visible point
-        for (size_t i = current + 2; i < path.points.size(); i++) {
-            Vec3 hitPoint;
-            int hitPoly;
-            if (!navMesh_->raycast(path.points[current].position,
-                                   path.points[i].position, hitPoint, hitPoly)) {
-                farthest = i;
+    Vec3 apex = portals[0].left;
+    Vec3 left = portals[0].left, right = portals[0].right;
+    size_t apexIndex = 0, leftIndex = 0, rightIndex = 0;
+    for (size_t i = 1; i < portals.size(); i++) {
+        const Portal& portal = portals[i];
+        // Tighten the right side
+        if (triArea2(apex, right, portal.right) <= 0.0f) {
+            if (same(apex, right) || triArea2(apex, left, portal.right) > 0.0f) {
+                right = portal.right;
+                rightIndex = i;
+            } else {
+                // Right crossed over left: left becomes a corner
+                apex = left;
+                apexIndex = leftIndex;
+                smoothed.push_back({apex, portals[apexIndex].poly, portals[apexIndex].areaType});
+                left = right = apex;
+                leftIndex = rightIndex = apexIndex;
+                i = apexIndex;
+                continue;
+            }
+        }
+        // Tighten the left side
+        if (triArea2(apex, left, portal.left) >= 0.0f) {
+            if (same(apex, left) || triArea2(apex, right, portal.left) < 0.0f) {
+                left = portal.left;
+                leftIndex = i;
+            } else {
+                apex = right;
+                apexIndex = rightIndex;
+                smoothed.push_back({apex, portals[apexIndex].poly, portals[apexIndex].areaType});
+                left = right = apex;
+                leftIndex = rightIndex = apexIndex;
+                i = apexIndex;
+                continue;
             }
         }
-        
-        smoothed.push_back(path.points[farthest]);
-        current = farthest;
     }
+    if (!same(smoothed.back().position, last.position)) smoothed.push_back(last);
     
     path.points = smoothed;
     
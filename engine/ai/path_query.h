@@ -0,0 +1,679 @@
+// Path Queries - asynchronous, cached and hierarchical path finding
+// NavPathQueryService owns a request queue that is drained by worker
+// threads or, with threads = 0, in time slices from update().
+//   - every thread keeps its own NavPathfinder, whose node pool is reused
+//   - solved poly-to-poly corridors go into an LRU cache; later requests
+//     between the same polygons only re-run string pulling
+//   - meshes with at least hierarchicalMinPolys polygons are split into
+//     clusters of neighboring polygons; A* first runs on the cluster graph
+//     and the polygon search is then limited to the clusters on that route
+//   - start/end polygons come from a uniform grid over polygon bounds
+//     instead of NavMesh::findNearestPoly's linear scan
+// Clusters, grid and cache are rebuilt when NavMesh::getVersion() changes.
+// The mesh itself must not be edited while queries run (flush() first).
+#pragma once
+
+#include "navmesh.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+namespace luma {
+
+// ===== Path Query Settings =====
+struct NavPathQuerySettings {
+    int threads = 0;                     // worker threads; 0 = solved in update()
+    size_t cacheCapacity = 1024;         // corridors kept, least recently used evicted
+    int clusterSize = 64;                // polygons per cluster
+    size_t hierarchicalMinPolys = 4096;  // smaller meshes are searched flat
+};
+
+struct NavPathQueryStats {
+    size_t submitted = 0;
+    size_t completed = 0;                // including failed
+    size_t failed = 0;
+    size_t cacheHits = 0;
+    size_t cacheMisses = 0;
+    size_t hierarchical = 0;             // searches limited to a cluster route
+    size_t hierarchicalFallbacks = 0;    // route had no polygon path; searched flat
+    size_t clusters = 0;
+};
+
+enum class NavPathQueryStatus {
+    Invalid,    // unknown, cancelled or already taken
+    Pending,
+    Succeeded,
+    Failed
+};
+
+// ===== Path Query Service =====
+class NavPathQueryService {
+public:
+    using QueryId = uint32_t;
+    static constexpr QueryId INVALID_QUERY = 0;
+
+    explicit NavPathQueryService(const NavMesh* navMesh = nullptr, const NavPathQuerySettings& settings = {});
+    ~NavPathQueryService();
+
+    NavPathQueryService(const NavPathQueryService&) = delete;
+    NavPathQueryService& operator=(const NavPathQueryService&) = delete;
+
+    // Finishes running queries first
+    void setNavMesh(const NavMesh* navMesh);
+    const NavMesh* getNavMesh() const { return navMesh_; }
+
+    // Queues a query; pick the path up with takeResult once it is done
+    QueryId request(const Vec3& start, const Vec3& end);
+    NavPathQueryStatus getStatus(QueryId id) const;
+    // Moves a finished query's path out and forgets the query. False while
+    // pending or unknown; failed queries return true with an invalid path.
+    bool takeResult(QueryId id, NavPath& outPath);
+    void cancel(QueryId id);
+
+    // Solves queued queries on this thread until budgetMs has passed (at
+    // least one); returns how many. Workers keep running in the background.
+    size_t update(double budgetMs);
+    // Blocks until nothing is queued or running
+    void flush();
+
+    // Synchronous query through the same cache and cluster graph
+    bool findPath(const Vec3& start, const Vec3& end, NavPath& outPath);
+
+    // Drops cached corridors (mesh changes are also picked up by version)
+    void invalidate();
+
+    // Polygon containing position, or the nearest one
+    int findPoly(const Vec3& position) const;
+
+    NavPathQueryStats getStats() const;
+    size_t getPendingCount() const;
+    int getThreadCount() const { return (int)workers_.size(); }
+
+private:
+    struct Query {
+        Vec3 start;
+        Vec3 end;
+        NavPathQueryStatus status = NavPathQueryStatus::Pending;
+        NavPath path;
+    };
+    // Per-thread search state
+    struct SearchContext {
+        NavPathfinder pathfinder{nullptr};
+        std::vector<int> corridor;
+        std::vector<uint32_t> allowed;     // poly -> stamp of the route allowing it
+        uint32_t allowedStamp = 0;
+        // Cluster A*
+        std::vector<float> gCost;
+        std::vector<int> parent;
+        std::vector<uint32_t> visited;
+        std::vector<uint32_t> closed;
+        uint32_t generation = 0;
+        std::vector<std::pair<float, int>> open;
+        std::vector<int> route;
+    };
+    struct SolveInfo {
+        bool cacheHit = false;
+        bool cacheMiss = false;
+        bool hierarchical = false;
+        bool fallback = false;
+    };
+    struct CacheEntry {
+        uint64_t key;
+        std::vector<int> corridor;
+    };
+
+    void syncMesh();
+    void rebuild();
+    void buildClusters();
+    void buildLocator();
+    bool popQuery(QueryId& id, Vec3& start, Vec3& end);
+    void finishQuery(QueryId id, bool ok, NavPath& path, const SolveInfo& info);
+    bool solve(SearchContext& context, const Vec3& start, const Vec3& end, NavPath& outPath, SolveInfo& info);
+    bool findClusterRoute(SearchContext& context, int startCluster, int endCluster);
+    bool cacheLookup(uint64_t key, std::vector<int>& outCorridor);
+    void cacheStore(uint64_t key, const std::vector<int>& corridor);
+    void workerLoop(SearchContext& context);
+
+    const NavMesh* navMesh_ = nullptr;
+    NavPathQuerySettings settings_;
+    const NavMesh* builtFor_ = nullptr;
+    uint32_t builtVersion_ = 0;
+
+    // Clusters (CSR layouts)
+    std::vector<int> polyCluster_;
+    std::vector<uint32_t> clusterPolyStart_;
+    std::vector<int> clusterPolys_;
+    std::vector<uint32_t> clusterLinkStart_;
+    std::vector<std::pair<int, float>> clusterLinks_;  // neighbor, center distance
+    std::vector<Vec3> clusterCenter_;
+
+    // Polygon locator grid over the mesh bounds
+    float locatorMinX_ = 0.0f, locatorMinZ_ = 0.0f;
+    float locatorInvCell_ = 1.0f;
+    int locatorWidth_ = 0, locatorHeight_ = 0;
+    std::vector<uint32_t> locatorStart_;
+    std::vector<int> locatorPolys_;
+
+    // Corridor cache
+    std::mutex cacheMutex_;
+    std::list<CacheEntry> lru_;  // most recent first
+    std::unordered_map<uint64_t, std::list<CacheEntry>::iterator> cacheIndex_;
+
+    // Queries; mutex_ also guards stats_
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::unordered_map<QueryId, Query> queries_;
+    std::deque<QueryId> queue_;
+    QueryId nextId_ = 1;
+    size_t running_ = 0;
+    bool stop_ = false;
+    NavPathQueryStats stats_;
+
+    // Workers hold it shared while solving; rebuilds take it exclusively
+    std::shared_mutex meshMutex_;
+    SearchContext ownerContext_;
+    std::vector<std::unique_ptr<SearchContext>> workerContexts_;
+    std::vector<std::thread> workers_;
+};
+
+// ===== Path Query Service Implementation =====
+
+inline NavPathQueryService::NavPathQueryService(const NavMesh* navMesh, const NavPathQuerySettings& settings)
+    : navMesh_(navMesh), settings_(settings) {
+    settings_.clusterSize = std::max(1, settings_.clusterSize);
+    ownerContext_.pathfinder.setNavMesh(navMesh_);
+    syncMesh();
+    for (int i = 0; i < settings_.threads; i++) {
+        workerContexts_.push_back(std::make_unique<SearchContext>());
+        workerContexts_.back()->pathfinder.setNavMesh(navMesh_);
+    }
+    for (auto& context : workerContexts_) {
+        SearchContext* c = context.get();
+        workers_.emplace_back([this, c] { workerLoop(*c); });
+    }
+}
+
+inline NavPathQueryService::~NavPathQueryService() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) worker.join();
+}
+
+inline void NavPathQueryService::setNavMesh(const NavMesh* navMesh) {
+    flush();
+    std::unique_lock<std::shared_mutex> lock(meshMutex_);
+    navMesh_ = navMesh;
+    ownerContext_.pathfinder.setNavMesh(navMesh);
+    for (auto& context : workerContexts_) context->pathfinder.setNavMesh(navMesh);
+    rebuild();
+}
+
+inline NavPathQueryService::QueryId NavPathQueryService::request(const Vec3& start, const Vec3& end) {
+    syncMesh();
+    QueryId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = nextId_++;
+        if (nextId_ == INVALID_QUERY) nextId_ = 1;
+        Query& query = queries_[id];
+        query.start = start;
+        query.end = end;
+        queue_.push_back(id);
+        stats_.submitted++;
+    }
+    wake_.notify_one();
+    return id;
+}
+
+inline NavPathQueryStatus NavPathQueryService::getStatus(QueryId id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = queries_.find(id);
+    return it == queries_.end() ? NavPathQueryStatus::Invalid : it->second.status;
+}
+
+inline bool NavPathQueryService::takeResult(QueryId id, NavPath& outPath) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = queries_.find(id);
+    if (it == queries_.end() || it->second.status == NavPathQueryStatus::Pending) return false;
+    outPath = std::move(it->second.path);
+    queries_.erase(it);
+    return true;
+}
+
+inline void NavPathQueryService::cancel(QueryId id) {
+    // Queued ids without a query are skipped; a running one is dropped when it finishes
+    std::lock_guard<std::mutex> lock(mutex_);
+    queries_.erase(id);
+}
+
+inline size_t NavPathQueryService::update(double budgetMs) {
+    syncMesh();
+    auto begin = std::chrono::steady_clock::now();
+    size_t solved = 0;
+    QueryId id;
+    Vec3 start, end;
+    while (popQuery(id, start, end)) {
+        NavPath path;
+        SolveInfo info;
+        bool ok;
+        {
+            std::shared_lock<std::shared_mutex> meshLock(meshMutex_);
+            ok = solve(ownerContext_, start, end, path, info);
+        }
+        finishQuery(id, ok, path, info);
+        solved++;
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        if (elapsed >= budgetMs) break;
+    }
+    return solved;
+}
+
+inline void NavPathQueryService::flush() {
+    update(std::numeric_limits<double>::infinity());
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return running_ == 0; });
+}
+
+inline bool NavPathQueryService::findPath(const Vec3& start, const Vec3& end, NavPath& outPath) {
+    syncMesh();
+    SolveInfo info;
+    bool ok;
+    {
+        std::shared_lock<std::shared_mutex> meshLock(meshMutex_);
+        ok = solve(ownerContext_, start, end, outPath, info);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.cacheHits += info.cacheHit;
+    stats_.cacheMisses += info.cacheMiss;
+    stats_.hierarchical += info.hierarchical;
+    stats_.hierarchicalFallbacks += info.fallback;
+    return ok;
+}
+
+inline void NavPathQueryService::invalidate() {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    lru_.clear();
+    cacheIndex_.clear();
+}
+
+inline NavPathQueryStats NavPathQueryService::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+inline size_t NavPathQueryService::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size() + running_;
+}
+
+inline void NavPathQueryService::syncMesh() {
+    if (navMesh_ == builtFor_ && (!navMesh_ || navMesh_->getVersion() == builtVersion_)) return;
+    std::unique_lock<std::shared_mutex> lock(meshMutex_);
+    rebuild();
+}
+
+inline void NavPathQueryService::rebuild() {
+    builtFor_ = navMesh_;
+    builtVersion_ = navMesh_ ? navMesh_->getVersion() : 0;
+    invalidate();
+    buildClusters();
+    buildLocator();
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.clusters = clusterCenter_.size();
+}
+
+inline void NavPathQueryService::buildClusters() {
+    polyCluster_.clear();
+    clusterPolyStart_.assign(1, 0);
+    clusterPolys_.clear();
+    clusterLinkStart_.assign(1, 0);
+    clusterLinks_.clear();
+    clusterCenter_.clear();
+    if (!navMesh_ || navMesh_->getPolyCount() < settings_.hierarchicalMinPolys) return;
+
+    // Grow clusters breadth-first so each one is connected
+    const auto& polygons = navMesh_->getPolygons();
+    const int polyCount = (int)polygons.size();
+    polyCluster_.assign(polyCount, -1);
+    std::vector<int> frontier;
+    for (int seed = 0; seed < polyCount; seed++) {
+        if (polyCluster_[seed] >= 0) continue;
+        int cluster = (int)clusterCenter_.size();
+        Vec3 center(0, 0, 0);
+        frontier.assign(1, seed);
+        polyCluster_[seed] = cluster;
+        size_t head = 0;
+        while (head < frontier.size()) {
+            int poly = frontier[head++];
+            clusterPolys_.push_back(poly);
+            center = center + polygons[poly].center;
+            for (int e = 0; e < polygons[poly].vertCount; e++) {
+                int n = polygons[poly].neighbors[e];
+                if (n < 0 || polyCluster_[n] >= 0 || (int)frontier.size() >= settings_.clusterSize) continue;
+                polyCluster_[n] = cluster;
+                frontier.push_back(n);
+            }
+        }
+        clusterCenter_.push_back(center * (1.0f / (float)frontier.size()));
+        clusterPolyStart_.push_back((uint32_t)clusterPolys_.size());
+    }
+
+    // Links between clusters sharing a polygon edge
+    std::vector<int> seen(clusterCenter_.size(), -1);
+    for (int cluster = 0; cluster < (int)clusterCenter_.size(); cluster++) {
+        for (uint32_t p = clusterPolyStart_[cluster]; p < clusterPolyStart_[cluster + 1]; p++) {
+            const NavPoly& poly = polygons[clusterPolys_[p]];
+            for (int e = 0; e < poly.vertCount; e++) {
+                if (poly.neighbors[e] < 0) continue;
+                int other = polyCluster_[poly.neighbors[e]];
+                if (other == cluster || seen[other] == cluster) continue;
+                seen[other] = cluster;
+                clusterLinks_.push_back({other, (clusterCenter_[other] - clusterCenter_[cluster]).length()});
+            }
+        }
+        clusterLinkStart_.push_back((uint32_t)clusterLinks_.size());
+    }
+}
+
+inline void NavPathQueryService::buildLocator() {
+    locatorWidth_ = locatorHeight_ = 0;
+    locatorStart_.clear();
+    locatorPolys_.clear();
+    if (!navMesh_ || !navMesh_->isValid()) return;
+
+    const auto& polygons = navMesh_->getPolygons();
+    const auto& vertices = navMesh_->getVertices();
+    // NavMesh bounds are not kept up to date by addPolygon
+    Vec3 minB = vertices[polygons[0].indices[0]], maxB = minB;
+    for (const Vec3& v : vertices) {
+        minB = Vec3(std::min(minB.x, v.x), minB.y, std::min(minB.z, v.z));
+        maxB = Vec3(std::max(maxB.x, v.x), maxB.y, std::max(maxB.z, v.z));
+    }
+    // About one polygon per cell, at most 512 x 512 cells
+    float extentX = std::max(maxB.x - minB.x, NAV_EPSILON), extentZ = std::max(maxB.z - minB.z, NAV_EPSILON);
+    float cell = std::sqrt(extentX * extentZ / (float)polygons.size());
+    cell = std::max(cell, std::max(extentX, extentZ) / 512.0f);
+    locatorInvCell_ = 1.0f / cell;
+    locatorMinX_ = minB.x;
+    locatorMinZ_ = minB.z;
+    locatorWidth_ = (int)(extentX * locatorInvCell_) + 1;
+    locatorHeight_ = (int)(extentZ * locatorInvCell_) + 1;
+
+    auto cellRange = [&](const NavPoly& poly, int& x0, int& z0, int& x1, int& z1) {
+        float minX = 1e30f, minZ = 1e30f, maxX = -1e30f, maxZ = -1e30f;
+        for (int i = 0; i < poly.vertCount; i++) {
+            const Vec3& v = vertices[poly.indices[i]];
+            minX = std::min(minX, v.x); maxX = std::max(maxX, v.x);
+            minZ = std::min(minZ, v.z); maxZ = std::max(maxZ, v.z);
+        }
+        x0 = std::max(0, (int)((minX - locatorMinX_) * locatorInvCell_));
+        z0 = std::max(0, (int)((minZ - locatorMinZ_) * locatorInvCell_));
+        x1 = std::min(locatorWidth_ - 1, (int)((maxX - locatorMinX_) * locatorInvCell_));
+        z1 = std::min(locatorHeight_ - 1, (int)((maxZ - locatorMinZ_) * locatorInvCell_));
+    };
+    // Counting sort of (cell, poly) pairs
+    locatorStart_.assign((size_t)locatorWidth_ * locatorHeight_ + 1, 0);
+    for (const NavPoly& poly : polygons) {
+        int x0, z0, x1, z1;
+        cellRange(poly, x0, z0, x1, z1);
+        for (int z = z0; z <= z1; z++)
+            for (int x = x0; x <= x1; x++) locatorStart_[(size_t)z * locatorWidth_ + x + 1]++;
+    }
+    for (size_t c = 1; c < locatorStart_.size(); c++) locatorStart_[c] += locatorStart_[c - 1];
+    locatorPolys_.resize(locatorStart_.back());
+    std::vector<uint32_t> cursor(locatorStart_.begin(), locatorStart_.end() - 1);
+    for (int p = 0; p < (int)polygons.size(); p++) {
+        int x0, z0, x1, z1;
+        cellRange(polygons[p], x0, z0, x1, z1);
+        for (int z = z0; z <= z1; z++)
+            for (int x = x0; x <= x1; x++) locatorPolys_[cursor[(size_t)z * locatorWidth_ + x]++] = p;
+    }
+}
+
+inline int NavPathQueryService::findPoly(const Vec3& position) const {
+    if (!navMesh_) return -1;
+    int cx = (int)std::floor((position.x - locatorMinX_) * locatorInvCell_);
+    int cz = (int)std::floor((position.z - locatorMinZ_) * locatorInvCell_);
+    if (cx >= 0 && cz >= 0 && cx < locatorWidth_ && cz < locatorHeight_) {
+        // Of the polygons containing the point, the one closest in height
+        size_t c = (size_t)cz * locatorWidth_ + cx;
+        int best = -1;
+        float bestDist = std::numeric_limits<float>::max();
+        for (uint32_t i = locatorStart_[c]; i < locatorStart_[c + 1]; i++) {
+            int poly = locatorPolys_[i];
+            if (!navMesh_->isPointInPoly(poly, position)) continue;
+            float dist = (navMesh_->getClosestPointOnPoly(poly, position) - position).lengthSquared();
+            if (dist < bestDist) {
+                bestDist = dist;
+                best = poly;
+            }
+        }
+        if (best >= 0) return best;
+        
+        // Off the mesh (e.g. inside an obstacle): nearest polygon in the
+        // surrounding cells
+        for (int z = std::max(0, cz - 1); z <= std::min(locatorHeight_ - 1, cz + 1); z++) {
+            for (int x = std::max(0, cx - 1); x <= std::min(locatorWidth_ - 1, cx + 1); x++) {
+                size_t n = (size_t)z * locatorWidth_ + x;
+                for (uint32_t i = locatorStart_[n]; i < locatorStart_[n + 1]; i++) {
+                    int poly = locatorPolys_[i];
+                    float dist = (navMesh_->getClosestPointOnPoly(poly, position) - position).lengthSquared();
+                    if (dist < bestDist) {
+                        bestDist = dist;
+                        best = poly;
+                    }
+                }
+            }
+        }
+        // Anything closer than a cell is nearer than polygons further out
+        if (best >= 0 && bestDist * locatorInvCell_ * locatorInvCell_ <= 1.0f) return best;
+    }
+    return navMesh_->findNearestPoly(position);
+}
+
+inline bool NavPathQueryService::popQuery(QueryId& id, Vec3& start, Vec3& end) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!queue_.empty()) {
+        id = queue_.front();
+        queue_.pop_front();
+        auto it = queries_.find(id);
+        if (it == queries_.end()) continue;  // cancelled
+        start = it->second.start;
+        end = it->second.end;
+        running_++;
+        return true;
+    }
+    return false;
+}
+
+inline void NavPathQueryService::finishQuery(QueryId id, bool ok, NavPath& path, const SolveInfo& info) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_--;
+        stats_.completed++;
+        stats_.failed += !ok;
+        stats_.cacheHits += info.cacheHit;
+        stats_.cacheMisses += info.cacheMiss;
+        stats_.hierarchical += info.hierarchical;
+        stats_.hierarchicalFallbacks += info.fallback;
+        auto it = queries_.find(id);
+        if (it != queries_.end()) {
+            it->second.status = ok ? NavPathQueryStatus::Succeeded : NavPathQueryStatus::Failed;
+            it->second.path = std::move(path);
+        }
+    }
+    idle_.notify_all();
+}
+
+inline bool NavPathQueryService::solve(SearchContext& context, const Vec3& start, const Vec3& end,
+                                       NavPath& outPath, SolveInfo& info) {
+    outPath.clear();
+    if (!navMesh_ || !navMesh_->isValid()) return false;
+    int startPoly = findPoly(start);
+    int endPoly = findPoly(end);
+    if (startPoly < 0 || endPoly < 0) return false;
+
+    const auto& polygons = navMesh_->getPolygons();
+    if (startPoly == endPoly) {
+        outPath.points.push_back({start, startPoly, polygons[startPoly].areaType});
+        outPath.points.push_back({end, endPoly, polygons[endPoly].areaType});
+        outPath.totalLength = (end - start).length();
+        outPath.valid = true;
+        return true;
+    }
+
+    const uint64_t key = ((uint64_t)(uint32_t)startPoly << 32) | (uint32_t)endPoly;
+    if (cacheLookup(key, context.corridor)) {
+        info.cacheHit = true;
+        context.pathfinder.buildPath(context.corridor, start, end, outPath);
+        if (outPath.valid) return true;
+    }
+    info.cacheMiss = true;
+
+    bool found = false;
+    if (!polyCluster_.empty()) {
+        // Cluster graph connectivity matches the polygon graph, so no route
+        // means no path at all
+        if (!findClusterRoute(context, polyCluster_[startPoly], polyCluster_[endPoly])) return false;
+        if (context.allowed.size() != polygons.size()) {
+            context.allowed.assign(polygons.size(), 0);
+            context.allowedStamp = 0;
+        }
+        if (++context.allowedStamp == 0) {
+            std::fill(context.allowed.begin(), context.allowed.end(), 0);
+            context.allowedStamp = 1;
+        }
+        // The route and the clusters bordering it; the extra ring gives the
+        // polygon search room to cut across cluster corners
+        auto allow = [&](int cluster) {
+            for (uint32_t p = clusterPolyStart_[cluster]; p < clusterPolyStart_[cluster + 1]; p++) {
+                context.allowed[clusterPolys_[p]] = context.allowedStamp;
+            }
+        };
+        for (int cluster : context.route) {
+            allow(cluster);
+            for (uint32_t l = clusterLinkStart_[cluster]; l < clusterLinkStart_[cluster + 1]; l++) {
+                allow(clusterLinks_[l].first);
+            }
+        }
+        info.hierarchical = true;
+        found = context.pathfinder.findCorridor(startPoly, endPoly, start, end, context.corridor, {},
+                                                &context.allowed, context.allowedStamp);
+        info.fallback = !found;
+    }
+    if (!found) found = context.pathfinder.findCorridor(startPoly, endPoly, start, end, context.corridor);
+    if (!found) return false;
+
+    cacheStore(key, context.corridor);
+    context.pathfinder.buildPath(context.corridor, start, end, outPath);
+    return outPath.valid;
+}
+
+inline bool NavPathQueryService::findClusterRoute(SearchContext& context, int startCluster, int endCluster) {
+    const size_t count = clusterCenter_.size();
+    if (context.visited.size() != count) {
+        context.gCost.assign(count, 0.0f);
+        context.parent.assign(count, -1);
+        context.visited.assign(count, 0);
+        context.closed.assign(count, 0);
+        context.generation = 0;
+    }
+    if (++context.generation == 0) {
+        std::fill(context.visited.begin(), context.visited.end(), 0);
+        std::fill(context.closed.begin(), context.closed.end(), 0);
+        context.generation = 1;
+    }
+    const uint32_t gen = context.generation;
+    const Vec3& goal = clusterCenter_[endCluster];
+    auto greater = std::greater<std::pair<float, int>>();
+
+    context.open.clear();
+    context.gCost[startCluster] = 0.0f;
+    context.parent[startCluster] = -1;
+    context.visited[startCluster] = gen;
+    context.open.push_back({(goal - clusterCenter_[startCluster]).length(), startCluster});
+    bool found = false;
+    while (!context.open.empty()) {
+        std::pop_heap(context.open.begin(), context.open.end(), greater);
+        int cluster = context.open.back().second;
+        context.open.pop_back();
+        if (context.closed[cluster] == gen) continue;
+        context.closed[cluster] = gen;
+        if (cluster == endCluster) {
+            found = true;
+            break;
+        }
+        for (uint32_t l = clusterLinkStart_[cluster]; l < clusterLinkStart_[cluster + 1]; l++) {
+            int next = clusterLinks_[l].first;
+            if (context.closed[next] == gen) continue;
+            float g = context.gCost[cluster] + clusterLinks_[l].second;
+            if (context.visited[next] == gen && g >= context.gCost[next]) continue;
+            context.visited[next] = gen;
+            context.gCost[next] = g;
+            context.parent[next] = cluster;
+            context.open.push_back({g + (goal - clusterCenter_[next]).length(), next});
+            std::push_heap(context.open.begin(), context.open.end(), greater);
+        }
+    }
+    context.route.clear();
+    if (!found) return false;
+    for (int cluster = endCluster; cluster >= 0; cluster = context.parent[cluster]) context.route.push_back(cluster);
+    return true;
+}
+
+inline bool NavPathQueryService::cacheLookup(uint64_t key, std::vector<int>& outCorridor) {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto it = cacheIndex_.find(key);
+    if (it == cacheIndex_.end()) return false;
+    lru_.splice(lru_.begin(), lru_, it->second);
+    outCorridor = it->second->corridor;
+    return true;
+}
+
+inline void NavPathQueryService::cacheStore(uint64_t key, const std::vector<int>& corridor) {
+    if (settings_.cacheCapacity == 0) return;
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto it = cacheIndex_.find(key);
+    if (it != cacheIndex_.end()) {
+        it->second->corridor = corridor;
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return;
+    }
+    lru_.push_front({key, corridor});
+    cacheIndex_[key] = lru_.begin();
+    if (lru_.size() > settings_.cacheCapacity) {
+        cacheIndex_.erase(lru_.back().key);
+        lru_.pop_back();
+    }
+}
+
+inline void NavPathQueryService::workerLoop(SearchContext& context) {
+    for (;;) {
+        QueryId id;
+        Vec3 start, end;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (stop_) return;
+        }
+        if (!popQuery(id, start, end)) continue;
+        NavPath path;
+        SolveInfo info;
+        bool ok;
+        {
+            std::shared_lock<std::shared_mutex> meshLock(meshMutex_);
+            ok = solve(context, start, end, path, info);
+        }
+        finishQuery(id, ok, path, info);
+    }
+}
+
+}  // namespace luma
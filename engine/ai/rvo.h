@@ -0,0 +1,287 @@
+// RVO - neighbor-based local avoidance on the XZ plane
+// SpatialHashGrid: uniform grid hashed into a power-of-two bucket table,
+// rebuilt from scratch each tick by counting sort.
+// computeORCAVelocity: optimal reciprocal collision avoidance (van den Berg
+// et al., "Reciprocal n-Body Collision Avoidance"). Every neighbor adds a
+// half-plane of permitted velocities; a 2D linear program picks the one
+// closest to the preferred velocity, and when the half-planes have no
+// common point a 3D program picks the least-violating velocity instead.
+#pragma once
+
+#include "engine/foundation/math_types.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace luma {
+
+constexpr int RVO_MAX_NEIGHBORS = 16;
+
+// ===== Spatial Hash Grid =====
+class SpatialHashGrid {
+public:
+    // Indexes items [0, count) by (x[i], z[i])
+    void build(const float* x, const float* z, size_t count, float cellSize) {
+        cellSize_ = cellSize > 0.01f ? cellSize : 0.01f;
+        invCellSize_ = 1.0f / cellSize_;
+        uint32_t buckets = 64;
+        while (buckets < count * 2) buckets <<= 1;
+        mask_ = buckets - 1;
+
+        cellStart_.assign(buckets + 1, 0);
+        itemBucket_.resize(count);
+        itemCellX_.resize(count);
+        itemCellZ_.resize(count);
+        items_.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            int32_t cx = cellCoord(x[i]);
+            int32_t cz = cellCoord(z[i]);
+            uint32_t b = bucket(cx, cz);
+            itemBucket_[i] = b;
+            cellStart_[b + 1]++;
+        }
+        for (uint32_t b = 0; b < buckets; b++) cellStart_[b + 1] += cellStart_[b];
+        cursor_.assign(cellStart_.begin(), cellStart_.end() - 1);
+        for (size_t i = 0; i < count; i++) {
+            uint32_t slot = cursor_[itemBucket_[i]]++;
+            items_[slot] = (uint32_t)i;
+            itemCellX_[slot] = cellCoord(x[i]);
+            itemCellZ_[slot] = cellCoord(z[i]);
+        }
+    }
+
+    // Calls fn(index) once for every item in the cells overlapping the
+    // square of half-size radius around (x, z)
+    template<typename F>
+    void query(float x, float z, float radius, F&& fn) const {
+        if (items_.empty()) return;
+        int32_t x0 = cellCoord(x - radius), x1 = cellCoord(x + radius);
+        int32_t z0 = cellCoord(z - radius), z1 = cellCoord(z + radius);
+        for (int32_t cz = z0; cz <= z1; cz++) {
+            for (int32_t cx = x0; cx <= x1; cx++) {
+                uint32_t b = bucket(cx, cz);
+                for (uint32_t s = cellStart_[b]; s < cellStart_[b + 1]; s++) {
+                    // Buckets are shared by colliding cells
+                    if (itemCellX_[s] == cx && itemCellZ_[s] == cz) fn(items_[s]);
+                }
+            }
+        }
+    }
+
+    float getCellSize() const { return cellSize_; }
+    size_t getBucketCount() const { return cellStart_.empty() ? 0 : cellStart_.size() - 1; }
+
+private:
+    int32_t cellCoord(float v) const { return (int32_t)std::floor(v * invCellSize_); }
+    uint32_t bucket(int32_t cx, int32_t cz) const {
+        return ((uint32_t)cx * 73856093u ^ (uint32_t)cz * 19349663u) & mask_;
+    }
+
+    float cellSize_ = 1.0f;
+    float invCellSize_ = 1.0f;
+    uint32_t mask_ = 0;
+    std::vector<uint32_t> cellStart_;
+    std::vector<uint32_t> items_;       // sorted by bucket
+    std::vector<int32_t> itemCellX_;    // cell of items_[s]
+    std::vector<int32_t> itemCellZ_;
+    std::vector<uint32_t> itemBucket_;  // scratch
+    std::vector<uint32_t> cursor_;      // scratch
+};
+
+// ===== Neighbors =====
+struct RVONeighbor {
+    Vec2 position;          // world XZ
+    Vec2 velocity;
+    float radius = 0.0f;
+    float responsibility = 0.5f;  // share of the avoidance this agent takes
+};
+
+// Keeps the closest `capacity` neighbors, sorted by distance
+struct RVONeighborList {
+    RVONeighbor items[RVO_MAX_NEIGHBORS];
+    float distSq[RVO_MAX_NEIGHBORS];
+    int count = 0;
+    int capacity = RVO_MAX_NEIGHBORS;
+
+    void insert(const RVONeighbor& neighbor, float d) {
+        if (count == capacity && d >= distSq[count - 1]) return;
+        int i = count < capacity ? count++ : count - 1;
+        for (; i > 0 && distSq[i - 1] > d; i--) {
+            items[i] = items[i - 1];
+            distSq[i] = distSq[i - 1];
+        }
+        items[i] = neighbor;
+        distSq[i] = d;
+    }
+};
+
+// Avoidance share from NavAgentSettings::avoidancePriority-style values:
+// lower is more important and yields to fewer agents
+inline float rvoResponsibility(int priority, int otherPriority) {
+    int sum = priority + otherPriority;
+    return sum > 0 ? (float)priority / (float)sum : 0.5f;
+}
+
+// ===== ORCA =====
+namespace rvo_detail {
+
+struct Line {
+    Vec2 point;
+    Vec2 direction;  // permitted velocities lie to the left
+};
+
+inline float det(const Vec2& a, const Vec2& b) { return a.x * b.y - a.y * b.x; }
+
+constexpr float kEpsilon = 1e-5f;
+
+// Best point on line `lineNo` satisfying lines [0, lineNo) inside the speed circle
+inline bool linearProgram1(const Line* lines, int lineNo, float radius, const Vec2& optVelocity,
+                           bool directionOpt, Vec2& result) {
+    const Line& line = lines[lineNo];
+    float dot = line.point.dot(line.direction);
+    float discriminant = dot * dot + radius * radius - line.point.lengthSquared();
+    if (discriminant < 0.0f) return false;
+    float sqrtDiscriminant = std::sqrt(discriminant);
+    float tLeft = -dot - sqrtDiscriminant;
+    float tRight = -dot + sqrtDiscriminant;
+
+    for (int i = 0; i < lineNo; i++) {
+        float denominator = det(line.direction, lines[i].direction);
+        float numerator = det(lines[i].direction, line.point - lines[i].point);
+        if (std::abs(denominator) <= kEpsilon) {
+            if (numerator < 0.0f) return false;  // parallel and outside
+            continue;
+        }
+        float t = numerator / denominator;
+        if (denominator >= 0.0f) {
+            tRight = std::min(tRight, t);
+        } else {
+            tLeft = std::max(tLeft, t);
+        }
+        if (tLeft > tRight) return false;
+    }
+
+    if (directionOpt) {
+        result = line.point + line.direction * (optVelocity.dot(line.direction) > 0.0f ? tRight : tLeft);
+    } else {
+        float t = line.direction.dot(optVelocity - line.point);
+        result = line.point + line.direction * std::max(tLeft, std::min(tRight, t));
+    }
+    return true;
+}
+
+// Returns the index of the first line that could not be satisfied, or count
+inline int linearProgram2(const Line* lines, int count, float radius, const Vec2& optVelocity,
+                          bool directionOpt, Vec2& result) {
+    if (directionOpt) {
+        result = optVelocity * radius;
+    } else if (optVelocity.lengthSquared() > radius * radius) {
+        result = optVelocity.normalized() * radius;
+    } else {
+        result = optVelocity;
+    }
+    for (int i = 0; i < count; i++) {
+        if (det(lines[i].direction, lines[i].point - result) > 0.0f) {
+            Vec2 previous = result;
+            if (!linearProgram1(lines, i, radius, optVelocity, directionOpt, result)) {
+                result = previous;
+                return i;
+            }
+        }
+    }
+    return count;
+}
+
+// Minimizes the largest violation of lines [beginLine, count)
+inline void linearProgram3(const Line* lines, int count, int beginLine, float radius, Vec2& result) {
+    float distance = 0.0f;
+    Line projected[RVO_MAX_NEIGHBORS];
+    for (int i = beginLine; i < count; i++) {
+        if (det(lines[i].direction, lines[i].point - result) <= distance) continue;
+        int projectedCount = 0;
+        for (int j = 0; j < i; j++) {
+            Line line;
+            float determinant = det(lines[i].direction, lines[j].direction);
+            if (std::abs(determinant) <= kEpsilon) {
+                if (lines[i].direction.dot(lines[j].direction) > 0.0f) continue;  // same direction
+                line.point = (lines[i].point + lines[j].point) * 0.5f;
+            } else {
+                line.point = lines[i].point +
+                             lines[i].direction * (det(lines[j].direction, lines[i].point - lines[j].point) / determinant);
+            }
+            line.direction = (lines[j].direction - lines[i].direction).normalized();
+            projected[projectedCount++] = line;
+        }
+        Vec2 previous = result;
+        if (linearProgram2(projected, projectedCount, radius, Vec2(-lines[i].direction.y, lines[i].direction.x), true,
+                           result) < projectedCount) {
+            result = previous;  // numerical failure; keep the last good one
+        }
+        distance = det(lines[i].direction, lines[i].point - result);
+    }
+}
+
+}  // namespace rvo_detail
+
+// New velocity for an agent at `position` moving at `velocity` that wants
+// `preferred`; collisions within timeHorizon seconds are avoided
+inline Vec2 computeORCAVelocity(const Vec2& position, const Vec2& velocity, const Vec2& preferred, float radius,
+                                float maxSpeed, const RVONeighbor* neighbors, int count, float timeHorizon, float dt) {
+    using namespace rvo_detail;
+    count = std::min(count, RVO_MAX_NEIGHBORS);
+    Line lines[RVO_MAX_NEIGHBORS];
+    const float invTimeHorizon = 1.0f / timeHorizon;
+
+    for (int n = 0; n < count; n++) {
+        const RVONeighbor& other = neighbors[n];
+        Vec2 relativePosition = other.position - position;
+        Vec2 relativeVelocity = velocity - other.velocity;
+        float distSq = relativePosition.lengthSquared();
+        float combinedRadius = radius + other.radius;
+        float combinedRadiusSq = combinedRadius * combinedRadius;
+
+        Line& line = lines[n];
+        Vec2 u;
+        if (distSq > combinedRadiusSq) {
+            // No collision yet: vector from cutoff center to relative velocity
+            Vec2 w = relativeVelocity - relativePosition * invTimeHorizon;
+            float wLengthSq = w.lengthSquared();
+            float dot1 = w.dot(relativePosition);
+            if (dot1 < 0.0f && dot1 * dot1 > combinedRadiusSq * wLengthSq) {
+                // Project on the cutoff circle
+                float wLength = std::sqrt(wLengthSq);
+                Vec2 unitW = w / wLength;
+                line.direction = Vec2(unitW.y, -unitW.x);
+                u = unitW * (combinedRadius * invTimeHorizon - wLength);
+            } else {
+                // Project on a leg of the velocity obstacle cone
+                float leg = std::sqrt(distSq - combinedRadiusSq);
+                if (det(relativePosition, w) > 0.0f) {
+                    line.direction = Vec2(relativePosition.x * leg - relativePosition.y * combinedRadius,
+                                          relativePosition.x * combinedRadius + relativePosition.y * leg) / distSq;
+                } else {
+                    line.direction = Vec2(relativePosition.x * leg + relativePosition.y * combinedRadius,
+                                          -relativePosition.x * combinedRadius + relativePosition.y * leg) / -distSq;
+                }
+                u = line.direction * relativeVelocity.dot(line.direction) - relativeVelocity;
+            }
+        } else {
+            // Already overlapping: separate within this step
+            float invTimeStep = 1.0f / dt;
+            Vec2 w = relativeVelocity - relativePosition * invTimeStep;
+            float wLength = w.length();
+            Vec2 unitW = wLength > kEpsilon ? w / wLength : Vec2(1.0f, 0.0f);
+            line.direction = Vec2(unitW.y, -unitW.x);
+            u = unitW * (combinedRadius * invTimeStep - wLength);
+        }
+        line.point = velocity + u * other.responsibility;
+    }
+
+    Vec2 result;
+    int failed = linearProgram2(lines, count, maxSpeed, preferred, false, result);
+    if (failed < count) linearProgram3(lines, count, failed, maxSpeed, result);
+    return result;
+}
+
+}  // namespace luma
@@ -0,0 +1,567 @@
+// Tiled NavMesh - heightmap navigation mesh built and edited per tile
+// The heightmap is split into square tiles of tileCells x tileCells cells.
+//   - every tile is triangulated on its own (same slope filter as
+//     NavMesh::buildFromHeightmap), so dirty tiles build in parallel
+//   - height edits and obstacle changes only mark the tiles they touch;
+//     rebuild() rebuilds those and stitches tile borders by matching edges
+//     on shared heightmap samples
+//   - built tiles can be saved to a binary cache; loadCache() takes the
+//     polygons of every tile whose inputs (samples, obstacles, settings)
+//     still hash the same, and refills its vertices from the heightmap
+// The stitched result is a plain NavMesh, so NavPathfinder,
+// NavPathQueryService and Crowd use it unchanged.
+#pragma once
+
+#include "navmesh.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace luma {
+
+// ===== Tile Settings =====
+struct NavTileSettings {
+    int tileCells = 32;   // heightmap cells per tile side
+    int threads = 0;      // build threads; 0 = hardware concurrency
+};
+
+struct NavTileStats {
+    size_t tiles = 0;
+    size_t dirtyTiles = 0;       // still waiting for rebuild()
+    size_t tilesBuilt = 0;       // by the last rebuild()
+    size_t tilesFromCache = 0;   // by the last loadCache()
+    size_t polygons = 0;
+    double buildMs = 0.0;        // last rebuild(): tile triangulation
+    double stitchMs = 0.0;       // last rebuild(): concatenation and border links
+    double totalMs = 0.0;
+};
+
+// ===== Tiled NavMesh =====
+class TiledNavMesh {
+public:
+    // Copies the heights (0..1, scaled by maxHeight) and marks every tile dirty
+    bool setHeightmap(const float* heights, int width, int height,
+                      float worldWidth, float worldHeight, float maxHeight,
+                      const NavMeshBuildSettings& settings = {},
+                      const NavTileSettings& tileSettings = {});
+    // Overwrites a w x h block of samples starting at (x0, z0)
+    bool setHeights(int x0, int z0, int w, int h, const float* data);
+
+    // Box obstacles block every cell whose center lies inside their XZ
+    // footprint grown by agentRadius
+    int addObstacle(const Vec3& minBounds, const Vec3& maxBounds);
+    bool moveObstacle(int id, const Vec3& minBounds, const Vec3& maxBounds);
+    bool removeObstacle(int id);
+
+    void markDirty(const Vec3& minBounds, const Vec3& maxBounds);
+    void markAllDirty();
+
+    // Builds dirty tiles and restitches the NavMesh
+    bool rebuild();
+
+    const NavMesh& getNavMesh() const { return navMesh_; }
+    // Tile of a NavMesh polygon, -1 if out of range
+    int getPolyTile(int poly) const {
+        return poly >= 0 && poly < (int)polyTile_.size() ? polyTile_[poly] : -1;
+    }
+    int getTilesX() const { return tilesX_; }
+    int getTilesZ() const { return tilesZ_; }
+
+    // Binary tile cache. loadCache needs the current heightmap (and
+    // obstacles) first; outdated tiles stay dirty and are built right away.
+    bool saveCache(const std::string& path) const;
+    bool loadCache(const std::string& path);
+
+    const NavTileStats& getStats() const { return stats_; }
+    const std::string& getLastError() const { return lastError_; }
+
+private:
+    struct Tile {
+        int x0 = 0, z0 = 0;           // first cell
+        int cellsX = 0, cellsZ = 0;
+        std::vector<Vec3> vertices;   // (cellsX + 1) x (cellsZ + 1) sample grid
+        std::vector<NavPoly> polygons;  // tile-local indices and neighbors
+        uint64_t inputHash = 0;
+        bool dirty = true;
+    };
+
+    struct Obstacle {
+        Vec3 minBounds, maxBounds;
+        bool active = false;
+    };
+
+    struct CacheHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t width, height;
+        uint32_t tileCells;
+        uint32_t tileCount;
+    };
+
+    struct CacheTile {
+        uint64_t inputHash;
+        uint32_t polyCount;
+        uint32_t reserved;
+    };
+
+    static constexpr uint32_t CACHE_VERSION = 1;
+
+    void fillVertices(Tile& tile) const;
+    void buildTile(Tile& tile) const;
+    uint64_t hashTile(const Tile& tile) const;
+    bool cellBlocked(int x, int z) const;
+    void markCells(int x0, int z0, int x1, int z1);
+    void markFootprint(const Vec3& minBounds, const Vec3& maxBounds);
+    void stitch();
+
+    float worldX(int x) const { return x * cellSizeX_ - worldWidth_ * 0.5f; }
+    float worldZ(int z) const { return z * cellSizeZ_ - worldHeight_ * 0.5f; }
+
+    bool fail(const std::string& message) const {
+        lastError_ = message;
+        return false;
+    }
+
+    NavMeshBuildSettings settings_;
+    NavTileSettings tileSettings_;
+    std::vector<float> heights_;
+    int width_ = 0, height_ = 0;
+    float worldWidth_ = 0.0f, worldHeight_ = 0.0f, maxHeight_ = 0.0f;
+    float cellSizeX_ = 0.0f, cellSizeZ_ = 0.0f;
+
+    int tilesX_ = 0, tilesZ_ = 0;
+    std::vector<Tile> tiles_;
+    std::vector<Obstacle> obstacles_;
+
+    NavMesh navMesh_;
+    std::vector<int> polyTile_;
+    NavTileStats stats_;
+    mutable std::string lastError_;
+};
+
+// ===== Tiled NavMesh Implementation =====
+
+inline bool TiledNavMesh::setHeightmap(const float* heights, int width, int height,
+                                       float worldWidth, float worldHeight, float maxHeight,
+                                       const NavMeshBuildSettings& settings,
+                                       const NavTileSettings& tileSettings) {
+    if (!heights || width < 2 || height < 2) return fail("heightmap needs at least 2x2 samples");
+    if (tileSettings.tileCells < 1) return fail("tileCells must be positive");
+
+    settings_ = settings;
+    tileSettings_ = tileSettings;
+    heights_.assign(heights, heights + (size_t)width * height);
+    width_ = width;
+    height_ = height;
+    worldWidth_ = worldWidth;
+    worldHeight_ = worldHeight;
+    maxHeight_ = maxHeight;
+    cellSizeX_ = worldWidth / (width - 1);
+    cellSizeZ_ = worldHeight / (height - 1);
+
+    int cells = tileSettings.tileCells;
+    tilesX_ = (width - 1 + cells - 1) / cells;
+    tilesZ_ = (height - 1 + cells - 1) / cells;
+    tiles_.assign((size_t)tilesX_ * tilesZ_, Tile());
+    for (int tz = 0; tz < tilesZ_; tz++) {
+        for (int tx = 0; tx < tilesX_; tx++) {
+            Tile& tile = tiles_[tz * tilesX_ + tx];
+            tile.x0 = tx * cells;
+            tile.z0 = tz * cells;
+            tile.cellsX = std::min(cells, width - 1 - tile.x0);
+            tile.cellsZ = std::min(cells, height - 1 - tile.z0);
+        }
+    }
+
+    navMesh_.clear();
+    polyTile_.clear();
+    stats_ = NavTileStats();
+    stats_.tiles = tiles_.size();
+    stats_.dirtyTiles = tiles_.size();
+    return true;
+}
+
+inline bool TiledNavMesh::setHeights(int x0, int z0, int w, int h, const float* data) {
+    if (!data || w <= 0 || h <= 0 || x0 < 0 || z0 < 0 || x0 + w > width_ || z0 + h > height_) {
+        return fail("height block outside the heightmap");
+    }
+    for (int z = 0; z < h; z++) {
+        std::memcpy(&heights_[(size_t)(z0 + z) * width_ + x0], data + (size_t)z * w, w * sizeof(float));
+    }
+    // A sample touches the cells on both sides of it
+    markCells(x0 - 1, z0 - 1, x0 + w - 1, z0 + h - 1);
+    return true;
+}
+
+inline int TiledNavMesh::addObstacle(const Vec3& minBounds, const Vec3& maxBounds) {
+    int id = 0;
+    while (id < (int)obstacles_.size() && obstacles_[id].active) id++;
+    if (id == (int)obstacles_.size()) obstacles_.emplace_back();
+    obstacles_[id] = {minBounds, maxBounds, true};
+    markFootprint(minBounds, maxBounds);
+    return id;
+}
+
+inline bool TiledNavMesh::moveObstacle(int id, const Vec3& minBounds, const Vec3& maxBounds) {
+    if (id < 0 || id >= (int)obstacles_.size() || !obstacles_[id].active) return fail("unknown obstacle");
+    markFootprint(obstacles_[id].minBounds, obstacles_[id].maxBounds);
+    obstacles_[id].minBounds = minBounds;
+    obstacles_[id].maxBounds = maxBounds;
+    markFootprint(minBounds, maxBounds);
+    return true;
+}
+
+inline bool TiledNavMesh::removeObstacle(int id) {
+    if (id < 0 || id >= (int)obstacles_.size() || !obstacles_[id].active) return fail("unknown obstacle");
+    markFootprint(obstacles_[id].minBounds, obstacles_[id].maxBounds);
+    obstacles_[id].active = false;
+    return true;
+}
+
+inline void TiledNavMesh::markDirty(const Vec3& minBounds, const Vec3& maxBounds) {
+    if (tiles_.empty()) return;
+    markCells((int)std::floor((minBounds.x + worldWidth_ * 0.5f) / cellSizeX_),
+              (int)std::floor((minBounds.z + worldHeight_ * 0.5f) / cellSizeZ_),
+              (int)std::floor((maxBounds.x + worldWidth_ * 0.5f) / cellSizeX_),
+              (int)std::floor((maxBounds.z + worldHeight_ * 0.5f) / cellSizeZ_));
+}
+
+inline void TiledNavMesh::markAllDirty() {
+    for (auto& tile : tiles_) tile.dirty = true;
+    stats_.dirtyTiles = tiles_.size();
+}
+
+inline void TiledNavMesh::markFootprint(const Vec3& minBounds, const Vec3& maxBounds) {
+    Vec3 grow(settings_.agentRadius, 0.0f, settings_.agentRadius);
+    markDirty(minBounds - grow, maxBounds + grow);
+}
+
+inline void TiledNavMesh::markCells(int x0, int z0, int x1, int z1) {
+    if (tiles_.empty()) return;
+    int cells = tileSettings_.tileCells;
+    int tx0 = std::max(0, x0) / cells, tz0 = std::max(0, z0) / cells;
+    int tx1 = std::min(x1, width_ - 2) / cells, tz1 = std::min(z1, height_ - 2) / cells;
+    if (x1 < 0 || z1 < 0) return;
+    for (int tz = tz0; tz <= tz1; tz++) {
+        for (int tx = tx0; tx <= tx1; tx++) {
+            Tile& tile = tiles_[tz * tilesX_ + tx];
+            if (!tile.dirty) stats_.dirtyTiles++;
+            tile.dirty = true;
+        }
+    }
+}
+
+inline bool TiledNavMesh::cellBlocked(int x, int z) const {
+    float cx = worldX(x) + cellSizeX_ * 0.5f;
+    float cz = worldZ(z) + cellSizeZ_ * 0.5f;
+    float r = settings_.agentRadius;
+    for (const auto& o : obstacles_) {
+        if (o.active && cx >= o.minBounds.x - r && cx <= o.maxBounds.x + r &&
+            cz >= o.minBounds.z - r && cz <= o.maxBounds.z + r) {
+            return true;
+        }
+    }
+    return false;
+}
+
+inline uint64_t TiledNavMesh::hashTile(const Tile& tile) const {
+    uint64_t hash = 14695981039346656037ull;  // FNV-1a
+    auto mix = [&hash](const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+
+    float params[] = {settings_.agentMaxSlope, settings_.agentRadius, cellSizeX_, cellSizeZ_, maxHeight_,
+                      worldX(tile.x0), worldZ(tile.z0)};
+    mix(params, sizeof(params));
+    for (int z = 0; z <= tile.cellsZ; z++) {
+        mix(&heights_[(size_t)(tile.z0 + z) * width_ + tile.x0], (tile.cellsX + 1) * sizeof(float));
+    }
+    // Only blocked cells matter, so obstacles hash through the cells they cover
+    for (int z = 0; z < tile.cellsZ; z++) {
+        uint64_t row = 0;
+        for (int x = 0; x < tile.cellsX; x++) {
+            if (cellBlocked(tile.x0 + x, tile.z0 + z)) row = row * 31 + x + 1;
+        }
+        mix(&row, sizeof(row));
+    }
+    return hash;
+}
+
+inline void TiledNavMesh::fillVertices(Tile& tile) const {
+    tile.vertices.clear();
+    tile.vertices.reserve((size_t)(tile.cellsX + 1) * (tile.cellsZ + 1));
+    for (int z = 0; z <= tile.cellsZ; z++) {
+        for (int x = 0; x <= tile.cellsX; x++) {
+            int gx = tile.x0 + x, gz = tile.z0 + z;
+            tile.vertices.push_back(Vec3(worldX(gx), heights_[(size_t)gz * width_ + gx] * maxHeight_, worldZ(gz)));
+        }
+    }
+}
+
+inline void TiledNavMesh::buildTile(Tile& tile) const {
+    const int stride = tile.cellsX + 1;
+    fillVertices(tile);
+    tile.polygons.clear();
+
+    auto addTriangle = [&tile](int a, int b, int c, const Vec3& normal) {
+        NavPoly poly;
+        poly.indices[0] = a;
+        poly.indices[1] = b;
+        poly.indices[2] = c;
+        poly.vertCount = 3;
+        poly.normal = normal;
+        for (int j = 0; j < NAV_MAX_VERTS_PER_POLY; j++) poly.neighbors[j] = -1;
+        const Vec3& v0 = tile.vertices[a];
+        const Vec3& v1 = tile.vertices[b];
+        const Vec3& v2 = tile.vertices[c];
+        poly.center = (v0 + v1 + v2) * (1.0f / 3.0f);
+        poly.area = (v1 - v0).cross(v2 - v0).length() * 0.5f;
+        tile.polygons.push_back(poly);
+    };
+
+    // Same triangulation and slope test as NavMesh::buildFromHeightmap
+    const float maxSlope = settings_.agentMaxSlope;
+    auto slope = [](const Vec3& n) {
+        return std::acos(std::max(-1.0f, std::min(1.0f, n.y))) * 180.0f / 3.14159f;
+    };
+    // Polygons of the previous cell row, to link edges without a hash map
+    std::vector<int> lastRow(tile.cellsX * 2, -1), row(tile.cellsX * 2, -1);
+    for (int z = 0; z < tile.cellsZ; z++) {
+        std::fill(row.begin(), row.end(), -1);
+        for (int x = 0; x < tile.cellsX; x++) {
+            if (cellBlocked(tile.x0 + x, tile.z0 + z)) continue;
+            int i00 = z * stride + x;
+            int i10 = i00 + 1;
+            int i01 = i00 + stride;
+            int i11 = i01 + 1;
+            const Vec3& v0 = tile.vertices[i00];
+            const Vec3& v1 = tile.vertices[i10];
+            const Vec3& v2 = tile.vertices[i01];
+            const Vec3& v3 = tile.vertices[i11];
+
+            Vec3 normal1 = (v2 - v0).cross(v1 - v0).normalized();
+            if (slope(normal1) <= maxSlope) {
+                row[x * 2] = (int)tile.polygons.size();
+                addTriangle(i00, i10, i01, normal1);
+            }
+            Vec3 normal2 = (v2 - v1).cross(v3 - v1).normalized();
+            if (slope(normal2) <= maxSlope) {
+                row[x * 2 + 1] = (int)tile.polygons.size();
+                addTriangle(i10, i11, i01, normal2);
+            }
+        }
+
+        // Edges: tri1 (00-10, 10-01, 01-00), tri2 (10-11, 11-01, 01-10)
+        for (int x = 0; x < tile.cellsX; x++) {
+            int t1 = row[x * 2], t2 = row[x * 2 + 1];
+            auto link = [&tile](int a, int edgeA, int b, int edgeB) {
+                if (a < 0 || b < 0) return;
+                tile.polygons[a].neighbors[edgeA] = b;
+                tile.polygons[b].neighbors[edgeB] = a;
+            };
+            link(t1, 1, t2, 2);                                  // diagonal
+            if (x > 0) link(t1, 2, row[(x - 1) * 2 + 1], 0);     // left cell's tri2
+            if (z > 0) link(t1, 0, lastRow[x * 2 + 1], 1);       // lower row's tri2
+        }
+        std::swap(row, lastRow);
+    }
+}
+
+inline bool TiledNavMesh::rebuild() {
+    if (tiles_.empty()) return fail("no heightmap");
+    auto t0 = std::chrono::high_resolution_clock::now();
+
+    std::vector<int> dirty;
+    for (size_t i = 0; i < tiles_.size(); i++) {
+        if (tiles_[i].dirty) dirty.push_back((int)i);
+    }
+
+    // Tiles only read shared state, so workers pull them from a counter
+    std::atomic<size_t> next{0};
+    auto work = [&] {
+        for (size_t i = next++; i < dirty.size(); i = next++) {
+            Tile& tile = tiles_[dirty[i]];
+            buildTile(tile);
+            tile.inputHash = hashTile(tile);
+            tile.dirty = false;
+        }
+    };
+    size_t threads = tileSettings_.threads > 0
+        ? (size_t)tileSettings_.threads
+        : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, dirty.size());
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; t++) workers.emplace_back(work);
+    work();
+    for (auto& worker : workers) worker.join();
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    stitch();
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    stats_.tilesBuilt = dirty.size();
+    stats_.dirtyTiles = 0;
+    stats_.polygons = navMesh_.getPolyCount();
+    stats_.buildMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    stats_.stitchMs = std::chrono::duration<double, std::milli>(t2 - t1).count();
+    stats_.totalMs = stats_.buildMs + stats_.stitchMs;
+    return true;
+}
+
+inline void TiledNavMesh::stitch() {
+    size_t vertexCount = 0, polyCount = 0;
+    for (const auto& tile : tiles_) {
+        vertexCount += tile.vertices.size();
+        polyCount += tile.polygons.size();
+    }
+    std::vector<Vec3> vertices;
+    std::vector<NavPoly> polygons;
+    vertices.reserve(vertexCount);
+    polygons.reserve(polyCount);
+    polyTile_.clear();
+    polyTile_.reserve(polyCount);
+
+    // Open border edges keyed by their heightmap samples (from << 32 | to);
+    // the neighboring tile's matching edge runs the other way
+    std::unordered_map<uint64_t, std::pair<int, int>> border;
+    for (size_t t = 0; t < tiles_.size(); t++) {
+        const Tile& tile = tiles_[t];
+        const int stride = tile.cellsX + 1;
+        int vertexBase = (int)vertices.size();
+        int polyBase = (int)polygons.size();
+        vertices.insert(vertices.end(), tile.vertices.begin(), tile.vertices.end());
+
+        for (size_t p = 0; p < tile.polygons.size(); p++) {
+            const NavPoly& local = tile.polygons[p];
+            NavPoly poly = local;
+            int global = polyBase + (int)p;
+            for (int e = 0; e < poly.vertCount; e++) {
+                int a = local.indices[e], b = local.indices[(e + 1) % local.vertCount];
+                poly.indices[e] = vertexBase + a;
+                if (poly.neighbors[e] >= 0) {
+                    poly.neighbors[e] += polyBase;
+                    continue;
+                }
+
+                int ax = a % stride, az = a / stride, bx = b % stride, bz = b / stride;
+                bool onBorder = (ax == bx && (ax == 0 || ax == tile.cellsX)) ||
+                                (az == bz && (az == 0 || az == tile.cellsZ));
+                if (!onBorder) continue;
+                uint64_t sa = (uint64_t)(tile.z0 + az) * width_ + tile.x0 + ax;
+                uint64_t sb = (uint64_t)(tile.z0 + bz) * width_ + tile.x0 + bx;
+                auto it = border.find((sb << 32) | sa);
+                if (it != border.end()) {
+                    poly.neighbors[e] = it->second.first;
+                    polygons[it->second.first].neighbors[it->second.second] = global;
+                    border.erase(it);
+                } else {
+                    border[(sa << 32) | sb] = {global, e};
+                }
+            }
+            polygons.push_back(poly);
+            polyTile_.push_back((int)t);
+        }
+    }
+
+    navMesh_.assign(std::move(vertices), std::move(polygons));
+}
+
+// ===== Tile Cache =====
+
+inline bool TiledNavMesh::saveCache(const std::string& path) const {
+    if (tiles_.empty()) return fail("no heightmap");
+    for (const auto& tile : tiles_) {
+        if (tile.dirty) return fail("rebuild() dirty tiles before saving");
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return fail("cannot open " + path);
+
+    CacheHeader header = {};
+    std::memcpy(header.magic, "LNVT", 4);
+    header.version = CACHE_VERSION;
+    header.width = (uint32_t)width_;
+    header.height = (uint32_t)height_;
+    header.tileCells = (uint32_t)tileSettings_.tileCells;
+    header.tileCount = (uint32_t)tiles_.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const auto& tile : tiles_) {
+        CacheTile record = {tile.inputHash, (uint32_t)tile.polygons.size(), 0};
+        file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        file.write(reinterpret_cast<const char*>(tile.polygons.data()), tile.polygons.size() * sizeof(NavPoly));
+    }
+    if (!file) return fail("write failed: " + path);
+    return true;
+}
+
+inline bool TiledNavMesh::loadCache(const std::string& path) {
+    if (tiles_.empty()) return fail("set the heightmap before loading a tile cache");
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return fail("cannot open " + path);
+
+    CacheHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return fail("truncated tile cache");
+    if (std::memcmp(header.magic, "LNVT", 4) != 0) return fail("not a tile cache");
+    if (header.version != CACHE_VERSION) return fail("unsupported tile cache version");
+    if (header.width != (uint32_t)width_ || header.height != (uint32_t)height_ ||
+        header.tileCells != (uint32_t)tileSettings_.tileCells || header.tileCount != tiles_.size()) {
+        return fail("tile cache was built for a different heightmap layout");
+    }
+
+    // Read and validate everything before touching the tiles
+    std::vector<uint64_t> hashes(tiles_.size());
+    std::vector<std::vector<NavPoly>> polygons(tiles_.size());
+    for (size_t t = 0; t < tiles_.size(); t++) {
+        const Tile& tile = tiles_[t];
+        CacheTile record;
+        if (!file.read(reinterpret_cast<char*>(&record), sizeof(record))) return fail("truncated tile cache");
+        if (record.polyCount > (uint32_t)(tile.cellsX * tile.cellsZ * 2)) return fail("corrupt tile cache");
+        hashes[t] = record.inputHash;
+        polygons[t].resize(record.polyCount);
+        if (!file.read(reinterpret_cast<char*>(polygons[t].data()), record.polyCount * sizeof(NavPoly))) {
+            return fail("truncated tile cache");
+        }
+
+        const int vertexCount = (tile.cellsX + 1) * (tile.cellsZ + 1);
+        for (const NavPoly& poly : polygons[t]) {
+            if (poly.vertCount < 3 || poly.vertCount > NAV_MAX_VERTS_PER_POLY) return fail("corrupt tile cache");
+            for (int e = 0; e < poly.vertCount; e++) {
+                if (poly.indices[e] < 0 || poly.indices[e] >= vertexCount ||
+                    poly.neighbors[e] < -1 || poly.neighbors[e] >= (int)record.polyCount) {
+                    return fail("corrupt tile cache");
+                }
+            }
+        }
+    }
+
+    // Take the tiles whose inputs are unchanged; the rest are rebuilt
+    size_t fromCache = 0;
+    for (size_t t = 0; t < tiles_.size(); t++) {
+        Tile& tile = tiles_[t];
+        if (hashes[t] != hashTile(tile)) {
+            if (!tile.dirty) stats_.dirtyTiles++;
+            tile.dirty = true;
+            continue;
+        }
+        fillVertices(tile);
+        tile.polygons.swap(polygons[t]);
+        tile.inputHash = hashes[t];
+        if (tile.dirty) stats_.dirtyTiles--;
+        tile.dirty = false;
+        fromCache++;
+    }
+
+    bool ok = rebuild();
+    stats_.tilesFromCache = fromCache;
+    return ok;
+}
+
+} // namespace luma
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "engine/foundation/math_types.h"
+#include "engine/audio/audio_spectrum.h"
 #include <string>
 #include <vector>
 #include <array>
@@ -10,6 +11,8 @@
 #include <functional>
 #include <cmath>
 #include <deque>
+#include <thread>
+#include <algorithm>
 
 namespace luma {
 
@@ -88,6 +91,9 @@ inline std::string visemeToString(Viseme v) {
 struct VisemeBlendShapes {
     // ARKit-style BlendShape names and weights for each viseme
     std::unordered_map<std::string, float> shapes;
+    
+    VisemeBlendShapes() = default;
+    VisemeBlendShapes(std::initializer_list<std::pair<const std::string, float>> weights) : shapes(weights) {}
 };
 
 class VisemeMapping {
@@ -324,8 +330,14 @@ struct AudioFrame {
     float spectralCentroid = 0;
 };
 
+// Features of one analysis window. Spectrum bands are octaves from 100 Hz
+// (100-200, 200-400, ... 12.8-25.6 kHz), each the RMS amplitude of the
+// signal within the band.
 class AudioAnalyzer {
 public:
+    static constexpr int kBands = 8;
+    static constexpr float kLowestBandHz = 100.0f;
+    
     // Analyze audio samples
     // samples: mono audio data, sampleRate: e.g., 44100
     AudioFrame analyze(const float* samples, int numSamples, float sampleRate, float timestamp) {
@@ -350,11 +362,13 @@ public:
         }
         frame.zeroCrossingRate = static_cast<float>(crossings) / numSamples;
         
-        // Simple pitch estimation using autocorrelation
+        prepare(numSamples, sampleRate);
+        
+        // Pitch from the autocorrelation
         frame.pitch = estimatePitch(samples, numSamples, sampleRate);
         
-        // Simple spectrum analysis (8 bands)
-        analyzeSpectrum(samples, numSamples, sampleRate, frame.spectrum);
+        // Octave band spectrum and spectral centroid from one FFT
+        analyzeSpectrum(samples, numSamples, frame);
         
         // Energy (sum of spectrum)
         frame.energy = 0;
@@ -362,68 +376,162 @@ public:
             frame.energy += band;
         }
         
-        // Spectral centroid
-        float weightedSum = 0;
-        float totalWeight = 0;
-        for (int i = 0; i < 8; i++) {
-            float freq = (i + 0.5f) * sampleRate / 16.0f;
-            weightedSum += freq * frame.spectrum[i];
-            totalWeight += frame.spectrum[i];
-        }
-        frame.spectralCentroid = (totalWeight > 0) ? weightedSum / totalWeight : 0;
-        
         return frame;
     }
     
 private:
+    // FFT sizes, window and bands follow the frame length and sample rate
+    void prepare(int numSamples, float sampleRate) {
+        if (numSamples == preparedSamples_ && sampleRate == preparedRate_) return;
+        preparedSamples_ = numSamples;
+        preparedRate_ = sampleRate;
+        
+        size_t size = 8;
+        while (size < (size_t)numSamples) size <<= 1;
+        spectrumFft_.resize(size);
+        pitchFft_.resize(size * 2);  // Zero padded so the correlation does not wrap
+        
+        // Hann window, and the scale turning band power into RMS amplitude
+        window_.resize(numSamples);
+        float windowPower = 0.0f;
+        for (int i = 0; i < numSamples; i++) {
+            window_[i] = 0.5f - 0.5f * std::cos(2.0f * 3.14159265f * i / std::max(1, numSamples - 1));
+            windowPower += window_[i] * window_[i];
+        }
+        bandScale_ = 2.0f / (std::max(windowPower, 1e-6f) * (float)size);
+        octaves_ = dsp::FilterBank::octave(kBands, size, sampleRate, kLowestBandHz);
+        
+        size_t bins = pitchFft_.bins();
+        input_.assign(pitchFft_.size(), 0.0f);
+        re_.assign(bins, 0.0f);
+        im_.assign(bins, 0.0f);
+        power_.assign(bins, 0.0f);
+    }
+    
+    // Autocorrelation via the Wiener-Khinchin theorem: inverse FFT of the
+    // power spectrum. Searches lags between 80 and 500 Hz.
     float estimatePitch(const float* samples, int numSamples, float sampleRate) {
-        // Simple autocorrelation-based pitch detection
         int minLag = static_cast<int>(sampleRate / 500);   // Max 500 Hz
         int maxLag = static_cast<int>(sampleRate / 80);    // Min 80 Hz
         
         if (maxLag >= numSamples) maxLag = numSamples - 1;
         
+        std::copy(samples, samples + numSamples, input_.begin());
+        std::fill(input_.begin() + numSamples, input_.end(), 0.0f);
+        pitchFft_.powerSpectrum(input_.data(), power_.data(), re_.data(), im_.data());
+        std::fill(im_.begin(), im_.end(), 0.0f);
+        pitchFft_.inverse(power_.data(), im_.data(), input_.data());
+        
         float maxCorr = 0;
-        int bestLag = minLag;
+        for (int lag = minLag; lag <= maxLag; lag++) {
+            input_[lag] /= (numSamples - lag);
+            maxCorr = std::max(maxCorr, input_[lag]);
+        }
         
+        // The first peak close to the maximum, so multiples of the period
+        // (which correlate just as well) do not halve the pitch
+        int bestLag = minLag;
         for (int lag = minLag; lag <= maxLag; lag++) {
-            float corr = 0;
-            for (int i = 0; i < numSamples - lag; i++) {
-                corr += samples[i] * samples[i + lag];
-            }
-            corr /= (numSamples - lag);
-            
-            if (corr > maxCorr) {
-                maxCorr = corr;
+            bool peak = (lag == maxLag || input_[lag] >= input_[lag + 1]) &&
+                        (lag == minLag || input_[lag] >= input_[lag - 1]);
+            if (maxCorr > 0 && peak && input_[lag] >= maxCorr * 0.9f) {
                 bestLag = lag;
+                break;
             }
         }
         
         return sampleRate / bestLag;
     }
     
-    void analyzeSpectrum(const float* samples, int numSamples, float sampleRate,
-                         std::array<float, 8>& spectrum) {
-        // Simple filter bank analysis (not FFT for simplicity)
-        // Band edges roughly: 100, 200, 400, 800, 1600, 3200, 6400, 12800 Hz
-        
-        std::fill(spectrum.begin(), spectrum.end(), 0.0f);
+    void analyzeSpectrum(const float* samples, int numSamples, AudioFrame& frame) {
+        size_t size = spectrumFft_.size();
+        for (int i = 0; i < numSamples; i++) input_[i] = samples[i] * window_[i];
+        std::fill(input_.begin() + numSamples, input_.begin() + size, 0.0f);
+        spectrumFft_.powerSpectrum(input_.data(), power_.data(), re_.data(), im_.data());
+        
+        float bands[kBands];
+        octaves_.apply(power_.data(), bands);
+        for (int b = 0; b < kBands; b++) {
+            frame.spectrum[b] = std::sqrt(bands[b] * bandScale_);
+        }
         
-        // Use simple bandpass filters
-        for (int band = 0; band < 8; band++) {
-            float lowFreq = 100.0f * std::pow(2.0f, band);
-            float highFreq = 100.0f * std::pow(2.0f, band + 1);
+        // Power-weighted mean frequency
+        float binHz = preparedRate_ / (float)size;
+        float weightedSum = 0;
+        float totalWeight = 0;
+        for (size_t k = 1; k < spectrumFft_.bins(); k++) {
+            weightedSum += k * binHz * power_[k];
+            totalWeight += power_[k];
+        }
+        frame.spectralCentroid = (totalWeight > 0) ? weightedSum / totalWeight : 0;
+    }
+    
+    int preparedSamples_ = 0;
+    float preparedRate_ = 0.0f;
+    dsp::RealFFT spectrumFft_{8};
+    dsp::RealFFT pitchFft_{8};
+    dsp::FilterBank octaves_ = dsp::FilterBank::octave(kBands, 8, 44100.0f, kLowestBandHz);
+    std::vector<float> window_;
+    std::vector<float> input_, re_, im_, power_;
+    float bandScale_ = 1.0f;
+};
+
+// ============================================================================
+// Streaming Audio Analysis
+// ============================================================================
+
+// Analyzes live audio as it arrives: overlapping windows of `windowSize`
+// samples every `hopSize` samples, whatever the size of the pushed blocks.
+// A sample shows up in a frame at most one window after it was pushed.
+class StreamingAudioAnalyzer {
+public:
+    StreamingAudioAnalyzer(float sampleRate = 44100.0f, int windowSize = 1024, int hopSize = 512)
+        : sampleRate_(sampleRate), windowSize_(std::max(8, windowSize)),
+          hopSize_(std::clamp(hopSize, 1, std::max(8, windowSize))) {
+        buffer_.assign(windowSize_, 0.0f);
+    }
+    
+    // Feed a block of mono samples; completed frames are appended to `frames`.
+    // Returns the number of frames added.
+    size_t push(const float* samples, size_t count, std::vector<AudioFrame>& frames) {
+        size_t added = 0;
+        while (count > 0) {
+            size_t take = std::min(count, (size_t)(windowSize_ - filled_));
+            std::copy(samples, samples + take, buffer_.begin() + filled_);
+            filled_ += (int)take;
+            samples += take;
+            count -= take;
             
-            // Simple energy measurement with frequency weighting
-            float energy = 0;
-            for (int i = 1; i < numSamples; i++) {
-                float diff = samples[i] - samples[i-1];
-                // Higher bands respond more to rapid changes
-                energy += diff * diff * (1.0f + band * 0.5f);
+            if (filled_ == windowSize_) {
+                float timestamp = (float)((double)windowStart_ / sampleRate_);
+                frames.push_back(analyzer_.analyze(buffer_.data(), windowSize_, sampleRate_, timestamp));
+                added++;
+                // Keep the overlap for the next window
+                std::copy(buffer_.begin() + hopSize_, buffer_.end(), buffer_.begin());
+                filled_ = windowSize_ - hopSize_;
+                windowStart_ += hopSize_;
             }
-            spectrum[band] = std::sqrt(energy / numSamples);
         }
+        return added;
+    }
+    
+    void reset() {
+        filled_ = 0;
+        windowStart_ = 0;
     }
+    
+    // Worst-case delay between a sample arriving and its frame, in seconds
+    float getLatency() const { return windowSize_ / sampleRate_; }
+    float getFrameInterval() const { return hopSize_ / sampleRate_; }
+    
+private:
+    AudioAnalyzer analyzer_;
+    float sampleRate_;
+    int windowSize_;
+    int hopSize_;
+    std::vector<float> buffer_;
+    int filled_ = 0;
+    uint64_t windowStart_ = 0;  // Sample index of buffer_[0]
 };
 
 // ============================================================================
@@ -642,12 +750,10 @@ struct LipSyncTrack {
     std::pair<Viseme, float> sample(float time) const {
         if (keyframes.empty()) return {Viseme::Silence, 0};
         
-        // Find surrounding keyframes
-        int idx = 0;
-        for (size_t i = 0; i < keyframes.size(); i++) {
-            if (keyframes[i].time > time) break;
-            idx = static_cast<int>(i);
-        }
+        // Last keyframe at or before `time` (the first one before the start)
+        auto it = std::upper_bound(keyframes.begin(), keyframes.end(), time,
+            [](float t, const VisemeKeyframe& kf) { return t < kf.time; });
+        size_t idx = it == keyframes.begin() ? 0 : (size_t)(it - keyframes.begin()) - 1;
         
         return {keyframes[idx].viseme, keyframes[idx].weight};
     }
@@ -659,10 +765,11 @@ struct LipSyncTrack {
         kf.viseme = viseme;
         kf.weight = weight;
         
-        // Insert sorted
-        auto it = keyframes.begin();
-        while (it != keyframes.end() && it->time < time) {
-            ++it;
+        // Insert sorted (appending is the common case)
+        auto it = keyframes.end();
+        if (!keyframes.empty() && keyframes.back().time >= time) {
+            it = std::lower_bound(keyframes.begin(), keyframes.end(), time,
+                [](const VisemeKeyframe& k, float t) { return k.time < t; });
         }
         keyframes.insert(it, kf);
         
@@ -676,30 +783,28 @@ struct LipSyncTrack {
 
 class LipSyncGenerator {
 public:
-    // Generate lip sync track from audio data
+    // Generate lip sync track from audio data. Frames are analyzed in
+    // parallel on `threads` workers (0 = one per core); classification then
+    // runs in order, so the track does not depend on the thread count.
     LipSyncTrack generate(const float* samples, int numSamples, float sampleRate,
-                          const LipSyncSettings& settings = {}) {
+                          const LipSyncSettings& settings = {}, unsigned threads = 0) {
         LipSyncTrack track;
         track.name = "Generated";
         
         LipSyncEngine engine;
-        AudioAnalyzer analyzer;
         
         // Process audio in chunks
         int chunkSize = static_cast<int>(sampleRate / 30.0f);  // ~30 fps
-        int numChunks = numSamples / chunkSize;
+        int numChunks = chunkSize > 0 ? numSamples / chunkSize : 0;
+        
+        std::vector<AudioFrame> frames(numChunks);
+        analyzeChunks(samples, chunkSize, sampleRate, frames, threads);
         
         Viseme lastViseme = Viseme::Silence;
         
         for (int i = 0; i < numChunks; i++) {
             float time = static_cast<float>(i * chunkSize) / sampleRate;
-            
-            AudioFrame frame = analyzer.analyze(
-                samples + i * chunkSize, 
-                chunkSize, 
-                sampleRate, 
-                time
-            );
+            const AudioFrame& frame = frames[i];
             
             engine.process(frame, settings);
             Viseme currentViseme = engine.getCurrentViseme();
@@ -734,6 +839,35 @@ public:
     }
     
 private:
+    // Chunks are split into contiguous ranges, one analyzer per worker
+    static void analyzeChunks(const float* samples, int chunkSize, float sampleRate,
+                              std::vector<AudioFrame>& frames, unsigned threads) {
+        constexpr size_t kMinChunksPerWorker = 64;  // ~2 s of audio
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        size_t workers = std::min<size_t>(threads, std::max<size_t>(1, frames.size() / kMinChunksPerWorker));
+        
+        auto analyzeRange = [&](size_t begin, size_t end) {
+            AudioAnalyzer analyzer;
+            for (size_t i = begin; i < end; i++) {
+                float time = static_cast<float>(i * chunkSize) / sampleRate;
+                frames[i] = analyzer.analyze(samples + i * chunkSize, chunkSize, sampleRate, time);
+            }
+        };
+        
+        if (workers <= 1) {
+            analyzeRange(0, frames.size());
+            return;
+        }
+        std::vector<std::thread> pool;
+        size_t perWorker = (frames.size() + workers - 1) / workers;
+        for (size_t w = 0; w < workers; w++) {
+            size_t begin = w * perWorker;
+            size_t end = std::min(frames.size(), begin + perWorker);
+            if (begin < end) pool.emplace_back(analyzeRange, begin, end);
+        }
+        for (auto& thread : pool) thread.join();
+    }
+    
     Viseme phonemeToViseme(const std::string& phoneme) {
         // ARPABET phoneme to viseme mapping
         static std::unordered_map<std::string, Viseme> mapping = {
@@ -78,6 +78,9 @@ public:
     // Compute final skinning matrices (bone matrix * inverse bind matrix)
     void computeSkinningMatrices(Mat4* outMatrices) const;
     
+    // Model-space matrix of a single bone (identity if out of range)
+    Mat4 getGlobalMatrix(int boneIndex) const;
+    
     // Reset to bind pose
     void resetToBindPose();
     
@@ -159,6 +162,12 @@ inline void Skeleton::computeSkinningMatrices(Mat4* outMatrices) const {
     }
 }
 
+inline Mat4 Skeleton::getGlobalMatrix(int boneIndex) const {
+    if (boneIndex < 0 || boneIndex >= (int)bones_.size()) return Mat4::identity();
+    computeModelSpaceMatrices();
+    return modelSpaceMatrices_[boneIndex];
+}
+
 inline void Skeleton::resetToBindPose() {
     // Reset all bones to identity local transform
     // (actual bind pose is encoded in inverseBindMatrix)
@@ -1,5 +1,9 @@
 // Animation State Machine
 // Finite State Machine for animation control
+//   - AnimationStateMachine: editable, name-keyed definition and runtime
+//   - CompiledStateMachine: read-only copy with dense parameter/state
+//     indices and a flat predicate table; many StateMachineInstances
+//     (one per character) are updated against one compiled definition
 #pragma once
 
 #include "animation_clip.h"
@@ -10,6 +14,7 @@
 #include <unordered_map>
 #include <functional>
 #include <variant>
+#include <algorithm>
 
 namespace luma {
 
@@ -215,6 +220,31 @@ public:
     }
 };
 
+// Pose buffers for blending two states; they only grow
+struct StateMachineSampleScratch {
+    std::vector<Vec3> fromPos, toPos;
+    std::vector<Quat> fromRot, toRot;
+    std::vector<Vec3> fromScl, toScl;
+    
+    // Default pose in the first boneCount entries (bones without channels keep it)
+    void prepare(int boneCount) {
+        if ((int)fromPos.size() < boneCount) {
+            fromPos.resize(boneCount);
+            toPos.resize(boneCount);
+            fromRot.resize(boneCount);
+            toRot.resize(boneCount);
+            fromScl.resize(boneCount);
+            toScl.resize(boneCount);
+        }
+        std::fill_n(fromPos.begin(), boneCount, Vec3());
+        std::fill_n(toPos.begin(), boneCount, Vec3());
+        std::fill_n(fromRot.begin(), boneCount, Quat());
+        std::fill_n(toRot.begin(), boneCount, Quat());
+        std::fill_n(fromScl.begin(), boneCount, Vec3());
+        std::fill_n(toScl.begin(), boneCount, Vec3());
+    }
+};
+
 // ===== Animation State Machine =====
 class AnimationStateMachine {
 public:
@@ -375,7 +405,8 @@ public:
         }
         
         // Check state transitions (sorted by priority)
-        std::vector<const StateTransition*> sortedTransitions;
+        std::vector<const StateTransition*>& sortedTransitions = sortedScratch_;
+        sortedTransitions.clear();
         for (const auto& t : current->transitions) {
             sortedTransitions.push_back(&t);
         }
@@ -395,12 +426,23 @@ public:
     
     // === Output ===
     
+    // Safe to call from several threads at once: blend buffers are
+    // per thread, or the caller's own scratch in the second overload
     void sample(Vec3* positions, Quat* rotations, Vec3* scales, int boneCount) const {
+        thread_local StateMachineSampleScratch scratch;
+        sample(positions, rotations, scales, boneCount, scratch);
+    }
+    void sample(Vec3* positions, Quat* rotations, Vec3* scales, int boneCount,
+                StateMachineSampleScratch& scratch) const {
         if (isTransitioning_) {
             // Blend between states
-            std::vector<Vec3> fromPos(boneCount), toPos(boneCount);
-            std::vector<Quat> fromRot(boneCount), toRot(boneCount);
-            std::vector<Vec3> fromScl(boneCount), toScl(boneCount);
+            std::vector<Vec3>& fromPos = scratch.fromPos;
+            std::vector<Vec3>& toPos = scratch.toPos;
+            std::vector<Quat>& fromRot = scratch.fromRot;
+            std::vector<Quat>& toRot = scratch.toRot;
+            std::vector<Vec3>& fromScl = scratch.fromScl;
+            std::vector<Vec3>& toScl = scratch.toScl;
+            scratch.prepare(boneCount);
             
             if (auto* from = getStateConst(previousState_)) {
                 from->sample(fromPos.data(), fromRot.data(), fromScl.data(), boneCount);
@@ -481,10 +523,15 @@ private:
         }
     }
     
+    friend class CompiledStateMachine;
+    
     std::unordered_map<std::string, std::unique_ptr<StateMachineState>> states_;
     std::unordered_map<std::string, AnimationParameter> parameters_;
     std::vector<StateTransition> anyStateTransitions_;
     
+    // Reused by update() so it doesn't allocate every frame
+    std::vector<const StateTransition*> sortedScratch_;
+    
     std::string defaultState_;
     std::string currentState_;
     std::string previousState_;
@@ -495,6 +542,341 @@ private:
     float transitionProgress_ = 0.0f;
 };
 
+// ===== State Machine Instance =====
+// Runtime state of one character driven by a CompiledStateMachine.
+// Parameters are indexed by CompiledStateMachine::findParameter.
+struct StateMachineInstance {
+    std::vector<float> parameters;   // ints as floats, bools and triggers as 0/1
+    int currentState = -1;
+    int previousState = -1;
+    float currentTime = 0.0f;
+    float previousTime = 0.0f;
+    float transitionDuration = 0.0f;
+    float transitionProgress = 0.0f;
+    bool transitioning = false;
+    bool started = false;
+    bool stateChanged = false;       // a transition started in the last update
+    
+    void setFloat(int index, float value) { if ((size_t)index < parameters.size()) parameters[index] = value; }
+    void setInt(int index, int value) { setFloat(index, (float)value); }
+    void setBool(int index, bool value) { setFloat(index, value ? 1.0f : 0.0f); }
+    void setTrigger(int index) { setFloat(index, 1.0f); }
+    
+    float getFloat(int index) const { return (size_t)index < parameters.size() ? parameters[index] : 0.0f; }
+    int getInt(int index) const { return (int)getFloat(index); }
+    bool getBool(int index) const { return getFloat(index) > 0.5f; }
+};
+
+// ===== Compiled State Machine =====
+// Snapshot of an AnimationStateMachine's parameters, states and
+// transitions. Updates behave like AnimationStateMachine::update, except:
+//   - state callbacks aren't called (check stateChanged instead)
+//   - state durations are taken at compile time, including blend trees'
+class CompiledStateMachine {
+public:
+    // Fails on transitions to unknown states or a missing default state
+    bool compile(const AnimationStateMachine& source);
+    
+    int findParameter(const std::string& name) const {
+        auto it = parameterLookup_.find(name);
+        return it != parameterLookup_.end() ? it->second : -1;
+    }
+    int findState(const std::string& name) const {
+        auto it = stateLookup_.find(name);
+        return it != stateLookup_.end() ? it->second : -1;
+    }
+    size_t getParameterCount() const { return parameterDefaults_.size(); }
+    size_t getStateCount() const { return states_.size(); }
+    const std::string& getStateName(int state) const { return stateNames_[state]; }
+    
+    // Sizes the parameter array; the instance starts on the next update
+    void initInstance(StateMachineInstance& instance) const {
+        instance = StateMachineInstance();
+        instance.parameters = parameterDefaults_;
+    }
+    
+    void update(StateMachineInstance& instance, float deltaTime) const;
+    void updateBatch(StateMachineInstance* instances, size_t count, float deltaTime) const {
+        for (size_t i = 0; i < count; i++) update(instances[i], deltaTime);
+    }
+    
+    float getNormalizedTime(int state, float time) const;
+    
+    void sample(const StateMachineInstance& instance, Vec3* positions, Quat* rotations, Vec3* scales,
+                int boneCount, StateMachineSampleScratch& scratch) const;
+    
+    const std::string& getLastError() const { return lastError_; }
+    
+private:
+    // Condition modes resolved against the parameter type
+    enum class PredicateOp : uint8_t {
+        Equal, NotEqual, Greater, Less, GreaterEqual, LessEqual,
+        BoolEqual, BoolNotEqual,
+        Trigger,
+        Never   // unknown parameter or mode the type doesn't support
+    };
+    
+    struct Predicate {
+        uint32_t parameter;
+        PredicateOp op;
+        float threshold;
+    };
+    
+    struct Transition {
+        int target;
+        uint32_t firstPredicate;
+        uint32_t predicateCount;
+        float duration;
+        float exitTime;     // normalized; 0 without exit time
+    };
+    
+    struct State {
+        const AnimationClip* clip;
+        float speed;
+        float duration;
+        bool loop;
+        uint32_t firstTransition;
+        uint32_t transitionCount;
+    };
+    
+    bool compileTransition(const StateTransition& transition, const AnimationStateMachine& source);
+    bool passes(const Transition& transition, const float* parameters, float normalizedTime) const;
+    void startTransition(StateMachineInstance& instance, const Transition& transition) const;
+    
+    std::vector<State> states_;
+    std::vector<Transition> transitions_;   // per state by priority, then any-state ones
+    std::vector<Predicate> predicates_;
+    uint32_t firstAnyTransition_ = 0;
+    int defaultState_ = -1;
+    
+    std::vector<float> parameterDefaults_;
+    std::vector<std::string> stateNames_;
+    std::unordered_map<std::string, int> parameterLookup_;
+    std::unordered_map<std::string, int> stateLookup_;
+    std::string lastError_;
+};
+
+inline bool CompiledStateMachine::compile(const AnimationStateMachine& source) {
+    *this = CompiledStateMachine();
+    
+    // Sorted names keep indices independent of hash order
+    std::vector<std::string> parameterNames;
+    for (const auto& [name, param] : source.parameters_) parameterNames.push_back(name);
+    std::sort(parameterNames.begin(), parameterNames.end());
+    for (const auto& name : parameterNames) {
+        const AnimationParameter& param = source.parameters_.at(name);
+        parameterLookup_[name] = (int)parameterDefaults_.size();
+        switch (param.type) {
+            case ParameterType::Float: parameterDefaults_.push_back(param.floatValue); break;
+            case ParameterType::Int: parameterDefaults_.push_back((float)param.intValue); break;
+            case ParameterType::Bool: parameterDefaults_.push_back(param.boolValue ? 1.0f : 0.0f); break;
+            case ParameterType::Trigger: parameterDefaults_.push_back(param.triggerValue ? 1.0f : 0.0f); break;
+        }
+    }
+    
+    for (const auto& [name, state] : source.states_) stateNames_.push_back(name);
+    std::sort(stateNames_.begin(), stateNames_.end());
+    for (size_t i = 0; i < stateNames_.size(); i++) stateLookup_[stateNames_[i]] = (int)i;
+    
+    auto failWith = [this](const std::string& message) {
+        std::string error = message;
+        *this = CompiledStateMachine();
+        lastError_ = error;
+        return false;
+    };
+    
+    defaultState_ = findState(source.defaultState_);
+    if (defaultState_ < 0) return failWith("unknown default state '" + source.defaultState_ + "'");
+    
+    std::vector<const StateTransition*> sorted;
+    for (const auto& name : stateNames_) {
+        const StateMachineState& state = *source.states_.at(name);
+        State flat;
+        flat.clip = state.clip;
+        flat.speed = state.speed;
+        flat.duration = state.getDuration();
+        flat.loop = state.loop;
+        flat.firstTransition = (uint32_t)transitions_.size();
+        
+        // Same order as AnimationStateMachine::update
+        sorted.clear();
+        for (const auto& t : state.transitions) sorted.push_back(&t);
+        std::sort(sorted.begin(), sorted.end(), [](const StateTransition* a, const StateTransition* b) {
+            return a->priority > b->priority;
+        });
+        for (const StateTransition* transition : sorted) {
+            if (!compileTransition(*transition, source)) {
+                return failWith("transition from '" + name + "' to unknown state '" + transition->targetState + "'");
+            }
+        }
+        flat.transitionCount = (uint32_t)transitions_.size() - flat.firstTransition;
+        states_.push_back(flat);
+    }
+    
+    firstAnyTransition_ = (uint32_t)transitions_.size();
+    for (const auto& transition : source.anyStateTransitions_) {
+        if (!compileTransition(transition, source)) {
+            return failWith("any-state transition to unknown state '" + transition.targetState + "'");
+        }
+    }
+    return true;
+}
+
+inline bool CompiledStateMachine::compileTransition(const StateTransition& transition,
+                                                    const AnimationStateMachine& source) {
+    Transition flat;
+    flat.target = findState(transition.targetState);
+    if (flat.target < 0) return false;
+    flat.duration = transition.duration;
+    flat.exitTime = transition.hasExitTime ? transition.exitTime : 0.0f;
+    flat.firstPredicate = (uint32_t)predicates_.size();
+    
+    for (const auto& condition : transition.conditions) {
+        Predicate predicate = {0, PredicateOp::Never, condition.threshold};
+        auto param = source.parameters_.find(condition.parameterName);
+        if (param != source.parameters_.end()) {
+            predicate.parameter = (uint32_t)findParameter(condition.parameterName);
+            switch (param->second.type) {
+                case ParameterType::Float:
+                case ParameterType::Int:
+                    static_assert((int)PredicateOp::LessEqual == (int)ConditionMode::LessEqual,
+                                  "PredicateOp starts with the ConditionMode comparisons");
+                    predicate.op = (PredicateOp)condition.mode;
+                    break;
+                case ParameterType::Bool:
+                    predicate.threshold = condition.threshold > 0.5f ? 1.0f : 0.0f;
+                    if (condition.mode == ConditionMode::If) predicate.op = PredicateOp::BoolEqual;
+                    else if (condition.mode == ConditionMode::IfNot) predicate.op = PredicateOp::BoolNotEqual;
+                    break;
+                case ParameterType::Trigger:
+                    predicate.op = PredicateOp::Trigger;
+                    break;
+            }
+        }
+        predicates_.push_back(predicate);
+    }
+    flat.predicateCount = (uint32_t)predicates_.size() - flat.firstPredicate;
+    transitions_.push_back(flat);
+    return true;
+}
+
+inline float CompiledStateMachine::getNormalizedTime(int state, float time) const {
+    float duration = states_[state].duration;
+    if (duration <= 0.0f) return 0.0f;
+    return states_[state].loop ? std::fmod(time, duration) / duration : std::min(time / duration, 1.0f);
+}
+
+inline bool CompiledStateMachine::passes(const Transition& transition, const float* parameters,
+                                         float normalizedTime) const {
+    if (normalizedTime < transition.exitTime) return false;
+    const Predicate* predicate = predicates_.data() + transition.firstPredicate;
+    for (uint32_t i = 0; i < transition.predicateCount; i++, predicate++) {
+        float value = parameters[predicate->parameter];
+        bool pass = false;
+        switch (predicate->op) {
+            case PredicateOp::Equal: pass = std::abs(value - predicate->threshold) < 0.0001f; break;
+            case PredicateOp::NotEqual: pass = std::abs(value - predicate->threshold) >= 0.0001f; break;
+            case PredicateOp::Greater: pass = value > predicate->threshold; break;
+            case PredicateOp::Less: pass = value < predicate->threshold; break;
+            case PredicateOp::GreaterEqual: pass = value >= predicate->threshold; break;
+            case PredicateOp::LessEqual: pass = value <= predicate->threshold; break;
+            case PredicateOp::BoolEqual: pass = (value > 0.5f) == (predicate->threshold > 0.5f); break;
+            case PredicateOp::BoolNotEqual: pass = (value > 0.5f) != (predicate->threshold > 0.5f); break;
+            case PredicateOp::Trigger: pass = value > 0.5f; break;
+            case PredicateOp::Never: break;
+        }
+        if (!pass) return false;
+    }
+    return true;
+}
+
+inline void CompiledStateMachine::startTransition(StateMachineInstance& instance, const Transition& transition) const {
+    instance.previousState = instance.currentState;
+    instance.previousTime = instance.currentTime;
+    instance.currentState = transition.target;
+    instance.currentTime = 0.0f;
+    instance.transitionDuration = transition.duration;
+    instance.transitionProgress = 0.0f;
+    instance.transitioning = true;
+    instance.stateChanged = true;
+    
+    // Consume triggers
+    const Predicate* predicate = predicates_.data() + transition.firstPredicate;
+    for (uint32_t i = 0; i < transition.predicateCount; i++, predicate++) {
+        if (predicate->op == PredicateOp::Trigger) instance.parameters[predicate->parameter] = 0.0f;
+    }
+}
+
+inline void CompiledStateMachine::update(StateMachineInstance& instance, float deltaTime) const {
+    instance.stateChanged = false;
+    if (!instance.started) {
+        if (states_.empty() || instance.parameters.size() != parameterDefaults_.size()) return;
+        instance.started = true;
+        instance.currentState = defaultState_;
+        instance.currentTime = 0.0f;
+    }
+    
+    if (instance.transitioning) {
+        instance.transitionProgress = instance.transitionDuration > 0.0f
+            ? instance.transitionProgress + deltaTime / instance.transitionDuration
+            : 1.0f;
+        instance.previousTime += deltaTime * states_[instance.previousState].speed;
+        instance.currentTime += deltaTime * states_[instance.currentState].speed;
+        if (instance.transitionProgress >= 1.0f) {
+            instance.transitionProgress = 1.0f;
+            instance.transitioning = false;
+        }
+        return;
+    }
+    
+    const State& current = states_[instance.currentState];
+    instance.currentTime += deltaTime * current.speed;
+    float normalizedTime = getNormalizedTime(instance.currentState, instance.currentTime);
+    const float* parameters = instance.parameters.data();
+    
+    for (uint32_t t = firstAnyTransition_; t < transitions_.size(); t++) {
+        const Transition& transition = transitions_[t];
+        if (transition.target != instance.currentState && passes(transition, parameters, normalizedTime)) {
+            startTransition(instance, transition);
+            return;
+        }
+    }
+    for (uint32_t t = current.firstTransition; t < current.firstTransition + current.transitionCount; t++) {
+        if (passes(transitions_[t], parameters, normalizedTime)) {
+            startTransition(instance, transitions_[t]);
+            return;
+        }
+    }
+}
+
+inline void CompiledStateMachine::sample(const StateMachineInstance& instance, Vec3* positions, Quat* rotations,
+                                         Vec3* scales, int boneCount, StateMachineSampleScratch& scratch) const {
+    if (instance.currentState < 0) return;
+    auto sampleState = [this](int state, float time, Vec3* pos, Quat* rot, Vec3* scl, int count) {
+        const State& s = states_[state];
+        if (!s.clip) return;
+        float sampleTime = s.loop && s.duration > 0.0f ? std::fmod(time, s.duration) : time;
+        s.clip->sample(sampleTime, pos, rot, scl, count);
+    };
+    
+    if (!instance.transitioning) {
+        sampleState(instance.currentState, instance.currentTime, positions, rotations, scales, boneCount);
+        return;
+    }
+    
+    scratch.prepare(boneCount);
+    sampleState(instance.previousState, instance.previousTime,
+                scratch.fromPos.data(), scratch.fromRot.data(), scratch.fromScl.data(), boneCount);
+    sampleState(instance.currentState, instance.currentTime,
+                scratch.toPos.data(), scratch.toRot.data(), scratch.toScl.data(), boneCount);
+    float t = instance.transitionProgress;
+    for (int i = 0; i < boneCount; i++) {
+        positions[i] = anim::lerp(scratch.fromPos[i], scratch.toPos[i], t);
+        rotations[i] = anim::slerp(scratch.fromRot[i], scratch.toRot[i], t);
+        scales[i] = anim::lerp(scratch.fromScl[i], scratch.toScl[i], t);
+    }
+}
+
 // ===== State Machine Presets =====
 namespace StateMachinePresets {
 
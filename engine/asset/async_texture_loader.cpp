@@ -1,5 +1,6 @@
 // Async Texture Loader Implementation
 #include "async_texture_loader.h"
+#include "engine/util/file_watcher.h"
 
 // Use stb_image functions from model_loader.cpp
 extern "C" {
@@ -12,69 +13,316 @@ extern "C" {
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <iterator>
+#include <cmath>
 
 namespace luma {
 
+// ===== Streaming Priority =====
+
+float texturePriority(TexturePriority level, float screenPixels) {
+    // Screen size only orders textures within a level
+    constexpr float kLevelSpan = 100000.0f;
+    float size = std::clamp(screenPixels, 0.0f, kLevelSpan - 1.0f);
+    return static_cast<float>(level) * kLevelSpan + size;
+}
+
+float projectedScreenSize(float distance, float radius, float fovY, float viewportHeight) {
+    if (radius <= 0.0f || viewportHeight <= 0.0f) return 0.0f;
+    float d = std::max(distance, radius);
+    return (radius / (d * std::tan(fovY * 0.5f))) * viewportHeight;
+}
+
 // ===== AsyncTextureLoader Implementation =====
 
+// Textures are never trimmed below this size
+static constexpr int kMinTrimSize = 64;
+
+float AsyncTextureLoader::PendingLoad::priority() const {
+    float best = waiters.empty() ? request.priority : waiters.front().second;
+    for (const auto& waiter : waiters) best = std::max(best, waiter.second);
+    return best;
+}
+
+size_t AsyncTextureLoader::ResidentTexture::bytes() const {
+    size_t total = 0;
+    for (size_t i = static_cast<size_t>(firstMip); i < levelBytes.size(); ++i) total += levelBytes[i];
+    return total;
+}
+
+static double elapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+static std::string roleKey(const std::string& prefix, const std::string& id, TextureRole role) {
+    return prefix + id + "|" + textureRoleName(role);
+}
+
 AsyncTextureLoader::AsyncTextureLoader(size_t numThreads) {
     // Start worker threads
-    for (size_t i = 0; i < numThreads; ++i) {
-        workers_.emplace_back(&AsyncTextureLoader::workerThread, this);
-    }
+    setWorkerCount(numThreads);
     std::cout << "[async_loader] Started with " << numThreads << " worker threads" << std::endl;
 }
 
 AsyncTextureLoader::~AsyncTextureLoader() {
+    setFileWatcher(nullptr);
     shutdown();
 }
 
 void AsyncTextureLoader::shutdown() {
     if (!running_) return;
     
-    running_ = false;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        running_ = false;
+    }
     workAvailable_.notify_all();
     
-    for (auto& worker : workers_) {
-        if (worker.joinable()) {
-            worker.join();
+    {
+        std::lock_guard<std::mutex> lock(workersMutex_);
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
         }
+        workers_.clear();
+        targetWorkers_ = 0;
+    }
+    
+    // Queued loads are dropped; wake anyone waiting on them
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        loads_.clear();
+        requestToLoad_.clear();
+        coalesceIndex_.clear();
+        queue_ = {};
+        pendingCount_ = 0;
     }
-    workers_.clear();
+    allDone_.notify_all();
     std::cout << "[async_loader] Shutdown complete" << std::endl;
 }
 
-uint32_t AsyncTextureLoader::loadTexture(const std::string& path) {
+void AsyncTextureLoader::setWorkerCount(size_t count) {
+    std::lock_guard<std::mutex> lock(workersMutex_);
+    if (!running_) return;
+    
+    if (count < workers_.size()) {
+        {
+            std::lock_guard<std::mutex> pendingLock(pendingMutex_);
+            targetWorkers_ = count;
+        }
+        workAvailable_.notify_all();
+        for (size_t i = count; i < workers_.size(); ++i) {
+            workers_[i].join();
+        }
+        workers_.resize(count);
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> pendingLock(pendingMutex_);
+        targetWorkers_ = count;
+    }
+    for (size_t i = workers_.size(); i < count; ++i) {
+        workers_.emplace_back(&AsyncTextureLoader::workerThread, this, i);
+    }
+}
+
+size_t AsyncTextureLoader::getWorkerCount() const {
+    return targetWorkers_.load();
+}
+
+uint32_t AsyncTextureLoader::loadTexture(const std::string& path, TextureRole role, float priority) {
     TextureLoadRequest request;
     request.id = nextId_++;
     request.path = path;
     request.isEmbedded = false;
+    request.role = role;
+    request.priority = priority;
     
-    {
-        std::lock_guard<std::mutex> lock(pendingMutex_);
-        pendingQueue_.push(std::move(request));
-        pendingCount_++;
+    // Already resident: complete immediately without touching the workers
+    if (TextureHandle cached = getTextureCache().findFile(path, cookVariant(role, getCookSettings()))) {
+        TextureLoadResult result;
+        result.id = request.id;
+        result.texture = std::move(cached);
+        result.success = true;
+        result.fromCache = true;
+        
+        ResidentTexture restore;
+        restore.path = path;
+        restore.isFile = true;
+        restore.role = role;
+        restore.priority = priority;
+        {
+            std::lock_guard<std::mutex> lock(pendingMutex_);
+            counters_.submitted++;
+            counters_.completed++;
+        }
+        pushCompleted(std::move(result), &restore);
+        return request.id;
     }
-    workAvailable_.notify_one();
     
-    return request.id;
+    std::string key = roleKey("file:", TextureCache::normalizePath(path), role);
+    return submit(std::move(request), key);
 }
 
-uint32_t AsyncTextureLoader::loadTextureFromMemory(const std::vector<uint8_t>& data, const std::string& name) {
+uint32_t AsyncTextureLoader::loadTextureFromMemory(const std::vector<uint8_t>& data, const std::string& name,
+                                                   TextureRole role, float priority) {
     TextureLoadRequest request;
     request.id = nextId_++;
     request.path = name;
     request.embeddedData = data;
     request.isEmbedded = true;
+    request.role = role;
+    request.priority = priority;
     
+    std::string key = roleKey("mem:", std::to_string(TextureCache::hashBytes(data.data(), data.size())), role);
+    return submit(std::move(request), key);
+}
+
+uint32_t AsyncTextureLoader::cookTexture(const TextureHandle& source, TextureRole role, float priority) {
+    TextureLoadRequest request;
+    request.id = nextId_++;
+    request.path = source ? source->path : std::string();
+    request.source = source;
+    request.role = role;
+    request.priority = priority;
+    
+    // The same decoded image (shared through the TextureCache) is cooked once
+    std::string key = source ? roleKey("src:", std::to_string(reinterpret_cast<uintptr_t>(source.get())), role)
+                             : std::string();
+    return submit(std::move(request), key);
+}
+
+uint32_t AsyncTextureLoader::submit(TextureLoadRequest&& request, const std::string& coalesceKey) {
+    uint32_t id = request.id;
+    request.submitTime = std::chrono::steady_clock::now();
     {
         std::lock_guard<std::mutex> lock(pendingMutex_);
-        pendingQueue_.push(std::move(request));
+        counters_.submitted++;
+        
+        // Join an identical load that has not finished yet
+        if (!coalesceKey.empty()) {
+            auto it = coalesceIndex_.find(coalesceKey);
+            if (it != coalesceIndex_.end()) {
+                PendingLoad& load = loads_.at(it->second);
+                float before = load.priority();
+                load.waiters.emplace_back(id, request.priority);
+                requestToLoad_[id] = it->second;
+                counters_.coalesced++;
+                if (!load.inFlight && load.priority() > before) {
+                    enqueueLocked(load);
+                }
+                return id;
+            }
+        }
+        
+        PendingLoad& load = loads_[id];
+        load.request = std::move(request);
+        load.waiters.emplace_back(id, load.request.priority);
+        load.coalesceKey = coalesceKey;
+        load.sequence = queueSequence_++;
+        if (!coalesceKey.empty()) coalesceIndex_[coalesceKey] = id;
+        requestToLoad_[id] = id;
         pendingCount_++;
+        enqueueLocked(load);
     }
     workAvailable_.notify_one();
     
-    return request.id;
+    return id;
+}
+
+void AsyncTextureLoader::enqueueLocked(PendingLoad& load) {
+    load.generation++;
+    queue_.push({load.priority(), load.sequence, load.request.id, load.generation});
+    
+    // Frequent re-prioritization leaves stale entries behind; rebuild the
+    // heap from the live loads once they dominate
+    if (queue_.size() > 2 * loads_.size() + 64) {
+        std::priority_queue<QueueEntry> rebuilt;
+        for (const auto& [loadId, pending] : loads_) {
+            if (!pending.inFlight) {
+                rebuilt.push({pending.priority(), pending.sequence, loadId, pending.generation});
+            }
+        }
+        queue_ = std::move(rebuilt);
+    }
+}
+
+void AsyncTextureLoader::updatePriority(uint32_t id, float priority) {
+    {
+        // Resident textures keep it for eviction order and restores
+        std::lock_guard<std::mutex> lock(residentMutex_);
+        auto it = resident_.find(id);
+        if (it != resident_.end()) it->second.priority = priority;
+    }
+    
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    auto it = requestToLoad_.find(id);
+    if (it == requestToLoad_.end()) return;
+    
+    PendingLoad& load = loads_.at(it->second);
+    if (load.inFlight) return;
+    
+    float before = load.priority();
+    for (auto& waiter : load.waiters) {
+        if (waiter.first == id) waiter.second = priority;
+    }
+    if (load.priority() != before) {
+        enqueueLocked(load);
+    }
+}
+
+bool AsyncTextureLoader::cancel(uint32_t id) {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    auto it = requestToLoad_.find(id);
+    if (it == requestToLoad_.end()) return false;
+    
+    uint32_t loadId = it->second;
+    requestToLoad_.erase(it);
+    counters_.cancelled++;
+    
+    PendingLoad& load = loads_.at(loadId);
+    load.waiters.erase(std::remove_if(load.waiters.begin(), load.waiters.end(),
+                                      [id](const auto& waiter) { return waiter.first == id; }),
+                       load.waiters.end());
+    if (!load.waiters.empty()) {
+        if (!load.inFlight) enqueueLocked(load);
+        return true;
+    }
+    
+    // Nobody is waiting any more. A load already on a worker finishes and
+    // its result is discarded; new requests start a fresh load.
+    auto keyIt = coalesceIndex_.find(load.coalesceKey);
+    if (keyIt != coalesceIndex_.end() && keyIt->second == loadId) {
+        coalesceIndex_.erase(keyIt);
+    }
+    if (!load.inFlight) {
+        loads_.erase(loadId);
+        pendingCount_--;
+        allDone_.notify_all();
+    }
+    return true;
+}
+
+void AsyncTextureLoader::setCookSettings(const TextureCookSettings& settings) {
+    std::lock_guard<std::mutex> lock(settingsMutex_);
+    cookSettings_ = settings;
+}
+
+TextureCookSettings AsyncTextureLoader::getCookSettings() const {
+    std::lock_guard<std::mutex> lock(settingsMutex_);
+    return cookSettings_;
+}
+
+std::string AsyncTextureLoader::cookVariant(TextureRole role, const TextureCookSettings& settings) const {
+    if (!settings.enabled()) return "";
+    std::string variant = "cooked/";
+    variant += textureRoleName(role);
+    variant += settings.quality == TextureQuality::High ? "/high" : "/fast";
+    variant += settings.generateMips ? "/mips" : "";
+    variant += settings.compress ? "/bc" : "";
+    return variant;
 }
 
 bool AsyncTextureLoader::hasCompletedTextures() const {
@@ -83,10 +331,293 @@ bool AsyncTextureLoader::hasCompletedTextures() const {
 }
 
 std::vector<TextureLoadResult> AsyncTextureLoader::getCompletedTextures() {
-    std::lock_guard<std::mutex> lock(completedMutex_);
-    std::vector<TextureLoadResult> results = std::move(completedResults_);
-    completedResults_.clear();
-    return results;
+    std::vector<TextureLoadResult> results;
+    std::unordered_map<uint32_t, ResidentTexture> restoreInfo;
+    {
+        std::lock_guard<std::mutex> lock(completedMutex_);
+        results = std::move(completedResults_);
+        completedResults_.clear();
+        restoreInfo.swap(restoreInfo_);
+    }
+    
+    // Everything handed out from here on counts against the budget
+    std::lock_guard<std::mutex> lock(residentMutex_);
+    std::vector<TextureLoadResult> delivered;
+    delivered.reserve(results.size());
+    for (auto& result : results) {
+        auto it = resident_.find(result.id);
+        if (it == resident_.end()) {
+            if (result.success && result.texture) {
+                auto info = restoreInfo.find(result.id);
+                ResidentTexture resident = info != restoreInfo.end() ? std::move(info->second) : ResidentTexture{};
+                const TextureData& tex = *result.texture;
+                resident.width = tex.width;
+                resident.levelBytes.clear();
+                if (tex.isCooked()) {
+                    for (const auto& mip : tex.mips) resident.levelBytes.push_back(mip.data.size());
+                } else {
+                    resident.levelBytes.push_back(tex.pixels.size());
+                }
+                resident.lastUsedFrame = frame_;
+                residentBytes_ += resident.bytes();
+                if (resident.isFile) watchSourceLocked(resident);
+                resident_[result.id] = std::move(resident);
+            }
+            delivered.push_back(std::move(result));
+            continue;
+        }
+        
+        ResidentTexture& resident = it->second;
+        if (result.success && !result.texture) {
+            // Trim issued by update()
+            delivered.push_back(std::move(result));
+            continue;
+        }
+        
+        if (resident.reloadQueued) {
+            // The source changed while this load was running; its result may be stale
+            resident.reloadQueued = false;
+            submitReloadLocked(result.id, resident);
+            continue;
+        }
+        resident.restorePending = false;
+        
+        if (resident.reloadPending) {
+            // Hot reload: the new file may differ in size and format. A broken
+            // file (e.g. half written) keeps the current upload.
+            resident.reloadPending = false;
+            if (!result.success) continue;
+            const TextureData& tex = *result.texture;
+            residentBytes_ -= resident.bytes();
+            resident.width = tex.width;
+            resident.levelBytes.clear();
+            if (tex.isCooked()) {
+                for (const auto& mip : tex.mips) resident.levelBytes.push_back(mip.data.size());
+            } else {
+                resident.levelBytes.push_back(tex.pixels.size());
+            }
+            resident.firstMip = 0;
+            resident.isFile = true;
+            residentBytes_ += resident.bytes();
+            delivered.push_back(std::move(result));
+            continue;
+        }
+        
+        // Restore of a trimmed texture
+        if (!result.success || !result.texture->isCooked() ||
+            result.texture->mips.size() != resident.levelBytes.size()) {
+            // Source changed or is gone; keep the trimmed copy for good
+            resident.isFile = false;
+            resident.embeddedData.reset();
+            resident.source.reset();
+            resident.cookedKey = 0;
+            continue;
+        }
+        residentBytes_ -= resident.bytes();
+        resident.firstMip = 0;
+        residentBytes_ += resident.bytes();
+        restores_++;
+        delivered.push_back(std::move(result));
+    }
+    return delivered;
+}
+
+// ===== Residency =====
+
+void AsyncTextureLoader::touchTexture(uint32_t id) {
+    std::lock_guard<std::mutex> lock(residentMutex_);
+    auto it = resident_.find(id);
+    if (it != resident_.end()) {
+        it->second.lastUsedFrame = frame_;
+    }
+}
+
+void AsyncTextureLoader::releaseTexture(uint32_t id) {
+    bool restorePending = false;
+    {
+        std::lock_guard<std::mutex> lock(residentMutex_);
+        auto it = resident_.find(id);
+        if (it == resident_.end()) return;
+        restorePending = it->second.restorePending;
+        residentBytes_ -= it->second.bytes();
+        unwatchSourceLocked(it->second);
+        resident_.erase(it);
+    }
+    if (restorePending) cancel(id);
+}
+
+// ===== Hot Reload =====
+
+size_t AsyncTextureLoader::reloadFile(const std::string& path) {
+    std::string key = TextureCache::normalizePath(path);
+    getTextureCache().invalidateFile(path);
+    
+    std::lock_guard<std::mutex> lock(residentMutex_);
+    size_t reloaded = 0;
+    for (auto& [id, resident] : resident_) {
+        if (resident.watchKey != key) continue;
+        if (resident.restorePending) {
+            // One load per ID at a time; go again once the current one is back
+            resident.reloadQueued = true;
+        } else {
+            submitReloadLocked(id, resident);
+        }
+        reloaded++;
+    }
+    return reloaded;
+}
+
+void AsyncTextureLoader::submitReloadLocked(uint32_t id, ResidentTexture& resident) {
+    // Same ID, so the reloaded result replaces the current upload
+    TextureLoadRequest request;
+    request.id = id;
+    request.path = resident.path;
+    request.role = resident.role;
+    request.priority = resident.priority;
+    resident.restorePending = true;
+    resident.reloadPending = true;
+    submit(std::move(request), "");
+}
+
+void AsyncTextureLoader::setFileWatcher(FileWatcher* watcher) {
+    std::lock_guard<std::mutex> lock(residentMutex_);
+    if (watcher == fileWatcher_) return;
+    for (const auto& [key, source] : watchedSources_) {
+        if (fileWatcher_) fileWatcher_->unwatchFile(source.first);
+        if (watcher) watcher->watchFile(source.first, [this](const std::string& path) { reloadFile(path); });
+    }
+    fileWatcher_ = watcher;
+}
+
+void AsyncTextureLoader::watchSourceLocked(ResidentTexture& resident) {
+    resident.watchKey = TextureCache::normalizePath(resident.path);
+    auto& source = watchedSources_[resident.watchKey];
+    if (source.second++ > 0) return;
+    source.first = resident.path;
+    if (fileWatcher_) {
+        fileWatcher_->watchFile(resident.path, [this](const std::string& path) { reloadFile(path); });
+    }
+}
+
+void AsyncTextureLoader::unwatchSourceLocked(const ResidentTexture& resident) {
+    auto it = watchedSources_.find(resident.watchKey);
+    if (it == watchedSources_.end() || --it->second.second > 0) return;
+    if (fileWatcher_) fileWatcher_->unwatchFile(it->second.first);
+    watchedSources_.erase(it);
+}
+
+void AsyncTextureLoader::setMemoryBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(residentMutex_);
+    budgetBytes_ = bytes;
+}
+
+size_t AsyncTextureLoader::getMemoryBudget() const {
+    std::lock_guard<std::mutex> lock(residentMutex_);
+    return budgetBytes_;
+}
+
+bool AsyncTextureLoader::canRestore(const ResidentTexture& texture) const {
+    return texture.isFile || texture.embeddedData || !texture.source.expired() ||
+           (texture.cookedKey != 0 && cookedCache_.isEnabled());
+}
+
+void AsyncTextureLoader::update() {
+    std::vector<TextureLoadResult> updates;
+    {
+        std::lock_guard<std::mutex> lock(residentMutex_);
+        if (residentBytes_ > budgetBytes_) {
+            trimToBudgetLocked(updates);
+        } else {
+            scheduleRestoresLocked();
+        }
+        frame_++;
+    }
+    for (auto& result : updates) {
+        pushCompleted(std::move(result));
+    }
+}
+
+void AsyncTextureLoader::trimToBudgetLocked(std::vector<TextureLoadResult>& updates) {
+    // Least recently used first, lower priority first among equals
+    std::vector<std::pair<uint32_t, ResidentTexture*>> candidates;
+    for (auto& [id, resident] : resident_) {
+        if (resident.restorePending || resident.levelBytes.size() < 2 || !canRestore(resident)) continue;
+        candidates.emplace_back(id, &resident);
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        if (a.second->lastUsedFrame != b.second->lastUsedFrame) {
+            return a.second->lastUsedFrame < b.second->lastUsedFrame;
+        }
+        return a.second->priority < b.second->priority;
+    });
+    
+    // Textures used this frame are only trimmed if the others are not enough
+    for (int pass = 0; pass < 2 && residentBytes_ > budgetBytes_; ++pass) {
+        for (auto& [id, resident] : candidates) {
+            if (residentBytes_ <= budgetBytes_) break;
+            if (pass == 0 && resident->lastUsedFrame >= frame_) continue;
+            
+            int before = resident->firstMip;
+            int lastLevel = static_cast<int>(resident->levelBytes.size()) - 1;
+            while (residentBytes_ > budgetBytes_ && resident->firstMip < lastLevel &&
+                   (resident->width >> (resident->firstMip + 1)) >= kMinTrimSize) {
+                residentBytes_ -= resident->levelBytes[resident->firstMip];
+                resident->firstMip++;
+                mipsEvicted_++;
+            }
+            if (resident->firstMip != before) {
+                TextureLoadResult trim;
+                trim.id = id;
+                trim.success = true;
+                trim.firstMip = resident->firstMip;
+                updates.push_back(std::move(trim));
+            }
+        }
+    }
+}
+
+void AsyncTextureLoader::scheduleRestoresLocked() {
+    // Restore with some headroom so a texture is not trimmed again right away
+    size_t limit = budgetBytes_ - budgetBytes_ / 16;
+    size_t projected = residentBytes_;
+    std::vector<std::pair<uint32_t, ResidentTexture*>> candidates;
+    for (auto& [id, resident] : resident_) {
+        size_t full = 0;
+        for (size_t bytes : resident.levelBytes) full += bytes;
+        if (resident.restorePending) {
+            projected += full - resident.bytes();
+        } else if (resident.firstMip > 0 && resident.lastUsedFrame >= frame_ && canRestore(resident)) {
+            candidates.emplace_back(id, &resident);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return a.second->priority > b.second->priority;
+    });
+    
+    for (auto& [id, resident] : candidates) {
+        size_t full = 0;
+        for (size_t bytes : resident->levelBytes) full += bytes;
+        size_t growth = full - resident->bytes();
+        if (projected + growth > limit) continue;
+        
+        // Same ID, so the restored result replaces the trimmed upload
+        TextureLoadRequest request;
+        request.id = id;
+        request.path = resident->path;
+        request.role = resident->role;
+        request.priority = resident->priority;
+        if (TextureHandle source = resident->source.lock()) {
+            request.source = std::move(source);
+        } else if (resident->embeddedData) {
+            request.embeddedData = *resident->embeddedData;
+            request.isEmbedded = true;
+        } else if (!resident->isFile) {
+            request.cookedKey = resident->cookedKey;
+        }
+        resident->restorePending = true;
+        projected += growth;
+        submit(std::move(request), "");
+    }
 }
 
 size_t AsyncTextureLoader::getPendingCount() const {
@@ -94,59 +625,236 @@ size_t AsyncTextureLoader::getPendingCount() const {
 }
 
 void AsyncTextureLoader::waitForAll() {
-    while (pendingCount_ > 0) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    std::unique_lock<std::mutex> lock(pendingMutex_);
+    allDone_.wait(lock, [this] { return pendingCount_ == 0 || !running_; });
+}
+
+TextureStreamingStats AsyncTextureLoader::getStats() const {
+    TextureStreamingStats stats;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        stats = counters_;
+        stats.inFlightRequests = inFlight_;
+        stats.queuedRequests = loads_.size() - inFlight_;
+        uint64_t finished = counters_.completed + counters_.failed;
+        if (finished > 0) {
+            stats.avgQueueLatencyMs = queueLatencySumMs_ / static_cast<double>(finished);
+            stats.avgLoadTimeMs = loadTimeSumMs_ / static_cast<double>(finished);
+        }
+    }
+    stats.workerCount = targetWorkers_.load();
+    
+    std::lock_guard<std::mutex> lock(residentMutex_);
+    stats.residentTextures = resident_.size();
+    stats.residentBytes = residentBytes_;
+    stats.budgetBytes = budgetBytes_;
+    for (const auto& [id, resident] : resident_) {
+        if (resident.firstMip > 0) stats.trimmedTextures++;
+    }
+    stats.mipsEvicted = mipsEvicted_;
+    stats.restores = restores_;
+    return stats;
+}
+
+void AsyncTextureLoader::pushCompleted(TextureLoadResult&& result, const ResidentTexture* restore) {
+    std::lock_guard<std::mutex> lock(completedMutex_);
+    if (restore) {
+        restoreInfo_[result.id] = *restore;
     }
+    completedResults_.push_back(std::move(result));
 }
 
-void AsyncTextureLoader::workerThread() {
-    while (running_) {
+void AsyncTextureLoader::workerThread(size_t index) {
+    for (;;) {
+        uint32_t loadId = 0;
         TextureLoadRequest request;
         
         {
             std::unique_lock<std::mutex> lock(pendingMutex_);
-            workAvailable_.wait(lock, [this] {
-                return !pendingQueue_.empty() || !running_;
+            workAvailable_.wait(lock, [this, index] {
+                return !queue_.empty() || !running_ || index >= targetWorkers_;
             });
             
-            if (!running_ && pendingQueue_.empty()) break;
-            if (pendingQueue_.empty()) continue;
+            if (!running_ || index >= targetWorkers_) break;
             
-            request = std::move(pendingQueue_.front());
-            pendingQueue_.pop();
+            QueueEntry entry = queue_.top();
+            queue_.pop();
+            auto it = loads_.find(entry.loadId);
+            if (it == loads_.end() || it->second.inFlight || it->second.generation != entry.generation) {
+                continue;  // Cancelled or re-prioritized
+            }
+            
+            PendingLoad& load = it->second;
+            load.inFlight = true;
+            inFlight_++;
+            loadId = entry.loadId;
+            request = std::move(load.request);
+            
+            double latency = elapsedMs(request.submitTime, std::chrono::steady_clock::now());
+            queueLatencySumMs_ += latency;
+            counters_.maxQueueLatencyMs = std::max(counters_.maxQueueLatencyMs, latency);
         }
         
-        // Decode texture (this is the slow part we want off the main thread)
+        // Decode and cook (this is the slow part we want off the main thread)
+        auto start = std::chrono::steady_clock::now();
         TextureLoadResult result;
-        result.id = request.id;
-        
+        uint64_t cookedKey = 0;
         try {
-            if (request.isEmbedded) {
-                result.data = decodeTextureFromMemory(request.embeddedData);
-            } else {
-                result.data = decodeTexture(request.path);
-            }
-            
-            if (!result.data.pixels.empty()) {
-                result.success = true;
-                result.data.path = request.path;
-            } else {
-                result.success = false;
-                result.error = "Failed to decode texture: " + request.path;
-            }
+            result = processRequest(request, cookedKey);
         } catch (const std::exception& e) {
+            result.id = request.id;
             result.success = false;
             result.error = std::string("Exception: ") + e.what();
         }
         
-        // Add to completed queue
-        {
-            std::lock_guard<std::mutex> lock(completedMutex_);
-            completedResults_.push_back(std::move(result));
+        finishLoad(loadId, request, std::move(result), cookedKey,
+                   elapsedMs(start, std::chrono::steady_clock::now()));
+    }
+}
+
+void AsyncTextureLoader::finishLoad(uint32_t loadId, TextureLoadRequest& request, TextureLoadResult&& result,
+                                    uint64_t cookedKey, double loadMs) {
+    std::vector<std::pair<uint32_t, float>> waiters;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        auto it = loads_.find(loadId);
+        if (it != loads_.end()) {
+            PendingLoad& load = it->second;
+            waiters = std::move(load.waiters);
+            for (const auto& waiter : waiters) requestToLoad_.erase(waiter.first);
+            auto keyIt = coalesceIndex_.find(load.coalesceKey);
+            if (keyIt != coalesceIndex_.end() && keyIt->second == loadId) {
+                coalesceIndex_.erase(keyIt);
+            }
+            loads_.erase(it);
         }
+        inFlight_--;
+        (result.success ? counters_.completed : counters_.failed)++;
+        loadTimeSumMs_ += loadMs;
+    }
+    
+    // One result per waiting request; cancelled loads have none
+    if (!waiters.empty()) {
+        ResidentTexture restore;
+        restore.path = request.path;
+        restore.role = request.role;
+        restore.isFile = !request.isEmbedded && !request.source && request.cookedKey == 0;
+        if (request.isEmbedded) {
+            restore.embeddedData = std::make_shared<const std::vector<uint8_t>>(std::move(request.embeddedData));
+        }
+        restore.source = request.source;
+        restore.cookedKey = cookedKey;
         
+        for (const auto& [id, priority] : waiters) {
+            TextureLoadResult copy = result;
+            copy.id = id;
+            restore.priority = priority;
+            pushCompleted(std::move(copy), result.success ? &restore : nullptr);
+        }
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
         pendingCount_--;
     }
+    allDone_.notify_all();
+}
+
+TextureLoadResult AsyncTextureLoader::processRequest(TextureLoadRequest& request, uint64_t& cookedKey) {
+    TextureLoadResult result;
+    result.id = request.id;
+    
+    TextureCookSettings settings = getCookSettings();
+    std::string variant = cookVariant(request.role, settings);
+    TextureCache& cache = getTextureCache();
+    bool fromDisk = false;
+    
+    if (request.cookedKey != 0) {
+        // Streaming restore of a cooked texture whose source pixels are gone
+        TextureData cooked;
+        cooked.path = request.path;
+        if (cookedCache_.load(request.cookedKey, cooked)) {
+            result.texture = makeTexture(std::move(cooked));
+            fromDisk = true;
+        }
+        cookedKey = request.cookedKey;
+    } else if (request.source) {
+        // Already decoded: the pixel contents identify the source
+        const TextureData& src = *request.source;
+        if (!settings.enabled()) {
+            result.texture = request.source;
+        } else {
+            uint64_t sourceHash = TextureCache::hashPixels(src);
+            cookedKey = CookedTextureCache::makeKey(sourceHash, request.role, settings);
+            result.texture = cache.getOrLoadPixels(src, [&]() {
+                return cookFromSource(sourceHash, settings, request.role, request.path,
+                                      [&]() { return src; }, fromDisk);
+            }, variant);
+        }
+    } else if (request.isEmbedded) {
+        const std::vector<uint8_t>& bytes = request.embeddedData;
+        result.texture = cache.getOrLoadMemory(bytes.data(), bytes.size(), [&]() {
+            return cookFromSource(TextureCache::hashBytes(bytes.data(), bytes.size()), settings, request.role,
+                                  request.path, [&]() { return decodeTextureFromMemory(bytes); }, fromDisk);
+        }, variant);
+    } else {
+        result.texture = cache.getOrLoadFile(request.path, [&]() {
+            if (!settings.enabled()) {
+                TextureData tex = decodeTexture(request.path);
+                tex.path = request.path;
+                return tex;
+            }
+            // Read once: the bytes are both the cooked cache key and the decoder input
+            std::vector<uint8_t> bytes;
+            std::ifstream file(request.path, std::ios::binary);
+            if (file) {
+                bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            }
+            if (bytes.empty()) return TextureData{};
+            return cookFromSource(TextureCache::hashBytes(bytes.data(), bytes.size()), settings, request.role,
+                                  request.path, [&]() { return decodeTextureFromMemory(bytes); }, fromDisk);
+        }, variant);
+    }
+    
+    result.fromCookedCache = fromDisk;
+    if (hasPixels(result.texture)) {
+        result.success = true;
+    } else {
+        result.success = false;
+        result.error = "Failed to decode texture: " + request.path;
+    }
+    return result;
+}
+
+TextureData AsyncTextureLoader::cookFromSource(uint64_t sourceHash, const TextureCookSettings& settings,
+                                               TextureRole role, const std::string& name,
+                                               const std::function<TextureData()>& decode, bool& fromDisk) {
+    if (!settings.enabled()) {
+        TextureData tex = decode();
+        tex.path = name;
+        return tex;
+    }
+    
+    uint64_t key = CookedTextureCache::makeKey(sourceHash, role, settings);
+    TextureData cooked;
+    cooked.path = name;
+    if (cookedCache_.load(key, cooked)) {
+        fromDisk = true;
+        return cooked;
+    }
+    
+    TextureData decoded = decode();
+    if (decoded.pixels.empty()) return decoded;
+    decoded.path = name;
+    
+    cooked = luma::cookTexture(decoded, role, settings);
+    if (cooked.isCooked()) {
+        cookedCache_.store(key, cooked);
+        std::cout << "[async_loader] Cooked: " << name << " (" << cooked.width << "x" << cooked.height
+                  << ", " << cooked.mips.size() << " mips, " << textureFormatName(cooked.format) << ")"
+                  << std::endl;
+    }
+    return cooked;
 }
 
 TextureData AsyncTextureLoader::decodeTexture(const std::string& path) {
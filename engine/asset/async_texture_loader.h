@@ -3,86 +3,301 @@
 #pragma once
 
 #include "engine/renderer/mesh.h"
+#include "engine/asset/texture_cache.h"
+#include "engine/asset/texture_compression.h"
 #include <string>
 #include <vector>
 #include <queue>
+#include <unordered_map>
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <condition_variable>
 #include <memory>
 
 namespace luma {
 
+class FileWatcher;
+
+// ===== Streaming Priority =====
+// Coarse level first, then projected size on screen: a close-up hero
+// character outranks the same material on a distant prop.
+enum class TexturePriority : uint8_t {
+    Background = 0,
+    Low,
+    Normal,
+    High,
+    Critical
+};
+
+// Queue key for a level and an optional screen size in pixels (larger loads first)
+float texturePriority(TexturePriority level, float screenPixels = 0.0f);
+
+// Projected height in pixels of a sphere of `radius` seen at `distance`
+float projectedScreenSize(float distance, float radius, float fovY, float viewportHeight);
+
 // ===== Texture Load Request =====
 struct TextureLoadRequest {
     uint32_t id;                    // Unique request ID
     std::string path;               // File path or embedded data identifier
     std::vector<uint8_t> embeddedData;  // For embedded textures
     bool isEmbedded = false;
-    
-    // Callback when texture is decoded (on worker thread)
-    // Returns decoded TextureData
+    TextureHandle source;           // Already decoded pixels to cook
+    TextureRole role = TextureRole::Generic;
+    uint64_t cookedKey = 0;         // Reload from the cooked cache only (streaming restore)
+    float priority = 0.0f;
+    std::chrono::steady_clock::time_point submitTime;
 };
 
 // ===== Texture Load Result =====
 struct TextureLoadResult {
     uint32_t id;
-    TextureData data;
+    TextureHandle texture;          // Shared with the texture cache
     bool success = false;
+    bool fromCache = false;         // Already resident, no decode was needed
+    bool fromCookedCache = false;   // Loaded from disk, no decode or compression
+    // Top levels dropped by the memory budget. A result with no texture and
+    // firstMip > 0 asks the renderer to trim its existing upload to that level.
+    int firstMip = 0;
     std::string error;
 };
 
+// ===== Streaming Statistics =====
+struct TextureStreamingStats {
+    size_t queuedRequests = 0;      // Waiting for a worker
+    size_t inFlightRequests = 0;
+    size_t workerCount = 0;
+
+    uint64_t submitted = 0;
+    uint64_t coalesced = 0;         // Joined an identical pending request
+    uint64_t cancelled = 0;
+    uint64_t completed = 0;
+    uint64_t failed = 0;
+
+    double avgQueueLatencyMs = 0.0; // Submit -> worker start
+    double maxQueueLatencyMs = 0.0;
+    double avgLoadTimeMs = 0.0;     // Worker start -> done
+
+    size_t residentTextures = 0;
+    size_t residentBytes = 0;
+    size_t budgetBytes = 0;
+    size_t trimmedTextures = 0;     // Resident with top mips dropped
+    uint64_t mipsEvicted = 0;
+    uint64_t restores = 0;
+};
+
 // ===== Async Texture Loader =====
-// Thread-safe texture loading system
+// Thread-safe texture loading system. Decoded textures go through the shared
+// TextureCache, so a path or payload that is already resident completes
+// without being decoded again. With cooking enabled (the default) workers
+// also build the mip chain and block compress it per role, and keep the
+// result in a CookedTextureCache on disk for the next load.
+//
+// Requests are served highest priority first; identical pending requests
+// share one load, and every request can be cancelled. Textures handed out
+// by getCompletedTextures() stay resident until released; update() keeps
+// them within the memory budget by dropping top mips of the least recently
+// used ones, and streams them back in once they are used again.
 class AsyncTextureLoader {
 public:
+    static constexpr size_t kDefaultBudgetBytes = size_t(1) << 30;
+
     AsyncTextureLoader(size_t numThreads = 2);
     ~AsyncTextureLoader();
-    
+
     // Non-copyable
     AsyncTextureLoader(const AsyncTextureLoader&) = delete;
     AsyncTextureLoader& operator=(const AsyncTextureLoader&) = delete;
-    
+
     // Submit a texture load request
     // Returns a unique request ID
-    uint32_t loadTexture(const std::string& path);
-    uint32_t loadTextureFromMemory(const std::vector<uint8_t>& data, const std::string& name);
-    
+    uint32_t loadTexture(const std::string& path, TextureRole role = TextureRole::Generic,
+                         float priority = texturePriority(TexturePriority::Normal));
+    uint32_t loadTextureFromMemory(const std::vector<uint8_t>& data, const std::string& name,
+                                   TextureRole role = TextureRole::Generic,
+                                   float priority = texturePriority(TexturePriority::Normal));
+
+    // Cook already decoded RGBA8 pixels (e.g. textures of a loaded model)
+    uint32_t cookTexture(const TextureHandle& source, TextureRole role,
+                         float priority = texturePriority(TexturePriority::Normal));
+
+    // Reorder a queued request (no effect once a worker picked it up). For a
+    // resident texture this orders trimming and restores instead.
+    void updatePriority(uint32_t id, float priority);
+
+    // Drop a request. Returns false if it already completed.
+    bool cancel(uint32_t id);
+
+    // Mip generation / compression applied by the workers
+    void setCookSettings(const TextureCookSettings& settings);
+    TextureCookSettings getCookSettings() const;
+    CookedTextureCache& getCookedCache() { return cookedCache_; }
+
     // Check for completed textures (call from main thread)
     // Returns true if there are completed results
     bool hasCompletedTextures() const;
-    
+
     // Get all completed textures (call from main thread)
-    // Clears the completed queue
+    // Clears the completed queue. Results may repeat an ID when streaming
+    // trims or restores a resident texture; replace the previous upload.
     std::vector<TextureLoadResult> getCompletedTextures();
-    
+
+    // ===== Residency =====
+    // Mark a resident texture as used this frame
+    void touchTexture(uint32_t id);
+    // Forget a resident texture (its owner no longer needs it)
+    void releaseTexture(uint32_t id);
+
+    // ===== Hot Reload =====
+    // Decode a changed source file again and deliver it under the ID of every
+    // resident texture loaded from it. Returns the number of textures reloaded.
+    size_t reloadFile(const std::string& path);
+    // Watch the source files of resident textures and reload them on change.
+    // The watcher is driven by its owner's checkChanges() and must stay alive
+    // until detached (nullptr) or the loader is destroyed.
+    void setFileWatcher(FileWatcher* watcher);
+
+    void setMemoryBudget(size_t bytes);
+    size_t getMemoryBudget() const;
+
+    // Once per frame: trims / restores resident textures against the budget
+    void update();
+
     // Get pending count
     size_t getPendingCount() const;
-    
+
     // Wait for all pending loads to complete
     void waitForAll();
-    
+
+    // Grow or shrink the worker pool
+    void setWorkerCount(size_t count);
+    size_t getWorkerCount() const;
+
+    TextureStreamingStats getStats() const;
+
     // Shutdown the loader
     void shutdown();
-    
+
 private:
-    void workerThread();
+    // One load shared by every request ID waiting on it
+    struct PendingLoad {
+        TextureLoadRequest request;
+        std::vector<std::pair<uint32_t, float>> waiters;  // request ID, priority
+        std::string coalesceKey;
+        uint64_t sequence = 0;
+        uint32_t generation = 0;
+        bool inFlight = false;
+
+        float priority() const;
+    };
+
+    // Heap entries go stale when a load is re-prioritized or cancelled;
+    // workers skip entries whose generation no longer matches
+    struct QueueEntry {
+        float priority;
+        uint64_t sequence;
+        uint32_t loadId;
+        uint32_t generation;
+
+        bool operator<(const QueueEntry& other) const {
+            if (priority != other.priority) return priority < other.priority;
+            return sequence > other.sequence;  // FIFO within a priority
+        }
+    };
+
+    // A texture the renderer holds. Only sizes are kept here; trimming is
+    // applied to the renderer's upload, and the full chain is loaded again
+    // from its source when restored.
+    struct ResidentTexture {
+        std::vector<size_t> levelBytes;
+        int width = 0;
+        int firstMip = 0;
+        uint64_t lastUsedFrame = 0;
+        float priority = 0.0f;
+        bool restorePending = false;  // A load for this ID is queued or running
+        bool reloadPending = false;   // ...and it is a hot reload
+        bool reloadQueued = false;    // Reload once the pending load is back
+
+        // Restore source
+        std::string path;
+        std::string watchKey;         // Normalized path of a file source
+        bool isFile = false;
+        std::shared_ptr<const std::vector<uint8_t>> embeddedData;
+        std::weak_ptr<const TextureData> source;
+        uint64_t cookedKey = 0;
+        TextureRole role = TextureRole::Generic;
+
+        size_t bytes() const;
+    };
+
+    void workerThread(size_t index);
+    void pushCompleted(TextureLoadResult&& result, const ResidentTexture* restore = nullptr);
+    uint32_t submit(TextureLoadRequest&& request, const std::string& coalesceKey);
+    void enqueueLocked(PendingLoad& load);
+    void finishLoad(uint32_t loadId, TextureLoadRequest& request, TextureLoadResult&& result,
+                    uint64_t cookedKey, double loadMs);
+    TextureLoadResult processRequest(TextureLoadRequest& request, uint64_t& cookedKey);
+    TextureData cookFromSource(uint64_t sourceHash, const TextureCookSettings& settings,
+                               TextureRole role, const std::string& name,
+                               const std::function<TextureData()>& decode, bool& fromDisk);
+    std::string cookVariant(TextureRole role, const TextureCookSettings& settings) const;
+    bool canRestore(const ResidentTexture& texture) const;
+    void trimToBudgetLocked(std::vector<TextureLoadResult>& updates);
+    void scheduleRestoresLocked();
+    void submitReloadLocked(uint32_t id, ResidentTexture& resident);
+    void watchSourceLocked(ResidentTexture& resident);
+    void unwatchSourceLocked(const ResidentTexture& resident);
     TextureData decodeTexture(const std::string& path);
     TextureData decodeTextureFromMemory(const std::vector<uint8_t>& data);
-    
+
+    // Workers
     std::vector<std::thread> workers_;
-    std::queue<TextureLoadRequest> pendingQueue_;
+    std::atomic<size_t> targetWorkers_{0};
+    std::mutex workersMutex_;
+
+    // Queue; guarded by pendingMutex_
+    std::unordered_map<uint32_t, PendingLoad> loads_;         // by load (first request) ID
+    std::unordered_map<uint32_t, uint32_t> requestToLoad_;    // request ID -> load ID
+    std::unordered_map<std::string, uint32_t> coalesceIndex_; // coalesce key -> load ID
+    std::priority_queue<QueueEntry> queue_;
+    uint64_t queueSequence_ = 0;
+    size_t inFlight_ = 0;
+
+    // Guarded by completedMutex_
     std::vector<TextureLoadResult> completedResults_;
-    
+    std::unordered_map<uint32_t, ResidentTexture> restoreInfo_;  // for results not yet handed out
+
+    // Lock order: residentMutex_, pendingMutex_, completedMutex_
     mutable std::mutex pendingMutex_;
     mutable std::mutex completedMutex_;
     std::condition_variable workAvailable_;
-    
+    std::condition_variable allDone_;
+
     std::atomic<bool> running_{true};
     std::atomic<uint32_t> nextId_{1};
     std::atomic<size_t> pendingCount_{0};
+
+    mutable std::mutex settingsMutex_;
+    TextureCookSettings cookSettings_;
+    CookedTextureCache cookedCache_;
+
+    // Residency; guarded by residentMutex_
+    mutable std::mutex residentMutex_;
+    std::unordered_map<uint32_t, ResidentTexture> resident_;
+    size_t residentBytes_ = 0;
+    size_t budgetBytes_ = kDefaultBudgetBytes;
+    uint64_t frame_ = 1;
+    uint64_t mipsEvicted_ = 0;
+    uint64_t restores_ = 0;
+    FileWatcher* fileWatcher_ = nullptr;
+    std::unordered_map<std::string, std::pair<std::string, size_t>> watchedSources_;  // key -> path, textures
+
+    // Metrics; guarded by pendingMutex_
+    TextureStreamingStats counters_;
+    double queueLatencySumMs_ = 0.0;
+    double loadTimeSumMs_ = 0.0;
 };
 
 // ===== Global Loader Instance =====
@@ -3,6 +3,7 @@
 #include "stb_image.h"
 
 #include "model_loader.h"
+#include "texture_cache.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -26,27 +27,29 @@ namespace {
 // Directory of the model file (for resolving relative texture paths)
 std::string g_modelDir;
 
-// Load texture from file
-TextureData load_texture(const std::string& path) {
-    TextureData tex;
-    tex.path = path;
-    
-    int w, h, channels;
-    stbi_set_flip_vertically_on_load(false);  // Don't flip for DirectX (origin is top-left)
-    unsigned char* data = stbi_load(path.c_str(), &w, &h, &channels, 4);  // Force RGBA
-    
-    if (data) {
-        tex.width = w;
-        tex.height = h;
-        tex.channels = 4;
-        tex.pixels.assign(data, data + w * h * 4);
-        stbi_image_free(data);
-        std::cout << "[texture] Loaded: " << path << " (" << w << "x" << h << ")" << std::endl;
-    } else {
-        std::cerr << "[texture] Failed to load: " << path << std::endl;
-    }
-    
-    return tex;
+// Load texture from file (shared through the texture cache)
+TextureHandle load_texture(const std::string& path) {
+    return getTextureCache().getOrLoadFile(path, [&path]() {
+        TextureData tex;
+        tex.path = path;
+        
+        int w, h, channels;
+        stbi_set_flip_vertically_on_load(false);  // Don't flip for DirectX (origin is top-left)
+        unsigned char* data = stbi_load(path.c_str(), &w, &h, &channels, 4);  // Force RGBA
+        
+        if (data) {
+            tex.width = w;
+            tex.height = h;
+            tex.channels = 4;
+            tex.pixels.assign(data, data + w * h * 4);
+            stbi_image_free(data);
+            std::cout << "[texture] Loaded: " << path << " (" << w << "x" << h << ")" << std::endl;
+        } else {
+            std::cerr << "[texture] Failed to load: " << path << std::endl;
+        }
+        
+        return tex;
+    });
 }
 
 // Try to find texture file
@@ -82,43 +85,48 @@ std::string find_texture_file(const std::string& texPath) {
     return "";  // Not found
 }
 
-// Load embedded texture by index
-TextureData load_embedded_texture(const aiTexture* aiTex) {
-    TextureData tex;
-    if (!aiTex) return tex;
+// Load embedded texture by index (shared through the texture cache)
+TextureHandle load_embedded_texture(const aiTexture* aiTex) {
+    if (!aiTex) return nullptr;
     
     if (aiTex->mHeight == 0) {
-        // Compressed format (PNG, JPG, etc.) - mWidth is the size in bytes
-        int w, h, channels;
-        stbi_set_flip_vertically_on_load(false);  // Don't flip for DirectX
-        unsigned char* data = stbi_load_from_memory(
-            reinterpret_cast<const unsigned char*>(aiTex->pcData),
-            aiTex->mWidth, &w, &h, &channels, 4);
-        if (data) {
-            tex.width = w;
-            tex.height = h;
-            tex.channels = 4;
-            tex.pixels.assign(data, data + w * h * 4);
-            tex.path = aiTex->mFilename.C_Str();
-            stbi_image_free(data);
-            std::cout << "[texture] Loaded embedded: " << w << "x" << h << " (" << tex.path << ")" << std::endl;
-        }
-    } else {
-        // Uncompressed ARGB8888 format
-        tex.width = aiTex->mWidth;
-        tex.height = aiTex->mHeight;
-        tex.channels = 4;
-        tex.pixels.resize(tex.width * tex.height * 4);
-        for (unsigned int i = 0; i < aiTex->mWidth * aiTex->mHeight; i++) {
-            tex.pixels[i * 4 + 0] = aiTex->pcData[i].r;
-            tex.pixels[i * 4 + 1] = aiTex->pcData[i].g;
-            tex.pixels[i * 4 + 2] = aiTex->pcData[i].b;
-            tex.pixels[i * 4 + 3] = aiTex->pcData[i].a;
-        }
-        tex.path = "[embedded raw]";
-        std::cout << "[texture] Loaded embedded raw: " << tex.width << "x" << tex.height << std::endl;
+        // Compressed format (PNG, JPG, etc.) - mWidth is the size in bytes.
+        // Keyed by the encoded bytes so meshes sharing it decode once.
+        return getTextureCache().getOrLoadMemory(aiTex->pcData, aiTex->mWidth, [aiTex]() {
+            TextureData tex;
+            int w, h, channels;
+            stbi_set_flip_vertically_on_load(false);  // Don't flip for DirectX
+            unsigned char* data = stbi_load_from_memory(
+                reinterpret_cast<const unsigned char*>(aiTex->pcData),
+                aiTex->mWidth, &w, &h, &channels, 4);
+            if (data) {
+                tex.width = w;
+                tex.height = h;
+                tex.channels = 4;
+                tex.pixels.assign(data, data + w * h * 4);
+                tex.path = aiTex->mFilename.C_Str();
+                stbi_image_free(data);
+                std::cout << "[texture] Loaded embedded: " << w << "x" << h << " (" << tex.path << ")" << std::endl;
+            }
+            return tex;
+        });
     }
-    return tex;
+    
+    // Uncompressed ARGB8888 format
+    TextureData tex;
+    tex.width = aiTex->mWidth;
+    tex.height = aiTex->mHeight;
+    tex.channels = 4;
+    tex.pixels.resize(tex.width * tex.height * 4);
+    for (unsigned int i = 0; i < aiTex->mWidth * aiTex->mHeight; i++) {
+        tex.pixels[i * 4 + 0] = aiTex->pcData[i].r;
+        tex.pixels[i * 4 + 1] = aiTex->pcData[i].g;
+        tex.pixels[i * 4 + 2] = aiTex->pcData[i].b;
+        tex.pixels[i * 4 + 3] = aiTex->pcData[i].a;
+    }
+    tex.path = "[embedded raw]";
+    std::cout << "[texture] Loaded embedded raw: " << tex.width << "x" << tex.height << std::endl;
+    return getTextureCache().insert(std::move(tex));
 }
 
 // Find embedded texture by matching filename
@@ -175,8 +183,8 @@ const aiTexture* get_embedded_texture_for_material(const aiScene* scene, unsigne
 }
 
 // Get texture from material (supports embedded and external textures)
-TextureData get_material_texture(const aiMaterial* mat, aiTextureType type, const aiScene* scene) {
-    TextureData tex;
+TextureHandle get_material_texture(const aiMaterial* mat, aiTextureType type, const aiScene* scene) {
+    TextureHandle tex;
     
     if (mat->GetTextureCount(type) > 0) {
         aiString texPath;
@@ -297,7 +305,7 @@ Mesh process_mesh(const aiMesh* aiMesh, const aiScene* scene, Model& model) {
         }
         
         // Try all possible texture types for diffuse/albedo
-        TextureData diffuseTex;
+        TextureHandle diffuseTex;
         aiTextureType tryTypes[] = {
             aiTextureType_DIFFUSE,
             aiTextureType_BASE_COLOR,
@@ -305,13 +313,13 @@ Mesh process_mesh(const aiMesh* aiMesh, const aiScene* scene, Model& model) {
             aiTextureType_UNKNOWN,  // Fallback
         };
         for (auto type : tryTypes) {
-            if (diffuseTex.pixels.empty()) {
+            if (!hasPixels(diffuseTex)) {
                 diffuseTex = get_material_texture(mat, type, scene);
             }
         }
         
         // Fallback: try to use embedded texture by material index (for FBX files)
-        if (diffuseTex.pixels.empty() && scene->mNumTextures > 0) {
+        if (!hasPixels(diffuseTex) && scene->mNumTextures > 0) {
             // Try to find any embedded texture that might work for this material
             const aiTexture* embeddedTex = get_embedded_texture_for_material(scene, aiMesh->mMaterialIndex);
             if (embeddedTex) {
@@ -320,7 +328,7 @@ Mesh process_mesh(const aiMesh* aiMesh, const aiScene* scene, Model& model) {
             }
             
             // If still empty and there are embedded textures, try first available
-            if (diffuseTex.pixels.empty() && scene->mNumTextures > 0) {
+            if (!hasPixels(diffuseTex) && scene->mNumTextures > 0) {
                 // Scan all embedded textures and use the first one that looks like a diffuse/albedo
                 for (unsigned int ti = 0; ti < scene->mNumTextures; ti++) {
                     const aiTexture* tex = scene->mTextures[ti];
@@ -337,9 +345,9 @@ Mesh process_mesh(const aiMesh* aiMesh, const aiScene* scene, Model& model) {
                                         texNameLower.find("_d.") != std::string::npos ||
                                         texNameLower.find("_c.") != std::string::npos;
                         
-                        if (isDiffuse || (ti == 0 && diffuseTex.pixels.empty())) {
+                        if (isDiffuse || (ti == 0 && !hasPixels(diffuseTex))) {
                             diffuseTex = load_embedded_texture(tex);
-                            if (!diffuseTex.pixels.empty()) {
+                            if (hasPixels(diffuseTex)) {
                                 std::cout << "  [scan] Found embedded diffuse: " << texName << std::endl;
                                 break;
                             }
@@ -349,29 +357,29 @@ Mesh process_mesh(const aiMesh* aiMesh, const aiScene* scene, Model& model) {
             }
         }
         
-        if (!diffuseTex.pixels.empty()) {
+        if (hasPixels(diffuseTex)) {
             mesh.diffuseTexture = std::move(diffuseTex);
             mesh.hasDiffuseTexture = true;
         }
         
         // Load normal map
-        TextureData normalTex = get_material_texture(mat, aiTextureType_NORMALS, scene);
-        if (normalTex.pixels.empty()) {
+        TextureHandle normalTex = get_material_texture(mat, aiTextureType_NORMALS, scene);
+        if (!hasPixels(normalTex)) {
             // Try height map as fallback
             normalTex = get_material_texture(mat, aiTextureType_HEIGHT, scene);
         }
-        if (!normalTex.pixels.empty()) {
+        if (hasPixels(normalTex)) {
             mesh.normalTexture = std::move(normalTex);
             mesh.hasNormalTexture = true;
             std::cout << "  [loaded] Normal map" << std::endl;
         }
         
         // Load specular/metallic map
-        TextureData specTex = get_material_texture(mat, aiTextureType_SPECULAR, scene);
-        if (specTex.pixels.empty()) {
+        TextureHandle specTex = get_material_texture(mat, aiTextureType_SPECULAR, scene);
+        if (!hasPixels(specTex)) {
             specTex = get_material_texture(mat, aiTextureType_METALNESS, scene);
         }
-        if (!specTex.pixels.empty()) {
+        if (hasPixels(specTex)) {
             mesh.specularTexture = std::move(specTex);
             mesh.hasSpecularTexture = true;
             std::cout << "  [loaded] Specular/Metallic map" << std::endl;
@@ -465,6 +473,18 @@ Mesh process_mesh(const aiMesh* aiMesh, const aiScene* scene, Model& model) {
     return mesh;
 }
 
+// Record how much texture decoding the shared cache avoided for this model
+void record_texture_sharing(Model& model, const TextureCacheStats& before) {
+    TextureCacheStats after = getTextureCache().getStats();
+    model.textureBytesDecoded = after.decodedBytes - before.decodedBytes;
+    model.textureBytesShared = after.bytesSaved - before.bytesSaved;
+    if (after.hits > before.hits) {
+        std::cout << "[texture] Shared " << (after.hits - before.hits) << " texture references, "
+                  << model.textureBytesDecoded / (1024 * 1024) << " MB decoded, "
+                  << model.textureBytesShared / (1024 * 1024) << " MB saved" << std::endl;
+    }
+}
+
 // Recursively process nodes
 void process_node(const aiNode* node, const aiScene* scene, Model& model) {
     for (unsigned int i = 0; i < node->mNumMeshes; i++) {
@@ -524,7 +544,9 @@ std::optional<Model> load_model(const std::string& path) {
     model.minBounds[0] = model.minBounds[1] = model.minBounds[2] = std::numeric_limits<float>::max();
     model.maxBounds[0] = model.maxBounds[1] = model.maxBounds[2] = std::numeric_limits<float>::lowest();
 
+    TextureCacheStats cacheBefore = getTextureCache().getStats();
     process_node(scene->mRootNode, scene, model);
+    record_texture_sharing(model, cacheBefore);
 
     if (model.meshes.empty()) {
         std::cerr << "[model] No valid meshes found" << std::endl;
@@ -850,7 +872,9 @@ std::optional<Model> load_model_with_animations(const std::string& path) {
     load_skeleton(scene, model);
 
     // Process meshes
+    TextureCacheStats cacheBefore = getTextureCache().getStats();
     process_node(scene->mRootNode, scene, model);
+    record_texture_sharing(model, cacheBefore);
 
     // Load bone weights for each mesh
     if (model.hasSkeleton()) {
@@ -25,6 +25,8 @@ struct Model {
     // Statistics
     size_t totalVertices = 0;
     size_t totalTriangles = 0;
+    size_t textureBytesDecoded = 0;   // Pixel bytes decoded for this model
+    size_t textureBytesShared = 0;    // Pixel bytes reused from the texture cache
     
     // Skeletal animation data (optional)
     std::unique_ptr<Skeleton> skeleton;
@@ -0,0 +1,225 @@
+// Texture Cache Implementation
+#include "texture_cache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace luma {
+
+TextureCache& TextureCache::get() {
+    static TextureCache instance;
+    return instance;
+}
+
+uint64_t TextureCache::hashBytes(const void* data, size_t size, uint64_t seed) {
+    // 8 bytes per step with a multiply/xorshift mix; fast enough to hash
+    // multi-megabyte images without showing up next to the decode itself
+    const uint64_t kMul = 0x9E3779B97F4A7C15ULL;
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    uint64_t h = seed ^ (size * kMul);
+
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes + i, sizeof(word));
+        h ^= word * kMul;
+        h = (h << 31) | (h >> 33);
+        h *= 0xBF58476D1CE4E5B9ULL;
+    }
+    uint64_t tail = 0;
+    for (size_t shift = 0; i < size; ++i, shift += 8) {
+        tail |= static_cast<uint64_t>(bytes[i]) << shift;
+    }
+    h ^= tail * kMul;
+
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
+
+std::string TextureCache::normalizePath(const std::string& path) {
+    std::error_code ec;
+    std::filesystem::path resolved = std::filesystem::weakly_canonical(path, ec);
+    std::string key = ec ? std::filesystem::path(path).lexically_normal().string() : resolved.string();
+#if defined(_WIN32)
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) {
+        return c == '\\' ? '/' : static_cast<char>(std::tolower(c));
+    });
+#endif
+    return key;
+}
+
+static std::string hexKey(const char* prefix, uint64_t hash) {
+    static const char digits[] = "0123456789abcdef";
+    std::string key = prefix;
+    for (int i = 60; i >= 0; i -= 4) {
+        key += digits[(hash >> i) & 0xF];
+    }
+    return key;
+}
+
+// Decoded pixels: the layout is part of the key, as equal bytes at different
+// dimensions are a different image
+static std::string pixelKey(const TextureData& data) {
+    return hexKey("pix:", TextureCache::hashBytes(data.pixels.data(), data.pixels.size())) + ':' +
+           std::to_string(data.width) + 'x' + std::to_string(data.height) + 'x' +
+           std::to_string(data.channels);
+}
+
+uint64_t TextureCache::hashPixels(const TextureData& data) {
+    int32_t layout[3] = {data.width, data.height, data.channels};
+    return hashBytes(data.pixels.data(), data.pixels.size(), hashBytes(layout, sizeof(layout)));
+}
+
+TextureHandle TextureCache::find(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return nullptr;
+
+    TextureHandle handle = it->second.lock();
+    if (!handle) {
+        entries_.erase(it);
+        return nullptr;
+    }
+    stats_.requests++;
+    stats_.hits++;
+    stats_.bytesSaved += handle->byteSize();
+    return handle;
+}
+
+TextureHandle TextureCache::store(const std::string& key, TextureData&& data) {
+    if (data.byteSize() == 0) return nullptr;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.decodedBytes += data.byteSize();
+
+    // Another thread may have decoded the same texture meanwhile; keep the first
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        if (TextureHandle existing = it->second.lock()) {
+            stats_.requests++;
+            stats_.hits++;
+            stats_.bytesSaved += existing->byteSize();
+            return existing;
+        }
+    }
+
+    TextureHandle handle = std::make_shared<const TextureData>(std::move(data));
+    entries_[key] = handle;
+    stats_.requests++;
+    return handle;
+}
+
+static std::string withVariant(std::string key, const std::string& variant) {
+    if (!variant.empty()) {
+        key += '#';
+        key += variant;
+    }
+    return key;
+}
+
+TextureHandle TextureCache::getOrLoadFile(const std::string& path, const Decoder& decode,
+                                          const std::string& variant) {
+    std::string key = withVariant("file:" + normalizePath(path), variant);
+    if (TextureHandle cached = find(key)) {
+        return cached;
+    }
+    return store(key, decode());
+}
+
+TextureHandle TextureCache::findFile(const std::string& path, const std::string& variant) {
+    return find(withVariant("file:" + normalizePath(path), variant));
+}
+
+size_t TextureCache::invalidateFile(const std::string& path) {
+    std::string key = "file:" + normalizePath(path);
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t removed = 0;
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        const std::string& entry = it->first;
+        if (entry.compare(0, key.size(), key) == 0 && (entry.size() == key.size() || entry[key.size()] == '#')) {
+            it = entries_.erase(it);
+            removed++;
+        } else {
+            ++it;
+        }
+    }
+    return removed;
+}
+
+TextureHandle TextureCache::getOrLoadMemory(const void* data, size_t size, const Decoder& decode,
+                                            const std::string& variant) {
+    // The size is part of the key so a hash collision also needs equal lengths
+    std::string key = hexKey("mem:", hashBytes(data, size)) + ':' + std::to_string(size);
+    key = withVariant(std::move(key), variant);
+    if (TextureHandle cached = find(key)) {
+        return cached;
+    }
+    return store(key, decode());
+}
+
+TextureHandle TextureCache::getOrLoadPixels(const TextureData& source, const Decoder& decode,
+                                            const std::string& variant) {
+    std::string key = withVariant(pixelKey(source), variant);
+    if (TextureHandle cached = find(key)) {
+        return cached;
+    }
+    return store(key, decode());
+}
+
+TextureHandle TextureCache::insert(TextureData&& data) {
+    if (data.pixels.empty()) return nullptr;
+
+    std::string key = pixelKey(data);
+    if (TextureHandle cached = find(key)) {
+        // The pixels are at hand, so a hash collision is caught here rather than
+        // handing out someone else's image; the newcomer just goes uncached
+        if (cached->pixels == data.pixels) return cached;
+        return std::make_shared<const TextureData>(std::move(data));
+    }
+
+    // Count inserted pixels as decoded so bytesSaved stays comparable
+    return store(key, std::move(data));
+}
+
+size_t TextureCache::collectGarbage() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t removed = 0;
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second.expired()) {
+            it = entries_.erase(it);
+            removed++;
+        } else {
+            ++it;
+        }
+    }
+    return removed;
+}
+
+void TextureCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+}
+
+TextureCacheStats TextureCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TextureCacheStats stats = stats_;
+    stats.residentTextures = 0;
+    for (const auto& [key, entry] : entries_) {
+        if (!entry.expired()) stats.residentTextures++;
+    }
+    return stats;
+}
+
+void TextureCache::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_ = TextureCacheStats{};
+}
+
+}  // namespace luma
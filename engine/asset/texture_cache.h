@@ -0,0 +1,94 @@
+// Texture Cache - Shared decoded textures
+// Meshes that reference the same image (by resolved path or by content) share
+// one decoded TextureData instead of each holding a private copy.
+#pragma once
+
+#include "engine/renderer/mesh.h"
+#include <string>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+
+namespace luma {
+
+// ===== Texture Cache Statistics =====
+struct TextureCacheStats {
+    size_t requests = 0;         // Lookups that produced a texture
+    size_t hits = 0;             // Lookups served by an existing texture
+    size_t residentTextures = 0; // Unique textures still referenced
+    size_t decodedBytes = 0;     // Pixel bytes actually decoded
+    size_t bytesSaved = 0;       // Pixel bytes served from an existing texture instead of a new copy
+
+    float hitRate() const { return requests > 0 ? static_cast<float>(hits) / requests : 0.0f; }
+};
+
+// ===== Texture Cache =====
+// Thread-safe. Entries are weak: a texture is released once no mesh holds its
+// handle, so the cache never keeps pixels alive on its own.
+class TextureCache {
+public:
+    using Decoder = std::function<TextureData()>;
+
+    static TextureCache& get();
+
+    // File texture keyed by its resolved, normalized path. `variant` separates
+    // differently processed versions of one source (e.g. cooked vs. raw).
+    TextureHandle getOrLoadFile(const std::string& path, const Decoder& decode,
+                                const std::string& variant = "");
+
+    // Encoded bytes (e.g. an embedded PNG) keyed by a hash of the bytes, so
+    // identical payloads are decoded only once
+    TextureHandle getOrLoadMemory(const void* data, size_t size, const Decoder& decode,
+                                  const std::string& variant = "");
+
+    // Already decoded pixels keyed by their content; returns the existing
+    // handle if identical pixels are resident
+    TextureHandle insert(TextureData&& data);
+
+    // Already decoded pixels that are processed before caching (e.g. cooked).
+    // Keyed like insert(), so the same bytes at other dimensions never match.
+    TextureHandle getOrLoadPixels(const TextureData& source, const Decoder& decode,
+                                  const std::string& variant = "");
+
+    // Lookup without loading; null if the file texture is not resident
+    TextureHandle findFile(const std::string& path, const std::string& variant = "");
+
+    // Forget every variant of a file texture so the next load decodes it
+    // again (hot reload). Handles already given out stay valid.
+    size_t invalidateFile(const std::string& path);
+
+    // Drop expired entries
+    size_t collectGarbage();
+
+    void clear();
+
+    TextureCacheStats getStats() const;
+    void resetStats();
+
+    // 64-bit content hash used for memory and pixel keys
+    static uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 0);
+
+    // Content hash of decoded pixels including their width, height and channels
+    static uint64_t hashPixels(const TextureData& data);
+
+    // Resolve a file path to the key used by getOrLoadFile
+    static std::string normalizePath(const std::string& path);
+
+private:
+    TextureCache() = default;
+
+    TextureHandle find(const std::string& key);
+    TextureHandle store(const std::string& key, TextureData&& data);
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::weak_ptr<const TextureData>> entries_;
+    TextureCacheStats stats_;
+};
+
+inline TextureCache& getTextureCache() {
+    return TextureCache::get();
+}
+
+}  // namespace luma
@@ -0,0 +1,1027 @@
+// Texture Compression Implementation
+#include "texture_compression.h"
+#include "texture_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace luma {
+
+const char* textureRoleName(TextureRole role) {
+    switch (role) {
+        case TextureRole::Generic: return "generic";
+        case TextureRole::Albedo:  return "albedo";
+        case TextureRole::Normal:  return "normal";
+        case TextureRole::ORM:     return "orm";
+    }
+    return "?";
+}
+
+const char* textureFormatName(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::RGBA8: return "RGBA8";
+        case TextureFormat::BC1:   return "BC1";
+        case TextureFormat::BC3:   return "BC3";
+        case TextureFormat::BC5:   return "BC5";
+        case TextureFormat::BC7:   return "BC7";
+    }
+    return "?";
+}
+
+// ===== Format Helpers =====
+
+size_t textureBlockBytes(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::RGBA8: return 0;
+        case TextureFormat::BC1:   return 8;
+        case TextureFormat::BC3:
+        case TextureFormat::BC5:
+        case TextureFormat::BC7:   return 16;
+    }
+    return 0;
+}
+
+size_t textureLevelSize(TextureFormat format, int width, int height) {
+    if (!isBlockCompressed(format)) {
+        return static_cast<size_t>(width) * height * 4;
+    }
+    size_t blocksX = (width + 3) / 4;
+    size_t blocksY = (height + 3) / 4;
+    return blocksX * blocksY * textureBlockBytes(format);
+}
+
+int textureMipCount(int width, int height) {
+    int levels = 1;
+    while (width > 1 || height > 1) {
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+        levels++;
+    }
+    return levels;
+}
+
+TextureFormat selectTextureFormat(TextureRole role, bool hasAlpha, TextureQuality quality) {
+    switch (role) {
+        case TextureRole::Normal:
+            return TextureFormat::BC5;
+        case TextureRole::ORM:
+            return quality == TextureQuality::High ? TextureFormat::BC7 : TextureFormat::BC1;
+        case TextureRole::Albedo:
+        case TextureRole::Generic:
+            if (quality == TextureQuality::High) return TextureFormat::BC7;
+            return hasAlpha ? TextureFormat::BC3 : TextureFormat::BC1;
+    }
+    return TextureFormat::BC7;
+}
+
+// ===== Mip Generation =====
+
+namespace {
+
+struct SrgbTables {
+    float toLinear[256];
+    uint8_t fromLinear[4096];
+
+    SrgbTables() {
+        for (int i = 0; i < 256; i++) {
+            float c = i / 255.0f;
+            toLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        for (int i = 0; i < 4096; i++) {
+            float l = i / 4095.0f;
+            float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+            fromLinear[i] = static_cast<uint8_t>(std::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f));
+        }
+    }
+};
+
+const SrgbTables& srgbTables() {
+    static const SrgbTables tables;
+    return tables;
+}
+
+inline uint8_t toUnorm8(float v) {
+    return static_cast<uint8_t>(std::clamp(v * 255.0f + 0.5f, 0.0f, 255.0f));
+}
+
+// Level data is filtered in float so rounding does not accumulate down the chain
+void decodeForFiltering(const uint8_t* rgba, size_t count, TextureRole role, std::vector<float>& out) {
+    const SrgbTables& srgb = srgbTables();
+    out.resize(count * 4);
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* p = rgba + i * 4;
+        float* o = out.data() + i * 4;
+        switch (role) {
+            case TextureRole::Albedo:
+                o[0] = srgb.toLinear[p[0]];
+                o[1] = srgb.toLinear[p[1]];
+                o[2] = srgb.toLinear[p[2]];
+                o[3] = p[3] / 255.0f;
+                break;
+            case TextureRole::Normal:
+                o[0] = p[0] / 127.5f - 1.0f;
+                o[1] = p[1] / 127.5f - 1.0f;
+                o[2] = p[2] / 127.5f - 1.0f;
+                o[3] = p[3] / 255.0f;
+                break;
+            default:
+                for (int c = 0; c < 4; c++) o[c] = p[c] / 255.0f;
+                break;
+        }
+    }
+}
+
+void encodeFiltered(const std::vector<float>& level, TextureRole role, std::vector<uint8_t>& out) {
+    const SrgbTables& srgb = srgbTables();
+    size_t count = level.size() / 4;
+    out.resize(count * 4);
+    for (size_t i = 0; i < count; i++) {
+        const float* p = level.data() + i * 4;
+        uint8_t* o = out.data() + i * 4;
+        switch (role) {
+            case TextureRole::Albedo:
+                for (int c = 0; c < 3; c++) {
+                    int idx = static_cast<int>(std::clamp(p[c], 0.0f, 1.0f) * 4095.0f + 0.5f);
+                    o[c] = srgb.fromLinear[idx];
+                }
+                o[3] = toUnorm8(p[3]);
+                break;
+            case TextureRole::Normal:
+                for (int c = 0; c < 3; c++) o[c] = toUnorm8(p[c] * 0.5f + 0.5f);
+                o[3] = toUnorm8(p[3]);
+                break;
+            default:
+                for (int c = 0; c < 4; c++) o[c] = toUnorm8(p[c]);
+                break;
+        }
+    }
+}
+
+// 2x2 box filter; odd edges reuse the last row/column
+void downsample(const std::vector<float>& src, int srcW, int srcH, TextureRole role,
+                std::vector<float>& dst, int dstW, int dstH) {
+    dst.resize(static_cast<size_t>(dstW) * dstH * 4);
+    for (int y = 0; y < dstH; y++) {
+        int y0 = std::min(y * 2, srcH - 1);
+        int y1 = std::min(y * 2 + 1, srcH - 1);
+        for (int x = 0; x < dstW; x++) {
+            int x0 = std::min(x * 2, srcW - 1);
+            int x1 = std::min(x * 2 + 1, srcW - 1);
+            const float* a = &src[(static_cast<size_t>(y0) * srcW + x0) * 4];
+            const float* b = &src[(static_cast<size_t>(y0) * srcW + x1) * 4];
+            const float* c = &src[(static_cast<size_t>(y1) * srcW + x0) * 4];
+            const float* d = &src[(static_cast<size_t>(y1) * srcW + x1) * 4];
+            float* o = &dst[(static_cast<size_t>(y) * dstW + x) * 4];
+            for (int k = 0; k < 4; k++) {
+                o[k] = (a[k] + b[k] + c[k] + d[k]) * 0.25f;
+            }
+            if (role == TextureRole::Normal) {
+                float len = std::sqrt(o[0] * o[0] + o[1] * o[1] + o[2] * o[2]);
+                if (len > 1e-6f) {
+                    o[0] /= len;
+                    o[1] /= len;
+                    o[2] /= len;
+                } else {
+                    o[0] = 0.0f;
+                    o[1] = 0.0f;
+                    o[2] = 1.0f;
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+std::vector<TextureMip> generateMipChain(const uint8_t* rgba, int width, int height, TextureRole role) {
+    std::vector<TextureMip> chain;
+    if (!rgba || width <= 0 || height <= 0) return chain;
+
+    chain.reserve(textureMipCount(width, height));
+    TextureMip base;
+    base.width = width;
+    base.height = height;
+    base.data.assign(rgba, rgba + static_cast<size_t>(width) * height * 4);
+    chain.push_back(std::move(base));
+
+    std::vector<float> current, next;
+    decodeForFiltering(rgba, static_cast<size_t>(width) * height, role, current);
+
+    int w = width, h = height;
+    while (w > 1 || h > 1) {
+        int nw = std::max(1, w / 2);
+        int nh = std::max(1, h / 2);
+        downsample(current, w, h, role, next, nw, nh);
+
+        TextureMip mip;
+        mip.width = nw;
+        mip.height = nh;
+        encodeFiltered(next, role, mip.data);
+        chain.push_back(std::move(mip));
+
+        std::swap(current, next);
+        w = nw;
+        h = nh;
+    }
+    return chain;
+}
+
+// ===== Block Compression =====
+
+namespace {
+
+struct ColorBlock {
+    uint8_t px[16][4];
+};
+
+void fetchBlock(const uint8_t* rgba, int width, int height, int bx, int by, ColorBlock& block) {
+    for (int y = 0; y < 4; y++) {
+        int sy = std::min(by * 4 + y, height - 1);
+        for (int x = 0; x < 4; x++) {
+            int sx = std::min(bx * 4 + x, width - 1);
+            std::memcpy(block.px[y * 4 + x], rgba + (static_cast<size_t>(sy) * width + sx) * 4, 4);
+        }
+    }
+}
+
+// Principal axis of `channels`-dimensional points by power iteration
+void principalAxis(const float (*points)[4], int count, int channels, float mean[4], float axis[4]) {
+    for (int c = 0; c < 4; c++) mean[c] = 0.0f;
+    for (int i = 0; i < count; i++) {
+        for (int c = 0; c < channels; c++) mean[c] += points[i][c];
+    }
+    for (int c = 0; c < channels; c++) mean[c] /= count;
+
+    float cov[4][4] = {};
+    for (int i = 0; i < count; i++) {
+        float d[4];
+        for (int c = 0; c < channels; c++) d[c] = points[i][c] - mean[c];
+        for (int r = 0; r < channels; r++) {
+            for (int c = r; c < channels; c++) cov[r][c] += d[r] * d[c];
+        }
+    }
+    for (int r = 0; r < channels; r++) {
+        for (int c = 0; c < r; c++) cov[r][c] = cov[c][r];
+    }
+
+    // Start from the covariance row with the largest diagonal
+    int start = 0;
+    for (int c = 1; c < channels; c++) {
+        if (cov[c][c] > cov[start][start]) start = c;
+    }
+    float v[4] = {};
+    for (int c = 0; c < channels; c++) v[c] = cov[start][c];
+    for (int iter = 0; iter < 8; iter++) {
+        float n[4] = {};
+        for (int r = 0; r < channels; r++) {
+            for (int c = 0; c < channels; c++) n[r] += cov[r][c] * v[c];
+        }
+        float len = 0.0f;
+        for (int c = 0; c < channels; c++) len = std::max(len, std::fabs(n[c]));
+        if (len < 1e-12f) break;
+        for (int c = 0; c < channels; c++) v[c] = n[c] / len;
+    }
+    float len = 0.0f;
+    for (int c = 0; c < channels; c++) len += v[c] * v[c];
+    len = std::sqrt(len);
+    for (int c = 0; c < 4; c++) axis[c] = (c < channels && len > 1e-12f) ? v[c] / len : 0.0f;
+    if (len <= 1e-12f) axis[0] = 1.0f;
+}
+
+// Endpoints at the extremes of the projection onto the principal axis
+void axisEndpoints(const float (*points)[4], int count, int channels, float e0[4], float e1[4]) {
+    float mean[4], axis[4];
+    principalAxis(points, count, channels, mean, axis);
+    float minT = 1e30f, maxT = -1e30f;
+    for (int i = 0; i < count; i++) {
+        float t = 0.0f;
+        for (int c = 0; c < channels; c++) t += (points[i][c] - mean[c]) * axis[c];
+        minT = std::min(minT, t);
+        maxT = std::max(maxT, t);
+    }
+    for (int c = 0; c < channels; c++) {
+        e0[c] = std::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+        e1[c] = std::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+    }
+}
+
+// Least-squares endpoints for fixed per-pixel interpolation weights
+// (`weights[i]` is the fraction of e1 in pixel i)
+bool refineEndpoints(const float (*points)[4], const float* weights, int count, int channels,
+                     float e0[4], float e1[4]) {
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    float ax[4] = {}, bx[4] = {};
+    for (int i = 0; i < count; i++) {
+        float b = weights[i];
+        float a = 1.0f - b;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (int c = 0; c < channels; c++) {
+            ax[c] += a * points[i][c];
+            bx[c] += b * points[i][c];
+        }
+    }
+    float det = aa * bb - ab * ab;
+    if (std::fabs(det) < 1e-6f) return false;
+    float inv = 1.0f / det;
+    for (int c = 0; c < channels; c++) {
+        e0[c] = std::clamp((bb * ax[c] - ab * bx[c]) * inv, 0.0f, 255.0f);
+        e1[c] = std::clamp((aa * bx[c] - ab * ax[c]) * inv, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+// ----- BC1 color block (always 4-color mode) -----
+
+inline uint16_t packRGB565(const float c[4]) {
+    int r = static_cast<int>(std::lround(c[0] * 31.0f / 255.0f));
+    int g = static_cast<int>(std::lround(c[1] * 63.0f / 255.0f));
+    int b = static_cast<int>(std::lround(c[2] * 31.0f / 255.0f));
+    return static_cast<uint16_t>((std::clamp(r, 0, 31) << 11) | (std::clamp(g, 0, 63) << 5) | std::clamp(b, 0, 31));
+}
+
+inline void unpackRGB565(uint16_t v, int out[3]) {
+    int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+void bc1Palette(uint16_t c0, uint16_t c1, int palette[4][3]) {
+    unpackRGB565(c0, palette[0]);
+    unpackRGB565(c1, palette[1]);
+    for (int c = 0; c < 3; c++) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+}
+
+// Returns squared error; fills 2-bit indices
+int bc1Indices(const ColorBlock& block, uint16_t c0, uint16_t c1, uint32_t& indices) {
+    int palette[4][3];
+    bc1Palette(c0, c1, palette);
+    indices = 0;
+    int total = 0;
+    for (int i = 0; i < 16; i++) {
+        int best = 0, bestErr = 1 << 30;
+        for (int p = 0; p < 4; p++) {
+            int dr = block.px[i][0] - palette[p][0];
+            int dg = block.px[i][1] - palette[p][1];
+            int db = block.px[i][2] - palette[p][2];
+            int err = dr * dr + dg * dg + db * db;
+            if (err < bestErr) {
+                bestErr = err;
+                best = p;
+            }
+        }
+        indices |= static_cast<uint32_t>(best) << (i * 2);
+        total += bestErr;
+    }
+    return total;
+}
+
+void encodeBC1Color(const ColorBlock& block, uint8_t* out, int refineIterations) {
+    float points[16][4];
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 4; c++) points[i][c] = block.px[i][c];
+    }
+
+    float e0[4] = {}, e1[4] = {};
+    axisEndpoints(points, 16, 3, e0, e1);
+
+    uint16_t bestC0 = 0, bestC1 = 0;
+    uint32_t bestIndices = 0;
+    int bestErr = 1 << 30;
+
+    static const float kWeights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+    for (int iter = 0; iter <= refineIterations; iter++) {
+        uint16_t c0 = packRGB565(e0);
+        uint16_t c1 = packRGB565(e1);
+        if (c0 < c1) std::swap(c0, c1);
+
+        // Equal endpoints would select 3-color mode; index 0 is exact for every pixel then
+        uint32_t indices = 0;
+        int err = bc1Indices(block, c0, c1, indices);
+        if (c0 == c1) indices = 0;
+        if (err < bestErr) {
+            bestErr = err;
+            bestC0 = c0;
+            bestC1 = c1;
+            bestIndices = indices;
+        }
+        if (c0 == c1 || iter == refineIterations) break;
+
+        float weights[16];
+        for (int i = 0; i < 16; i++) weights[i] = kWeights[(indices >> (i * 2)) & 3];
+        if (!refineEndpoints(points, weights, 16, 3, e0, e1)) break;
+    }
+
+    out[0] = static_cast<uint8_t>(bestC0 & 0xFF);
+    out[1] = static_cast<uint8_t>(bestC0 >> 8);
+    out[2] = static_cast<uint8_t>(bestC1 & 0xFF);
+    out[3] = static_cast<uint8_t>(bestC1 >> 8);
+    for (int i = 0; i < 4; i++) out[4 + i] = static_cast<uint8_t>(bestIndices >> (i * 8));
+}
+
+void decodeBC1Color(const uint8_t* in, uint8_t out[16][4], bool forceFourColor) {
+    uint16_t c0 = static_cast<uint16_t>(in[0] | (in[1] << 8));
+    uint16_t c1 = static_cast<uint16_t>(in[2] | (in[3] << 8));
+    int palette[4][3];
+    bc1Palette(c0, c1, palette);
+    bool threeColor = !forceFourColor && c0 <= c1;
+    if (threeColor) {
+        for (int c = 0; c < 3; c++) {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+    uint32_t indices = in[4] | (in[5] << 8) | (in[6] << 16) | (static_cast<uint32_t>(in[7]) << 24);
+    for (int i = 0; i < 16; i++) {
+        int idx = (indices >> (i * 2)) & 3;
+        for (int c = 0; c < 3; c++) out[i][c] = static_cast<uint8_t>(palette[idx][c]);
+        out[i][3] = (threeColor && idx == 3) ? 0 : 255;
+    }
+}
+
+// ----- BC4 single channel block (8-value mode) -----
+
+void bc4Palette(int a0, int a1, int palette[8]) {
+    palette[0] = a0;
+    palette[1] = a1;
+    if (a0 > a1) {
+        for (int i = 1; i < 7; i++) palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+    } else {
+        for (int i = 1; i < 5; i++) palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+}
+
+void encodeBC4(const uint8_t values[16], uint8_t* out) {
+    int mn = 255, mx = 0;
+    for (int i = 0; i < 16; i++) {
+        mn = std::min(mn, static_cast<int>(values[i]));
+        mx = std::max(mx, static_cast<int>(values[i]));
+    }
+
+    out[0] = static_cast<uint8_t>(mx);
+    out[1] = static_cast<uint8_t>(mn);
+    uint64_t bits = 0;
+    if (mx != mn) {
+        int palette[8];
+        bc4Palette(mx, mn, palette);
+        for (int i = 0; i < 16; i++) {
+            int best = 0, bestErr = 1 << 30;
+            for (int p = 0; p < 8; p++) {
+                int err = std::abs(values[i] - palette[p]);
+                if (err < bestErr) {
+                    bestErr = err;
+                    best = p;
+                }
+            }
+            bits |= static_cast<uint64_t>(best) << (i * 3);
+        }
+    }
+    for (int i = 0; i < 6; i++) out[2 + i] = static_cast<uint8_t>(bits >> (i * 8));
+}
+
+void decodeBC4(const uint8_t* in, uint8_t values[16]) {
+    int palette[8];
+    bc4Palette(in[0], in[1], palette);
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; i++) bits |= static_cast<uint64_t>(in[2 + i]) << (i * 8);
+    for (int i = 0; i < 16; i++) {
+        values[i] = static_cast<uint8_t>(palette[(bits >> (i * 3)) & 7]);
+    }
+}
+
+// ----- BC7 mode 6 (one subset, RGBA 7.7.7.7 + p-bit endpoints, 4-bit indices) -----
+
+const int kBC7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct BitWriter {
+    uint8_t* out;
+    int pos = 0;
+    void write(uint32_t value, int bits) {
+        for (int i = 0; i < bits; i++, pos++) {
+            if ((value >> i) & 1) out[pos >> 3] |= static_cast<uint8_t>(1 << (pos & 7));
+        }
+    }
+};
+
+struct BitReader {
+    const uint8_t* in;
+    int pos = 0;
+    uint32_t read(int bits) {
+        uint32_t value = 0;
+        for (int i = 0; i < bits; i++, pos++) {
+            value |= static_cast<uint32_t>((in[pos >> 3] >> (pos & 7)) & 1) << i;
+        }
+        return value;
+    }
+};
+
+// Quantize an endpoint to 7 bits per channel plus a shared p-bit
+void quantizeBC7Endpoint(const float e[4], int q[4], int& pbit) {
+    int bestErr = 1 << 30;
+    for (int p = 0; p < 2; p++) {
+        int err = 0, cand[4];
+        for (int c = 0; c < 4; c++) {
+            int v = static_cast<int>(std::lround((e[c] - p) / 2.0f));
+            cand[c] = std::clamp(v, 0, 127);
+            int d = ((cand[c] << 1) | p) - static_cast<int>(std::lround(e[c]));
+            err += d * d;
+        }
+        if (err < bestErr) {
+            bestErr = err;
+            pbit = p;
+            std::memcpy(q, cand, sizeof(cand));
+        }
+    }
+}
+
+int bc7Indices(const ColorBlock& block, const int ep0[4], const int ep1[4], uint8_t indices[16]) {
+    int palette[16][4];
+    for (int w = 0; w < 16; w++) {
+        for (int c = 0; c < 4; c++) {
+            palette[w][c] = ((64 - kBC7Weights4[w]) * ep0[c] + kBC7Weights4[w] * ep1[c] + 32) >> 6;
+        }
+    }
+    // Project onto the endpoint line for a first guess, then only compare the
+    // neighbouring palette entries instead of all 16
+    static const auto nearestWeight = [] {
+        std::array<uint8_t, 65> table{};
+        for (int t = 0; t <= 64; t++) {
+            int best = 0;
+            for (int w = 1; w < 16; w++) {
+                if (std::abs(kBC7Weights4[w] - t) < std::abs(kBC7Weights4[best] - t)) best = w;
+            }
+            table[t] = static_cast<uint8_t>(best);
+        }
+        return table;
+    }();
+
+    int dir[4], dirLen2 = 0;
+    for (int c = 0; c < 4; c++) {
+        dir[c] = ep1[c] - ep0[c];
+        dirLen2 += dir[c] * dir[c];
+    }
+
+    int total = 0;
+    for (int i = 0; i < 16; i++) {
+        int guess = 0;
+        if (dirLen2 > 0) {
+            int dot = 0;
+            for (int c = 0; c < 4; c++) dot += (block.px[i][c] - ep0[c]) * dir[c];
+            int t = std::clamp((dot * 64 + dirLen2 / 2) / dirLen2, 0, 64);
+            guess = nearestWeight[t];
+        }
+        int best = guess, bestErr = 1 << 30;
+        for (int w = std::max(0, guess - 1); w <= std::min(15, guess + 1); w++) {
+            int err = 0;
+            for (int c = 0; c < 4; c++) {
+                int d = block.px[i][c] - palette[w][c];
+                err += d * d;
+            }
+            if (err < bestErr) {
+                bestErr = err;
+                best = w;
+            }
+        }
+        indices[i] = static_cast<uint8_t>(best);
+        total += bestErr;
+    }
+    return total;
+}
+
+void encodeBC7Mode6(const ColorBlock& block, uint8_t* out, int refineIterations) {
+    float points[16][4];
+    for (int i = 0; i < 16; i++) {
+        for (int c = 0; c < 4; c++) points[i][c] = block.px[i][c];
+    }
+
+    float e0[4], e1[4];
+    axisEndpoints(points, 16, 4, e0, e1);
+
+    int bestQ0[4] = {}, bestQ1[4] = {}, bestP0 = 0, bestP1 = 0;
+    uint8_t bestIdx[16] = {};
+    int bestErr = 1 << 30;
+
+    for (int iter = 0; iter <= refineIterations; iter++) {
+        int q0[4], q1[4], p0 = 0, p1 = 0;
+        quantizeBC7Endpoint(e0, q0, p0);
+        quantizeBC7Endpoint(e1, q1, p1);
+        int ep0[4], ep1[4];
+        for (int c = 0; c < 4; c++) {
+            ep0[c] = (q0[c] << 1) | p0;
+            ep1[c] = (q1[c] << 1) | p1;
+        }
+        uint8_t idx[16];
+        int err = bc7Indices(block, ep0, ep1, idx);
+        if (err < bestErr) {
+            bestErr = err;
+            std::memcpy(bestQ0, q0, sizeof(q0));
+            std::memcpy(bestQ1, q1, sizeof(q1));
+            bestP0 = p0;
+            bestP1 = p1;
+            std::memcpy(bestIdx, idx, sizeof(idx));
+        }
+        if (err == 0 || iter == refineIterations) break;
+
+        float weights[16];
+        for (int i = 0; i < 16; i++) weights[i] = kBC7Weights4[idx[i]] / 64.0f;
+        if (!refineEndpoints(points, weights, 16, 4, e0, e1)) break;
+    }
+
+    // The anchor (pixel 0) index has an implicit zero MSB
+    if (bestIdx[0] >= 8) {
+        std::swap(bestQ0, bestQ1);
+        std::swap(bestP0, bestP1);
+        for (auto& i : bestIdx) i = static_cast<uint8_t>(15 - i);
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer{out};
+    writer.write(1u << 6, 7);  // mode 6
+    for (int c = 0; c < 4; c++) {
+        writer.write(bestQ0[c], 7);
+        writer.write(bestQ1[c], 7);
+    }
+    writer.write(bestP0, 1);
+    writer.write(bestP1, 1);
+    writer.write(bestIdx[0], 3);
+    for (int i = 1; i < 16; i++) writer.write(bestIdx[i], 4);
+}
+
+void decodeBC7(const uint8_t* in, uint8_t out[16][4]) {
+    if ((in[0] & 0x7F) != 0x40) {
+        // Not mode 6; only the encoder's own output is expected here
+        for (int i = 0; i < 16; i++) {
+            out[i][0] = 255; out[i][1] = 0; out[i][2] = 255; out[i][3] = 255;
+        }
+        return;
+    }
+    BitReader reader{in};
+    reader.read(7);
+    int q0[4], q1[4];
+    for (int c = 0; c < 4; c++) {
+        q0[c] = static_cast<int>(reader.read(7));
+        q1[c] = static_cast<int>(reader.read(7));
+    }
+    int p0 = static_cast<int>(reader.read(1));
+    int p1 = static_cast<int>(reader.read(1));
+    int ep0[4], ep1[4];
+    for (int c = 0; c < 4; c++) {
+        ep0[c] = (q0[c] << 1) | p0;
+        ep1[c] = (q1[c] << 1) | p1;
+    }
+    for (int i = 0; i < 16; i++) {
+        int w = kBC7Weights4[reader.read(i == 0 ? 3 : 4)];
+        for (int c = 0; c < 4; c++) {
+            out[i][c] = static_cast<uint8_t>(((64 - w) * ep0[c] + w * ep1[c] + 32) >> 6);
+        }
+    }
+}
+
+void encodeBlock(const ColorBlock& block, TextureFormat format, TextureQuality quality, uint8_t* out) {
+    int refine = quality == TextureQuality::High ? 2 : 1;
+    switch (format) {
+        case TextureFormat::BC1:
+            encodeBC1Color(block, out, refine);
+            break;
+        case TextureFormat::BC3: {
+            uint8_t alpha[16];
+            for (int i = 0; i < 16; i++) alpha[i] = block.px[i][3];
+            encodeBC4(alpha, out);
+            encodeBC1Color(block, out + 8, refine);
+            break;
+        }
+        case TextureFormat::BC5: {
+            uint8_t r[16], g[16];
+            for (int i = 0; i < 16; i++) {
+                r[i] = block.px[i][0];
+                g[i] = block.px[i][1];
+            }
+            encodeBC4(r, out);
+            encodeBC4(g, out + 8);
+            break;
+        }
+        case TextureFormat::BC7:
+            encodeBC7Mode6(block, out, refine);
+            break;
+        case TextureFormat::RGBA8:
+            break;
+    }
+}
+
+void decodeBlock(const uint8_t* in, TextureFormat format, uint8_t out[16][4]) {
+    switch (format) {
+        case TextureFormat::BC1:
+            decodeBC1Color(in, out, false);
+            break;
+        case TextureFormat::BC3: {
+            uint8_t alpha[16];
+            decodeBC4(in, alpha);
+            decodeBC1Color(in + 8, out, true);
+            for (int i = 0; i < 16; i++) out[i][3] = alpha[i];
+            break;
+        }
+        case TextureFormat::BC5: {
+            uint8_t r[16], g[16];
+            decodeBC4(in, r);
+            decodeBC4(in + 8, g);
+            for (int i = 0; i < 16; i++) {
+                out[i][0] = r[i];
+                out[i][1] = g[i];
+                out[i][2] = 0;
+                out[i][3] = 255;
+            }
+            break;
+        }
+        case TextureFormat::BC7:
+            decodeBC7(in, out);
+            break;
+        case TextureFormat::RGBA8:
+            break;
+    }
+}
+
+}  // namespace
+
+std::vector<uint8_t> compressTextureLevel(const uint8_t* rgba, int width, int height, TextureFormat format,
+                                          TextureQuality quality) {
+    if (!isBlockCompressed(format)) {
+        return std::vector<uint8_t>(rgba, rgba + static_cast<size_t>(width) * height * 4);
+    }
+
+    int blocksX = (width + 3) / 4;
+    int blocksY = (height + 3) / 4;
+    size_t blockBytes = textureBlockBytes(format);
+    std::vector<uint8_t> out(static_cast<size_t>(blocksX) * blocksY * blockBytes);
+
+    ColorBlock block;
+    for (int by = 0; by < blocksY; by++) {
+        for (int bx = 0; bx < blocksX; bx++) {
+            fetchBlock(rgba, width, height, bx, by, block);
+            encodeBlock(block, format, quality, &out[(static_cast<size_t>(by) * blocksX + bx) * blockBytes]);
+        }
+    }
+    return out;
+}
+
+std::vector<uint8_t> decompressTextureLevel(const uint8_t* blocks, int width, int height, TextureFormat format) {
+    if (!isBlockCompressed(format)) {
+        return std::vector<uint8_t>(blocks, blocks + static_cast<size_t>(width) * height * 4);
+    }
+
+    int blocksX = (width + 3) / 4;
+    int blocksY = (height + 3) / 4;
+    size_t blockBytes = textureBlockBytes(format);
+    std::vector<uint8_t> out(static_cast<size_t>(width) * height * 4);
+
+    uint8_t decoded[16][4];
+    for (int by = 0; by < blocksY; by++) {
+        for (int bx = 0; bx < blocksX; bx++) {
+            decodeBlock(&blocks[(static_cast<size_t>(by) * blocksX + bx) * blockBytes], format, decoded);
+            for (int y = 0; y < 4; y++) {
+                int py = by * 4 + y;
+                if (py >= height) break;
+                for (int x = 0; x < 4; x++) {
+                    int px = bx * 4 + x;
+                    if (px >= width) break;
+                    std::memcpy(&out[(static_cast<size_t>(py) * width + px) * 4], decoded[y * 4 + x], 4);
+                }
+            }
+        }
+    }
+    return out;
+}
+
+std::vector<uint8_t> textureLevelRGBA8(const TextureData& texture, int level) {
+    if (texture.isCooked()) {
+        if (level < 0 || level >= static_cast<int>(texture.mips.size())) return {};
+        const TextureMip& mip = texture.mips[level];
+        if (mip.data.size() < textureLevelSize(texture.format, mip.width, mip.height)) return {};
+        if (!isBlockCompressed(texture.format)) return mip.data;
+        return decompressTextureLevel(mip.data.data(), mip.width, mip.height, texture.format);
+    }
+
+    size_t pixelCount = static_cast<size_t>(texture.width) * texture.height;
+    int channels = texture.channels;
+    if (level != 0 || channels < 1 || channels > 4 || texture.pixels.size() < pixelCount * channels) return {};
+    if (channels == 4) return texture.pixels;
+
+    // Gray, gray + alpha and RGB expand to RGBA
+    std::vector<uint8_t> out(pixelCount * 4);
+    for (size_t i = 0; i < pixelCount; i++) {
+        const uint8_t* src = &texture.pixels[i * channels];
+        uint8_t* dst = &out[i * 4];
+        if (channels < 3) {
+            dst[0] = dst[1] = dst[2] = src[0];
+            dst[3] = channels == 2 ? src[1] : 255;
+        } else {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+            dst[3] = 255;
+        }
+    }
+    return out;
+}
+
+double computePSNR(const uint8_t* a, const uint8_t* b, size_t pixelCount, int channels) {
+    if (pixelCount == 0 || channels <= 0) return 100.0;
+    double sum = 0.0;
+    for (size_t i = 0; i < pixelCount; i++) {
+        for (int c = 0; c < channels; c++) {
+            double d = static_cast<double>(a[i * 4 + c]) - b[i * 4 + c];
+            sum += d * d;
+        }
+    }
+    double mse = sum / (static_cast<double>(pixelCount) * channels);
+    if (mse <= 0.0) return 100.0;
+    return std::min(100.0, 10.0 * std::log10(255.0 * 255.0 / mse));
+}
+
+// ===== Cooking =====
+
+TextureData cookTexture(const TextureData& source, TextureRole role, const TextureCookSettings& settings) {
+    TextureData cooked;
+    cooked.width = source.width;
+    cooked.height = source.height;
+    cooked.channels = 4;
+    cooked.path = source.path;
+
+    if (source.pixels.empty() || source.channels != 4 ||
+        source.pixels.size() < static_cast<size_t>(source.width) * source.height * 4) {
+        return source;
+    }
+
+    if (settings.generateMips) {
+        cooked.mips = generateMipChain(source.pixels.data(), source.width, source.height, role);
+    } else {
+        TextureMip base;
+        base.width = source.width;
+        base.height = source.height;
+        base.data = source.pixels;
+        cooked.mips.push_back(std::move(base));
+    }
+
+    cooked.format = TextureFormat::RGBA8;
+    if (settings.compress) {
+        bool hasAlpha = false;
+        for (size_t i = 3; i < source.pixels.size(); i += 4) {
+            if (source.pixels[i] != 255) {
+                hasAlpha = true;
+                break;
+            }
+        }
+        cooked.format = selectTextureFormat(role, hasAlpha, settings.quality);
+        for (auto& mip : cooked.mips) {
+            mip.data = compressTextureLevel(mip.data.data(), mip.width, mip.height, cooked.format, settings.quality);
+        }
+    }
+    return cooked;
+}
+
+// ===== Cooked Texture Cache =====
+
+namespace {
+
+struct CookedFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t format;
+    uint32_t width;
+    uint32_t height;
+    uint32_t mipCount;
+};
+
+}  // namespace
+
+CookedTextureCache::CookedTextureCache(const std::string& directory) : directory_(directory) {}
+
+void CookedTextureCache::setDirectory(const std::string& directory) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    directory_ = directory;
+}
+
+std::string CookedTextureCache::getDirectory() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return directory_;
+}
+
+std::string CookedTextureCache::defaultDirectory() {
+    std::error_code ec;
+    auto temp = std::filesystem::temp_directory_path(ec);
+    return ((ec ? std::filesystem::path(".") : temp) / "luma_cooked_textures").string();
+}
+
+uint64_t CookedTextureCache::makeKey(uint64_t sourceHash, TextureRole role, const TextureCookSettings& settings) {
+    uint8_t desc[12] = {
+        static_cast<uint8_t>(role),
+        static_cast<uint8_t>(settings.quality),
+        static_cast<uint8_t>(settings.generateMips),
+        static_cast<uint8_t>(settings.compress),
+    };
+    uint32_t version = kVersion;
+    std::memcpy(desc + 4, &version, sizeof(version));
+    return TextureCache::hashBytes(desc, sizeof(desc), sourceHash);
+}
+
+std::string CookedTextureCache::pathForKey(uint64_t key) const {
+    static const char digits[] = "0123456789abcdef";
+    std::string name(16, '0');
+    for (int i = 0; i < 16; i++) name[15 - i] = digits[(key >> (i * 4)) & 0xF];
+    return (std::filesystem::path(getDirectory()) / (name + ".ltex")).string();
+}
+
+bool CookedTextureCache::load(uint64_t key, TextureData& out) const {
+    if (!enabled_) return false;
+
+    std::ifstream file(pathForKey(key), std::ios::binary);
+    if (!file) return false;
+
+    CookedFileHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, "LTEX", 4) != 0 || header.version != kVersion ||
+        header.format > static_cast<uint32_t>(TextureFormat::BC7) || header.mipCount == 0 ||
+        header.mipCount > 32) {
+        return false;
+    }
+
+    TextureData cooked;
+    cooked.width = static_cast<int>(header.width);
+    cooked.height = static_cast<int>(header.height);
+    cooked.channels = 4;
+    cooked.format = static_cast<TextureFormat>(header.format);
+    cooked.mips.resize(header.mipCount);
+    for (auto& mip : cooked.mips) {
+        uint32_t dims[3];
+        if (!file.read(reinterpret_cast<char*>(dims), sizeof(dims))) return false;
+        mip.width = static_cast<int>(dims[0]);
+        mip.height = static_cast<int>(dims[1]);
+        if (dims[2] != textureLevelSize(cooked.format, mip.width, mip.height)) return false;
+        mip.data.resize(dims[2]);
+        if (!file.read(reinterpret_cast<char*>(mip.data.data()), dims[2])) return false;
+    }
+    cooked.path = out.path;
+    out = std::move(cooked);
+    return true;
+}
+
+bool CookedTextureCache::store(uint64_t key, const TextureData& cooked) const {
+    if (!enabled_ || !cooked.isCooked()) return false;
+
+    std::error_code ec;
+    std::filesystem::create_directories(getDirectory(), ec);
+
+    // Write to a private temp file and rename, so concurrent readers never
+    // see a partial file
+    static std::atomic<uint32_t> tempCounter{0};
+    std::string finalPath = pathForKey(key);
+    std::string tempPath = finalPath + ".tmp" + std::to_string(tempCounter.fetch_add(1));
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+
+        CookedFileHeader header{{'L', 'T', 'E', 'X'}, kVersion, static_cast<uint32_t>(cooked.format),
+                                static_cast<uint32_t>(cooked.width), static_cast<uint32_t>(cooked.height),
+                                static_cast<uint32_t>(cooked.mips.size())};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const auto& mip : cooked.mips) {
+            uint32_t dims[3] = {static_cast<uint32_t>(mip.width), static_cast<uint32_t>(mip.height),
+                                static_cast<uint32_t>(mip.data.size())};
+            file.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+            file.write(reinterpret_cast<const char*>(mip.data.data()), mip.data.size());
+        }
+        if (!file) {
+            file.close();
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(tempPath, finalPath, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
+
+void CookedTextureCache::clear() const {
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(getDirectory(), ec)) {
+        if (entry.path().extension() == ".ltex") {
+            std::filesystem::remove(entry.path(), ec);
+        }
+    }
+}
+
+}  // namespace luma
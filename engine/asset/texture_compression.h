@@ -0,0 +1,129 @@
+// Texture Compression - Mip chains, BCn block encoding and the cooked texture cache
+// Runs on the async loader's worker threads: decoded RGBA8 images are turned
+// into a gamma-correct mip chain, block compressed in a format chosen from the
+// texture's role, and written to disk so later loads skip both steps.
+#pragma once
+
+#include "engine/renderer/mesh.h"
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+#if defined(__APPLE__)
+#include <TargetConditionals.h>
+#endif
+
+namespace luma {
+
+// iOS GPUs have no BCn support; textures are still mipmapped there
+#if defined(__APPLE__) && TARGET_OS_IPHONE
+inline constexpr bool kPlatformSupportsBCn = false;
+#else
+inline constexpr bool kPlatformSupportsBCn = true;
+#endif
+
+// ===== Texture Role =====
+// What a texture is used for decides how mips are filtered and which block
+// format it ends up in.
+enum class TextureRole : uint8_t {
+    Generic = 0,    // Linear data, RGBA
+    Albedo,         // sRGB color (+ alpha)
+    Normal,         // Tangent-space normal map, only XY are kept when compressed
+    ORM             // Occlusion / roughness / metallic, linear
+};
+
+enum class TextureQuality : uint8_t {
+    Fast = 0,       // BC1/BC3 for color data
+    High            // BC7 for color data
+};
+
+struct TextureCookSettings {
+    bool generateMips = true;
+    bool compress = kPlatformSupportsBCn;
+    TextureQuality quality = TextureQuality::High;
+
+    bool enabled() const { return generateMips || compress; }
+};
+
+const char* textureRoleName(TextureRole role);
+const char* textureFormatName(TextureFormat format);
+
+// ===== Format Helpers =====
+inline bool isBlockCompressed(TextureFormat format) { return format != TextureFormat::RGBA8; }
+
+// Bytes per 4x4 block (0 for RGBA8)
+size_t textureBlockBytes(TextureFormat format);
+
+// Storage size of one level
+size_t textureLevelSize(TextureFormat format, int width, int height);
+
+// Number of levels down to 1x1
+int textureMipCount(int width, int height);
+
+// Format picked for a role; BC5 for normals, BC7 (High) or BC1/BC3 (Fast) otherwise
+TextureFormat selectTextureFormat(TextureRole role, bool hasAlpha, TextureQuality quality);
+
+// ===== Mip Generation =====
+// RGBA8 levels, level 0 first. Albedo is filtered in linear space and
+// re-encoded to sRGB; normals are averaged as vectors and renormalized.
+std::vector<TextureMip> generateMipChain(const uint8_t* rgba, int width, int height, TextureRole role);
+
+// ===== Block Compression =====
+// Encode an RGBA8 level; partial edge blocks replicate the last row/column.
+// BC7 output uses mode 6 (single subset, RGBA, 4-bit indices) for every block.
+std::vector<uint8_t> compressTextureLevel(const uint8_t* rgba, int width, int height, TextureFormat format,
+                                          TextureQuality quality = TextureQuality::High);
+
+// Decode a level back to RGBA8. Handles the subset of BC7 written by the encoder.
+std::vector<uint8_t> decompressTextureLevel(const uint8_t* blocks, int width, int height, TextureFormat format);
+
+// RGBA8 copy of one level of a cooked or uncooked texture, for consumers
+// without BCn support. Empty if the texture has no such level.
+std::vector<uint8_t> textureLevelRGBA8(const TextureData& texture, int level = 0);
+
+// Peak signal-to-noise ratio over the first `channels` components of two
+// RGBA8 images, in dB (capped at 100 for identical images)
+double computePSNR(const uint8_t* a, const uint8_t* b, size_t pixelCount, int channels = 3);
+
+// ===== Cooking =====
+// Full worker-side stage: mips + compression. The result keeps `mips` and
+// drops the RGBA8 `pixels`.
+TextureData cookTexture(const TextureData& source, TextureRole role, const TextureCookSettings& settings);
+
+// ===== Cooked Texture Cache =====
+// Cooked textures on disk, keyed by a hash of the source bytes and the cook
+// settings. Safe to use from several workers.
+class CookedTextureCache {
+public:
+    static constexpr uint32_t kVersion = 1;
+
+    explicit CookedTextureCache(const std::string& directory = defaultDirectory());
+
+    void setDirectory(const std::string& directory);
+    std::string getDirectory() const;
+
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+    bool isEnabled() const { return enabled_; }
+
+    // Key for a source payload under the given role and settings
+    static uint64_t makeKey(uint64_t sourceHash, TextureRole role, const TextureCookSettings& settings);
+
+    bool load(uint64_t key, TextureData& out) const;
+    bool store(uint64_t key, const TextureData& cooked) const;
+
+    // Remove every cooked file
+    void clear() const;
+
+    static std::string defaultDirectory();
+
+private:
+    std::string pathForKey(uint64_t key) const;
+
+    mutable std::mutex mutex_;
+    std::string directory_;
+    std::atomic<bool> enabled_{true};
+};
+
+}  // namespace luma
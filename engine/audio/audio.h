@@ -3,6 +3,9 @@
 #pragma once
 
 #include "engine/foundation/math_types.h"
+#include "engine/audio/audio_dsp.h"
+#include "engine/audio/audio_stream.h"
+#include "engine/foundation/spsc_queue.h"
 #include <vector>
 #include <memory>
 #include <string>
@@ -12,6 +15,10 @@
 #include <algorithm>
 #include <mutex>
 #include <atomic>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <chrono>
 
 namespace luma {
 
@@ -32,7 +39,12 @@ enum class AudioFormat {
 };
 
 // ===== Audio Clip =====
-// Loaded audio data (WAV, etc.)
+// Loaded audio data (WAV, etc.). Samples are converted once at load to planar
+// float: channel c occupies [c * frameCount, (c + 1) * frameCount), so the
+// mixer reads contiguous runs without per-sample decoding.
+//
+// A streaming clip (openStream()) holds no samples; each voice playing it
+// decodes the file in chunks into its own small AudioStream ring.
 class AudioClip {
 public:
     AudioClip() = default;
@@ -41,7 +53,7 @@ public:
     const std::string& getName() const { return name_; }
     void setName(const std::string& name) { name_ = name; }
     
-    // Audio properties
+    // Audio properties (bit depth and format describe the source data)
     int getSampleRate() const { return sampleRate_; }
     int getChannels() const { return channels_; }
     int getBitsPerSample() const { return bitsPerSample_; }
@@ -49,22 +61,99 @@ public:
     
     // Duration in seconds
     float getDuration() const {
-        if (sampleRate_ == 0 || channels_ == 0) return 0.0f;
-        size_t bytesPerSample = bitsPerSample_ / 8;
-        size_t totalSamples = data_.size() / (bytesPerSample * channels_);
-        return (float)totalSamples / sampleRate_;
+        if (sampleRate_ == 0) return 0.0f;
+        return (float)frameCount_ / sampleRate_;
     }
     
-    // Data access
-    const std::vector<uint8_t>& getData() const { return data_; }
-    std::vector<uint8_t>& getData() { return data_; }
-    size_t getDataSize() const { return data_.size(); }
+    // Data access (resident clips only)
+    size_t getFrameCount() const { return frameCount_; }
+    const float* getChannelData(int channel) const { return samples_.data() + channel * frameCount_; }
+    const std::vector<float>& getSamples() const { return samples_; }
+    size_t getDataSize() const { return samples_.size() * sizeof(float); }
     
-    // Load from WAV file (simplified - header only)
+    // ===== Streaming =====
+    bool isStreaming() const { return file_ != nullptr; }
+    
+    // Decoded audio held in memory: the samples of a resident clip, or the
+    // rings of the voices currently playing a streaming one
+    size_t getResidentBytes() const { return file_ ? file_->getBufferBytes() : getDataSize(); }
+    
+    // Stream reads that found no decoded frames yet (streaming clips)
+    uint64_t getStreamUnderruns() const { return file_ ? file_->getUnderruns() : 0; }
+    
+    // A new ring for one playback starting at `startFrame`
+    std::shared_ptr<AudioStream> createStream(size_t startFrame, bool loop) const {
+        return file_ ? std::make_shared<AudioStream>(file_, startFrame, loop) : nullptr;
+    }
+    
+    // Decode a whole WAV file into memory
+    bool loadFromFile(const std::string& path) {
+        auto file = WavFile::open(path);
+        if (!file) return false;
+        const WavInfo& info = file->getInfo();
+        setFormat(info.sampleRate, info.channels, info.bitsPerSample);
+        frameCount_ = info.frameCount();
+        samples_.resize(frameCount_ * channels_);
+        std::vector<float*> planes(channels_);
+        for (int c = 0; c < channels_; c++) planes[c] = samples_.data() + c * frameCount_;
+        file->decode(0, frameCount_, planes.data(), channels_);
+        file_.reset();
+        return true;
+    }
+    
+    // Keep a WAV file open and decode it while playing
+    bool openStream(const std::string& path) {
+        auto file = WavFile::open(path);
+        if (!file) return false;
+        const WavInfo& info = file->getInfo();
+        setFormat(info.sampleRate, info.channels, info.bitsPerSample);
+        frameCount_ = info.frameCount();
+        samples_.clear();
+        samples_.shrink_to_fit();
+        file_ = std::move(file);
+        return true;
+    }
+    
+    // Load interleaved PCM: 8-bit unsigned, 16/24-bit signed or 32-bit float
     bool loadFromMemory(const uint8_t* data, size_t size,
                         int sampleRate, int channels, int bitsPerSample)
     {
-        data_.assign(data, data + size);
+        if (channels <= 0 || sampleRate <= 0) return false;
+        if (bitsPerSample != 8 && bitsPerSample != 16 && bitsPerSample != 24 && bitsPerSample != 32) return false;
+        
+        setFormat(sampleRate, channels, bitsPerSample);
+        file_.reset();
+        
+        size_t bytesPerSample = bitsPerSample / 8;
+        frameCount_ = size / (bytesPerSample * channels);
+        samples_.resize(frameCount_ * channels);
+        
+        // Deinterleave while converting
+        std::vector<float*> planes(channels);
+        for (int c = 0; c < channels; c++) planes[c] = samples_.data() + c * frameCount_;
+        decodePcm(data, bitsPerSample, channels, frameCount_, planes.data(), channels);
+        
+        return true;
+    }
+    
+    // Generate simple waveforms for testing
+    void generateSineWave(float frequency, float duration, int sampleRate = 44100) {
+        setMonoFloat(sampleRate, (size_t)(sampleRate * duration));
+        for (size_t i = 0; i < frameCount_; i++) {
+            float t = (float)i / sampleRate;
+            samples_[i] = sinf(2.0f * 3.14159f * frequency * t);
+        }
+    }
+    
+    void generateWhiteNoise(float duration, int sampleRate = 44100) {
+        setMonoFloat(sampleRate, (size_t)(sampleRate * duration));
+        for (size_t i = 0; i < frameCount_; i++) {
+            samples_[i] = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+        }
+    }
+    
+private:
+    void setFormat(int sampleRate, int channels, int bitsPerSample) {
         sampleRate_ = sampleRate;
         channels_ = channels;
         bitsPerSample_ = bitsPerSample;
@@ -79,49 +168,19 @@ public:
             else if (bitsPerSample == 16) format_ = AudioFormat::Stereo16;
             else format_ = AudioFormat::StereoFloat;
         }
-        
-        return true;
     }
     
-    // Generate simple waveforms for testing
-    void generateSineWave(float frequency, float duration, int sampleRate = 44100) {
-        sampleRate_ = sampleRate;
-        channels_ = 1;
-        bitsPerSample_ = 16;
-        format_ = AudioFormat::Mono16;
-        
-        int totalSamples = (int)(sampleRate * duration);
-        data_.resize(totalSamples * 2);  // 16-bit = 2 bytes
-        
-        for (int i = 0; i < totalSamples; i++) {
-            float t = (float)i / sampleRate;
-            float sample = sinf(2.0f * 3.14159f * frequency * t);
-            int16_t s16 = (int16_t)(sample * 32767);
-            data_[i * 2] = s16 & 0xFF;
-            data_[i * 2 + 1] = (s16 >> 8) & 0xFF;
-        }
+    void setMonoFloat(int sampleRate, size_t frames) {
+        setFormat(sampleRate, 1, 32);
+        file_.reset();
+        frameCount_ = frames;
+        samples_.assign(frames, 0.0f);
     }
     
-    void generateWhiteNoise(float duration, int sampleRate = 44100) {
-        sampleRate_ = sampleRate;
-        channels_ = 1;
-        bitsPerSample_ = 16;
-        format_ = AudioFormat::Mono16;
-        
-        int totalSamples = (int)(sampleRate * duration);
-        data_.resize(totalSamples * 2);
-        
-        for (int i = 0; i < totalSamples; i++) {
-            float sample = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
-            int16_t s16 = (int16_t)(sample * 32767);
-            data_[i * 2] = s16 & 0xFF;
-            data_[i * 2 + 1] = (s16 >> 8) & 0xFF;
-        }
-    }
-    
-private:
     std::string name_;
-    std::vector<uint8_t> data_;
+    std::vector<float> samples_;
+    std::shared_ptr<WavFile> file_;  // Streaming clips
+    size_t frameCount_ = 0;
     int sampleRate_ = 44100;
     int channels_ = 1;
     int bitsPerSample_ = 16;
@@ -193,29 +252,37 @@ public:
     void setVelocity(const Vec3& vel) { velocity_ = vel; }
     Vec3 getVelocity() const { return velocity_; }
     
-    // Playback control
+    // Playback control. Takes effect on the audio thread at the next
+    // AudioSystem::update(); the state reported here is the requested one.
     void play() {
         if (clip_) {
             state_ = AudioState::Playing;
-            playbackPosition_ = 0;
+            cursor_ = 0;
+            generation_ = nextGeneration_++;
+            pending_ = kPendingPlay;
         }
     }
     
     void pause() {
         if (state_ == AudioState::Playing) {
             state_ = AudioState::Paused;
+            pending_ = (pending_ & ~kPendingResume) | kPendingPause;
         }
     }
     
     void unpause() {
         if (state_ == AudioState::Paused) {
             state_ = AudioState::Playing;
+            pending_ = (pending_ & ~kPendingPause) | kPendingResume;
         }
     }
     
     void stop() {
+        if (state_ != AudioState::Stopped || pending_ != 0) {
+            pending_ = kPendingStop;
+        }
         state_ = AudioState::Stopped;
-        playbackPosition_ = 0;
+        cursor_ = 0;
     }
     
     AudioState getState() const { return state_; }
@@ -224,12 +291,13 @@ public:
     // Playback position
     float getTime() const {
         if (!clip_ || clip_->getSampleRate() == 0) return 0.0f;
-        return (float)playbackPosition_ / clip_->getSampleRate();
+        return (float)((double)cursor_ / dsp::SincResampler::kOne / clip_->getSampleRate());
     }
     
     void setTime(float time) {
         if (clip_) {
-            playbackPosition_ = (size_t)(time * clip_->getSampleRate());
+            cursor_ = dsp::SincResampler::toFixed((double)time * clip_->getSampleRate());
+            if (state_ != AudioState::Stopped) pending_ |= kPendingSeek;
         }
     }
     
@@ -244,17 +312,35 @@ public:
     bool isLooping() const { return settings_.loop; }
     
     // Internal
-    size_t getPlaybackPosition() const { return playbackPosition_; }
-    void advancePlayback(size_t samples) { playbackPosition_ += samples; }
+    // Position in clip frames as of the last update(); the cursor is the same
+    // in 32.32 fixed point
+    size_t getPlaybackPosition() const { return (size_t)(cursor_ >> dsp::SincResampler::kFracBits); }
+    uint64_t getPlaybackCursor() const { return cursor_; }
+    
+    // Tracked but not mixed this frame (inaudible or over the real-voice cap)
+    bool isVirtual() const { return virtual_; }
     
     // For mixing - computed effective volume after distance attenuation
     float computedVolume = 0.0f;
     float computedPanL = 1.0f;
     float computedPanR = 1.0f;
+    float computedPitch = 1.0f;   // Pitch including Doppler shift
     
 private:
+    friend class AudioSystem;
+    
+    // Commands not yet sent to the audio thread
+    enum : uint8_t {
+        kPendingPlay = 1 << 0,
+        kPendingStop = 1 << 1,
+        kPendingPause = 1 << 2,
+        kPendingResume = 1 << 3,
+        kPendingSeek = 1 << 4,
+    };
+    
     uint32_t id_;
     static inline uint32_t nextId_ = 0;
+    static inline uint32_t nextGeneration_ = 1;  // 0 marks an idle voice
     
     std::shared_ptr<AudioClip> clip_;
     AudioSourceSettings settings_;
@@ -263,7 +349,13 @@ private:
     Vec3 velocity_ = {0, 0, 0};
     
     AudioState state_ = AudioState::Stopped;
-    size_t playbackPosition_ = 0;
+    uint64_t cursor_ = 0;
+    
+    int slot_ = -1;             // Voice slot on the audio thread
+    uint32_t generation_ = 0;   // Identifies this play() to the audio thread
+    uint8_t pending_ = 0;
+    bool virtual_ = false;
+    bool oneShot_ = false;      // Destroyed once it finishes
 };
 
 // ===== Audio Listener =====
@@ -382,76 +474,167 @@ private:
     std::vector<AudioMixerGroup> groups_;
 };
 
+// ===== Audio Mix Statistics =====
+struct AudioMixStats {
+    uint64_t buffersMixed = 0;
+    double lastMixUs = 0.0;         // Time spent in the last mixAudio() call
+    double avgMixUs = 0.0;          // Exponential moving average
+    double maxMixUs = 0.0;
+    double deadlineUs = 0.0;        // Playback length of the last buffer
+    uint64_t overruns = 0;          // Buffers that took longer to mix than to play
+    uint64_t underruns = 0;         // Device reads the mix thread could not fill
+    uint64_t commandsDeferred = 0;  // Retried next update because the queue was full
+    uint32_t realVoices = 0;
+    uint32_t virtualVoices = 0;
+
+    // Share of the real-time budget spent mixing
+    double load() const { return deadlineUs > 0.0 ? avgMixUs / deadlineUs : 0.0; }
+};
+
 // ===== Audio System =====
+// Sources live on the game thread: update() spatializes them, decides which
+// voices are real, and hands play/stop/seek commands to the audio thread
+// through a lock-free queue. Per-voice parameters are published once per
+// update through a triple buffer, so mixAudio() never waits on the game
+// thread and never allocates. mixAudio() may run on the device callback or on
+// the mix thread (startMixThread()), but only on one of them.
 class AudioSystem {
 public:
     static AudioSystem& get() {
         static AudioSystem instance;
         return instance;
     }
-    
-    void initialize(int sampleRate = 44100, int channels = 2, int bufferSize = 4096) {
+
+    static constexpr int kDefaultMaxRealVoices = 64;
+
+    // `maxSources` bounds the number of sources playing or paused at once
+    void initialize(int sampleRate = 44100, int channels = 2, int bufferSize = 4096,
+                    size_t maxSources = 512) {
         sampleRate_ = sampleRate;
         channels_ = channels;
         bufferSize_ = bufferSize;
-        mixBuffer_.resize(bufferSize * channels, 0.0f);
+        mixBuffer_.assign(kMixBlock * channels, 0.0f);
+        for (auto& buffer : voiceBuffers_) buffer.assign(kMixBlock, 0.0f);
+        // Widest window the resampler can ask for (rate is clamped to kMaxStep)
+        using dsp::SincResampler;
+        size_t gatherFrames = SincResampler::inputFramesNeeded(
+            (uint64_t)(SincResampler::kHistory + 1) << SincResampler::kFracBits,
+            (uint64_t)kMaxStep << SincResampler::kFracBits, kMixBlock) + 1;
+        for (auto& buffer : gatherBuffers_) buffer.assign(gatherFrames, 0.0f);
+
+        voices_ = std::vector<Voice>(maxSources);
+        voiceStatus_ = std::make_unique<VoiceStatus[]>(maxSources);
+        for (auto& params : params_) params.assign(maxSources, VoiceParams{});
+        paramsBack_ = 0;
+        paramsFront_ = 1;
+        paramsLatest_.store(2, std::memory_order_relaxed);
+        slotOwners_.assign(maxSources, nullptr);
+        freeSlots_.clear();
+        for (size_t i = maxSources; i-- > 0;) freeSlots_.push_back((int)i);
+        pendingReleases_.clear();
+        commands_ = std::make_unique<SpscQueue<AudioCommand>>(maxSources * 2 + 64);
+        events_ = std::make_unique<SpscQueue<AudioEvent>>(maxSources * 2 + 64);
+        finishedOverflow_.clear();
+        finishedOverflow_.reserve(maxSources);
+        heldCommand_ = AudioCommand{};
+        commandHeld_ = false;
+
+        masterGain_.store(masterVolume_ * listener_.getVolume(), std::memory_order_relaxed);
+        resetMixStats();
         initialized_ = true;
     }
-    
+
     void shutdown() {
+        stopMixThread();
         sources_.clear();
         clips_.clear();
+        voices_.clear();
+        finishedOverflow_.clear();
+        heldCommand_ = AudioCommand{};
+        commandHeld_ = false;
+        commands_.reset();
+        events_.reset();
+        streamer_.stop();
         initialized_ = false;
     }
-    
+
     bool isInitialized() const { return initialized_; }
     int getSampleRate() const { return sampleRate_; }
     int getChannels() const { return channels_; }
-    
+
     // Clip management
     std::shared_ptr<AudioClip> createClip(const std::string& name) {
         auto clip = std::make_shared<AudioClip>(name);
         clips_[name] = clip;
         return clip;
     }
-    
+
     std::shared_ptr<AudioClip> getClip(const std::string& name) {
         auto it = clips_.find(name);
         return it != clips_.end() ? it->second : nullptr;
     }
     
+    // Load a WAV file; streamed clips are decoded while they play
+    std::shared_ptr<AudioClip> loadClip(const std::string& name, const std::string& path, bool stream = false) {
+        auto clip = std::make_shared<AudioClip>(name);
+        bool loaded = stream ? clip->openStream(path) : clip->loadFromFile(path);
+        if (!loaded) {
+            std::cerr << "[Audio] Failed to load " << path << std::endl;
+            return nullptr;
+        }
+        clips_[name] = clip;
+        return clip;
+    }
+    
+    const std::unordered_map<std::string, std::shared_ptr<AudioClip>>& getClips() const { return clips_; }
+    
+    // Top up the rings of streaming voices now (the streaming thread does
+    // this on its own every few milliseconds)
+    void pumpStreams() { streamer_.pump(); }
+    size_t getActiveStreamCount() const { return streamer_.getStreamCount(); }
+
     // Source management
     AudioSource* createSource() {
         sources_.push_back(std::make_unique<AudioSource>());
         return sources_.back().get();
     }
-    
+
     void destroySource(AudioSource* source) {
+        if (source) releaseSlot(*source);
         sources_.erase(
             std::remove_if(sources_.begin(), sources_.end(),
                 [source](const auto& s) { return s.get() == source; }),
             sources_.end()
         );
+        flushReleases();
     }
-    
+
     const std::vector<std::unique_ptr<AudioSource>>& getSources() const { return sources_; }
-    
+
     // Listener
     AudioListener& getListener() { return listener_; }
     const AudioListener& getListener() const { return listener_; }
-    
+
     // Mixer
     AudioMixer& getMixer() { return mixer_; }
     const AudioMixer& getMixer() const { return mixer_; }
-    
+
     // Master volume
-    void setMasterVolume(float v) { masterVolume_ = std::max(0.0f, std::min(1.0f, v)); }
+    void setMasterVolume(float v) {
+        masterVolume_ = std::max(0.0f, std::min(1.0f, v));
+        masterGain_.store(masterVolume_ * listener_.getVolume(), std::memory_order_relaxed);
+    }
     float getMasterVolume() const { return masterVolume_; }
-    
+
     // Mute
-    void setMuted(bool muted) { muted_ = muted; }
-    bool isMuted() const { return muted_; }
-    
+    void setMuted(bool muted) { muted_.store(muted, std::memory_order_relaxed); }
+    bool isMuted() const { return muted_.load(std::memory_order_relaxed); }
+
+    // Voices mixed at once; the rest play on silently (virtual) and become
+    // audible again when a slot frees up
+    void setMaxRealVoices(int count) { maxRealVoices_ = std::max(0, count); }
+    int getMaxRealVoices() const { return maxRealVoices_; }
+
     // Pause all
     void pauseAll() {
         for (auto& source : sources_) {
@@ -460,7 +643,7 @@ public:
             }
         }
     }
-    
+
     void unpauseAll() {
         for (auto& source : sources_) {
             if (source->getState() == AudioState::Paused) {
@@ -468,48 +651,152 @@ public:
             }
         }
     }
-    
+
     void stopAll() {
         for (auto& source : sources_) {
             source->stop();
         }
     }
-    
-    // Update (call each frame to update 3D audio calculations)
+
+    // Update (call each frame from the game thread): picks up voices the
+    // audio thread finished, spatializes, virtualizes and sends commands
     void update(float dt) {
         if (!initialized_) return;
-        
+        (void)dt;
+
+        processEvents();
+        flushReleases();
+
+        // Playback positions as of the last mixed buffer
+        for (auto& source : sources_) {
+            if (source->slot_ < 0 || source->state_ == AudioState::Stopped ||
+                (source->pending_ & (AudioSource::kPendingPlay | AudioSource::kPendingSeek))) continue;
+            const VoiceStatus& status = voiceStatus_[source->slot_];
+            if (status.generation.load(std::memory_order_acquire) == source->generation_) {
+                source->cursor_ = status.cursor.load(std::memory_order_relaxed);
+            }
+        }
+
         // Update 3D calculations for each source
         for (auto& source : sources_) {
             if (!source->isPlaying()) continue;
-            
+
             updateSource3D(*source);
         }
+
+        updateVirtualization();
+
+        masterGain_.store(masterVolume_ * listener_.getVolume(), std::memory_order_relaxed);
+        flushCommands();
+        publishParams();
     }
-    
-    // Mix audio (call from audio callback)
+
+    // Mix audio (call from audio callback, or let the mix thread call it)
+    // Interleaved output; mixed internally in planar blocks of kMixBlock frames
     void mixAudio(float* outputBuffer, size_t frameCount) {
-        if (!initialized_ || muted_) {
+        auto start = std::chrono::steady_clock::now();
+        if (!initialized_) {
             std::fill(outputBuffer, outputBuffer + frameCount * channels_, 0.0f);
             return;
         }
-        
-        std::fill(mixBuffer_.begin(), mixBuffer_.end(), 0.0f);
-        
-        // Mix all playing sources
-        for (auto& source : sources_) {
-            if (!source->isPlaying()) continue;
-            
-            mixSource(*source, frameCount);
+
+        if (!finishedOverflow_.empty()) flushFinishedOverflow();
+        drainCommands();
+        acquireParams();
+
+        if (muted_.load(std::memory_order_relaxed)) {
+            std::fill(outputBuffer, outputBuffer + frameCount * channels_, 0.0f);
+        } else {
+            float vol = masterGain_.load(std::memory_order_relaxed);
+            const float* planes[8];
+            int planeCount = std::min(channels_, 8);
+            for (int c = 0; c < planeCount; c++) {
+                planes[c] = mixBuffer_.data() + c * kMixBlock;
+            }
+
+            for (size_t done = 0; done < frameCount; done += kMixBlock) {
+                size_t frames = std::min(kMixBlock, frameCount - done);
+                std::fill(mixBuffer_.begin(), mixBuffer_.end(), 0.0f);
+
+                // Mix all playing voices
+                for (size_t slot = 0; slot < voices_.size(); slot++) {
+                    Voice& voice = voices_[slot];
+                    if (!voice.active || voice.paused) continue;
+
+                    mixVoice(voice, (uint32_t)slot, frames);
+                }
+
+                // Apply master volume and interleave into the output
+                dsp::interleave(outputBuffer + done * channels_, planes, planeCount, frames, vol);
+            }
+
+            for (size_t slot = 0; slot < voices_.size(); slot++) {
+                if (voices_[slot].active) {
+                    voiceStatus_[slot].cursor.store(voices_[slot].cursor, std::memory_order_relaxed);
+                }
+            }
         }
-        
-        // Apply master volume and copy to output
-        float vol = masterVolume_ * listener_.getVolume();
-        for (size_t i = 0; i < frameCount * channels_; i++) {
-            outputBuffer[i] = mixBuffer_[i] * vol;
+
+        recordMixTime(start, frameCount);
+    }
+
+    // ===== Mix Thread =====
+    // Mixes ahead into a FIFO of `latencyFrames`; the device callback drains
+    // it with readOutput() instead of calling mixAudio() itself
+    void startMixThread(size_t latencyFrames = 2048) {
+        if (!initialized_ || mixThread_.joinable()) return;
+        outputFifo_ = std::make_unique<SpscQueue<float>>(latencyFrames * channels_);
+        mixThreadRunning_.store(true, std::memory_order_release);
+        mixThread_ = std::thread([this] { mixThreadLoop(); });
+    }
+
+    void stopMixThread() {
+        if (!mixThread_.joinable()) return;
+        mixThreadRunning_.store(false, std::memory_order_release);
+        mixThread_.join();
+        outputFifo_.reset();
+    }
+
+    bool isMixThreadRunning() const { return mixThread_.joinable(); }
+
+    // Device side of the mix thread. Missing frames are silent and counted as
+    // an underrun. Returns the frames that came from the mixer.
+    size_t readOutput(float* outputBuffer, size_t frameCount) {
+        size_t wanted = frameCount * channels_;
+        size_t got = outputFifo_ ? outputFifo_->popBulk(outputBuffer, wanted) : 0;
+        if (got < wanted) {
+            std::fill(outputBuffer + got, outputBuffer + wanted, 0.0f);
+            mixStats_.underruns.fetch_add(1, std::memory_order_relaxed);
         }
+        return got / channels_;
     }
-    
+
+    // ===== Statistics =====
+    AudioMixStats getMixStats() const {
+        AudioMixStats stats;
+        stats.buffersMixed = mixStats_.buffersMixed.load(std::memory_order_relaxed);
+        stats.lastMixUs = mixStats_.lastMixUs.load(std::memory_order_relaxed);
+        stats.avgMixUs = mixStats_.avgMixUs.load(std::memory_order_relaxed);
+        stats.maxMixUs = mixStats_.maxMixUs.load(std::memory_order_relaxed);
+        stats.deadlineUs = mixStats_.deadlineUs.load(std::memory_order_relaxed);
+        stats.overruns = mixStats_.overruns.load(std::memory_order_relaxed);
+        stats.underruns = mixStats_.underruns.load(std::memory_order_relaxed);
+        stats.commandsDeferred = commandsDeferred_;
+        stats.realVoices = realVoices_;
+        stats.virtualVoices = virtualVoices_;
+        return stats;
+    }
+
+    void resetMixStats() {
+        mixStats_.buffersMixed.store(0, std::memory_order_relaxed);
+        mixStats_.lastMixUs.store(0.0, std::memory_order_relaxed);
+        mixStats_.avgMixUs.store(0.0, std::memory_order_relaxed);
+        mixStats_.maxMixUs.store(0.0, std::memory_order_relaxed);
+        mixStats_.overruns.store(0, std::memory_order_relaxed);
+        mixStats_.underruns.store(0, std::memory_order_relaxed);
+        commandsDeferred_ = 0;
+    }
+
     // Get active source count
     size_t getPlayingCount() const {
         size_t count = 0;
@@ -518,58 +805,128 @@ public:
         }
         return count;
     }
-    
-    // Play one-shot sound (creates temporary source)
+
+    // Play one-shot sound (temporary source, destroyed once it finishes)
     void playOneShot(std::shared_ptr<AudioClip> clip, const Vec3& position, float volume = 1.0f) {
         AudioSource* source = createSource();
         source->setClip(clip);
         source->setPosition(position);
         source->setVolume(volume);
+        source->oneShot_ = true;
         source->play();
-        // Note: In real implementation, would clean up after playback
     }
-    
+
 private:
     AudioSystem() = default;
-    
+    ~AudioSystem() { stopMixThread(); }
+
+    static constexpr size_t kMixBlock = 256;    // Frames mixed per pass
+    static constexpr size_t kRampFrames = 64;   // Gain changes are spread over this many frames
+    static constexpr int kMaxStep = dsp::SincResampler::kMaxStep;  // Highest clip-to-device rate ratio mixed
+    static constexpr float kAudibleGain = 1e-4f;  // -80 dB; quieter voices go virtual
+
+    // ===== Game -> Audio Thread =====
+    // Everything the mixer needs to know about a voice, written by update()
+    struct VoiceParams {
+        float gains[2] = {0.0f, 0.0f};  // Per output channel; 0 while virtual
+        float pitch = 1.0f;             // Including Doppler
+        uint32_t generation = 0;        // Play the parameters belong to
+        bool loop = false;
+        bool foldToMono = false;        // Spatialized stereo clips
+    };
+
+    struct AudioCommand {
+        enum class Type : uint8_t { Play, Pause, Resume, Seek, Release };
+        Type type = Type::Release;
+        uint32_t slot = 0;
+        uint32_t generation = 0;
+        uint64_t cursor = 0;
+        VoiceParams params;
+        std::shared_ptr<AudioClip> clip;
+        std::shared_ptr<AudioStream> stream;  // Play / Seek of a streaming clip
+    };
+
+    // ===== Audio Thread -> Game =====
+    struct AudioEvent {
+        enum class Type : uint8_t { Finished, Retire };
+        Type type = Type::Finished;
+        uint32_t slot = 0;
+        uint32_t generation = 0;
+        std::shared_ptr<AudioClip> clip;      // Released on the game thread
+        std::shared_ptr<AudioStream> stream;
+    };
+
+    // Mixer-side state of a voice slot; only the audio thread touches it
+    struct Voice {
+        std::shared_ptr<AudioClip> clip;
+        std::shared_ptr<AudioStream> stream;  // Streaming clips
+        uint64_t loopBase = 0;                // Stream frame of clip frame 0 this loop
+        VoiceParams params;
+        uint64_t cursor = 0;
+        uint32_t generation = 0;
+        float mixGains[2] = {0.0f, 0.0f};  // Gains applied in the last mixed block
+        bool primed = false;
+        bool active = false;
+        bool paused = false;
+    };
+
+    // Published by the mixer after every buffer
+    struct VoiceStatus {
+        std::atomic<uint64_t> cursor{0};
+        std::atomic<uint32_t> generation{0};
+    };
+
+    struct MixCounters {
+        std::atomic<uint64_t> buffersMixed{0};
+        std::atomic<double> lastMixUs{0.0};
+        std::atomic<double> avgMixUs{0.0};
+        std::atomic<double> maxMixUs{0.0};
+        std::atomic<double> deadlineUs{0.0};
+        std::atomic<uint64_t> overruns{0};
+        std::atomic<uint64_t> underruns{0};
+    };
+
+    static constexpr uint32_t kParamsDirty = 4;  // Set in paramsLatest_ when unread
+
     void updateSource3D(AudioSource& source) {
         const auto& settings = source.getSettings();
-        
+
+        source.computedPitch = settings.pitch;
         if (!settings.spatialize) {
             source.computedVolume = settings.volume;
             source.computedPanL = 1.0f;
             source.computedPanR = 1.0f;
             return;
         }
-        
+
         Vec3 listenerPos = listener_.getPosition();
         Vec3 sourcePos = source.getPosition();
         Vec3 delta = sourcePos - listenerPos;
         float distance = delta.length();
-        
+
         // Distance attenuation
         float attenuation = 1.0f;
         if (distance > settings.minDistance) {
             if (settings.rolloff == AudioRolloff::Linear) {
-                attenuation = 1.0f - (distance - settings.minDistance) / 
+                attenuation = 1.0f - (distance - settings.minDistance) /
                              (settings.maxDistance - settings.minDistance);
                 attenuation = std::max(0.0f, attenuation);
             } else {
                 // Logarithmic
-                attenuation = settings.minDistance / 
-                             (settings.minDistance + settings.rolloffFactor * 
+                attenuation = settings.minDistance /
+                             (settings.minDistance + settings.rolloffFactor *
                               (distance - settings.minDistance));
             }
         }
-        
+
         source.computedVolume = settings.volume * attenuation;
-        
+
         // Stereo panning
         if (distance > 0.001f) {
             Vec3 dir = delta * (1.0f / distance);
             Vec3 right = listener_.getRight();
             float pan = dir.dot(right);  // -1 to 1
-            
+
             // Constant power panning
             float angle = (pan + 1.0f) * 0.25f * 3.14159f;  // 0 to PI/2
             source.computedPanL = cosf(angle);
@@ -577,92 +934,561 @@ private:
         } else {
             source.computedPanL = source.computedPanR = 0.707f;  // Equal power
         }
-        
+
         // Doppler effect (simplified)
         if (settings.dopplerLevel > 0.0f) {
             Vec3 listenerVel = listener_.getVelocity();
             Vec3 sourceVel = source.getVelocity();
-            
+
             if (distance > 0.001f) {
                 Vec3 dir = delta * (1.0f / distance);
                 float vListener = listenerVel.dot(dir);
                 float vSource = sourceVel.dot(dir);
-                
+
                 const float speedOfSound = 343.0f;
                 float dopplerShift = (speedOfSound + vListener * settings.dopplerLevel) /
                                     (speedOfSound + vSource * settings.dopplerLevel);
                 dopplerShift = std::max(0.5f, std::min(2.0f, dopplerShift));
-                // Would apply to pitch in real implementation
+                source.computedPitch = settings.pitch * dopplerShift;
             }
         }
     }
-    
-    void mixSource(AudioSource& source, size_t frameCount) {
-        AudioClip* clip = source.getClip();
-        if (!clip || clip->getDataSize() == 0) return;
-        
-        size_t samplePos = source.getPlaybackPosition();
-        size_t clipSamples = clip->getDataSize() / (clip->getBitsPerSample() / 8) / clip->getChannels();
-        
+
+    // ===== Game Thread =====
+    float audibility(const AudioSource& source) const {
+        if (!source.getSettings().spatialize || channels_ < 2) return source.computedVolume;
+        return source.computedVolume * std::max(source.computedPanL, source.computedPanR);
+    }
+
+    // Highest priority first, then loudest; everything past the cap or below
+    // the audible threshold is virtual
+    void updateVirtualization() {
+        virtualOrder_.clear();
+        for (auto& source : sources_) {
+            if (source->isPlaying()) virtualOrder_.push_back(source.get());
+        }
+        std::sort(virtualOrder_.begin(), virtualOrder_.end(),
+            [this](const AudioSource* a, const AudioSource* b) {
+                int pa = a->getSettings().priority;
+                int pb = b->getSettings().priority;
+                if (pa != pb) return pa < pb;
+                return audibility(*a) > audibility(*b);
+            });
+
+        realVoices_ = 0;
+        virtualVoices_ = 0;
+        for (AudioSource* source : virtualOrder_) {
+            bool real = (int)realVoices_ < maxRealVoices_ && audibility(*source) >= kAudibleGain;
+            source->virtual_ = !real;
+            if (real) realVoices_++; else virtualVoices_++;
+        }
+    }
+
+    VoiceParams makeParams(const AudioSource& source) const {
+        VoiceParams params;
         const auto& settings = source.getSettings();
-        float volume = source.computedVolume;
-        float panL = source.computedPanL;
-        float panR = source.computedPanR;
-        
-        const uint8_t* data = clip->getData().data();
-        int bytesPerSample = clip->getBitsPerSample() / 8;
-        int clipChannels = clip->getChannels();
-        
-        for (size_t i = 0; i < frameCount; i++) {
-            if (samplePos >= clipSamples) {
-                if (settings.loop) {
-                    samplePos = 0;
-                } else {
-                    source.stop();
+        if (!source.virtual_) {
+            float volume = source.computedVolume;
+            params.gains[0] = channels_ < 2 ? volume : volume * source.computedPanL;
+            params.gains[1] = volume * source.computedPanR;
+        }
+        params.pitch = source.computedPitch;
+        params.generation = source.generation_;
+        params.loop = settings.loop;
+        params.foldToMono = settings.spatialize;
+        return params;
+    }
+
+    bool sendCommand(AudioCommand::Type type, const AudioSource& source) {
+        AudioCommand command;
+        command.type = type;
+        command.slot = (uint32_t)source.slot_;
+        command.generation = source.generation_;
+        command.cursor = source.cursor_;
+        if (type == AudioCommand::Type::Play) {
+            command.params = makeParams(source);
+            command.clip = source.clip_;
+        }
+        if ((type == AudioCommand::Type::Play || type == AudioCommand::Type::Seek) &&
+            source.clip_ && source.clip_->isStreaming()) {
+            size_t startFrame = (size_t)(source.cursor_ >> dsp::SincResampler::kFracBits);
+            command.stream = source.clip_->createStream(startFrame, source.getSettings().loop);
+            streamer_.add(command.stream);  // Decodes the first chunks before the mixer sees it
+        }
+        return commands_->push(std::move(command));
+    }
+
+    // Slots of destroyed sources go back to the pool once the audio thread
+    // has been told to let go of them
+    void flushReleases() {
+        if (!commands_) return;
+        while (!pendingReleases_.empty()) {
+            AudioCommand command;
+            command.type = AudioCommand::Type::Release;
+            command.slot = (uint32_t)pendingReleases_.back();
+            if (!commands_->push(std::move(command))) {
+                commandsDeferred_++;
+                return;
+            }
+            freeSlots_.push_back(pendingReleases_.back());
+            pendingReleases_.pop_back();
+        }
+    }
+
+    void releaseSlot(AudioSource& source) {
+        if (source.slot_ < 0) return;
+        slotOwners_[source.slot_] = nullptr;
+        pendingReleases_.push_back(source.slot_);
+        source.slot_ = -1;
+    }
+
+    // A source holds a voice slot only while playing or paused. Pending
+    // commands stay on the source when the queue is full and are retried on
+    // the next update.
+    void flushCommands() {
+        using Type = AudioCommand::Type;
+        for (auto& source : sources_) {
+            AudioSource& s = *source;
+            if (s.pending_ == 0) continue;
+            if (s.pending_ & AudioSource::kPendingStop) {
+                releaseSlot(s);
+                s.pending_ = 0;
+                continue;
+            }
+            if (s.slot_ < 0) {
+                if (freeSlots_.empty()) {
+                    commandsDeferred_++;
+                    continue;
+                }
+                s.slot_ = freeSlots_.back();
+                freeSlots_.pop_back();
+                slotOwners_[s.slot_] = &s;
+            }
+
+            if (s.pending_ & AudioSource::kPendingPlay) {
+                s.pending_ &= ~AudioSource::kPendingSeek;  // Play starts at the cursor
+            }
+            static const std::pair<uint8_t, Type> order[] = {
+                {AudioSource::kPendingPlay, Type::Play},
+                {AudioSource::kPendingSeek, Type::Seek},
+                {AudioSource::kPendingPause, Type::Pause},
+                {AudioSource::kPendingResume, Type::Resume},
+            };
+            for (const auto& [bit, type] : order) {
+                if (!(s.pending_ & bit)) continue;
+                if (!sendCommand(type, s)) {
+                    commandsDeferred_++;
                     break;
                 }
+                s.pending_ &= ~bit;
             }
-            
-            // Read sample
-            float sample = 0.0f;
-            size_t byteOffset = samplePos * bytesPerSample * clipChannels;
-            
-            if (bytesPerSample == 2) {
-                int16_t s16 = (int16_t)(data[byteOffset] | (data[byteOffset + 1] << 8));
-                sample = s16 / 32768.0f;
-            } else if (bytesPerSample == 1) {
-                sample = (data[byteOffset] - 128) / 128.0f;
+        }
+        flushReleases();
+    }
+
+    // Writes every slot into the back buffer and swaps it with the shared one
+    void publishParams() {
+        std::vector<VoiceParams>& back = params_[paramsBack_];
+        std::fill(back.begin(), back.end(), VoiceParams{});
+        for (auto& source : sources_) {
+            if (source->slot_ >= 0 && source->state_ != AudioState::Stopped) {
+                back[source->slot_] = makeParams(*source);
+            }
+        }
+        uint32_t previous = paramsLatest_.exchange(paramsBack_ | kParamsDirty, std::memory_order_acq_rel);
+        paramsBack_ = previous & ~kParamsDirty;
+    }
+
+    void processEvents() {
+        AudioEvent event;
+        bool oneShotsDone = false;
+        while (events_->pop(event)) {
+            if (event.type != AudioEvent::Type::Finished) {
+                event.clip.reset();  // Last reference may go here, off the audio thread
+                event.stream.reset();
+                continue;
             }
-            
-            // Apply volume and panning
-            sample *= volume;
-            
-            if (channels_ == 2) {
-                mixBuffer_[i * 2] += sample * panL;
-                mixBuffer_[i * 2 + 1] += sample * panR;
+            AudioSource* source = slotOwners_[event.slot];
+            if (!source || source->generation_ != event.generation ||
+                (source->pending_ & AudioSource::kPendingPlay)) continue;
+            source->state_ = AudioState::Stopped;
+            source->cursor_ = 0;
+            source->pending_ = 0;
+            releaseSlot(*source);
+            oneShotsDone |= source->oneShot_;
+        }
+
+        if (oneShotsDone) {
+            sources_.erase(
+                std::remove_if(sources_.begin(), sources_.end(),
+                    [](const auto& s) { return s->oneShot_ && s->state_ == AudioState::Stopped; }),
+                sources_.end()
+            );
+        }
+    }
+
+    // ===== Audio Thread =====
+    // Hands a clip (and stream) the voice no longer needs back to the game
+    // thread, so the last reference is never dropped (and freed) here
+    void retireClip(Voice& voice) {
+        if (!voice.clip && !voice.stream) return;
+        AudioEvent event;
+        event.type = AudioEvent::Type::Retire;
+        event.clip = std::move(voice.clip);
+        event.stream = std::move(voice.stream);
+        if (!events_->push(std::move(event))) {
+            // Queue full: release here rather than leak
+            event.clip.reset();
+            event.stream.reset();
+        }
+        voice.clip.reset();
+        voice.stream.reset();
+    }
+
+    void finishVoice(Voice& voice, uint32_t slot) {
+        voice.active = false;
+        AudioEvent event;
+        event.type = AudioEvent::Type::Finished;
+        event.slot = slot;
+        event.generation = voice.generation;
+        if (!events_->push(std::move(event))) {
+            // Queue full: the game thread must still hear about it or the
+            // source stays playing and its slot leaks. One entry per slot,
+            // so the reserved storage never grows here.
+            auto it = std::find_if(finishedOverflow_.begin(), finishedOverflow_.end(),
+                                   [slot](const auto& entry) { return entry.first == slot; });
+            if (it != finishedOverflow_.end()) {
+                it->second = voice.generation;  // The earlier play is superseded
             } else {
-                mixBuffer_[i] += sample;
+                finishedOverflow_.emplace_back(slot, voice.generation);
             }
-            
-            samplePos++;
         }
-        
-        source.advancePlayback(frameCount);
+        retireClip(voice);
     }
-    
+
+    // Finished events that did not fit, retried at the start of each mix
+    void flushFinishedOverflow() {
+        size_t sent = 0;
+        for (; sent < finishedOverflow_.size(); sent++) {
+            AudioEvent event;
+            event.type = AudioEvent::Type::Finished;
+            event.slot = finishedOverflow_[sent].first;
+            event.generation = finishedOverflow_[sent].second;
+            if (!events_->push(std::move(event))) break;
+        }
+        finishedOverflow_.erase(finishedOverflow_.begin(), finishedOverflow_.begin() + sent);
+    }
+
+    // A command that has to wait stops the drain, so later commands keep
+    // their order behind it; it is retried at the start of the next mix
+    void drainCommands() {
+        if (commandHeld_) {
+            if (!applyCommand(heldCommand_)) return;
+            heldCommand_ = AudioCommand{};
+            commandHeld_ = false;
+        }
+        AudioCommand command;
+        while (commands_->pop(command)) {
+            if (!applyCommand(command)) {
+                heldCommand_ = std::move(command);
+                commandHeld_ = true;
+                return;
+            }
+        }
+    }
+
+    // False if the command cannot be applied until the event queue has room
+    bool applyCommand(AudioCommand& command) {
+        using Type = AudioCommand::Type;
+        if (command.slot >= voices_.size()) return true;
+        Voice& voice = voices_[command.slot];
+        VoiceStatus& status = voiceStatus_[command.slot];
+        if (command.type == Type::Play) {
+            retireClip(voice);
+            voice.clip = std::move(command.clip);
+            voice.stream = std::move(command.stream);
+            voice.loopBase = 0;
+            voice.params = command.params;
+            voice.cursor = command.cursor;
+            voice.generation = command.generation;
+            voice.primed = false;
+            voice.active = true;
+            voice.paused = false;
+            status.cursor.store(voice.cursor, std::memory_order_relaxed);
+            status.generation.store(voice.generation, std::memory_order_release);
+            return true;
+        }
+        if (command.type == Type::Release) {
+            voice.active = false;
+            voice.generation = 0;
+            retireClip(voice);
+            status.generation.store(0, std::memory_order_release);
+            return true;
+        }
+        if (command.generation != voice.generation) return true;  // Aimed at an earlier play
+        switch (command.type) {
+            case Type::Pause:  voice.paused = true; break;
+            case Type::Resume: voice.paused = false; break;
+            case Type::Seek:
+                if (command.stream) {
+                    if (voice.stream) {
+                        // The replaced stream must reach the game thread; with
+                        // the queue full the voice keeps playing the old one
+                        AudioEvent event;
+                        event.type = AudioEvent::Type::Retire;
+                        event.stream = std::move(voice.stream);
+                        if (!events_->push(std::move(event))) {
+                            voice.stream = std::move(event.stream);
+                            return false;
+                        }
+                    }
+                    voice.stream = std::move(command.stream);
+                    voice.loopBase = 0;
+                }
+                voice.cursor = command.cursor;
+                status.cursor.store(voice.cursor, std::memory_order_relaxed);
+                break;
+            default: break;
+        }
+        return true;
+    }
+
+    void acquireParams() {
+        if (paramsLatest_.load(std::memory_order_relaxed) & kParamsDirty) {
+            paramsFront_ = paramsLatest_.exchange(paramsFront_, std::memory_order_acq_rel) & ~kParamsDirty;
+            const std::vector<VoiceParams>& front = params_[paramsFront_];
+            for (size_t slot = 0; slot < voices_.size(); slot++) {
+                Voice& voice = voices_[slot];
+                if (voice.active && front[slot].generation == voice.generation) {
+                    voice.params = front[slot];
+                }
+            }
+        }
+    }
+
+    void recordMixTime(std::chrono::steady_clock::time_point start, size_t frameCount) {
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        double deadline = frameCount * 1e6 / sampleRate_;
+        uint64_t count = mixStats_.buffersMixed.load(std::memory_order_relaxed);
+        double avg = count == 0 ? us : mixStats_.avgMixUs.load(std::memory_order_relaxed) * 0.95 + us * 0.05;
+        mixStats_.lastMixUs.store(us, std::memory_order_relaxed);
+        mixStats_.avgMixUs.store(avg, std::memory_order_relaxed);
+        if (us > mixStats_.maxMixUs.load(std::memory_order_relaxed)) {
+            mixStats_.maxMixUs.store(us, std::memory_order_relaxed);
+        }
+        mixStats_.deadlineUs.store(deadline, std::memory_order_relaxed);
+        if (us > deadline) mixStats_.overruns.fetch_add(1, std::memory_order_relaxed);
+        mixStats_.buffersMixed.store(count + 1, std::memory_order_relaxed);
+    }
+
+    void mixThreadLoop() {
+        const size_t chunk = kMixBlock * 2;
+        std::vector<float> scratch(chunk * channels_);
+        auto idle = std::chrono::microseconds((int64_t)(chunk * 1e6 / sampleRate_ / 4));
+        while (mixThreadRunning_.load(std::memory_order_acquire)) {
+            if (outputFifo_->freeSpace() < scratch.size()) {
+                std::this_thread::sleep_for(idle);
+                continue;
+            }
+            mixAudio(scratch.data(), chunk);
+            outputFifo_->pushBulk(scratch.data(), scratch.size());
+        }
+    }
+
+    // Copy clip frames [first, first + count) of one channel; frames outside
+    // the clip wrap around when looping and are silent otherwise
+    static void gatherFrames(const float* plane, size_t clipFrames, int64_t first, size_t count,
+                             bool loop, float* dst) {
+        int64_t frames = (int64_t)clipFrames;
+        size_t written = 0;
+        while (written < count) {
+            int64_t index = first + (int64_t)written;
+            size_t run = count - written;
+            if (loop) {
+                index %= frames;
+                if (index < 0) index += frames;
+                run = std::min(run, (size_t)(frames - index));
+                memcpy(dst + written, plane + index, run * sizeof(float));
+            } else if (index < 0) {
+                run = std::min(run, (size_t)(-index));
+                std::fill(dst + written, dst + written + run, 0.0f);
+            } else if (index >= frames) {
+                std::fill(dst + written, dst + written + run, 0.0f);
+            } else {
+                run = std::min(run, (size_t)(frames - index));
+                memcpy(dst + written, plane + index, run * sizeof(float));
+            }
+            written += run;
+        }
+    }
+
+    void mixVoice(Voice& voice, uint32_t slot, size_t frameCount) {
+        AudioClip* clip = voice.clip.get();
+        if (!clip || clip->getFrameCount() == 0) {
+            finishVoice(voice, slot);
+            return;
+        }
+
+        using dsp::SincResampler;
+        const VoiceParams& params = voice.params;
+        const size_t clipFrames = clip->getFrameCount();
+        const uint64_t end = (uint64_t)clipFrames << SincResampler::kFracBits;
+        uint64_t pos = voice.cursor;
+        if (pos >= end) {
+            if (!params.loop) {
+                finishVoice(voice, slot);
+                return;
+            }
+            voice.loopBase += clipFrames * (pos / end);
+            pos %= end;
+        }
+        AudioStream* stream = voice.stream.get();
+        if (stream) stream->setLoop(params.loop);
+
+        // Clip rate, pitch and Doppler all end up in one resampling step
+        double rate = (double)clip->getSampleRate() / sampleRate_ * std::max(0.01f, params.pitch);
+        rate = std::min(rate, (double)kMaxStep);
+        uint64_t step = std::max<uint64_t>(1, SincResampler::toFixed(rate));
+
+        // Target gains per output channel (constant-power pan for mono voices)
+        const float* target = params.gains;
+        if (!voice.primed) {
+            voice.mixGains[0] = target[0];
+            voice.mixGains[1] = target[1];
+            voice.primed = true;
+        }
+
+        bool silent = target[0] == 0.0f && target[1] == 0.0f &&
+                      voice.mixGains[0] == 0.0f && voice.mixGains[1] == 0.0f;
+        int voiceChannels = std::min(clip->getChannels(), 2);
+        const float* samples[2] = {nullptr, nullptr};
+
+        if (silent) {
+            // Nothing to hear (or virtual); only keep the playback position moving
+            pos += step * frameCount;
+        } else if (!stream && step == SincResampler::kOne && (pos & (SincResampler::kOne - 1)) == 0 &&
+                   (pos >> SincResampler::kFracBits) + frameCount <= clipFrames) {
+            // Same rate, whole frames: read the clip in place
+            size_t first = (size_t)(pos >> SincResampler::kFracBits);
+            for (int c = 0; c < voiceChannels; c++) {
+                samples[c] = clip->getChannelData(c) + first;
+            }
+            pos += step * frameCount;
+        } else {
+            // Band-limited resampling from a window of clip frames around the
+            // block, positioned so that the first output sits kHistory frames in
+            uint64_t localPos = (pos & (SincResampler::kOne - 1)) +
+                                ((uint64_t)SincResampler::kHistory << SincResampler::kFracBits);
+            int64_t first = (int64_t)(pos >> SincResampler::kFracBits) - SincResampler::kHistory;
+            size_t needed = SincResampler::inputFramesNeeded(localPos, step, frameCount);
+
+            const float* input[2];
+            float* output[2];
+            float* gathered[2] = {gatherBuffers_[0].data(), gatherBuffers_[1].data()};
+            if (stream) {
+                // Streams address frames continuously across loops
+                stream->read((int64_t)voice.loopBase + first, needed, gathered);
+            }
+            for (int c = 0; c < voiceChannels; c++) {
+                if (!stream) {
+                    gatherFrames(clip->getChannelData(c), clipFrames, first, needed, params.loop,
+                                 gathered[c]);
+                }
+                input[c] = gatherBuffers_[c].data();
+                output[c] = voiceBuffers_[c].data();
+                samples[c] = voiceBuffers_[c].data();
+            }
+            SincResampler::get().process(input, output, voiceChannels, frameCount, localPos, step);
+            pos += step * frameCount;
+        }
+
+        if (!silent) {
+            float* left = mixBuffer_.data();
+            float* right = channels_ >= 2 ? mixBuffer_.data() + kMixBlock : nullptr;
+            if (voiceChannels == 2 && (params.foldToMono || !right)) {
+                // Spatialized (or mono output): fold the clip to mono first
+                float* mono = voiceBuffers_[0].data();
+                if (samples[0] != mono) memcpy(mono, samples[0], frameCount * sizeof(float));
+                for (size_t i = 0; i < frameCount; i++) mono[i] = (mono[i] + samples[1][i]) * 0.5f;
+                samples[0] = mono;
+                voiceChannels = 1;
+            }
+
+            if (!right) {
+                dsp::mixGainRamp(left, samples[0], frameCount, voice.mixGains[0], target[0], kRampFrames);
+            } else {
+                const float* samplesRight = voiceChannels == 2 ? samples[1] : samples[0];
+                dsp::mixGainRamp(left, samples[0], frameCount, voice.mixGains[0], target[0], kRampFrames);
+                dsp::mixGainRamp(right, samplesRight, frameCount, voice.mixGains[1], target[1], kRampFrames);
+            }
+        }
+        voice.mixGains[0] = target[0];
+        voice.mixGains[1] = target[1];
+
+        if (pos >= end) {
+            if (params.loop) {
+                voice.loopBase += clipFrames * (pos / end);
+                pos %= end;
+            } else {
+                voice.cursor = pos;
+                finishVoice(voice, slot);
+                return;
+            }
+        }
+        voice.cursor = pos;
+        if (stream) {
+            // Keep the next block's history; everything before it can be reused
+            stream->release((int64_t)(voice.loopBase + (pos >> SincResampler::kFracBits)) -
+                            SincResampler::kHistory);
+        }
+    }
+
     bool initialized_ = false;
     int sampleRate_ = 44100;
     int channels_ = 2;
     int bufferSize_ = 4096;
-    
+
+    // Game thread
     std::unordered_map<std::string, std::shared_ptr<AudioClip>> clips_;
     std::vector<std::unique_ptr<AudioSource>> sources_;
     AudioListener listener_;
     AudioMixer mixer_;
-    
-    std::vector<float> mixBuffer_;
     float masterVolume_ = 1.0f;
-    bool muted_ = false;
+    int maxRealVoices_ = kDefaultMaxRealVoices;
+    std::vector<AudioSource*> slotOwners_;
+    std::vector<int> freeSlots_;
+    std::vector<int> pendingReleases_;
+    std::vector<AudioSource*> virtualOrder_;
+    uint32_t realVoices_ = 0;
+    uint32_t virtualVoices_ = 0;
+    uint64_t commandsDeferred_ = 0;
+
+    // Shared between the threads
+    std::unique_ptr<SpscQueue<AudioCommand>> commands_;
+    std::unique_ptr<SpscQueue<AudioEvent>> events_;
+    std::vector<VoiceParams> params_[3];            // Triple buffer, one entry per slot
+    std::atomic<uint32_t> paramsLatest_{2};         // Last published buffer | kParamsDirty
+    uint32_t paramsBack_ = 0;                       // Game thread writes here
+    uint32_t paramsFront_ = 1;                      // Audio thread reads here
+    std::unique_ptr<VoiceStatus[]> voiceStatus_;
+    std::atomic<float> masterGain_{1.0f};
+    std::atomic<bool> muted_{false};
+    MixCounters mixStats_;
+    AudioStreamer streamer_;
+
+    // Audio thread
+    std::vector<Voice> voices_;
+    std::vector<std::pair<uint32_t, uint32_t>> finishedOverflow_;  // Slot, generation
+    AudioCommand heldCommand_;                      // Waiting for room in the event queue
+    bool commandHeld_ = false;
+    std::vector<float> mixBuffer_;                  // Planar, kMixBlock frames per channel
+    std::vector<float> voiceBuffers_[2];            // Resampled voice, per clip channel
+    std::vector<float> gatherBuffers_[2];           // Clip frames feeding the resampler
+
+    // Mix thread
+    std::thread mixThread_;
+    std::atomic<bool> mixThreadRunning_{false};
+    std::unique_ptr<SpscQueue<float>> outputFifo_;
 };
 
 // ===== Convenience Functions =====
@@ -0,0 +1,305 @@
+// Audio DSP - Vectorized mix kernels and band-limited resampling
+// Used by the AudioSystem mixer; operates on planar float buffers.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define LUMA_AUDIO_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LUMA_AUDIO_NEON 1
+#endif
+
+namespace luma {
+namespace dsp {
+
+// ===== 4-wide Float Vector =====
+#if defined(LUMA_AUDIO_SSE)
+using Float4 = __m128;
+inline Float4 load4(const float* p) { return _mm_loadu_ps(p); }
+inline void store4(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+inline Float4 set4(float v) { return _mm_set1_ps(v); }
+inline Float4 add4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 sub4(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 mul4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 madd4(Float4 acc, Float4 a, Float4 b) { return _mm_add_ps(acc, _mm_mul_ps(a, b)); }
+inline float hsum4(Float4 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+}
+#elif defined(LUMA_AUDIO_NEON)
+using Float4 = float32x4_t;
+inline Float4 load4(const float* p) { return vld1q_f32(p); }
+inline void store4(float* p, Float4 v) { vst1q_f32(p, v); }
+inline Float4 set4(float v) { return vdupq_n_f32(v); }
+inline Float4 add4(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 sub4(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+inline Float4 mul4(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+inline Float4 madd4(Float4 acc, Float4 a, Float4 b) { return vmlaq_f32(acc, a, b); }
+inline float hsum4(Float4 v) {
+    float32x2_t pair = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+    return vget_lane_f32(vpadd_f32(pair, pair), 0);
+}
+#else
+struct Float4 { float v[4]; };
+inline Float4 load4(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store4(float* p, Float4 a) { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+inline Float4 set4(float x) { return {{x, x, x, x}}; }
+inline Float4 add4(Float4 a, Float4 b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+inline Float4 sub4(Float4 a, Float4 b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+inline Float4 mul4(Float4 a, Float4 b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+inline Float4 madd4(Float4 acc, Float4 a, Float4 b) { return add4(acc, mul4(a, b)); }
+inline float hsum4(Float4 a) { return (a.v[0] + a.v[1]) + (a.v[2] + a.v[3]); }
+#endif
+
+// ===== Mix Kernels =====
+
+// dst[i] += src[i] * gain
+inline void mixGain(float* dst, const float* src, size_t count, float gain) {
+    Float4 g = set4(gain);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        store4(dst + i, madd4(load4(dst + i), load4(src + i), g));
+    }
+    for (; i < count; i++) dst[i] += src[i] * gain;
+}
+
+// dst[i] += src[i] * gain, gain moving linearly from `from` to `to` over the
+// first `rampFrames` frames (avoids zipper noise on volume / pan changes)
+inline void mixGainRamp(float* dst, const float* src, size_t count, float from, float to, size_t rampFrames) {
+    size_t ramp = std::min(count, rampFrames);
+    if (ramp == 0 || from == to) {
+        mixGain(dst, src, count, to);
+        return;
+    }
+    float step = (to - from) / static_cast<float>(ramp);
+    const float offsets[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    Float4 g = add4(set4(from), mul4(set4(step), load4(offsets)));
+    Float4 g4 = set4(step * 4.0f);
+    size_t i = 0;
+    for (; i + 4 <= ramp; i += 4) {
+        store4(dst + i, madd4(load4(dst + i), load4(src + i), g));
+        g = add4(g, g4);
+    }
+    for (; i < ramp; i++) dst[i] += src[i] * (from + step * static_cast<float>(i));
+    mixGain(dst + ramp, src + ramp, count - ramp, to);
+}
+
+// out[frame * channels + c] = planes[c][frame] * gain
+inline void interleave(float* out, const float* const* planes, int channels, size_t count, float gain) {
+    if (channels == 2) {
+        const float* left = planes[0];
+        const float* right = planes[1];
+        size_t i = 0;
+#if defined(LUMA_AUDIO_SSE)
+        __m128 g = _mm_set1_ps(gain);
+        for (; i + 4 <= count; i += 4) {
+            __m128 l = _mm_mul_ps(_mm_loadu_ps(left + i), g);
+            __m128 r = _mm_mul_ps(_mm_loadu_ps(right + i), g);
+            _mm_storeu_ps(out + i * 2, _mm_unpacklo_ps(l, r));
+            _mm_storeu_ps(out + i * 2 + 4, _mm_unpackhi_ps(l, r));
+        }
+#elif defined(LUMA_AUDIO_NEON)
+        float32x4_t g = vdupq_n_f32(gain);
+        for (; i + 4 <= count; i += 4) {
+            float32x4x2_t lr;
+            lr.val[0] = vmulq_f32(vld1q_f32(left + i), g);
+            lr.val[1] = vmulq_f32(vld1q_f32(right + i), g);
+            vst2q_f32(out + i * 2, lr);
+        }
+#endif
+        for (; i < count; i++) {
+            out[i * 2] = left[i] * gain;
+            out[i * 2 + 1] = right[i] * gain;
+        }
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        for (int c = 0; c < channels; c++) {
+            out[i * channels + c] = planes[c][i] * gain;
+        }
+    }
+}
+
+// ===== Band-limited Resampler =====
+// Polyphase windowed-sinc (Kaiser) interpolation. Every output sample at
+// input position p reads a window of input frames around floor(p);
+// coefficients are linearly interpolated between kPhases table rows.
+//
+// Steps above 1 (pitching up / downsampling) fold everything above the output
+// Nyquist back into the audible band unless it is filtered out first, so the
+// kernel for those steps has a cutoff that falls with 1/step and taps that
+// grow with it to keep the transition band narrow. Steps above kMaxStep are
+// not filtered enough. Callers provide kHistory frames before floor(p) and
+// kLookahead frames from floor(p) on, enough for the widest kernel.
+class SincResampler {
+public:
+    static constexpr int kMaxTaps = 128;
+    static constexpr int kMaxStep = 8;
+    static constexpr int kHistory = kMaxTaps / 2 - 1;
+    static constexpr int kLookahead = kMaxTaps - kHistory;
+    static constexpr int kPhaseBits = 7;
+    static constexpr int kPhases = 1 << kPhaseBits;
+    static constexpr int kFracBits = 32;             // Positions are 32.32 fixed point
+    static constexpr uint64_t kOne = uint64_t(1) << kFracBits;
+
+    static const SincResampler& get() {
+        static const SincResampler instance;
+        return instance;
+    }
+
+    static uint64_t toFixed(double value) { return static_cast<uint64_t>(value * static_cast<double>(kOne) + 0.5); }
+
+    // Input frames [0, n) have to be available for `count` outputs starting
+    // at `pos` (fixed point, at least kHistory frames in) with increment `step`
+    static size_t inputFramesNeeded(uint64_t pos, uint64_t step, size_t count) {
+        if (count == 0) return 0;
+        uint64_t last = pos + step * (count - 1);
+        return static_cast<size_t>(last >> kFracBits) + kLookahead;
+    }
+
+    // Taps used for a step (cost per output sample and channel)
+    int tapsForStep(uint64_t step) const { return bandForStep(step).taps; }
+
+    // Resample planar channels sharing one position. Returns the position
+    // after the last output.
+    uint64_t process(const float* const* input, float* const* output, int channels,
+                     size_t count, uint64_t pos, uint64_t step) const {
+        const Band& band = bandForStep(step);
+        switch (band.taps) {
+            case 16: return run<16>(band, input, output, channels, count, pos, step);
+            case 32: return run<32>(band, input, output, channels, count, pos, step);
+            case 48: return run<48>(band, input, output, channels, count, pos, step);
+            case 64: return run<64>(band, input, output, channels, count, pos, step);
+            case 96: return run<96>(band, input, output, channels, count, pos, step);
+            default: return run<128>(band, input, output, channels, count, pos, step);
+        }
+    }
+
+private:
+    static constexpr int kBands = 7;
+
+    struct Band {
+        float maxStep;
+        int taps;
+        std::vector<float> coeffs;  // (kPhases + 1) rows of `taps`
+        std::vector<float> deltas;  // row[p + 1] - row[p]
+    };
+
+    SincResampler() {
+        // Kaiser (beta 7) transition width is about 8.6 / taps of the input
+        // Nyquist; cutoffs put the stopband edge at the output Nyquist
+        // (1 / maxStep), so taps grow with the step to keep the passband
+        struct Spec { float maxStep; int taps; float cutoff; };
+        const Spec specs[kBands] = {
+            {1.0f, 16, 0.92f},
+            {1.5f, 32, 0.53f},
+            {2.0f, 32, 0.36f},
+            {3.0f, 48, 0.24f},
+            {4.0f, 64, 0.18f},
+            {6.0f, 96, 0.12f},
+            {kMaxStep, 128, 0.09f},
+        };
+        for (int b = 0; b < kBands; b++) {
+            bands_[b] = buildBand(specs[b].taps, specs[b].cutoff);
+            bands_[b].maxStep = specs[b].maxStep;
+        }
+    }
+
+    const Band& bandForStep(uint64_t step) const {
+        float s = static_cast<float>(step) / static_cast<float>(kOne);
+        for (const Band& band : bands_) {
+            if (s <= band.maxStep) return band;
+        }
+        return bands_[kBands - 1];
+    }
+
+    template <int Taps>
+    static uint64_t run(const Band& band, const float* const* input, float* const* output, int channels,
+                        size_t count, uint64_t pos, uint64_t step) {
+        constexpr int kVectors = Taps / 4;
+        constexpr int kOffset = kHistory - (Taps / 2 - 1);
+        constexpr int kFracShift = kFracBits - kPhaseBits;
+        constexpr float kInterpScale = 1.0f / static_cast<float>(uint64_t(1) << kFracShift);
+
+        for (size_t i = 0; i < count; i++) {
+            size_t base = static_cast<size_t>(pos >> kFracBits) - kHistory + kOffset;
+            uint32_t frac = static_cast<uint32_t>(pos);
+            uint32_t phase = frac >> kFracShift;
+            Float4 t = set4(static_cast<float>(frac & ((1u << kFracShift) - 1)) * kInterpScale);
+
+            const float* c0 = &band.coeffs[phase * Taps];
+            const float* d0 = &band.deltas[phase * Taps];
+            Float4 k[kVectors];
+            for (int v = 0; v < kVectors; v++) {
+                k[v] = madd4(load4(c0 + v * 4), load4(d0 + v * 4), t);
+            }
+
+            for (int c = 0; c < channels; c++) {
+                const float* x = input[c] + base;
+                Float4 acc = mul4(k[0], load4(x));
+                for (int v = 1; v < kVectors; v++) {
+                    acc = madd4(acc, k[v], load4(x + v * 4));
+                }
+                output[c][i] = hsum4(acc);
+            }
+            pos += step;
+        }
+        return pos;
+    }
+
+    static double besselI0(double x) {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 32; k++) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    static Band buildBand(int taps, float cutoff) {
+        constexpr double kPi = 3.14159265358979323846;
+        constexpr double kBeta = 7.0;  // ~70 dB stopband
+        const int history = taps / 2 - 1;
+        const double halfWidth = taps / 2.0;
+        Band band;
+        band.taps = taps;
+        band.coeffs.resize((kPhases + 1) * taps);
+        band.deltas.resize((kPhases + 1) * taps);
+        for (int p = 0; p <= kPhases; p++) {
+            double frac = static_cast<double>(p) / kPhases;
+            double sum = 0.0;
+            for (int k = 0; k < taps; k++) {
+                double x = (k - history) - frac;  // Tap offset from the output position
+                double sinc = std::abs(x) < 1e-9 ? 1.0 : std::sin(kPi * cutoff * x) / (kPi * cutoff * x);
+                double r = x / halfWidth;
+                double window = std::abs(r) >= 1.0 ? 0.0 : besselI0(kBeta * std::sqrt(1.0 - r * r)) / besselI0(kBeta);
+                band.coeffs[p * taps + k] = static_cast<float>(sinc * window);
+                sum += sinc * window;
+            }
+            // Unity DC gain for every phase
+            for (int k = 0; k < taps; k++) {
+                band.coeffs[p * taps + k] = static_cast<float>(band.coeffs[p * taps + k] / sum);
+            }
+        }
+        for (int p = 0; p < kPhases; p++) {
+            for (int k = 0; k < taps; k++) {
+                band.deltas[p * taps + k] = band.coeffs[(p + 1) * taps + k] - band.coeffs[p * taps + k];
+            }
+        }
+        return band;
+    }
+
+    Band bands_[kBands];
+};
+
+}  // namespace dsp
+}  // namespace luma
@@ -0,0 +1,259 @@
+// Audio Spectrum - Real FFT and band filterbanks
+// Spectral analysis for lip sync and audio visualization; vectorized with the
+// Float4 wrappers from audio_dsp.h.
+#pragma once
+
+#include "engine/audio/audio_dsp.h"
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+namespace luma {
+namespace dsp {
+
+// ===== Real FFT =====
+// Forward / inverse transform of `size` real samples (a power of two, at
+// least 8) to size / 2 + 1 complex bins. Runs as a half-size complex FFT on
+// split real / imaginary arrays (iterative radix-2, four butterflies per
+// step once a stage is wide enough) followed by the real-split post pass.
+// Holds scratch buffers: use one instance per thread.
+class RealFFT {
+public:
+    explicit RealFFT(size_t size = 1024) { resize(size); }
+
+    void resize(size_t size) {
+        size_t n = 8;
+        while (n < size) n <<= 1;
+        n_ = n;
+        m_ = n / 2;
+
+        int bits = 0;
+        while ((size_t(1) << bits) < m_) bits++;
+        reverse_.resize(m_);
+        for (size_t i = 0; i < m_; i++) {
+            uint32_t r = 0;
+            for (int b = 0; b < bits; b++) r |= ((i >> b) & 1u) << (bits - 1 - b);
+            reverse_[i] = r;
+        }
+
+        // Stage with half-width h keeps its twiddles at [h - 1, 2h - 1)
+        stageCos_.resize(m_);
+        stageSin_.resize(m_);
+        for (size_t half = 1; half < m_; half <<= 1) {
+            for (size_t k = 0; k < half; k++) {
+                double angle = -3.14159265358979323846 * (double)k / (double)half;
+                stageCos_[half - 1 + k] = (float)std::cos(angle);
+                stageSin_[half - 1 + k] = (float)std::sin(angle);
+            }
+        }
+
+        postCos_.resize(m_);
+        postSin_.resize(m_);
+        for (size_t k = 0; k < m_; k++) {
+            double angle = -2.0 * 3.14159265358979323846 * (double)k / (double)n_;
+            postCos_[k] = (float)std::cos(angle);
+            postSin_[k] = (float)std::sin(angle);
+        }
+        zr_.assign(m_, 0.0f);
+        zi_.assign(m_, 0.0f);
+    }
+
+    size_t size() const { return n_; }
+    size_t bins() const { return m_ + 1; }
+
+    // `re` and `im` receive bins() values
+    void forward(const float* input, float* re, float* im) {
+        for (size_t i = 0; i < m_; i++) {
+            zr_[reverse_[i]] = input[2 * i];
+            zi_[reverse_[i]] = input[2 * i + 1];
+        }
+        transform(zr_.data(), zi_.data());
+
+        re[0] = zr_[0] + zi_[0];
+        im[0] = 0.0f;
+        re[m_] = zr_[0] - zi_[0];
+        im[m_] = 0.0f;
+        for (size_t k = 1; k < m_; k++) {
+            float ar = zr_[k], ai = zi_[k];
+            float br = zr_[m_ - k], bi = zi_[m_ - k];
+            // Even and odd sample spectra, then one combining butterfly
+            float er = (ar + br) * 0.5f, ei = (ai - bi) * 0.5f;
+            float odr = (ai + bi) * 0.5f, odi = (br - ar) * 0.5f;
+            float c = postCos_[k], s = postSin_[k];
+            re[k] = er + c * odr - s * odi;
+            im[k] = ei + c * odi + s * odr;
+        }
+    }
+
+    // Inverse of forward(): inverse(forward(x)) == x
+    void inverse(const float* re, const float* im, float* output) {
+        for (size_t k = 0; k < m_; k++) {
+            float xr = re[k], xi = im[k];
+            float yr = re[m_ - k], yi = -im[m_ - k];  // conj(X[m - k])
+            float er = (xr + yr) * 0.5f, ei = (xi + yi) * 0.5f;
+            float dr = xr - yr, di = xi - yi;
+            float c = postCos_[k], s = postSin_[k];
+            float odr = (dr * c + di * s) * 0.5f, odi = (di * c - dr * s) * 0.5f;
+            // Conjugated, so the forward transform computes the inverse
+            zr_[reverse_[k]] = er - odi;
+            zi_[reverse_[k]] = -(ei + odr);
+        }
+        transform(zr_.data(), zi_.data());
+
+        float scale = 1.0f / (float)m_;
+        for (size_t i = 0; i < m_; i++) {
+            output[2 * i] = zr_[i] * scale;
+            output[2 * i + 1] = -zi_[i] * scale;
+        }
+    }
+
+    // |X[k]|^2 for bins() bins; `re` / `im` are scratch of bins() values
+    void powerSpectrum(const float* input, float* power, float* re, float* im) {
+        forward(input, re, im);
+        size_t count = bins();
+        size_t k = 0;
+        for (; k + 4 <= count; k += 4) {
+            Float4 r = load4(re + k), i = load4(im + k);
+            store4(power + k, madd4(mul4(r, r), i, i));
+        }
+        for (; k < count; k++) power[k] = re[k] * re[k] + im[k] * im[k];
+    }
+
+private:
+    // In-place complex FFT of m_ points already in bit-reversed order
+    void transform(float* re, float* im) const {
+        for (size_t half = 1; half < m_; half <<= 1) {
+            const float* wr = stageCos_.data() + half - 1;
+            const float* wi = stageSin_.data() + half - 1;
+            for (size_t group = 0; group < m_; group += half * 2) {
+                float* ar = re + group;
+                float* ai = im + group;
+                float* br = ar + half;
+                float* bi = ai + half;
+                size_t k = 0;
+                if (half >= 4) {
+                    for (; k < half; k += 4) {
+                        Float4 xr = load4(br + k), xi = load4(bi + k);
+                        Float4 cr = load4(wr + k), ci = load4(wi + k);
+                        Float4 tr = sub4(mul4(xr, cr), mul4(xi, ci));
+                        Float4 ti = madd4(mul4(xr, ci), xi, cr);
+                        Float4 ur = load4(ar + k), ui = load4(ai + k);
+                        store4(br + k, sub4(ur, tr));
+                        store4(bi + k, sub4(ui, ti));
+                        store4(ar + k, add4(ur, tr));
+                        store4(ai + k, add4(ui, ti));
+                    }
+                }
+                for (; k < half; k++) {
+                    float tr = br[k] * wr[k] - bi[k] * wi[k];
+                    float ti = br[k] * wi[k] + bi[k] * wr[k];
+                    br[k] = ar[k] - tr;
+                    bi[k] = ai[k] - ti;
+                    ar[k] += tr;
+                    ai[k] += ti;
+                }
+            }
+        }
+    }
+
+    size_t n_ = 0;
+    size_t m_ = 0;
+    std::vector<uint32_t> reverse_;
+    std::vector<float> stageCos_, stageSin_;
+    std::vector<float> postCos_, postSin_;
+    std::vector<float> zr_, zi_;
+};
+
+// ===== Filterbank =====
+// Weighted sums of power-spectrum bins: triangular mel bands (speech
+// features) or rectangular octave bands (coarse spectral shape).
+class FilterBank {
+public:
+    // `bands` triangles evenly spaced on the mel scale between the limits
+    static FilterBank mel(int bands, size_t fftSize, float sampleRate, float minHz, float maxHz) {
+        auto toMel = [](float hz) { return 2595.0f * std::log10(1.0f + hz / 700.0f); };
+        auto toHz = [](float mel) { return 700.0f * (std::pow(10.0f, mel / 2595.0f) - 1.0f); };
+        FilterBank bank(fftSize, sampleRate);
+        float lowMel = toMel(minHz);
+        float highMel = toMel(std::min(maxHz, sampleRate * 0.5f));
+        for (int b = 0; b < bands; b++) {
+            float left = toHz(lowMel + (highMel - lowMel) * b / (bands + 1));
+            float center = toHz(lowMel + (highMel - lowMel) * (b + 1) / (bands + 1));
+            float right = toHz(lowMel + (highMel - lowMel) * (b + 2) / (bands + 1));
+            bank.addBand([&](float hz) {
+                if (hz <= left || hz >= right) return 0.0f;
+                return hz < center ? (hz - left) / (center - left) : (right - hz) / (right - center);
+            });
+        }
+        return bank;
+    }
+
+    // Band b covers [lowestHz * 2^b, lowestHz * 2^(b + 1)), clipped at Nyquist
+    static FilterBank octave(int bands, size_t fftSize, float sampleRate, float lowestHz) {
+        FilterBank bank(fftSize, sampleRate);
+        for (int b = 0; b < bands; b++) {
+            float low = lowestHz * std::ldexp(1.0f, b);
+            float high = low * 2.0f;
+            bank.addBand([&](float hz) { return hz >= low && hz < high ? 1.0f : 0.0f; });
+        }
+        return bank;
+    }
+
+    int getBandCount() const { return (int)bands_.size(); }
+    size_t getFftSize() const { return fftSize_; }
+
+    // bands[b] = sum of weight * power over the band's bins
+    void apply(const float* power, float* bands) const {
+        for (size_t b = 0; b < bands_.size(); b++) {
+            const Band& band = bands_[b];
+            const float* w = weights_.data() + band.offset;
+            const float* p = power + band.firstBin;
+            Float4 acc = set4(0.0f);
+            size_t i = 0;
+            for (; i + 4 <= band.count; i += 4) acc = madd4(acc, load4(w + i), load4(p + i));
+            float sum = hsum4(acc);
+            for (; i < band.count; i++) sum += w[i] * p[i];
+            bands[b] = sum;
+        }
+    }
+
+private:
+    struct Band {
+        size_t firstBin = 0;
+        size_t count = 0;
+        size_t offset = 0;  // Into weights_
+    };
+
+    FilterBank(size_t fftSize, float sampleRate) : fftSize_(fftSize), sampleRate_(sampleRate) {}
+
+    template<typename Response>
+    void addBand(Response response) {
+        size_t bins = fftSize_ / 2 + 1;
+        float binHz = sampleRate_ / (float)fftSize_;
+        Band band;
+        band.offset = weights_.size();
+        bool started = false;
+        for (size_t k = 0; k < bins; k++) {
+            float w = response(k * binHz);
+            if (w <= 0.0f && !started) continue;
+            if (!started) {
+                band.firstBin = k;
+                started = true;
+            }
+            weights_.push_back(w);
+        }
+        // Trim trailing zeros
+        while (weights_.size() > band.offset && weights_.back() <= 0.0f) weights_.pop_back();
+        band.count = weights_.size() - band.offset;
+        bands_.push_back(band);
+    }
+
+    size_t fftSize_;
+    float sampleRate_;
+    std::vector<Band> bands_;
+    std::vector<float> weights_;
+};
+
+}  // namespace dsp
+}  // namespace luma
@@ -0,0 +1,387 @@
+// Audio Streaming - WAV files decoded in chunks ahead of the mixer
+// Long clips (music, dialogue) keep only a small ring of decoded frames per
+// playing voice instead of the whole track.
+#pragma once
+
+#include "engine/audio/audio_dsp.h"
+#include <vector>
+#include <memory>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace luma {
+
+// ===== PCM Decoding =====
+// Interleaved 8-bit unsigned, 16/24-bit signed or 32-bit float PCM to planar
+// float; only the first `dstChannels` channels are written
+inline void decodePcm(const uint8_t* data, int bitsPerSample, int srcChannels, size_t frames,
+                      float* const* dst, int dstChannels) {
+    size_t bytesPerSample = bitsPerSample / 8;
+    size_t stride = bytesPerSample * srcChannels;
+    for (int c = 0; c < dstChannels; c++) {
+        float* out = dst[c];
+        const uint8_t* src = data + c * bytesPerSample;
+        for (size_t i = 0; i < frames; i++, src += stride) {
+            switch (bitsPerSample) {
+                case 8:
+                    out[i] = (src[0] - 128) / 128.0f;
+                    break;
+                case 16:
+                    out[i] = (int16_t)(src[0] | (src[1] << 8)) / 32768.0f;
+                    break;
+                case 24: {
+                    int32_t s24 = (int32_t)((uint32_t)src[0] << 8 | (uint32_t)src[1] << 16 | (uint32_t)src[2] << 24) >> 8;
+                    out[i] = s24 / 8388608.0f;
+                    break;
+                }
+                default:
+                    memcpy(&out[i], src, sizeof(float));
+                    break;
+            }
+        }
+    }
+}
+
+// ===== WAV Header =====
+struct WavInfo {
+    int sampleRate = 0;
+    int channels = 0;
+    int bitsPerSample = 0;
+    size_t dataOffset = 0;  // Byte offset of the first frame in the file
+    size_t dataSize = 0;
+
+    size_t frameCount() const {
+        size_t frameBytes = (size_t)(bitsPerSample / 8) * channels;
+        return frameBytes ? dataSize / frameBytes : 0;
+    }
+};
+
+// Parses the RIFF chunks up to the "data" chunk. Accepts PCM 8/16/24-bit and
+// 32-bit float, plain or WAVE_FORMAT_EXTENSIBLE.
+inline bool parseWavHeader(const uint8_t* data, size_t size, WavInfo& info) {
+    auto u16 = [&](size_t at) { return (uint32_t)data[at] | (uint32_t)data[at + 1] << 8; };
+    auto u32 = [&](size_t at) { return u16(at) | u16(at + 2) << 16; };
+
+    if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0) return false;
+
+    bool haveFormat = false;
+    uint32_t formatTag = 0;
+    size_t at = 12;
+    while (at + 8 <= size) {
+        uint32_t chunkSize = u32(at + 4);
+        const uint8_t* id = data + at;
+        size_t body = at + 8;
+        if (memcmp(id, "fmt ", 4) == 0) {
+            if (chunkSize < 16 || body + 16 > size) return false;
+            formatTag = u16(body);
+            info.channels = (int)u16(body + 2);
+            info.sampleRate = (int)u32(body + 4);
+            info.bitsPerSample = (int)u16(body + 14);
+            if (formatTag == 0xFFFE && chunkSize >= 26 && body + 26 <= size) {
+                formatTag = u16(body + 24);  // Sub-format GUID starts with the tag
+            }
+            haveFormat = true;
+        } else if (memcmp(id, "data", 4) == 0) {
+            if (!haveFormat) return false;
+            info.dataOffset = body;
+            // Streamed writers may leave the size open; clamp to the file
+            info.dataSize = std::min<size_t>(chunkSize, size > body ? size - body : 0);
+            bool pcm = formatTag == 1 && (info.bitsPerSample == 8 || info.bitsPerSample == 16 ||
+                                          info.bitsPerSample == 24);
+            bool ieee = formatTag == 3 && info.bitsPerSample == 32;
+            return (pcm || ieee) && info.channels > 0 && info.sampleRate > 0;
+        }
+        at = body + chunkSize + (chunkSize & 1);  // Chunks are word aligned
+    }
+    return false;
+}
+
+// ===== WAV File =====
+// A WAV file opened for streaming. The payload is memory-mapped (read through
+// the file on Windows), so only the pages the streamer touches are loaded.
+class WavFile {
+public:
+    static std::shared_ptr<WavFile> open(const std::string& path) {
+        auto file = std::shared_ptr<WavFile>(new WavFile());
+        file->path_ = path;
+#if defined(_WIN32)
+        file->stream_.open(path, std::ios::binary);
+        if (!file->stream_) return nullptr;
+        std::vector<uint8_t> header(64 * 1024);
+        file->stream_.read(reinterpret_cast<char*>(header.data()), header.size());
+        header.resize((size_t)file->stream_.gcount());
+        file->stream_.clear();
+        file->stream_.seekg(0, std::ios::end);
+        size_t fileSize = (size_t)file->stream_.tellg();
+        if (!parseWavHeader(header.data(), header.size(), file->info_)) return nullptr;
+        file->info_.dataSize = std::min(file->info_.dataSize, fileSize - file->info_.dataOffset);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return nullptr;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return nullptr;
+        }
+        void* mapped = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) return nullptr;
+        file->mapped_ = static_cast<const uint8_t*>(mapped);
+        file->mappedSize_ = (size_t)st.st_size;
+        if (!parseWavHeader(file->mapped_, file->mappedSize_, file->info_)) return nullptr;
+        madvise(mapped, file->mappedSize_, MADV_SEQUENTIAL);
+#endif
+        return file;
+    }
+
+    ~WavFile() {
+#if !defined(_WIN32)
+        if (mapped_) munmap(const_cast<uint8_t*>(mapped_), mappedSize_);
+#endif
+    }
+
+    WavFile(const WavFile&) = delete;
+    WavFile& operator=(const WavFile&) = delete;
+
+    const WavInfo& getInfo() const { return info_; }
+    const std::string& getPath() const { return path_; }
+    size_t getFrameCount() const { return info_.frameCount(); }
+
+    // Decode frames [first, first + count) of the first `channels` channels
+    void decode(size_t first, size_t count, float* const* dst, int channels) const {
+        size_t frameBytes = (size_t)(info_.bitsPerSample / 8) * info_.channels;
+#if defined(_WIN32)
+        std::lock_guard<std::mutex> lock(readMutex_);
+        readBuffer_.resize(count * frameBytes);
+        stream_.seekg((std::streamoff)(info_.dataOffset + first * frameBytes));
+        stream_.read(reinterpret_cast<char*>(readBuffer_.data()), readBuffer_.size());
+        decodePcm(readBuffer_.data(), info_.bitsPerSample, info_.channels, count, dst, channels);
+#else
+        decodePcm(mapped_ + info_.dataOffset + first * frameBytes, info_.bitsPerSample,
+                  info_.channels, count, dst, channels);
+#endif
+    }
+
+    // Decoded frames currently held for this file by live streams
+    size_t getBufferBytes() const { return bufferBytes_.load(std::memory_order_relaxed); }
+    uint64_t getUnderruns() const { return underruns_.load(std::memory_order_relaxed); }
+
+private:
+    friend class AudioStream;
+    WavFile() = default;
+
+    std::string path_;
+    WavInfo info_;
+#if defined(_WIN32)
+    mutable std::ifstream stream_;
+    mutable std::mutex readMutex_;
+    mutable std::vector<uint8_t> readBuffer_;
+#else
+    const uint8_t* mapped_ = nullptr;
+    size_t mappedSize_ = 0;
+#endif
+    std::atomic<size_t> bufferBytes_{0};
+    std::atomic<uint64_t> underruns_{0};
+};
+
+// ===== Audio Stream =====
+// One playback of a streamed clip. The streamer thread decodes ahead into a
+// ring, the mixer reads behind it (single producer, single consumer).
+//
+// Frames are addressed in unwrapped stream coordinates: when looping, frame
+// u holds clip frame u % frameCount, so the producer simply keeps decoding
+// across the loop point and the mixer's window straddles it seamlessly.
+class AudioStream {
+public:
+    static constexpr size_t kRingFrames = 16384;  // Per channel, ~0.35 s at 48 kHz
+    static constexpr size_t kChunkFrames = 2048;  // Decoded per step
+
+    // Starts a little before `startFrame` so the resampler has history there
+    AudioStream(std::shared_ptr<WavFile> file, size_t startFrame, bool loop)
+        : file_(std::move(file)), loop_(loop) {
+        channels_ = std::min(file_->getInfo().channels, 2);
+        frameCount_ = file_->getFrameCount();
+        size_t lead = dsp::SincResampler::kHistory;
+        start_ = startFrame > lead ? startFrame - lead : 0;
+        writeFrame_.store(start_, std::memory_order_relaxed);
+        readFrame_.store(start_, std::memory_order_relaxed);
+        for (int c = 0; c < channels_; c++) ring_[c].assign(kRingFrames, 0.0f);
+        file_->bufferBytes_.fetch_add(getBufferBytes(), std::memory_order_relaxed);
+    }
+
+    ~AudioStream() {
+        file_->bufferBytes_.fetch_sub(getBufferBytes(), std::memory_order_relaxed);
+    }
+
+    AudioStream(const AudioStream&) = delete;
+    AudioStream& operator=(const AudioStream&) = delete;
+
+    int getChannels() const { return channels_; }
+    size_t getBufferBytes() const { return kRingFrames * channels_ * sizeof(float); }
+    uint64_t getUnderruns() const { return underruns_.load(std::memory_order_relaxed); }
+
+    // ===== Producer =====
+    // Decodes until the ring is full (or a non-looping clip ends). Returns
+    // the frames written.
+    size_t fill() {
+        if (frameCount_ == 0) return 0;
+        uint64_t write = writeFrame_.load(std::memory_order_relaxed);
+        uint64_t read = readFrame_.load(std::memory_order_acquire);
+        bool loop = loop_.load(std::memory_order_relaxed);
+        if (read > write) write = read;  // Skipped frames are never read
+        size_t written = 0;
+        while (true) {
+            size_t space = kRingFrames - (size_t)(write - read);
+            if (space == 0 || (!loop && write >= frameCount_)) break;
+
+            size_t clipFrame = (size_t)(loop ? write % frameCount_ : write);
+            size_t ringPos = (size_t)(write & (kRingFrames - 1));
+            size_t count = std::min({space, kChunkFrames, frameCount_ - clipFrame, kRingFrames - ringPos});
+            float* dst[2] = {ring_[0].data() + ringPos, channels_ > 1 ? ring_[1].data() + ringPos : nullptr};
+            file_->decode(clipFrame, count, dst, channels_);
+            write += count;
+            written += count;
+            writeFrame_.store(write, std::memory_order_release);
+        }
+        return written;
+    }
+
+    // ===== Consumer =====
+    // Copies unwrapped frames [first, first + count) per channel. Frames
+    // before the start or past the end of a non-looping clip are silent;
+    // frames not decoded yet are silent and counted as an underrun.
+    void read(int64_t first, size_t count, float* const* dst) {
+        int64_t last = first + (int64_t)count;
+        int64_t write = (int64_t)writeFrame_.load(std::memory_order_acquire);
+        int64_t from = std::max<int64_t>(first, (int64_t)readFrame_.load(std::memory_order_relaxed));
+        int64_t end = loop_.load(std::memory_order_relaxed) ? last : std::min<int64_t>(last, (int64_t)frameCount_);
+        int64_t to = std::max(first, std::min(end, write));
+        from = std::min(from, to);
+
+        for (int c = 0; c < channels_; c++) {
+            float* out = dst[c];
+            std::fill(out, out + (from - first), 0.0f);
+            for (int64_t f = from; f < to;) {
+                size_t ringPos = (size_t)(f & (kRingFrames - 1));
+                size_t run = std::min((size_t)(to - f), kRingFrames - ringPos);
+                memcpy(out + (f - first), ring_[c].data() + ringPos, run * sizeof(float));
+                f += run;
+            }
+            std::fill(out + (to - first), out + count, 0.0f);
+        }
+        if (to < end) {
+            underruns_.fetch_add(1, std::memory_order_relaxed);
+            file_->underruns_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Frames before `frame` will not be read again; the producer may reuse
+    // them, or skip ahead when the mixer got past what was decoded
+    void release(int64_t frame) {
+        if (frame > (int64_t)readFrame_.load(std::memory_order_relaxed)) {
+            readFrame_.store((uint64_t)frame, std::memory_order_release);
+        }
+    }
+
+    void setLoop(bool loop) { loop_.store(loop, std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<WavFile> file_;
+    std::vector<float> ring_[2];
+    int channels_ = 1;
+    size_t frameCount_ = 0;
+    uint64_t start_ = 0;
+    std::atomic<uint64_t> writeFrame_{0};  // Next unwrapped frame to decode
+    std::atomic<uint64_t> readFrame_{0};   // Oldest frame the mixer may still read
+    std::atomic<bool> loop_{false};
+    std::atomic<uint64_t> underruns_{0};
+};
+
+// ===== Audio Streamer =====
+// Background thread keeping every live stream's ring topped up. Streams are
+// dropped once the streamer holds the last reference, so their buffers are
+// never freed on the audio thread.
+class AudioStreamer {
+public:
+    AudioStreamer() = default;
+    ~AudioStreamer() { stop(); }
+
+    AudioStreamer(const AudioStreamer&) = delete;
+    AudioStreamer& operator=(const AudioStreamer&) = delete;
+
+    // Fill the first chunks right away, then keep it topped up
+    void add(std::shared_ptr<AudioStream> stream) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stream->fill();
+        streams_.push_back(std::move(stream));
+        if (!thread_.joinable()) {
+            running_ = true;
+            thread_ = std::thread([this] { threadLoop(); });
+        }
+        wake_.notify_one();
+    }
+
+    // Fill every stream now (the thread does the same periodically)
+    void pump() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pumpLocked();
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_ = false;
+            wake_.notify_one();
+        }
+        if (thread_.joinable()) thread_.join();
+        std::lock_guard<std::mutex> lock(mutex_);
+        streams_.clear();
+    }
+
+    size_t getStreamCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return streams_.size();
+    }
+
+private:
+    void pumpLocked() {
+        streams_.erase(
+            std::remove_if(streams_.begin(), streams_.end(),
+                [](const auto& stream) { return stream.use_count() == 1; }),
+            streams_.end()
+        );
+        for (auto& stream : streams_) stream->fill();
+    }
+
+    void threadLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (running_) {
+            pumpLocked();
+            wake_.wait_for(lock, std::chrono::milliseconds(5));
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<std::shared_ptr<AudioStream>> streams_;
+    std::thread thread_;
+    bool running_ = false;
+};
+
+}  // namespace luma
@@ -1,8 +1,9 @@
-// AI Inference Engine - ONNX Runtime integration for neural network inference
+// AI Inference Engine - Neural network inference for character creation
 // Part of LUMA Character Creation System
 #pragma once
 
 #include "engine/foundation/math_types.h"
+#include "engine/character/ai/tensor_runtime.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -12,17 +13,6 @@
 
 namespace luma {
 
-// ============================================================================
-// Forward Declarations (ONNX Runtime types would be in implementation)
-// ============================================================================
-
-// These would be from onnxruntime_cxx_api.h in actual implementation
-namespace onnx {
-    struct Session;
-    struct Env;
-    struct Value;
-}
-
 // ============================================================================
 // Tensor Data Types
 // ============================================================================
@@ -160,13 +150,17 @@ struct ModelInfo {
 };
 
 // ============================================================================
-// Inference Session - Wrapper for ONNX Runtime session
+// Inference Session - Runs a model on the built-in CPU tensor runtime
 // ============================================================================
 
+// Models are .lnn graphs (see nn::Graph); the runtime is compiled on load and
+// again after the thread count or precision changes.
 class InferenceSession {
 public:
-    InferenceSession() = default;
+    InferenceSession() : runtime_(std::make_unique<nn::Runtime>()) {}
     ~InferenceSession() = default;
+    InferenceSession(InferenceSession&&) = default;
+    InferenceSession& operator=(InferenceSession&&) = default;
     
     // Load model from file
     bool loadModel(const std::string& modelPath);
@@ -174,6 +168,9 @@ public:
     // Load model from memory
     bool loadModelFromMemory(const void* data, size_t size);
     
+    // Use a network built in code
+    bool loadGraph(nn::Graph graph, const std::string& name = "graph");
+    
     // Get model info
     const ModelInfo& getModelInfo() const { return modelInfo_; }
     
@@ -189,61 +186,108 @@ public:
     Tensor runSingle(const Tensor& input);
     
     // Configuration
-    void setNumThreads(int threads) { numThreads_ = threads; }
-    void enableGPU(bool enable) { useGPU_ = enable; }
-    void enableCoreML(bool enable) { useCoreML_ = enable; }
+    void setNumThreads(int threads) { numThreads_ = threads; dirty_ = true; }
+    void enableInt8(bool enable) { useInt8_ = enable; dirty_ = true; }
+    void enableGPU(bool enable) { useGPU_ = enable; }        // CPU only for now
+    void enableCoreML(bool enable) { useCoreML_ = enable; }  // CPU only for now
     
     // State
     bool isLoaded() const { return isLoaded_; }
     const std::string& getLastError() const { return lastError_; }
+    const nn::RuntimeStats& getRuntimeStats() const { return runtime_->getStats(); }
     
 private:
+    bool finishLoad(const std::string& name);
+    bool prepare();
+    
     bool isLoaded_ = false;
+    bool dirty_ = true;
     ModelInfo modelInfo_;
     std::string lastError_;
+    nn::Graph graph_;
+    std::unique_ptr<nn::Runtime> runtime_;
     
     // Configuration
     int numThreads_ = 4;
+    bool useInt8_ = false;
     bool useGPU_ = false;
     bool useCoreML_ = false;
-    
-    // ONNX Runtime internals would be here
-    // std::unique_ptr<Ort::Session> session_;
-    // std::unique_ptr<Ort::Env> env_;
 };
 
 // ============================================================================
-// Implementation Placeholder
-// (Actual implementation would use ONNX Runtime C++ API)
+// Implementation
 // ============================================================================
 
 inline bool InferenceSession::loadModel(const std::string& modelPath) {
-    // Placeholder implementation
-    // In real code, this would:
-    // 1. Create Ort::Env
-    // 2. Create Ort::SessionOptions with execution providers
-    // 3. Create Ort::Session from model path
-    // 4. Extract input/output info
-    
+    modelInfo_ = ModelInfo();
     modelInfo_.path = modelPath;
+    isLoaded_ = false;
+    if (!graph_.load(modelPath, &lastError_)) {
+        return false;
+    }
     
     // Extract model name from path
     size_t lastSlash = modelPath.find_last_of("/\\");
+    size_t start = lastSlash == std::string::npos ? 0 : lastSlash + 1;
     size_t lastDot = modelPath.find_last_of('.');
-    modelInfo_.name = modelPath.substr(lastSlash + 1, lastDot - lastSlash - 1);
+    if (lastDot == std::string::npos || lastDot < start) lastDot = modelPath.size();
+    return finishLoad(modelPath.substr(start, lastDot - start));
+}
+
+inline bool InferenceSession::loadModelFromMemory(const void* data, size_t size) {
+    modelInfo_ = ModelInfo();
+    isLoaded_ = false;
+    if (!graph_.loadFromMemory(data, size, &lastError_)) {
+        return false;
+    }
+    return finishLoad("memory");
+}
+
+inline bool InferenceSession::loadGraph(nn::Graph graph, const std::string& name) {
+    modelInfo_ = ModelInfo();
+    isLoaded_ = false;
+    if (!graph.valid()) {
+        lastError_ = graph.getError().empty() ? "Graph has no outputs" : graph.getError();
+        return false;
+    }
+    graph_ = std::move(graph);
+    return finishLoad(name);
+}
+
+inline bool InferenceSession::finishLoad(const std::string& name) {
+    modelInfo_.name = name;
+    
+    auto toDims = [](nn::Shape shape) {
+        if (shape.h == 1 && shape.w == 1) return std::vector<int64_t>{1, shape.c};
+        return std::vector<int64_t>{1, shape.c, shape.h, shape.w};
+    };
+    modelInfo_.inputs.push_back({"input", toDims(graph_.getShape(0)), TensorDataType::Float32});
+    for (size_t i = 0; i < graph_.getOutputs().size(); i++) {
+        modelInfo_.outputs.push_back({"output" + std::to_string(i),
+                                      toDims(graph_.getShape(graph_.getOutputs()[i])),
+                                      TensorDataType::Float32});
+    }
     
-    // Check if file exists (simplified)
-    // In real implementation, would actually load the model
+    dirty_ = true;
+    if (!prepare()) return false;
     
-    isLoaded_ = true;  // Placeholder
+    const nn::RuntimeStats& stats = runtime_->getStats();
+    size_t bytes = stats.arenaBytes + stats.scratchBytes + stats.weightBytes;
+    modelInfo_.estimatedMemoryMB = (bytes + (1 << 20) - 1) >> 20;
+    isLoaded_ = true;
     return true;
 }
 
-inline bool InferenceSession::loadModelFromMemory(const void* data, size_t size) {
-    (void)data;
-    (void)size;
-    // Would use Ort::Session constructor with memory buffer
-    isLoaded_ = true;
+inline bool InferenceSession::prepare() {
+    if (!dirty_) return true;
+    nn::RuntimeOptions options;
+    options.threads = numThreads_;
+    options.int8 = useInt8_;
+    if (!runtime_->compile(graph_, options)) {
+        lastError_ = runtime_->getError();
+        return false;
+    }
+    dirty_ = false;
     return true;
 }
 
@@ -252,15 +296,20 @@ inline bool InferenceSession::run(const std::vector<Tensor>& inputs, std::vector
         lastError_ = "Model not loaded";
         return false;
     }
+    if (inputs.size() != 1 || inputs[0].dtype() != TensorDataType::Float32 ||
+        inputs[0].numElements() != runtime_->getInputShape().size()) {
+        lastError_ = "Expected one float input of " + std::to_string(runtime_->getInputShape().size()) + " elements";
+        return false;
+    }
+    if (!prepare() || !runtime_->run(inputs[0].dataAs<float>())) {
+        lastError_ = runtime_->getError();
+        return false;
+    }
     
-    // Placeholder: copy inputs to outputs
-    outputs = inputs;
-    
-    // Real implementation would:
-    // 1. Create Ort::Value for each input tensor
-    // 2. Call session->Run()
-    // 3. Copy output Ort::Value to output tensors
-    
+    outputs.clear();
+    for (size_t i = 0; i < runtime_->getOutputCount(); i++) {
+        outputs.push_back(Tensor::fromData(modelInfo_.outputs[i].shape, runtime_->getOutput(i)));
+    }
     return true;
 }
 
@@ -312,6 +361,7 @@ public:
     // Load a model
     bool loadModel(const std::string& modelId, const std::string& path) {
         auto session = std::make_unique<InferenceSession>();
+        session->setNumThreads(defaultNumThreads_);
         if (session->loadModel(path)) {
             sessions_[modelId] = std::move(session);
             return true;
@@ -47,7 +47,7 @@ struct ModelRegistry {
         AIModelInfo info;
         info.name = "Face Detector";
         info.description = "MediaPipe-compatible face detection model";
-        info.filename = "face_detection_short_range.onnx";
+        info.filename = "face_detection_short_range.lnn";
         info.downloadUrl = ""; // User must provide
         info.expectedSize = 0;
         info.required = true;
@@ -59,7 +59,7 @@ struct ModelRegistry {
         AIModelInfo info;
         info.name = "Face Mesh";
         info.description = "MediaPipe Face Mesh - 468 3D landmarks";
-        info.filename = "face_landmark.onnx";
+        info.filename = "face_landmark.lnn";
         info.downloadUrl = "";
         info.expectedSize = 0;
         info.required = true;
@@ -71,7 +71,7 @@ struct ModelRegistry {
         AIModelInfo info;
         info.name = "3DMM Regressor";
         info.description = "DECA/EMOCA compatible 3D Morphable Model";
-        info.filename = "deca_model.onnx";
+        info.filename = "deca_model.lnn";
         info.downloadUrl = "";
         info.expectedSize = 0;
         info.required = false;  // Can use landmarks-only fallback
@@ -83,7 +83,7 @@ struct ModelRegistry {
         AIModelInfo info;
         info.name = "Face Recognition";
         info.description = "Face embedding model for identity preservation";
-        info.filename = "arcface_model.onnx";
+        info.filename = "arcface_model.lnn";
         info.downloadUrl = "";
         info.expectedSize = 0;
         info.required = false;
@@ -141,6 +141,17 @@ public:
         return true;
     }
     
+    // Initialize with a network built in code (same input / output layout)
+    bool initialize(nn::Graph graph) {
+        if (!session_.loadGraph(std::move(graph))) {
+            return false;
+        }
+        initialized_ = true;
+        return true;
+    }
+    
+    InferenceSession& getSession() { return session_; }
+    
     // Detect faces in image
     // Returns list of detected faces
     std::vector<FaceDetection> detect(const uint8_t* imageData, int width, int height, int channels) {
@@ -168,12 +179,20 @@ public:
         // Run inference
         Tensor output = session_.runSingle(input);
         
-        // Parse output (would depend on specific model format)
-        // For now, return dummy result
+        // Single-face regression head: [score logit, x0, y0, x1, y1] and
+        // optionally six (x, y) keypoints, all normalized to the image
+        if (output.numElements() < 5) return results;
+        const float* data = output.dataAs<float>();
         FaceDetection det;
-        det.bboxMin = Vec2(0.2f, 0.1f);
-        det.bboxMax = Vec2(0.8f, 0.9f);
-        det.confidence = 0.95f;
+        det.confidence = 1.0f / (1.0f + std::exp(-data[0]));
+        if (det.confidence < MIN_CONFIDENCE) return results;
+        det.bboxMin = Vec2(std::min(data[1], data[3]), std::min(data[2], data[4]));
+        det.bboxMax = Vec2(std::max(data[1], data[3]), std::max(data[2], data[4]));
+        if (output.numElements() >= 17) {
+            Vec2* keypoints[] = {&det.leftEye, &det.rightEye, &det.nose, &det.mouth, &det.leftEar, &det.rightEar};
+            for (int i = 0; i < 6; i++) *keypoints[i] = Vec2(data[5 + i * 2], data[6 + i * 2]);
+            det.roll = std::atan2(det.rightEye.y - det.leftEye.y, det.rightEye.x - det.leftEye.x);
+        }
         results.push_back(det);
         
         return results;
@@ -199,6 +218,7 @@ public:
     
 private:
     static constexpr int INPUT_SIZE = 320;
+    static constexpr float MIN_CONFIDENCE = 0.5f;
     
     bool initialized_ = false;
     std::string modelPath_;
@@ -223,6 +243,17 @@ public:
         return true;
     }
     
+    // Initialize with a network built in code (same input / output layout)
+    bool initialize(nn::Graph graph) {
+        if (!session_.loadGraph(std::move(graph))) {
+            return false;
+        }
+        initialized_ = true;
+        return true;
+    }
+    
+    InferenceSession& getSession() { return session_; }
+    
     // Estimate face mesh from cropped face image
     bool estimate(const uint8_t* faceImageData, int width, int height, int channels,
                   FaceLandmarks& outLandmarks) {
@@ -239,10 +270,14 @@ public:
             INPUT_SIZE, INPUT_SIZE, true, true);
         
         // Run inference
-        Tensor output = session_.runSingle(input);
+        std::vector<Tensor> outputs;
+        if (!session_.run({input}, outputs) || outputs.empty() ||
+            outputs[0].numElements() < FACE_MESH_LANDMARK_COUNT * 3) {
+            return false;
+        }
         
-        // Parse output (468 x 3 coordinates)
-        const float* data = output.dataAs<float>();
+        // Parse output (468 x 3 coordinates, in input pixels)
+        const float* data = outputs[0].dataAs<float>();
         for (int i = 0; i < FACE_MESH_LANDMARK_COUNT; i++) {
             outLandmarks.points[i] = Vec3(
                 data[i * 3 + 0],
@@ -250,7 +285,12 @@ public:
                 data[i * 3 + 2]
             );
         }
+        
+        // Optional second output: face presence logit
         outLandmarks.confidence = 0.95f;
+        if (outputs.size() > 1 && outputs[1].numElements() > 0) {
+            outLandmarks.confidence = 1.0f / (1.0f + std::exp(-outputs[1].getValue<float>()));
+        }
         
         return true;
     }
@@ -403,6 +443,17 @@ public:
         return true;
     }
     
+    // Initialize with a network built in code (same input / output layout)
+    bool initialize(nn::Graph graph) {
+        if (!session_.loadGraph(std::move(graph))) {
+            return false;
+        }
+        initialized_ = true;
+        return true;
+    }
+    
+    InferenceSession& getSession() { return session_; }
+    
     // Regress 3DMM parameters from face image
     bool regress(const uint8_t* faceImageData, int width, int height, int channels,
                  FLAME3DMMParams& outParams) {
@@ -420,6 +471,9 @@ public:
         
         // Run inference
         Tensor output = session_.runSingle(input);
+        if (output.numElements() < 156) {
+            return false;
+        }
         
         // Parse output (model-specific format)
         // Typically concatenated: [shape, expression, pose, texture, lighting]
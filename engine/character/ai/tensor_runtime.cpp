@@ -0,0 +1,1225 @@
+// Tensor Runtime Implementation
+#include "tensor_runtime.h"
+#include "engine/foundation/worker_pool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define LUMA_NN_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define LUMA_NN_AVX2_TARGET
+#else
+#define LUMA_NN_AVX2_TARGET __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+namespace luma {
+namespace nn {
+
+// ===== Graph Building =====
+
+bool Graph::fail(const std::string& message) {
+    if (error_.empty()) error_ = message;
+    return false;
+}
+
+bool Graph::check(int value) {
+    if (value < 0 || value >= (int)shapes_.size()) return fail("invalid value id " + std::to_string(value));
+    return true;
+}
+
+int Graph::addNode(Node node, Shape shape) {
+    if (shape.c <= 0 || shape.h <= 0 || shape.w <= 0) {
+        fail("layer " + std::to_string(nodes_.size()) + " produces an empty tensor");
+        return -1;
+    }
+    node.output = (int)shapes_.size();
+    nodes_.push_back(std::move(node));
+    shapes_.push_back(shape);
+    return (int)shapes_.size() - 1;
+}
+
+// Output extent of a sliding window, or 0 if the kernel does not fit the
+// padded input (integer division would otherwise round that up to a size)
+static int windowExtent(int in, int kernel, int stride, int pad) {
+    int64_t padded = (int64_t)in + 2 * (int64_t)pad;
+    if (padded < kernel) return 0;
+    int64_t extent = (padded - kernel) / stride + 1;
+    return extent > INT32_MAX ? 0 : (int)extent;
+}
+
+static bool validActivation(Activation activation, const std::vector<float>& slopes, int channels) {
+    return activation != Activation::PReLU || (int)slopes.size() == channels;
+}
+
+int Graph::input(Shape shape) {
+    if (!shapes_.empty()) {
+        fail("graph already has an input");
+        return -1;
+    }
+    if (shape.size() == 0) {
+        fail("input shape is empty");
+        return -1;
+    }
+    shapes_.push_back(shape);
+    return 0;
+}
+
+int Graph::conv(int x, int outChannels, int kernel, int stride, int pad,
+                std::vector<float> weights, std::vector<float> bias,
+                Activation activation, std::vector<float> slopes) {
+    if (!check(x)) return -1;
+    Shape in = shapes_[x];
+    if (outChannels <= 0 || kernel <= 0 || stride <= 0 || pad < 0 ||
+        weights.size() != (size_t)outChannels * in.c * kernel * kernel ||
+        (!bias.empty() && bias.size() != (size_t)outChannels) ||
+        !validActivation(activation, slopes, outChannels)) {
+        fail("conv layer " + std::to_string(nodes_.size()) + " has mismatched parameters");
+        return -1;
+    }
+    Node node;
+    node.type = OpType::Conv2D;
+    node.activation = activation;
+    node.inputs[0] = x;
+    node.kernel = kernel;
+    node.stride = stride;
+    node.pad = pad;
+    node.weights = std::move(weights);
+    node.bias = std::move(bias);
+    node.slopes = std::move(slopes);
+    Shape out{outChannels, windowExtent(in.h, kernel, stride, pad), windowExtent(in.w, kernel, stride, pad)};
+    if (out.h == 0 || out.w == 0) {
+        fail("conv layer " + std::to_string(nodes_.size()) + " has a kernel larger than its padded input");
+        return -1;
+    }
+    return addNode(std::move(node), out);
+}
+
+int Graph::depthwise(int x, int kernel, int stride, int pad,
+                     std::vector<float> weights, std::vector<float> bias,
+                     Activation activation, std::vector<float> slopes) {
+    if (!check(x)) return -1;
+    Shape in = shapes_[x];
+    if (kernel <= 0 || stride <= 0 || pad < 0 ||
+        weights.size() != (size_t)in.c * kernel * kernel ||
+        (!bias.empty() && bias.size() != (size_t)in.c) ||
+        !validActivation(activation, slopes, in.c)) {
+        fail("depthwise layer " + std::to_string(nodes_.size()) + " has mismatched parameters");
+        return -1;
+    }
+    Node node;
+    node.type = OpType::Conv2D;
+    node.activation = activation;
+    node.inputs[0] = x;
+    node.kernel = kernel;
+    node.stride = stride;
+    node.pad = pad;
+    node.groups = in.c;
+    node.weights = std::move(weights);
+    node.bias = std::move(bias);
+    node.slopes = std::move(slopes);
+    Shape out{in.c, windowExtent(in.h, kernel, stride, pad), windowExtent(in.w, kernel, stride, pad)};
+    if (out.h == 0 || out.w == 0) {
+        fail("depthwise layer " + std::to_string(nodes_.size()) + " has a kernel larger than its padded input");
+        return -1;
+    }
+    return addNode(std::move(node), out);
+}
+
+int Graph::dense(int x, int outputs, std::vector<float> weights, std::vector<float> bias,
+                 Activation activation, std::vector<float> slopes) {
+    if (!check(x)) return -1;
+    size_t in = shapes_[x].size();
+    if (outputs <= 0 || weights.size() != (size_t)outputs * in ||
+        (!bias.empty() && bias.size() != (size_t)outputs) ||
+        !validActivation(activation, slopes, outputs)) {
+        fail("dense layer " + std::to_string(nodes_.size()) + " has mismatched parameters");
+        return -1;
+    }
+    Node node;
+    node.type = OpType::Dense;
+    node.activation = activation;
+    node.inputs[0] = x;
+    node.weights = std::move(weights);
+    node.bias = std::move(bias);
+    node.slopes = std::move(slopes);
+    return addNode(std::move(node), Shape{outputs, 1, 1});
+}
+
+int Graph::add(int a, int b, Activation activation) {
+    if (!check(a) || !check(b)) return -1;
+    if (!(shapes_[a] == shapes_[b]) || activation == Activation::PReLU) {
+        fail("add layer " + std::to_string(nodes_.size()) + " has mismatched inputs");
+        return -1;
+    }
+    Node node;
+    node.type = OpType::Add;
+    node.activation = activation;
+    node.inputs[0] = a;
+    node.inputs[1] = b;
+    return addNode(std::move(node), shapes_[a]);
+}
+
+int Graph::maxPool(int x, int kernel, int stride) {
+    if (!check(x)) return -1;
+    if (kernel <= 0 || stride <= 0) {
+        fail("pool layer " + std::to_string(nodes_.size()) + " has mismatched parameters");
+        return -1;
+    }
+    Shape in = shapes_[x];
+    Node node;
+    node.type = OpType::MaxPool;
+    node.inputs[0] = x;
+    node.kernel = kernel;
+    node.stride = stride;
+    Shape out{in.c, windowExtent(in.h, kernel, stride, 0), windowExtent(in.w, kernel, stride, 0)};
+    if (out.h == 0 || out.w == 0) {
+        fail("pool layer " + std::to_string(nodes_.size()) + " has a kernel larger than its input");
+        return -1;
+    }
+    return addNode(std::move(node), out);
+}
+
+int Graph::globalAvgPool(int x) {
+    if (!check(x)) return -1;
+    Node node;
+    node.type = OpType::GlobalAvgPool;
+    node.inputs[0] = x;
+    return addNode(std::move(node), Shape{shapes_[x].c, 1, 1});
+}
+
+size_t Graph::getWeightCount() const {
+    size_t count = 0;
+    for (const Node& node : nodes_) count += node.weights.size() + node.bias.size() + node.slopes.size();
+    return count;
+}
+
+uint64_t Graph::getMacCount() const {
+    uint64_t macs = 0;
+    for (const Node& node : nodes_) {
+        Shape out = shapes_[node.output];
+        if (node.type == OpType::Conv2D) {
+            uint64_t perOutput = node.weights.size() / out.c;
+            macs += perOutput * out.size();
+        } else if (node.type == OpType::Dense) {
+            macs += node.weights.size();
+        }
+    }
+    return macs;
+}
+
+// ===== Model File =====
+// "LNN1", version, input shape, nodes (type, activation, inputs, outputs,
+// kernel, stride, pad, groups, weights, bias, slopes), output ids. All
+// little-endian.
+
+namespace {
+
+constexpr char kMagic[4] = {'L', 'N', 'N', '1'};
+constexpr uint32_t kVersion = 1;
+
+struct Writer {
+    std::vector<uint8_t> bytes;
+
+    template<typename T>
+    void put(T value) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+        bytes.insert(bytes.end(), p, p + sizeof(T));
+    }
+    void putFloats(const std::vector<float>& values) {
+        put<uint32_t>((uint32_t)values.size());
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(values.data());
+        bytes.insert(bytes.end(), p, p + values.size() * sizeof(float));
+    }
+};
+
+struct Reader {
+    const uint8_t* data;
+    size_t size;
+    size_t at = 0;
+    bool ok = true;
+
+    template<typename T>
+    T get() {
+        T value{};
+        if (at + sizeof(T) > size) {
+            ok = false;
+            return value;
+        }
+        std::memcpy(&value, data + at, sizeof(T));
+        at += sizeof(T);
+        return value;
+    }
+    std::vector<float> getFloats() {
+        uint32_t count = get<uint32_t>();
+        std::vector<float> values;
+        if (!ok || (size - at) / sizeof(float) < count) {
+            ok = false;
+            return values;
+        }
+        if (count == 0) return values;  // data() may be null; memcpy must not see it
+        values.resize(count);
+        std::memcpy(values.data(), data + at, count * sizeof(float));
+        at += count * sizeof(float);
+        return values;
+    }
+};
+
+}  // namespace
+
+bool Graph::save(const std::string& path) const {
+    if (!valid()) return false;
+    Writer w;
+    w.bytes.insert(w.bytes.end(), kMagic, kMagic + 4);
+    w.put<uint32_t>(kVersion);
+    w.put<int32_t>(shapes_[0].c);
+    w.put<int32_t>(shapes_[0].h);
+    w.put<int32_t>(shapes_[0].w);
+    w.put<uint32_t>((uint32_t)nodes_.size());
+    for (const Node& node : nodes_) {
+        w.put<uint8_t>((uint8_t)node.type);
+        w.put<uint8_t>((uint8_t)node.activation);
+        w.put<int32_t>(node.inputs[0]);
+        w.put<int32_t>(node.inputs[1]);
+        w.put<int32_t>(shapes_[node.output].c);
+        w.put<int32_t>(node.kernel);
+        w.put<int32_t>(node.stride);
+        w.put<int32_t>(node.pad);
+        w.put<int32_t>(node.groups);
+        w.putFloats(node.weights);
+        w.putFloats(node.bias);
+        w.putFloats(node.slopes);
+    }
+    w.put<uint32_t>((uint32_t)outputs_.size());
+    for (int output : outputs_) w.put<int32_t>(output);
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+    file.write(reinterpret_cast<const char*>(w.bytes.data()), (std::streamsize)w.bytes.size());
+    return (bool)file;
+}
+
+bool Graph::load(const std::string& path, std::string* error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        if (error) *error = "Cannot open " + path;
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return loadFromMemory(bytes.data(), bytes.size(), error);
+}
+
+bool Graph::loadFromMemory(const void* data, size_t size, std::string* error) {
+    *this = Graph();
+    Reader r{static_cast<const uint8_t*>(data), size};
+    auto reject = [&](const std::string& message) {
+        if (error) *error = message;
+        *this = Graph();
+        return false;
+    };
+
+    if (size < 8 || std::memcmp(data, kMagic, 4) != 0) {
+        return reject("Not a LUMA network (.lnn) file; ONNX models must be converted first");
+    }
+    r.at = 4;
+    if (r.get<uint32_t>() != kVersion) return reject("Unsupported .lnn version");
+
+    Shape in;
+    in.c = r.get<int32_t>();
+    in.h = r.get<int32_t>();
+    in.w = r.get<int32_t>();
+    uint32_t nodeCount = r.get<uint32_t>();
+    if (!r.ok || in.c <= 0 || in.h <= 0 || in.w <= 0) return reject("Truncated .lnn header");
+    input(in);
+
+    // Rebuilt through the builder so shapes and parameter counts are validated
+    for (uint32_t i = 0; i < nodeCount && r.ok && error_.empty(); i++) {
+        auto type = (OpType)r.get<uint8_t>();
+        auto activation = (Activation)r.get<uint8_t>();
+        int a = r.get<int32_t>();
+        int b = r.get<int32_t>();
+        int outChannels = r.get<int32_t>();
+        int kernel = r.get<int32_t>();
+        int stride = r.get<int32_t>();
+        int pad = r.get<int32_t>();
+        int groups = r.get<int32_t>();
+        std::vector<float> weights = r.getFloats();
+        std::vector<float> bias = r.getFloats();
+        std::vector<float> slopes = r.getFloats();
+        if (!r.ok) break;
+        if ((uint8_t)activation > (uint8_t)Activation::PReLU) return reject("Unknown activation in .lnn");
+
+        switch (type) {
+            case OpType::Conv2D:
+                if (groups == 1) {
+                    conv(a, outChannels, kernel, stride, pad, std::move(weights), std::move(bias), activation, std::move(slopes));
+                } else if (check(a) && groups == shapes_[a].c && outChannels == groups) {
+                    depthwise(a, kernel, stride, pad, std::move(weights), std::move(bias), activation, std::move(slopes));
+                } else {
+                    return reject("Grouped convolutions other than depthwise are not supported");
+                }
+                break;
+            case OpType::Dense:
+                dense(a, outChannels, std::move(weights), std::move(bias), activation, std::move(slopes));
+                break;
+            case OpType::Add: add(a, b, activation); break;
+            case OpType::MaxPool: maxPool(a, kernel, stride); break;
+            case OpType::GlobalAvgPool: globalAvgPool(a); break;
+            default: return reject("Unknown layer type in .lnn");
+        }
+    }
+    uint32_t outputCount = r.get<uint32_t>();
+    for (uint32_t i = 0; i < outputCount && r.ok; i++) {
+        int id = r.get<int32_t>();
+        if (check(id)) output(id);
+    }
+    if (!r.ok) return reject("Truncated .lnn file");
+    if (!valid()) return reject(error_.empty() ? "Network has no outputs" : error_);
+    return true;
+}
+
+// ===== Kernels =====
+
+namespace {
+
+constexpr int kPanelRows = 4;       // Output channels per GEMM panel
+constexpr int kTileCols = 16;       // Columns per register tile
+constexpr int kColumnBlock = 256;   // Columns kept cache-resident across panels
+
+inline float activate(float v, Activation activation, float slope) {
+    switch (activation) {
+        case Activation::None: return v;
+        case Activation::ReLU: return v > 0.0f ? v : 0.0f;
+        case Activation::ReLU6: return std::min(std::max(v, 0.0f), 6.0f);
+        case Activation::PReLU: return v > 0.0f ? v : v * slope;
+    }
+    return v;
+}
+
+// Bias, per-row scale (int8 dequantization) and activation, applied to
+// finished accumulators
+struct Epilogue {
+    const float* bias;      // Padded to whole panels
+    const float* slopes;    // Padded to whole panels
+    const float* scale;     // int8 only: weight scale per row
+    float inputScale;       // int8 only
+    Activation activation;
+};
+
+// Weights packed as panels of kPanelRows rows, interleaved per k:
+// panel p, column k, row r lives at [(p * K + k) * kPanelRows + r]
+std::vector<float> packPanels(const float* weights, int M, int K) {
+    int panels = (M + kPanelRows - 1) / kPanelRows;
+    std::vector<float> packed((size_t)panels * K * kPanelRows, 0.0f);
+    for (int m = 0; m < M; m++) {
+        int p = m / kPanelRows, r = m % kPanelRows;
+        for (int k = 0; k < K; k++) packed[((size_t)p * K + k) * kPanelRows + r] = weights[(size_t)m * K + k];
+    }
+    return packed;
+}
+
+// int8 weights, symmetric per output channel, as (k, k + 1) int16 pairs in
+// one int32 so a single broadcast feeds the 16-bit multiply-add:
+// panel p, pair q, row r lives at [(p * pairs + q) * kPanelRows + r]
+std::vector<int32_t> packPanelsInt8(const float* weights, int M, int K, std::vector<float>& scales) {
+    int panels = (M + kPanelRows - 1) / kPanelRows;
+    int pairs = (K + 1) / 2;
+    scales.assign((size_t)panels * kPanelRows, 0.0f);
+    std::vector<int32_t> packed((size_t)panels * pairs * kPanelRows, 0);
+    for (int m = 0; m < M; m++) {
+        const float* row = weights + (size_t)m * K;
+        float maxAbs = 0.0f;
+        for (int k = 0; k < K; k++) maxAbs = std::max(maxAbs, std::abs(row[k]));
+        float scale = maxAbs > 0.0f ? maxAbs / 127.0f : 1.0f;
+        scales[m] = scale;
+        int p = m / kPanelRows, r = m % kPanelRows;
+        for (int q = 0; q < pairs; q++) {
+            int k = q * 2;
+            auto lo = (int16_t)std::lround(row[k] / scale);
+            auto hi = (int16_t)(k + 1 < K ? std::lround(row[k + 1] / scale) : 0);
+            packed[((size_t)p * pairs + q) * kPanelRows + r] = (int32_t)((uint32_t)(uint16_t)lo | ((uint32_t)(uint16_t)hi << 16));
+        }
+    }
+    return packed;
+}
+
+inline void storeRow(float* C, size_t ldc, int M, int m, int n, const float* values, int count,
+                     const Epilogue& e, float rowScale) {
+    if (m >= M) return;
+    float bias = e.bias[m];
+    float slope = e.slopes[m];
+    float* out = C + (size_t)m * ldc + n;
+    for (int i = 0; i < count; i++) out[i] = activate(values[i] * rowScale + bias, e.activation, slope);
+}
+
+// C[m][n] = act(A[m] . B[:, n] + bias[m]) for the panels [p0, p1).
+// B is K x N with row stride ldb; C has row stride ldc.
+void gemmScalar(int p0, int p1, const float* A, const float* B, size_t ldb, int M, int K, int N,
+                float* C, size_t ldc, const Epilogue& e) {
+    for (int nb = 0; nb < N; nb += kColumnBlock) {
+        int ne = std::min(N, nb + kColumnBlock);
+        for (int p = p0; p < p1; p++) {
+            const float* panel = A + (size_t)p * K * kPanelRows;
+            for (int n = nb; n < ne; n += kTileCols) {
+                int cols = std::min(kTileCols, ne - n);
+                float acc[kPanelRows][kTileCols] = {};
+                for (int k = 0; k < K; k++) {
+                    const float* b = B + (size_t)k * ldb + n;
+                    const float* a = panel + (size_t)k * kPanelRows;
+                    for (int r = 0; r < kPanelRows; r++) {
+                        for (int j = 0; j < cols; j++) acc[r][j] += a[r] * b[j];
+                    }
+                }
+                for (int r = 0; r < kPanelRows; r++) storeRow(C, ldc, M, p * kPanelRows + r, n, acc[r], cols, e, 1.0f);
+            }
+        }
+    }
+}
+
+// Same with int8 weights and activations. B holds pairs of rows
+// interleaved: (k, n) lives at [((k / 2) * N + n) * 2 + k % 2].
+void gemmInt8Scalar(int p0, int p1, const int32_t* A, const int8_t* B, int M, int K, int N,
+                    float* C, size_t ldc, const Epilogue& e) {
+    int pairs = (K + 1) / 2;
+    for (int nb = 0; nb < N; nb += kColumnBlock) {
+        int ne = std::min(N, nb + kColumnBlock);
+        for (int p = p0; p < p1; p++) {
+            const int32_t* panel = A + (size_t)p * pairs * kPanelRows;
+            for (int n = nb; n < ne; n += kTileCols) {
+                int cols = std::min(kTileCols, ne - n);
+                int32_t acc[kPanelRows][kTileCols] = {};
+                for (int q = 0; q < pairs; q++) {
+                    const int8_t* b = B + ((size_t)q * N + n) * 2;
+                    const int32_t* a = panel + (size_t)q * kPanelRows;
+                    for (int r = 0; r < kPanelRows; r++) {
+                        int32_t lo = (int16_t)(a[r] & 0xFFFF), hi = (int16_t)((uint32_t)a[r] >> 16);
+                        for (int j = 0; j < cols; j++) acc[r][j] += lo * b[j * 2] + hi * b[j * 2 + 1];
+                    }
+                }
+                for (int r = 0; r < kPanelRows; r++) {
+                    int m = p * kPanelRows + r;
+                    if (m >= M) break;
+                    float values[kTileCols];
+                    for (int j = 0; j < cols; j++) values[j] = (float)acc[r][j];
+                    storeRow(C, ldc, M, m, n, values, cols, e, e.scale[m] * e.inputScale);
+                }
+            }
+        }
+    }
+}
+
+// ===== Elementwise Kernels =====
+
+// Rounds half to even, like the AVX2 conversion, so both paths quantize
+// identically
+inline int8_t quantize(float v, float invScale) {
+    return (int8_t)std::min(std::max(std::nearbyint(v * invScale), -127.0f), 127.0f);
+}
+
+float maxAbsScalar(const float* values, size_t count) {
+    float result = 0.0f;
+    for (size_t i = 0; i < count; i++) result = std::max(result, std::abs(values[i]));
+    return result;
+}
+
+void quantizeScalar(const float* src, int8_t* dst, size_t count, float invScale) {
+    for (size_t i = 0; i < count; i++) dst[i] = quantize(src[i], invScale);
+}
+
+// Two rows of `count` values into (row0[n], row1[n]) int8 pairs
+void quantizePairsScalar(const float* row0, const float* row1, int8_t* dst, size_t count, float invScale) {
+    for (size_t n = 0; n < count; n++) {
+        dst[n * 2] = quantize(row0[n], invScale);
+        dst[n * 2 + 1] = quantize(row1[n], invScale);
+    }
+}
+
+void addScalar(const float* a, const float* b, float* out, size_t count, Activation activation) {
+    for (size_t i = 0; i < count; i++) out[i] = activate(a[i] + b[i], activation, 0.0f);
+}
+
+// One depthwise channel: each tap adds a shifted input row to the output row
+void depthwiseScalar(const float* plane, Shape is, float* dst, Shape os, const float* w,
+                     int k, int s, int pad, float bias, Activation activation, float slope) {
+    for (int oy = 0; oy < os.h; oy++) {
+        float* row = dst + (size_t)oy * os.w;
+        std::fill(row, row + os.w, bias);
+        for (int ky = 0; ky < k; ky++) {
+            int iy = oy * s - pad + ky;
+            if (iy < 0 || iy >= is.h) continue;
+            const float* src = plane + (size_t)iy * is.w;
+            for (int kx = 0; kx < k; kx++) {
+                float weight = w[ky * k + kx];
+                int lo = std::max(0, (pad - kx + s - 1) / s);
+                int hi = std::min(os.w, (is.w - 1 + pad - kx) / s + 1);
+                for (int ox = lo; ox < hi; ox++) row[ox] += weight * src[ox * s + kx - pad];
+            }
+        }
+        if (activation != Activation::None) {
+            for (int ox = 0; ox < os.w; ox++) row[ox] = activate(row[ox], activation, slope);
+        }
+    }
+}
+
+#if defined(LUMA_NN_X86)
+
+LUMA_NN_AVX2_TARGET
+inline __m256 activate8(__m256 v, Activation activation, __m256 slope) {
+    switch (activation) {
+        case Activation::None: return v;
+        case Activation::ReLU: return _mm256_max_ps(v, _mm256_setzero_ps());
+        case Activation::ReLU6: return _mm256_min_ps(_mm256_max_ps(v, _mm256_setzero_ps()), _mm256_set1_ps(6.0f));
+        case Activation::PReLU: {
+            __m256 negative = _mm256_mul_ps(_mm256_min_ps(v, _mm256_setzero_ps()), slope);
+            return _mm256_add_ps(_mm256_max_ps(v, _mm256_setzero_ps()), negative);
+        }
+    }
+    return v;
+}
+
+// 4 x 16 register tile: 8 accumulators, two B loads and four broadcasts
+// per k
+LUMA_NN_AVX2_TARGET
+void gemmAvx2(int p0, int p1, const float* A, const float* B, size_t ldb, int M, int K, int N,
+              float* C, size_t ldc, const Epilogue& e) {
+    for (int nb = 0; nb < N; nb += kColumnBlock) {
+        int ne = std::min(N, nb + kColumnBlock);
+        for (int p = p0; p < p1; p++) {
+            const float* panel = A + (size_t)p * K * kPanelRows;
+            int n = nb;
+            for (; n + kTileCols <= ne; n += kTileCols) {
+                // Spelled out so the tile stays in registers without -O3
+                __m256 c00 = _mm256_setzero_ps(), c01 = c00, c10 = c00, c11 = c00;
+                __m256 c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+                const float* b = B + n;
+                const float* a = panel;
+                for (int k = 0; k < K; k++, b += ldb, a += kPanelRows) {
+                    __m256 b0 = _mm256_loadu_ps(b);
+                    __m256 b1 = _mm256_loadu_ps(b + 8);
+                    __m256 w = _mm256_broadcast_ss(a);
+                    c00 = _mm256_fmadd_ps(w, b0, c00);
+                    c01 = _mm256_fmadd_ps(w, b1, c01);
+                    w = _mm256_broadcast_ss(a + 1);
+                    c10 = _mm256_fmadd_ps(w, b0, c10);
+                    c11 = _mm256_fmadd_ps(w, b1, c11);
+                    w = _mm256_broadcast_ss(a + 2);
+                    c20 = _mm256_fmadd_ps(w, b0, c20);
+                    c21 = _mm256_fmadd_ps(w, b1, c21);
+                    w = _mm256_broadcast_ss(a + 3);
+                    c30 = _mm256_fmadd_ps(w, b0, c30);
+                    c31 = _mm256_fmadd_ps(w, b1, c31);
+                }
+                __m256 acc[kPanelRows][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}};
+                for (int r = 0; r < kPanelRows; r++) {
+                    int m = p * kPanelRows + r;
+                    if (m >= M) break;
+                    __m256 bias = _mm256_set1_ps(e.bias[m]);
+                    __m256 slope = _mm256_set1_ps(e.slopes[m]);
+                    float* out = C + (size_t)m * ldc + n;
+                    _mm256_storeu_ps(out, activate8(_mm256_add_ps(acc[r][0], bias), e.activation, slope));
+                    _mm256_storeu_ps(out + 8, activate8(_mm256_add_ps(acc[r][1], bias), e.activation, slope));
+                }
+            }
+            if (n < ne) {
+                gemmScalar(p, p + 1, A, B + n, ldb, M, K, ne - n, C + n, ldc, e);
+            }
+        }
+    }
+}
+
+// 4 x 16 int8 tile: each B load widens 8 columns x 2 rows to int16 and one
+// multiply-add per row accumulates both rows into int32
+LUMA_NN_AVX2_TARGET
+void gemmInt8Avx2(int p0, int p1, const int32_t* A, const int8_t* B, int M, int K, int N,
+                  float* C, size_t ldc, const Epilogue& e) {
+    int pairs = (K + 1) / 2;
+    for (int nb = 0; nb < N; nb += kColumnBlock) {
+        int ne = std::min(N, nb + kColumnBlock);
+        for (int p = p0; p < p1; p++) {
+            const int32_t* panel = A + (size_t)p * pairs * kPanelRows;
+            int n = nb;
+            for (; n + kTileCols <= ne; n += kTileCols) {
+                __m256i c00 = _mm256_setzero_si256(), c01 = c00, c10 = c00, c11 = c00;
+                __m256i c20 = c00, c21 = c00, c30 = c00, c31 = c00;
+                const int8_t* b = B + (size_t)n * 2;
+                const int32_t* a = panel;
+                for (int q = 0; q < pairs; q++, b += (size_t)N * 2, a += kPanelRows) {
+                    __m256i b0 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+                    __m256i b1 = _mm256_cvtepi8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 16)));
+                    __m256i w = _mm256_set1_epi32(a[0]);
+                    c00 = _mm256_add_epi32(c00, _mm256_madd_epi16(b0, w));
+                    c01 = _mm256_add_epi32(c01, _mm256_madd_epi16(b1, w));
+                    w = _mm256_set1_epi32(a[1]);
+                    c10 = _mm256_add_epi32(c10, _mm256_madd_epi16(b0, w));
+                    c11 = _mm256_add_epi32(c11, _mm256_madd_epi16(b1, w));
+                    w = _mm256_set1_epi32(a[2]);
+                    c20 = _mm256_add_epi32(c20, _mm256_madd_epi16(b0, w));
+                    c21 = _mm256_add_epi32(c21, _mm256_madd_epi16(b1, w));
+                    w = _mm256_set1_epi32(a[3]);
+                    c30 = _mm256_add_epi32(c30, _mm256_madd_epi16(b0, w));
+                    c31 = _mm256_add_epi32(c31, _mm256_madd_epi16(b1, w));
+                }
+                __m256i acc[kPanelRows][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}};
+                for (int r = 0; r < kPanelRows; r++) {
+                    int m = p * kPanelRows + r;
+                    if (m >= M) break;
+                    __m256 scale = _mm256_set1_ps(e.scale[m] * e.inputScale);
+                    __m256 bias = _mm256_set1_ps(e.bias[m]);
+                    __m256 slope = _mm256_set1_ps(e.slopes[m]);
+                    float* out = C + (size_t)m * ldc + n;
+                    __m256 v0 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(acc[r][0]), scale, bias);
+                    __m256 v1 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(acc[r][1]), scale, bias);
+                    _mm256_storeu_ps(out, activate8(v0, e.activation, slope));
+                    _mm256_storeu_ps(out + 8, activate8(v1, e.activation, slope));
+                }
+            }
+            if (n < ne) {
+                // Tail columns: scalar over the same interleaved layout
+                int cols = ne - n;
+                int32_t acc[kPanelRows][kTileCols] = {};
+                for (int q = 0; q < pairs; q++) {
+                    const int8_t* b = B + ((size_t)q * N + n) * 2;
+                    const int32_t* a = panel + (size_t)q * kPanelRows;
+                    for (int r = 0; r < kPanelRows; r++) {
+                        int32_t lo = (int16_t)(a[r] & 0xFFFF), hi = (int16_t)((uint32_t)a[r] >> 16);
+                        for (int j = 0; j < cols; j++) acc[r][j] += lo * b[j * 2] + hi * b[j * 2 + 1];
+                    }
+                }
+                for (int r = 0; r < kPanelRows; r++) {
+                    int m = p * kPanelRows + r;
+                    if (m >= M) break;
+                    float values[kTileCols];
+                    for (int j = 0; j < cols; j++) values[j] = (float)acc[r][j];
+                    storeRow(C, ldc, M, m, n, values, cols, e, e.scale[m] * e.inputScale);
+                }
+            }
+        }
+    }
+}
+
+// Dense layers: one input column, so each k feeds four rows at once
+LUMA_NN_AVX2_TARGET
+void gemvAvx2(int p0, int p1, const float* A, const float* x, int M, int K, float* y, const Epilogue& e) {
+    for (int p = p0; p < p1; p++) {
+        const float* panel = A + (size_t)p * K * kPanelRows;
+        // Two k per register, two registers in flight
+        __m256 acc0 = _mm256_setzero_ps(), acc1 = acc0;
+        int k = 0;
+        for (; k + 4 <= K; k += 4) {
+            const float* a = panel + (size_t)k * kPanelRows;
+            __m256 x0 = _mm256_setr_m128(_mm_set1_ps(x[k]), _mm_set1_ps(x[k + 1]));
+            __m256 x1 = _mm256_setr_m128(_mm_set1_ps(x[k + 2]), _mm_set1_ps(x[k + 3]));
+            acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a), x0, acc0);
+            acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + 8), x1, acc1);
+        }
+        __m256 acc = _mm256_add_ps(acc0, acc1);
+        __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+        for (; k < K; k++) sum = _mm_fmadd_ps(_mm_loadu_ps(panel + (size_t)k * kPanelRows), _mm_set1_ps(x[k]), sum);
+        float sums[kPanelRows];
+        _mm_storeu_ps(sums, sum);
+        for (int r = 0; r < kPanelRows; r++) storeRow(y, 1, M, p * kPanelRows + r, 0, sums + r, 1, e, 1.0f);
+    }
+}
+
+// int8 dense: x holds K values as consecutive (k, k + 1) pairs
+LUMA_NN_AVX2_TARGET
+void gemvInt8Avx2(int p0, int p1, const int32_t* A, const int8_t* x, int M, int K, float* y, const Epilogue& e) {
+    int pairs = (K + 1) / 2;
+    for (int p = p0; p < p1; p++) {
+        const int32_t* panel = A + (size_t)p * pairs * kPanelRows;
+        __m256i acc = _mm256_setzero_si256();
+        int q = 0;
+        for (; q + 2 <= pairs; q += 2) {
+            // Two pairs of x against two k-pairs of the four rows
+            __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(panel + (size_t)q * kPanelRows));
+            int32_t x0 = (int32_t)((uint32_t)(uint16_t)x[q * 2] | ((uint32_t)(uint16_t)x[q * 2 + 1] << 16));
+            int32_t x1 = (int32_t)((uint32_t)(uint16_t)x[q * 2 + 2] | ((uint32_t)(uint16_t)x[q * 2 + 3] << 16));
+            __m256i xv = _mm256_setr_epi32(x0, x0, x0, x0, x1, x1, x1, x1);
+            acc = _mm256_add_epi32(acc, _mm256_madd_epi16(w, xv));
+        }
+        __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        int32_t sums[kPanelRows];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(sums), sum);
+        for (; q < pairs; q++) {
+            for (int r = 0; r < kPanelRows; r++) {
+                int32_t a = panel[(size_t)q * kPanelRows + r];
+                sums[r] += (int16_t)(a & 0xFFFF) * x[q * 2] + (int16_t)((uint32_t)a >> 16) * x[q * 2 + 1];
+            }
+        }
+        for (int r = 0; r < kPanelRows; r++) {
+            int m = p * kPanelRows + r;
+            if (m >= M) break;
+            float value = (float)sums[r];
+            storeRow(y, 1, M, m, 0, &value, 1, e, e.scale[m] * e.inputScale);
+        }
+    }
+}
+
+LUMA_NN_AVX2_TARGET
+float maxAbsAvx2(const float* values, size_t count) {
+    __m256 signMask = _mm256_set1_ps(-0.0f);
+    __m256 best = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) best = _mm256_max_ps(best, _mm256_andnot_ps(signMask, _mm256_loadu_ps(values + i)));
+    float lanes[8];
+    _mm256_storeu_ps(lanes, best);
+    float result = maxAbsScalar(values + i, count - i);
+    for (float lane : lanes) result = std::max(result, lane);
+    return result;
+}
+
+LUMA_NN_AVX2_TARGET
+void quantizeAvx2(const float* src, int8_t* dst, size_t count, float invScale) {
+    __m256 scale = _mm256_set1_ps(invScale);
+    __m256i gather = _mm256_setr_epi32(0, 4, 0, 0, 0, 0, 0, 0);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i i32 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale));
+        __m256i i16 = _mm256_packs_epi32(i32, i32);
+        __m256i i8 = _mm256_packs_epi16(i16, i16);
+        // Per lane the first four bytes are that lane's values
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(i8, gather)));
+    }
+    quantizeScalar(src + i, dst + i, count - i, invScale);
+}
+
+LUMA_NN_AVX2_TARGET
+void quantizePairsAvx2(const float* row0, const float* row1, int8_t* dst, size_t count, float invScale) {
+    __m256 scale = _mm256_set1_ps(invScale);
+    // int16 a0..a3 b0..b3 -> a0 b0 a1 b1 a2 b2 a3 b3, per lane
+    __m256i interleave = _mm256_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15,
+                                          0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15);
+    size_t n = 0;
+    for (; n + 8 <= count; n += 8) {
+        __m256i a = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(row0 + n), scale));
+        __m256i b = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(row1 + n), scale));
+        __m256i i16 = _mm256_shuffle_epi8(_mm256_packs_epi32(a, b), interleave);
+        __m256i i8 = _mm256_permute4x64_epi64(_mm256_packs_epi16(i16, i16), _MM_SHUFFLE(3, 1, 2, 0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + n * 2), _mm256_castsi256_si128(i8));
+    }
+    quantizePairsScalar(row0 + n, row1 + n, dst + n * 2, count - n, invScale);
+}
+
+LUMA_NN_AVX2_TARGET
+void addAvx2(const float* a, const float* b, float* out, size_t count, Activation activation) {
+    __m256 zero = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 sum = _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        _mm256_storeu_ps(out + i, activate8(sum, activation, zero));
+    }
+    addScalar(a + i, b + i, out + i, count - i, activation);
+}
+
+// Stride-1 depthwise channel: eight outputs per register with every tap
+// accumulated before the single store. Blocks that overhang the row load and
+// store through lane masks, so borders and narrow planes stay vectorized.
+LUMA_NN_AVX2_TARGET
+void depthwiseAvx2(const float* plane, Shape is, float* dst, Shape os, const float* w,
+                   int k, int pad, float bias, Activation activation, float slope) {
+    __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256 slope8 = _mm256_set1_ps(slope);
+    for (int oy = 0; oy < os.h; oy++) {
+        float* row = dst + (size_t)oy * os.w;
+        int kyLo = std::max(0, pad - oy), kyHi = std::min(k, is.h + pad - oy);
+        for (int ox = 0; ox < os.w; ox += 8) {
+            __m256 acc = _mm256_set1_ps(bias);
+            bool inside = ox - pad >= 0 && ox + 7 - pad + k - 1 < is.w && ox + 8 <= os.w;
+            for (int ky = kyLo; ky < kyHi; ky++) {
+                const float* src = plane + (size_t)(oy - pad + ky) * is.w;
+                const float* wk = w + ky * k;
+                for (int kx = 0; kx < k; kx++) {
+                    int ix = ox - pad + kx;
+                    __m256 v;
+                    if (inside) {
+                        v = _mm256_loadu_ps(src + ix);
+                    } else {
+                        // Lanes outside [0, width) read as zero padding
+                        __m256i index = _mm256_add_epi32(lanes, _mm256_set1_epi32(ix));
+                        __m256i valid = _mm256_and_si256(_mm256_cmpgt_epi32(index, _mm256_set1_epi32(-1)),
+                                                         _mm256_cmpgt_epi32(_mm256_set1_epi32(is.w), index));
+                        v = _mm256_maskload_ps(src + ix, valid);
+                    }
+                    acc = _mm256_fmadd_ps(_mm256_broadcast_ss(wk + kx), v, acc);
+                }
+            }
+            acc = activate8(acc, activation, slope8);
+            if (ox + 8 <= os.w) {
+                _mm256_storeu_ps(row + ox, acc);
+            } else {
+                __m256i store = _mm256_cmpgt_epi32(_mm256_set1_epi32(os.w - ox), lanes);
+                _mm256_maskstore_ps(row + ox, store, acc);
+            }
+        }
+    }
+}
+
+#endif  // LUMA_NN_X86
+
+// Column matrix row (c, ky, kx) x output pixel, zero outside the input
+template<typename Store>
+void im2col(const float* in, Shape s, int c0, int c1, int kernel, int stride, int pad,
+            int outH, int outW, Store store) {
+    for (int c = c0; c < c1; c++) {
+        const float* plane = in + (size_t)c * s.h * s.w;
+        for (int ky = 0; ky < kernel; ky++) {
+            for (int kx = 0; kx < kernel; kx++) {
+                int row = (c * kernel + ky) * kernel + kx;
+                for (int oy = 0; oy < outH; oy++) {
+                    int iy = oy * stride - pad + ky;
+                    int n = oy * outW;
+                    for (int ox = 0; ox < outW; ox++, n++) {
+                        int ix = ox * stride - pad + kx;
+                        bool inside = iy >= 0 && iy < s.h && ix >= 0 && ix < s.w;
+                        store(row, n, inside ? plane[(size_t)iy * s.w + ix] : 0.0f);
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+// ===== Execution Plan =====
+
+struct Runtime::Step {
+    OpType type = OpType::Conv2D;
+    Activation activation = Activation::None;
+    int in0 = -1, in1 = -1, out = -1;
+    Shape inShape, outShape;
+    int kernel = 1, stride = 1, pad = 0;
+
+    // Conv / dense as GEMM: C[M x N] = W[M x K] * B[K x N]
+    bool gemm = false;
+    bool direct = false;        // B is the input itself (1x1 conv, dense)
+    bool int8 = false;
+    int M = 0, K = 0, N = 0;
+    std::vector<float> packed;
+    std::vector<int32_t> packedInt8;
+    std::vector<float> scales;
+    std::vector<float> bias;    // Padded to whole panels
+    std::vector<float> slopes;
+
+    std::vector<float> depthwise;  // [C][k][k]
+
+    size_t colFloats = 0;       // int8: scratch floats in front of the quantized columns
+    std::vector<float> zeros;   // int8 with odd K: stands in for the missing last row
+};
+
+Runtime::Runtime() = default;
+Runtime::~Runtime() = default;
+
+bool Runtime::cpuHasAvx2() {
+#if defined(LUMA_NN_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuidex(info, 7, 0);
+    bool avx2 = (info[1] & (1 << 5)) != 0;
+    __cpuid(info, 1);
+    bool fma = (info[2] & (1 << 12)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    return avx2 && fma && osxsave && (_xgetbv(0) & 6) == 6;
+#else
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+#endif
+#else
+    return false;
+#endif
+}
+
+bool Runtime::compile(const Graph& graph, const RuntimeOptions& options) {
+    compiled_ = false;
+    steps_.clear();
+    error_.clear();
+    if (!graph.valid()) {
+        error_ = graph.getError().empty() ? "Graph has no input or outputs" : graph.getError();
+        return false;
+    }
+
+    shapes_ = graph.getShapes();
+    outputs_ = graph.getOutputs();
+    inputShape_ = shapes_[0];
+    stats_ = RuntimeStats();
+    stats_.avx2 = options.simd && cpuHasAvx2();
+    size_t scratchBytes = 0;
+
+    for (const Node& node : graph.getNodes()) {
+        Step step;
+        step.type = node.type;
+        step.activation = node.activation;
+        step.in0 = node.inputs[0];
+        step.in1 = node.inputs[1];
+        step.out = node.output;
+        step.inShape = shapes_[step.in0];
+        step.outShape = shapes_[step.out];
+        step.kernel = node.kernel;
+        step.stride = node.stride;
+        step.pad = node.pad;
+
+        bool depthwise = node.type == OpType::Conv2D && node.groups > 1;
+        if (depthwise) {
+            step.depthwise = node.weights;
+            stats_.weightBytes += step.depthwise.size() * sizeof(float);
+        } else if (node.type == OpType::Conv2D || node.type == OpType::Dense) {
+            step.gemm = true;
+            step.int8 = options.int8;
+            step.M = step.outShape.c;
+            if (node.type == OpType::Dense) {
+                step.K = (int)step.inShape.size();
+                step.N = 1;
+                step.direct = true;
+            } else {
+                step.K = step.inShape.c * node.kernel * node.kernel;
+                step.N = step.outShape.h * step.outShape.w;
+                step.direct = node.kernel == 1 && node.stride == 1 && node.pad == 0;
+            }
+            if (!step.direct) step.colFloats = ((size_t)step.K * step.N + 15) & ~size_t(15);
+            size_t stepScratch = step.colFloats * sizeof(float);
+            if (step.int8) {
+                step.packedInt8 = packPanelsInt8(node.weights.data(), step.M, step.K, step.scales);
+                stats_.weightBytes += step.packedInt8.size() * sizeof(int32_t) + step.scales.size() * sizeof(float);
+                // Quantized B, rows interleaved in pairs, follows the float columns
+                stepScratch += (size_t)(step.K + 1) / 2 * 2 * step.N;
+                if (step.K % 2) step.zeros.assign(step.N, 0.0f);
+            } else {
+                step.packed = packPanels(node.weights.data(), step.M, step.K);
+                stats_.weightBytes += step.packed.size() * sizeof(float);
+            }
+            scratchBytes = std::max(scratchBytes, stepScratch);
+        }
+
+        int rows = ((step.outShape.c + kPanelRows - 1) / kPanelRows) * kPanelRows;
+        step.bias.assign(rows, 0.0f);
+        step.slopes.assign(rows, 0.0f);
+        std::copy(node.bias.begin(), node.bias.end(), step.bias.begin());
+        std::copy(node.slopes.begin(), node.slopes.end(), step.slopes.begin());
+        steps_.push_back(std::move(step));
+    }
+
+    // ----- Arena: values whose lifetimes overlap never share memory -----
+    size_t valueCount = shapes_.size();
+    std::vector<int> first(valueCount), last(valueCount);
+    int endOfRun = (int)steps_.size();
+    for (size_t v = 0; v < valueCount; v++) first[v] = last[v] = (int)v - 1;
+    for (size_t i = 0; i < steps_.size(); i++) {
+        last[steps_[i].in0] = std::max(last[steps_[i].in0], (int)i);
+        if (steps_[i].in1 >= 0) last[steps_[i].in1] = std::max(last[steps_[i].in1], (int)i);
+    }
+    for (int output : outputs_) last[output] = endOfRun;
+
+    auto padded = [](size_t floats) { return (floats + 15) & ~size_t(15); };  // 64-byte multiples
+    std::vector<size_t> order(valueCount);
+    for (size_t v = 0; v < valueCount; v++) order[v] = v;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return shapes_[a].size() > shapes_[b].size(); });
+
+    offsets_.assign(valueCount, 0);
+    std::vector<size_t> placed;
+    size_t arenaFloats = 0;
+    for (size_t v : order) {
+        size_t size = padded(shapes_[v].size());
+        std::vector<std::pair<size_t, size_t>> busy;
+        for (size_t other : placed) {
+            if (first[other] <= last[v] && first[v] <= last[other]) {
+                busy.push_back({offsets_[other], offsets_[other] + padded(shapes_[other].size())});
+            }
+        }
+        std::sort(busy.begin(), busy.end());
+        size_t offset = 0;
+        for (const auto& [begin, end] : busy) {
+            if (offset + size <= begin) break;
+            offset = std::max(offset, end);
+        }
+        offsets_[v] = offset;
+        placed.push_back(v);
+        arenaFloats = std::max(arenaFloats, offset + size);
+        stats_.unsharedBytes += size * sizeof(float);
+    }
+
+    auto align = [](std::vector<float>& storage, size_t floats) {
+        storage.assign(floats + 16, 0.0f);
+        auto address = reinterpret_cast<uintptr_t>(storage.data());
+        return storage.data() + ((64 - address % 64) % 64) / sizeof(float);
+    };
+    arena_ = align(arenaStorage_, arenaFloats);
+    scratch_ = align(scratchStorage_, (scratchBytes + sizeof(float) - 1) / sizeof(float));
+    stats_.arenaBytes = arenaFloats * sizeof(float);
+    stats_.scratchBytes = scratchBytes;
+
+    int threads = options.threads > 0 ? options.threads : (int)std::max(1u, std::thread::hardware_concurrency());
+    if (!pool_ || pool_->getThreadCount() != threads) {
+        pool_.reset();
+        pool_ = std::make_unique<WorkerPool>(threads);
+    }
+    stats_.threads = threads;
+    compiled_ = true;
+    return true;
+}
+
+bool Runtime::run(const float* input) {
+    if (!compiled_) {
+        error_ = "Runtime not compiled";
+        return false;
+    }
+    std::memcpy(arena_ + offsets_[0], input, inputShape_.size() * sizeof(float));
+    for (const Step& step : steps_) execute(step);
+    return true;
+}
+
+const float* Runtime::getOutput(size_t index) const {
+    return index < outputs_.size() ? arena_ + offsets_[outputs_[index]] : nullptr;
+}
+
+Shape Runtime::getOutputShape(size_t index) const {
+    return index < outputs_.size() ? shapes_[outputs_[index]] : Shape{};
+}
+
+void Runtime::execute(const Step& step) {
+    const float* in = arena_ + offsets_[step.in0];
+    float* out = arena_ + offsets_[step.out];
+    Shape is = step.inShape, os = step.outShape;
+
+    if (step.gemm) {
+        Epilogue e{step.bias.data(), step.slopes.data(), step.scales.data(), 1.0f, step.activation};
+        int panels = (step.M + kPanelRows - 1) / kPanelRows;
+        int N = step.N;
+        bool avx2 = stats_.avx2;
+
+        // Column matrix: the input itself, or im2col into scratch
+        const float* B = in;
+        if (!step.direct) {
+            float* col = scratch_;
+            auto fill = [&](size_t c0, size_t c1) {
+                im2col(in, is, (int)c0, (int)c1, step.kernel, step.stride, step.pad, os.h, os.w,
+                       [&](int row, int n, float v) { col[(size_t)row * N + n] = v; });
+            };
+            pool_->parallelFor(is.c, 0, fill);
+            B = col;
+        }
+
+        if (step.int8) {
+            // Dynamic per-tensor activation scale; im2col only repeats input
+            // values, so the input's range covers the column matrix
+            float maxAbs = avx2 ? maxAbsAvx2(in, is.size()) : maxAbsScalar(in, is.size());
+            e.inputScale = maxAbs > 0.0f ? maxAbs / 127.0f : 1.0f;
+            float invScale = 1.0f / e.inputScale;
+            int8_t* col = reinterpret_cast<int8_t*>(scratch_ + step.colFloats);
+            int pairs = (step.K + 1) / 2;
+
+            if (N == 1) {
+                col[step.K] = 0;  // Odd K: the last pair's second half
+                if (avx2) quantizeAvx2(B, col, step.K, invScale);
+                else quantizeScalar(B, col, step.K, invScale);
+            } else {
+                auto quantizeRows = [&](size_t q0, size_t q1) {
+                    for (size_t q = q0; q < q1; q++) {
+                        const float* row0 = B + q * 2 * N;
+                        const float* row1 = (int)q * 2 + 1 < step.K ? row0 + N : step.zeros.data();
+                        if (avx2) quantizePairsAvx2(row0, row1, col + q * 2 * N, N, invScale);
+                        else quantizePairsScalar(row0, row1, col + q * 2 * N, N, invScale);
+                    }
+                };
+                pool_->parallelFor(pairs, 0, quantizeRows);
+            }
+
+            auto body = [&](size_t p0, size_t p1) {
+#if defined(LUMA_NN_X86)
+                if (avx2) {
+                    if (N == 1) gemvInt8Avx2((int)p0, (int)p1, step.packedInt8.data(), col, step.M, step.K, out, e);
+                    else gemmInt8Avx2((int)p0, (int)p1, step.packedInt8.data(), col, step.M, step.K, N, out, N, e);
+                    return;
+                }
+#endif
+                gemmInt8Scalar((int)p0, (int)p1, step.packedInt8.data(), col, step.M, step.K, N, out, N, e);
+            };
+            pool_->parallelFor(panels, 0, body);
+            return;
+        }
+
+        auto body = [&](size_t p0, size_t p1) {
+#if defined(LUMA_NN_X86)
+            if (avx2) {
+                if (N == 1) gemvAvx2((int)p0, (int)p1, step.packed.data(), B, step.M, step.K, out, e);
+                else gemmAvx2((int)p0, (int)p1, step.packed.data(), B, N, step.M, step.K, N, out, N, e);
+                return;
+            }
+#endif
+            gemmScalar((int)p0, (int)p1, step.packed.data(), B, N, step.M, step.K, N, out, N, e);
+        };
+        pool_->parallelFor(panels, 0, body);
+        return;
+    }
+
+    switch (step.type) {
+        case OpType::Conv2D: {
+            // Depthwise, one channel at a time
+            int k = step.kernel;
+            auto body = [&](size_t c0, size_t c1) {
+                for (size_t c = c0; c < c1; c++) {
+                    const float* plane = in + c * is.h * is.w;
+                    const float* w = step.depthwise.data() + c * k * k;
+                    float* dst = out + c * os.h * os.w;
+#if defined(LUMA_NN_X86)
+                    if (stats_.avx2 && step.stride == 1) {
+                        depthwiseAvx2(plane, is, dst, os, w, k, step.pad, step.bias[c], step.activation, step.slopes[c]);
+                        continue;
+                    }
+#endif
+                    depthwiseScalar(plane, is, dst, os, w, k, step.stride, step.pad, step.bias[c],
+                                    step.activation, step.slopes[c]);
+                }
+            };
+            pool_->parallelFor(os.c, 0, body);
+            break;
+        }
+        case OpType::Add: {
+            const float* other = arena_ + offsets_[step.in1];
+#if defined(LUMA_NN_X86)
+            if (stats_.avx2) {
+                addAvx2(in, other, out, os.size(), step.activation);
+                break;
+            }
+#endif
+            addScalar(in, other, out, os.size(), step.activation);
+            break;
+        }
+        case OpType::MaxPool: {
+            for (int c = 0; c < os.c; c++) {
+                const float* plane = in + (size_t)c * is.h * is.w;
+                for (int oy = 0; oy < os.h; oy++) {
+                    for (int ox = 0; ox < os.w; ox++) {
+                        float best = -INFINITY;
+                        for (int ky = 0; ky < step.kernel; ky++) {
+                            const float* src = plane + (size_t)(oy * step.stride + ky) * is.w + ox * step.stride;
+                            for (int kx = 0; kx < step.kernel; kx++) best = std::max(best, src[kx]);
+                        }
+                        out[((size_t)c * os.h + oy) * os.w + ox] = best;
+                    }
+                }
+            }
+            break;
+        }
+        case OpType::GlobalAvgPool: {
+            size_t plane = (size_t)is.h * is.w;
+            for (int c = 0; c < is.c; c++) {
+                float sum = 0.0f;
+                for (size_t i = 0; i < plane; i++) sum += in[c * plane + i];
+                out[c] = sum / (float)plane;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+}  // namespace nn
+}  // namespace luma
@@ -0,0 +1,170 @@
+// Tensor Runtime - Built-in CPU inference for small convolutional networks
+// Runs the face reconstruction models without an external runtime: conv,
+// depthwise conv and dense layers as im2col + blocked GEMM (AVX2 when the CPU
+// has it), an optional int8 path, one preallocated arena for activations and
+// output channels split across worker threads.
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace luma {
+
+class WorkerPool;
+
+namespace nn {
+
+// ===== Graph =====
+// Batch size is always 1; activations are CHW. Dense layers produce C x 1 x 1.
+struct Shape {
+    int c = 0;
+    int h = 1;
+    int w = 1;
+
+    size_t size() const { return (size_t)c * h * w; }
+    bool operator==(const Shape& o) const { return c == o.c && h == o.h && w == o.w; }
+};
+
+enum class OpType : uint8_t {
+    Conv2D = 0,      // groups == 1, or depthwise when groups == channels
+    Dense,           // Fully connected over the flattened input
+    Add,             // Elementwise, for residual connections
+    MaxPool,
+    GlobalAvgPool
+};
+
+// Applied in place after the op (fused into the GEMM epilogue)
+enum class Activation : uint8_t {
+    None = 0,
+    ReLU,
+    ReLU6,
+    PReLU            // Per-output-channel slopes
+};
+
+struct Node {
+    OpType type = OpType::Conv2D;
+    Activation activation = Activation::None;
+    int inputs[2] = {-1, -1};   // Value ids
+    int output = -1;            // Value id (always node index + 1)
+    int kernel = 1;
+    int stride = 1;
+    int pad = 0;
+    int groups = 1;
+    std::vector<float> weights; // Conv: [out][in / groups][k][k], Dense: [out][in]
+    std::vector<float> bias;    // [out], may be empty
+    std::vector<float> slopes;  // PReLU only, [out]
+};
+
+// Networks are built in execution order: value 0 is the input and every
+// node defines the next value.
+class Graph {
+public:
+    int input(Shape shape);
+
+    int conv(int x, int outChannels, int kernel, int stride, int pad,
+             std::vector<float> weights, std::vector<float> bias = {},
+             Activation activation = Activation::None, std::vector<float> slopes = {});
+    int depthwise(int x, int kernel, int stride, int pad,
+                  std::vector<float> weights, std::vector<float> bias = {},
+                  Activation activation = Activation::None, std::vector<float> slopes = {});
+    int dense(int x, int outputs, std::vector<float> weights, std::vector<float> bias = {},
+              Activation activation = Activation::None, std::vector<float> slopes = {});
+    int add(int a, int b, Activation activation = Activation::None);
+    int maxPool(int x, int kernel, int stride);
+    int globalAvgPool(int x);
+    void output(int x) { outputs_.push_back(x); }
+
+    // Binary .lnn model file
+    bool save(const std::string& path) const;
+    bool load(const std::string& path, std::string* error = nullptr);
+    bool loadFromMemory(const void* data, size_t size, std::string* error = nullptr);
+
+    bool empty() const { return shapes_.empty(); }
+    bool valid() const { return error_.empty() && !shapes_.empty() && !outputs_.empty(); }
+    const std::string& getError() const { return error_; }
+
+    const std::vector<Node>& getNodes() const { return nodes_; }
+    const std::vector<Shape>& getShapes() const { return shapes_; }
+    const std::vector<int>& getOutputs() const { return outputs_; }
+    Shape getShape(int value) const { return shapes_[value]; }
+    size_t getWeightCount() const;
+
+    // Multiply-accumulates for one inference
+    uint64_t getMacCount() const;
+
+private:
+    int addNode(Node node, Shape shape);
+    bool fail(const std::string& message);
+    bool check(int value);
+
+    std::vector<Node> nodes_;
+    std::vector<Shape> shapes_;
+    std::vector<int> outputs_;
+    std::string error_;
+};
+
+// ===== Runtime =====
+struct RuntimeOptions {
+    int threads = 0;        // 0 = hardware concurrency
+    bool int8 = false;      // Quantize conv / dense weights per output channel
+    bool simd = true;       // AVX2 kernels when the CPU has them
+};
+
+struct RuntimeStats {
+    size_t arenaBytes = 0;       // Activations after liveness-based reuse
+    size_t unsharedBytes = 0;    // Activations if every value had its own buffer
+    size_t scratchBytes = 0;     // im2col / quantization scratch
+    size_t weightBytes = 0;      // Packed weights
+    bool avx2 = false;
+    int threads = 1;
+};
+
+// Compiles a graph into an execution plan. run() never allocates.
+class Runtime {
+public:
+    Runtime();
+    ~Runtime();
+    Runtime(const Runtime&) = delete;
+    Runtime& operator=(const Runtime&) = delete;
+
+    bool compile(const Graph& graph, const RuntimeOptions& options = {});
+    bool isCompiled() const { return compiled_; }
+
+    // `input` holds getInputShape().size() floats; returns pointers into the
+    // arena, valid until the next run()
+    bool run(const float* input);
+    const float* getOutput(size_t index) const;
+    Shape getOutputShape(size_t index) const;
+    size_t getOutputCount() const { return outputs_.size(); }
+    Shape getInputShape() const { return inputShape_; }
+
+    const RuntimeStats& getStats() const { return stats_; }
+    const std::string& getError() const { return error_; }
+
+    static bool cpuHasAvx2();
+
+private:
+    struct Step;
+
+    void execute(const Step& step);
+
+    std::vector<Step> steps_;
+    std::vector<size_t> offsets_;       // Arena offset per value, in floats
+    std::vector<Shape> shapes_;
+    std::vector<int> outputs_;
+    Shape inputShape_;
+    std::vector<float> arenaStorage_;
+    float* arena_ = nullptr;
+    std::vector<float> scratchStorage_;
+    float* scratch_ = nullptr;
+    std::unique_ptr<WorkerPool> pool_;
+    RuntimeStats stats_;
+    std::string error_;
+    bool compiled_ = false;
+};
+
+}  // namespace nn
+}  // namespace luma
@@ -6,11 +6,15 @@
 #include "engine/animation/skeleton.h"
 #include "engine/renderer/mesh.h"
 #include "engine/character/standard_rig.h"
+#include "engine/character/skinning_bvh.h"
+#include <array>
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <algorithm>
+#include <cfloat>
 #include <cmath>
+#include <thread>
 
 namespace luma {
 
@@ -35,24 +39,18 @@ struct VertexSkinning {
     void addWeight(int boneIndex, float weight) {
         if (weight < 0.001f) return;
         
-        // Find slot or replace smallest
-        int insertIdx = -1;
-        float minWeight = weight;
-        
-        for (int i = 0; i < MAX_INFLUENCES; i++) {
-            if (weights[i].boneIndex < 0) {
-                insertIdx = i;
-                break;
-            }
-            if (weights[i].weight < minWeight) {
-                minWeight = weights[i].weight;
-                insertIdx = i;
-            }
+        // Fill a free slot, otherwise replace the smallest if this is larger
+        if (influenceCount < MAX_INFLUENCES) {
+            weights[influenceCount++] = SkinWeight(boneIndex, weight);
+            return;
         }
         
-        if (insertIdx >= 0 && weight > minWeight) {
-            weights[insertIdx] = SkinWeight(boneIndex, weight);
-            influenceCount = std::min(influenceCount + 1, MAX_INFLUENCES);
+        int minIdx = 0;
+        for (int i = 1; i < MAX_INFLUENCES; i++) {
+            if (weights[i].weight < weights[minIdx].weight) minIdx = i;
+        }
+        if (weight > weights[minIdx].weight) {
+            weights[minIdx] = SkinWeight(boneIndex, weight);
         }
     }
     
@@ -93,22 +91,30 @@ struct MeshSkinData {
         return !vertexWeights.empty() && !inverseBindMatrices.empty();
     }
     
-    // Apply to mesh vertex data (for export)
+    // Apply to mesh vertex data (fills skinnedVertices for export/rendering)
     void applyToMesh(Mesh& mesh) const {
-        for (size_t i = 0; i < vertexWeights.size() && i < mesh.vertices.size(); i++) {
-            const auto& skin = vertexWeights[i];
+        mesh.skinnedVertices.resize(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); i++) {
+            const Vertex& src = mesh.vertices[i];
+            SkinnedVertex& dst = mesh.skinnedVertices[i];
+            std::copy(src.position, src.position + 3, dst.position);
+            std::copy(src.normal, src.normal + 3, dst.normal);
+            std::copy(src.tangent, src.tangent + 4, dst.tangent);
+            std::copy(src.uv, src.uv + 2, dst.uv);
+            std::copy(src.color, src.color + 3, dst.color);
             
             // Store in vertex bone indices/weights
             for (int j = 0; j < 4; j++) {
-                if (j < skin.influenceCount) {
-                    mesh.vertices[i].boneIndices[j] = skin.weights[j].boneIndex;
-                    mesh.vertices[i].boneWeights[j] = skin.weights[j].weight;
+                if (i < vertexWeights.size() && j < vertexWeights[i].influenceCount) {
+                    dst.boneIndices[j] = static_cast<uint32_t>(vertexWeights[i].weights[j].boneIndex);
+                    dst.boneWeights[j] = vertexWeights[i].weights[j].weight;
                 } else {
-                    mesh.vertices[i].boneIndices[j] = 0;
-                    mesh.vertices[i].boneWeights[j] = 0.0f;
+                    dst.boneIndices[j] = 0;
+                    dst.boneWeights[j] = 0.0f;
                 }
             }
         }
+        mesh.hasSkeleton = !mesh.skinnedVertices.empty();
     }
 };
 
@@ -140,6 +146,9 @@ struct AutoRigParams {
     
     // Body region hints
     bool useBodyRegions = true;     // Use anatomical hints for better weighting
+    
+    // Worker threads for per-vertex passes (0 = hardware concurrency)
+    int threadCount = 0;
 };
 
 // ============================================================================
@@ -202,19 +211,23 @@ public:
             skinData.boneNameToIndex[skeleton.getBoneName(i)] = i;
         }
         
-        // Generate weights for each vertex
+        // Generate weights for each vertex; the BVH limits each vertex to
+        // the capsules whose influence range covers it
+        CapsuleBVH bvh = buildCapsuleBVH(capsules);
         skinData.vertexWeights.resize(mesh.vertices.size());
         
-        for (size_t i = 0; i < mesh.vertices.size(); i++) {
-            Vec3 vertexPos(
-                mesh.vertices[i].position[0],
-                mesh.vertices[i].position[1],
-                mesh.vertices[i].position[2]
-            );
-            
-            skinData.vertexWeights[i] = calculateVertexWeights(
-                vertexPos, capsules, params);
-        }
+        parallelFor(mesh.vertices.size(), params.threadCount, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                Vec3 vertexPos(
+                    mesh.vertices[i].position[0],
+                    mesh.vertices[i].position[1],
+                    mesh.vertices[i].position[2]
+                );
+                
+                skinData.vertexWeights[i] = calculateVertexWeights(
+                    vertexPos, capsules, bvh, params);
+            }
+        });
         
         // Smooth weights
         if (params.smoothIterations > 0) {
@@ -250,51 +263,6 @@ public:
     
     // === Utility Functions ===
     
-    // Estimate bone radii based on mesh
-    static void estimateBoneRadii(
-        std::vector<BoneCapsule>& capsules,
-        const Mesh& mesh)
-    {
-        for (auto& capsule : capsules) {
-            // Find vertices closest to this bone
-            std::vector<float> distances;
-            
-            for (const auto& vertex : mesh.vertices) {
-                Vec3 pos(vertex.position[0], vertex.position[1], vertex.position[2]);
-                float dist = capsule.distanceToPoint(pos);
-                distances.push_back(dist);
-            }
-            
-            // Sort and take percentile for radius estimation
-            std::sort(distances.begin(), distances.end());
-            size_t idx = std::min(
-                static_cast<size_t>(distances.size() * 0.2f),
-                distances.size() - 1);
-            
-            capsule.radius = std::max(0.01f, distances[idx]);
-        }
-    }
-    
-    // Validate that all vertices have valid weights
-    static bool validateWeights(const MeshSkinData& skinData) {
-        for (const auto& vw : skinData.vertexWeights) {
-            if (vw.influenceCount == 0) {
-                return false;  // Unweighted vertex
-            }
-            
-            float total = 0.0f;
-            for (int i = 0; i < vw.influenceCount; i++) {
-                total += vw.weights[i].weight;
-            }
-            
-            if (std::abs(total - 1.0f) > 0.01f) {
-                return false;  // Unnormalized
-            }
-        }
-        return true;
-    }
-    
-private:
     // Build capsule representations for all bones
     static std::vector<BoneCapsule> buildBoneCapsules(
         const Skeleton& skeleton,
@@ -350,6 +318,118 @@ private:
         return capsules;
     }
     
+    // Estimate bone radii based on mesh
+    static void estimateBoneRadii(
+        std::vector<BoneCapsule>& capsules,
+        const Mesh& mesh)
+    {
+        if (mesh.vertices.empty()) return;
+        
+        std::vector<float> distances;
+        distances.reserve(mesh.vertices.size());
+        for (auto& capsule : capsules) {
+            // Find vertices closest to this bone
+            distances.clear();
+            
+            for (const auto& vertex : mesh.vertices) {
+                Vec3 pos(vertex.position[0], vertex.position[1], vertex.position[2]);
+                float dist = capsule.distanceToPoint(pos);
+                distances.push_back(dist);
+            }
+            
+            // Take percentile for radius estimation
+            size_t idx = std::min(
+                static_cast<size_t>(distances.size() * 0.2f),
+                distances.size() - 1);
+            std::nth_element(distances.begin(), distances.begin() + idx, distances.end());
+            
+            capsule.radius = std::max(0.01f, distances[idx]);
+        }
+    }
+    
+    // Validate that all vertices have valid weights
+    static bool validateWeights(const MeshSkinData& skinData) {
+        for (const auto& vw : skinData.vertexWeights) {
+            if (vw.influenceCount == 0) {
+                return false;  // Unweighted vertex
+            }
+            
+            float total = 0.0f;
+            for (int i = 0; i < vw.influenceCount; i++) {
+                total += vw.weights[i].weight;
+            }
+            
+            if (std::abs(total - 1.0f) > 0.01f) {
+                return false;  // Unnormalized
+            }
+        }
+        return true;
+    }
+    
+    // Transfer weights from a skinned body to another mesh (e.g. a garment).
+    // Each target vertex takes the barycentric blend of the weights at its
+    // closest point on the body surface. A body without triangles is
+    // treated as a point cloud (nearest vertex).
+    static MeshSkinData transferWeights(
+        const Mesh& target,
+        const Mesh& body,
+        const MeshSkinData& bodySkin,
+        const AutoRigParams& params = {})
+    {
+        MeshSkinData skinData;
+        skinData.inverseBindMatrices = bodySkin.inverseBindMatrices;
+        skinData.boneNameToIndex = bodySkin.boneNameToIndex;
+        skinData.vertexWeights.resize(target.vertices.size());
+        
+        size_t bodyCount = std::min(body.vertices.size(), bodySkin.vertexWeights.size());
+        if (bodyCount == 0) return skinData;
+        
+        std::vector<uint32_t> pointTriangles;
+        const std::vector<uint32_t>* indices = &body.indices;
+        if (body.indices.size() < 3) {
+            pointTriangles.resize(bodyCount * 3);
+            for (size_t i = 0; i < pointTriangles.size(); i++) pointTriangles[i] = uint32_t(i / 3);
+            indices = &pointTriangles;
+        }
+        
+        static_assert(sizeof(Vertex) % sizeof(float) == 0, "Vertex must be float-packed");
+        TriangleBVH bvh;
+        bvh.build(body.vertices[0].position, sizeof(Vertex) / sizeof(float), bodyCount,
+                  indices->data(), indices->size());
+        
+        parallelFor(target.vertices.size(), params.threadCount, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                const float* p = target.vertices[i].position;
+                TriangleBVH::Hit hit = bvh.closestPoint(Vec3(p[0], p[1], p[2]));
+                if (!hit.valid()) continue;
+                
+                // Up to 3 x MAX_INFLUENCES distinct bones
+                std::array<SkinWeight, 3 * VertexSkinning::MAX_INFLUENCES> blended;
+                int blendedCount = 0;
+                for (int k = 0; k < 3; k++) {
+                    uint32_t vi = (*indices)[hit.triangle * 3 + k];
+                    if (vi >= bodyCount || hit.bary[k] <= 0.0f) continue;
+                    const VertexSkinning& vs = bodySkin.vertexWeights[vi];
+                    for (int j = 0; j < vs.influenceCount; j++) {
+                        int bone = vs.weights[j].boneIndex;
+                        float w = vs.weights[j].weight * hit.bary[k];
+                        int slot = 0;
+                        while (slot < blendedCount && blended[slot].boneIndex != bone) slot++;
+                        if (slot == blendedCount) blended[blendedCount++] = SkinWeight(bone, 0.0f);
+                        blended[slot].weight += w;
+                    }
+                }
+                
+                TopWeights top(params.maxBonesPerVertex);
+                for (int j = 0; j < blendedCount; j++) top.offer(blended[j].boneIndex, blended[j].weight);
+                skinData.vertexWeights[i] = top.toSkinning();
+            }
+        });
+        
+        return skinData;
+    }
+    
+private:
     // Estimate bone radius based on name
     static float estimateBoneRadius(const std::string& boneName, float defaultRadius) {
         // Larger for torso bones
@@ -401,51 +481,101 @@ private:
         }
     }
     
+    // Capsule BVH with each capsule's reach set to its falloff range
+    static CapsuleBVH buildCapsuleBVH(const std::vector<BoneCapsule>& capsules) {
+        std::vector<CapsuleBVH::Capsule> segments(capsules.size());
+        for (size_t i = 0; i < capsules.size(); i++) {
+            segments[i].start = capsules[i].start;
+            segments[i].end = capsules[i].end;
+            segments[i].reach = capsules[i].radius * 2.0f;
+        }
+        CapsuleBVH bvh;
+        bvh.build(segments);
+        return bvh;
+    }
+    
+    // Splits [0, count) into contiguous ranges run on worker threads
+    template<typename F>
+    static void parallelFor(size_t count, int threadCount, F&& body) {
+        constexpr size_t MIN_PER_THREAD = 4096;
+        size_t threads = threadCount > 0
+            ? static_cast<size_t>(threadCount)
+            : std::max(1u, std::thread::hardware_concurrency());
+        threads = std::min(threads, (count + MIN_PER_THREAD - 1) / MIN_PER_THREAD);
+        if (threads <= 1) {
+            body(size_t(0), count);
+            return;
+        }
+        
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        for (size_t t = 1; t < threads; t++) {
+            size_t begin = count * t / threads, end = count * (t + 1) / threads;
+            workers.emplace_back([&body, begin, end] { body(begin, end); });
+        }
+        body(size_t(0), count / threads);
+        for (auto& worker : workers) worker.join();
+    }
+    
+    // Keeps the `limit` largest (bone, weight) pairs in descending order;
+    // ties go to the lower bone index so results don't depend on visit order
+    struct TopWeights {
+        std::array<SkinWeight, VertexSkinning::MAX_INFLUENCES> items;
+        int count = 0;
+        int limit = VertexSkinning::MAX_INFLUENCES;
+        
+        explicit TopWeights(int maxBones)
+            : limit(std::clamp(maxBones, 1, VertexSkinning::MAX_INFLUENCES)) {}
+        
+        static bool before(int boneA, float weightA, const SkinWeight& b) {
+            return weightA > b.weight || (weightA == b.weight && boneA < b.boneIndex);
+        }
+        
+        void offer(int boneIndex, float weight) {
+            if (count == limit && !before(boneIndex, weight, items[count - 1])) return;
+            int pos = count < limit ? count++ : count - 1;
+            while (pos > 0 && before(boneIndex, weight, items[pos - 1])) {
+                items[pos] = items[pos - 1];
+                pos--;
+            }
+            items[pos] = SkinWeight(boneIndex, weight);
+        }
+        
+        VertexSkinning toSkinning() const {
+            VertexSkinning skinning;
+            for (int i = 0; i < count; i++) {
+                skinning.addWeight(items[i].boneIndex, items[i].weight);
+            }
+            skinning.normalize();
+            return skinning;
+        }
+    };
+    
     // Calculate weights for a single vertex
     static VertexSkinning calculateVertexWeights(
         const Vec3& position,
         const std::vector<BoneCapsule>& capsules,
+        const CapsuleBVH& bvh,
         const AutoRigParams& params)
     {
-        VertexSkinning skinning;
-        
-        // Calculate weight contribution from each bone
-        std::vector<std::pair<int, float>> boneWeights;
-        
-        for (const auto& capsule : capsules) {
-            float weight = capsule.calculateWeight(position, params.falloffPower);
+        // Only capsules within 2x radius can contribute (see calculateWeight)
+        TopWeights top(params.maxBonesPerVertex);
+        bvh.forEachInReach(position, [&](uint32_t index, float dist) {
+            const BoneCapsule& capsule = capsules[index];
+            float falloff = 1.0f - dist / (capsule.radius * 2.0f);
+            float weight = params.falloffPower == 2.0f ? falloff * falloff
+                                                       : std::pow(falloff, params.falloffPower);
             if (weight > params.minWeight) {
-                boneWeights.push_back({capsule.boneIndex, weight});
+                top.offer(capsule.boneIndex, weight);
             }
-        }
-        
-        // Sort by weight (highest first)
-        std::sort(boneWeights.begin(), boneWeights.end(),
-            [](const auto& a, const auto& b) { return a.second > b.second; });
+        });
         
-        // Take top N weights
-        int count = std::min(static_cast<int>(boneWeights.size()), params.maxBonesPerVertex);
-        for (int i = 0; i < count; i++) {
-            skinning.addWeight(boneWeights[i].first, boneWeights[i].second);
-        }
-        
-        // Normalize
-        skinning.normalize();
+        VertexSkinning skinning = top.toSkinning();
         
         // Fallback: assign to nearest bone if no weights
         if (skinning.influenceCount == 0 && !capsules.empty()) {
-            float minDist = FLT_MAX;
-            int nearestBone = 0;
-            
-            for (const auto& capsule : capsules) {
-                float dist = capsule.distanceToPoint(position);
-                if (dist < minDist) {
-                    minDist = dist;
-                    nearestBone = capsule.boneIndex;
-                }
-            }
-            
-            skinning.addWeight(nearestBone, 1.0f);
+            int nearest = bvh.nearest(position);
+            skinning.addWeight(capsules[nearest >= 0 ? nearest : 0].boneIndex, 1.0f);
         }
         
         return skinning;
@@ -457,68 +587,55 @@ private:
         const Mesh& mesh,
         const AutoRigParams& params)
     {
-        // Build adjacency list from triangles
-        std::vector<std::vector<size_t>> adjacency(mesh.vertices.size());
-        
-        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
-            uint32_t a = mesh.indices[i];
-            uint32_t b = mesh.indices[i + 1];
-            uint32_t c = mesh.indices[i + 2];
-            
-            adjacency[a].push_back(b);
-            adjacency[a].push_back(c);
-            adjacency[b].push_back(a);
-            adjacency[b].push_back(c);
-            adjacency[c].push_back(a);
-            adjacency[c].push_back(b);
-        }
+        MeshAdjacency adjacency;
+        adjacency.build(mesh.vertices.size(), mesh.indices.data(), mesh.indices.size());
         
-        // Remove duplicates in adjacency
-        for (auto& adj : adjacency) {
-            std::sort(adj.begin(), adj.end());
-            adj.erase(std::unique(adj.begin(), adj.end()), adj.end());
-        }
+        // Jacobi iterations: read one buffer, write the other
+        std::vector<VertexSkinning> smoothed(skinData.vertexWeights.size());
+        size_t vertexCount = std::min(mesh.vertices.size(), skinData.vertexWeights.size());
+        float ownFactor = 1.0f - params.smoothStrength;
         
-        // Smooth iterations
         for (int iter = 0; iter < params.smoothIterations; iter++) {
-            std::vector<VertexSkinning> smoothed = skinData.vertexWeights;
+            const std::vector<VertexSkinning>& source = skinData.vertexWeights;
             
-            for (size_t i = 0; i < mesh.vertices.size(); i++) {
-                if (adjacency[i].empty()) continue;
-                
-                // Accumulate neighbor weights
-                std::unordered_map<int, float> accumulated;
-                
-                // Add own weight
-                float ownFactor = 1.0f - params.smoothStrength;
-                for (int j = 0; j < skinData.vertexWeights[i].influenceCount; j++) {
-                    accumulated[skinData.vertexWeights[i].weights[j].boneIndex] +=
-                        skinData.vertexWeights[i].weights[j].weight * ownFactor;
-                }
+            parallelFor(vertexCount, params.threadCount, [&](size_t begin, size_t end) {
+                // Distinct bones around one vertex; reused across vertices
+                std::vector<SkinWeight> accumulated;
+                accumulated.reserve(64);
                 
-                // Add neighbor weights
-                float neighborFactor = params.smoothStrength / adjacency[i].size();
-                for (size_t ni : adjacency[i]) {
-                    for (int j = 0; j < skinData.vertexWeights[ni].influenceCount; j++) {
-                        accumulated[skinData.vertexWeights[ni].weights[j].boneIndex] +=
-                            skinData.vertexWeights[ni].weights[j].weight * neighborFactor;
+                auto accumulate = [&](const VertexSkinning& vs, float factor) {
+                    for (int j = 0; j < vs.influenceCount; j++) {
+                        int bone = vs.weights[j].boneIndex;
+                        float w = vs.weights[j].weight * factor;
+                        auto it = std::find_if(accumulated.begin(), accumulated.end(),
+                            [bone](const SkinWeight& sw) { return sw.boneIndex == bone; });
+                        if (it != accumulated.end()) it->weight += w;
+                        else accumulated.emplace_back(bone, w);
                     }
-                }
-                
-                // Rebuild vertex skinning from accumulated
-                smoothed[i].clear();
-                
-                std::vector<std::pair<int, float>> sorted(accumulated.begin(), accumulated.end());
-                std::sort(sorted.begin(), sorted.end(),
-                    [](const auto& a, const auto& b) { return a.second > b.second; });
+                };
                 
-                for (int j = 0; j < std::min(params.maxBonesPerVertex, (int)sorted.size()); j++) {
-                    smoothed[i].addWeight(sorted[j].first, sorted[j].second);
+                for (size_t i = begin; i < end; i++) {
+                    uint32_t degree = adjacency.degree(i);
+                    if (degree == 0) {
+                        smoothed[i] = source[i];
+                        continue;
+                    }
+                    
+                    accumulated.clear();
+                    accumulate(source[i], ownFactor);
+                    float neighborFactor = params.smoothStrength / degree;
+                    for (const uint32_t* n = adjacency.begin(i); n != adjacency.end(i); ++n) {
+                        accumulate(source[*n], neighborFactor);
+                    }
+                    
+                    TopWeights top(params.maxBonesPerVertex);
+                    for (const SkinWeight& sw : accumulated) top.offer(sw.boneIndex, sw.weight);
+                    smoothed[i] = top.toSkinning();
                 }
-                smoothed[i].normalize();
-            }
+            });
             
-            skinData.vertexWeights = std::move(smoothed);
+            for (size_t i = vertexCount; i < smoothed.size(); i++) smoothed[i] = source[i];
+            std::swap(skinData.vertexWeights, smoothed);
         }
     }
 };
@@ -649,40 +766,9 @@ public:
         const Skeleton& referenceSkeleton,
         const MeshSkinData& referenceSkinData)
     {
-        // Transfer weights by nearest vertex
-        MeshSkinData newSkinData;
-        newSkinData.inverseBindMatrices = referenceSkinData.inverseBindMatrices;
-        newSkinData.boneNameToIndex = referenceSkinData.boneNameToIndex;
-        newSkinData.vertexWeights.resize(targetMesh.vertices.size());
-        
-        for (size_t i = 0; i < targetMesh.vertices.size(); i++) {
-            Vec3 targetPos(
-                targetMesh.vertices[i].position[0],
-                targetMesh.vertices[i].position[1],
-                targetMesh.vertices[i].position[2]
-            );
-            
-            // Find nearest reference vertex
-            float minDist = FLT_MAX;
-            size_t nearestIdx = 0;
-            
-            for (size_t j = 0; j < referenceMesh.vertices.size(); j++) {
-                Vec3 refPos(
-                    referenceMesh.vertices[j].position[0],
-                    referenceMesh.vertices[j].position[1],
-                    referenceMesh.vertices[j].position[2]
-                );
-                
-                float dist = (targetPos - refPos).length();
-                if (dist < minDist) {
-                    minDist = dist;
-                    nearestIdx = j;
-                }
-            }
-            
-            // Copy weights from nearest
-            newSkinData.vertexWeights[i] = referenceSkinData.vertexWeights[nearestIdx];
-        }
+        // Transfer weights from the closest point on the reference surface
+        MeshSkinData newSkinData = AutoRigGenerator::transferWeights(
+            targetMesh, referenceMesh, referenceSkinData);
         
         newSkinData.applyToMesh(targetMesh);
         return true;
@@ -8,6 +8,7 @@
 #include <vector>
 #include <unordered_map>
 #include <cmath>
+#include <cfloat>
 #include <algorithm>
 
 namespace luma {
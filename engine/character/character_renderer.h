@@ -7,6 +7,7 @@
 #include "engine/character/character.h"
 #include "engine/character/base_human_loader.h"
 #include "engine/character/uv_mapping.h"
+#include "engine/character/skin_deformer.h"
 #include "engine/renderer/mesh.h"
 #include <vector>
 #include <memory>
@@ -21,11 +22,10 @@ class UnifiedRenderer;
 // ============================================================================
 
 struct CharacterGPUData {
-    // Base mesh buffers (positions, normals - for BlendShape modification)
-    std::vector<float> basePositions;   // 3 floats per vertex
-    std::vector<float> baseNormals;     // 3 floats per vertex
+    // Base mesh compiled to SoA streams (blend shapes + skinning + tangents)
+    SkinDeformer deformer;
     
-    // Current deformed mesh (after BlendShape)
+    // Current deformed mesh, written in place by the deformer
     std::vector<Vertex> deformedVertices;
     
     // Indices
@@ -103,58 +103,66 @@ public:
     
     // Setup GPU data from base model
     void setupFromModel(const BaseHumanModel& model) {
-        gpuData_.vertexCount = static_cast<uint32_t>(model.vertices.size());
-        gpuData_.indexCount = static_cast<uint32_t>(model.indices.size());
-        
-        // Extract positions and normals
-        gpuData_.basePositions.resize(gpuData_.vertexCount * 3);
-        gpuData_.baseNormals.resize(gpuData_.vertexCount * 3);
-        gpuData_.deformedVertices = model.vertices;
-        gpuData_.indices = model.indices;
-        
-        for (uint32_t i = 0; i < gpuData_.vertexCount; i++) {
-            gpuData_.basePositions[i * 3 + 0] = model.vertices[i].position[0];
-            gpuData_.basePositions[i * 3 + 1] = model.vertices[i].position[1];
-            gpuData_.basePositions[i * 3 + 2] = model.vertices[i].position[2];
-            
-            gpuData_.baseNormals[i * 3 + 0] = model.vertices[i].normal[0];
-            gpuData_.baseNormals[i * 3 + 1] = model.vertices[i].normal[1];
-            gpuData_.baseNormals[i * 3 + 2] = model.vertices[i].normal[2];
-        }
-        
-        gpuData_.needsUpdate = true;
+        setupMesh(model.vertices, model.indices);
     }
     
     // === Update ===
     
-    // Update deformed mesh from BlendShape weights (CPU fallback)
+    // Update deformed mesh from BlendShape weights (CPU fallback). Only
+    // re-blends when a weight changed; needsGPUUpdate() reports whether the
+    // vertices were rewritten.
     void updateBlendShapes() {
-        if (!character_) return;
+        if (!character_ || gpuData_.vertexCount == 0) return;
         
-        const auto& blendShapes = character_->getBlendShapeMesh();
-        const auto& baseVerts = character_->getBaseVertices();
-        
-        if (baseVerts.empty()) return;
-        
-        // Apply BlendShapes
-        blendShapes.applyToMesh(baseVerts, gpuData_.deformedVertices);
-        
-        // Recalculate tangents for normal mapping after deformation
-        if (!gpuData_.indices.empty()) {
-            UVMapper::calculateTangents(gpuData_.deformedVertices, gpuData_.indices);
-        }
-        
-        gpuData_.needsUpdate = true;
+        gpuData_.deformer.setBlendShapes(&character_->getBlendShapeMesh());
+        deform();
     }
     
     // Update from external BlendShapeMesh
     void updateBlendShapes(const BlendShapeMesh& blendShapes, const std::vector<Vertex>& baseVerts) {
         if (baseVerts.empty()) return;
         
-        blendShapes.applyToMesh(baseVerts, gpuData_.deformedVertices);
-        gpuData_.needsUpdate = true;
+        if (baseVerts.size() != gpuData_.vertexCount) {
+            setupMesh(baseVerts, gpuData_.indices);
+        }
+        gpuData_.deformer.setBlendShapes(&blendShapes);
+        deform();
+    }
+    
+    // === Skinning ===
+    
+    // Bone influences per base vertex (SkinVertex or SkinnedVertex)
+    template<typename SkinT>
+    void setSkinWeights(const std::vector<SkinT>& skinData) {
+        gpuData_.deformer.setSkinWeights(skinData);
+    }
+    
+    // Pose for the next update (from Animator::getSkinningMatrices)
+    void setPose(const Mat4* skinningMatrices, size_t boneCount) {
+        gpuData_.deformer.setBoneMatrices(skinningMatrices, boneCount);
+    }
+    
+    void setSkinningMode(SkinningMode mode) { gpuData_.deformer.setMode(mode); }
+    
+    // Deform many characters at once, one character per worker
+    static void updateAll(const std::vector<CharacterRenderer*>& renderers, SkinDeformerBatch& batch) {
+        std::vector<SkinDeformerBatch::Job> jobs;
+        std::vector<CharacterRenderer*> active;
+        for (CharacterRenderer* r : renderers) {
+            if (!r || r->gpuData_.vertexCount == 0) continue;
+            if (r->character_) r->gpuData_.deformer.setBlendShapes(&r->character_->getBlendShapeMesh());
+            jobs.push_back({&r->gpuData_.deformer, r->gpuData_.deformedVertices.data()});
+            active.push_back(r);
+        }
+        batch.run(jobs);
+        for (size_t i = 0; i < active.size(); i++) {
+            if (batch.wasUpdated(i)) active[i]->gpuData_.needsUpdate = true;
+        }
     }
     
+    // Stage timings of the last update
+    const DeformTimings& getDeformTimings() const { return gpuData_.deformer.getTimings(); }
+    
     // === Rendering ===
     
     // Get deformed mesh for rendering
@@ -207,31 +215,26 @@ private:
         if (!character_) return;
         
         const auto& baseVerts = character_->getBaseVertices();
-        const auto& indices = character_->getIndices();
-        
         if (baseVerts.empty()) return;
         
+        setupMesh(baseVerts, character_->getIndices());
+        gpuData_.deformer.setBlendShapes(&character_->getBlendShapeMesh());
+    }
+    
+    void setupMesh(const std::vector<Vertex>& baseVerts, const std::vector<uint32_t>& indices) {
         gpuData_.vertexCount = static_cast<uint32_t>(baseVerts.size());
         gpuData_.indexCount = static_cast<uint32_t>(indices.size());
-        
-        // Extract positions and normals
-        gpuData_.basePositions.resize(gpuData_.vertexCount * 3);
-        gpuData_.baseNormals.resize(gpuData_.vertexCount * 3);
         gpuData_.deformedVertices = baseVerts;
         gpuData_.indices = indices;
-        
-        for (uint32_t i = 0; i < gpuData_.vertexCount; i++) {
-            gpuData_.basePositions[i * 3 + 0] = baseVerts[i].position[0];
-            gpuData_.basePositions[i * 3 + 1] = baseVerts[i].position[1];
-            gpuData_.basePositions[i * 3 + 2] = baseVerts[i].position[2];
-            
-            gpuData_.baseNormals[i * 3 + 0] = baseVerts[i].normal[0];
-            gpuData_.baseNormals[i * 3 + 1] = baseVerts[i].normal[1];
-            gpuData_.baseNormals[i * 3 + 2] = baseVerts[i].normal[2];
-        }
-        
+        gpuData_.deformer.setBaseMesh(baseVerts, indices);
         gpuData_.needsUpdate = true;
     }
+    
+    void deform() {
+        if (gpuData_.deformer.update(gpuData_.deformedVertices.data())) {
+            gpuData_.needsUpdate = true;
+        }
+    }
 };
 
 } // namespace luma
@@ -125,11 +125,11 @@ public:
             }
             
             // Copy texture paths
-            if (!mesh.diffuseTexture.path.empty() && asset.material.diffuseTexture.empty()) {
-                asset.material.diffuseTexture = mesh.diffuseTexture.path;
+            if (mesh.diffuseTexture && !mesh.diffuseTexture->path.empty() && asset.material.diffuseTexture.empty()) {
+                asset.material.diffuseTexture = mesh.diffuseTexture->path;
             }
-            if (!mesh.normalTexture.path.empty() && asset.material.normalTexture.empty()) {
-                asset.material.normalTexture = mesh.normalTexture.path;
+            if (mesh.normalTexture && !mesh.normalTexture->path.empty() && asset.material.normalTexture.empty()) {
+                asset.material.normalTexture = mesh.normalTexture->path;
             }
         }
         
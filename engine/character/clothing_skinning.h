@@ -5,9 +5,11 @@
 #include "engine/foundation/math_types.h"
 #include "engine/animation/skeleton.h"
 #include "engine/renderer/mesh.h"
+#include "engine/character/skinning_bvh.h"
 #include <vector>
 #include <unordered_map>
 #include <string>
+#include <cfloat>
 #include <cmath>
 #include <algorithm>
 
@@ -174,6 +176,58 @@ public:
         return skinData;
     }
     
+    // Transfer weights from an already skinned body: each garment vertex
+    // blends the weights at its closest point on the body surface, so
+    // clothing follows the body's deformation instead of raw bone distance
+    static ClothingSkinData transferWeights(const std::vector<Vertex>& garmentVertices,
+                                            const std::vector<Vertex>& bodyVertices,
+                                            const std::vector<uint32_t>& bodyIndices,
+                                            const ClothingSkinData& bodySkin) {
+        ClothingSkinData skinData;
+        skinData.boneNameToIndex = bodySkin.boneNameToIndex;
+        skinData.inverseBindMatrices = bodySkin.inverseBindMatrices;
+        skinData.vertexWeights.resize(garmentVertices.size());
+        
+        size_t bodyCount = std::min(bodyVertices.size(), bodySkin.vertexWeights.size());
+        if (bodyCount == 0 || bodyIndices.size() < 3) return skinData;
+        
+        TriangleBVH bvh;
+        bvh.build(bodyVertices[0].position, sizeof(Vertex) / sizeof(float), bodyCount,
+                  bodyIndices.data(), bodyIndices.size());
+        
+        for (size_t vi = 0; vi < garmentVertices.size(); vi++) {
+            const float* p = garmentVertices[vi].position;
+            TriangleBVH::Hit hit = bvh.closestPoint(Vec3(p[0], p[1], p[2]));
+            if (!hit.valid()) continue;
+            
+            // Merge the 3 corners' influences, then keep the strongest 4
+            BoneWeight blended[12];
+            int blendedCount = 0;
+            for (int k = 0; k < 3; k++) {
+                uint32_t bi = bodyIndices[hit.triangle * 3 + k];
+                if (bi >= bodyCount || hit.bary[k] <= 0.0f) continue;
+                const VertexSkinData& src = bodySkin.vertexWeights[bi];
+                for (int w = 0; w < src.weightCount; w++) {
+                    int bone = src.weights[w].boneIndex;
+                    if (bone < 0) continue;
+                    int slot = 0;
+                    while (slot < blendedCount && blended[slot].boneIndex != bone) slot++;
+                    if (slot == blendedCount) blended[blendedCount++] = BoneWeight(bone, 0.0f);
+                    blended[slot].weight += src.weights[w].weight * hit.bary[k];
+                }
+            }
+            
+            std::sort(blended, blended + blendedCount,
+                [](const BoneWeight& a, const BoneWeight& b) { return a.weight > b.weight; });
+            for (int w = 0; w < blendedCount; w++) {
+                skinData.vertexWeights[vi].addWeight(blended[w].boneIndex, blended[w].weight);
+            }
+            skinData.vertexWeights[vi].normalize();
+        }
+        
+        return skinData;
+    }
+    
     // Generate weights using heat diffusion (more accurate but slower)
     static ClothingSkinData generateWeightsHeatDiffusion(
         const std::vector<Vertex>& vertices,
@@ -4,6 +4,7 @@
 
 #include "engine/foundation/math_types.h"
 #include "engine/renderer/mesh.h"
+#include "engine/asset/texture_cache.h"
 #include "engine/character/clothing_system.h"
 #include <string>
 #include <vector>
@@ -90,6 +91,16 @@ struct ClothingMaterialSet {
     FabricType fabricType = FabricType::Cotton;
     bool hasPattern = false;
     
+    // Meshes wearing the same material share one copy of the pixels
+    static TextureHandle shareTexture(const ClothingTextureAsset& texture) {
+        TextureData data;
+        data.pixels = texture.pixels;
+        data.width = texture.width;
+        data.height = texture.height;
+        data.channels = texture.channels;
+        return getTextureCache().insert(std::move(data));
+    }
+    
     // Apply to mesh
     void applyToMesh(Mesh& mesh) const {
         mesh.baseColor[0] = baseColor.x;
@@ -101,30 +112,21 @@ struct ClothingMaterialSet {
         // Apply diffuse texture if available
         auto it = textures.find(ClothingTextureType::Diffuse);
         if (it != textures.end() && it->second.isLoaded) {
-            mesh.diffuseTexture.pixels = it->second.pixels;
-            mesh.diffuseTexture.width = it->second.width;
-            mesh.diffuseTexture.height = it->second.height;
-            mesh.diffuseTexture.channels = it->second.channels;
+            mesh.diffuseTexture = shareTexture(it->second);
             mesh.hasDiffuseTexture = true;
         }
         
         // Apply normal map
         it = textures.find(ClothingTextureType::Normal);
         if (it != textures.end() && it->second.isLoaded) {
-            mesh.normalTexture.pixels = it->second.pixels;
-            mesh.normalTexture.width = it->second.width;
-            mesh.normalTexture.height = it->second.height;
-            mesh.normalTexture.channels = it->second.channels;
+            mesh.normalTexture = shareTexture(it->second);
             mesh.hasNormalTexture = true;
         }
         
         // Apply roughness/specular map
         it = textures.find(ClothingTextureType::Roughness);
         if (it != textures.end() && it->second.isLoaded) {
-            mesh.specularTexture.pixels = it->second.pixels;
-            mesh.specularTexture.width = it->second.width;
-            mesh.specularTexture.height = it->second.height;
-            mesh.specularTexture.channels = it->second.channels;
+            mesh.specularTexture = shareTexture(it->second);
             mesh.hasSpecularTexture = true;
         }
     }
@@ -14,6 +14,19 @@
 #include <sstream>
 #include <filesystem>
 #include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <string_view>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace luma {
 
@@ -25,6 +38,7 @@ struct MakeHumanPaths {
     // Default paths relative to assets folder
     static constexpr const char* BaseModelPath = "assets/makehuman/base.obj";
     static constexpr const char* TargetsPath = "assets/makehuman/targets/";
+    static constexpr const char* TargetPackPath = "assets/makehuman/targets.mhpack";  // Built by luma_mhpack
     static constexpr const char* SkeletonPath = "assets/makehuman/skeleton/";
     static constexpr const char* TexturesPath = "assets/makehuman/textures/";
     
@@ -111,6 +125,344 @@ private:
     }
 };
 
+// ============================================================================
+// MakeHuman Target Pack - All targets of a directory in one binary file
+// ============================================================================
+//
+// Built offline (tools/mhpack) from a targets/ directory so startup does not
+// parse hundreds of text files. Layout, little-endian:
+//
+//   PackHeader
+//   PackEntry[targetCount]     sorted by name
+//   string table               names and categories, not terminated
+//   per target, 4-byte aligned:
+//     vertex indices           uint16 or uint32 (PackEntry::indexBytes)
+//     deltas                   int16 x, y, z; value = q * PackEntry::scale[axis]
+//
+// The file is memory-mapped and targets are decoded one at a time on demand.
+
+class MakeHumanTargetPack {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    MakeHumanTargetPack() = default;
+    ~MakeHumanTargetPack() { close(); }
+    MakeHumanTargetPack(const MakeHumanTargetPack&) = delete;
+    MakeHumanTargetPack& operator=(const MakeHumanTargetPack&) = delete;
+
+    // === Build ===
+
+    // Converts every .target file below `targetDir` into one pack. The
+    // category of a target is its directory relative to `targetDir`.
+    static bool build(const std::string& targetDir, const std::string& packPath,
+                      std::string* error = nullptr, size_t* targetCount = nullptr) {
+        namespace fs = std::filesystem;
+        if (!fs::is_directory(targetDir)) return fail(error, "Not a directory: " + targetDir);
+
+        struct Source {
+            std::string name;
+            std::string category;
+            std::string path;
+        };
+        std::vector<Source> sources;
+        for (const auto& entry : fs::recursive_directory_iterator(targetDir)) {
+            if (!entry.is_regular_file() || entry.path().extension() != ".target") continue;
+            std::string category = entry.path().parent_path().lexically_relative(targetDir).generic_string();
+            if (category == ".") category.clear();
+            sources.push_back({entry.path().stem().string(), category, entry.path().string()});
+        }
+        std::sort(sources.begin(), sources.end(), [](const Source& a, const Source& b) {
+            return a.name != b.name ? a.name < b.name : a.category < b.category;
+        });
+
+        std::vector<PackEntry> entries;
+        std::string strings;
+        std::vector<uint8_t> data;
+        for (const Source& source : sources) {
+            BlendShapeTarget target;
+            if (!MakeHumanTargetLoader::loadTarget(source.path, target, source.name)) continue;
+
+            PackEntry e{};
+            e.nameOffset = static_cast<uint32_t>(strings.size());
+            e.nameLength = static_cast<uint32_t>(source.name.size());
+            strings += source.name;
+            e.categoryOffset = static_cast<uint32_t>(strings.size());
+            e.categoryLength = static_cast<uint32_t>(source.category.size());
+            strings += source.category;
+
+            uint32_t maxIndex = 0;
+            float maxAbs[3] = {0, 0, 0};
+            for (const auto& d : target.deltas) {
+                maxIndex = std::max(maxIndex, d.vertexIndex);
+                maxAbs[0] = std::max(maxAbs[0], std::abs(d.positionDelta.x));
+                maxAbs[1] = std::max(maxAbs[1], std::abs(d.positionDelta.y));
+                maxAbs[2] = std::max(maxAbs[2], std::abs(d.positionDelta.z));
+            }
+            e.deltaCount = static_cast<uint32_t>(target.deltas.size());
+            e.indexBytes = maxIndex <= 0xFFFF ? 2 : 4;
+            for (int a = 0; a < 3; a++) e.scale[a] = maxAbs[a] / 32767.0f;
+
+            data.resize((data.size() + 3) & ~size_t(3));
+            e.dataOffset = data.size();
+            size_t at = data.size();
+            data.resize(at + (size_t)e.deltaCount * (e.indexBytes + 6));
+            uint8_t* indices = data.data() + at;
+            uint8_t* deltas = indices + (size_t)e.deltaCount * e.indexBytes;
+            for (uint32_t i = 0; i < e.deltaCount; i++) {
+                const BlendShapeDelta& d = target.deltas[i];
+                if (e.indexBytes == 2) {
+                    uint16_t index = static_cast<uint16_t>(d.vertexIndex);
+                    std::memcpy(indices + i * 2, &index, 2);
+                } else {
+                    std::memcpy(indices + i * 4, &d.vertexIndex, 4);
+                }
+                const float values[3] = {d.positionDelta.x, d.positionDelta.y, d.positionDelta.z};
+                for (int a = 0; a < 3; a++) {
+                    int16_t q = e.scale[a] > 0.0f ? static_cast<int16_t>(std::lround(values[a] / e.scale[a])) : 0;
+                    std::memcpy(deltas + (i * 3 + a) * 2, &q, 2);
+                }
+            }
+            entries.push_back(e);
+        }
+
+        PackHeader header{};
+        std::memcpy(header.magic, "LMTP", 4);
+        header.version = VERSION;
+        header.targetCount = static_cast<uint32_t>(entries.size());
+        header.entriesOffset = sizeof(PackHeader);
+        header.stringsOffset = header.entriesOffset + entries.size() * sizeof(PackEntry);
+        header.stringsSize = strings.size();
+        header.dataOffset = (header.stringsOffset + strings.size() + 7) & ~uint64_t(7);
+        header.dataSize = data.size();
+        for (auto& e : entries) e.dataOffset += header.dataOffset;
+
+        std::ofstream out(packPath, std::ios::binary | std::ios::trunc);
+        if (!out) return fail(error, "Cannot write " + packPath);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(PackEntry));
+        out.write(strings.data(), strings.size());
+        const char padding[8] = {};
+        out.write(padding, header.dataOffset - header.stringsOffset - strings.size());
+        out.write(reinterpret_cast<const char*>(data.data()), data.size());
+        if (!out) return fail(error, "Write failed: " + packPath);
+        if (targetCount) *targetCount = entries.size();
+        return true;
+    }
+
+    // === Load ===
+
+    // Maps the pack and validates its index; no target is decoded yet
+    bool open(const std::string& path) {
+        close();
+#if defined(_WIN32)
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) return fail(&error_, "Cannot open " + path);
+        storage_.resize((size_t)file.tellg());
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(storage_.data()), storage_.size());
+        if (!file) return fail(&error_, "Cannot read " + path);
+        data_ = storage_.data();
+        size_ = storage_.size();
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return fail(&error_, "Cannot open " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return fail(&error_, "Empty pack: " + path);
+        }
+        void* mapped = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) return fail(&error_, "Cannot map " + path);
+        data_ = static_cast<const uint8_t*>(mapped);
+        size_ = (size_t)st.st_size;
+        mapped_ = true;
+#endif
+        if (!validate()) {
+            std::string message = error_;
+            close();
+            error_ = message + ": " + path;
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+#if !defined(_WIN32)
+        if (mapped_) munmap(const_cast<uint8_t*>(data_), size_);
+#endif
+        mapped_ = false;
+        storage_.clear();
+        data_ = nullptr;
+        size_ = 0;
+        entries_.clear();
+        error_.clear();
+    }
+
+    bool isOpen() const { return data_ != nullptr; }
+    const std::string& getError() const { return error_; }
+
+    // === Queries ===
+
+    size_t getTargetCount() const { return entries_.size(); }
+
+    std::string_view getName(size_t index) const {
+        const PackEntry& e = entries_[index];
+        return {reinterpret_cast<const char*>(data_ + strings_ + e.nameOffset), e.nameLength};
+    }
+
+    std::string_view getCategory(size_t index) const {
+        const PackEntry& e = entries_[index];
+        return {reinterpret_cast<const char*>(data_ + strings_ + e.categoryOffset), e.categoryLength};
+    }
+
+    size_t getDeltaCount(size_t index) const { return entries_[index].deltaCount; }
+
+    // Binary search over the sorted names; -1 if absent
+    int findTarget(std::string_view name) const {
+        size_t lo = 0, hi = entries_.size();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (getName(mid) < name) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo < entries_.size() && getName(lo) == name ? static_cast<int>(lo) : -1;
+    }
+
+    // Largest rounding error of target `index` per axis (half a step)
+    Vec3 getQuantizationError(size_t index) const {
+        const PackEntry& e = entries_[index];
+        return Vec3(e.scale[0] * 0.5f, e.scale[1] * 0.5f, e.scale[2] * 0.5f);
+    }
+
+    // === Decode ===
+
+    bool decodeTarget(size_t index, BlendShapeTarget& outTarget) const {
+        if (index >= entries_.size()) return false;
+        const PackEntry& e = entries_[index];
+        outTarget = BlendShapeTarget(std::string(getName(index)));
+        outTarget.category = std::string(getCategory(index));
+        outTarget.deltas.resize(e.deltaCount);
+
+        const uint8_t* indices = data_ + e.dataOffset;
+        const uint8_t* deltas = indices + (size_t)e.deltaCount * e.indexBytes;
+        Vec3 lo(FLT_MAX, FLT_MAX, FLT_MAX), hi(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (uint32_t i = 0; i < e.deltaCount; i++) {
+            BlendShapeDelta& d = outTarget.deltas[i];
+            if (e.indexBytes == 2) {
+                uint16_t v;
+                std::memcpy(&v, indices + i * 2, 2);
+                d.vertexIndex = v;
+            } else {
+                std::memcpy(&d.vertexIndex, indices + i * 4, 4);
+            }
+            int16_t q[3];
+            std::memcpy(q, deltas + (size_t)i * 6, 6);
+            d.positionDelta = Vec3(q[0] * e.scale[0], q[1] * e.scale[1], q[2] * e.scale[2]);
+            lo = Vec3(std::min(lo.x, d.positionDelta.x), std::min(lo.y, d.positionDelta.y), std::min(lo.z, d.positionDelta.z));
+            hi = Vec3(std::max(hi.x, d.positionDelta.x), std::max(hi.y, d.positionDelta.y), std::max(hi.z, d.positionDelta.z));
+        }
+        outTarget.boundsMin = lo;
+        outTarget.boundsMax = hi;
+        return true;
+    }
+
+    bool decodeTarget(std::string_view name, BlendShapeTarget& outTarget) const {
+        int index = findTarget(name);
+        return index >= 0 && decodeTarget(static_cast<size_t>(index), outTarget);
+    }
+
+    // All targets whose category is `category` or below it ("" = all)
+    std::vector<BlendShapeTarget> decodeCategory(std::string_view category) const {
+        std::vector<BlendShapeTarget> targets;
+        for (size_t i = 0; i < entries_.size(); i++) {
+            std::string_view c = getCategory(i);
+            bool match = category.empty() || c == category ||
+                         (c.size() > category.size() && c.compare(0, category.size(), category) == 0 &&
+                          c[category.size()] == '/');
+            if (!match) continue;
+            targets.emplace_back();
+            decodeTarget(i, targets.back());
+        }
+        return targets;
+    }
+
+private:
+    struct PackHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t targetCount;
+        uint32_t reserved;
+        uint64_t entriesOffset;
+        uint64_t stringsOffset;
+        uint64_t stringsSize;
+        uint64_t dataOffset;
+        uint64_t dataSize;
+    };
+
+    struct PackEntry {
+        uint32_t nameOffset;        // Into the string table
+        uint32_t nameLength;
+        uint32_t categoryOffset;
+        uint32_t categoryLength;
+        uint32_t deltaCount;
+        uint32_t indexBytes;        // 2 or 4
+        uint64_t dataOffset;        // From the start of the file
+        float scale[3];             // Per-axis dequantization step
+        uint32_t reserved;
+    };
+
+    static bool fail(std::string* error, const std::string& message) {
+        if (error) *error = message;
+        return false;
+    }
+
+    // [offset, offset + length) lies within [0, limit), without offset + length wrapping
+    static bool inRange(uint64_t offset, uint64_t length, uint64_t limit) {
+        return offset <= limit && length <= limit - offset;
+    }
+
+    // Every offset is checked once here so decoding needs no bounds checks
+    bool validate() {
+        PackHeader header;
+        if (size_ < sizeof(header)) return fail(&error_, "Truncated pack");
+        std::memcpy(&header, data_, sizeof(header));
+        if (std::memcmp(header.magic, "LMTP", 4) != 0) return fail(&error_, "Not a MakeHuman target pack");
+        if (header.version != VERSION) return fail(&error_, "Unsupported pack version " + std::to_string(header.version));
+        uint64_t entriesBytes = (uint64_t)header.targetCount * sizeof(PackEntry);
+        if (!inRange(header.entriesOffset, entriesBytes, size_) ||
+            header.stringsOffset < header.entriesOffset + entriesBytes ||
+            !inRange(header.stringsOffset, header.stringsSize, size_) ||
+            !inRange(header.dataOffset, header.dataSize, size_)) {
+            return fail(&error_, "Truncated pack");
+        }
+        entries_.resize(header.targetCount);
+        std::memcpy(entries_.data(), data_ + header.entriesOffset, entries_.size() * sizeof(PackEntry));
+        strings_ = header.stringsOffset;
+        for (const PackEntry& e : entries_) {
+            bool valid = e.indexBytes == 2 || e.indexBytes == 4;
+            uint64_t bytes = valid ? (uint64_t)e.deltaCount * (e.indexBytes + 6) : 0;
+            if (!valid ||
+                !inRange(e.nameOffset, e.nameLength, header.stringsSize) ||
+                !inRange(e.categoryOffset, e.categoryLength, header.stringsSize) ||
+                e.dataOffset < header.dataOffset ||
+                !inRange(e.dataOffset - header.dataOffset, bytes, header.dataSize)) {
+                entries_.clear();
+                return fail(&error_, "Corrupt pack index");
+            }
+        }
+        return true;
+    }
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<uint8_t> storage_;      // Whole file where mmap is unavailable
+    std::vector<PackEntry> entries_;
+    uint64_t strings_ = 0;
+    std::string error_;
+};
+
 // ============================================================================
 // MakeHuman Skeleton Mapping
 // ============================================================================
@@ -192,23 +544,27 @@ public:
             }
         }
         
-        // Load targets
+        // Load targets, from the binary pack when one was built
         std::string targetsDir = modelDir + "targets/";
-        if (std::filesystem::exists(targetsDir)) {
-            auto targets = MakeHumanTargetLoader::loadTargetsFromDirectory(targetsDir);
-            for (const auto& target : targets) {
-                outModel.blendShapes.addTarget(target);
-                
-                // Create channel for each target
-                BlendShapeChannel channel;
-                channel.name = target.name;
-                channel.targetIndices.push_back(static_cast<int>(outModel.blendShapes.getTargetCount()) - 1);
-                channel.targetWeights.push_back(1.0f);
-                channel.defaultWeight = 0.0f;
-                channel.minWeight = -1.0f;
-                channel.maxWeight = 1.0f;
-                outModel.blendShapes.addChannel(channel);
-            }
+        std::vector<BlendShapeTarget> targets;
+        MakeHumanTargetPack pack;
+        if (std::filesystem::exists(modelDir + "targets.mhpack") && pack.open(modelDir + "targets.mhpack")) {
+            targets = pack.decodeCategory("");
+        } else if (std::filesystem::exists(targetsDir)) {
+            targets = MakeHumanTargetLoader::loadTargetsFromDirectory(targetsDir);
+        }
+        for (const auto& target : targets) {
+            outModel.blendShapes.addTarget(target);
+            
+            // Create channel for each target
+            BlendShapeChannel channel;
+            channel.name = target.name;
+            channel.targetIndices.push_back(static_cast<int>(outModel.blendShapes.getTargetCount()) - 1);
+            channel.targetWeights.push_back(1.0f);
+            channel.defaultWeight = 0.0f;
+            channel.minWeight = -1.0f;
+            channel.maxWeight = 1.0f;
+            outModel.blendShapes.addChannel(channel);
         }
         
         // Initialize skeleton
@@ -314,8 +670,8 @@ public:
                 }
                 
                 if (face.t[i] >= 0 && face.t[i] < (int)texCoords.size()) {
-                    v.texCoord[0] = texCoords[face.t[i]].x;
-                    v.texCoord[1] = texCoords[face.t[i]].y;
+                    v.uv[0] = texCoords[face.t[i]].x;
+                    v.uv[1] = texCoords[face.t[i]].y;
                 }
                 
                 outModel.indices.push_back(static_cast<uint32_t>(outModel.vertices.size()));
@@ -404,6 +760,8 @@ public:
     // Set base path for MakeHuman assets
     void setAssetPath(const std::string& path) {
         assetPath_ = path;
+        pack_.close();
+        packChecked_ = false;
     }
     
     const std::string& getAssetPath() const {
@@ -437,18 +795,36 @@ public:
         return MakeHumanLoader::loadModel(assetPath_, outModel);
     }
     
-    // Load specific targets by category
+    // Load specific targets by category (decoded from the pack when present)
     std::vector<BlendShapeTarget> loadTargetCategory(const std::string& category) {
+        if (const MakeHumanTargetPack* pack = getTargetPack()) {
+            return pack->decodeCategory(category);
+        }
         std::string categoryPath = assetPath_ + "/targets/" + category + "/";
         return MakeHumanTargetLoader::loadTargetsFromDirectory(categoryPath);
     }
     
+    // targets.mhpack of the asset folder, mapped on first use; nullptr if
+    // it was never built or failed to open (see getTargetPackError())
+    const MakeHumanTargetPack* getTargetPack() {
+        if (!packChecked_) {
+            packChecked_ = true;
+            std::string path = assetPath_ + "/targets.mhpack";
+            if (std::filesystem::exists(path)) pack_.open(path);
+        }
+        return pack_.isOpen() ? &pack_ : nullptr;
+    }
+    
+    const std::string& getTargetPackError() const { return pack_.getError(); }
+    
 private:
     MakeHumanAssetManager() {
         assetPath_ = "assets/makehuman";
     }
     
     std::string assetPath_;
+    MakeHumanTargetPack pack_;
+    bool packChecked_ = false;
 };
 
 // ============================================================================
@@ -0,0 +1,730 @@
+// Skin Deformer - Fused blend shape, tangent and skinning stage on the CPU
+// The base mesh and blend shape deltas are compiled once into SoA streams.
+// An update blends the active targets and rebuilds tangents (only when the
+// weights changed), then skins straight into an upload-ready Vertex buffer.
+// SkinDeformerBatch updates many characters in parallel.
+// Part of LUMA Character Creation System
+#pragma once
+
+#include "engine/foundation/math_types.h"
+#include "engine/renderer/mesh.h"
+#include "engine/character/blend_shape.h"
+#include "engine/foundation/worker_pool.h"
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define LUMA_SKIN_SSE 1
+#elif defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define LUMA_SKIN_NEON 1
+#endif
+
+namespace luma {
+
+enum class SkinningMode : uint8_t {
+    Linear = 0,         // Linear blend skinning (matrix palette)
+    DualQuaternion      // Volume preserving at twisting joints; ignores bone scale
+};
+
+// Milliseconds spent in each stage by the last update()
+struct DeformTimings {
+    double blendMs = 0.0;
+    double tangentMs = 0.0;
+    double skinMs = 0.0;
+    bool reblended = false;     // Weights changed, blend + tangent stages ran
+};
+
+namespace skin {
+
+// ===== 4-wide Float Vector =====
+#if defined(LUMA_SKIN_SSE)
+using Float4 = __m128;
+inline Float4 load4(const float* p) { return _mm_loadu_ps(p); }
+inline void store4(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+inline Float4 set4(float v) { return _mm_set1_ps(v); }
+inline Float4 add4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 sub4(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 mul4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 madd4(Float4 acc, Float4 a, Float4 b) { return _mm_add_ps(acc, _mm_mul_ps(a, b)); }
+inline Float4 max4(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+inline Float4 invSqrt4(Float4 v) { return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(v)); }
+inline float hsum4(Float4 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuf));
+}
+#elif defined(LUMA_SKIN_NEON)
+using Float4 = float32x4_t;
+inline Float4 load4(const float* p) { return vld1q_f32(p); }
+inline void store4(float* p, Float4 v) { vst1q_f32(p, v); }
+inline Float4 set4(float v) { return vdupq_n_f32(v); }
+inline Float4 add4(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+inline Float4 sub4(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+inline Float4 mul4(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+inline Float4 madd4(Float4 acc, Float4 a, Float4 b) { return vmlaq_f32(acc, a, b); }
+inline Float4 max4(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+inline Float4 invSqrt4(Float4 v) { return vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(v)); }
+inline float hsum4(Float4 v) { return vaddvq_f32(v); }
+#else
+struct Float4 { float v[4]; };
+inline Float4 load4(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store4(float* p, Float4 a) { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+inline Float4 set4(float x) { return {{x, x, x, x}}; }
+inline Float4 add4(Float4 a, Float4 b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+inline Float4 sub4(Float4 a, Float4 b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+inline Float4 mul4(Float4 a, Float4 b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+inline Float4 madd4(Float4 acc, Float4 a, Float4 b) { return add4(acc, mul4(a, b)); }
+inline Float4 max4(Float4 a, Float4 b) {
+    return {{std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3])}};
+}
+inline Float4 invSqrt4(Float4 a) {
+    return {{1.0f / std::sqrt(a.v[0]), 1.0f / std::sqrt(a.v[1]), 1.0f / std::sqrt(a.v[2]), 1.0f / std::sqrt(a.v[3])}};
+}
+inline float hsum4(Float4 a) { return (a.v[0] + a.v[1]) + (a.v[2] + a.v[3]); }
+#endif
+
+// ===== SoA Kernels =====
+// Streams are padded to a multiple of 4 so the loops have no scalar tail.
+
+inline size_t padded(size_t count) { return (count + 3) & ~size_t(3); }
+
+// Scales (x, y, z) to unit length; zero vectors stay zero
+inline void normalize(float* x, float* y, float* z, size_t count) {
+    Float4 tiny = set4(1e-20f);
+    for (size_t i = 0; i < count; i += 4) {
+        Float4 vx = load4(x + i), vy = load4(y + i), vz = load4(z + i);
+        Float4 len2 = madd4(madd4(mul4(vx, vx), vy, vy), vz, vz);
+        Float4 inv = invSqrt4(max4(len2, tiny));
+        store4(x + i, mul4(vx, inv));
+        store4(y + i, mul4(vy, inv));
+        store4(z + i, mul4(vz, inv));
+    }
+}
+
+// t = normalize(t - n * dot(n, t)), with n unit length
+inline void orthogonalize(float* tx, float* ty, float* tz,
+                          const float* nx, const float* ny, const float* nz, size_t count) {
+    for (size_t i = 0; i < count; i += 4) {
+        Float4 vx = load4(tx + i), vy = load4(ty + i), vz = load4(tz + i);
+        Float4 ux = load4(nx + i), uy = load4(ny + i), uz = load4(nz + i);
+        Float4 d = madd4(madd4(mul4(ux, vx), uy, vy), uz, vz);
+        store4(tx + i, sub4(vx, mul4(ux, d)));
+        store4(ty + i, sub4(vy, mul4(uy, d)));
+        store4(tz + i, sub4(vz, mul4(uz, d)));
+    }
+    normalize(tx, ty, tz, count);
+}
+
+// Unit quaternion (x, y, z, w) of the rotation part of an affine matrix
+inline void rotationOf(const Mat4& m, float q[4]) {
+    float c[3][3];
+    for (int col = 0; col < 3; col++) {
+        float x = m.m[col * 4 + 0], y = m.m[col * 4 + 1], z = m.m[col * 4 + 2];
+        float len = std::sqrt(x * x + y * y + z * z);
+        float inv = len > 1e-12f ? 1.0f / len : 0.0f;
+        c[col][0] = x * inv; c[col][1] = y * inv; c[col][2] = z * inv;
+    }
+    // c[col][row]
+    float trace = c[0][0] + c[1][1] + c[2][2];
+    if (trace > 0.0f) {
+        float s = std::sqrt(trace + 1.0f) * 2.0f;
+        q[3] = 0.25f * s;
+        q[0] = (c[1][2] - c[2][1]) / s;
+        q[1] = (c[2][0] - c[0][2]) / s;
+        q[2] = (c[0][1] - c[1][0]) / s;
+    } else if (c[0][0] > c[1][1] && c[0][0] > c[2][2]) {
+        float s = std::sqrt(1.0f + c[0][0] - c[1][1] - c[2][2]) * 2.0f;
+        q[3] = (c[1][2] - c[2][1]) / s;
+        q[0] = 0.25f * s;
+        q[1] = (c[1][0] + c[0][1]) / s;
+        q[2] = (c[2][0] + c[0][2]) / s;
+    } else if (c[1][1] > c[2][2]) {
+        float s = std::sqrt(1.0f + c[1][1] - c[0][0] - c[2][2]) * 2.0f;
+        q[3] = (c[2][0] - c[0][2]) / s;
+        q[0] = (c[1][0] + c[0][1]) / s;
+        q[1] = 0.25f * s;
+        q[2] = (c[2][1] + c[1][2]) / s;
+    } else {
+        float s = std::sqrt(1.0f + c[2][2] - c[0][0] - c[1][1]) * 2.0f;
+        q[3] = (c[0][1] - c[1][0]) / s;
+        q[0] = (c[2][0] + c[0][2]) / s;
+        q[1] = (c[2][1] + c[1][2]) / s;
+        q[2] = 0.25f * s;
+    }
+}
+
+}  // namespace skin
+
+// ============================================================================
+// Skin Deformer - One mesh instance
+// ============================================================================
+
+class SkinDeformer {
+public:
+    static constexpr int MAX_INFLUENCES = 4;
+
+    SkinDeformer() = default;
+
+    // === Setup ===
+
+    // Compiles the base mesh into SoA streams. Indices are only needed for
+    // tangent rebuilding; without them the base tangents are skinned as-is.
+    void setBaseMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices) {
+        vertexCount_ = vertices.size();
+        size_t n = skin::padded(vertexCount_);
+        for (int s = 0; s < STREAM_COUNT; s++) base_[s].assign(n, 0.0f);
+        attributes_.resize(vertexCount_);
+        for (size_t i = 0; i < vertexCount_; i++) {
+            const Vertex& v = vertices[i];
+            for (int a = 0; a < 3; a++) {
+                base_[PX + a][i] = v.position[a];
+                base_[NX + a][i] = v.normal[a];
+                base_[TX + a][i] = v.tangent[a];
+            }
+            // Same fallback as UVMapper::calculateTangents for missing tangents
+            if (v.tangent[0] * v.tangent[0] + v.tangent[1] * v.tangent[1] + v.tangent[2] * v.tangent[2] < 1e-8f) {
+                bool upright = std::abs(v.normal[1]) < 0.9f;
+                base_[TX][i] = upright ? 1.0f : 0.0f;
+                base_[TZ][i] = upright ? 0.0f : 1.0f;
+            }
+            Attributes& attr = attributes_[i];
+            attr.handedness = v.tangent[3] < 0.0f ? -1.0f : 1.0f;
+            std::memcpy(attr.uv, v.uv, sizeof(attr.uv));
+            std::memcpy(attr.color, v.color, sizeof(attr.color));
+        }
+        indices_.clear();
+        indices_.reserve(indices.size());
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            if (indices[i] >= vertexCount_ || indices[i + 1] >= vertexCount_ || indices[i + 2] >= vertexCount_) continue;
+            indices_.insert(indices_.end(), {indices[i], indices[i + 1], indices[i + 2]});
+        }
+        influences_.clear();
+        blendShapes_ = nullptr;
+        targets_.clear();
+        compiledTargetCount_ = 0;
+        activeWeights_.clear();
+        blended_ = false;
+        outputValid_ = false;
+    }
+
+    // Blend shapes are read by reference; call invalidateBlendShapes() after
+    // editing target deltas in place
+    void setBlendShapes(const BlendShapeMesh* blendShapes) {
+        if (blendShapes != blendShapes_) {
+            blendShapes_ = blendShapes;
+            invalidateBlendShapes();
+        }
+    }
+
+    void invalidateBlendShapes() {
+        targets_.clear();
+        compiledTargetCount_ = 0;
+        activeWeights_.clear();
+        blended_ = false;
+        outputValid_ = false;
+    }
+
+    // Per-vertex bone influences from any type with boneIndices[4] and
+    // boneWeights[4] (SkinVertex, SkinnedVertex). Weights are renormalized.
+    template<typename SkinT>
+    void setSkinWeights(const std::vector<SkinT>& skinData) {
+        influences_.assign(vertexCount_, Influences{});
+        size_t count = std::min(skinData.size(), vertexCount_);
+        for (size_t i = 0; i < count; i++) {
+            Influences& inf = influences_[i];
+            float total = 0.0f;
+            for (int k = 0; k < MAX_INFLUENCES; k++) {
+                float w = skinData[i].boneWeights[k];
+                if (w <= 0.0f || skinData[i].boneIndices[k] >= MAX_BONES) continue;
+                inf.bone[inf.count] = static_cast<uint16_t>(skinData[i].boneIndices[k]);
+                inf.weight[inf.count] = w;
+                inf.count++;
+                total += w;
+            }
+            for (int k = 0; k < inf.count; k++) inf.weight[k] /= total;
+        }
+        outputValid_ = false;
+    }
+
+    // Bone palette for this frame (from Animator::getSkinningMatrices);
+    // copied, so the caller's array may be reused immediately. The last
+    // palette stays in effect until the next call or clearPose().
+    void setBoneMatrices(const Mat4* matrices, size_t count) {
+        count = std::min<size_t>(count, MAX_BONES);
+        bones_.assign(matrices, matrices + count);
+        posed_ = true;
+    }
+
+    void clearPose() {
+        bones_.clear();
+        posed_ = false;
+        outputValid_ = false;
+    }
+
+    void setMode(SkinningMode mode) {
+        if (mode != mode_) { mode_ = mode; outputValid_ = false; }
+    }
+    SkinningMode getMode() const { return mode_; }
+
+    void setRebuildTangents(bool rebuild) {
+        if (rebuild != rebuildTangents_) { rebuildTangents_ = rebuild; blended_ = false; }
+    }
+
+    // === Update ===
+
+    // Writes vertexCount() vertices to `out`. Returns false (and leaves `out`
+    // untouched) when neither the weights nor the pose changed since the
+    // last update into the same buffer.
+    bool update(Vertex* out) {
+        timings_ = DeformTimings{};
+        if (vertexCount_ == 0 || !out) return false;
+
+        auto t0 = std::chrono::steady_clock::now();
+        bool reblend = refreshWeights();
+        auto t1 = std::chrono::steady_clock::now();
+        if (reblend) {
+            blend();
+            t1 = std::chrono::steady_clock::now();
+            rebuildTangents();
+            timings_.reblended = true;
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        bool skinned = !bones_.empty() && !influences_.empty();
+        bool changed = reblend || posed_ || !outputValid_ || out != lastOutput_;
+        if (changed) {
+            if (skinned && mode_ == SkinningMode::DualQuaternion) skinDualQuaternion(out);
+            else if (skinned) skinLinear(out);
+            else writeUnskinned(out);
+        }
+        posed_ = false;
+        outputValid_ = true;
+        lastOutput_ = out;
+        auto t3 = std::chrono::steady_clock::now();
+
+        timings_.blendMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        timings_.tangentMs = std::chrono::duration<double, std::milli>(t2 - t1).count();
+        timings_.skinMs = std::chrono::duration<double, std::milli>(t3 - t2).count();
+        return changed;
+    }
+
+    // Update into the deformer's own buffer
+    bool update() {
+        output_.resize(vertexCount_);
+        return update(output_.data());
+    }
+
+    // === Queries ===
+
+    size_t vertexCount() const { return vertexCount_; }
+    const std::vector<Vertex>& getOutput() const { return output_; }
+    const DeformTimings& getTimings() const { return timings_; }
+    size_t getActiveTargetCount() const { return activeTargets_.size(); }
+
+private:
+    enum Stream { PX, PY, PZ, NX, NY, NZ, TX, TY, TZ, STREAM_COUNT };
+
+    struct Attributes {
+        float handedness;
+        float uv[2];
+        float color[3];
+    };
+
+    struct Influences {
+        uint16_t bone[MAX_INFLUENCES] = {0, 0, 0, 0};
+        float weight[MAX_INFLUENCES] = {0, 0, 0, 0};
+        int count = 0;
+    };
+
+    // Targets touching more than a quarter of the mesh are stored dense so
+    // they blend as straight vector loops; the rest scatter
+    struct CompiledTarget {
+        bool dense = false;
+        std::vector<uint32_t> indices;
+        std::vector<float> delta[6];    // Position xyz, normal xyz
+    };
+
+    void compileTargets() {
+        targets_.clear();
+        compiledTargetCount_ = blendShapes_->getTargetCount();
+        targets_.resize(compiledTargetCount_);
+        size_t n = skin::padded(vertexCount_);
+        for (size_t t = 0; t < compiledTargetCount_; t++) {
+            const BlendShapeTarget* target = blendShapes_->getTarget(static_cast<int>(t));
+            CompiledTarget& ct = targets_[t];
+            ct.dense = target->deltas.size() * 4 > vertexCount_;
+            for (auto& d : ct.delta) d.assign(ct.dense ? n : 0, 0.0f);
+            for (const auto& delta : target->deltas) {
+                if (delta.vertexIndex >= vertexCount_) continue;
+                const float values[6] = {delta.positionDelta.x, delta.positionDelta.y, delta.positionDelta.z,
+                                         delta.normalDelta.x, delta.normalDelta.y, delta.normalDelta.z};
+                if (ct.dense) {
+                    for (int s = 0; s < 6; s++) ct.delta[s][delta.vertexIndex] += values[s];
+                } else {
+                    ct.indices.push_back(delta.vertexIndex);
+                    for (int s = 0; s < 6; s++) ct.delta[s].push_back(values[s]);
+                }
+            }
+        }
+    }
+
+    // Combined per-target weights, with the same thresholds as
+    // BlendShapeMesh::applyToMesh. True when they differ from the last blend.
+    bool refreshWeights() {
+        if (blendShapes_ && blendShapes_->getTargetCount() != compiledTargetCount_) {
+            compileTargets();
+            blended_ = false;
+        }
+        weights_.assign(compiledTargetCount_, 0.0f);
+        if (blendShapes_) {
+            for (size_t c = 0; c < blendShapes_->getChannelCount(); c++) {
+                const BlendShapeChannel* channel = blendShapes_->getChannel(static_cast<int>(c));
+                if (std::abs(channel->weight) < 0.001f) continue;
+                for (size_t i = 0; i < channel->targetIndices.size(); i++) {
+                    uint32_t idx = channel->targetIndices[i];
+                    if (idx < compiledTargetCount_) weights_[idx] += channel->weight * channel->targetWeights[i];
+                }
+            }
+        }
+        activeTargets_.clear();
+        for (size_t t = 0; t < weights_.size(); t++) {
+            if (std::abs(weights_[t]) >= 0.001f) activeTargets_.push_back({static_cast<uint32_t>(t), weights_[t]});
+        }
+        if (blended_ && activeTargets_ == activeWeights_) return false;
+        activeWeights_ = activeTargets_;
+        blended_ = true;
+        return true;
+    }
+
+    void blend() {
+        size_t n = skin::padded(vertexCount_);
+        for (int s = 0; s < STREAM_COUNT; s++) current_[s].resize(n);
+        // Dense targets: one pass per stream, base plus all targets summed in
+        // registers; streams they don't touch are plain copies
+        denseDeltas_.clear();
+        denseWeights_.clear();
+        for (const auto& [index, weight] : activeTargets_) {
+            if (!targets_[index].dense) continue;
+            denseDeltas_.push_back(&targets_[index]);
+            denseWeights_.push_back(weight);
+        }
+        for (int s = denseDeltas_.empty() ? 0 : 6; s < STREAM_COUNT; s++) {
+            std::memcpy(current_[s].data(), base_[s].data(), n * sizeof(float));
+        }
+        if (activeTargets_.empty()) return;
+        if (!denseDeltas_.empty()) {
+            size_t count = denseDeltas_.size();
+            denseStreams_.resize(count);
+            for (int s = 0; s < 6; s++) {
+                for (size_t t = 0; t < count; t++) denseStreams_[t] = denseDeltas_[t]->delta[s].data();
+                const float* const* streams = denseStreams_.data();
+                const float* weights = denseWeights_.data();
+                const float* src = base_[s].data();
+                float* dst = current_[s].data();
+                for (size_t i = 0; i < n; i += 4) {
+                    skin::Float4 acc = skin::load4(src + i);
+                    for (size_t t = 0; t < count; t++) {
+                        acc = skin::madd4(acc, skin::load4(streams[t] + i), skin::set4(weights[t]));
+                    }
+                    skin::store4(dst + i, acc);
+                }
+            }
+        }
+        for (const auto& [index, weight] : activeTargets_) {
+            const CompiledTarget& ct = targets_[index];
+            if (!ct.dense) {
+                for (int s = 0; s < 6; s++) {
+                    float* dst = current_[s].data();
+                    const float* delta = ct.delta[s].data();
+                    for (size_t i = 0; i < ct.indices.size(); i++) dst[ct.indices[i]] += delta[i] * weight;
+                }
+            }
+        }
+        skin::normalize(current_[NX].data(), current_[NY].data(), current_[NZ].data(), n);
+    }
+
+    // Triangle tangents from the blended positions, orthogonalized against
+    // the blended normals. Base tangents are added with a tiny weight so
+    // vertices with degenerate UVs keep their original direction.
+    void rebuildTangents() {
+        if (!rebuildTangents_ || indices_.empty() || activeTargets_.empty()) return;
+        size_t n = skin::padded(vertexCount_);
+        float* tx = current_[TX].data();
+        float* ty = current_[TY].data();
+        float* tz = current_[TZ].data();
+        const float* px = current_[PX].data();
+        const float* py = current_[PY].data();
+        const float* pz = current_[PZ].data();
+        for (size_t i = 0; i < n; i++) {
+            tx[i] = base_[TX][i] * 1e-4f;
+            ty[i] = base_[TY][i] * 1e-4f;
+            tz[i] = base_[TZ][i] * 1e-4f;
+        }
+        for (size_t i = 0; i < indices_.size(); i += 3) {
+            uint32_t i0 = indices_[i], i1 = indices_[i + 1], i2 = indices_[i + 2];
+            const float* uv0 = attributes_[i0].uv;
+            const float* uv1 = attributes_[i1].uv;
+            const float* uv2 = attributes_[i2].uv;
+            float du1 = uv1[0] - uv0[0], dv1 = uv1[1] - uv0[1];
+            float du2 = uv2[0] - uv0[0], dv2 = uv2[1] - uv0[1];
+            float det = du1 * dv2 - du2 * dv1;
+            if (std::abs(det) < 0.0001f) det = 1.0f;
+            float a = dv2 / det, b = -dv1 / det;
+            float e1x = px[i1] - px[i0], e1y = py[i1] - py[i0], e1z = pz[i1] - pz[i0];
+            float e2x = px[i2] - px[i0], e2y = py[i2] - py[i0], e2z = pz[i2] - pz[i0];
+            float x = e1x * a + e2x * b, y = e1y * a + e2y * b, z = e1z * a + e2z * b;
+            tx[i0] += x; ty[i0] += y; tz[i0] += z;
+            tx[i1] += x; ty[i1] += y; tz[i1] += z;
+            tx[i2] += x; ty[i2] += y; tz[i2] += z;
+        }
+        skin::orthogonalize(tx, ty, tz, current_[NX].data(), current_[NY].data(), current_[NZ].data(), n);
+    }
+
+    static void writeAttributes(Vertex& v, const Attributes& attr) {
+        v.tangent[3] = attr.handedness;
+        v.uv[0] = attr.uv[0];
+        v.uv[1] = attr.uv[1];
+        v.color[0] = attr.color[0];
+        v.color[1] = attr.color[1];
+        v.color[2] = attr.color[2];
+    }
+
+    void writeUnskinned(Vertex* out) const {
+        const float* px = current_[PX].data(); const float* py = current_[PY].data(); const float* pz = current_[PZ].data();
+        const float* nx = current_[NX].data(); const float* ny = current_[NY].data(); const float* nz = current_[NZ].data();
+        const float* tx = current_[TX].data(); const float* ty = current_[TY].data(); const float* tz = current_[TZ].data();
+        const Attributes* attributes = attributes_.data();
+        for (size_t i = 0; i < vertexCount_; i++) {
+            Vertex& v = out[i];
+            v.position[0] = px[i]; v.position[1] = py[i]; v.position[2] = pz[i];
+            v.normal[0] = nx[i]; v.normal[1] = ny[i]; v.normal[2] = nz[i];
+            v.tangent[0] = tx[i]; v.tangent[1] = ty[i]; v.tangent[2] = tz[i];
+            writeAttributes(v, attributes[i]);
+        }
+    }
+
+    static_assert(offsetof(Vertex, normal) == offsetof(Vertex, position) + 3 * sizeof(float) &&
+                  offsetof(Vertex, tangent) == offsetof(Vertex, normal) + 3 * sizeof(float),
+                  "skinLinear stores position, normal and tangent with overlapping 4-wide writes");
+
+    // Blended matrix columns c0..c3 (one register each, vectorized over the
+    // xyz lanes), then p' = c0 x + c1 y + c2 z + c3
+    void skinLinear(Vertex* out) const {
+        using namespace skin;
+        const Mat4* bones = bones_.data();
+        size_t boneCount = bones_.size();
+        // Local stream pointers: stores through `out` could alias the vectors
+        const float* px = current_[PX].data(); const float* py = current_[PY].data(); const float* pz = current_[PZ].data();
+        const float* nx = current_[NX].data(); const float* ny = current_[NY].data(); const float* nz = current_[NZ].data();
+        const float* tx = current_[TX].data(); const float* ty = current_[TY].data(); const float* tz = current_[TZ].data();
+        const Attributes* attributes = attributes_.data();
+        const Influences* influences = influences_.data();
+        Float4 zero = set4(0.0f);
+        for (size_t i = 0; i < vertexCount_; i++) {
+            const Influences& inf = influences[i];
+            Float4 c0 = zero, c1 = zero, c2 = zero, c3 = zero;
+            float total = 0.0f;
+            for (int k = 0; k < inf.count; k++) {
+                if (inf.bone[k] >= boneCount) continue;
+                const float* m = bones[inf.bone[k]].m;
+                Float4 w = set4(inf.weight[k]);
+                c0 = madd4(c0, load4(m), w);
+                c1 = madd4(c1, load4(m + 4), w);
+                c2 = madd4(c2, load4(m + 8), w);
+                c3 = madd4(c3, load4(m + 12), w);
+                total += inf.weight[k];
+            }
+            if (total == 0.0f) {
+                // Unweighted vertices stay in bind pose
+                const float identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+                c0 = load4(identity); c1 = load4(identity + 4); c2 = load4(identity + 8); c3 = load4(identity + 12);
+            }
+            Float4 p = madd4(madd4(madd4(c3, c0, set4(px[i])), c1, set4(py[i])), c2, set4(pz[i]));
+            Float4 nrm = madd4(madd4(mul4(c0, set4(nx[i])), c1, set4(ny[i])), c2, set4(nz[i]));
+            Float4 tan = madd4(madd4(mul4(c0, set4(tx[i])), c1, set4(ty[i])), c2, set4(tz[i]));
+            float nl = hsum4(mul4(nrm, nrm)), tl = hsum4(mul4(tan, tan));
+            nrm = mul4(nrm, set4(nl > 1e-20f ? 1.0f / std::sqrt(nl) : 0.0f));
+            tan = mul4(tan, set4(tl > 1e-20f ? 1.0f / std::sqrt(tl) : 0.0f));
+            // position, normal and tangent are contiguous: each store spills
+            // one lane into the next field, which the following store rewrites
+            Vertex& v = out[i];
+            store4(v.position, p);
+            store4(v.normal, nrm);
+            store4(v.tangent, tan);
+            writeAttributes(v, attributes[i]);
+        }
+    }
+
+    // Per bone (real, dual) quaternions, blended per vertex along the
+    // shortest arc to the first influence
+    void skinDualQuaternion(Vertex* out) {
+        using namespace skin;
+        dualQuats_.resize(bones_.size() * 8);
+        for (size_t b = 0; b < bones_.size(); b++) {
+            float* dq = &dualQuats_[b * 8];
+            rotationOf(bones_[b], dq);
+            float tx = bones_[b].m[12], ty = bones_[b].m[13], tz = bones_[b].m[14];
+            // dual = 0.5 * (t, 0) * real
+            dq[4] = 0.5f * (tx * dq[3] + ty * dq[2] - tz * dq[1]);
+            dq[5] = 0.5f * (-tx * dq[2] + ty * dq[3] + tz * dq[0]);
+            dq[6] = 0.5f * (tx * dq[1] - ty * dq[0] + tz * dq[3]);
+            dq[7] = 0.5f * (-tx * dq[0] - ty * dq[1] - tz * dq[2]);
+        }
+        size_t boneCount = bones_.size();
+        const float* px = current_[PX].data(); const float* py = current_[PY].data(); const float* pz = current_[PZ].data();
+        const float* nx = current_[NX].data(); const float* ny = current_[NY].data(); const float* nz = current_[NZ].data();
+        const float* tx = current_[TX].data(); const float* ty = current_[TY].data(); const float* tz = current_[TZ].data();
+        const Attributes* attributes = attributes_.data();
+        const Influences* influences = influences_.data();
+        const float* dualQuats = dualQuats_.data();
+        alignas(16) float r[4], d[4];
+        for (size_t i = 0; i < vertexCount_; i++) {
+            const Influences& inf = influences[i];
+            Float4 real = set4(0.0f), dual = set4(0.0f);
+            const float* pivot = nullptr;
+            for (int k = 0; k < inf.count; k++) {
+                if (inf.bone[k] >= boneCount) continue;
+                const float* dq = dualQuats + inf.bone[k] * 8;
+                if (!pivot) pivot = dq;
+                float dot = pivot[0] * dq[0] + pivot[1] * dq[1] + pivot[2] * dq[2] + pivot[3] * dq[3];
+                Float4 w = set4(dot < 0.0f ? -inf.weight[k] : inf.weight[k]);
+                real = madd4(real, load4(dq), w);
+                dual = madd4(dual, load4(dq + 4), w);
+            }
+            store4(r, real);
+            store4(d, dual);
+            float len = std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2] + r[3] * r[3]);
+            if (!pivot || len < 1e-8f) {
+                r[0] = r[1] = r[2] = 0.0f; r[3] = 1.0f;
+                d[0] = d[1] = d[2] = d[3] = 0.0f;
+            } else {
+                float inv = 1.0f / len;
+                for (int a = 0; a < 4; a++) { r[a] *= inv; d[a] *= inv; }
+            }
+            // Translation = 2 * (w_r d_v - w_d r_v + r_v x d_v)
+            float trans[3] = {
+                2.0f * (r[3] * d[0] - d[3] * r[0] + r[1] * d[2] - r[2] * d[1]),
+                2.0f * (r[3] * d[1] - d[3] * r[1] + r[2] * d[0] - r[0] * d[2]),
+                2.0f * (r[3] * d[2] - d[3] * r[2] + r[0] * d[1] - r[1] * d[0])};
+            auto rotate = [&](float x, float y, float z, float* o) {
+                // v + 2 r_v x (r_v x v + w v)
+                float cx = r[1] * z - r[2] * y + r[3] * x;
+                float cy = r[2] * x - r[0] * z + r[3] * y;
+                float cz = r[0] * y - r[1] * x + r[3] * z;
+                o[0] = x + 2.0f * (r[1] * cz - r[2] * cy);
+                o[1] = y + 2.0f * (r[2] * cx - r[0] * cz);
+                o[2] = z + 2.0f * (r[0] * cy - r[1] * cx);
+            };
+            Vertex& v = out[i];
+            rotate(px[i], py[i], pz[i], v.position);
+            for (int a = 0; a < 3; a++) v.position[a] += trans[a];
+            rotate(nx[i], ny[i], nz[i], v.normal);
+            rotate(tx[i], ty[i], tz[i], v.tangent);
+            writeAttributes(v, attributes[i]);
+        }
+    }
+
+    size_t vertexCount_ = 0;
+    std::vector<float> base_[STREAM_COUNT];
+    std::vector<float> current_[STREAM_COUNT];
+    std::vector<Attributes> attributes_;
+    std::vector<uint32_t> indices_;
+    std::vector<Influences> influences_;
+
+    const BlendShapeMesh* blendShapes_ = nullptr;
+    std::vector<CompiledTarget> targets_;
+    size_t compiledTargetCount_ = 0;
+    std::vector<float> weights_;
+    std::vector<std::pair<uint32_t, float>> activeTargets_;
+    std::vector<std::pair<uint32_t, float>> activeWeights_;     // Weights of the current blend
+    std::vector<const CompiledTarget*> denseDeltas_;
+    std::vector<float> denseWeights_;
+    std::vector<const float*> denseStreams_;
+    bool blended_ = false;
+    bool rebuildTangents_ = true;
+
+    std::vector<Mat4> bones_;
+    std::vector<float> dualQuats_;
+    bool posed_ = false;
+    SkinningMode mode_ = SkinningMode::Linear;
+
+    std::vector<Vertex> output_;
+    const Vertex* lastOutput_ = nullptr;
+    bool outputValid_ = false;
+    DeformTimings timings_;
+};
+
+// ============================================================================
+// Skin Deformer Batch - Parallel update of many characters
+// ============================================================================
+
+struct DeformBatchStats {
+    double wallMs = 0.0;
+    double blendMs = 0.0;       // Stage totals summed over all characters
+    double tangentMs = 0.0;
+    double skinMs = 0.0;
+    size_t characters = 0;
+    size_t updated = 0;         // Characters whose output changed
+    size_t vertices = 0;
+    int threads = 1;
+};
+
+// Whole characters are handed to a WorkerPool one at a time; the calling
+// thread works too.
+class SkinDeformerBatch {
+public:
+    struct Job {
+        SkinDeformer* deformer = nullptr;
+        Vertex* output = nullptr;       // nullptr = the deformer's own buffer
+    };
+
+    explicit SkinDeformerBatch(int threads = 0) : pool_(threads) {}
+
+    SkinDeformerBatch(const SkinDeformerBatch&) = delete;
+    SkinDeformerBatch& operator=(const SkinDeformerBatch&) = delete;
+
+    void run(const std::vector<Job>& jobs) {
+        auto start = std::chrono::steady_clock::now();
+        results_.assign(jobs.size(), 0);
+        auto body = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) runJob(jobs[i], i);
+        };
+        pool_.parallelFor(jobs.size(), 1, body);
+
+        stats_ = DeformBatchStats{};
+        stats_.threads = pool_.getThreadCount();
+        stats_.characters = jobs.size();
+        for (size_t i = 0; i < jobs.size(); i++) {
+            const DeformTimings& t = jobs[i].deformer->getTimings();
+            stats_.blendMs += t.blendMs;
+            stats_.tangentMs += t.tangentMs;
+            stats_.skinMs += t.skinMs;
+            stats_.updated += results_[i];
+            stats_.vertices += jobs[i].deformer->vertexCount();
+        }
+        stats_.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    const DeformBatchStats& getStats() const { return stats_; }
+    // Whether job `index` of the last run() rewrote its output
+    bool wasUpdated(size_t index) const { return index < results_.size() && results_[index] != 0; }
+    int getThreadCount() const { return pool_.getThreadCount(); }
+
+private:
+    void runJob(const Job& job, size_t index) {
+        results_[index] = job.output ? job.deformer->update(job.output) : job.deformer->update();
+    }
+
+    WorkerPool pool_;
+    std::vector<uint8_t> results_;
+    DeformBatchStats stats_;
+};
+
+} // namespace luma
@@ -0,0 +1,416 @@
+// Skinning BVH - Spatial acceleration for weight generation and transfer
+// Capsule BVH for bone influence queries, triangle BVH for closest-point
+// queries against a body surface, and CSR vertex adjacency for smoothing
+#pragma once
+
+#include "engine/foundation/math_types.h"
+#include <vector>
+#include <cstdint>
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+
+namespace luma {
+
+// ============================================================================
+// Shared node layout
+// ============================================================================
+
+namespace skinbvh {
+
+// Children of an inner node are stored as an adjacent pair starting at
+// first. count > 0 marks a leaf.
+struct Node {
+    float lo[3];
+    float hi[3];
+    uint32_t first = 0;     // Leaf: first item / Inner: left child
+    uint32_t count = 0;
+};
+
+inline float boxDistanceSq(const Node& n, const Vec3& p) {
+    float dx = std::max(std::max(n.lo[0] - p.x, p.x - n.hi[0]), 0.0f);
+    float dy = std::max(std::max(n.lo[1] - p.y, p.y - n.hi[1]), 0.0f);
+    float dz = std::max(std::max(n.lo[2] - p.z, p.z - n.hi[2]), 0.0f);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+inline bool boxContains(const Node& n, const Vec3& p) {
+    return p.x >= n.lo[0] && p.x <= n.hi[0] &&
+           p.y >= n.lo[1] && p.y <= n.hi[1] &&
+           p.z >= n.lo[2] && p.z <= n.hi[2];
+}
+
+// Builds nodes over items given per-item bounds and centroids. order is
+// permuted so each leaf covers order[first, first + count).
+inline void build(std::vector<Node>& nodes, std::vector<uint32_t>& order,
+                  const std::vector<float>& bounds,      // 6 floats per item
+                  const std::vector<float>& centroids,   // 3 floats per item
+                  uint32_t leafSize)
+{
+    nodes.clear();
+    order.resize(centroids.size() / 3);
+    std::iota(order.begin(), order.end(), 0u);
+    if (order.empty()) return;
+    nodes.reserve(order.size() * 2 / leafSize + 1);
+
+    struct Task { uint32_t begin, end, node; };
+    std::vector<Task> stack;
+    nodes.emplace_back();
+    stack.push_back({0, (uint32_t)order.size(), 0});
+
+    while (!stack.empty()) {
+        Task t = stack.back();
+        stack.pop_back();
+
+        Node node;
+        float clo[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+        float chi[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+        for (int a = 0; a < 3; a++) { node.lo[a] = FLT_MAX; node.hi[a] = -FLT_MAX; }
+        for (uint32_t i = t.begin; i < t.end; i++) {
+            const float* b = &bounds[order[i] * 6];
+            const float* c = &centroids[order[i] * 3];
+            for (int a = 0; a < 3; a++) {
+                node.lo[a] = std::min(node.lo[a], b[a]);
+                node.hi[a] = std::max(node.hi[a], b[a + 3]);
+                clo[a] = std::min(clo[a], c[a]);
+                chi[a] = std::max(chi[a], c[a]);
+            }
+        }
+
+        uint32_t n = t.end - t.begin;
+        int axis = 0;
+        if (chi[1] - clo[1] > chi[axis] - clo[axis]) axis = 1;
+        if (chi[2] - clo[2] > chi[axis] - clo[axis]) axis = 2;
+
+        if (n <= leafSize || chi[axis] - clo[axis] <= 0.0f) {
+            node.first = t.begin;
+            node.count = n;
+            nodes[t.node] = node;
+            continue;
+        }
+
+        // Median split along the widest centroid axis
+        uint32_t mid = t.begin + n / 2;
+        std::nth_element(order.begin() + t.begin, order.begin() + mid, order.begin() + t.end,
+            [&](uint32_t x, uint32_t y) { return centroids[x * 3 + axis] < centroids[y * 3 + axis]; });
+
+        uint32_t left = (uint32_t)nodes.size();
+        nodes.emplace_back();
+        nodes.emplace_back();
+        node.first = left;
+        node.count = 0;
+        nodes[t.node] = node;
+
+        stack.push_back({mid, t.end, left + 1});
+        stack.push_back({t.begin, mid, left});
+    }
+}
+
+}  // namespace skinbvh
+
+// ============================================================================
+// Capsule BVH - bone segments with an influence reach
+// ============================================================================
+
+class CapsuleBVH {
+public:
+    struct Capsule {
+        Vec3 start;
+        Vec3 end;
+        float reach = 0.0f;     // Query points further than this are ignored
+    };
+
+    void build(const std::vector<Capsule>& capsules) {
+        capsules_ = capsules;
+        std::vector<float> bounds(capsules.size() * 6);
+        std::vector<float> centroids(capsules.size() * 3);
+        for (size_t i = 0; i < capsules.size(); i++) {
+            const Capsule& c = capsules[i];
+            float* b = &bounds[i * 6];
+            b[0] = std::min(c.start.x, c.end.x) - c.reach;
+            b[1] = std::min(c.start.y, c.end.y) - c.reach;
+            b[2] = std::min(c.start.z, c.end.z) - c.reach;
+            b[3] = std::max(c.start.x, c.end.x) + c.reach;
+            b[4] = std::max(c.start.y, c.end.y) + c.reach;
+            b[5] = std::max(c.start.z, c.end.z) + c.reach;
+            for (int a = 0; a < 3; a++) centroids[i * 3 + a] = (b[a] + b[a + 3]) * 0.5f;
+        }
+        skinbvh::build(nodes_, order_, bounds, centroids, 2);
+    }
+
+    // Distance from p to the capsule's core segment
+    float distance(uint32_t index, const Vec3& p) const {
+        const Capsule& c = capsules_[index];
+        Vec3 ab = c.end - c.start;
+        float len2 = ab.dot(ab);
+        float t = len2 > 0.0f ? std::clamp(ab.dot(p - c.start) / len2, 0.0f, 1.0f) : 0.0f;
+        return (p - (c.start + ab * t)).length();
+    }
+
+    // Calls fn(index, distance) for every capsule whose reach covers p
+    template<typename F>
+    void forEachInReach(const Vec3& p, F&& fn) const {
+        if (nodes_.empty()) return;
+        uint32_t stack[64];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const skinbvh::Node& node = nodes_[stack[--top]];
+            if (!skinbvh::boxContains(node, p)) continue;
+            if (node.count > 0) {
+                for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                    uint32_t idx = order_[i];
+                    float d = distance(idx, p);
+                    if (d < capsules_[idx].reach) fn(idx, d);
+                }
+            } else {
+                stack[top++] = node.first;
+                stack[top++] = node.first + 1;
+            }
+        }
+    }
+
+    // Closest capsule core regardless of reach; -1 if empty
+    int nearest(const Vec3& p, float* outDistance = nullptr) const {
+        int best = -1;
+        float bestDist = FLT_MAX;
+        if (nodes_.empty()) return best;
+        uint32_t stack[64];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            uint32_t ni = stack[--top];
+            const skinbvh::Node& node = nodes_[ni];
+            // Boxes are padded by reach, so this is a conservative bound
+            if (skinbvh::boxDistanceSq(node, p) >= bestDist * bestDist) continue;
+            if (node.count > 0) {
+                for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                    float d = distance(order_[i], p);
+                    if (d < bestDist) { bestDist = d; best = (int)order_[i]; }
+                }
+            } else {
+                stack[top++] = node.first;
+                stack[top++] = node.first + 1;
+            }
+        }
+        if (outDistance) *outDistance = bestDist;
+        return best;
+    }
+
+    size_t size() const { return capsules_.size(); }
+    bool empty() const { return capsules_.empty(); }
+
+private:
+    std::vector<Capsule> capsules_;
+    std::vector<skinbvh::Node> nodes_;
+    std::vector<uint32_t> order_;
+};
+
+// ============================================================================
+// Triangle BVH - closest point on a triangle mesh
+// ============================================================================
+
+class TriangleBVH {
+public:
+    struct Hit {
+        uint32_t triangle = UINT32_MAX;     // Index into the source triangle list
+        float bary[3] = {0, 0, 0};          // Weights of the triangle's 3 vertices
+        float distanceSq = FLT_MAX;
+        Vec3 point;
+
+        bool valid() const { return triangle != UINT32_MAX; }
+    };
+
+    // positions: 3 floats every strideFloats; indices: triangle list
+    void build(const float* positions, size_t strideFloats, size_t vertexCount,
+               const uint32_t* indices, size_t indexCount)
+    {
+        size_t triCount = indexCount / 3;
+        std::vector<float> bounds(triCount * 6);
+        std::vector<float> centroids(triCount * 3);
+        std::vector<Vec3> corners(triCount * 3);
+
+        for (size_t t = 0; t < triCount; t++) {
+            uint32_t ids[3] = {indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2]};
+            if (ids[0] >= vertexCount || ids[1] >= vertexCount || ids[2] >= vertexCount) {
+                ids[0] = ids[1] = ids[2] = 0;   // Out of range: collapse, still indexed
+            }
+            float* b = &bounds[t * 6];
+            b[0] = b[1] = b[2] = FLT_MAX;
+            b[3] = b[4] = b[5] = -FLT_MAX;
+            for (int k = 0; k < 3; k++) {
+                const float* src = positions + ids[k] * strideFloats;
+                corners[t * 3 + k] = Vec3(src[0], src[1], src[2]);
+                for (int a = 0; a < 3; a++) {
+                    b[a] = std::min(b[a], src[a]);
+                    b[a + 3] = std::max(b[a + 3], src[a]);
+                }
+            }
+            for (int a = 0; a < 3; a++) centroids[t * 3 + a] = (b[a] + b[a + 3]) * 0.5f;
+        }
+
+        std::vector<uint32_t> order;
+        skinbvh::build(nodes_, order, bounds, centroids, 4);
+
+        // Store corners in leaf order so leaf scans are sequential
+        tris_.resize(order.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            Tri& tri = tris_[i];
+            tri.a = corners[order[i] * 3];
+            tri.b = corners[order[i] * 3 + 1];
+            tri.c = corners[order[i] * 3 + 2];
+            tri.source = order[i];
+        }
+    }
+
+    Hit closestPoint(const Vec3& p, float maxDistance = FLT_MAX) const {
+        Hit hit;
+        if (nodes_.empty()) return hit;
+        hit.distanceSq = maxDistance < FLT_MAX ? maxDistance * maxDistance : FLT_MAX;
+
+        uint32_t stack[64];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            uint32_t ni = stack[--top];
+            const skinbvh::Node& node = nodes_[ni];
+            if (node.count > 0) {
+                for (uint32_t i = node.first; i < node.first + node.count; i++) {
+                    float bary[3];
+                    Vec3 q = closestOnTriangle(p, tris_[i], bary);
+                    Vec3 d = q - p;
+                    float d2 = d.dot(d);
+                    if (d2 < hit.distanceSq) {
+                        hit.distanceSq = d2;
+                        hit.triangle = tris_[i].source;
+                        hit.point = q;
+                        hit.bary[0] = bary[0];
+                        hit.bary[1] = bary[1];
+                        hit.bary[2] = bary[2];
+                    }
+                }
+                continue;
+            }
+            // Visit the nearer child first so the far one is usually culled
+            uint32_t l = node.first, r = node.first + 1;
+            float dl = skinbvh::boxDistanceSq(nodes_[l], p);
+            float dr = skinbvh::boxDistanceSq(nodes_[r], p);
+            if (dl > dr) { std::swap(l, r); std::swap(dl, dr); }
+            if (dr < hit.distanceSq) stack[top++] = r;
+            if (dl < hit.distanceSq) stack[top++] = l;
+        }
+        return hit;
+    }
+
+    size_t triangleCount() const { return tris_.size(); }
+    bool empty() const { return tris_.empty(); }
+
+private:
+    struct Tri {
+        Vec3 a, b, c;
+        uint32_t source = 0;
+    };
+
+    // Ericson, Real-Time Collision Detection 5.1.5, with barycentrics
+    static Vec3 closestOnTriangle(const Vec3& p, const Tri& t, float bary[3]) {
+        Vec3 ab = t.b - t.a, ac = t.c - t.a, ap = p - t.a;
+        float d1 = ab.dot(ap), d2 = ac.dot(ap);
+        if (d1 <= 0.0f && d2 <= 0.0f) { bary[0] = 1; bary[1] = 0; bary[2] = 0; return t.a; }
+
+        Vec3 bp = p - t.b;
+        float d3 = ab.dot(bp), d4 = ac.dot(bp);
+        if (d3 >= 0.0f && d4 <= d3) { bary[0] = 0; bary[1] = 1; bary[2] = 0; return t.b; }
+
+        float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+            float v = d1 / (d1 - d3);
+            bary[0] = 1 - v; bary[1] = v; bary[2] = 0;
+            return t.a + ab * v;
+        }
+
+        Vec3 cp = p - t.c;
+        float d5 = ab.dot(cp), d6 = ac.dot(cp);
+        if (d6 >= 0.0f && d5 <= d6) { bary[0] = 0; bary[1] = 0; bary[2] = 1; return t.c; }
+
+        float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+            float w = d2 / (d2 - d6);
+            bary[0] = 1 - w; bary[1] = 0; bary[2] = w;
+            return t.a + ac * w;
+        }
+
+        float va = d3 * d6 - d5 * d4;
+        if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+            float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            bary[0] = 0; bary[1] = 1 - w; bary[2] = w;
+            return t.b + (t.c - t.b) * w;
+        }
+
+        float denom = 1.0f / (va + vb + vc);
+        float v = vb * denom, w = vc * denom;
+        bary[0] = 1 - v - w; bary[1] = v; bary[2] = w;
+        return t.a + ab * v + ac * w;
+    }
+
+    std::vector<skinbvh::Node> nodes_;
+    std::vector<Tri> tris_;
+};
+
+// ============================================================================
+// Mesh Adjacency - compressed sparse rows of unique vertex neighbors
+// ============================================================================
+
+struct MeshAdjacency {
+    std::vector<uint32_t> offsets;      // vertexCount + 1
+    std::vector<uint32_t> neighbors;
+
+    void build(size_t vertexCount, const uint32_t* indices, size_t indexCount) {
+        offsets.assign(vertexCount + 1, 0);
+        size_t triCount = indexCount / 3;
+        auto inRange = [&](size_t t) {
+            return indices[t * 3] < vertexCount && indices[t * 3 + 1] < vertexCount &&
+                   indices[t * 3 + 2] < vertexCount;
+        };
+
+        for (size_t t = 0; t < triCount; t++) {
+            if (!inRange(t)) continue;
+            for (int k = 0; k < 3; k++) offsets[indices[t * 3 + k] + 1] += 2;
+        }
+        for (size_t i = 0; i < vertexCount; i++) offsets[i + 1] += offsets[i];
+
+        neighbors.resize(offsets[vertexCount]);
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t t = 0; t < triCount; t++) {
+            if (!inRange(t)) continue;
+            uint32_t a = indices[t * 3], b = indices[t * 3 + 1], c = indices[t * 3 + 2];
+            neighbors[cursor[a]++] = b; neighbors[cursor[a]++] = c;
+            neighbors[cursor[b]++] = a; neighbors[cursor[b]++] = c;
+            neighbors[cursor[c]++] = a; neighbors[cursor[c]++] = b;
+        }
+
+        // Sort + dedupe each row, compacting in place
+        uint32_t write = 0;
+        for (size_t i = 0; i < vertexCount; i++) {
+            uint32_t begin = offsets[i], end = offsets[i + 1];
+            std::sort(neighbors.begin() + begin, neighbors.begin() + end);
+            offsets[i] = write;
+            for (uint32_t j = begin; j < end; j++) {
+                uint32_t n = neighbors[j];
+                if (n == i) continue;
+                if (write > offsets[i] && neighbors[write - 1] == n) continue;
+                neighbors[write++] = n;
+            }
+        }
+        offsets[vertexCount] = write;
+        neighbors.resize(write);
+        neighbors.shrink_to_fit();
+    }
+
+    size_t vertexCount() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    uint32_t degree(size_t v) const { return offsets[v + 1] - offsets[v]; }
+    const uint32_t* begin(size_t v) const { return neighbors.data() + offsets[v]; }
+    const uint32_t* end(size_t v) const { return neighbors.data() + offsets[v + 1]; }
+};
+
+}  // namespace luma
@@ -164,7 +164,7 @@ namespace StandardBones {
 // Bone Mapping - Maps between different rig standards
 // ============================================================================
 
-struct BoneMapping {
+struct RigBoneMapping {
     std::string lumaBone;       // Our standard name
     std::string mixamoBone;     // Mixamo name
     std::string unityBone;      // Unity Humanoid name
@@ -194,7 +194,7 @@ public:
         return instance;
     }
     
-    const BoneMapping* getMapping(const std::string& lumaBone) const {
+    const RigBoneMapping* getMapping(const std::string& lumaBone) const {
         auto it = mappings_.find(lumaBone);
         return (it != mappings_.end()) ? &it->second : nullptr;
     }
@@ -310,11 +310,11 @@ private:
         addMapping({"eye_R", "mixamorig:RightEye", "RightEye", "rightEye", "eye_r"});
     }
     
-    void addMapping(const BoneMapping& mapping) {
+    void addMapping(const RigBoneMapping& mapping) {
         mappings_[mapping.lumaBone] = mapping;
     }
     
-    std::unordered_map<std::string, BoneMapping> mappings_;
+    std::unordered_map<std::string, RigBoneMapping> mappings_;
 };
 
 // ============================================================================
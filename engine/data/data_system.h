@@ -3,6 +3,7 @@
 #pragma once
 
 #include "engine/foundation/math_types.h"
+#include "engine/util/file_watcher.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -321,61 +322,6 @@ private:
     std::unordered_map<std::string, std::unordered_map<std::string, std::string>> strings_;
 };
 
-// ===== File Watcher =====
-struct WatchedFile {
-    std::string path;
-    std::filesystem::file_time_type lastModified;
-    std::function<void(const std::string&)> callback;
-};
-
-class FileWatcher {
-public:
-    void addWatch(const std::string& path,
-                  std::function<void(const std::string&)> callback) {
-        WatchedFile watch;
-        watch.path = path;
-        watch.callback = callback;
-        
-        try {
-            if (std::filesystem::exists(path)) {
-                watch.lastModified = std::filesystem::last_write_time(path);
-            }
-        } catch (...) {}
-        
-        watchedFiles_[path] = watch;
-    }
-    
-    void removeWatch(const std::string& path) {
-        watchedFiles_.erase(path);
-    }
-    
-    void clearAllWatches() {
-        watchedFiles_.clear();
-    }
-    
-    // Check for changes (call periodically)
-    void update() {
-        for (auto& [path, watch] : watchedFiles_) {
-            try {
-                if (!std::filesystem::exists(path)) continue;
-                
-                auto currentTime = std::filesystem::last_write_time(path);
-                if (currentTime != watch.lastModified) {
-                    watch.lastModified = currentTime;
-                    if (watch.callback) {
-                        watch.callback(path);
-                    }
-                }
-            } catch (...) {}
-        }
-    }
-    
-    size_t getWatchCount() const { return watchedFiles_.size(); }
-    
-private:
-    std::unordered_map<std::string, WatchedFile> watchedFiles_;
-};
-
 // ===== Data Manager =====
 class DataManager {
 public:
@@ -412,7 +358,7 @@ public:
         
         // Set up hot reload
         if (hotReloadEnabled_) {
-            fileWatcher_.addWatch(fullPath, [this, name](const std::string& path) {
+            fileWatcher_.watchFile(fullPath, [this, name](const std::string& path) {
                 reloadConfig(name, path);
             });
         }
@@ -484,7 +430,7 @@ public:
         
         // Set up hot reload
         if (hotReloadEnabled_) {
-            fileWatcher_.addWatch(fullPath, [this, language](const std::string& path) {
+            fileWatcher_.watchFile(fullPath, [this, language](const std::string& path) {
                 std::ifstream f(path);
                 if (f.is_open()) {
                     std::stringstream buffer;
@@ -515,7 +461,7 @@ public:
     
     void update() {
         if (hotReloadEnabled_) {
-            fileWatcher_.update();
+            fileWatcher_.checkChanges();
         }
     }
     
@@ -4,6 +4,7 @@
 
 #include "engine/foundation/math_types.h"
 #include "engine/renderer/mesh.h"
+#include "engine/asset/texture_compression.h"
 #include "engine/animation/skeleton.h"
 #include "engine/character/blend_shape.h"
 #include <string>
@@ -257,14 +258,14 @@ public:
         scenes_.push_back(scene);
         
         // Add textures
-        if (!mesh.diffuseTexture.pixels.empty()) {
-            addTexture(mesh.diffuseTexture, "diffuse");
+        if (hasPixels(mesh.diffuseTexture)) {
+            addTexture(*mesh.diffuseTexture, "diffuse");
         }
-        if (!mesh.normalTexture.pixels.empty()) {
-            addTexture(mesh.normalTexture, "normal");
+        if (hasPixels(mesh.normalTexture)) {
+            addTexture(*mesh.normalTexture, "normal");
         }
-        if (!mesh.specularTexture.pixels.empty()) {
-            addTexture(mesh.specularTexture, "roughness");
+        if (hasPixels(mesh.specularTexture)) {
+            addTexture(*mesh.specularTexture, "roughness");
         }
         
         // Create material
@@ -869,10 +870,9 @@ private:
         // In production, would use stb_image_write or libpng
         
         // Create a minimal PNG header + raw data
-        // For now, just store raw data (not valid PNG)
-        std::vector<uint8_t> data;
-        data.insert(data.end(), tex.pixels.begin(), tex.pixels.end());
-        return data;
+        // For now, just store raw data (not valid PNG). Cooked textures are
+        // decoded back to RGBA8 first.
+        return textureLevelRGBA8(tex);
     }
     
     // === JSON Generation ===
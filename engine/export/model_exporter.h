@@ -247,7 +247,7 @@ public:
             mtlFile << "Ks 0.5 0.5 0.5\n";
             mtlFile << "Ns " << (1.0f - mesh.roughness) * 1000.0f << "\n";
             
-            if (mesh.hasDiffuseTexture && !mesh.diffuseTexture.pixels.empty()) {
+            if (mesh.hasDiffuseTexture && hasPixels(mesh.diffuseTexture)) {
                 std::string texPath = outputPath.substr(0, outputPath.rfind('.')) + "_diffuse.png";
                 mtlFile << "map_Kd " << texPath.substr(texPath.rfind('/') + 1) << "\n";
                 // Would need to write texture file
@@ -1,12 +1,338 @@
 #include "log.h"
 
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
 #include <iostream>
 
 namespace luma {
 
+const char* logLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "trace";
+        case LogLevel::Debug: return "debug";
+        case LogLevel::Info:  return "info";
+        case LogLevel::Warn:  return "warn";
+        case LogLevel::Error: return "error";
+        case LogLevel::Fatal: return "fatal";
+        case LogLevel::Off:   return "off";
+    }
+    return "?";
+}
+
+const char* logCategoryName(LogCategory category) {
+    switch (category) {
+        case LogCategory::General:   return "general";
+        case LogCategory::Renderer:  return "renderer";
+        case LogCategory::Asset:     return "asset";
+        case LogCategory::Scene:     return "scene";
+        case LogCategory::Animation: return "animation";
+        case LogCategory::Audio:     return "audio";
+        case LogCategory::Script:    return "script";
+        case LogCategory::Network:   return "network";
+        case LogCategory::AI:        return "ai";
+        case LogCategory::Editor:    return "editor";
+        case LogCategory::Count:     break;
+    }
+    return "?";
+}
+
+// ===== LogRecord =====
+
+void LogRecord::format_to(std::string& out) const {
+    size_t offset = 0;
+    uint8_t argsLeft = argCount;
+    char number[64];
+
+    auto appendNextArg = [&]() {
+        if (argsLeft == 0) {
+            out += "{?}";
+            return;
+        }
+        argsLeft--;
+        auto type = static_cast<ArgType>(payload[offset++]);
+        switch (type) {
+            case ArgType::Int: {
+                int64_t v;
+                std::memcpy(&v, payload + offset, sizeof(v));
+                offset += sizeof(v);
+                int n = std::snprintf(number, sizeof(number), "%" PRId64, v);
+                out.append(number, n);
+                break;
+            }
+            case ArgType::UInt: {
+                uint64_t v;
+                std::memcpy(&v, payload + offset, sizeof(v));
+                offset += sizeof(v);
+                int n = std::snprintf(number, sizeof(number), "%" PRIu64, v);
+                out.append(number, n);
+                break;
+            }
+            case ArgType::Double: {
+                double v;
+                std::memcpy(&v, payload + offset, sizeof(v));
+                offset += sizeof(v);
+                int n = std::snprintf(number, sizeof(number), "%g", v);
+                out.append(number, n);
+                break;
+            }
+            case ArgType::Bool: {
+                out += payload[offset++] ? "true" : "false";
+                break;
+            }
+            case ArgType::Char: {
+                out += static_cast<char>(payload[offset++]);
+                break;
+            }
+            case ArgType::String: {
+                uint16_t len;
+                std::memcpy(&len, payload + offset, sizeof(len));
+                offset += sizeof(len);
+                out.append(reinterpret_cast<const char*>(payload + offset), len);
+                offset += len;
+                break;
+            }
+            case ArgType::OverflowString: {
+                uint32_t range[2];
+                std::memcpy(range, payload + offset, sizeof(range));
+                offset += sizeof(range);
+                if (overflow) out.append(*overflow, range[0], range[1]);
+                break;
+            }
+            case ArgType::Pointer: {
+                uintptr_t v;
+                std::memcpy(&v, payload + offset, sizeof(v));
+                offset += sizeof(v);
+                int n = std::snprintf(number, sizeof(number), "0x%" PRIxPTR, v);
+                out.append(number, n);
+                break;
+            }
+        }
+    };
+
+    for (const char* p = format ? format : ""; *p; ++p) {
+        if (p[0] == '{' && p[1] == '}') {
+            appendNextArg();
+            ++p;
+        } else if (p[0] == '{' && p[1] == '{') {
+            out += '{';
+            ++p;
+        } else if (p[0] == '}' && p[1] == '}') {
+            out += '}';
+            ++p;
+        } else {
+            out += *p;
+        }
+    }
+
+    if (truncated) {
+        out += " [truncated]";
+    }
+}
+
+// ===== Sinks =====
+
+void ConsoleLogSink::write(const LogRecord& record, std::string_view line) {
+    std::FILE* stream = record.level >= LogLevel::Warn ? stderr : stdout;
+    std::fwrite(line.data(), 1, line.size(), stream);
+    std::fputc('\n', stream);
+}
+
+void ConsoleLogSink::flush() {
+    std::fflush(stdout);
+    std::fflush(stderr);
+}
+
+FileLogSink::FileLogSink(const std::string& path, bool append) {
+    file_ = std::fopen(path.c_str(), append ? "ab" : "wb");
+    if (!file_) {
+        std::cerr << "[luma] Failed to open log file: " << path << std::endl;
+    }
+}
+
+FileLogSink::~FileLogSink() {
+    if (file_) {
+        std::fclose(file_);
+    }
+}
+
+void FileLogSink::write(const LogRecord&, std::string_view line) {
+    if (!file_) return;
+    std::fwrite(line.data(), 1, line.size(), file_);
+    std::fputc('\n', file_);
+}
+
+void FileLogSink::flush() {
+    if (file_) {
+        std::fflush(file_);
+    }
+}
+
+// ===== Logger =====
+
+Logger& Logger::get() {
+    static Logger instance;
+    return instance;
+}
+
+Logger::Logger() : slots_(new Slot[kCapacity]) {
+    for (size_t i = 0; i < capacity_; i++) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    for (auto& level : categoryLevels_) {
+        level.store(LogLevel::Info, std::memory_order_relaxed);
+    }
+
+    startNs_ = nowNs();
+    sinks_.push_back(std::make_shared<ConsoleLogSink>());
+
+    running_.store(true, std::memory_order_release);
+    sinkThread_ = std::thread(&Logger::sinkThreadMain, this);
+}
+
+Logger::~Logger() {
+    running_.store(false, std::memory_order_release);
+    if (sinkThread_.joinable()) {
+        sinkThread_.join();
+    }
+    drain();
+}
+
+uint64_t Logger::nowNs() const {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count()) - startNs_;
+}
+
+uint32_t Logger::currentThreadId() {
+    static std::atomic<uint32_t> nextId{0};
+    thread_local uint32_t id = nextId.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+void Logger::setLevel(LogLevel level) {
+    for (auto& l : categoryLevels_) {
+        l.store(level, std::memory_order_relaxed);
+    }
+}
+
+void Logger::setCategoryLevel(LogCategory category, LogLevel level) {
+    categoryLevels_[static_cast<size_t>(category)].store(level, std::memory_order_relaxed);
+}
+
+void Logger::addSink(std::shared_ptr<LogSink> sink) {
+    std::lock_guard<std::mutex> lock(sinkMutex_);
+    sinks_.push_back(std::move(sink));
+}
+
+void Logger::clearSinks() {
+    std::lock_guard<std::mutex> lock(sinkMutex_);
+    for (auto& sink : sinks_) {
+        sink->flush();
+    }
+    sinks_.clear();
+}
+
+// Bounded MPSC queue: each slot carries a sequence number that tells producers
+// and the consumer whose turn it is (Vyukov-style), so enqueue is a single CAS.
+LogRecord* Logger::beginWrite(uint64_t& ticket) {
+    uint64_t pos = writePos_.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = slots_[pos & (capacity_ - 1)];
+        uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (writePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                ticket = pos;
+                return &slot.record;
+            }
+        } else if (diff < 0) {
+            return nullptr;  // full
+        } else {
+            pos = writePos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::endWrite(uint64_t ticket) {
+    slots_[ticket & (capacity_ - 1)].sequence.store(ticket + 1, std::memory_order_release);
+}
+
+size_t Logger::drain() {
+    std::lock_guard<std::mutex> lock(sinkMutex_);
+
+    size_t count = 0;
+    for (;;) {
+        Slot& slot = slots_[readPos_ & (capacity_ - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != readPos_ + 1) break;
+
+        const LogRecord& record = slot.record;
+        if (!sinks_.empty()) {
+            char prefix[112];
+            uint64_t ms = record.timestampNs / 1000000;
+            int n = std::snprintf(prefix, sizeof(prefix), "[%" PRIu64 ".%03" PRIu64 "][t%" PRIu32 "][%s][%s] ",
+                                  ms / 1000, ms % 1000, record.threadId, logLevelName(record.level),
+                                  logCategoryName(record.category));
+            lineBuffer_.assign(prefix, n);
+            record.format_to(lineBuffer_);
+            for (auto& sink : sinks_) {
+                sink->write(record, lineBuffer_);
+            }
+        }
+
+        slot.record.overflow.reset();
+        slot.sequence.store(readPos_ + capacity_, std::memory_order_release);
+        readPos_++;
+        count++;
+    }
+
+    uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+    if (dropped != droppedReported_) {
+        std::fprintf(stderr, "[luma] log ring buffer full, dropped %" PRIu64 " messages\n",
+                     dropped - droppedReported_);
+        droppedReported_ = dropped;
+    }
+
+    if (count > 0) {
+        for (auto& sink : sinks_) {
+            sink->flush();
+        }
+        written_.fetch_add(count, std::memory_order_relaxed);
+    }
+    readPosPublished_.store(readPos_, std::memory_order_release);
+    return count;
+}
+
+void Logger::sinkThreadMain() {
+    while (running_.load(std::memory_order_acquire)) {
+        if (drain() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+void Logger::flush() {
+    uint64_t target = writePos_.load(std::memory_order_acquire);
+    if (!running_.load(std::memory_order_acquire)) {
+        drain();
+        return;
+    }
+    while (readPosPublished_.load(std::memory_order_acquire) < target) {
+        std::this_thread::yield();
+    }
+}
+
+// ===== Convenience wrappers =====
+
 void log_info(std::string_view message) {
-    std::cout << "[luma] " << message << std::endl;
+    LUMA_LOG_INFO(LogCategory::General, "{}", message);
 }
 
-}  // namespace luma
+void log_warn(std::string_view message) {
+    LUMA_LOG_WARN(LogCategory::General, "{}", message);
+}
+
+void log_error(std::string_view message) {
+    LUMA_LOG_ERROR(LogCategory::General, "{}", message);
+}
 
+}  // namespace luma
@@ -1,11 +1,339 @@
-// Minimal logging facade placeholder; replace with spdlog in full build.
+// Asynchronous structured logging.
+//
+// Producers encode the format string pointer and raw arguments into a slot of
+// a lock-free multi-producer ring buffer; a background sink thread does the
+// formatting and writes to the registered sinks. Levels below
+// LUMA_LOG_MIN_LEVEL are compiled out, the rest are filtered per category at
+// runtime.
+//
+//   LUMA_LOG_INFO(luma::LogCategory::Asset, "Imported {} ({} meshes, {} ms)", path, meshCount, ms);
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// 0 = Trace, 1 = Debug, 2 = Info, 3 = Warn, 4 = Error, 5 = Fatal
+#ifndef LUMA_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define LUMA_LOG_MIN_LEVEL 2
+#else
+#define LUMA_LOG_MIN_LEVEL 0
+#endif
+#endif
 
 namespace luma {
 
+enum class LogLevel : uint8_t {
+    Trace = 0,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Fatal,
+    Off
+};
+
+enum class LogCategory : uint8_t {
+    General = 0,
+    Renderer,
+    Asset,
+    Scene,
+    Animation,
+    Audio,
+    Script,
+    Network,
+    AI,
+    Editor,
+    Count
+};
+
+const char* logLevelName(LogLevel level);
+const char* logCategoryName(LogCategory category);
+
+// ===== Log Record =====
+// One fixed-size ring buffer entry. Arguments are stored type-tagged in
+// `payload` and only turned into text on the sink thread. Strings that do not
+// fit the payload go to `overflow`, which the sink thread frees.
+struct LogRecord {
+    static constexpr size_t kPayloadSize = 464;
+
+    enum class ArgType : uint8_t {
+        Int,
+        UInt,
+        Double,
+        Bool,
+        Char,
+        String,
+        Pointer,
+        OverflowString  // Offset and length into `overflow`
+    };
+
+    uint64_t timestampNs = 0;       // steady clock, relative to logger start
+    const char* format = nullptr;   // must outlive the logger (string literal)
+    uint32_t threadId = 0;          // Small per-process index, printed as [tN]
+    LogLevel level = LogLevel::Info;
+    LogCategory category = LogCategory::General;
+    uint8_t argCount = 0;
+    bool truncated = false;
+    uint16_t payloadSize = 0;
+    uint8_t payload[kPayloadSize];
+    std::unique_ptr<std::string> overflow;
+
+    // Expand `{}` placeholders with the stored arguments
+    void format_to(std::string& out) const;
+};
+
+// ===== Sinks =====
+class LogSink {
+public:
+    virtual ~LogSink() = default;
+    // Called on the sink thread with the fully formatted line (no newline)
+    virtual void write(const LogRecord& record, std::string_view line) = 0;
+    // Called after each drained batch
+    virtual void flush() {}
+};
+
+class ConsoleLogSink : public LogSink {
+public:
+    void write(const LogRecord& record, std::string_view line) override;
+    void flush() override;
+};
+
+class FileLogSink : public LogSink {
+public:
+    explicit FileLogSink(const std::string& path, bool append = false);
+    ~FileLogSink() override;
+
+    bool isOpen() const { return file_ != nullptr; }
+
+    void write(const LogRecord& record, std::string_view line) override;
+    void flush() override;
+
+private:
+    std::FILE* file_ = nullptr;
+};
+
+// ===== Logger =====
+class Logger {
+public:
+    static Logger& get();
+
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // Runtime filtering
+    void setLevel(LogLevel level);
+    void setCategoryLevel(LogCategory category, LogLevel level);
+    LogLevel getCategoryLevel(LogCategory category) const {
+        return categoryLevels_[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+    bool shouldLog(LogLevel level, LogCategory category) const {
+        return level >= getCategoryLevel(category);
+    }
+
+    // Sinks are shared with the caller; write()/flush() run on the sink thread
+    void addSink(std::shared_ptr<LogSink> sink);
+    void clearSinks();
+
+    // Enqueue a record; never blocks. Returns false if the ring buffer was full.
+    template<typename... Args>
+    bool log(LogLevel level, LogCategory category, const char* format, const Args&... args);
+
+    // Block until every record enqueued before this call has been written
+    void flush();
+
+    // Stats
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t getWrittenCount() const { return written_.load(std::memory_order_relaxed); }
+    size_t getCapacity() const { return capacity_; }
+
+private:
+    Logger();
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence{0};
+        LogRecord record;
+    };
+
+    static constexpr size_t kCapacity = 8192;  // power of two
+
+    LogRecord* beginWrite(uint64_t& ticket);
+    void endWrite(uint64_t ticket);
+    void sinkThreadMain();
+    size_t drain();
+    uint64_t nowNs() const;
+    static uint32_t currentThreadId();
+
+    // Argument encoding
+    struct Encoder {
+        LogRecord& record;
+        size_t offset = 0;
+
+        bool reserve(size_t bytes) {
+            if (offset + bytes > LogRecord::kPayloadSize) {
+                record.truncated = true;
+                return false;
+            }
+            return true;
+        }
+        void tag(LogRecord::ArgType type) { record.payload[offset++] = static_cast<uint8_t>(type); }
+
+        template<typename T>
+        void raw(LogRecord::ArgType type, const T& value) {
+            if (!reserve(1 + sizeof(T))) return;
+            tag(type);
+            std::memcpy(record.payload + offset, &value, sizeof(T));
+            offset += sizeof(T);
+            record.argCount++;
+        }
+
+        void string(std::string_view s) {
+            if (offset + 1 + sizeof(uint16_t) + s.size() > LogRecord::kPayloadSize) {
+                overflowString(s);
+                return;
+            }
+            tag(LogRecord::ArgType::String);
+            uint16_t len = static_cast<uint16_t>(s.size());
+            std::memcpy(record.payload + offset, &len, sizeof(len));
+            offset += sizeof(len);
+            std::memcpy(record.payload + offset, s.data(), s.size());
+            offset += s.size();
+            record.argCount++;
+        }
+
+        // Too long for the slot: copied to the heap instead of truncated
+        void overflowString(std::string_view s) {
+            if (!reserve(1 + 2 * sizeof(uint32_t))) return;
+            if (!record.overflow) record.overflow = std::make_unique<std::string>();
+            uint32_t range[2] = {static_cast<uint32_t>(record.overflow->size()), static_cast<uint32_t>(s.size())};
+            record.overflow->append(s);
+            tag(LogRecord::ArgType::OverflowString);
+            std::memcpy(record.payload + offset, range, sizeof(range));
+            offset += sizeof(range);
+            record.argCount++;
+        }
+
+        template<typename T>
+        void encode(const T& value) {
+            using D = std::decay_t<T>;
+            if constexpr (std::is_same_v<D, bool>) {
+                raw(LogRecord::ArgType::Bool, static_cast<uint8_t>(value));
+            } else if constexpr (std::is_same_v<D, char>) {
+                raw(LogRecord::ArgType::Char, value);
+            } else if constexpr (std::is_enum_v<D>) {
+                raw(LogRecord::ArgType::Int, static_cast<int64_t>(value));
+            } else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>) {
+                raw(LogRecord::ArgType::Int, static_cast<int64_t>(value));
+            } else if constexpr (std::is_integral_v<D>) {
+                raw(LogRecord::ArgType::UInt, static_cast<uint64_t>(value));
+            } else if constexpr (std::is_floating_point_v<D>) {
+                raw(LogRecord::ArgType::Double, static_cast<double>(value));
+            } else if constexpr (std::is_same_v<D, const char*> || std::is_same_v<D, char*>) {
+                string(value ? std::string_view(value) : std::string_view("(null)"));
+            } else if constexpr (std::is_convertible_v<const D&, std::string_view>) {
+                string(std::string_view(value));
+            } else if constexpr (std::is_pointer_v<D>) {
+                raw(LogRecord::ArgType::Pointer, reinterpret_cast<uintptr_t>(value));
+            } else {
+                static_assert(sizeof(D) == 0, "Unsupported log argument type");
+            }
+        }
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t capacity_ = kCapacity;
+    alignas(64) std::atomic<uint64_t> writePos_{0};
+    alignas(64) uint64_t readPos_ = 0;
+    std::atomic<uint64_t> readPosPublished_{0};
+
+    std::atomic<LogLevel> categoryLevels_[static_cast<size_t>(LogCategory::Count)];
+
+    std::mutex sinkMutex_;
+    std::vector<std::shared_ptr<LogSink>> sinks_;
+
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> written_{0};
+    uint64_t droppedReported_ = 0;
+
+    std::atomic<bool> running_{false};
+    std::thread sinkThread_;
+    uint64_t startNs_ = 0;
+    std::string lineBuffer_;
+};
+
+template<typename... Args>
+bool Logger::log(LogLevel level, LogCategory category, const char* format, const Args&... args) {
+    uint64_t ticket;
+    LogRecord* record = beginWrite(ticket);
+    if (!record) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    record->timestampNs = nowNs();
+    record->format = format;
+    record->threadId = currentThreadId();
+    record->level = level;
+    record->category = category;
+    record->argCount = 0;
+    record->truncated = false;
+
+    Encoder encoder{*record};
+    (encoder.encode(args), ...);
+    record->payloadSize = static_cast<uint16_t>(encoder.offset);
+
+    endWrite(ticket);
+
+    if (level >= LogLevel::Fatal) {
+        flush();
+    }
+    return true;
+}
+
+// Plain message convenience wrappers (General category). Messages longer than
+// LogRecord::kPayloadSize are not truncated but cost a heap copy per call.
 void log_info(std::string_view message);
+void log_warn(std::string_view message);
+void log_error(std::string_view message);
+
+// Levels below LUMA_LOG_MIN_LEVEL compile to nothing. The comparison is skipped
+// when the minimum is 0 so it does not trip -Wtype-limits at every call site.
+constexpr bool isLogLevelCompiledIn(LogLevel level) {
+#if LUMA_LOG_MIN_LEVEL > 0
+    return static_cast<int>(level) >= LUMA_LOG_MIN_LEVEL;
+#else
+    (void)level;
+    return true;
+#endif
+}
 
 }  // namespace luma
 
+// ===== Logging Macros =====
+#define LUMA_LOG(level, category, ...)                                                      \
+    do {                                                                                    \
+        if constexpr (::luma::isLogLevelCompiledIn(level)) {                                \
+            ::luma::Logger& lumaLogger_ = ::luma::Logger::get();                            \
+            if (lumaLogger_.shouldLog(level, category)) {                                   \
+                lumaLogger_.log(level, category, __VA_ARGS__);                              \
+            }                                                                               \
+        }                                                                                   \
+    } while (0)
+
+#define LUMA_LOG_TRACE(category, ...) LUMA_LOG(::luma::LogLevel::Trace, category, __VA_ARGS__)
+#define LUMA_LOG_DEBUG(category, ...) LUMA_LOG(::luma::LogLevel::Debug, category, __VA_ARGS__)
+#define LUMA_LOG_INFO(category, ...)  LUMA_LOG(::luma::LogLevel::Info, category, __VA_ARGS__)
+#define LUMA_LOG_WARN(category, ...)  LUMA_LOG(::luma::LogLevel::Warn, category, __VA_ARGS__)
+#define LUMA_LOG_ERROR(category, ...) LUMA_LOG(::luma::LogLevel::Error, category, __VA_ARGS__)
+#define LUMA_LOG_FATAL(category, ...) LUMA_LOG(::luma::LogLevel::Fatal, category, __VA_ARGS__)
@@ -309,6 +309,54 @@ struct Mat4 {
             (m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14]) / w
         };
     }
+
+    // Upper 3x3 only (no translation)
+    Vec3 transformDirection(const Vec3& d) const {
+        return {
+            m[0] * d.x + m[4] * d.y + m[8] * d.z,
+            m[1] * d.x + m[5] * d.y + m[9] * d.z,
+            m[2] * d.x + m[6] * d.y + m[10] * d.z
+        };
+    }
+
+    // General inverse via 2x2 sub-determinants; identity if singular
+    Mat4 inverse() const {
+        float s0 = m[0] * m[5] - m[4] * m[1];
+        float s1 = m[0] * m[9] - m[8] * m[1];
+        float s2 = m[0] * m[13] - m[12] * m[1];
+        float s3 = m[4] * m[9] - m[8] * m[5];
+        float s4 = m[4] * m[13] - m[12] * m[5];
+        float s5 = m[8] * m[13] - m[12] * m[9];
+        float c5 = m[10] * m[15] - m[14] * m[11];
+        float c4 = m[6] * m[15] - m[14] * m[7];
+        float c3 = m[6] * m[11] - m[10] * m[7];
+        float c2 = m[2] * m[15] - m[14] * m[3];
+        float c1 = m[2] * m[11] - m[10] * m[3];
+        float c0 = m[2] * m[7] - m[6] * m[3];
+
+        float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        if (std::abs(det) < 1e-12f) return identity();
+        float invDet = 1.0f / det;
+
+        Mat4 r;
+        r.m[0]  = ( m[5] * c5 - m[9] * c4 + m[13] * c3) * invDet;
+        r.m[4]  = (-m[4] * c5 + m[8] * c4 - m[12] * c3) * invDet;
+        r.m[8]  = ( m[7] * s5 - m[11] * s4 + m[15] * s3) * invDet;
+        r.m[12] = (-m[6] * s5 + m[10] * s4 - m[14] * s3) * invDet;
+        r.m[1]  = (-m[1] * c5 + m[9] * c2 - m[13] * c1) * invDet;
+        r.m[5]  = ( m[0] * c5 - m[8] * c2 + m[12] * c1) * invDet;
+        r.m[9]  = (-m[3] * s5 + m[11] * s2 - m[15] * s1) * invDet;
+        r.m[13] = ( m[2] * s5 - m[10] * s2 + m[14] * s1) * invDet;
+        r.m[2]  = ( m[1] * c4 - m[5] * c2 + m[13] * c0) * invDet;
+        r.m[6]  = (-m[0] * c4 + m[4] * c2 - m[12] * c0) * invDet;
+        r.m[10] = ( m[3] * s4 - m[7] * s2 + m[15] * s0) * invDet;
+        r.m[14] = (-m[2] * s4 + m[6] * s2 - m[14] * s0) * invDet;
+        r.m[3]  = (-m[1] * c3 + m[5] * c1 - m[9] * c0) * invDet;
+        r.m[7]  = ( m[0] * c3 - m[4] * c1 + m[8] * c0) * invDet;
+        r.m[11] = (-m[3] * s3 + m[7] * s1 - m[11] * s0) * invDet;
+        r.m[15] = ( m[2] * s3 - m[6] * s1 + m[10] * s0) * invDet;
+        return r;
+    }
 };
 
 }  // namespace luma
@@ -0,0 +1,99 @@
+// Single-producer / single-consumer lock-free queue.
+//
+// One thread pushes, one other thread pops; neither ever blocks or allocates
+// after construction, which makes it suitable for handing data to and from
+// real-time threads (e.g. the audio mixer). Capacity is rounded up to a power
+// of two.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <algorithm>
+
+namespace luma {
+
+template<typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity = 1024) {
+        capacity_ = 1;
+        while (capacity_ < capacity) capacity_ <<= 1;
+        mask_ = capacity_ - 1;
+        slots_ = std::make_unique<T[]>(capacity_);
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t capacity() const { return capacity_; }
+
+    // Approximate when called from neither side
+    size_t size() const {
+        return static_cast<size_t>(tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire));
+    }
+    bool empty() const { return size() == 0; }
+
+    // ===== Producer =====
+    bool push(T&& value) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) >= capacity_) return false;
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool push(const T& value) {
+        T copy = value;
+        return push(std::move(copy));
+    }
+
+    // Copies as many of `count` items as fit; returns how many were written
+    size_t pushBulk(const T* values, size_t count) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        size_t space = capacity_ - static_cast<size_t>(tail - head_.load(std::memory_order_acquire));
+        count = std::min(count, space);
+        for (size_t i = 0; i < count; i++) {
+            slots_[(tail + i) & mask_] = values[i];
+        }
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    size_t freeSpace() const {
+        return capacity_ - static_cast<size_t>(tail_.load(std::memory_order_relaxed) -
+                                               head_.load(std::memory_order_acquire));
+    }
+
+    // ===== Consumer =====
+    bool pop(T& out) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) return false;
+        out = std::move(slots_[head & mask_]);
+        slots_[head & mask_] = T{};  // Release resources held by the slot
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Moves up to `count` items out; returns how many were read
+    size_t popBulk(T* out, size_t count) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        size_t available = static_cast<size_t>(tail_.load(std::memory_order_acquire) - head);
+        count = std::min(count, available);
+        for (size_t i = 0; i < count; i++) {
+            out[i] = std::move(slots_[(head + i) & mask_]);
+        }
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    std::unique_ptr<T[]> slots_;
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<uint64_t> head_{0};   // Consumer position
+    alignas(64) std::atomic<uint64_t> tail_{0};   // Producer position
+};
+
+}  // namespace luma
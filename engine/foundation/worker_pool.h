@@ -0,0 +1,121 @@
+// Fork-join worker pool for data-parallel loops.
+//
+// Workers are persistent, so a dispatch costs a wake-up rather than a thread
+// launch. The calling thread takes part in every job, and run() returns only
+// once every worker has checked in, so no worker can straddle two jobs.
+// Chunks are handed out from a shared counter; grain sets the items per chunk.
+// One job at a time: run() is not reentrant and must not be called from
+// several threads at once.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace luma {
+
+class WorkerPool {
+public:
+    using Task = void (*)(void* context, size_t begin, size_t end);
+
+    // threads counts the calling thread; <= 0 uses the hardware concurrency
+    explicit WorkerPool(int threads = 0) {
+        if (threads <= 0) threads = (int)std::max(1u, std::thread::hardware_concurrency());
+        for (int i = 1; i < threads; i++) workers_.emplace_back([this] { workerLoop(); });
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_) worker.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int getThreadCount() const { return (int)workers_.size() + 1; }
+
+    // Calls fn(context, begin, end) over [0, count) in chunks of grain items.
+    // grain 0 splits the range into about four chunks per thread.
+    void run(size_t count, size_t grain, Task fn, void* context) {
+        if (count == 0) return;
+        if (grain == 0) {
+            size_t chunks = std::min(count, (size_t)getThreadCount() * 4);
+            grain = (count + chunks - 1) / chunks;
+        }
+        size_t chunks = (count + grain - 1) / grain;
+        if (workers_.empty() || chunks == 1) {
+            fn(context, 0, count);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = fn;
+            context_ = context;
+            count_ = count;
+            grain_ = grain;
+            chunkCount_ = chunks;
+            nextChunk_.store(0, std::memory_order_relaxed);
+            checkedIn_ = 0;
+            generation_++;
+        }
+        wake_.notify_all();
+        work();
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return checkedIn_ == workers_.size(); });
+    }
+
+    // body(begin, end)
+    template<typename F>
+    void parallelFor(size_t count, size_t grain, F& body) {
+        run(count, grain, [](void* context, size_t begin, size_t end) { (*static_cast<F*>(context))(begin, end); }, &body);
+    }
+
+private:
+    void work() {
+        for (;;) {
+            size_t chunk = nextChunk_.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= chunkCount_) break;
+            task_(context_, chunk * grain_, std::min(count_, (chunk + 1) * grain_));
+        }
+    }
+
+    void workerLoop() {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+            }
+            work();
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (++checkedIn_ == workers_.size()) done_.notify_one();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    Task task_ = nullptr;
+    void* context_ = nullptr;
+    size_t count_ = 0;
+    size_t grain_ = 1;
+    size_t chunkCount_ = 0;
+    std::atomic<size_t> nextChunk_{0};
+    size_t checkedIn_ = 0;
+    uint64_t generation_ = 0;
+    bool stop_ = false;
+};
+
+}  // namespace luma
@@ -0,0 +1,987 @@
+// Game UI System - Batched Renderer
+// Retained per-canvas vertex/index streams, glyph atlas and shaped text runs
+#pragma once
+
+#include "ui_system.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+namespace luma {
+namespace ui {
+
+// ===== Vertex Stream =====
+struct UIVertex {
+    float x = 0.0f;
+    float y = 0.0f;
+    float u = 0.0f;
+    float v = 0.0f;
+    uint32_t color = 0xFFFFFFFFu;  // RGBA8, R in the low byte
+};
+
+inline uint32_t packUIColor(const UIColor& c) {
+    auto channel = [](float f) -> uint32_t {
+        f = std::max(0.0f, std::min(1.0f, f));
+        return (uint32_t)(f * 255.0f + 0.5f);
+    };
+    return channel(c.r) | (channel(c.g) << 8) | (channel(c.b) << 16) | (channel(c.a) << 24);
+}
+
+// One draw call: a run of quads sharing texture and scissor rect
+struct UIDrawBatch {
+    uint64_t texture = 0;
+    UIRect clip;
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+};
+
+// Geometry for one canvas. Every primitive is a quad; indices follow the
+// 0,1,2 / 0,2,3 pattern so the index buffer only grows with quad count.
+struct UIDrawList {
+    std::vector<UIVertex> vertices;
+    std::vector<uint32_t> indices;
+    std::vector<UIDrawBatch> batches;
+};
+
+// ===== Render Stats =====
+struct UIRenderStats {
+    uint32_t canvases = 0;
+    uint32_t canvasesRestitched = 0;  // draw list rebuilt from cached widget geometry
+    uint32_t widgetsRebuilt = 0;      // widgets whose quads were regenerated
+    uint32_t widgetsPatched = 0;      // regenerated widgets copied in place
+    uint32_t drawCalls = 0;
+    uint32_t vertices = 0;
+    uint32_t indices = 0;
+    uint32_t textRunsShaped = 0;
+    uint32_t textRunHits = 0;
+    uint32_t glyphsRasterized = 0;
+    double cpuMs = 0.0;
+};
+
+// ===== Font Provider =====
+struct UIGlyphBitmap {
+    float advance = 0.0f;
+    int offsetX = 0;                // from pen position
+    int offsetY = 0;                // from baseline, negative is up
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> coverage;  // width * height, 0..255
+};
+
+class IUIFontProvider {
+public:
+    virtual ~IUIFontProvider() = default;
+
+    virtual float getAscent(const std::string& font, int pixelSize) = 0;
+    virtual float getLineHeight(const std::string& font, int pixelSize) = 0;
+    virtual bool getGlyph(const std::string& font, int pixelSize, uint32_t codepoint,
+                          UIGlyphBitmap& out) = 0;
+};
+
+// Box glyphs of plausible metrics, used until a real rasterizer is plugged in
+class UIFallbackFont : public IUIFontProvider {
+public:
+    float getAscent(const std::string&, int pixelSize) override { return pixelSize * 0.8f; }
+    float getLineHeight(const std::string&, int pixelSize) override { return pixelSize * 1.2f; }
+
+    bool getGlyph(const std::string&, int pixelSize, uint32_t codepoint, UIGlyphBitmap& out) override {
+        out.advance = std::ceil(pixelSize * 0.55f);
+        out.offsetX = 1;
+        if (codepoint <= 32) {
+            out.width = out.height = 0;
+            out.offsetY = 0;
+            out.coverage.clear();
+            return true;
+        }
+        out.width = std::max(1, (int)out.advance - 2);
+        out.height = std::max(1, (int)std::lround(pixelSize * 0.65f));
+        out.offsetY = -out.height;
+        out.coverage.assign((size_t)out.width * out.height, 255);
+        return true;
+    }
+};
+
+// ===== Glyph Atlas =====
+// Single-channel coverage texture shared by text, solid fills and rounded
+// corners, so most widgets land in one batch. Backends upload getDirtyRect()
+// and call clearDirty(); getGeneration() changes whenever cached UVs go stale.
+class UIGlyphAtlas {
+public:
+    struct Glyph {
+        float u0 = 0, v0 = 0, u1 = 0, v1 = 0;
+        float offsetX = 0, offsetY = 0;
+        float width = 0, height = 0;
+        float advance = 0;
+    };
+
+    static constexpr int CORNER_SIZE = 64;
+
+    explicit UIGlyphAtlas(int size = 1024) : size_(std::max(128, size)) {
+        clear();
+    }
+
+    int getSize() const { return size_; }
+    const std::vector<uint8_t>& getPixels() const { return pixels_; }
+    uint32_t getGeneration() const { return generation_; }
+    size_t getGlyphCount() const { return glyphs_.size(); }
+
+    // Region touched since the last upload
+    bool getDirtyRect(UIRect& rect) const {
+        if (dirtyMaxX_ <= dirtyMinX_ || dirtyMaxY_ <= dirtyMinY_) return false;
+        rect = {(float)dirtyMinX_, (float)dirtyMinY_,
+                (float)(dirtyMaxX_ - dirtyMinX_), (float)(dirtyMaxY_ - dirtyMinY_)};
+        return true;
+    }
+    void clearDirty() { dirtyMinX_ = dirtyMinY_ = size_; dirtyMaxX_ = dirtyMaxY_ = 0; }
+
+    // Drop every glyph and re-create the built-in regions
+    void clear() {
+        pixels_.assign((size_t)size_ * size_, 0);
+        glyphs_.clear();
+        shelves_.clear();
+        shelfTop_ = 0;
+        generation_++;
+        clearDirty();
+
+        int x, y;
+        allocate(4, 4, x, y);
+        fill(x, y, 4, 4, nullptr);
+        whiteU_ = (x + 2.0f) / size_;
+        whiteV_ = (y + 2.0f) / size_;
+
+        // Quarter disc centred on the region's bottom-right; the top-left
+        // texel is empty. Flipping UVs gives the other three corners.
+        allocate(CORNER_SIZE, CORNER_SIZE, x, y);
+        std::vector<uint8_t> mask((size_t)CORNER_SIZE * CORNER_SIZE);
+        for (int py = 0; py < CORNER_SIZE; py++) {
+            for (int px = 0; px < CORNER_SIZE; px++) {
+                float dx = CORNER_SIZE - (px + 0.5f);
+                float dy = CORNER_SIZE - (py + 0.5f);
+                float d = std::sqrt(dx * dx + dy * dy);
+                float a = std::max(0.0f, std::min(1.0f, CORNER_SIZE - d + 0.5f));
+                mask[py * CORNER_SIZE + px] = (uint8_t)(a * 255.0f + 0.5f);
+            }
+        }
+        fill(x, y, CORNER_SIZE, CORNER_SIZE, mask.data());
+        cornerUV_ = {(float)x / size_, (float)y / size_,
+                     (float)CORNER_SIZE / size_, (float)CORNER_SIZE / size_};
+    }
+
+    float getWhiteU() const { return whiteU_; }
+    float getWhiteV() const { return whiteV_; }
+    const UIRect& getCornerUV() const { return cornerUV_; }
+
+    static uint64_t glyphKey(uint16_t fontId, int pixelSize, uint32_t codepoint) {
+        return ((uint64_t)fontId << 48) | ((uint64_t)(pixelSize & 0xFFFF) << 32) | codepoint;
+    }
+
+    const Glyph* findGlyph(uint64_t key) const {
+        auto it = glyphs_.find(key);
+        return it != glyphs_.end() ? &it->second : nullptr;
+    }
+
+    // Returns nullptr when the atlas is full
+    const Glyph* addGlyph(uint64_t key, const UIGlyphBitmap& bitmap) {
+        Glyph g;
+        g.offsetX = (float)bitmap.offsetX;
+        g.offsetY = (float)bitmap.offsetY;
+        g.width = (float)bitmap.width;
+        g.height = (float)bitmap.height;
+        g.advance = bitmap.advance;
+
+        if (bitmap.width > 0 && bitmap.height > 0 &&
+            (int)bitmap.coverage.size() >= bitmap.width * bitmap.height) {
+            int x, y;
+            if (!allocate(bitmap.width, bitmap.height, x, y)) return nullptr;
+            fill(x, y, bitmap.width, bitmap.height, bitmap.coverage.data());
+            g.u0 = (float)x / size_;
+            g.v0 = (float)y / size_;
+            g.u1 = (float)(x + bitmap.width) / size_;
+            g.v1 = (float)(y + bitmap.height) / size_;
+        }
+        return &(glyphs_[key] = g);
+    }
+
+private:
+    struct Shelf {
+        int y = 0;
+        int height = 0;
+        int x = 0;
+    };
+
+    // Shelf packer with one texel of padding around every entry
+    bool allocate(int w, int h, int& outX, int& outY) {
+        int pw = w + 1, ph = h + 1;
+        if (pw > size_ || ph > size_) return false;
+
+        Shelf* best = nullptr;
+        for (auto& shelf : shelves_) {
+            if (ph <= shelf.height && shelf.x + pw <= size_ &&
+                (!best || shelf.height < best->height)) {
+                best = &shelf;
+            }
+        }
+        if (!best) {
+            if (shelfTop_ + ph > size_) return false;
+            shelves_.push_back({shelfTop_, ph, 0});
+            shelfTop_ += ph;
+            best = &shelves_.back();
+        }
+        outX = best->x + 1;
+        outY = best->y + 1;
+        best->x += pw;
+        return true;
+    }
+
+    void fill(int x, int y, int w, int h, const uint8_t* src) {
+        for (int row = 0; row < h; row++) {
+            uint8_t* dst = &pixels_[(size_t)(y + row) * size_ + x];
+            if (src) std::memcpy(dst, src + (size_t)row * w, w);
+            else std::memset(dst, 255, w);
+        }
+        dirtyMinX_ = std::min(dirtyMinX_, x);
+        dirtyMinY_ = std::min(dirtyMinY_, y);
+        dirtyMaxX_ = std::max(dirtyMaxX_, x + w);
+        dirtyMaxY_ = std::max(dirtyMaxY_, y + h);
+    }
+
+    int size_;
+    std::vector<uint8_t> pixels_;
+    std::unordered_map<uint64_t, Glyph> glyphs_;
+    std::vector<Shelf> shelves_;
+    int shelfTop_ = 0;
+    uint32_t generation_ = 0;
+
+    float whiteU_ = 0.0f;
+    float whiteV_ = 0.0f;
+    UIRect cornerUV_ = {0, 0, 0, 0};
+
+    int dirtyMinX_ = 0, dirtyMinY_ = 0, dirtyMaxX_ = 0, dirtyMaxY_ = 0;
+};
+
+// ===== Shaped Text Run =====
+// Glyph quads relative to the pen origin on the baseline
+struct UITextRun {
+    struct Quad {
+        float x0, y0, x1, y1;
+        float u0, v0, u1, v1;
+    };
+    std::vector<Quad> quads;
+    float width = 0.0f;
+    float ascent = 0.0f;
+    float lineHeight = 0.0f;
+};
+
+// ===== Batched UI Renderer =====
+// Draws canvases straight into vertex/index streams instead of going through
+// IUIRenderer. Each canvas keeps the quads of every widget from the last
+// frame; only widgets stamped after that frame are regenerated, and their
+// vertices are patched in place when the batch layout did not change.
+class UIBatchRenderer {
+public:
+    static constexpr uint64_t ATLAS_TEXTURE = 0;
+    static constexpr size_t MAX_TEXT_RUNS = 4096;
+
+    explicit UIBatchRenderer(IUIFontProvider* fonts = nullptr, int atlasSize = 1024)
+        : fonts_(fonts ? fonts : &fallbackFont_), atlas_(atlasSize) {}
+
+    // Render all visible canvases of a system in render order
+    void render(UISystem& system) {
+        auto start = std::chrono::high_resolution_clock::now();
+        beginStats();
+        frame_++;
+
+        const auto& canvases = system.getSortedCanvases();
+        for (int attempt = 0; attempt < 2; attempt++) {
+            atlasFull_ = false;
+            drawLists_.clear();
+            for (UICanvas* canvas : canvases) {
+                drawLists_.push_back(&renderCanvasInternal(*canvas));
+            }
+            if (!atlasFull_ || !recoverAtlas()) break;
+        }
+
+        // Forget canvases that were removed or hidden
+        for (auto it = caches_.begin(); it != caches_.end();) {
+            if (it->second.frame != frame_) it = caches_.erase(it);
+            else ++it;
+        }
+
+        endStats(start);
+    }
+
+    // Render a single canvas; returns its draw list
+    const UIDrawList& renderCanvas(UICanvas& canvas) {
+        auto start = std::chrono::high_resolution_clock::now();
+        beginStats();
+        frame_++;
+
+        drawLists_.clear();
+        const UIDrawList* list = nullptr;
+        for (int attempt = 0; attempt < 2; attempt++) {
+            atlasFull_ = false;
+            list = &renderCanvasInternal(canvas);
+            if (!atlasFull_ || !recoverAtlas()) break;
+        }
+        drawLists_.push_back(list);
+
+        endStats(start);
+        return *list;
+    }
+
+    // Draw lists of the last render() in paint order
+    const std::vector<const UIDrawList*>& getDrawLists() const { return drawLists_; }
+
+    const UIDrawList* getDrawList(const UICanvas* canvas) const {
+        auto it = caches_.find(canvas);
+        return it != caches_.end() ? &it->second.drawList : nullptr;
+    }
+
+    UIGlyphAtlas& getAtlas() { return atlas_; }
+    const UIRenderStats& getStats() const { return stats_; }
+    size_t getTextRunCount() const { return runs_.size(); }
+    const std::string& getLastError() const { return lastError_; }
+
+    // Regenerate every widget on the next frame
+    void invalidate() {
+        for (auto& [canvas, cache] : caches_) cache.rootId = UINT32_MAX;
+    }
+
+private:
+    struct Segment {
+        uint64_t texture = 0;
+        uint32_t quadCount = 0;
+        bool operator==(const Segment& o) const { return texture == o.texture && quadCount == o.quadCount; }
+        bool operator!=(const Segment& o) const { return !(*this == o); }
+    };
+
+    struct WidgetGeometry {
+        std::vector<UIVertex> vertices;
+        std::vector<Segment> segments;
+        UIRect bounds = {0, 0, 0, 0};
+        uint32_t vertexOffset = 0;
+        uint16_t clip = 0;       // scissor this widget is drawn with
+        uint16_t childClip = 0;  // scissor its children are drawn with
+        uint32_t frame = 0;
+        bool culled = false;
+        bool valid = false;
+    };
+
+    struct CanvasCache {
+        uint64_t stamp = 0;
+        uint32_t rootId = UINT32_MAX;
+        uint32_t atlasGeneration = 0;
+        float screenWidth = 0.0f;
+        float screenHeight = 0.0f;
+        uint32_t frame = 0;
+        std::unordered_map<uint32_t, WidgetGeometry> widgets;
+        std::vector<WidgetGeometry*> order;
+        std::vector<UIRect> clips;
+        UIDrawList drawList;
+    };
+
+    struct RunEntry {
+        uint16_t fontId = 0;
+        int pixelSize = 0;
+        std::string text;
+        UITextRun run;
+    };
+
+    // ----- Frame -----
+
+    void beginStats() {
+        stats_ = UIRenderStats();
+        lastError_.clear();
+    }
+
+    void endStats(std::chrono::high_resolution_clock::time_point start) {
+        for (const UIDrawList* list : drawLists_) {
+            stats_.drawCalls += (uint32_t)list->batches.size();
+            stats_.vertices += (uint32_t)list->vertices.size();
+            stats_.indices += (uint32_t)list->indices.size();
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        stats_.cpuMs = std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    // Clear the atlas and redo the frame once; the new generation forces every
+    // canvas to rebuild. Text that still does not fit is dropped.
+    bool recoverAtlas() {
+        if (atlasRecovered_ == frame_) {
+            lastError_ = "Glyph atlas full";
+            return false;
+        }
+        atlasRecovered_ = frame_;
+        atlas_.clear();
+        runs_.clear();
+        return true;
+    }
+
+    UIDrawList& renderCanvasInternal(UICanvas& canvas) {
+        stats_.canvases++;
+        CanvasCache& cache = caches_[&canvas];
+        cache.frame = frame_;
+
+        UIWidget* root = canvas.getRoot();
+        bool full = cache.rootId != root->getId() ||
+                    cache.atlasGeneration != atlas_.getGeneration() ||
+                    cache.screenWidth != canvas.getScreenWidth() ||
+                    cache.screenHeight != canvas.getScreenHeight();
+        if (full) {
+            // Keep the allocations; stale entries are swept after the walk
+            for (auto& [id, geo] : cache.widgets) geo.valid = false;
+            cache.rootId = root->getId();
+            cache.atlasGeneration = atlas_.getGeneration();
+            cache.screenWidth = canvas.getScreenWidth();
+            cache.screenHeight = canvas.getScreenHeight();
+        } else if (root->getSubtreeVersion() <= cache.stamp) {
+            return cache.drawList;
+        }
+
+        uint64_t stamp = cache.stamp;
+        cache.stamp = UIWidget::getVersionClock();
+
+        bool restitch = full || root->getStructureVersion() > stamp;
+        if (!restitch) {
+            patched_.clear();
+            bool needFull = false;
+            updateDirty(cache, root, stamp, restitch, needFull);
+            if (needFull) {
+                restitch = true;
+            } else if (!restitch) {
+                for (WidgetGeometry* geo : patched_) {
+                    std::copy(geo->vertices.begin(), geo->vertices.end(),
+                              cache.drawList.vertices.begin() + geo->vertexOffset);
+                }
+                stats_.widgetsPatched += (uint32_t)patched_.size();
+                return cache.drawList;
+            }
+        }
+
+        // Full walk: regenerate what changed, then stitch everything
+        cache.order.clear();
+        cache.clips.clear();
+        cache.clips.push_back({0, 0, canvas.getScreenWidth(), canvas.getScreenHeight()});
+        walk(cache, root, 0, stamp);
+        for (auto it = cache.widgets.begin(); it != cache.widgets.end();) {
+            if (it->second.frame != frame_) it = cache.widgets.erase(it);
+            else ++it;
+        }
+        stitch(cache);
+        return cache.drawList;
+    }
+
+    static bool drawsGeometry(UIWidgetType type) {
+        switch (type) {
+            case UIWidgetType::Panel:
+            case UIWidgetType::Label:
+            case UIWidgetType::Image:
+            case UIWidgetType::Button:
+            case UIWidgetType::Checkbox:
+            case UIWidgetType::Slider:
+            case UIWidgetType::ProgressBar:
+            case UIWidgetType::InputField:
+            case UIWidgetType::Dropdown:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    static bool clipsChildren(UIWidgetType type) {
+        return type == UIWidgetType::ScrollView || type == UIWidgetType::ListView;
+    }
+
+    void walk(CanvasCache& cache, UIWidget* widget, uint16_t clip, uint64_t stamp) {
+        if (!widget->isVisible()) return;
+
+        UIWidgetType type = widget->getType();
+        uint16_t childClip = clip;
+        bool draws = drawsGeometry(type);
+        bool clips = clipsChildren(type);
+
+        if (draws || clips) {
+            WidgetGeometry& geo = cache.widgets[widget->getId()];
+            geo.frame = frame_;
+            geo.clip = clip;
+            if (clips && cache.clips.size() < UINT16_MAX) {
+                childClip = (uint16_t)cache.clips.size();
+                cache.clips.push_back(widget->getWorldRect().intersection(cache.clips[clip]));
+            }
+            geo.childClip = childClip;
+            if (draws) {
+                if (!geo.valid || widget->getRenderVersion() > stamp) {
+                    build(geo, widget);
+                }
+                cache.order.push_back(&geo);
+            }
+        }
+
+        for (const auto& child : widget->getChildren()) {
+            walk(cache, child.get(), childClip, stamp);
+        }
+    }
+
+    // Descend only into subtrees stamped after the last frame
+    void updateDirty(CanvasCache& cache, UIWidget* widget, uint64_t stamp,
+                     bool& restitch, bool& needFull) {
+        if (needFull) return;
+
+        if (widget->getRenderVersion() > stamp) {
+            UIWidgetType type = widget->getType();
+            if (drawsGeometry(type) || clipsChildren(type)) {
+                auto it = cache.widgets.find(widget->getId());
+                if (it == cache.widgets.end()) {
+                    needFull = true;
+                    return;
+                }
+                WidgetGeometry& geo = it->second;
+
+                if (clipsChildren(type)) {
+                    UIRect rect = widget->getWorldRect().intersection(cache.clips[geo.clip]);
+                    if (geo.childClip == geo.clip || rect != cache.clips[geo.childClip]) {
+                        needFull = true;
+                        return;
+                    }
+                }
+                if (drawsGeometry(type)) {
+                    segmentScratch_ = geo.segments;
+                    bool wasCulled = geo.culled;
+                    build(geo, widget);
+                    geo.culled = isCulled(geo, cache);
+                    if (geo.culled != wasCulled || geo.segments != segmentScratch_) {
+                        restitch = true;
+                    } else if (!geo.culled && !geo.vertices.empty()) {
+                        patched_.push_back(&geo);
+                    }
+                }
+            }
+        }
+
+        for (const auto& child : widget->getChildren()) {
+            if (child->getSubtreeVersion() > stamp) {
+                updateDirty(cache, child.get(), stamp, restitch, needFull);
+            }
+        }
+    }
+
+    static bool isCulled(const WidgetGeometry& geo, const CanvasCache& cache) {
+        const UIRect& clip = cache.clips[geo.clip];
+        return geo.vertices.empty() || clip.width <= 0.0f || clip.height <= 0.0f ||
+               !geo.bounds.intersects(clip);
+    }
+
+    // Concatenate cached widget geometry; neighbouring quads with the same
+    // texture and scissor share a draw call. Only consecutive runs merge so
+    // paint order is preserved.
+    void stitch(CanvasCache& cache) {
+        stats_.canvasesRestitched++;
+        UIDrawList& list = cache.drawList;
+        list.vertices.clear();
+        list.batches.clear();
+
+        uint32_t quads = 0;
+        uint16_t lastClip = UINT16_MAX;
+        for (WidgetGeometry* geo : cache.order) {
+            geo->culled = isCulled(*geo, cache);
+            if (geo->culled) continue;
+
+            geo->vertexOffset = (uint32_t)list.vertices.size();
+            list.vertices.insert(list.vertices.end(), geo->vertices.begin(), geo->vertices.end());
+
+            for (const Segment& seg : geo->segments) {
+                if (!list.batches.empty() && list.batches.back().texture == seg.texture &&
+                    lastClip == geo->clip) {
+                    list.batches.back().indexCount += seg.quadCount * 6;
+                } else {
+                    UIDrawBatch batch;
+                    batch.texture = seg.texture;
+                    batch.clip = cache.clips[geo->clip];
+                    batch.firstIndex = quads * 6;
+                    batch.indexCount = seg.quadCount * 6;
+                    list.batches.push_back(batch);
+                    lastClip = geo->clip;
+                }
+                quads += seg.quadCount;
+            }
+        }
+
+        size_t indexCount = (size_t)quads * 6;
+        size_t have = list.indices.size();
+        list.indices.resize(indexCount);
+        for (size_t q = have / 6; q < quads; q++) {
+            uint32_t base = (uint32_t)(q * 4);
+            uint32_t* idx = &list.indices[q * 6];
+            idx[0] = base; idx[1] = base + 1; idx[2] = base + 2;
+            idx[3] = base; idx[4] = base + 2; idx[5] = base + 3;
+        }
+    }
+
+    // ----- Geometry -----
+
+    void build(WidgetGeometry& geo, UIWidget* widget) {
+        stats_.widgetsRebuilt++;
+        target_ = &geo;
+        geo.vertices.clear();
+        geo.segments.clear();
+        minX_ = minY_ = 1e30f;
+        maxX_ = maxY_ = -1e30f;
+
+        switch (widget->getType()) {
+            case UIWidgetType::Panel:
+                buildPanel(static_cast<UIPanel*>(widget));
+                break;
+            case UIWidgetType::Label:
+                buildLabel(static_cast<UILabel*>(widget));
+                break;
+            case UIWidgetType::Image:
+                buildImage(static_cast<UIImage*>(widget));
+                break;
+            case UIWidgetType::Button:
+                buildButton(static_cast<UIButton*>(widget));
+                break;
+            case UIWidgetType::Checkbox:
+                buildCheckbox(static_cast<UICheckbox*>(widget));
+                break;
+            case UIWidgetType::Slider:
+                buildSlider(static_cast<UISlider*>(widget));
+                break;
+            case UIWidgetType::ProgressBar:
+                buildProgressBar(static_cast<UIProgressBar*>(widget));
+                break;
+            case UIWidgetType::InputField:
+                buildInputField(static_cast<UIInputField*>(widget));
+                break;
+            case UIWidgetType::Dropdown:
+                buildDropdown(static_cast<UIDropdown*>(widget));
+                break;
+            default:
+                break;
+        }
+
+        geo.bounds = geo.vertices.empty()
+            ? UIRect{0, 0, 0, 0}
+            : UIRect{minX_, minY_, maxX_ - minX_, maxY_ - minY_};
+        geo.valid = true;
+        target_ = nullptr;
+    }
+
+    void quad(uint64_t texture, float x0, float y0, float x1, float y1,
+              float u0, float v0, float u1, float v1, uint32_t color) {
+        if (x1 <= x0 || y1 <= y0) return;
+
+        auto& segs = target_->segments;
+        if (!segs.empty() && segs.back().texture == texture) segs.back().quadCount++;
+        else segs.push_back({texture, 1});
+
+        auto& v = target_->vertices;
+        v.push_back({x0, y0, u0, v0, color});
+        v.push_back({x1, y0, u1, v0, color});
+        v.push_back({x1, y1, u1, v1, color});
+        v.push_back({x0, y1, u0, v1, color});
+
+        minX_ = std::min(minX_, x0);
+        minY_ = std::min(minY_, y0);
+        maxX_ = std::max(maxX_, x1);
+        maxY_ = std::max(maxY_, y1);
+    }
+
+    void solid(float x0, float y0, float x1, float y1, uint32_t color) {
+        float u = atlas_.getWhiteU(), v = atlas_.getWhiteV();
+        quad(ATLAS_TEXTURE, x0, y0, x1, y1, u, v, u, v, color);
+    }
+
+    void rect(const UIRect& r, const UIColor& color) {
+        if (color.a <= 0.0f) return;
+        solid(r.x, r.y, r.x + r.width, r.y + r.height, packUIColor(color));
+    }
+
+    // Four masked corners plus three solid strips
+    void roundedRect(const UIRect& r, const UIColor& color, float radius) {
+        if (color.a <= 0.0f || r.width <= 0.0f || r.height <= 0.0f) return;
+        radius = std::min(radius, std::min(r.width, r.height) * 0.5f);
+        uint32_t c = packUIColor(color);
+        float x0 = r.x, y0 = r.y, x1 = r.x + r.width, y1 = r.y + r.height;
+        if (radius < 0.5f) {
+            solid(x0, y0, x1, y1, c);
+            return;
+        }
+
+        const UIRect& m = atlas_.getCornerUV();
+        float mu0 = m.x, mv0 = m.y, mu1 = m.x + m.width, mv1 = m.y + m.height;
+        float ix0 = x0 + radius, iy0 = y0 + radius, ix1 = x1 - radius, iy1 = y1 - radius;
+
+        quad(ATLAS_TEXTURE, x0, y0, ix0, iy0, mu0, mv0, mu1, mv1, c);
+        quad(ATLAS_TEXTURE, ix1, y0, x1, iy0, mu1, mv0, mu0, mv1, c);
+        quad(ATLAS_TEXTURE, x0, iy1, ix0, y1, mu0, mv1, mu1, mv0, c);
+        quad(ATLAS_TEXTURE, ix1, iy1, x1, y1, mu1, mv1, mu0, mv0, c);
+
+        solid(ix0, y0, ix1, iy0, c);
+        solid(ix0, iy1, ix1, y1, c);
+        solid(x0, iy0, x1, iy1, c);
+    }
+
+    void rectOutline(const UIRect& r, const UIColor& color, float width) {
+        if (color.a <= 0.0f || width <= 0.0f) return;
+        uint32_t c = packUIColor(color);
+        float x0 = r.x, y0 = r.y, x1 = r.x + r.width, y1 = r.y + r.height;
+        width = std::min(width, std::min(r.width, r.height) * 0.5f);
+        solid(x0, y0, x1, y0 + width, c);
+        solid(x0, y1 - width, x1, y1, c);
+        solid(x0, y0 + width, x0 + width, y1 - width, c);
+        solid(x1 - width, y0 + width, x1, y1 - width, c);
+    }
+
+    void image(const UIRect& r, uint64_t texture, const UIRect& uv, const UIColor& tint) {
+        if (tint.a <= 0.0f) return;
+        if (texture == ATLAS_TEXTURE) {
+            rect(r, tint);
+            return;
+        }
+        quad(texture, r.x, r.y, r.x + r.width, r.y + r.height,
+             uv.x, uv.y, uv.x + uv.width, uv.y + uv.height, packUIColor(tint));
+    }
+
+    void text(const std::string& str, const UIRect& r, const UIColor& color,
+              const std::string& font, float fontSize,
+              UILabel::HAlign hAlign, UILabel::VAlign vAlign) {
+        if (str.empty() || color.a <= 0.0f) return;
+        const UITextRun* run = shapeRun(font, fontSize, str);
+        if (!run) return;
+
+        float x = r.x;
+        if (hAlign == UILabel::HAlign::Center) x = r.x + (r.width - run->width) * 0.5f;
+        else if (hAlign == UILabel::HAlign::Right) x = r.x + r.width - run->width;
+
+        float top = r.y;
+        if (vAlign == UILabel::VAlign::Middle) top = r.y + (r.height - run->lineHeight) * 0.5f;
+        else if (vAlign == UILabel::VAlign::Bottom) top = r.y + r.height - run->lineHeight;
+
+        float penX = std::floor(x + 0.5f);
+        float baseline = std::floor(top + run->ascent + 0.5f);
+        uint32_t c = packUIColor(color);
+        for (const auto& q : run->quads) {
+            quad(ATLAS_TEXTURE, penX + q.x0, baseline + q.y0, penX + q.x1, baseline + q.y1,
+                 q.u0, q.v0, q.u1, q.v1, c);
+        }
+    }
+
+    // ----- Text -----
+
+    uint16_t fontId(const std::string& font) {
+        auto it = fontIds_.find(font);
+        if (it != fontIds_.end()) return it->second;
+        uint16_t id = (uint16_t)fontIds_.size();
+        fontIds_[font] = id;
+        return id;
+    }
+
+    static uint64_t runHash(uint16_t font, int pixelSize, const std::string& str) {
+        uint64_t h = 1469598103934665603ull;
+        auto mix = [&h](uint8_t b) { h ^= b; h *= 1099511628211ull; };
+        mix((uint8_t)font); mix((uint8_t)(font >> 8));
+        mix((uint8_t)pixelSize); mix((uint8_t)(pixelSize >> 8));
+        for (char ch : str) mix((uint8_t)ch);
+        return h;
+    }
+
+    static uint32_t decodeUTF8(const std::string& s, size_t& i) {
+        uint8_t c = (uint8_t)s[i++];
+        if (c < 0x80) return c;
+        int extra = (c >= 0xF0) ? 3 : (c >= 0xE0) ? 2 : (c >= 0xC0) ? 1 : 0;
+        if (extra == 0) return 0xFFFD;
+        uint32_t cp = c & (0x3F >> extra);
+        for (int k = 0; k < extra; k++) {
+            if (i >= s.size() || ((uint8_t)s[i] & 0xC0) != 0x80) return 0xFFFD;
+            cp = (cp << 6) | ((uint8_t)s[i++] & 0x3F);
+        }
+        return cp;
+    }
+
+    const UITextRun* shapeRun(const std::string& font, float fontSize, const std::string& str) {
+        int px = std::max(1, (int)std::lround(fontSize));
+        uint16_t fid = fontId(font);
+        uint64_t key = runHash(fid, px, str);
+
+        auto it = runs_.find(key);
+        if (it != runs_.end() && it->second.fontId == fid &&
+            it->second.pixelSize == px && it->second.text == str) {
+            stats_.textRunHits++;
+            return &it->second.run;
+        }
+
+        UITextRun run;
+        run.ascent = fonts_->getAscent(font, px);
+        run.lineHeight = fonts_->getLineHeight(font, px);
+        float pen = 0.0f;
+        for (size_t i = 0; i < str.size();) {
+            uint32_t cp = decodeUTF8(str, i);
+            uint64_t gkey = UIGlyphAtlas::glyphKey(fid, px, cp);
+            const UIGlyphAtlas::Glyph* g = atlas_.findGlyph(gkey);
+            if (!g) {
+                if (!fonts_->getGlyph(font, px, cp, glyphScratch_)) continue;
+                g = atlas_.addGlyph(gkey, glyphScratch_);
+                if (!g) {
+                    atlasFull_ = true;
+                    return nullptr;
+                }
+                stats_.glyphsRasterized++;
+            }
+            if (g->width > 0 && g->height > 0) {
+                float x0 = pen + g->offsetX;
+                run.quads.push_back({x0, g->offsetY, x0 + g->width, g->offsetY + g->height,
+                                     g->u0, g->v0, g->u1, g->v1});
+            }
+            pen += g->advance;
+        }
+        run.width = pen;
+        stats_.textRunsShaped++;
+
+        if (runs_.size() >= MAX_TEXT_RUNS) runs_.clear();
+        RunEntry& entry = runs_[key];
+        entry.fontId = fid;
+        entry.pixelSize = px;
+        entry.text = str;
+        entry.run = std::move(run);
+        return &entry.run;
+    }
+
+    // ----- Widgets (mirrors UIWidgetDrawer) -----
+
+    void buildPanel(UIPanel* panel) {
+        const UIRect& r = panel->getWorldRect();
+        roundedRect(r, panel->getBackgroundColor(), panel->getCornerRadius());
+        if (panel->getBorderWidth() > 0) {
+            rectOutline(r, panel->getBorderColor(), panel->getBorderWidth());
+        }
+    }
+
+    void buildLabel(UILabel* label) {
+        text(label->getText(), label->getWorldRect(), label->getTextColor(),
+             label->getFontName(), label->getFontSize(), label->getHAlign(), label->getVAlign());
+    }
+
+    void buildImage(UIImage* img) {
+        image(img->getWorldRect(), img->getTextureHandle(), img->getUVRect(), img->getColor());
+    }
+
+    void buildButton(UIButton* button) {
+        roundedRect(button->getWorldRect(), button->getCurrentColor(), button->getBorderRadius());
+    }
+
+    void buildCheckbox(UICheckbox* checkbox) {
+        const UIRect& r = checkbox->getWorldRect();
+        float boxSize = checkbox->getBoxSize();
+        UIRect boxRect = {r.x, r.y + (r.height - boxSize) * 0.5f, boxSize, boxSize};
+        roundedRect(boxRect, UIColor(0.3f, 0.3f, 0.3f, 1.0f), 2.0f);
+        if (checkbox->isChecked()) {
+            UIRect checkRect = {boxRect.x + 3, boxRect.y + 3, boxSize - 6, boxSize - 6};
+            roundedRect(checkRect, UIColor(0.3f, 0.7f, 0.3f, 1.0f), 2.0f);
+        }
+    }
+
+    void buildSlider(UISlider* slider) {
+        const UIRect& r = slider->getWorldRect();
+        float handleSize = slider->getHandleSize();
+        float normalized = slider->getNormalizedValue();
+
+        UIRect trackRect = {r.x, r.y + r.height * 0.5f - 2, r.width, 4};
+        roundedRect(trackRect, UIColor(0.2f, 0.2f, 0.2f, 1.0f), 2.0f);
+
+        UIRect fillRect = {r.x, trackRect.y, r.width * normalized, 4};
+        roundedRect(fillRect, UIColor(0.3f, 0.6f, 1.0f, 1.0f), 2.0f);
+
+        float handleX = r.x + normalized * r.width - handleSize * 0.5f;
+        UIRect handleRect = {handleX, r.y + (r.height - handleSize) * 0.5f, handleSize, handleSize};
+        roundedRect(handleRect, UIColor::White(), handleSize * 0.5f);
+    }
+
+    void buildProgressBar(UIProgressBar* bar) {
+        const UIRect& r = bar->getWorldRect();
+        float value = bar->getDisplayValue();
+
+        roundedRect(r, bar->getBackgroundColor(), 4.0f);
+        UIRect fillRect = {r.x + 2, r.y + 2, (r.width - 4) * value, r.height - 4};
+        roundedRect(fillRect, bar->getFillColor(), 2.0f);
+
+        if (bar->getShowText()) {
+            char buf[16];
+            snprintf(buf, sizeof(buf), "%.0f%%", value * 100);
+            text(buf, r, UIColor::White(), "default", 14.0f,
+                 UILabel::HAlign::Center, UILabel::VAlign::Middle);
+        }
+    }
+
+    void buildInputField(UIInputField* input) {
+        const UIRect& r = input->getWorldRect();
+        bool focused = input->isFocused();
+
+        roundedRect(r, focused ? UIColor(0.25f, 0.25f, 0.25f, 1.0f) : UIColor(0.2f, 0.2f, 0.2f, 1.0f), 4.0f);
+        rectOutline(r, focused ? UIColor(0.3f, 0.6f, 1.0f, 1.0f) : UIColor(0.4f, 0.4f, 0.4f, 1.0f), 1.0f);
+
+        bool placeholder = input->getText().empty() && !focused;
+        UIRect textRect = {r.x + 8, r.y, r.width - 16, r.height};
+        text(placeholder ? input->getPlaceholder() : input->getDisplayText(), textRect,
+             placeholder ? UIColor(0.5f, 0.5f, 0.5f, 1.0f) : UIColor::White(),
+             "default", 14.0f, UILabel::HAlign::Left, UILabel::VAlign::Middle);
+    }
+
+    void buildDropdown(UIDropdown* dropdown) {
+        const UIRect& r = dropdown->getWorldRect();
+
+        roundedRect(r, UIColor(0.25f, 0.25f, 0.25f, 1.0f), 4.0f);
+        rectOutline(r, UIColor(0.4f, 0.4f, 0.4f, 1.0f), 1.0f);
+
+        UIRect textRect = {r.x + 8, r.y, r.width - 32, r.height};
+        text(dropdown->getSelectedOption(), textRect, UIColor::White(),
+             "default", 14.0f, UILabel::HAlign::Left, UILabel::VAlign::Middle);
+
+        UIRect arrowRect = {r.x + r.width - 24, r.y, 16, r.height};
+        text(dropdown->isExpanded() ? "^" : "v", arrowRect, UIColor::White(),
+             "default", 12.0f, UILabel::HAlign::Center, UILabel::VAlign::Middle);
+
+        if (dropdown->isExpanded()) {
+            const auto& options = dropdown->getOptions();
+            float itemHeight = 28.0f;
+            UIRect listRect = {r.x, r.y + r.height, r.width, options.size() * itemHeight};
+            roundedRect(listRect, UIColor(0.2f, 0.2f, 0.2f, 0.95f), 4.0f);
+
+            for (size_t i = 0; i < options.size(); i++) {
+                UIRect itemRect = {r.x, r.y + r.height + i * itemHeight, r.width, itemHeight};
+                if ((int)i == dropdown->getSelectedIndex()) {
+                    rect(itemRect, UIColor(0.3f, 0.5f, 0.8f, 1.0f));
+                }
+                UIRect itemTextRect = {itemRect.x + 8, itemRect.y, itemRect.width - 16, itemRect.height};
+                text(options[i], itemTextRect, UIColor::White(),
+                     "default", 14.0f, UILabel::HAlign::Left, UILabel::VAlign::Middle);
+            }
+        }
+    }
+
+    UIFallbackFont fallbackFont_;
+    IUIFontProvider* fonts_;
+    UIGlyphAtlas atlas_;
+
+    std::unordered_map<const UICanvas*, CanvasCache> caches_;
+    std::vector<const UIDrawList*> drawLists_;
+    std::unordered_map<uint64_t, RunEntry> runs_;
+    std::unordered_map<std::string, uint16_t> fontIds_;
+
+    // Scratch for the widget currently being built
+    WidgetGeometry* target_ = nullptr;
+    float minX_ = 0, minY_ = 0, maxX_ = 0, maxY_ = 0;
+    std::vector<Segment> segmentScratch_;
+    std::vector<WidgetGeometry*> patched_;
+    UIGlyphBitmap glyphScratch_;
+
+    UIRenderStats stats_;
+    uint32_t frame_ = 0;
+    uint32_t atlasRecovered_ = UINT32_MAX;
+    bool atlasFull_ = false;
+    std::string lastError_;
+};
+
+}  // namespace ui
+}  // namespace luma
@@ -53,6 +53,11 @@ struct UIRect {
                  y + height <= other.y || other.y + other.height <= y);
     }
     
+    bool operator==(const UIRect& other) const {
+        return x == other.x && y == other.y && width == other.width && height == other.height;
+    }
+    bool operator!=(const UIRect& other) const { return !(*this == other); }
+    
     UIRect intersection(const UIRect& other) const {
         float nx = std::max(x, other.x);
         float ny = std::max(y, other.y);
@@ -187,18 +192,28 @@ public:
     
     // Visibility
     bool isVisible() const { return visible_; }
-    void setVisible(bool v) { visible_ = v; }
+    void setVisible(bool v) {
+        if (visible_ != v) { visible_ = v; markStructureDirty(); }
+    }
     
     bool isEnabled() const { return enabled_; }
-    void setEnabled(bool e) { enabled_ = e; }
+    void setEnabled(bool e) {
+        if (enabled_ != e) { enabled_ = e; markDirty(); }
+    }
     
     bool isInteractive() const { return interactive_; }
     void setInteractive(bool i) { interactive_ = i; }
     
     // Transform
-    void setPosition(float x, float y) { localRect_.x = x; localRect_.y = y; markDirty(); }
-    void setSize(float w, float h) { localRect_.width = w; localRect_.height = h; markDirty(); }
-    void setRect(const UIRect& rect) { localRect_ = rect; markDirty(); }
+    void setPosition(float x, float y) {
+        if (x != localRect_.x || y != localRect_.y) { localRect_.x = x; localRect_.y = y; markDirty(); }
+    }
+    void setSize(float w, float h) {
+        if (w != localRect_.width || h != localRect_.height) { localRect_.width = w; localRect_.height = h; markDirty(); }
+    }
+    void setRect(const UIRect& rect) {
+        if (rect != localRect_) { localRect_ = rect; markDirty(); }
+    }
     
     float getX() const { return localRect_.x; }
     float getY() const { return localRect_.y; }
@@ -221,10 +236,10 @@ public:
     const UIMargin& getMargin() const { return margin_; }
     
     // Appearance
-    void setColor(const UIColor& color) { color_ = color; }
+    void setColor(const UIColor& color) { color_ = color; markDirty(); }
     const UIColor& getColor() const { return color_; }
     
-    void setAlpha(float alpha) { color_.a = alpha; }
+    void setAlpha(float alpha) { color_.a = alpha; markDirty(); }
     float getAlpha() const { return color_.a; }
     
     // Hierarchy
@@ -236,7 +251,7 @@ public:
         child->removeFromParent();
         child->parent_ = this;
         children_.push_back(child);
-        markDirty();
+        markStructureDirty();
     }
     
     void removeChild(UIWidget* child) {
@@ -246,7 +261,7 @@ public:
             children_.end()
         );
         if (child) child->parent_ = nullptr;
-        markDirty();
+        markStructureDirty();
     }
     
     void removeFromParent() {
@@ -291,7 +306,9 @@ public:
     
     // Layout
     void updateLayout(const UIRect& parentRect) {
+        UIRect previous = worldRect_;
         calculateWorldRect(parentRect);
+        if (worldRect_ != previous) markDirty();
         
         for (auto& child : children_) {
             child->updateLayout(worldRect_);
@@ -330,14 +347,33 @@ public:
     bool isPressed() const { return pressed_; }
     bool isFocused() const { return focused_; }
     
-    void setHovered(bool h) { hovered_ = h; }
-    void setPressed(bool p) { pressed_ = p; }
-    void setFocused(bool f) { focused_ = f; }
+    void setHovered(bool h) { if (hovered_ != h) { hovered_ = h; markDirty(); } }
+    void setPressed(bool p) { if (pressed_ != p) { pressed_ = p; markDirty(); } }
+    void setFocused(bool f) { if (focused_ != f) { focused_ = f; markDirty(); } }
     
     // Z-order
     int getZOrder() const { return zOrder_; }
     void setZOrder(int z) { zOrder_ = z; }
     
+    // Render invalidation. Anything that changes how the widget draws calls
+    // markDirty(); adding, removing or hiding widgets calls markStructureDirty().
+    // Versions are stamps from one global clock and propagate to every ancestor,
+    // so a renderer that remembers the clock at its last pass finds changed
+    // subtrees with a compare per widget.
+    void markDirty() {
+        dirty_ = true;
+        renderVersion_ = ++versionClock_;
+        for (UIWidget* w = this; w; w = w->parent_) w->subtreeVersion_ = renderVersion_;
+    }
+    void markStructureDirty() {
+        markDirty();
+        for (UIWidget* w = this; w; w = w->parent_) w->structureVersion_ = renderVersion_;
+    }
+    uint64_t getRenderVersion() const { return renderVersion_; }
+    uint64_t getSubtreeVersion() const { return subtreeVersion_; }
+    uint64_t getStructureVersion() const { return structureVersion_; }
+    static uint64_t getVersionClock() { return versionClock_; }
+    
 protected:
     virtual void handleEvent(UIEvent& event) {}
     
@@ -396,10 +432,9 @@ protected:
         worldRect_ = {x, y, w, h};
     }
     
-    void markDirty() { dirty_ = true; }
-    
     uint32_t id_;
     static inline uint32_t nextId_ = 0;
+    static inline uint64_t versionClock_ = 0;
     
     std::string name_;
     bool visible_ = true;
@@ -415,6 +450,9 @@ protected:
     int zOrder_ = 0;
     
     bool dirty_ = true;
+    uint64_t renderVersion_ = 0;
+    uint64_t subtreeVersion_ = 0;
+    uint64_t structureVersion_ = 0;
     bool hovered_ = false;
     bool pressed_ = false;
     bool focused_ = false;
@@ -378,6 +378,7 @@ public:
         canvas->setScreenSize(screenWidth_, screenHeight_);
         UICanvas* ptr = canvas.get();
         canvases_[name] = std::move(canvas);
+        canvasOrderDirty_ = true;
         return ptr;
     }
     
@@ -388,6 +389,7 @@ public:
     
     void removeCanvas(const std::string& name) {
         canvases_.erase(name);
+        canvasOrderDirty_ = true;
     }
     
     const std::map<std::string, std::unique_ptr<UICanvas>>& getCanvases() const {
@@ -403,20 +405,43 @@ public:
         }
     }
     
+    // Visible canvases in render order (bottom to top). Re-sorted only when a
+    // canvas is added or removed or changes its order or visibility.
+    const std::vector<UICanvas*>& getSortedCanvases() {
+        bool stale = canvasOrderDirty_ || canvasOrderKeys_.size() != canvases_.size();
+        if (!stale) {
+            size_t i = 0;
+            for (auto& [name, canvas] : canvases_) {
+                const CanvasOrderKey& key = canvasOrderKeys_[i++];
+                if (key.canvas != canvas.get() || key.renderOrder != canvas->getRenderOrder() ||
+                    key.visible != canvas->isVisible()) {
+                    stale = true;
+                    break;
+                }
+            }
+        }
+        if (stale) {
+            canvasOrderKeys_.clear();
+            sortedCanvases_.clear();
+            for (auto& [name, canvas] : canvases_) {
+                canvasOrderKeys_.push_back({canvas.get(), canvas->getRenderOrder(), canvas->isVisible()});
+                if (canvas->isVisible()) {
+                    sortedCanvases_.push_back(canvas.get());
+                }
+            }
+            std::stable_sort(sortedCanvases_.begin(), sortedCanvases_.end(),
+                [](UICanvas* a, UICanvas* b) { return a->getRenderOrder() < b->getRenderOrder(); });
+            canvasOrderDirty_ = false;
+        }
+        return sortedCanvases_;
+    }
+    
     // Handle event
     void handleEvent(UIEvent& event) {
         // Process canvases in reverse render order (top to bottom)
-        std::vector<UICanvas*> sortedCanvases;
-        for (auto& [name, canvas] : canvases_) {
-            if (canvas->isVisible()) {
-                sortedCanvases.push_back(canvas.get());
-            }
-        }
-        std::sort(sortedCanvases.begin(), sortedCanvases.end(),
-            [](UICanvas* a, UICanvas* b) { return a->getRenderOrder() > b->getRenderOrder(); });
-        
-        for (auto* canvas : sortedCanvases) {
-            canvas->handleEvent(event);
+        const auto& sortedCanvases = getSortedCanvases();
+        for (size_t i = sortedCanvases.size(); i-- > 0;) {
+            sortedCanvases[i]->handleEvent(event);
             if (event.consumed) break;
         }
     }
@@ -426,18 +451,7 @@ public:
         renderer->beginFrame(screenWidth_, screenHeight_);
         
         UIWidgetDrawer drawer(renderer);
-        
-        // Sort by render order
-        std::vector<UICanvas*> sortedCanvases;
-        for (auto& [name, canvas] : canvases_) {
-            if (canvas->isVisible()) {
-                sortedCanvases.push_back(canvas.get());
-            }
-        }
-        std::sort(sortedCanvases.begin(), sortedCanvases.end(),
-            [](UICanvas* a, UICanvas* b) { return a->getRenderOrder() < b->getRenderOrder(); });
-        
-        for (auto* canvas : sortedCanvases) {
+        for (auto* canvas : getSortedCanvases()) {
             drawer.draw(canvas->getRoot());
         }
         
@@ -457,7 +471,16 @@ public:
 private:
     UISystem() = default;
     
+    struct CanvasOrderKey {
+        UICanvas* canvas;
+        int renderOrder;
+        bool visible;
+    };
+    
     std::map<std::string, std::unique_ptr<UICanvas>> canvases_;
+    std::vector<UICanvas*> sortedCanvases_;
+    std::vector<CanvasOrderKey> canvasOrderKeys_;
+    bool canvasOrderDirty_ = true;
     float screenWidth_ = 1920.0f;
     float screenHeight_ = 1080.0f;
 };
@@ -17,18 +17,18 @@ public:
     UIWidgetType getType() const override { return UIWidgetType::Panel; }
     
     // Background
-    void setBackgroundColor(const UIColor& color) { backgroundColor_ = color; }
+    void setBackgroundColor(const UIColor& color) { backgroundColor_ = color; markDirty(); }
     const UIColor& getBackgroundColor() const { return backgroundColor_; }
     
     // Border
-    void setBorderColor(const UIColor& color) { borderColor_ = color; }
+    void setBorderColor(const UIColor& color) { borderColor_ = color; markDirty(); }
     const UIColor& getBorderColor() const { return borderColor_; }
     
-    void setBorderWidth(float width) { borderWidth_ = width; }
+    void setBorderWidth(float width) { borderWidth_ = width; markDirty(); }
     float getBorderWidth() const { return borderWidth_; }
     
     // Corner radius
-    void setCornerRadius(float radius) { cornerRadius_ = radius; }
+    void setCornerRadius(float radius) { cornerRadius_ = radius; markDirty(); }
     float getCornerRadius() const { return cornerRadius_; }
     
 private:
@@ -49,14 +49,16 @@ public:
     UIWidgetType getType() const override { return UIWidgetType::Label; }
     
     // Text
-    void setText(const std::string& text) { text_ = text; }
+    void setText(const std::string& text) {
+        if (text != text_) { text_ = text; markDirty(); }
+    }
     const std::string& getText() const { return text_; }
     
     // Font
-    void setFontSize(float size) { fontSize_ = size; }
+    void setFontSize(float size) { fontSize_ = size; markDirty(); }
     float getFontSize() const { return fontSize_; }
     
-    void setFontName(const std::string& name) { fontName_ = name; }
+    void setFontName(const std::string& name) { fontName_ = name; markDirty(); }
     const std::string& getFontName() const { return fontName_; }
     
     // Text color (uses base color)
@@ -67,22 +69,22 @@ public:
     enum class HAlign { Left, Center, Right };
     enum class VAlign { Top, Middle, Bottom };
     
-    void setHAlign(HAlign align) { hAlign_ = align; }
+    void setHAlign(HAlign align) { hAlign_ = align; markDirty(); }
     HAlign getHAlign() const { return hAlign_; }
     
-    void setVAlign(VAlign align) { vAlign_ = align; }
+    void setVAlign(VAlign align) { vAlign_ = align; markDirty(); }
     VAlign getVAlign() const { return vAlign_; }
     
     // Word wrap
-    void setWordWrap(bool wrap) { wordWrap_ = wrap; }
+    void setWordWrap(bool wrap) { wordWrap_ = wrap; markDirty(); }
     bool getWordWrap() const { return wordWrap_; }
     
     // Shadow
-    void setShadow(bool enabled) { shadowEnabled_ = enabled; }
+    void setShadow(bool enabled) { shadowEnabled_ = enabled; markDirty(); }
     bool hasShadow() const { return shadowEnabled_; }
     
-    void setShadowColor(const UIColor& color) { shadowColor_ = color; }
-    void setShadowOffset(float x, float y) { shadowOffsetX_ = x; shadowOffsetY_ = y; }
+    void setShadowColor(const UIColor& color) { shadowColor_ = color; markDirty(); }
+    void setShadowOffset(float x, float y) { shadowOffsetX_ = x; shadowOffsetY_ = y; markDirty(); }
     
 private:
     std::string text_;
@@ -106,15 +108,16 @@ public:
     UIWidgetType getType() const override { return UIWidgetType::Image; }
     
     // Texture
-    void setTexture(const std::string& path) { texturePath_ = path; }
+    void setTexture(const std::string& path) { texturePath_ = path; markDirty(); }
     const std::string& getTexture() const { return texturePath_; }
     
-    void setTextureHandle(uint64_t handle) { textureHandle_ = handle; }
+    void setTextureHandle(uint64_t handle) { textureHandle_ = handle; markDirty(); }
     uint64_t getTextureHandle() const { return textureHandle_; }
     
     // UV rect (for sprites/atlases)
     void setUVRect(float u, float v, float w, float h) {
         uvRect_ = {u, v, w, h};
+        markDirty();
     }
     const UIRect& getUVRect() const { return uvRect_; }
     
@@ -126,13 +129,13 @@ public:
         Filled     // Progress fill
     };
     
-    void setImageType(Type type) { imageType_ = type; }
+    void setImageType(Type type) { imageType_ = type; markDirty(); }
     Type getImageType() const { return imageType_; }
     
     // Fill (for Filled type)
     enum class FillMethod { Horizontal, Vertical, Radial90, Radial180, Radial360 };
-    void setFillMethod(FillMethod method) { fillMethod_ = method; }
-    void setFillAmount(float amount) { fillAmount_ = std::max(0.0f, std::min(1.0f, amount)); }
+    void setFillMethod(FillMethod method) { fillMethod_ = method; markDirty(); }
+    void setFillAmount(float amount) { fillAmount_ = std::max(0.0f, std::min(1.0f, amount)); markDirty(); }
     float getFillAmount() const { return fillAmount_; }
     
     // Preserve aspect ratio
@@ -178,10 +181,10 @@ public:
     UILabel* getLabel() { return label_.get(); }
     
     // Colors
-    void setNormalColor(const UIColor& c) { normalColor_ = c; }
-    void setHoverColor(const UIColor& c) { hoverColor_ = c; }
-    void setPressedColor(const UIColor& c) { pressedColor_ = c; }
-    void setDisabledColor(const UIColor& c) { disabledColor_ = c; }
+    void setNormalColor(const UIColor& c) { normalColor_ = c; markDirty(); }
+    void setHoverColor(const UIColor& c) { hoverColor_ = c; markDirty(); }
+    void setPressedColor(const UIColor& c) { pressedColor_ = c; markDirty(); }
+    void setDisabledColor(const UIColor& c) { disabledColor_ = c; markDirty(); }
     
     const UIColor& getNormalColor() const { return normalColor_; }
     const UIColor& getHoverColor() const { return hoverColor_; }
@@ -189,11 +192,11 @@ public:
     const UIColor& getDisabledColor() const { return disabledColor_; }
     
     // Border
-    void setBorderRadius(float radius) { borderRadius_ = radius; }
+    void setBorderRadius(float radius) { borderRadius_ = radius; markDirty(); }
     float getBorderRadius() const { return borderRadius_; }
     
     // Icon
-    void setIcon(const std::string& texturePath) { iconPath_ = texturePath; }
+    void setIcon(const std::string& texturePath) { iconPath_ = texturePath; markDirty(); }
     const std::string& getIcon() const { return iconPath_; }
     
     // Get current color based on state
@@ -240,6 +243,7 @@ public:
     void setChecked(bool checked) {
         if (checked_ != checked) {
             checked_ = checked;
+            markDirty();
             if (onValueChanged_) onValueChanged_(checked_ ? 1.0f : 0.0f);
         }
     }
@@ -250,7 +254,7 @@ public:
     void setText(const std::string& text) { label_->setText(text); }
     
     // Box size
-    void setBoxSize(float size) { boxSize_ = size; }
+    void setBoxSize(float size) { boxSize_ = size; markDirty(); }
     float getBoxSize() const { return boxSize_; }
     
 protected:
@@ -279,6 +283,7 @@ public:
         float newValue = std::max(minValue_, std::min(maxValue_, value));
         if (newValue != value_) {
             value_ = newValue;
+            markDirty();
             if (onValueChanged_) onValueChanged_(value_);
         }
     }
@@ -286,7 +291,7 @@ public:
     // Range
     float getMinValue() const { return minValue_; }
     float getMaxValue() const { return maxValue_; }
-    void setRange(float min, float max) { minValue_ = min; maxValue_ = max; setValue(value_); }
+    void setRange(float min, float max) { minValue_ = min; maxValue_ = max; setValue(value_); markDirty(); }
     
     // Step
     void setStep(float step) { step_ = step; }
@@ -303,20 +308,20 @@ public:
     
     // Direction
     enum class Direction { Horizontal, Vertical };
-    void setDirection(Direction dir) { direction_ = dir; }
+    void setDirection(Direction dir) { direction_ = dir; markDirty(); }
     Direction getDirection() const { return direction_; }
     
     // Colors
-    void setTrackColor(const UIColor& c) { trackColor_ = c; }
-    void setFillColor(const UIColor& c) { fillColor_ = c; }
-    void setHandleColor(const UIColor& c) { handleColor_ = c; }
+    void setTrackColor(const UIColor& c) { trackColor_ = c; markDirty(); }
+    void setFillColor(const UIColor& c) { fillColor_ = c; markDirty(); }
+    void setHandleColor(const UIColor& c) { handleColor_ = c; markDirty(); }
     
     // Handle size
-    void setHandleSize(float size) { handleSize_ = size; }
+    void setHandleSize(float size) { handleSize_ = size; markDirty(); }
     float getHandleSize() const { return handleSize_; }
     
     // Show value
-    void setShowValue(bool show) { showValue_ = show; }
+    void setShowValue(bool show) { showValue_ = show; markDirty(); }
     bool getShowValue() const { return showValue_; }
     
 protected:
@@ -378,18 +383,18 @@ public:
     void setValue(float value) { value_ = std::max(0.0f, std::min(1.0f, value)); }
     
     // Colors
-    void setBackgroundColor(const UIColor& c) { backgroundColor_ = c; }
-    void setFillColor(const UIColor& c) { fillColor_ = c; }
+    void setBackgroundColor(const UIColor& c) { backgroundColor_ = c; markDirty(); }
+    void setFillColor(const UIColor& c) { fillColor_ = c; markDirty(); }
     
     const UIColor& getBackgroundColor() const { return backgroundColor_; }
     const UIColor& getFillColor() const { return fillColor_; }
     
     // Direction
     enum class Direction { LeftToRight, RightToLeft, BottomToTop, TopToBottom };
-    void setDirection(Direction dir) { direction_ = dir; }
+    void setDirection(Direction dir) { direction_ = dir; markDirty(); }
     
     // Show percentage text
-    void setShowText(bool show) { showText_ = show; }
+    void setShowText(bool show) { showText_ = show; markDirty(); }
     bool getShowText() const { return showText_; }
     
     // Animated fill
@@ -397,12 +402,14 @@ public:
     void setAnimationSpeed(float speed) { animationSpeed_ = speed; }
     
     void update(float dt) override {
+        float previous = displayValue_;
         if (animated_) {
             float target = value_;
             displayValue_ += (target - displayValue_) * animationSpeed_ * dt;
         } else {
             displayValue_ = value_;
         }
+        if (displayValue_ != previous) markDirty();
         UIWidget::update(dt);
     }
     
@@ -433,11 +440,12 @@ public:
     void setText(const std::string& text) {
         text_ = text;
         cursorPosition_ = text_.length();
+        markDirty();
         if (onTextChanged_) onTextChanged_(text_);
     }
     
     // Placeholder
-    void setPlaceholder(const std::string& placeholder) { placeholder_ = placeholder; }
+    void setPlaceholder(const std::string& placeholder) { placeholder_ = placeholder; markDirty(); }
     const std::string& getPlaceholder() const { return placeholder_; }
     
     // Character limit
@@ -446,11 +454,11 @@ public:
     
     // Input type
     enum class InputType { Standard, Password, Number, Email };
-    void setInputType(InputType type) { inputType_ = type; }
+    void setInputType(InputType type) { inputType_ = type; markDirty(); }
     InputType getInputType() const { return inputType_; }
     
     // Password char
-    void setPasswordChar(char c) { passwordChar_ = c; }
+    void setPasswordChar(char c) { passwordChar_ = c; markDirty(); }
     
     // Read only
     void setReadOnly(bool readOnly) { readOnly_ = readOnly; }
@@ -484,6 +492,7 @@ protected:
                 if (valid) {
                     text_.insert(cursorPosition_, 1, event.character);
                     cursorPosition_++;
+                    markDirty();
                     if (onTextChanged_) onTextChanged_(text_);
                 }
             }
@@ -493,12 +502,14 @@ protected:
                 if (cursorPosition_ > 0) {
                     text_.erase(cursorPosition_ - 1, 1);
                     cursorPosition_--;
+                    markDirty();
                     if (onTextChanged_) onTextChanged_(text_);
                 }
             }
             else if (event.keyCode == 127) {  // Delete
                 if (cursorPosition_ < (int)text_.length()) {
                     text_.erase(cursorPosition_, 1);
+                    markDirty();
                     if (onTextChanged_) onTextChanged_(text_);
                 }
             }
@@ -529,8 +540,8 @@ public:
     UIWidgetType getType() const override { return UIWidgetType::Dropdown; }
     
     // Options
-    void addOption(const std::string& option) { options_.push_back(option); }
-    void clearOptions() { options_.clear(); selectedIndex_ = -1; }
+    void addOption(const std::string& option) { options_.push_back(option); markDirty(); }
+    void clearOptions() { options_.clear(); selectedIndex_ = -1; markDirty(); }
     
     const std::vector<std::string>& getOptions() const { return options_; }
     
@@ -539,6 +550,7 @@ public:
     void setSelectedIndex(int index) {
         if (index >= -1 && index < (int)options_.size()) {
             selectedIndex_ = index;
+            markDirty();
             if (onValueChanged_) onValueChanged_((float)index);
         }
     }
@@ -550,8 +562,8 @@ public:
     
     // Expanded state
     bool isExpanded() const { return expanded_; }
-    void setExpanded(bool expanded) { expanded_ = expanded; }
-    void toggleExpanded() { expanded_ = !expanded_; }
+    void setExpanded(bool expanded) { expanded_ = expanded; markDirty(); }
+    void toggleExpanded() { expanded_ = !expanded_; markDirty(); }
     
 protected:
     void handleEvent(UIEvent& event) override {
@@ -3,6 +3,7 @@
 #pragma once
 
 #include "engine/foundation/math_types.h"
+#include "engine/network/udp_transport.h"
 #include <vector>
 #include <memory>
 #include <string>
@@ -10,15 +11,34 @@
 #include <functional>
 #include <queue>
 #include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstring>
 
 namespace luma {
 
 // ===== Network Constants =====
-constexpr uint32_t NETWORK_PROTOCOL_VERSION = 1;
+constexpr uint32_t NETWORK_PROTOCOL_VERSION = 2;
 constexpr uint32_t NETWORK_MAX_PACKET_SIZE = 1400;  // MTU-safe
 constexpr uint32_t NETWORK_MAX_CONNECTIONS = 64;
+constexpr uint32_t NETWORK_PROTOCOL_ID = 0x4C554D41u ^ NETWORK_PROTOCOL_VERSION;  // "LUMA"
+constexpr double NETWORK_CONNECTION_TIMEOUT = 10.0;  // seconds without packets
+constexpr double NETWORK_CONNECT_RETRY = 0.1;
+constexpr double NETWORK_CONNECT_TIMEOUT = 5.0;
+
+// ===== Packet Type =====
+// Every datagram: u32 protocol id, u8 packet type, body.
+// Connect / Accept carry the client's u32 salt; Data carries a
+// ReliableConnection packet.
+enum class NetworkPacketType : uint8_t {
+    Connect = 1,
+    Accept = 2,
+    Deny = 3,
+    Data = 4,
+    Disconnect = 5
+};
 
 // ===== Connection ID =====
 using ConnectionId = uint32_t;
@@ -46,6 +66,7 @@ enum class NetworkMessageType : uint8_t {
     StateUpdate = 10,
     StateFull = 11,
     StateRequest = 12,
+    SnapshotAck = 13,
     
     // RPC
     RPC = 20,
@@ -64,138 +85,516 @@ enum class NetworkMessageType : uint8_t {
     Custom = 100
 };
 
+// ===== Message Buffer Pool =====
+// Recycles message byte buffers so steady-state traffic does not allocate.
+// Buffers keep their capacity; oversized ones are dropped instead of pooled.
+class NetworkBufferPool {
+public:
+    static constexpr size_t kMaxPooled = 256;
+    static constexpr size_t kMaxPooledCapacity = 64 * 1024;
+    
+    std::vector<uint8_t> acquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.empty()) return {};
+        std::vector<uint8_t> buffer = std::move(free_.back());
+        free_.pop_back();
+        return buffer;
+    }
+    
+    void release(std::vector<uint8_t>&& buffer) {
+        if (buffer.capacity() == 0 || buffer.capacity() > kMaxPooledCapacity) return;
+        buffer.clear();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.size() < kMaxPooled) free_.push_back(std::move(buffer));
+    }
+    
+    size_t pooledCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return free_.size();
+    }
+    
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::vector<uint8_t>> free_;
+};
+
+inline NetworkBufferPool& getNetworkBufferPool() {
+    static NetworkBufferPool pool;
+    return pool;
+}
+
+// ===== String Table =====
+// Strings both peers register in the same order (RPC names, property
+// names) are sent as a varint index instead of their characters.
+// Compare checksum() across peers to detect mismatched registrations.
+class NetworkStringTable {
+public:
+    static constexpr uint32_t kNotFound = 0xFFFFFFFFu;
+    
+    uint32_t add(const std::string& str) {
+        auto it = indices_.find(str);
+        if (it != indices_.end()) return it->second;
+        uint32_t index = (uint32_t)strings_.size();
+        strings_.push_back(str);
+        indices_[str] = index;
+        // FNV-1a over the strings in registration order
+        for (char c : str) checksum_ = (checksum_ ^ (uint8_t)c) * 16777619u;
+        checksum_ = (checksum_ ^ 0xFFu) * 16777619u;
+        return index;
+    }
+    
+    uint32_t find(const std::string& str) const {
+        auto it = indices_.find(str);
+        return it != indices_.end() ? it->second : kNotFound;
+    }
+    
+    const std::string* get(uint32_t index) const {
+        return index < strings_.size() ? &strings_[index] : nullptr;
+    }
+    
+    size_t size() const { return strings_.size(); }
+    uint32_t checksum() const { return checksum_; }
+    void clear() { strings_.clear(); indices_.clear(); checksum_ = 2166136261u; }
+    
+private:
+    std::vector<std::string> strings_;
+    std::unordered_map<std::string, uint32_t> indices_;
+    uint32_t checksum_ = 2166136261u;
+};
+
 // ===== Network Message =====
+// Little-endian bit stream. Fixed-width values are written LSB first, so a
+// message made only of byte-sized writes has the plain byte layout. The
+// current 32-bit word is kept in a register and stored (never reloaded)
+// with one unaligned 64-bit write per value (little-endian hosts); the
+// buffer keeps slack past getSize() for those accesses.
+// Strings and byte arrays are byte-aligned (at most 7 bits of padding) and
+// copied with memcpy. Reading past the end returns zeros and sets
+// hasReadError(). The buffer comes from getNetworkBufferPool() and goes
+// back to it on destruction.
 class NetworkMessage {
 public:
     NetworkMessage() = default;
     explicit NetworkMessage(NetworkMessageType type) : type_(type) {}
+    ~NetworkMessage() { getNetworkBufferPool().release(std::move(data_)); }
+    
+    NetworkMessage(const NetworkMessage& other) : type_(other.type_) {
+        assign(other.data_.data(), other.getSize());
+        bitPos_ = other.bitPos_;
+        scratch_ = other.scratch_;
+        readBit_ = other.readBit_;
+        readError_ = other.readError_;
+    }
+    NetworkMessage(NetworkMessage&& other) noexcept
+        : type_(other.type_), data_(std::move(other.data_)), bitPos_(other.bitPos_), scratch_(other.scratch_),
+          readBit_(other.readBit_), readError_(other.readError_) {
+        other.clear();
+    }
+    NetworkMessage& operator=(const NetworkMessage& other) {
+        if (this != &other) {
+            type_ = other.type_;
+            assign(other.data_.data(), other.getSize());
+            bitPos_ = other.bitPos_;
+            scratch_ = other.scratch_;
+            readBit_ = other.readBit_;
+            readError_ = other.readError_;
+        }
+        return *this;
+    }
+    NetworkMessage& operator=(NetworkMessage&& other) noexcept {
+        if (this != &other) {
+            getNetworkBufferPool().release(std::move(data_));
+            type_ = other.type_;
+            data_ = std::move(other.data_);
+            bitPos_ = other.bitPos_;
+            scratch_ = other.scratch_;
+            readBit_ = other.readBit_;
+            readError_ = other.readError_;
+            other.clear();
+        }
+        return *this;
+    }
     
     NetworkMessageType getType() const { return type_; }
     void setType(NetworkMessageType type) { type_ = type; }
     
-    // Write methods
-    void writeByte(uint8_t value) { data_.push_back(value); }
-    void writeUInt16(uint16_t value) {
-        data_.push_back(value & 0xFF);
-        data_.push_back((value >> 8) & 0xFF);
-    }
-    void writeUInt32(uint32_t value) {
-        for (int i = 0; i < 4; i++) {
-            data_.push_back((value >> (i * 8)) & 0xFF);
-        }
+    // Bit writes (1..32 bits)
+    void writeBits(uint32_t value, int bits) {
+        BitCursor cursor = beginWrite(bits);
+        cursor.put(value, bits);
+        endWrite(cursor);
     }
+    void writeBool(bool value) { writeBits(value ? 1 : 0, 1); }
+    void writeByte(uint8_t value) { writeBits(value, 8); }
+    void writeUInt16(uint16_t value) { writeBits(value, 16); }
+    void writeUInt32(uint32_t value) { writeBits(value, 32); }
     void writeInt32(int32_t value) { writeUInt32((uint32_t)value); }
+    void writeUInt64(uint64_t value) {
+        writeBits((uint32_t)value, 32);
+        writeBits((uint32_t)(value >> 32), 32);
+    }
     void writeFloat(float value) {
         uint32_t bits;
         memcpy(&bits, &value, 4);
         writeUInt32(bits);
     }
-    void writeString(const std::string& str) {
-        writeUInt16((uint16_t)str.size());
-        for (char c : str) {
-            writeByte((uint8_t)c);
+    void writeDouble(double value) {
+        uint64_t bits;
+        memcpy(&bits, &value, 8);
+        writeUInt64(bits);
+    }
+    // 7 bits per group + continuation bit; small values take one byte
+    void writeVarUInt(uint64_t value) {
+        while (value >= 0x80) {
+            writeBits((uint32_t)(value & 0x7F) | 0x80, 8);
+            value >>= 7;
+        }
+        writeBits((uint32_t)value, 8);
+    }
+    // Zigzag, so small negative values stay short
+    void writeVarInt(int64_t value) { writeVarUInt(((uint64_t)value << 1) ^ (uint64_t)(value >> 63)); }
+    
+    // Quantized: value clamped to [min, max], bits (1..32) of precision
+    void writeQuantizedFloat(float value, float min, float max, int bits) {
+        writeBits(quantize(value, min, 1.0f / (max - min), bits), bits);
+    }
+    void writeQuantizedVec3(const Vec3& v, const Vec3& min, const Vec3& max, int bits) {
+        BitCursor cursor = beginWrite(3 * bits);
+        cursor.put(quantize(v.x, min.x, 1.0f / (max.x - min.x), bits), bits);
+        cursor.put(quantize(v.y, min.y, 1.0f / (max.y - min.y), bits), bits);
+        cursor.put(quantize(v.z, min.z, 1.0f / (max.z - min.z), bits), bits);
+        endWrite(cursor);
+    }
+    // Smallest three: index of the largest component (2 bits) plus the
+    // other three in [-1/sqrt2, 1/sqrt2]; the largest is rebuilt from unit
+    // length. 10 bits per component packs a rotation into 32 bits.
+    void writeQuat(const Quat& q, int bitsPerComponent = 10) {
+        float c[4] = {q.x, q.y, q.z, q.w};
+        float lengthSq = c[0] * c[0] + c[1] * c[1] + c[2] * c[2] + c[3] * c[3];
+        float invLength = lengthSq > 0.0f ? 1.0f / std::sqrt(lengthSq) : 1.0f;
+        // First largest |component|, picked without branches (random
+        // rotations mispredict a compare loop)
+        float a0 = std::abs(c[0]), a1 = std::abs(c[1]), a2 = std::abs(c[2]), a3 = std::abs(c[3]);
+        int low = a1 > a0 ? 1 : 0, high = a3 > a2 ? 3 : 2;
+        int largest = std::max(a2, a3) > std::max(a0, a1) ? high : low;
+        // q and -q are the same rotation; make the dropped component positive
+        float sign = c[largest] < 0.0f ? -invLength : invLength;
+        static constexpr int kOthers[4][3] = {{1, 2, 3}, {0, 2, 3}, {0, 1, 3}, {0, 1, 2}};
+        const float invRange = 0.5f / kQuatRange;
+        uint32_t a = quantize(c[kOthers[largest][0]] * sign, -kQuatRange, invRange, bitsPerComponent);
+        uint32_t b = quantize(c[kOthers[largest][1]] * sign, -kQuatRange, invRange, bitsPerComponent);
+        uint32_t d = quantize(c[kOthers[largest][2]] * sign, -kQuatRange, invRange, bitsPerComponent);
+        BitCursor cursor = beginWrite(2 + 3 * bitsPerComponent);
+        if (2 + 3 * bitsPerComponent <= 32) {
+            // Same layout as the separate writes, in one store
+            cursor.put((uint32_t)largest | a << 2 | b << (2 + bitsPerComponent) | d << (2 + 2 * bitsPerComponent),
+                       2 + 3 * bitsPerComponent);
+        } else {
+            cursor.put((uint32_t)largest, 2);
+            cursor.put(a, bitsPerComponent);
+            cursor.put(b, bitsPerComponent);
+            cursor.put(d, bitsPerComponent);
         }
+        endWrite(cursor);
     }
     void writeVec3(const Vec3& v) {
         writeFloat(v.x);
         writeFloat(v.y);
         writeFloat(v.z);
     }
+    
+    // Byte-aligned bulk writes
+    void writeString(const std::string& str) {
+        writeVarUInt(str.size());
+        writeRaw(str.data(), str.size());
+    }
+    // Table strings are a flag bit plus an index, or the string inline
+    void writeString(const std::string& str, const NetworkStringTable& table) {
+        uint32_t index = table.find(str);
+        writeBool(index != NetworkStringTable::kNotFound);
+        if (index != NetworkStringTable::kNotFound) {
+            writeVarUInt(index);
+        } else {
+            writeString(str);
+        }
+    }
     void writeBytes(const uint8_t* data, size_t size) {
-        writeUInt32((uint32_t)size);
-        data_.insert(data_.end(), data, data + size);
+        writeVarUInt(size);
+        writeRaw(data, size);
     }
-    
-    // Read methods
-    uint8_t readByte() {
-        if (readPos_ >= data_.size()) return 0;
-        return data_[readPos_++];
+    void writeRaw(const void* data, size_t size) {
+        alignWrite();
+        if (size == 0) return;
+        size_t byte = bitPos_ >> 3;
+        if (byte + size + kSlack > data_.size()) grow(byte + size + kSlack);
+        memcpy(data_.data() + byte, data, size);
+        bitPos_ += size * 8;
+        loadScratch();
     }
-    uint16_t readUInt16() {
-        uint16_t value = readByte();
-        value |= (uint16_t)readByte() << 8;
-        return value;
+    void alignWrite() {
+        size_t aligned = (bitPos_ + 7) & ~(size_t)7;
+        if (aligned == bitPos_) return;
+        bitPos_ = aligned;
+        // Padding up to a word boundary starts a new word with no bits below
+        // the cursor; the scratch still holds the finished one
+        if ((bitPos_ & 31) == 0) scratch_ = 0;
     }
-    uint32_t readUInt32() {
-        uint32_t value = 0;
-        for (int i = 0; i < 4; i++) {
-            value |= (uint32_t)readByte() << (i * 8);
+    // Drops everything written after bits (e.g. an entry over a size cap)
+    void truncateBits(size_t bits) {
+        if (bits >= bitPos_) return;
+        bitPos_ = bits;
+        loadScratch();
+        memcpy(data_.data() + ((bitPos_ >> 5) << 2), &scratch_, 8);
+        readBit_ = std::min(readBit_, bitPos_);
+    }
+    
+    // Bit reads (1..32 bits)
+    uint32_t readBits(int bits) {
+        if (readBit_ + bits > bitPos_) {
+            readError_ = true;
+            readBit_ = bitPos_;
+            return 0;
         }
+        uint64_t word;
+        memcpy(&word, data_.data() + (readBit_ >> 3), 8);
+        uint32_t value = (uint32_t)(word >> (readBit_ & 7));
+        if (bits < 32) value &= (1u << bits) - 1;
+        readBit_ += bits;
         return value;
     }
+    bool readBool() { return readBits(1) != 0; }
+    uint8_t readByte() { return (uint8_t)readBits(8); }
+    uint16_t readUInt16() { return (uint16_t)readBits(16); }
+    uint32_t readUInt32() { return readBits(32); }
     int32_t readInt32() { return (int32_t)readUInt32(); }
+    uint64_t readUInt64() {
+        uint64_t lo = readBits(32);
+        return lo | ((uint64_t)readBits(32) << 32);
+    }
     float readFloat() {
         uint32_t bits = readUInt32();
         float value;
         memcpy(&value, &bits, 4);
         return value;
     }
+    double readDouble() {
+        uint64_t bits = readUInt64();
+        double value;
+        memcpy(&value, &bits, 8);
+        return value;
+    }
+    uint64_t readVarUInt() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint32_t group = readBits(8);
+            value |= (uint64_t)(group & 0x7F) << shift;
+            if (!(group & 0x80)) return value;
+        }
+        readError_ = true;
+        return value;
+    }
+    int64_t readVarInt() {
+        uint64_t zigzag = readVarUInt();
+        return (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+    }
+    float readQuantizedFloat(float min, float max, int bits) {
+        uint32_t steps = bits >= 32 ? 0xFFFFFFFFu : (1u << bits) - 1;
+        return min + (float)((double)readBits(bits) / steps) * (max - min);
+    }
+    Vec3 readQuantizedVec3(const Vec3& min, const Vec3& max, int bits) {
+        float x = readQuantizedFloat(min.x, max.x, bits);
+        float y = readQuantizedFloat(min.y, max.y, bits);
+        float z = readQuantizedFloat(min.z, max.z, bits);
+        return Vec3(x, y, z);
+    }
+    Quat readQuat(int bitsPerComponent = 10) {
+        int largest = (int)readBits(2);
+        float c[4];
+        float sumSq = 0.0f;
+        for (int i = 0; i < 4; i++) {
+            if (i == largest) continue;
+            c[i] = readQuantizedFloat(-kQuatRange, kQuatRange, bitsPerComponent);
+            sumSq += c[i] * c[i];
+        }
+        c[largest] = std::sqrt(std::max(0.0f, 1.0f - sumSq));
+        return Quat(c[0], c[1], c[2], c[3]);
+    }
+    Vec3 readVec3() {
+        float x = readFloat();
+        float y = readFloat();
+        float z = readFloat();
+        return Vec3(x, y, z);
+    }
+    
     std::string readString() {
-        uint16_t len = readUInt16();
         std::string str;
-        str.reserve(len);
-        for (uint16_t i = 0; i < len; i++) {
-            str += (char)readByte();
-        }
+        readString(str);
         return str;
     }
-    Vec3 readVec3() {
-        return Vec3(readFloat(), readFloat(), readFloat());
+    // Reuses out's capacity
+    void readString(std::string& out) {
+        size_t size = readLength();
+        out.resize(size);
+        readRaw(out.data(), size);
     }
-    std::vector<uint8_t> readBytes() {
-        uint32_t size = readUInt32();
-        std::vector<uint8_t> bytes(size);
-        for (uint32_t i = 0; i < size; i++) {
-            bytes[i] = readByte();
+    std::string readString(const NetworkStringTable& table) {
+        if (!readBool()) return readString();
+        const std::string* str = table.get((uint32_t)readVarUInt());
+        if (!str) {
+            readError_ = true;
+            return {};
         }
+        return *str;
+    }
+    std::vector<uint8_t> readBytes() {
+        std::vector<uint8_t> bytes;
+        readBytes(bytes);
         return bytes;
     }
+    void readBytes(std::vector<uint8_t>& out) {
+        size_t size = readLength();
+        out.resize(size);
+        readRaw(out.data(), size);
+    }
+    void readRaw(void* out, size_t size) {
+        alignRead();
+        if (size == 0) return;
+        size_t byte = readBit_ >> 3;
+        if (byte + size > getSize()) {
+            readError_ = true;
+            memset(out, 0, size);
+            readBit_ = bitPos_;
+            return;
+        }
+        memcpy(out, data_.data() + byte, size);
+        readBit_ += size * 8;
+    }
+    void alignRead() { readBit_ = std::min((readBit_ + 7) & ~(size_t)7, getSize() * 8); }
+    bool hasReadError() const { return readError_; }
     
-    // Data access
-    const std::vector<uint8_t>& getData() const { return data_; }
-    size_t getSize() const { return data_.size(); }
-    void clear() { data_.clear(); readPos_ = 0; }
-    void resetRead() { readPos_ = 0; }
+    // Data access (getSize() bytes)
+    const uint8_t* getData() const { return data_.data(); }
+    size_t getSize() const { return (bitPos_ + 7) >> 3; }
+    size_t getBitSize() const { return bitPos_; }
+    void clear() { bitPos_ = 0; scratch_ = 0; readBit_ = 0; readError_ = false; }
+    void resetRead() { readBit_ = 0; readError_ = false; }
+    // Replaces the contents with raw payload bytes (memcpy)
+    void assign(const uint8_t* data, size_t size) {
+        clear();
+        if (size == 0) return;
+        if (data_.size() < kSlack || size > data_.size() - kSlack) grow(size + kSlack);
+        memcpy(data_.data(), data, size);
+        bitPos_ = size * 8;
+        loadScratch();
+    }
     
     // Serialization
+    // Header: type (1) + varint payload size
+    void serializeTo(std::vector<uint8_t>& out) const {
+        size_t size = getSize();
+        out.push_back((uint8_t)type_);
+        while (size >= 0x80) {
+            out.push_back((uint8_t)(size & 0x7F) | 0x80);
+            size >>= 7;
+        }
+        out.push_back((uint8_t)size);
+        out.insert(out.end(), data_.data(), data_.data() + getSize());
+    }
     std::vector<uint8_t> serialize() const {
         std::vector<uint8_t> packet;
-        packet.reserve(5 + data_.size());
-        
-        // Header: type (1) + size (4)
-        packet.push_back((uint8_t)type_);
-        uint32_t size = (uint32_t)data_.size();
-        for (int i = 0; i < 4; i++) {
-            packet.push_back((size >> (i * 8)) & 0xFF);
-        }
-        
-        // Data
-        packet.insert(packet.end(), data_.begin(), data_.end());
+        packet.reserve(6 + getSize());
+        serializeTo(packet);
         return packet;
     }
     
     static NetworkMessage deserialize(const uint8_t* data, size_t size) {
-        if (size < 5) return NetworkMessage();
-        
         NetworkMessage msg;
-        msg.type_ = (NetworkMessageType)data[0];
-        
-        uint32_t dataSize = 0;
-        for (int i = 0; i < 4; i++) {
-            dataSize |= (uint32_t)data[1 + i] << (i * 8);
-        }
-        
-        if (size >= 5 + dataSize) {
-            msg.data_.assign(data + 5, data + 5 + dataSize);
-        }
-        
+        msg.deserializeFrom(data, size);
         return msg;
     }
+    // Reuses this message's buffer; false if the header is malformed
+    bool deserializeFrom(const uint8_t* data, size_t size) {
+        clear();
+        if (size < 2) return false;
+        type_ = (NetworkMessageType)data[0];
+        size_t payload = 0;
+        size_t pos = 1;
+        for (int shift = 0; pos < size && shift < 35; shift += 7) {
+            uint8_t group = data[pos++];
+            payload |= (size_t)(group & 0x7F) << shift;
+            if (!(group & 0x80)) {
+                if (payload > size - pos) return false;
+                assign(data + pos, payload);
+                return true;
+            }
+        }
+        return false;
+    }
     
 private:
+    static constexpr float kQuatRange = 0.70710678f;
+    static constexpr size_t kSlack = 16;  // room for 64-bit accesses past the end
+    
+    // Write state copied into locals, so the stores through data (which
+    // may alias any member) do not force bitPos_/scratch_ back to memory
+    // between the values of a group
+    struct BitCursor {
+        uint8_t* data;
+        size_t bitPos;
+        uint64_t scratch;
+        void put(uint32_t value, int bits) {
+            if (bits < 32) value &= (1u << bits) - 1;
+            uint32_t shift = bitPos & 31;
+            scratch |= (uint64_t)value << shift;
+            memcpy(data + ((bitPos >> 5) << 2), &scratch, 8);
+            bitPos += bits;
+            if (shift + bits >= 32) scratch >>= 32;
+        }
+    };
+    // Room for up to maxBits more bits
+    BitCursor beginWrite(size_t maxBits) {
+        size_t byte = ((bitPos_ + maxBits) >> 5) << 2;
+        if (byte + kSlack > data_.size()) grow(byte + kSlack);
+        return {data_.data(), bitPos_, scratch_};
+    }
+    void endWrite(const BitCursor& cursor) {
+        bitPos_ = cursor.bitPos;
+        scratch_ = cursor.scratch;
+    }
+    static uint32_t quantize(float value, float min, float invRange, int bits) {
+        uint32_t steps = bits >= 32 ? 0xFFFFFFFFu : (1u << bits) - 1;
+        float t = (value - min) * invRange;
+        t = std::min(std::max(0.0f, t), 1.0f);  // NaN -> min
+        return (uint32_t)((double)t * steps + 0.5);
+    }
+    // Bits of the current word below the cursor
+    void loadScratch() {
+        uint32_t word;
+        memcpy(&word, data_.data() + ((bitPos_ >> 5) << 2), 4);
+        uint32_t bits = bitPos_ & 31;
+        scratch_ = bits ? word & ((1u << bits) - 1) : 0;
+    }
+    void grow(size_t bytes) {
+        if (data_.capacity() == 0) data_ = getNetworkBufferPool().acquire();
+        data_.resize(std::max({bytes, data_.size() * 2, (size_t)64}));
+    }
+    size_t readLength() {
+        uint64_t size = readVarUInt();
+        size_t remaining = getSize() - std::min(getSize(), (readBit_ + 7) >> 3);
+        if (size > remaining) {
+            readError_ = true;
+            readBit_ = bitPos_;
+            return 0;
+        }
+        return (size_t)size;
+    }
+    
     NetworkMessageType type_ = NetworkMessageType::Custom;
-    std::vector<uint8_t> data_;
-    size_t readPos_ = 0;
+    std::vector<uint8_t> data_;   // getSize() bytes + slack
+    size_t bitPos_ = 0;
+    uint64_t scratch_ = 0;        // word at (bitPos_ / 32) * 4, bits below bitPos_
+    size_t readBit_ = 0;
+    bool readError_ = false;
 };
 
 // ===== Connection State =====
@@ -249,8 +648,10 @@ public:
     virtual void stop() = 0;
     virtual void update(double dt) = 0;
     
-    virtual void send(ConnectionId target, const NetworkMessage& msg) = 0;
-    virtual void broadcast(const NetworkMessage& msg) = 0;
+    virtual void send(ConnectionId target, const NetworkMessage& msg,
+                      NetworkChannel channel = NetworkChannel::ReliableOrdered) = 0;
+    virtual void broadcast(const NetworkMessage& msg,
+                           NetworkChannel channel = NetworkChannel::ReliableOrdered) = 0;
     
     virtual NetworkRole getRole() const = 0;
     virtual bool isRunning() const = 0;
@@ -265,6 +666,20 @@ public:
         return it != connections_.end() ? &it->second : nullptr;
     }
     
+    // Transport
+    uint16_t getLocalPort() const { return transport_.getLocalAddress().port; }
+    const std::string& getLastError() const { return lastError_; }
+    // Simulated loss / latency / jitter on everything this peer sends
+    void setNetworkConditions(const NetworkConditions& conditions, uint32_t seed = 1) {
+        transport_.setConditions(conditions, seed);
+    }
+    // Sleeps until a packet arrives (or the timeout); for server loops
+    bool waitForPackets(double timeoutSeconds) { return transport_.wait(timeoutSeconds, time_); }
+    const ReliableConnectionStats* getTransportStats(ConnectionId id) const {
+        auto it = links_.find(id);
+        return it != links_.end() ? &it->second.connection->stats() : nullptr;
+    }
+    
     // Message handlers
     using MessageHandler = std::function<void(ConnectionId sender, NetworkMessage& msg)>;
     
@@ -290,8 +705,8 @@ public:
         if (it == rpcDefinitions_.end()) return;
         
         NetworkMessage msg(NetworkMessageType::RPC);
-        msg.writeUInt32(it->second.id);
-        msg.writeBytes(args.getData().data(), args.getData().size());
+        msg.writeVarUInt(it->second.id);
+        msg.writeBytes(args.getData(), args.getSize());
         
         if (target == BROADCAST_CONNECTION) {
             broadcast(msg);
@@ -306,16 +721,22 @@ public:
     void setOnDisconnect(ConnectionCallback cb) { onDisconnect_ = cb; }
     
 protected:
+    // Remote end of a connection on the wire
+    struct Link {
+        NetAddress address;
+        uint32_t salt = 0;
+        std::unique_ptr<ReliableConnection> connection;
+    };
+    
     void handleMessage(ConnectionId sender, NetworkMessage& msg) {
         // Handle RPC
         if (msg.getType() == NetworkMessageType::RPC) {
-            uint32_t rpcId = msg.readUInt32();
+            uint32_t rpcId = (uint32_t)msg.readVarUInt();
             auto it = rpcById_.find(rpcId);
             if (it != rpcById_.end() && it->second->handler) {
+                msg.readBytes(packetScratch_);
                 NetworkMessage args;
-                auto data = msg.readBytes();
-                for (uint8_t b : data) args.writeByte(b);
-                args.resetRead();
+                args.assign(packetScratch_.data(), packetScratch_.size());
                 it->second->handler(sender, args);
             }
             return;
@@ -323,11 +744,87 @@ protected:
         
         // Custom handlers
         auto it = messageHandlers_.find(msg.getType());
-        if (it != messageHandlers_.end()) {
+        if (it != messageHandlers_.end() && it->second) {
             it->second(sender, msg);
         }
     }
     
+    void sendPacket(const NetAddress& to, NetworkPacketType type, const uint8_t* body = nullptr, size_t size = 0) {
+        uint8_t header[5];
+        for (int i = 0; i < 4; i++) header[i] = (uint8_t)(NETWORK_PROTOCOL_ID >> (i * 8));
+        header[4] = (uint8_t)type;
+        transport_.send(to, header, sizeof(header), body, size, time_);
+    }
+    
+    void sendSaltPacket(const NetAddress& to, NetworkPacketType type, uint32_t salt) {
+        uint8_t body[4];
+        for (int i = 0; i < 4; i++) body[i] = (uint8_t)(salt >> (i * 8));
+        sendPacket(to, type, body, sizeof(body));
+    }
+    
+    // Splits a datagram into packet type and body; false if it is not ours
+    static bool parsePacket(const uint8_t* data, size_t size, NetworkPacketType& type,
+                            const uint8_t*& body, size_t& bodySize) {
+        if (size < 5) return false;
+        uint32_t protocol = 0;
+        for (int i = 0; i < 4; i++) protocol |= (uint32_t)data[i] << (i * 8);
+        if (protocol != NETWORK_PROTOCOL_ID) return false;
+        type = (NetworkPacketType)data[4];
+        body = data + 5;
+        bodySize = size - 5;
+        return true;
+    }
+    
+    static uint32_t readSalt(const uint8_t* body, size_t size) {
+        if (size < 4) return 0;
+        return (uint32_t)body[0] | ((uint32_t)body[1] << 8) | ((uint32_t)body[2] << 16) | ((uint32_t)body[3] << 24);
+    }
+    
+    // Queues a message on a link's channel
+    void sendOnLink(ConnectionId id, const NetworkMessage& msg, NetworkChannel channel) {
+        auto it = links_.find(id);
+        if (it == links_.end()) return;
+        packetScratch_.clear();
+        msg.serializeTo(packetScratch_);
+        it->second.connection->send(channel, packetScratch_.data(), packetScratch_.size());
+    }
+    
+    // Writes every link's due packets, mirrors stats into connections_ and
+    // hands the datagrams to the socket
+    void flushLinks() {
+        for (auto& [id, link] : links_) {
+            const NetAddress address = link.address;
+            link.connection->writePackets(time_, [&](const uint8_t* data, size_t size) {
+                sendPacket(address, NetworkPacketType::Data, data, size);
+            });
+            if (auto* conn = getConnection(id)) {
+                const auto& stats = link.connection->stats();
+                conn->bytesSent = stats.bytesSent;
+                conn->bytesReceived = stats.bytesReceived;
+                conn->packetsSent = (uint32_t)stats.packetsSent;
+                conn->packetsReceived = (uint32_t)stats.packetsReceived;
+                conn->packetsLost = (uint32_t)stats.packetsLost;
+                conn->roundTripTime = stats.rtt;
+            }
+        }
+        transport_.flush(time_);
+    }
+    
+    // Pops delivered messages first so handlers may send or disconnect freely
+    void dispatchLinkMessages() {
+        std::vector<std::pair<ConnectionId, std::vector<uint8_t>>> delivered;
+        NetworkChannel channel;
+        std::vector<uint8_t> bytes;
+        for (auto& [id, link] : links_) {
+            while (link.connection->popMessage(channel, bytes)) delivered.emplace_back(id, std::move(bytes));
+        }
+        NetworkMessage msg;
+        for (auto& [id, data] : delivered) {
+            if (!links_.count(id) || !msg.deserializeFrom(data.data(), data.size())) continue;
+            handleMessage(id, msg);
+        }
+    }
+    
     std::unordered_map<ConnectionId, NetworkConnection> connections_;
     std::unordered_map<NetworkMessageType, MessageHandler> messageHandlers_;
     std::unordered_map<std::string, RPCDefinition> rpcDefinitions_;
@@ -336,72 +833,117 @@ protected:
     
     ConnectionCallback onConnect_;
     ConnectionCallback onDisconnect_;
+    
+    UdpTransport transport_;
+    std::unordered_map<ConnectionId, Link> links_;
+    std::vector<uint8_t> packetScratch_;
+    double time_ = 0.0;  // sum of update() dts
+    std::string lastError_;
 };
 
 // ===== Network Server =====
 class NetworkServer : public NetworkPeer {
 public:
+    ~NetworkServer() override { stop(); }
+    
+    // Port 0 binds an ephemeral port (see getLocalPort)
     bool start(const std::string& address, uint16_t port) override {
+        stop();
+        NetAddress bindAddress;
+        if (!NetAddress::resolve(address, port, bindAddress)) {
+            lastError_ = "Cannot resolve " + address;
+            return false;
+        }
+        if (!transport_.open(bindAddress)) {
+            lastError_ = transport_.getLastError();
+            return false;
+        }
         address_ = address;
-        port_ = port;
+        port_ = transport_.getLocalAddress().port;
         running_ = true;
         nextConnectionId_ = 2;  // 1 is reserved for server
-        
-        // In real implementation, would create socket and bind
+        lastError_.clear();
         return true;
     }
     
     void stop() override {
-        running_ = false;
-        for (auto& [id, conn] : connections_) {
-            NetworkMessage msg(NetworkMessageType::Disconnect);
-            send(id, msg);
+        if (running_) {
+            for (auto& [id, link] : links_) sendPacket(link.address, NetworkPacketType::Disconnect);
+            transport_.flush(time_);
         }
+        running_ = false;
         connections_.clear();
+        links_.clear();
+        linkByAddress_.clear();
+        transport_.close();
     }
     
     void update(double dt) override {
         if (!running_) return;
+        time_ += dt;
         
-        // Process incoming packets (simulated)
-        // In real implementation, would poll socket
+        transport_.receive([&](const NetAddress& from, const uint8_t* data, size_t size) {
+            NetworkPacketType type;
+            const uint8_t* body;
+            size_t bodySize;
+            if (!parsePacket(data, size, type, body, bodySize)) return;
+            auto known = linkByAddress_.find(from);
+            ConnectionId id = known != linkByAddress_.end() ? known->second : INVALID_CONNECTION;
+            
+            switch (type) {
+                case NetworkPacketType::Connect: {
+                    uint32_t salt = readSalt(body, bodySize);
+                    if (id != INVALID_CONNECTION && links_[id].salt != salt) {
+                        // The client restarted on the same port
+                        disconnectClient(id);
+                        id = INVALID_CONNECTION;
+                    }
+                    if (id == INVALID_CONNECTION) {
+                        if (connections_.size() >= NETWORK_MAX_CONNECTIONS) {
+                            sendSaltPacket(from, NetworkPacketType::Deny, salt);
+                            return;
+                        }
+                        id = acceptPeer(from, salt);
+                    }
+                    sendSaltPacket(from, NetworkPacketType::Accept, salt);
+                    break;
+                }
+                case NetworkPacketType::Data:
+                    if (id != INVALID_CONNECTION && links_[id].connection->receivePacket(body, bodySize, time_)) {
+                        connections_[id].lastHeartbeat = time_;
+                    }
+                    break;
+                case NetworkPacketType::Disconnect:
+                    if (id != INVALID_CONNECTION) dropConnection(id);
+                    break;
+                default:
+                    break;
+            }
+        });
         
-        // Send heartbeats
-        heartbeatTimer_ += dt;
-        if (heartbeatTimer_ >= 1.0) {
-            heartbeatTimer_ = 0.0;
-            NetworkMessage heartbeat(NetworkMessageType::Heartbeat);
-            broadcast(heartbeat);
-        }
+        dispatchLinkMessages();
         
         // Check for timeouts
-        double now = 0.0;  // Would use actual time
-        for (auto it = connections_.begin(); it != connections_.end(); ) {
-            if (now - it->second.lastHeartbeat > 10.0) {
-                if (onDisconnect_) onDisconnect_(it->first, it->second);
-                it = connections_.erase(it);
-            } else {
-                ++it;
-            }
+        std::vector<ConnectionId> timedOut;
+        for (const auto& [id, link] : links_) {
+            if (time_ - link.connection->getLastReceiveTime() > NETWORK_CONNECTION_TIMEOUT) timedOut.push_back(id);
         }
+        for (ConnectionId id : timedOut) dropConnection(id);
+        
+        flushLinks();
     }
     
-    void send(ConnectionId target, const NetworkMessage& msg) override {
-        auto it = connections_.find(target);
-        if (it == connections_.end()) return;
-        
-        auto packet = msg.serialize();
-        it->second.bytesSent += packet.size();
-        it->second.packetsSent++;
-        
-        // In real implementation, would send via socket
-        pendingOutgoing_.push({target, packet});
+    void send(ConnectionId target, const NetworkMessage& msg,
+              NetworkChannel channel = NetworkChannel::ReliableOrdered) override {
+        if (connections_.find(target) == connections_.end()) return;
+        sendOnLink(target, msg, channel);
     }
     
-    void broadcast(const NetworkMessage& msg) override {
-        for (auto& [id, conn] : connections_) {
-            send(id, msg);
-        }
+    void broadcast(const NetworkMessage& msg,
+                   NetworkChannel channel = NetworkChannel::ReliableOrdered) override {
+        packetScratch_.clear();
+        msg.serializeTo(packetScratch_);
+        for (auto& [id, link] : links_) link.connection->send(channel, packetScratch_.data(), packetScratch_.size());
     }
     
     NetworkRole getRole() const override { return NetworkRole::Server; }
@@ -416,7 +958,7 @@ public:
         conn.address = address;
         conn.port = port;
         conn.state = ConnectionState::Connected;
-        conn.lastHeartbeat = 0.0;
+        conn.lastHeartbeat = time_;
         
         connections_[id] = conn;
         
@@ -426,32 +968,66 @@ public:
     }
     
     void disconnectClient(ConnectionId id) {
+        auto link = links_.find(id);
+        if (link != links_.end()) sendPacket(link->second.address, NetworkPacketType::Disconnect);
+        dropConnection(id);
+    }
+    
+    size_t getClientCount() const { return connections_.size(); }
+    
+private:
+    ConnectionId acceptPeer(const NetAddress& from, uint32_t salt) {
+        // Link first so onConnect handlers can already send
+        ConnectionId id = nextConnectionId_;
+        Link link;
+        link.address = from;
+        link.salt = salt;
+        link.connection = std::make_unique<ReliableConnection>();
+        link.connection->setLastReceiveTime(time_);
+        links_[id] = std::move(link);
+        linkByAddress_[from] = id;
+        std::string host = from.toString();
+        return acceptConnection(host.substr(0, host.find(':')), from.port);
+    }
+    
+    void dropConnection(ConnectionId id) {
+        auto link = links_.find(id);
+        if (link != links_.end()) {
+            linkByAddress_.erase(link->second.address);
+            links_.erase(link);
+        }
         auto it = connections_.find(id);
         if (it != connections_.end()) {
-            NetworkMessage msg(NetworkMessageType::Disconnect);
-            send(id, msg);
-            
-            if (onDisconnect_) onDisconnect_(id, it->second);
+            NetworkConnection conn = it->second;
             connections_.erase(it);
+            if (onDisconnect_) onDisconnect_(id, conn);
         }
     }
     
-    size_t getClientCount() const { return connections_.size(); }
-    
-private:
     std::string address_;
     uint16_t port_ = 0;
     bool running_ = false;
     ConnectionId nextConnectionId_ = 2;
-    double heartbeatTimer_ = 0.0;
-    
-    std::queue<std::pair<ConnectionId, std::vector<uint8_t>>> pendingOutgoing_;
+    std::unordered_map<NetAddress, ConnectionId, NetAddressHash> linkByAddress_;
 };
 
 // ===== Network Client =====
 class NetworkClient : public NetworkPeer {
 public:
+    ~NetworkClient() override { stop(); }
+    
     bool start(const std::string& address, uint16_t port) override {
+        stop();
+        NetAddress server;
+        if (!NetAddress::resolve(address, port, server)) {
+            lastError_ = "Cannot resolve " + address;
+            return false;
+        }
+        if (server.ip == 0) server.ip = NetAddress::loopback(port).ip;
+        if (!transport_.open(NetAddress{})) {
+            lastError_ = transport_.getLastError();
+            return false;
+        }
         serverAddress_ = address;
         serverPort_ = port;
         
@@ -463,56 +1039,118 @@ public:
         conn.state = ConnectionState::Connecting;
         connections_[SERVER_CONNECTION] = conn;
         
+        // Messages sent while connecting wait in the link
+        Link link;
+        link.address = server;
+        link.salt = (uint32_t)std::chrono::steady_clock::now().time_since_epoch().count() ^
+                    ((uint32_t)transport_.getLocalAddress().port << 16) ^ 0x9E3779B9u;
+        link.connection = std::make_unique<ReliableConnection>();
+        links_[SERVER_CONNECTION] = std::move(link);
+        
         // Send connect request
-        NetworkMessage msg(NetworkMessageType::Connect);
-        msg.writeUInt32(NETWORK_PROTOCOL_VERSION);
-        send(SERVER_CONNECTION, msg);
+        connectStarted_ = time_;
+        lastConnectSent_ = time_;
+        sendSaltPacket(server, NetworkPacketType::Connect, links_[SERVER_CONNECTION].salt);
+        transport_.flush(time_);
         
         running_ = true;
+        lastError_.clear();
         return true;
     }
     
     void stop() override {
-        if (running_) {
-            NetworkMessage msg(NetworkMessageType::Disconnect);
-            send(SERVER_CONNECTION, msg);
+        if (running_ && links_.count(SERVER_CONNECTION)) {
+            sendPacket(links_[SERVER_CONNECTION].address, NetworkPacketType::Disconnect);
+            transport_.flush(time_);
         }
         running_ = false;
         connections_.clear();
+        links_.clear();
+        transport_.close();
     }
     
     void update(double dt) override {
         if (!running_) return;
+        time_ += dt;
+        auto linkIt = links_.find(SERVER_CONNECTION);
+        if (linkIt == links_.end()) return;
+        Link& link = linkIt->second;
         
-        // Process incoming packets
-        // In real implementation, would poll socket
+        bool lost = false;
+        transport_.receive([&](const NetAddress& from, const uint8_t* data, size_t size) {
+            NetworkPacketType type;
+            const uint8_t* body;
+            size_t bodySize;
+            if (from != link.address || !parsePacket(data, size, type, body, bodySize)) return;
+            
+            switch (type) {
+                case NetworkPacketType::Accept:
+                    if (readSalt(body, bodySize) == link.salt && getConnectionState() == ConnectionState::Connecting) {
+                        auto& conn = connections_[SERVER_CONNECTION];
+                        conn.state = ConnectionState::Connected;
+                        conn.lastHeartbeat = time_;
+                        link.connection->setLastReceiveTime(time_);
+                        if (onConnect_) onConnect_(SERVER_CONNECTION, conn);
+                    }
+                    break;
+                case NetworkPacketType::Deny:
+                    if (readSalt(body, bodySize) == link.salt) {
+                        lastError_ = "Server is full";
+                        lost = true;
+                    }
+                    break;
+                case NetworkPacketType::Data:
+                    if (isConnected() && link.connection->receivePacket(body, bodySize, time_)) {
+                        connections_[SERVER_CONNECTION].lastHeartbeat = time_;
+                    }
+                    break;
+                case NetworkPacketType::Disconnect:
+                    lost = true;
+                    break;
+                default:
+                    break;
+            }
+        });
         
-        // Send heartbeat
-        heartbeatTimer_ += dt;
-        if (heartbeatTimer_ >= 1.0) {
-            heartbeatTimer_ = 0.0;
-            NetworkMessage heartbeat(NetworkMessageType::Heartbeat);
-            send(SERVER_CONNECTION, heartbeat);
+        if (!lost && getConnectionState() == ConnectionState::Connecting) {
+            if (time_ - connectStarted_ > NETWORK_CONNECT_TIMEOUT) {
+                lastError_ = "Connection to " + link.address.toString() + " timed out";
+                lost = true;
+            } else if (time_ - lastConnectSent_ >= NETWORK_CONNECT_RETRY) {
+                lastConnectSent_ = time_;
+                sendSaltPacket(link.address, NetworkPacketType::Connect, link.salt);
+            }
+        }
+        if (!lost && isConnected()) {
+            dispatchLinkMessages();
+            if (time_ - link.connection->getLastReceiveTime() > NETWORK_CONNECTION_TIMEOUT) {
+                lastError_ = "Server timed out";
+                lost = true;
+            }
+        }
+        if (lost) {
+            disconnectFromServer();
+            return;
+        }
+        
+        if (isConnected()) {
+            flushLinks();
+        } else {
+            transport_.flush(time_);
         }
     }
     
-    void send(ConnectionId target, const NetworkMessage& msg) override {
+    void send(ConnectionId target, const NetworkMessage& msg,
+              NetworkChannel channel = NetworkChannel::ReliableOrdered) override {
         // Client only sends to server
-        auto packet = msg.serialize();
-        
-        auto* conn = getConnection(SERVER_CONNECTION);
-        if (conn) {
-            conn->bytesSent += packet.size();
-            conn->packetsSent++;
-        }
-        
-        // In real implementation, would send via socket
-        pendingOutgoing_.push(packet);
+        (void)target;
+        sendOnLink(SERVER_CONNECTION, msg, channel);
     }
     
-    void broadcast(const NetworkMessage& msg) override {
+    void broadcast(const NetworkMessage& msg,
+                   NetworkChannel channel = NetworkChannel::ReliableOrdered) override {
         // Client broadcast is just send to server
-        send(SERVER_CONNECTION, msg);
+        send(SERVER_CONNECTION, msg, channel);
     }
     
     NetworkRole getRole() const override { return NetworkRole::Client; }
@@ -529,12 +1167,23 @@ public:
     }
     
 private:
+    void disconnectFromServer() {
+        auto it = connections_.find(SERVER_CONNECTION);
+        NetworkConnection conn = it != connections_.end() ? it->second : NetworkConnection{};
+        bool wasConnected = conn.isConnected();
+        conn.state = ConnectionState::Disconnected;
+        running_ = false;
+        connections_.clear();
+        links_.clear();
+        transport_.close();
+        if (wasConnected && onDisconnect_) onDisconnect_(SERVER_CONNECTION, conn);
+    }
+    
     std::string serverAddress_;
     uint16_t serverPort_ = 0;
     bool running_ = false;
-    double heartbeatTimer_ = 0.0;
-    
-    std::queue<std::vector<uint8_t>> pendingOutgoing_;
+    double connectStarted_ = 0.0;
+    double lastConnectSent_ = 0.0;
 };
 
 // ===== Network Manager =====
@@ -606,12 +1255,13 @@ public:
     bool isActive() const { return role_ != NetworkRole::None; }
     
     // Convenience: send/RPC
-    void send(ConnectionId target, const NetworkMessage& msg) {
-        if (auto* peer = getPeer()) peer->send(target, msg);
+    void send(ConnectionId target, const NetworkMessage& msg,
+              NetworkChannel channel = NetworkChannel::ReliableOrdered) {
+        if (auto* peer = getPeer()) peer->send(target, msg, channel);
     }
     
-    void broadcast(const NetworkMessage& msg) {
-        if (auto* peer = getPeer()) peer->broadcast(msg);
+    void broadcast(const NetworkMessage& msg, NetworkChannel channel = NetworkChannel::ReliableOrdered) {
+        if (auto* peer = getPeer()) peer->broadcast(msg, channel);
     }
     
     void registerRPC(const std::string& name, RPCDefinition::Handler handler,
@@ -0,0 +1,630 @@
+// Replication Implementation
+#include "replication.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace luma {
+
+namespace {
+
+// a is newer than b, with wrap-around
+inline bool sequenceGreater(uint16_t a, uint16_t b) {
+    return ((a > b) && (a - b <= 32768)) || ((a < b) && (b - a > 32768));
+}
+
+inline int32_t quantizeScalar(float value, float scale) {
+    double q = std::round((double)value * scale);
+    q = std::max(-2147483647.0, std::min(2147483647.0, q));
+    return std::isnan(q) ? 0 : (int32_t)q;
+}
+
+constexpr float kQuatRange = 0.70710678f;
+constexpr uint32_t kQuatSteps = 1023;
+
+// Smallest three, 10 bits each: index << 30 | a << 20 | b << 10 | c
+uint32_t quantizeRotation(const Quat& q) {
+    float c[4] = {q.x, q.y, q.z, q.w};
+    float lengthSq = c[0] * c[0] + c[1] * c[1] + c[2] * c[2] + c[3] * c[3];
+    float invLength = lengthSq > 0.0f ? 1.0f / std::sqrt(lengthSq) : 1.0f;
+    if (!(lengthSq > 0.0f)) c[3] = 1.0f;
+    int largest = 0;
+    for (int i = 1; i < 4; i++) {
+        if (std::abs(c[i]) > std::abs(c[largest])) largest = i;
+    }
+    float sign = c[largest] < 0.0f ? -invLength : invLength;
+    uint32_t packed = (uint32_t)largest << 30;
+    int shift = 20;
+    for (int i = 0; i < 4; i++) {
+        if (i == largest) continue;
+        float t = (c[i] * sign + kQuatRange) / (2.0f * kQuatRange);
+        t = t > 0.0f ? (t < 1.0f ? t : 1.0f) : 0.0f;
+        packed |= (uint32_t)(t * kQuatSteps + 0.5f) << shift;
+        shift -= 10;
+    }
+    return packed;
+}
+
+Quat dequantizeRotation(uint32_t packed) {
+    int largest = (int)(packed >> 30);
+    float c[4];
+    float sumSq = 0.0f;
+    int shift = 20;
+    for (int i = 0; i < 4; i++) {
+        if (i == largest) continue;
+        c[i] = ((float)((packed >> shift) & kQuatSteps) / kQuatSteps) * (2.0f * kQuatRange) - kQuatRange;
+        sumSq += c[i] * c[i];
+        shift -= 10;
+    }
+    c[largest] = std::sqrt(std::max(0.0f, 1.0f - sumSq));
+    return Quat(c[0], c[1], c[2], c[3]);
+}
+
+// Zigzag delta with a unary size class: 0 + 4 bits, 10 + 9, 110 + 16, 111 + 32
+void writeDelta(NetworkMessage& msg, int32_t delta) {
+    uint32_t z = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+    if (z < (1u << 4)) {
+        msg.writeBits(z << 1, 5);
+    } else if (z < (1u << 9)) {
+        msg.writeBits(1 | (z << 2), 11);
+    } else if (z < (1u << 16)) {
+        msg.writeBits(3 | (z << 3), 19);
+    } else {
+        msg.writeBits(7, 3);
+        msg.writeBits(z, 32);
+    }
+}
+
+int32_t readDelta(NetworkMessage& msg) {
+    uint32_t z;
+    if (!msg.readBool()) {
+        z = msg.readBits(4);
+    } else if (!msg.readBool()) {
+        z = msg.readBits(9);
+    } else if (!msg.readBool()) {
+        z = msg.readBits(16);
+    } else {
+        z = msg.readBits(32);
+    }
+    return (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+}
+
+constexpr uint32_t kMaxDespawnsPerSnapshot = 64;
+constexpr uint32_t kGridBuckets = 4096;  // power of two
+constexpr float kOwnerWeight = 4.0f;
+constexpr double kClockSnap = 0.25;      // seconds of render clock error
+constexpr double kMaxExtrapolation = 0.25;
+constexpr size_t kMaxSamples = 32;
+
+inline uint32_t cellBucket(int32_t x, int32_t z) {
+    uint32_t h = (uint32_t)x * 73856093u ^ (uint32_t)z * 19349663u;
+    return h & (kGridBuckets - 1);
+}
+
+}  // namespace
+
+// ===== Quantized State =====
+
+QuantizedState QuantizedState::quantize(const ReplicatedState& state) {
+    QuantizedState q;
+    q.position[0] = quantizeScalar(state.position.x, REPLICATION_POSITION_SCALE);
+    q.position[1] = quantizeScalar(state.position.y, REPLICATION_POSITION_SCALE);
+    q.position[2] = quantizeScalar(state.position.z, REPLICATION_POSITION_SCALE);
+    q.rotation = quantizeRotation(state.rotation);
+    q.velocity[0] = quantizeScalar(state.velocity.x, REPLICATION_VELOCITY_SCALE);
+    q.velocity[1] = quantizeScalar(state.velocity.y, REPLICATION_VELOCITY_SCALE);
+    q.velocity[2] = quantizeScalar(state.velocity.z, REPLICATION_VELOCITY_SCALE);
+    q.userData = state.userData;
+    return q;
+}
+
+ReplicatedState QuantizedState::dequantize() const {
+    ReplicatedState s;
+    s.position = Vec3(position[0] / REPLICATION_POSITION_SCALE, position[1] / REPLICATION_POSITION_SCALE,
+                      position[2] / REPLICATION_POSITION_SCALE);
+    s.rotation = dequantizeRotation(rotation);
+    s.velocity = Vec3(velocity[0] / REPLICATION_VELOCITY_SCALE, velocity[1] / REPLICATION_VELOCITY_SCALE,
+                      velocity[2] / REPLICATION_VELOCITY_SCALE);
+    s.userData = userData;
+    return s;
+}
+
+// ===== Server =====
+
+ReplicationServer::ReplicationServer(NetworkPeer& peer) : peer_(peer) {
+    peer_.setMessageHandler(NetworkMessageType::SnapshotAck,
+                            [this](ConnectionId sender, NetworkMessage& msg) { onAck(sender, msg); });
+    cellStart_.assign(kGridBuckets + 1, 0);
+}
+
+ReplicationServer::~ReplicationServer() {
+    peer_.setMessageHandler(NetworkMessageType::SnapshotAck, nullptr);
+}
+
+bool ReplicationServer::addEntity(uint32_t id, uint32_t typeId, const ReplicatedState& state, ConnectionId owner) {
+    if (slotOf_.count(id)) return false;
+    slotOf_[id] = (uint32_t)entities_.size();
+    entities_.push_back({id, typeId, owner, state, QuantizedState::quantize(state)});
+    for (auto& [clientId, client] : clients_) client.slots.emplace_back();
+    return true;
+}
+
+void ReplicationServer::setState(uint32_t id, const ReplicatedState& state) {
+    auto it = slotOf_.find(id);
+    if (it != slotOf_.end()) entities_[it->second].state = state;
+}
+
+void ReplicationServer::removeEntity(uint32_t id) {
+    auto it = slotOf_.find(id);
+    if (it == slotOf_.end()) return;
+    uint32_t slot = it->second;
+    uint32_t last = (uint32_t)entities_.size() - 1;
+    for (auto& [clientId, client] : clients_) {
+        resetSlot(client, slot, true);
+        client.slots[slot] = client.slots[last];
+        client.slots.pop_back();
+    }
+    slotOf_.erase(it);
+    if (slot != last) {
+        entities_[slot] = entities_[last];
+        slotOf_[entities_[slot].id] = slot;
+    }
+    entities_.pop_back();
+}
+
+void ReplicationServer::setInterest(ConnectionId client, const Vec3& center, float radius) {
+    interest_[client] = {center, radius};
+    auto it = clients_.find(client);
+    if (it != clients_.end()) {
+        it->second.interestCenter = center;
+        it->second.interestRadius = radius;
+    }
+}
+
+void ReplicationServer::resetSlot(Client& client, uint32_t slot, bool despawn) {
+    ClientEntity& ce = client.slots[slot];
+    if (despawn && ce.inFlight) client.despawns.push_back(ce.id);
+    ce.epoch++;
+    ce.priority = 0.0f;
+    ce.inFlight = false;
+    ce.known = false;
+    ce.hasBaseline = false;
+}
+
+void ReplicationServer::syncClients() {
+    const auto& connections = peer_.getConnections();
+    for (auto it = clients_.begin(); it != clients_.end();) {
+        auto conn = connections.find(it->first);
+        if (conn == connections.end() || !conn->second.isConnected()) {
+            interest_.erase(it->first);
+            it = clients_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (const auto& [id, conn] : connections) {
+        if (!conn.isConnected() || clients_.count(id)) continue;
+        Client& client = clients_[id];
+        client.id = id;
+        client.slots.resize(entities_.size());
+        client.sent.resize(kSentWindow);
+        client.records.resize(kRecordRing);
+        client.despawnRecords.resize(kRecordRing);
+        auto interest = interest_.find(id);
+        if (interest != interest_.end()) {
+            client.interestCenter = interest->second.first;
+            client.interestRadius = interest->second.second;
+        }
+    }
+}
+
+void ReplicationServer::buildGrid() {
+    // Counting sort of entities into hash buckets of their XZ cell
+    const uint32_t n = (uint32_t)entities_.size();
+    const float inv = 1.0f / cellSize_;
+    entityCell_.resize(n);
+    cellEntities_.resize(n);
+    std::fill(cellStart_.begin(), cellStart_.end(), 0);
+    for (uint32_t i = 0; i < n; i++) {
+        const Vec3& p = entities_[i].state.position;
+        uint32_t bucket = cellBucket((int32_t)std::floor(p.x * inv), (int32_t)std::floor(p.z * inv));
+        entityCell_[i] = bucket;
+        cellStart_[bucket + 1]++;
+    }
+    for (uint32_t b = 0; b < kGridBuckets; b++) cellStart_[b + 1] += cellStart_[b];
+    std::vector<uint32_t> cursor(cellStart_.begin(), cellStart_.end() - 1);
+    for (uint32_t i = 0; i < n; i++) cellEntities_[cursor[entityCell_[i]]++] = i;
+}
+
+void ReplicationServer::gatherRelevant(Client& client) {
+    client.candidates.clear();
+    const float radius = client.interestRadius;
+    const float radiusSq = radius * radius;
+    const Vec3 center = client.interestCenter;
+
+    auto consider = [&](uint32_t slot) {
+        const Entity& entity = entities_[slot];
+        ClientEntity& ce = client.slots[slot];
+        if (ce.relevantTick == tick_ && ce.id == entity.id) return;  // bucket seen twice
+        bool owned = entity.owner == client.id;
+        float weight = 1.0f;
+        if (radius > 0.0f) {
+            float dx = entity.state.position.x - center.x;
+            float dz = entity.state.position.z - center.z;
+            float distSq = dx * dx + dz * dz;
+            if (distSq > radiusSq && !owned) return;
+            weight = 1.0f / (1.0f + 4.0f * std::sqrt(distSq) / radius);
+        }
+        if (owned) weight = kOwnerWeight;
+        if (ce.id != entity.id) {
+            // Slot taken over by a different entity
+            resetSlot(client, slot, true);
+            ce.id = entity.id;
+        }
+        if (!ce.inFlight && !client.despawns.empty()) {
+            // Back in range before its despawn was acked
+            auto it = std::find(client.despawns.begin(), client.despawns.end(), entity.id);
+            if (it != client.despawns.end()) client.despawns.erase(it);
+        }
+        ce.relevantTick = tick_;
+        if (ce.known && ce.hasBaseline && ce.baseline == entity.quantized) {
+            ce.priority = 0.0f;  // client already has it
+            return;
+        }
+        ce.priority += weight;
+        client.candidates.push_back(slot);
+    };
+
+    if (radius <= 0.0f) {
+        for (uint32_t slot = 0; slot < entities_.size(); slot++) consider(slot);
+    } else {
+        const float inv = 1.0f / cellSize_;
+        int32_t x0 = (int32_t)std::floor((center.x - radius) * inv), x1 = (int32_t)std::floor((center.x + radius) * inv);
+        int32_t z0 = (int32_t)std::floor((center.z - radius) * inv), z1 = (int32_t)std::floor((center.z + radius) * inv);
+        if ((int64_t)(x1 - x0 + 1) * (z1 - z0 + 1) >= (int64_t)kGridBuckets) {
+            for (uint32_t slot = 0; slot < entities_.size(); slot++) consider(slot);
+        } else {
+            for (int32_t z = z0; z <= z1; z++) {
+                for (int32_t x = x0; x <= x1; x++) {
+                    uint32_t bucket = cellBucket(x, z);
+                    for (uint32_t i = cellStart_[bucket]; i < cellStart_[bucket + 1]; i++) consider(cellEntities_[i]);
+                }
+            }
+        }
+        // Owned entities outside the radius
+        for (uint32_t slot = 0; slot < entities_.size(); slot++) {
+            if (entities_[slot].owner == client.id) consider(slot);
+        }
+    }
+
+    // Entities the client has that left its interest
+    for (uint32_t slot = 0; slot < client.slots.size(); slot++) {
+        ClientEntity& ce = client.slots[slot];
+        if (ce.inFlight && ce.relevantTick != tick_) resetSlot(client, slot, true);
+    }
+}
+
+void ReplicationServer::writeSnapshot(Client& client) {
+    std::sort(client.candidates.begin(), client.candidates.end(), [&](uint32_t a, uint32_t b) {
+        return client.slots[a].priority > client.slots[b].priority;
+    });
+
+    NetworkMessage& msg = snapshot_;
+    msg.clear();
+    msg.setType(NetworkMessageType::StateUpdate);
+    const uint16_t sequence = client.nextSequence++;
+    msg.writeUInt16(sequence);
+    msg.writeVarUInt(tick_);
+
+    SentSnapshot& sent = client.sent[sequence % kSentWindow];
+    sent.sequence = sequence;
+    sent.valid = true;
+    sent.acked = false;
+    sent.firstRecord = client.recordHead;
+    sent.recordCount = 0;
+    sent.firstDespawn = client.despawnHead;
+
+    uint32_t despawnCount = std::min<uint32_t>((uint32_t)client.despawns.size(), kMaxDespawnsPerSnapshot);
+    msg.writeVarUInt(despawnCount);
+    uint32_t previousId = 0;
+    for (uint32_t i = 0; i < despawnCount; i++) {
+        uint32_t id = client.despawns[i];
+        msg.writeVarInt((int64_t)id - (int64_t)previousId);
+        previousId = id;
+        client.despawnRecords[client.despawnHead++ % kRecordRing] = id;
+    }
+    sent.despawnCount = despawnCount;
+
+    previousId = 0;
+    size_t written = 0;
+    for (uint32_t slot : client.candidates) {
+        const Entity& entity = entities_[slot];
+        ClientEntity& ce = client.slots[slot];
+        const size_t mark = msg.getBitSize();
+
+        msg.writeBool(true);
+        msg.writeVarInt((int64_t)entity.id - (int64_t)previousId);
+        msg.writeBool(!ce.known);
+        if (!ce.known) msg.writeVarUInt(entity.typeId);
+
+        QuantizedState base;
+        uint16_t offset = (uint16_t)(sequence - ce.baselineSequence);
+        if (ce.hasBaseline && offset < REPLICATION_BASELINE_WINDOW) {
+            base = ce.baseline;
+        } else {
+            offset = 0;
+        }
+        msg.writeBits(offset, 5);
+
+        const QuantizedState& q = entity.quantized;
+        bool positionChanged = q.position[0] != base.position[0] || q.position[1] != base.position[1] ||
+                               q.position[2] != base.position[2];
+        msg.writeBool(positionChanged);
+        if (positionChanged) {
+            for (int k = 0; k < 3; k++) writeDelta(msg, (int32_t)((uint32_t)q.position[k] - (uint32_t)base.position[k]));
+        }
+        msg.writeBool(q.rotation != base.rotation);
+        if (q.rotation != base.rotation) msg.writeBits(q.rotation, 32);
+        bool velocityChanged = q.velocity[0] != base.velocity[0] || q.velocity[1] != base.velocity[1] ||
+                               q.velocity[2] != base.velocity[2];
+        msg.writeBool(velocityChanged);
+        if (velocityChanged) {
+            for (int k = 0; k < 3; k++) writeDelta(msg, (int32_t)((uint32_t)q.velocity[k] - (uint32_t)base.velocity[k]));
+        }
+        msg.writeBool(q.userData != base.userData);
+        if (q.userData != base.userData) msg.writeVarUInt(q.userData);
+
+        // One bit for the terminator
+        if (msg.getSize() + 1 > bytesPerClient_) {
+            msg.truncateBits(mark);
+            break;
+        }
+        previousId = entity.id;
+        ce.priority = 0.0f;
+        ce.inFlight = true;
+        client.records[client.recordHead++ % kRecordRing] = {entity.id, ce.epoch, q};
+        sent.recordCount++;
+        written++;
+    }
+    msg.writeBool(false);
+
+    stats_.entitiesSent += written;
+    stats_.entitiesDeferred += client.candidates.size() - written;
+    stats_.bytesSent += msg.getSize();
+}
+
+void ReplicationServer::tick(double dt) {
+    (void)dt;  // priorities accumulate per tick
+    auto start = std::chrono::steady_clock::now();
+    tick_++;
+    syncClients();
+    for (Entity& entity : entities_) entity.quantized = QuantizedState::quantize(entity.state);
+    buildGrid();
+
+    stats_.entitiesSent = 0;
+    stats_.entitiesDeferred = 0;
+    stats_.bytesSent = 0;
+    for (auto& [id, client] : clients_) {
+        gatherRelevant(client);
+        writeSnapshot(client);
+        peer_.send(id, snapshot_, NetworkChannel::UnreliableSequenced);
+    }
+    stats_.clients = clients_.size();
+    stats_.entities = entities_.size();
+    stats_.tickMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void ReplicationServer::onAck(ConnectionId sender, NetworkMessage& msg) {
+    auto it = clients_.find(sender);
+    if (it == clients_.end()) return;
+    uint16_t latest = msg.readUInt16();
+    uint32_t bits = msg.readUInt32();
+    if (msg.hasReadError()) return;
+    // Oldest first so baselines end up on the newest acked snapshot
+    for (int i = 31; i >= 0; i--) {
+        if (bits & (1u << i)) applyAck(it->second, (uint16_t)(latest - i));
+    }
+}
+
+void ReplicationServer::applyAck(Client& client, uint16_t sequence) {
+    SentSnapshot& sent = client.sent[sequence % kSentWindow];
+    if (!sent.valid || sent.sequence != sequence || sent.acked) return;
+    sent.acked = true;
+
+    if (client.recordHead - sent.firstRecord <= kRecordRing) {
+        for (uint32_t r = 0; r < sent.recordCount; r++) {
+            const SentRecord& record = client.records[(sent.firstRecord + r) % kRecordRing];
+            auto slot = slotOf_.find(record.id);
+            if (slot == slotOf_.end()) continue;
+            ClientEntity& ce = client.slots[slot->second];
+            if (ce.id != record.id || ce.epoch != record.epoch) continue;
+            ce.known = true;
+            if (!ce.hasBaseline || sequenceGreater(sequence, ce.baselineSequence)) {
+                ce.baseline = record.state;
+                ce.baselineSequence = sequence;
+                ce.hasBaseline = true;
+            }
+        }
+    }
+    if (client.despawnHead - sent.firstDespawn <= kRecordRing) {
+        for (uint32_t d = 0; d < sent.despawnCount; d++) {
+            uint32_t id = client.despawnRecords[(sent.firstDespawn + d) % kRecordRing];
+            auto it = std::find(client.despawns.begin(), client.despawns.end(), id);
+            if (it != client.despawns.end()) client.despawns.erase(it);
+        }
+    }
+}
+
+// ===== Client =====
+
+ReplicationClient::ReplicationClient(NetworkPeer& peer) : peer_(peer) {
+    peer_.setMessageHandler(NetworkMessageType::StateUpdate,
+                            [this](ConnectionId sender, NetworkMessage& msg) { onSnapshot(sender, msg); });
+}
+
+ReplicationClient::~ReplicationClient() {
+    peer_.setMessageHandler(NetworkMessageType::StateUpdate, nullptr);
+}
+
+void ReplicationClient::onSnapshot(ConnectionId sender, NetworkMessage& msg) {
+    (void)sender;
+    const uint16_t sequence = msg.readUInt16();
+    const uint32_t tick = (uint32_t)msg.readVarUInt();
+    if (anyReceived_ && !sequenceGreater(sequence, latestSequence_)) {
+        stats_.snapshotsDropped++;
+        return;
+    }
+    stats_.snapshotsReceived++;
+    stats_.bytesReceived += msg.getSize();
+
+    uint32_t despawnCount = (uint32_t)msg.readVarUInt();
+    int64_t id = 0;
+    for (uint32_t i = 0; i < despawnCount && !msg.hasReadError(); i++) {
+        id += msg.readVarInt();
+        if (entities_.erase((uint32_t)id) && onDespawn_) onDespawn_((uint32_t)id);
+    }
+
+    bool complete = true;
+    const double time = tick * tickInterval_;
+    const uint32_t ring = sequence % REPLICATION_BASELINE_WINDOW;
+    id = 0;
+    while (msg.readBool()) {
+        id += msg.readVarInt();
+        bool spawn = msg.readBool();
+        uint32_t typeId = spawn ? (uint32_t)msg.readVarUInt() : 0;
+        uint32_t offset = msg.readBits(5);
+
+        auto it = entities_.find((uint32_t)id);
+        bool created = false;
+        if (it == entities_.end() && spawn) {
+            it = entities_.emplace((uint32_t)id, Entity{}).first;
+            created = true;
+        }
+        Entity* entity = it != entities_.end() ? &it->second : nullptr;
+        if (entity && spawn) entity->typeId = typeId;
+
+        QuantizedState q;
+        bool baselineOk = entity != nullptr;
+        if (offset != 0 && entity) {
+            uint16_t baseSequence = (uint16_t)(sequence - offset);
+            uint32_t slot = baseSequence % REPLICATION_BASELINE_WINDOW;
+            if (entity->valid[slot] && entity->sequences[slot] == baseSequence) {
+                q = entity->history[slot];
+            } else {
+                baselineOk = false;
+            }
+        }
+        if (msg.readBool()) {
+            for (int k = 0; k < 3; k++) q.position[k] = (int32_t)((uint32_t)q.position[k] + (uint32_t)readDelta(msg));
+        }
+        if (msg.readBool()) q.rotation = msg.readBits(32);
+        if (msg.readBool()) {
+            for (int k = 0; k < 3; k++) q.velocity[k] = (int32_t)((uint32_t)q.velocity[k] + (uint32_t)readDelta(msg));
+        }
+        if (msg.readBool()) q.userData = (uint32_t)msg.readVarUInt();
+        if (msg.hasReadError()) break;
+
+        if (!baselineOk) {
+            // Leave this snapshot unacked so the server falls back to an
+            // older baseline (or a full state)
+            stats_.baselineMisses++;
+            complete = false;
+            if (created) entities_.erase(it);
+            continue;
+        }
+        entity->sequences[ring] = sequence;
+        entity->valid[ring] = true;
+        entity->history[ring] = q;
+        entity->latest = q;
+        if (entity->samples.empty() || time > entity->samples.back().time) {
+            entity->samples.push_back({time, q.dequantize()});
+            if (entity->samples.size() > kMaxSamples) entity->samples.pop_front();
+        }
+        stats_.entityUpdates++;
+        if (created && onSpawn_) onSpawn_((uint32_t)id, typeId);
+    }
+    if (msg.hasReadError()) complete = false;
+
+    // Ack history: bit i is sequence - i
+    if (anyReceived_) {
+        uint16_t shift = (uint16_t)(sequence - latestSequence_);
+        receivedBits_ = shift >= 32 ? 0 : receivedBits_ << shift;
+    }
+    if (complete) receivedBits_ |= 1u;
+    anyReceived_ = true;
+    latestSequence_ = sequence;
+    latestTick_ = tick;
+    ackDue_ = true;
+
+    if (!clockStarted_) {
+        renderTime_ = time - interpolationDelay_;
+        clockStarted_ = true;
+    }
+}
+
+void ReplicationClient::update(double dt) {
+    if (clockStarted_) {
+        // Follow the newest snapshot minus the delay, snapping on large error
+        renderTime_ += dt;
+        double target = latestTick_ * tickInterval_ - interpolationDelay_;
+        double error = target - renderTime_;
+        if (std::abs(error) > kClockSnap) {
+            renderTime_ = target;
+        } else {
+            renderTime_ += error * std::min(1.0, dt * 2.0);
+        }
+        for (auto& [id, entity] : entities_) {
+            while (entity.samples.size() > 2 && entity.samples[1].time <= renderTime_) entity.samples.pop_front();
+        }
+    }
+    if (ackDue_) {
+        NetworkMessage ack(NetworkMessageType::SnapshotAck);
+        ack.writeUInt16(latestSequence_);
+        ack.writeUInt32(receivedBits_);
+        peer_.send(SERVER_CONNECTION, ack, NetworkChannel::Unreliable);
+        ackDue_ = false;
+    }
+}
+
+bool ReplicationClient::getLatestState(uint32_t id, ReplicatedState& out) const {
+    auto it = entities_.find(id);
+    if (it == entities_.end()) return false;
+    out = it->second.latest.dequantize();
+    return true;
+}
+
+bool ReplicationClient::getInterpolatedState(uint32_t id, ReplicatedState& out) const {
+    auto it = entities_.find(id);
+    if (it == entities_.end() || it->second.samples.empty()) return false;
+    const auto& samples = it->second.samples;
+    if (renderTime_ <= samples.front().time) {
+        out = samples.front().state;
+        return true;
+    }
+    if (renderTime_ >= samples.back().time) {
+        // Not updated since (unchanged or deferred): extrapolate briefly
+        const Sample& last = samples.back();
+        out = last.state;
+        float ahead = (float)std::min(renderTime_ - last.time, kMaxExtrapolation);
+        out.position = last.state.position + last.state.velocity * ahead;
+        return true;
+    }
+    size_t i = 1;
+    while (samples[i].time < renderTime_) i++;
+    const Sample& a = samples[i - 1];
+    const Sample& b = samples[i];
+    float t = (float)((renderTime_ - a.time) / (b.time - a.time));
+    out = b.state;
+    out.position = a.state.position + (b.state.position - a.state.position) * t;
+    out.velocity = a.state.velocity + (b.state.velocity - a.state.velocity) * t;
+    const Quat& qa = a.state.rotation;
+    Quat qb = b.state.rotation;
+    if (qa.x * qb.x + qa.y * qb.y + qa.z * qb.z + qa.w * qb.w < 0.0f) qb = Quat(-qb.x, -qb.y, -qb.z, -qb.w);
+    Quat q(qa.x + (qb.x - qa.x) * t, qa.y + (qb.y - qa.y) * t, qa.z + (qb.z - qa.z) * t, qa.w + (qb.w - qa.w) * t);
+    float length = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    out.rotation = length > 0.0f ? Quat(q.x / length, q.y / length, q.z / length, q.w / length) : qb;
+    return true;
+}
+
+}  // namespace luma
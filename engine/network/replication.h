@@ -0,0 +1,250 @@
+// Replication - delta-compressed entity snapshots with interest management
+// Server, per tick:
+//   1. quantize every replicated entity once (positions 1/512 m, velocities
+//      1/256 m/s, smallest-three rotations) and bucket it in a spatial grid
+//   2. per client: gather entities in the interest radius (plus owned ones),
+//      add relevance to a per-entity priority accumulator, and write the
+//      highest priorities first until the byte cap is reached
+//   3. each entity is delta-encoded against the last state the client acked
+//      for it; unchanged, acked entities cost nothing
+// Snapshots go out on the sequenced unreliable channel; the client acks
+// with (latest sequence, 32-bit history) and keeps a 32-snapshot baseline
+// ring per entity plus an interpolation buffer.
+// Entity ids are caller-chosen (e.g. ScriptInstance::getNetworkId()).
+#pragma once
+
+#include "engine/network/network.h"
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace luma {
+
+// ===== Replicated State =====
+struct ReplicatedState {
+    Vec3 position;
+    Quat rotation;
+    Vec3 velocity;
+    uint32_t userData = 0;  // game-defined bits (animation state, health, ...)
+};
+
+// Wire representation; deltas are taken between these
+struct QuantizedState {
+    int32_t position[3] = {0, 0, 0};
+    uint32_t rotation = 0;  // smallest three: 2-bit index + 3 x 10 bits
+    int32_t velocity[3] = {0, 0, 0};
+    uint32_t userData = 0;
+
+    static QuantizedState quantize(const ReplicatedState& state);
+    ReplicatedState dequantize() const;
+    bool operator==(const QuantizedState& o) const {
+        return position[0] == o.position[0] && position[1] == o.position[1] && position[2] == o.position[2] &&
+               rotation == o.rotation && velocity[0] == o.velocity[0] && velocity[1] == o.velocity[1] &&
+               velocity[2] == o.velocity[2] && userData == o.userData;
+    }
+    bool operator!=(const QuantizedState& o) const { return !(*this == o); }
+};
+
+constexpr float REPLICATION_POSITION_SCALE = 512.0f;
+constexpr float REPLICATION_VELOCITY_SCALE = 256.0f;
+constexpr uint32_t REPLICATION_BASELINE_WINDOW = 32;  // snapshots
+
+// ===== Server =====
+
+struct ReplicationServerStats {
+    size_t clients = 0;
+    size_t entities = 0;
+    size_t entitiesSent = 0;      // summed over clients, last tick
+    size_t entitiesDeferred = 0;  // relevant and changed but over the byte cap
+    size_t bytesSent = 0;         // snapshot payload, last tick
+    double tickMs = 0.0;
+};
+
+class ReplicationServer {
+public:
+    // Registers the snapshot-ack handler on peer (normally a NetworkServer)
+    explicit ReplicationServer(NetworkPeer& peer);
+    ~ReplicationServer();
+
+    ReplicationServer(const ReplicationServer&) = delete;
+    ReplicationServer& operator=(const ReplicationServer&) = delete;
+
+    // Entities; typeId tells clients what to spawn
+    bool addEntity(uint32_t id, uint32_t typeId, const ReplicatedState& state,
+                   ConnectionId owner = INVALID_CONNECTION);
+    void setState(uint32_t id, const ReplicatedState& state);
+    void removeEntity(uint32_t id);
+    size_t getEntityCount() const { return entities_.size(); }
+
+    // Interest: entities within radius (XZ plane) of center; 0 = everything.
+    // Owned entities are always relevant to their owner.
+    void setInterest(ConnectionId client, const Vec3& center, float radius);
+    void setGridCellSize(float size) { cellSize_ = size > 1.0f ? size : 1.0f; }
+    // Snapshot payload cap; 1000 keeps a snapshot in one datagram
+    void setBytesPerClient(size_t bytes) { bytesPerClient_ = bytes; }
+    size_t getBytesPerClient() const { return bytesPerClient_; }
+
+    // Builds and sends one snapshot per connected client. Clients are
+    // picked up from (and dropped with) the peer's connection list.
+    void tick(double dt);
+    uint32_t getTick() const { return tick_; }
+
+    const ReplicationServerStats& stats() const { return stats_; }
+
+private:
+    struct Entity {
+        uint32_t id;
+        uint32_t typeId;
+        ConnectionId owner;
+        ReplicatedState state;
+        QuantizedState quantized;
+    };
+    struct ClientEntity {
+        uint32_t id = 0;           // entity this slot state belongs to
+        uint32_t epoch = 0;        // bumped on reset; stale acks are ignored
+        float priority = 0.0f;
+        uint32_t relevantTick = 0;
+        bool inFlight = false;     // spawned or sent since the last reset
+        bool known = false;        // client acked a snapshot holding it
+        bool hasBaseline = false;
+        uint16_t baselineSequence = 0;
+        QuantizedState baseline;
+    };
+    // Slots move on removal, so records are matched by id at ack time
+    struct SentRecord {
+        uint32_t id;
+        uint32_t epoch;
+        QuantizedState state;
+    };
+    struct SentSnapshot {
+        uint16_t sequence = 0;
+        bool valid = false;
+        bool acked = false;
+        uint64_t firstRecord = 0;  // absolute index into the record ring
+        uint32_t recordCount = 0;
+        uint64_t firstDespawn = 0;
+        uint32_t despawnCount = 0;
+    };
+    struct Client {
+        ConnectionId id = INVALID_CONNECTION;
+        Vec3 interestCenter;
+        float interestRadius = 0.0f;
+        uint16_t nextSequence = 0;
+        std::vector<ClientEntity> slots;      // by entity slot
+        std::vector<uint32_t> despawns;       // ids the client must drop
+        std::vector<SentSnapshot> sent;       // by sequence % kSentWindow
+        std::vector<SentRecord> records;      // ring
+        uint64_t recordHead = 0;
+        std::vector<uint32_t> despawnRecords; // ring of despawned ids
+        uint64_t despawnHead = 0;
+        std::vector<uint32_t> candidates;     // scratch
+    };
+
+    static constexpr uint32_t kSentWindow = 64;
+    static constexpr size_t kRecordRing = 16384;
+
+    void syncClients();
+    void buildGrid();
+    void gatherRelevant(Client& client);
+    void writeSnapshot(Client& client);
+    void onAck(ConnectionId sender, NetworkMessage& msg);
+    void applyAck(Client& client, uint16_t sequence);
+    void resetSlot(Client& client, uint32_t slot, bool despawn);
+
+    NetworkPeer& peer_;
+    std::vector<Entity> entities_;                 // dense
+    std::unordered_map<uint32_t, uint32_t> slotOf_;
+    std::unordered_map<ConnectionId, Client> clients_;
+    std::unordered_map<ConnectionId, std::pair<Vec3, float>> interest_;
+
+    // Spatial hash over entity XZ, rebuilt every tick by counting sort
+    float cellSize_ = 32.0f;
+    std::vector<uint32_t> cellStart_;
+    std::vector<uint32_t> cellEntities_;
+    std::vector<uint32_t> entityCell_;
+
+    size_t bytesPerClient_ = 1000;
+    uint32_t tick_ = 0;
+    NetworkMessage snapshot_;
+    ReplicationServerStats stats_;
+};
+
+// ===== Client =====
+
+struct ReplicationClientStats {
+    size_t snapshotsReceived = 0;
+    size_t snapshotsDropped = 0;     // older than one already applied
+    size_t entityUpdates = 0;
+    size_t baselineMisses = 0;       // delta against a state we no longer have
+    size_t bytesReceived = 0;
+};
+
+class ReplicationClient {
+public:
+    using SpawnCallback = std::function<void(uint32_t id, uint32_t typeId)>;
+    using DespawnCallback = std::function<void(uint32_t id)>;
+
+    // Registers the snapshot handler on peer (normally a NetworkClient)
+    explicit ReplicationClient(NetworkPeer& peer);
+    ~ReplicationClient();
+
+    ReplicationClient(const ReplicationClient&) = delete;
+    ReplicationClient& operator=(const ReplicationClient&) = delete;
+
+    void setTickRate(double hz) { tickInterval_ = hz > 0.0 ? 1.0 / hz : tickInterval_; }
+    // Render time lags the newest snapshot by this much
+    void setInterpolationDelay(double seconds) { interpolationDelay_ = seconds; }
+    void setOnSpawn(SpawnCallback cb) { onSpawn_ = std::move(cb); }
+    void setOnDespawn(DespawnCallback cb) { onDespawn_ = std::move(cb); }
+
+    // Advances the render clock and acks received snapshots
+    void update(double dt);
+
+    bool hasEntity(uint32_t id) const { return entities_.count(id) != 0; }
+    size_t getEntityCount() const { return entities_.size(); }
+    // Newest received state
+    bool getLatestState(uint32_t id, ReplicatedState& out) const;
+    // State at the render time, interpolated between buffered snapshots
+    bool getInterpolatedState(uint32_t id, ReplicatedState& out) const;
+    // Server tick the render clock currently shows (fractional)
+    double getRenderTick() const { return renderTime_ / tickInterval_; }
+    uint32_t getLatestTick() const { return latestTick_; }
+
+    const ReplicationClientStats& stats() const { return stats_; }
+
+private:
+    struct Sample {
+        double time;
+        ReplicatedState state;
+    };
+    struct Entity {
+        uint32_t typeId = 0;
+        uint16_t sequences[REPLICATION_BASELINE_WINDOW];
+        bool valid[REPLICATION_BASELINE_WINDOW] = {};
+        QuantizedState history[REPLICATION_BASELINE_WINDOW];
+        QuantizedState latest;
+        std::deque<Sample> samples;
+    };
+
+    void onSnapshot(ConnectionId sender, NetworkMessage& msg);
+
+    NetworkPeer& peer_;
+    std::unordered_map<uint32_t, Entity> entities_;
+    SpawnCallback onSpawn_;
+    DespawnCallback onDespawn_;
+
+    bool anyReceived_ = false;
+    bool ackDue_ = false;
+    uint16_t latestSequence_ = 0;
+    uint32_t receivedBits_ = 0;      // bit i: latestSequence_ - 1 - i received
+    uint32_t latestTick_ = 0;
+    double tickInterval_ = 1.0 / 30.0;
+    double interpolationDelay_ = 0.1;
+    double renderTime_ = 0.0;
+    bool clockStarted_ = false;
+    ReplicationClientStats stats_;
+};
+
+}  // namespace luma
@@ -0,0 +1,811 @@
+// UDP Transport Implementation
+#include "udp_transport.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#define LUMA_NET_MMSG 1
+#endif
+#endif
+
+namespace luma {
+
+namespace {
+
+// ===== Byte Helpers =====
+
+inline void put16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+inline void put32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (i * 8));
+}
+inline uint16_t get16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+inline uint32_t get32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// a is newer than b, with wrap-around
+inline bool sequenceGreater(uint16_t a, uint16_t b) {
+    return ((a > b) && (a - b <= 32768)) || ((a < b) && (b - a > 32768));
+}
+
+constexpr size_t kPacketHeaderSize = 9;   // sequence, ack, ackBits, flags
+constexpr size_t kEntryHeaderSize = 5;    // channel, message id, size
+constexpr size_t kFragmentHeaderSize = 4; // index, count
+constexpr uint8_t kFragmentedFlag = 0x80;
+constexpr uint8_t kHasAckFlag = 0x01;       // ack fields are meaningful
+constexpr size_t kMaxReassemblyBytes = 32u << 20;
+constexpr size_t kSentEntryRing = 1u << 16;
+constexpr double kKeepaliveInterval = 0.1;
+constexpr double kPartialTimeout = 1.0;   // unreliable fragment groups
+constexpr size_t kMaxPacketsPerWrite = 256;
+
+sockaddr_in toSockaddr(const NetAddress& address) {
+    sockaddr_in sa{};
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(address.ip);
+    sa.sin_port = htons(address.port);
+    return sa;
+}
+
+NetAddress fromSockaddr(const sockaddr_in& sa) {
+    return {ntohl(sa.sin_addr.s_addr), ntohs(sa.sin_port)};
+}
+
+#if defined(_WIN32)
+bool ensureWinsock() {
+    static bool ready = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return ready;
+}
+inline bool wouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+// ICMP port unreachable from a closed peer surfaces as a reset on the next receive
+inline bool transientReceiveError() { return WSAGetLastError() == WSAECONNRESET; }
+std::string socketError(const char* what) { return std::string(what) + " failed (" + std::to_string(WSAGetLastError()) + ")"; }
+#else
+inline bool wouldBlock() { return errno == EAGAIN || errno == EWOULDBLOCK; }
+inline bool transientReceiveError() { return errno == EINTR || errno == ECONNREFUSED; }
+std::string socketError(const char* what) { return std::string(what) + " failed: " + std::strerror(errno); }
+#endif
+
+}  // namespace
+
+// ===== Addresses =====
+
+bool NetAddress::resolve(const std::string& host, uint16_t port, NetAddress& out) {
+    out.port = port;
+    if (host.empty() || host == "0.0.0.0" || host == "*") {
+        out.ip = 0;
+        return true;
+    }
+#if defined(_WIN32)
+    if (!ensureWinsock()) return false;
+#endif
+    in_addr numeric{};
+    if (inet_pton(AF_INET, host.c_str(), &numeric) == 1) {
+        out.ip = ntohl(numeric.s_addr);
+        return true;
+    }
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || !result) return false;
+    out.ip = ntohl(reinterpret_cast<const sockaddr_in*>(result->ai_addr)->sin_addr.s_addr);
+    freeaddrinfo(result);
+    return true;
+}
+
+std::string NetAddress::toString() const {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%u.%u.%u.%u:%u", (ip >> 24) & 0xFF, (ip >> 16) & 0xFF,
+                  (ip >> 8) & 0xFF, ip & 0xFF, (unsigned)port);
+    return text;
+}
+
+// ===== Socket =====
+
+bool UdpSocket::open(const NetAddress& bindAddress) {
+    close();
+#if defined(_WIN32)
+    if (!ensureWinsock()) {
+        lastError_ = "WSAStartup failed";
+        return false;
+    }
+#endif
+    auto fd = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+#if defined(_WIN32)
+    if (fd == INVALID_SOCKET) {
+#else
+    if (fd < 0) {
+#endif
+        lastError_ = socketError("socket");
+        return false;
+    }
+    handle_ = (Handle)fd;
+
+    // Bursts of batched datagrams need more than the default buffers
+    int bufferSize = 4 * 1024 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&bufferSize), sizeof(bufferSize));
+    setsockopt(fd, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&bufferSize), sizeof(bufferSize));
+#if defined(_WIN32)
+    u_long nonBlocking = 1;
+    if (ioctlsocket(fd, FIONBIO, &nonBlocking) != 0) {
+#else
+    if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK) != 0) {
+#endif
+        lastError_ = socketError("set non-blocking");
+        close();
+        return false;
+    }
+
+    sockaddr_in sa = toSockaddr(bindAddress);
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&sa), sizeof(sa)) != 0) {
+        lastError_ = socketError(("bind " + bindAddress.toString()).c_str());
+        close();
+        return false;
+    }
+    socklen_t length = sizeof(sa);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&sa), &length);
+    local_ = fromSockaddr(sa);
+
+#if defined(__linux__)
+    poller_ = epoll_create1(EPOLL_CLOEXEC);
+    if (poller_ >= 0) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (epoll_ctl(poller_, EPOLL_CTL_ADD, fd, &event) != 0) {
+            ::close(poller_);
+            poller_ = -1;
+        }
+    }
+#endif
+    lastError_.clear();
+    return true;
+}
+
+void UdpSocket::close() {
+#if defined(__linux__)
+    if (poller_ >= 0) ::close(poller_);
+#endif
+    poller_ = -1;
+    if (handle_ == kInvalidHandle) return;
+#if defined(_WIN32)
+    closesocket((SOCKET)handle_);
+#else
+    ::close(handle_);
+#endif
+    handle_ = kInvalidHandle;
+    local_ = {};
+}
+
+size_t UdpSocket::sendBatch(const Datagram* const* datagrams, size_t count) {
+    if (!isOpen()) return 0;
+    size_t sent = 0;
+#if defined(LUMA_NET_MMSG)
+    constexpr size_t kBatch = 64;
+    mmsghdr messages[kBatch];
+    iovec vectors[kBatch];
+    sockaddr_in addresses[kBatch];
+    while (sent < count) {
+        size_t batch = std::min(kBatch, count - sent);
+        for (size_t i = 0; i < batch; i++) {
+            const Datagram& d = *datagrams[sent + i];
+            addresses[i] = toSockaddr(d.address);
+            vectors[i].iov_base = const_cast<uint8_t*>(d.data);
+            vectors[i].iov_len = d.size;
+            messages[i] = {};
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        int result = sendmmsg(handle_, messages, (unsigned)batch, 0);
+        if (result <= 0) {
+            if (result < 0 && errno == EINTR) continue;
+            if (result < 0 && !wouldBlock()) lastError_ = socketError("sendmmsg");
+            break;  // full send buffer: the rest is dropped like any lost datagram
+        }
+        sent += (size_t)result;
+    }
+#else
+    for (; sent < count; sent++) {
+        const Datagram& d = *datagrams[sent];
+        sockaddr_in sa = toSockaddr(d.address);
+#if defined(_WIN32)
+        int result = sendto((SOCKET)handle_, reinterpret_cast<const char*>(d.data), (int)d.size, 0,
+                            reinterpret_cast<const sockaddr*>(&sa), sizeof(sa));
+#else
+        ssize_t result = sendto(handle_, d.data, d.size, 0, reinterpret_cast<const sockaddr*>(&sa), sizeof(sa));
+#endif
+        if (result < 0) {
+            if (!wouldBlock()) lastError_ = socketError("sendto");
+            break;
+        }
+    }
+#endif
+    return sent;
+}
+
+size_t UdpSocket::receiveBatch(Datagram* out, size_t maxCount) {
+    if (!isOpen()) return 0;
+    size_t received = 0;
+#if defined(LUMA_NET_MMSG)
+    constexpr size_t kBatch = 64;
+    mmsghdr messages[kBatch];
+    iovec vectors[kBatch];
+    sockaddr_in addresses[kBatch];
+    while (received < maxCount) {
+        size_t batch = std::min(kBatch, maxCount - received);
+        for (size_t i = 0; i < batch; i++) {
+            vectors[i].iov_base = out[received + i].data;
+            vectors[i].iov_len = UDP_MAX_DATAGRAM;
+            messages[i] = {};
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        int result = recvmmsg(handle_, messages, (unsigned)batch, MSG_DONTWAIT, nullptr);
+        if (result <= 0) {
+            if (result < 0 && transientReceiveError()) continue;
+            break;
+        }
+        size_t kept = received;
+        for (int i = 0; i < result; i++) {
+            // Oversized datagrams are not ours
+            if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) continue;
+            Datagram& d = out[kept];
+            if (kept != received + (size_t)i) std::memcpy(d.data, out[received + i].data, messages[i].msg_len);
+            d.size = messages[i].msg_len;
+            d.address = fromSockaddr(addresses[i]);
+            kept++;
+        }
+        received = kept;
+        if ((size_t)result < batch) break;
+    }
+#else
+    while (received < maxCount) {
+        Datagram& d = out[received];
+        sockaddr_in sa{};
+        socklen_t length = sizeof(sa);
+#if defined(_WIN32)
+        int result = recvfrom((SOCKET)handle_, reinterpret_cast<char*>(d.data), (int)UDP_MAX_DATAGRAM, 0,
+                              reinterpret_cast<sockaddr*>(&sa), &length);
+#else
+        ssize_t result = recvfrom(handle_, d.data, UDP_MAX_DATAGRAM, 0, reinterpret_cast<sockaddr*>(&sa), &length);
+#endif
+        if (result < 0) {
+            if (transientReceiveError()) continue;
+            break;
+        }
+        d.size = (uint32_t)result;
+        d.address = fromSockaddr(sa);
+        received++;
+    }
+#endif
+    return received;
+}
+
+bool UdpSocket::wait(double timeoutSeconds) {
+    if (!isOpen()) return false;
+    int timeoutMs = (int)std::max(0.0, timeoutSeconds * 1000.0 + 0.5);
+#if defined(__linux__)
+    if (poller_ >= 0) {
+        epoll_event event;
+        return epoll_wait(poller_, &event, 1, timeoutMs) > 0;
+    }
+#endif
+#if defined(_WIN32)
+    WSAPOLLFD fd{};
+    fd.fd = (SOCKET)handle_;
+    fd.events = POLLRDNORM;
+    return WSAPoll(&fd, 1, timeoutMs) > 0;
+#else
+    pollfd fd{};
+    fd.fd = handle_;
+    fd.events = POLLIN;
+    return poll(&fd, 1, timeoutMs) > 0;
+#endif
+}
+
+// ===== Reliable Connection =====
+
+ReliableConnection::ReliableConnection()
+    : sentPackets_(kSequenceWindow), sentEntries_(kSentEntryRing), receivedSequences_(kSequenceWindow, -1) {
+    for (auto& channel : reliableChannels_) {
+        channel.sendWindow.resize(kMessageWindow);
+        channel.receiveWindow.resize(kMessageWindow);
+    }
+}
+
+bool ReliableConnection::send(NetworkChannel channel, const uint8_t* data, size_t size) {
+    if (size == 0 || size > kMaxMessageSize || channel >= NetworkChannel::Count) return false;
+    if (reliable(channel)) {
+        ReliableChannel& rc = reliableChannels_[(int)channel - (int)NetworkChannel::Reliable];
+        rc.backlog.emplace_back(data, data + size);
+        fillSendWindow(rc);
+    } else {
+        unreliableChannels_[(int)channel].queued.emplace_back(data, data + size);
+    }
+    stats_.messagesSent++;
+    return true;
+}
+
+void ReliableConnection::fillSendWindow(ReliableChannel& rc) {
+    while (!rc.backlog.empty() && (uint16_t)(rc.nextSendId - rc.oldestUnacked) < kMessageWindow) {
+        OutgoingMessage& message = rc.sendWindow[rc.nextSendId % kMessageWindow];
+        message.id = rc.nextSendId++;
+        message.valid = true;
+        message.data = std::move(rc.backlog.front());
+        rc.backlog.pop_front();
+        message.fragmentCount = (uint16_t)((message.data.size() + kFragmentSize - 1) / kFragmentSize);
+        message.fragmentsAcked = 0;
+        message.fragmentAcked.assign(message.fragmentCount, 0);
+        message.fragmentSent.assign(message.fragmentCount, -1.0);
+    }
+}
+
+size_t ReliableConnection::pendingReliable() const {
+    size_t pending = 0;
+    for (const auto& rc : reliableChannels_) {
+        pending += rc.backlog.size();
+        for (uint16_t id = rc.oldestUnacked; id != rc.nextSendId; id++) {
+            if (rc.sendWindow[id % kMessageWindow].valid) pending++;
+        }
+    }
+    return pending;
+}
+
+void ReliableConnection::writePackets(double now, const std::function<void(const uint8_t*, size_t)>& emit) {
+    uint8_t packet[kPacketHeaderSize + kPacketBudget];
+    size_t size = 0;
+    size_t packetsWritten = 0;
+    uint64_t entryStart = sentEntryHead_;
+
+    auto begin = [&]() {
+        uint32_t ackBits = 0;
+        for (uint32_t i = 1; i <= 32; i++) {
+            uint16_t sequence = (uint16_t)(remoteSequence_ - i);
+            if (receivedSequences_[sequence % kSequenceWindow] == (int32_t)sequence) ackBits |= 1u << (i - 1);
+        }
+        put16(packet, nextSequence_);
+        put16(packet + 2, remoteSequence_);
+        put32(packet + 4, anyReceived_ ? ackBits : 0);
+        packet[8] = anyReceived_ ? kHasAckFlag : 0;
+        size = kPacketHeaderSize;
+        entryStart = sentEntryHead_;
+    };
+    auto finish = [&]() {
+        SentPacket& sent = sentPackets_[nextSequence_ % kSequenceWindow];
+        sent.sequence = nextSequence_;
+        sent.valid = true;
+        sent.acked = false;
+        sent.time = now;
+        sent.firstEntry = entryStart;
+        sent.entryCount = (uint32_t)(sentEntryHead_ - entryStart);
+        emit(packet, size);
+        nextSequence_++;
+        stats_.packetsSent++;
+        stats_.bytesSent += size;
+        packetsWritten++;
+        lastSend_ = now;
+        ackOwed_ = false;
+    };
+    auto reserve = [&](size_t entrySize) {
+        if (size == 0) {
+            begin();
+        } else if (size + entrySize > kPacketHeaderSize + kPacketBudget) {
+            finish();
+            if (packetsWritten >= kMaxPacketsPerWrite) {
+                size = 0;
+                return false;
+            }
+            begin();
+        }
+        return true;
+    };
+    auto writeEntry = [&](NetworkChannel channel, uint16_t id, uint16_t fragment, uint16_t fragmentCount,
+                          const uint8_t* payload, size_t payloadSize) {
+        uint8_t* p = packet + size;
+        p[0] = (uint8_t)channel | (fragmentCount > 1 ? kFragmentedFlag : 0);
+        put16(p + 1, id);
+        put16(p + 3, (uint16_t)payloadSize);
+        size += kEntryHeaderSize;
+        if (fragmentCount > 1) {
+            put16(p + 5, fragment);
+            put16(p + 7, fragmentCount);
+            size += kFragmentHeaderSize;
+        }
+        std::memcpy(packet + size, payload, payloadSize);
+        size += payloadSize;
+    };
+
+    // Reliable fragments: never sent, or unacked for longer than the resend delay
+    const double resendDelay = std::max(0.04, stats_.rtt * 1.25 + 4.0 * rttVariance_);
+    bool budgetLeft = true;
+    for (int c = 0; c < 2 && budgetLeft; c++) {
+        ReliableChannel& rc = reliableChannels_[c];
+        NetworkChannel channel = (NetworkChannel)((int)NetworkChannel::Reliable + c);
+        for (uint16_t id = rc.oldestUnacked; id != rc.nextSendId && budgetLeft; id++) {
+            OutgoingMessage& message = rc.sendWindow[id % kMessageWindow];
+            if (!message.valid) continue;
+            for (uint16_t f = 0; f < message.fragmentCount; f++) {
+                if (message.fragmentAcked[f]) continue;
+                double sentAt = message.fragmentSent[f];
+                if (sentAt >= 0.0 && now - sentAt < resendDelay) continue;
+                size_t offset = (size_t)f * kFragmentSize;
+                size_t bytes = std::min(kFragmentSize, message.data.size() - offset);
+                size_t entrySize = kEntryHeaderSize + (message.fragmentCount > 1 ? kFragmentHeaderSize : 0) + bytes;
+                if (!reserve(entrySize)) {
+                    budgetLeft = false;
+                    break;
+                }
+                writeEntry(channel, id, f, message.fragmentCount, message.data.data() + offset, bytes);
+                sentEntries_[sentEntryHead_++ % kSentEntryRing] = {(uint8_t)channel, id, f};
+                if (sentAt >= 0.0) stats_.fragmentsResent++;
+                message.fragmentSent[f] = now;
+            }
+        }
+    }
+
+    // Unreliable messages go out once, whatever fits this update
+    for (int c = 0; c < 2; c++) {
+        UnreliableChannel& uc = unreliableChannels_[c];
+        for (const auto& data : uc.queued) {
+            uint16_t id = uc.nextSendId++;
+            uint16_t fragmentCount = (uint16_t)((data.size() + kFragmentSize - 1) / kFragmentSize);
+            for (uint16_t f = 0; f < fragmentCount && budgetLeft; f++) {
+                size_t offset = (size_t)f * kFragmentSize;
+                size_t bytes = std::min(kFragmentSize, data.size() - offset);
+                if (!reserve(kEntryHeaderSize + (fragmentCount > 1 ? kFragmentHeaderSize : 0) + bytes)) {
+                    budgetLeft = false;
+                    break;
+                }
+                writeEntry((NetworkChannel)c, id, f, fragmentCount, data.data() + offset, bytes);
+            }
+        }
+        uc.queued.clear();
+    }
+
+    if (size > 0) {
+        finish();
+    } else if (ackOwed_ || lastSend_ < 0.0 || now - lastSend_ >= kKeepaliveInterval) {
+        begin();
+        finish();
+    }
+}
+
+bool ReliableConnection::receivePacket(const uint8_t* data, size_t size, double now) {
+    if (size < kPacketHeaderSize) return false;
+    uint16_t sequence = get16(data);
+    uint16_t ack = get16(data + 2);
+    uint32_t ackBits = get32(data + 4);
+    bool hasAck = (data[8] & kHasAckFlag) != 0;
+
+    // Duplicates and packets older than the window carry nothing new
+    int32_t& slot = receivedSequences_[sequence % kSequenceWindow];
+    if (slot == (int32_t)sequence) return false;
+    if (anyReceived_ && sequenceGreater(remoteSequence_, sequence) &&
+        (uint16_t)(remoteSequence_ - sequence) >= kSequenceWindow) {
+        return false;
+    }
+    slot = sequence;
+    if (!anyReceived_ || sequenceGreater(sequence, remoteSequence_)) remoteSequence_ = sequence;
+    anyReceived_ = true;
+    ackOwed_ = true;
+    lastReceive_ = now;
+    stats_.packetsReceived++;
+    stats_.bytesReceived += size;
+
+    if (hasAck) processAck(ack, ackBits, now);
+
+    size_t pos = kPacketHeaderSize;
+    while (pos < size) {
+        if (size - pos < kEntryHeaderSize) return false;
+        uint8_t header = data[pos];
+        NetworkChannel channel = (NetworkChannel)(header & ~kFragmentedFlag);
+        if (channel >= NetworkChannel::Count) return false;
+        uint16_t id = get16(data + pos + 1);
+        uint16_t payloadSize = get16(data + pos + 3);
+        pos += kEntryHeaderSize;
+        uint16_t fragment = 0, fragmentCount = 1;
+        if (header & kFragmentedFlag) {
+            if (size - pos < kFragmentHeaderSize) return false;
+            fragment = get16(data + pos);
+            fragmentCount = get16(data + pos + 2);
+            pos += kFragmentHeaderSize;
+        }
+        if (size - pos < payloadSize) return false;
+        if (!receiveEntry(channel, id, fragment, fragmentCount, data + pos, payloadSize, now)) return false;
+        pos += payloadSize;
+    }
+    return true;
+}
+
+void ReliableConnection::processAck(uint16_t ack, uint32_t ackBits, double now) {
+    // Ignore acks for packets never sent
+    if (!sequenceGreater(nextSequence_, ack)) return;
+    for (uint32_t i = 0; i <= 32; i++) {
+        if (i > 0 && !(ackBits & (1u << (i - 1)))) continue;
+        uint16_t sequence = (uint16_t)(ack - i);
+        SentPacket& packet = sentPackets_[sequence % kSequenceWindow];
+        if (packet.valid && packet.sequence == sequence && !packet.acked) onPacketAcked(packet, now);
+    }
+    // Packets that fell out of the ack field unacked are lost
+    uint16_t horizon = (uint16_t)(ack - 32);
+    while (sequenceGreater(horizon, oldestUnchecked_) && oldestUnchecked_ != nextSequence_) {
+        const SentPacket& packet = sentPackets_[oldestUnchecked_ % kSequenceWindow];
+        if (packet.valid && packet.sequence == oldestUnchecked_ && !packet.acked) stats_.packetsLost++;
+        oldestUnchecked_++;
+    }
+}
+
+void ReliableConnection::onPacketAcked(SentPacket& packet, double now) {
+    packet.acked = true;
+    stats_.packetsAcked++;
+    double sample = now - packet.time;
+    if (stats_.rtt == 0.0) {
+        stats_.rtt = sample;
+        rttVariance_ = sample * 0.5;
+    } else {
+        rttVariance_ += (std::abs(sample - stats_.rtt) - rttVariance_) * 0.25;
+        stats_.rtt += (sample - stats_.rtt) * 0.125;
+    }
+
+    // Entries overwritten in the ring belong to messages long since resent
+    if (sentEntryHead_ - packet.firstEntry > kSentEntryRing) return;
+    for (uint32_t e = 0; e < packet.entryCount; e++) {
+        const SentEntry& entry = sentEntries_[(packet.firstEntry + e) % kSentEntryRing];
+        ReliableChannel& rc = reliableChannels_[entry.channel - (uint8_t)NetworkChannel::Reliable];
+        OutgoingMessage& message = rc.sendWindow[entry.messageId % kMessageWindow];
+        if (!message.valid || message.id != entry.messageId || message.fragmentAcked[entry.fragment]) continue;
+        message.fragmentAcked[entry.fragment] = 1;
+        if (++message.fragmentsAcked == message.fragmentCount) {
+            message.valid = false;
+            message.data = {};
+        }
+    }
+    for (auto& rc : reliableChannels_) {
+        while (rc.oldestUnacked != rc.nextSendId && !rc.sendWindow[rc.oldestUnacked % kMessageWindow].valid) {
+            rc.oldestUnacked++;
+        }
+        fillSendWindow(rc);
+    }
+}
+
+bool ReliableConnection::receiveEntry(NetworkChannel channel, uint16_t messageId, uint16_t fragment,
+                                      uint16_t fragmentCount, const uint8_t* payload, size_t size, double now) {
+    if (fragmentCount == 0 || fragment >= fragmentCount || (size_t)fragmentCount * kFragmentSize > kMaxMessageSize) {
+        return false;
+    }
+    bool last = fragment + 1 == fragmentCount;
+    if (size == 0 || size > kFragmentSize || (!last && size != kFragmentSize)) return false;
+
+    // Assembles into message; true once every fragment is in
+    auto assemble = [&](IncomingMessage& message) {
+        if (message.fragmentReceived[fragment]) return false;
+        std::memcpy(message.data.data() + (size_t)fragment * kFragmentSize, payload, size);
+        message.fragmentReceived[fragment] = 1;
+        if (last) message.size = (size_t)fragment * kFragmentSize + size;
+        if (++message.fragmentsReceived < message.fragmentCount) return false;
+        message.data.resize(message.size);
+        return true;
+    };
+    // Returns false if the reassembly budget is exhausted
+    auto start = [&](IncomingMessage& message) {
+        size_t bytes = (size_t)fragmentCount * kFragmentSize;
+        if (fragmentCount > 1 && reassemblyBytes_ + bytes > kMaxReassemblyBytes) return false;
+        if (fragmentCount > 1) reassemblyBytes_ += bytes;
+        message.id = messageId;
+        message.valid = true;
+        message.delivered = false;
+        message.fragmentCount = fragmentCount;
+        message.fragmentsReceived = 0;
+        message.fragmentReceived.assign(fragmentCount, 0);
+        message.data.resize((size_t)fragmentCount * kFragmentSize);
+        message.size = 0;
+        message.firstSeen = now;
+        return true;
+    };
+    auto release = [&](const IncomingMessage& message) {
+        if (message.fragmentCount > 1) reassemblyBytes_ -= (size_t)message.fragmentCount * kFragmentSize;
+    };
+
+    if (reliable(channel)) {
+        ReliableChannel& rc = reliableChannels_[(int)channel - (int)NetworkChannel::Reliable];
+        // Older ids were delivered already; the sender's window keeps newer
+        // ones inside ours
+        if ((uint16_t)(messageId - rc.nextReceiveId) >= kMessageWindow) return true;
+        IncomingMessage& message = rc.receiveWindow[messageId % kMessageWindow];
+        if ((!message.valid || message.id != messageId) && !start(message)) return true;
+        if (message.delivered) return true;
+        if (message.fragmentCount != fragmentCount) return false;
+        if (!assemble(message)) return true;
+        release(message);
+
+        if (channel == NetworkChannel::Reliable) {
+            deliver(channel, std::move(message.data));
+            message.data = {};
+            message.delivered = true;
+            while (true) {
+                IncomingMessage& next = rc.receiveWindow[rc.nextReceiveId % kMessageWindow];
+                if (!next.valid || next.id != rc.nextReceiveId || !next.delivered) break;
+                next.valid = false;
+                rc.nextReceiveId++;
+            }
+        } else {
+            while (true) {
+                IncomingMessage& next = rc.receiveWindow[rc.nextReceiveId % kMessageWindow];
+                if (!next.valid || next.id != rc.nextReceiveId || next.fragmentsReceived < next.fragmentCount) break;
+                deliver(channel, std::move(next.data));
+                next.data = {};
+                next.valid = false;
+                rc.nextReceiveId++;
+            }
+        }
+        return true;
+    }
+
+    UnreliableChannel& uc = unreliableChannels_[(int)channel];
+    bool sequenced = channel == NetworkChannel::UnreliableSequenced;
+    if (sequenced && uc.anyDelivered && !sequenceGreater(messageId, uc.lastDelivered)) return true;
+    auto accept = [&](std::vector<uint8_t>&& data) {
+        if (sequenced) {
+            uc.lastDelivered = messageId;
+            uc.anyDelivered = true;
+        }
+        deliver(channel, std::move(data));
+    };
+    if (fragmentCount == 1) {
+        accept(std::vector<uint8_t>(payload, payload + size));
+        return true;
+    }
+    // Incomplete groups expire; their missing fragments are never resent
+    if (uc.partial.size() >= 64) {
+        for (auto it = uc.partial.begin(); it != uc.partial.end();) {
+            if (now - it->second.firstSeen > kPartialTimeout) {
+                release(it->second);
+                it = uc.partial.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    auto found = uc.partial.find(messageId);
+    if (found == uc.partial.end()) {
+        IncomingMessage message;
+        if (!start(message)) return true;
+        found = uc.partial.emplace(messageId, std::move(message)).first;
+    }
+    if (found->second.fragmentCount != fragmentCount) return false;
+    if (assemble(found->second)) {
+        release(found->second);
+        accept(std::move(found->second.data));
+        uc.partial.erase(found);
+    }
+    return true;
+}
+
+void ReliableConnection::deliver(NetworkChannel channel, std::vector<uint8_t>&& data) {
+    delivered_.emplace_back(channel, std::move(data));
+    stats_.messagesReceived++;
+}
+
+bool ReliableConnection::popMessage(NetworkChannel& channel, std::vector<uint8_t>& out) {
+    if (delivered_.empty()) return false;
+    channel = delivered_.front().first;
+    out = std::move(delivered_.front().second);
+    delivered_.pop_front();
+    return true;
+}
+
+// ===== UDP Transport =====
+
+bool UdpTransport::open(const NetAddress& bindAddress) {
+    outgoing_.clear();
+    delayed_.clear();
+    return socket_.open(bindAddress);
+}
+
+void UdpTransport::close() {
+    socket_.close();
+    outgoing_.clear();
+    delayed_.clear();
+}
+
+void UdpTransport::setConditions(const NetworkConditions& conditions, uint32_t seed) {
+    conditions_ = conditions;
+    random_.seed(seed);
+}
+
+std::unique_ptr<Datagram> UdpTransport::acquire() {
+    if (free_.empty()) return std::make_unique<Datagram>();
+    auto datagram = std::move(free_.back());
+    free_.pop_back();
+    return datagram;
+}
+
+void UdpTransport::send(const NetAddress& to, const uint8_t* header, size_t headerSize,
+                        const uint8_t* payload, size_t payloadSize, double now) {
+    if (headerSize + payloadSize > UDP_MAX_DATAGRAM) return;
+    auto datagram = acquire();
+    datagram->address = to;
+    datagram->size = (uint32_t)(headerSize + payloadSize);
+    if (headerSize) std::memcpy(datagram->data, header, headerSize);
+    if (payloadSize) std::memcpy(datagram->data + headerSize, payload, payloadSize);
+
+    if (!conditions_.enabled()) {
+        outgoing_.push_back(std::move(datagram));
+        return;
+    }
+    std::uniform_real_distribution<float> percent(0.0f, 100.0f);
+    std::uniform_real_distribution<float> jitter(-conditions_.jitterMs, conditions_.jitterMs);
+    if (percent(random_) < conditions_.lossPercent) {
+        free_.push_back(std::move(datagram));
+        return;
+    }
+    auto delay = [&]() { return now + std::max(0.0f, conditions_.latencyMs + jitter(random_)) / 1000.0; };
+    if (percent(random_) < conditions_.duplicatePercent) {
+        auto copy = acquire();
+        copy->address = datagram->address;
+        copy->size = datagram->size;
+        std::memcpy(copy->data, datagram->data, datagram->size);
+        delayed_.push_back({delay(), std::move(copy)});
+    }
+    delayed_.push_back({delay(), std::move(datagram)});
+}
+
+void UdpTransport::flush(double now) {
+    if (!delayed_.empty()) {
+        auto due = std::partition(delayed_.begin(), delayed_.end(), [&](const Delayed& d) { return d.due > now; });
+        std::sort(due, delayed_.end(), [](const Delayed& a, const Delayed& b) { return a.due < b.due; });
+        for (auto it = due; it != delayed_.end(); ++it) outgoing_.push_back(std::move(it->datagram));
+        delayed_.erase(due, delayed_.end());
+    }
+    if (outgoing_.empty()) return;
+
+    std::vector<const Datagram*> batch;
+    batch.reserve(outgoing_.size());
+    for (const auto& datagram : outgoing_) batch.push_back(datagram.get());
+    datagramsSent_ += socket_.sendBatch(batch.data(), batch.size());
+    for (auto& datagram : outgoing_) free_.push_back(std::move(datagram));
+    outgoing_.clear();
+}
+
+void UdpTransport::receive(const std::function<void(const NetAddress&, const uint8_t*, size_t)>& handler) {
+    if (incoming_.empty()) incoming_.resize(64);
+    for (;;) {
+        size_t count = socket_.receiveBatch(incoming_.data(), incoming_.size());
+        for (size_t i = 0; i < count; i++) handler(incoming_[i].address, incoming_[i].data, incoming_[i].size);
+        datagramsReceived_ += count;
+        if (count < incoming_.size()) break;
+    }
+}
+
+bool UdpTransport::wait(double timeoutSeconds, double now) {
+    for (const Delayed& d : delayed_) timeoutSeconds = std::min(timeoutSeconds, d.due - now);
+    return socket_.wait(std::max(0.0, timeoutSeconds));
+}
+
+}  // namespace luma
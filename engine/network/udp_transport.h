@@ -0,0 +1,282 @@
+// UDP Transport - non-blocking sockets and a reliability layer over them
+// Socket: batched send/receive (sendmmsg/recvmmsg on Linux) with epoll
+// (Linux) / poll (elsewhere) readiness waits.
+// ReliableConnection: per-peer packet sequencing with acks (sequence, ack,
+// 32-bit ack field), four delivery channels and fragmentation. Reliable
+// fragments are resent until a packet carrying them is acked.
+// UdpTransport: a socket with batched flushes and optional simulated loss,
+// latency, jitter and duplication on the send path for soak tests.
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace luma {
+
+// ===== Addresses =====
+
+// IPv4 address + port, host byte order
+struct NetAddress {
+    uint32_t ip = 0;
+    uint16_t port = 0;
+
+    // Numeric dotted quad or a host name; empty / "0.0.0.0" is any
+    static bool resolve(const std::string& host, uint16_t port, NetAddress& out);
+    static NetAddress loopback(uint16_t port) { return {0x7F000001u, port}; }
+    std::string toString() const;
+    bool operator==(const NetAddress& other) const { return ip == other.ip && port == other.port; }
+    bool operator!=(const NetAddress& other) const { return !(*this == other); }
+};
+
+struct NetAddressHash {
+    size_t operator()(const NetAddress& a) const { return ((size_t)a.ip << 16) ^ a.port; }
+};
+
+// ===== Socket =====
+
+constexpr size_t UDP_MAX_DATAGRAM = 1500;
+
+struct Datagram {
+    NetAddress address;
+    uint32_t size = 0;
+    uint8_t data[UDP_MAX_DATAGRAM];
+};
+
+class UdpSocket {
+public:
+    UdpSocket() = default;
+    ~UdpSocket() { close(); }
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    // Port 0 binds an ephemeral port
+    bool open(const NetAddress& bindAddress);
+    void close();
+    bool isOpen() const { return handle_ != kInvalidHandle; }
+    const NetAddress& getLocalAddress() const { return local_; }
+
+    // Returns the number of datagrams handed to the kernel
+    size_t sendBatch(const Datagram* const* datagrams, size_t count);
+    // Non-blocking; returns the number received
+    size_t receiveBatch(Datagram* out, size_t maxCount);
+    // True if a datagram is ready within the timeout
+    bool wait(double timeoutSeconds);
+
+    const std::string& getLastError() const { return lastError_; }
+
+private:
+#if defined(_WIN32)
+    using Handle = uintptr_t;
+    static constexpr Handle kInvalidHandle = ~(Handle)0;
+#else
+    using Handle = int;
+    static constexpr Handle kInvalidHandle = -1;
+#endif
+    Handle handle_ = kInvalidHandle;
+    int poller_ = -1;  // epoll instance on Linux
+    NetAddress local_;
+    std::string lastError_;
+};
+
+// ===== Simulated Conditions =====
+
+struct NetworkConditions {
+    float lossPercent = 0.0f;
+    float latencyMs = 0.0f;       // one way
+    float jitterMs = 0.0f;        // +/- uniform, reorders packets
+    float duplicatePercent = 0.0f;
+
+    bool enabled() const { return lossPercent > 0 || latencyMs > 0 || jitterMs > 0 || duplicatePercent > 0; }
+};
+
+// ===== Channels =====
+
+enum class NetworkChannel : uint8_t {
+    Unreliable = 0,           // may drop, may reorder
+    UnreliableSequenced = 1,  // may drop, never older than the last delivered
+    Reliable = 2,             // exactly once, any order
+    ReliableOrdered = 3,      // exactly once, in send order
+    Count = 4
+};
+
+struct ReliableConnectionStats {
+    uint64_t packetsSent = 0;
+    uint64_t packetsReceived = 0;
+    uint64_t packetsAcked = 0;
+    uint64_t packetsLost = 0;
+    uint64_t bytesSent = 0;
+    uint64_t bytesReceived = 0;
+    uint64_t messagesSent = 0;
+    uint64_t messagesReceived = 0;
+    uint64_t fragmentsResent = 0;
+    double rtt = 0.0;  // smoothed, seconds
+};
+
+// ===== Reliable Connection =====
+// Transport-agnostic: feed it received packets, drain packets to send.
+// Data packet layout (little endian):
+//   u16 sequence, u16 ack, u32 ackBits, u8 flags, then entries until the end:
+//   u8 channel | 0x80 if fragmented, u16 message id, u16 size,
+//   [u16 fragment index, u16 fragment count], payload
+class ReliableConnection {
+public:
+    static constexpr size_t kPacketBudget = 1200;   // payload bytes per datagram
+    static constexpr size_t kFragmentSize = 1024;
+    static constexpr uint32_t kSequenceWindow = 1024;
+    static constexpr uint32_t kMessageWindow = 1024;
+    static constexpr size_t kMaxMessageSize = kFragmentSize * 4096;
+
+    ReliableConnection();
+
+    // Queues a message; false if it is empty or over kMaxMessageSize
+    bool send(NetworkChannel channel, const uint8_t* data, size_t size);
+    // Processes one received data packet; false if malformed or stale
+    bool receivePacket(const uint8_t* data, size_t size, double now);
+    // Next delivered message, if any
+    bool popMessage(NetworkChannel& channel, std::vector<uint8_t>& out);
+
+    // Writes due packets (new and resent fragments, then unreliable
+    // messages; a bare ack packet if nothing else but acks are owed or the
+    // keepalive interval passed)
+    void writePackets(double now, const std::function<void(const uint8_t*, size_t)>& emit);
+
+    double getLastReceiveTime() const { return lastReceive_; }
+    void setLastReceiveTime(double now) { lastReceive_ = now; }
+    const ReliableConnectionStats& stats() const { return stats_; }
+    // Reliable messages still waiting for acks (or for window space)
+    size_t pendingReliable() const;
+
+private:
+    struct SentPacket {
+        uint16_t sequence = 0;
+        bool valid = false;
+        bool acked = false;
+        double time = 0.0;
+        uint64_t firstEntry = 0;  // absolute index into the sentEntries_ ring
+        uint32_t entryCount = 0;
+    };
+    struct SentEntry {
+        uint8_t channel;
+        uint16_t messageId;
+        uint16_t fragment;
+    };
+    struct OutgoingMessage {
+        uint16_t id = 0;
+        bool valid = false;
+        std::vector<uint8_t> data;
+        uint16_t fragmentCount = 0;
+        uint16_t fragmentsAcked = 0;
+        std::vector<uint8_t> fragmentAcked;
+        std::vector<double> fragmentSent;  // < 0 never sent
+    };
+    struct IncomingMessage {
+        uint16_t id = 0;
+        bool valid = false;
+        bool delivered = false;
+        std::vector<uint8_t> data;
+        size_t size = 0;  // known once the last fragment arrives
+        uint16_t fragmentCount = 0;
+        uint16_t fragmentsReceived = 0;
+        std::vector<uint8_t> fragmentReceived;
+        double firstSeen = 0.0;
+    };
+    struct ReliableChannel {
+        std::vector<OutgoingMessage> sendWindow;  // by id % kMessageWindow
+        std::deque<std::vector<uint8_t>> backlog; // waiting for window space
+        uint16_t nextSendId = 0;
+        uint16_t oldestUnacked = 0;
+        std::vector<IncomingMessage> receiveWindow;
+        uint16_t nextReceiveId = 0;               // everything older was delivered
+    };
+    struct UnreliableChannel {
+        std::vector<std::vector<uint8_t>> queued;
+        uint16_t nextSendId = 0;
+        std::unordered_map<uint16_t, IncomingMessage> partial;
+        uint16_t lastDelivered = 0;
+        bool anyDelivered = false;
+    };
+
+    bool reliable(NetworkChannel channel) const {
+        return channel == NetworkChannel::Reliable || channel == NetworkChannel::ReliableOrdered;
+    }
+    void processAck(uint16_t ack, uint32_t ackBits, double now);
+    void onPacketAcked(SentPacket& packet, double now);
+    void fillSendWindow(ReliableChannel& channel);
+    bool receiveEntry(NetworkChannel channel, uint16_t messageId, uint16_t fragment, uint16_t fragmentCount,
+                      const uint8_t* payload, size_t size, double now);
+    void deliver(NetworkChannel channel, std::vector<uint8_t>&& data);
+
+    // Packet-level sequencing
+    uint16_t nextSequence_ = 0;
+    std::vector<SentPacket> sentPackets_;         // by sequence % kSequenceWindow
+    std::vector<SentEntry> sentEntries_;          // ring of reliable entries
+    uint64_t sentEntryHead_ = 0;
+    uint16_t oldestUnchecked_ = 0;                // loss accounting cursor
+    std::vector<int32_t> receivedSequences_;      // by sequence % kSequenceWindow, -1 empty
+    uint16_t remoteSequence_ = 0;
+    bool anyReceived_ = false;
+    bool ackOwed_ = false;
+    double lastSend_ = -1.0;
+    double lastReceive_ = 0.0;
+    double rttVariance_ = 0.0;
+    size_t reassemblyBytes_ = 0;                  // buffers of incomplete fragmented messages
+
+    ReliableChannel reliableChannels_[2];         // Reliable, ReliableOrdered
+    UnreliableChannel unreliableChannels_[2];     // Unreliable, UnreliableSequenced
+    std::deque<std::pair<NetworkChannel, std::vector<uint8_t>>> delivered_;
+    ReliableConnectionStats stats_;
+};
+
+// ===== UDP Transport =====
+// A socket plus an optional simulator on the send path. Sends are queued
+// and handed to the kernel in batches on flush().
+class UdpTransport {
+public:
+    bool open(const NetAddress& bindAddress);
+    void close();
+    bool isOpen() const { return socket_.isOpen(); }
+    const NetAddress& getLocalAddress() const { return socket_.getLocalAddress(); }
+    const std::string& getLastError() const { return socket_.getLastError(); }
+
+    void setConditions(const NetworkConditions& conditions, uint32_t seed = 1);
+    const NetworkConditions& getConditions() const { return conditions_; }
+
+    // Header and payload are concatenated into one datagram
+    void send(const NetAddress& to, const uint8_t* header, size_t headerSize,
+              const uint8_t* payload, size_t payloadSize, double now);
+    void flush(double now);
+    // Drains every datagram currently readable
+    void receive(const std::function<void(const NetAddress&, const uint8_t*, size_t)>& handler);
+    // Blocks until a datagram is readable, a simulated one is due, or the timeout
+    bool wait(double timeoutSeconds, double now);
+
+    uint64_t getDatagramsSent() const { return datagramsSent_; }
+    uint64_t getDatagramsReceived() const { return datagramsReceived_; }
+
+private:
+    struct Delayed {
+        double due;
+        std::unique_ptr<Datagram> datagram;
+    };
+
+    std::unique_ptr<Datagram> acquire();
+
+    UdpSocket socket_;
+    NetworkConditions conditions_;
+    std::mt19937 random_{1};
+    std::vector<std::unique_ptr<Datagram>> outgoing_;
+    std::vector<Delayed> delayed_;                 // simulated, unsorted
+    std::vector<std::unique_ptr<Datagram>> free_;
+    std::vector<Datagram> incoming_;
+    uint64_t datagramsSent_ = 0;
+    uint64_t datagramsReceived_ = 0;
+};
+
+}  // namespace luma
@@ -5,6 +5,7 @@
 #include <string>
 #include <cstdint>
 #include <cmath>
+#include <memory>
 #include "engine/foundation/math_types.h"
 
 namespace luma {
@@ -28,6 +29,22 @@ struct SkinnedVertex {
     float boneWeights[4] = {0.0f, 0.0f, 0.0f, 0.0f};
 };
 
+// GPU storage format of a texture. BCn formats store 4x4 pixel blocks.
+enum class TextureFormat : uint8_t {
+    RGBA8 = 0,
+    BC1,        // RGB, 8 bytes/block
+    BC3,        // RGBA, 16 bytes/block
+    BC5,        // Two channels (normal XY), 16 bytes/block
+    BC7         // RGBA, 16 bytes/block
+};
+
+// One level of a cooked mip chain
+struct TextureMip {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> data;
+};
+
 // Texture data loaded from file
 struct TextureData {
     std::vector<uint8_t> pixels;
@@ -35,8 +52,39 @@ struct TextureData {
     int height = 0;
     int channels = 4;  // RGBA
     std::string path;
+
+    // Cooked textures (see texture_compression.h) carry a mip chain in
+    // `format`, level 0 first, and leave `pixels` empty
+    TextureFormat format = TextureFormat::RGBA8;
+    std::vector<TextureMip> mips;
+
+    bool isCooked() const { return !mips.empty(); }
+
+    size_t byteSize() const {
+        size_t bytes = pixels.size();
+        for (const auto& mip : mips) bytes += mip.data.size();
+        return bytes;
+    }
 };
 
+// Shared, immutable texture. Meshes reference textures by handle so that
+// materials using the same image share one decoded copy (see TextureCache).
+using TextureHandle = std::shared_ptr<const TextureData>;
+
+inline TextureHandle makeTexture(TextureData data) {
+    return std::make_shared<const TextureData>(std::move(data));
+}
+
+inline bool hasPixels(const TextureHandle& tex) {
+    return tex && (!tex->pixels.empty() || tex->isCooked());
+}
+
+// Texture contents, or an empty TextureData for a null handle
+inline const TextureData& textureData(const TextureHandle& tex) {
+    static const TextureData empty;
+    return tex ? *tex : empty;
+}
+
 struct Mesh {
     std::vector<Vertex> vertices;
     std::vector<uint32_t> indices;
@@ -46,9 +94,9 @@ struct Mesh {
     bool hasSkeleton = false;
     
     // PBR Textures (optional)
-    TextureData diffuseTexture;      // Base color / Albedo
-    TextureData normalTexture;       // Normal map
-    TextureData specularTexture;     // Specular / Metallic-Roughness
+    TextureHandle diffuseTexture;    // Base color / Albedo
+    TextureHandle normalTexture;     // Normal map
+    TextureHandle specularTexture;   // Specular / Metallic-Roughness
     bool hasDiffuseTexture = false;
     bool hasNormalTexture = false;
     bool hasSpecularTexture = false;
@@ -1,6 +1,7 @@
 // PBR Renderer Implementation (DX12)
 #include "pbr_renderer.h"
 #include "engine/asset/model_loader.h"
+#include "engine/asset/texture_compression.h"
 
 #include <iostream>
 #include <cmath>
@@ -14,6 +15,18 @@
 
 namespace luma {
 
+// ===== Texture Formats =====
+// Cooked textures keep their block format on the GPU; BC1-BC7 are core in D3D12
+static DXGI_FORMAT dxgiTextureFormat(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::BC1: return DXGI_FORMAT_BC1_UNORM;
+        case TextureFormat::BC3: return DXGI_FORMAT_BC3_UNORM;
+        case TextureFormat::BC5: return DXGI_FORMAT_BC5_UNORM;
+        case TextureFormat::BC7: return DXGI_FORMAT_BC7_UNORM;
+        default: return DXGI_FORMAT_R8G8B8A8_UNORM;
+    }
+}
+
 // ===== PBR Shader =====
 static const char* kPBRShaderSource = R"(
 cbuffer ConstantBuffer : register(b0) {
@@ -584,36 +597,63 @@ struct PBRRenderer::Impl {
         axisVbv.StrideInBytes = sizeof(LineVertex);
     }
     
+    // Plain textures upload level 0 as RGBA8, cooked ones their whole mip chain
     ComPtr<ID3D12Resource> uploadTexture(const TextureData& tex, UINT& outSrvIndex) {
-        if (tex.pixels.empty()) {
+        const bool cooked = tex.isCooked();
+        const UINT levels = cooked ? static_cast<UINT>(tex.mips.size()) : 1;
+        bool valid = cooked || tex.pixels.size() >= static_cast<size_t>(tex.width) * tex.height * 4;
+        for (UINT level = 0; cooked && level < levels; level++) {
+            const TextureMip& mip = tex.mips[level];
+            valid = valid && mip.data.size() >= textureLevelSize(tex.format, mip.width, mip.height);
+        }
+        if (!valid || tex.width <= 0 || tex.height <= 0) {
             outSrvIndex = defaultTextureSrvIndex;
             return defaultTexture;
         }
         
-        const UINT w = tex.width, h = tex.height;
+        // BCn top levels must be whole blocks; other sizes go up decoded
+        std::vector<std::vector<uint8_t>> decoded;
+        if (cooked && isBlockCompressed(tex.format) && (tex.width % 4 != 0 || tex.height % 4 != 0)) {
+            for (UINT level = 0; level < levels; level++) decoded.push_back(textureLevelRGBA8(tex, level));
+        }
+        const DXGI_FORMAT format = cooked && decoded.empty() ? dxgiTextureFormat(tex.format) : DXGI_FORMAT_R8G8B8A8_UNORM;
         
         D3D12_HEAP_PROPERTIES heapProps{}; heapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
         D3D12_RESOURCE_DESC texDesc{};
         texDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-        texDesc.Width = w; texDesc.Height = h; texDesc.DepthOrArraySize = 1; texDesc.MipLevels = 1;
-        texDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM; texDesc.SampleDesc.Count = 1;
+        texDesc.Width = tex.width; texDesc.Height = tex.height; texDesc.DepthOrArraySize = 1;
+        texDesc.MipLevels = static_cast<UINT16>(levels);
+        texDesc.Format = format; texDesc.SampleDesc.Count = 1;
         
         ComPtr<ID3D12Resource> texture;
         device->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &texDesc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&texture));
         
+        // Row counts and sizes are in block rows for BCn levels
+        std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> layouts(levels);
+        std::vector<UINT> rowCounts(levels);
+        std::vector<UINT64> rowSizes(levels);
+        UINT64 uploadSize = 0;
+        device->GetCopyableFootprints(&texDesc, 0, levels, 0, layouts.data(), rowCounts.data(),
+                                      rowSizes.data(), &uploadSize);
+        
         D3D12_HEAP_PROPERTIES uploadHeap{}; uploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
         D3D12_RESOURCE_DESC bufDesc{}; bufDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-        UINT rowPitch = (w * 4 + 255) & ~255;
-        bufDesc.Width = rowPitch * h; bufDesc.Height = 1; bufDesc.DepthOrArraySize = 1; bufDesc.MipLevels = 1;
+        bufDesc.Width = uploadSize; bufDesc.Height = 1; bufDesc.DepthOrArraySize = 1; bufDesc.MipLevels = 1;
         bufDesc.SampleDesc.Count = 1; bufDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
         
         ComPtr<ID3D12Resource> uploadBuf;
         device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadBuf));
         
-        void* mapped;
-        uploadBuf->Map(0, nullptr, &mapped);
-        for (UINT row = 0; row < h; row++) {
-            memcpy((uint8_t*)mapped + row * rowPitch, tex.pixels.data() + row * w * 4, w * 4);
+        uint8_t* mapped;
+        uploadBuf->Map(0, nullptr, reinterpret_cast<void**>(&mapped));
+        for (UINT level = 0; level < levels; level++) {
+            const uint8_t* src = !decoded.empty() ? decoded[level].data()
+                                 : cooked ? tex.mips[level].data.data() : tex.pixels.data();
+            const size_t rowSize = static_cast<size_t>(rowSizes[level]);
+            for (UINT row = 0; row < rowCounts[level]; row++) {
+                memcpy(mapped + layouts[level].Offset + row * layouts[level].Footprint.RowPitch,
+                       src + row * rowSize, rowSize);
+            }
         }
         uploadBuf->Unmap(0, nullptr);
         
@@ -622,13 +662,14 @@ struct PBRRenderer::Impl {
         allocators[0]->Reset();
         cmdList->Reset(allocators[0].Get(), nullptr);
         
-        D3D12_TEXTURE_COPY_LOCATION dst{}, src{};
-        dst.pResource = texture.Get(); dst.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-        src.pResource = uploadBuf.Get(); src.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-        src.PlacedFootprint.Footprint.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        src.PlacedFootprint.Footprint.Width = w; src.PlacedFootprint.Footprint.Height = h;
-        src.PlacedFootprint.Footprint.Depth = 1; src.PlacedFootprint.Footprint.RowPitch = rowPitch;
-        cmdList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+        for (UINT level = 0; level < levels; level++) {
+            D3D12_TEXTURE_COPY_LOCATION dst{}, src{};
+            dst.pResource = texture.Get(); dst.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+            dst.SubresourceIndex = level;
+            src.pResource = uploadBuf.Get(); src.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+            src.PlacedFootprint = layouts[level];
+            cmdList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+        }
         
         D3D12_RESOURCE_BARRIER barrier{}; barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
         barrier.Transition.pResource = texture.Get();
@@ -646,8 +687,8 @@ struct PBRRenderer::Impl {
         D3D12_CPU_DESCRIPTOR_HANDLE srvHandle = srvHeap->GetCPUDescriptorHandleForHeapStart();
         srvHandle.ptr += outSrvIndex * srvDescSize;
         D3D12_SHADER_RESOURCE_VIEW_DESC srvViewDesc{}; srvViewDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvViewDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM; srvViewDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-        srvViewDesc.Texture2D.MipLevels = 1;
+        srvViewDesc.Format = format; srvViewDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+        srvViewDesc.Texture2D.MipLevels = levels;
         device->CreateShaderResourceView(texture.Get(), &srvViewDesc, srvHandle);
         
         return texture;
@@ -830,12 +871,12 @@ GPUMesh PBRRenderer::uploadMesh(const Mesh& mesh) {
     gpu.ibv.Format = DXGI_FORMAT_R32_UINT;
     
     // Textures
-    gpu.diffuseTexture = impl_->uploadTexture(mesh.diffuseTexture, gpu.diffuseSrvIndex);
-    gpu.hasDiffuseTexture = !mesh.diffuseTexture.pixels.empty();
-    gpu.normalTexture = impl_->uploadTexture(mesh.normalTexture, gpu.normalSrvIndex);
-    gpu.hasNormalTexture = !mesh.normalTexture.pixels.empty();
-    gpu.specularTexture = impl_->uploadTexture(mesh.specularTexture, gpu.specularSrvIndex);
-    gpu.hasSpecularTexture = !mesh.specularTexture.pixels.empty();
+    gpu.diffuseTexture = impl_->uploadTexture(textureData(mesh.diffuseTexture), gpu.diffuseSrvIndex);
+    gpu.hasDiffuseTexture = hasPixels(mesh.diffuseTexture);
+    gpu.normalTexture = impl_->uploadTexture(textureData(mesh.normalTexture), gpu.normalSrvIndex);
+    gpu.hasNormalTexture = hasPixels(mesh.normalTexture);
+    gpu.specularTexture = impl_->uploadTexture(textureData(mesh.specularTexture), gpu.specularSrvIndex);
+    gpu.hasSpecularTexture = hasPixels(mesh.specularTexture);
     
     return gpu;
 }
@@ -857,7 +898,7 @@ bool PBRRenderer::loadModel(const std::string& path, LoadedModel& outModel) {
         const auto& mesh = result->meshes[i];
         std::cout << "[luma] Uploading mesh " << i << " (" << mesh.vertices.size() << " verts)" << std::endl;
         outModel.meshes.push_back(uploadMesh(mesh));
-        if (!mesh.diffuseTexture.pixels.empty()) outModel.textureCount++;
+        if (hasPixels(mesh.diffuseTexture)) outModel.textureCount++;
     }
     
     outModel.center[0] = (result->minBounds[0] + result->maxBounds[0]) / 2.0f;
@@ -6,8 +6,39 @@
 #include "rhi_resources.h"
 #include "rhi_device.h"
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+
 namespace luma::rhi {
 
+// ===== Backend =====
+
+// Backbuffer states tracked by the render graph (order matches
+// render_graph::Barrier::State)
+enum class ResourceState {
+    Undefined,
+    Present,
+    ColorAttachment
+};
+
+// Minimal per-platform backend driven by the render graph
+class Backend {
+public:
+    virtual ~Backend() = default;
+
+    virtual void render_clear(float r, float g, float b) = 0;
+    virtual void present() = 0;
+    virtual void transition_backbuffer(ResourceState /*before*/, ResourceState /*after*/) {}
+    virtual void bind_material_params(const std::unordered_map<std::string, std::string>& /*params*/) {}
+};
+
+std::unique_ptr<Backend> create_dx12_backend(const NativeWindow& window);
+std::unique_ptr<Backend> create_metal_backend(const NativeWindow& window);
+std::unique_ptr<Backend> create_vulkan_backend(const NativeWindow& window);
+// Headless CPU rasterizer (see software_backend.h); always available
+std::unique_ptr<Backend> create_software_backend(const NativeWindow& window);
+
 // ===== Utility Functions =====
 
 // Get the appropriate backend for the current platform
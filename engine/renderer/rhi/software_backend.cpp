@@ -0,0 +1,915 @@
+// Software Backend Implementation
+#include "software_backend.h"
+#include "engine/foundation/worker_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LUMA_SWR_SSE 1
+#elif defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define LUMA_SWR_NEON 1
+#endif
+
+namespace luma::rhi {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// ===== 4-wide Lanes =====
+// Four horizontally adjacent pixels per step. Masks are all-ones lanes.
+#if defined(LUMA_SWR_SSE)
+using Float4 = __m128;
+inline Float4 set4(float v) { return _mm_set1_ps(v); }
+inline Float4 set4(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+inline Float4 load4(const float* p) { return _mm_load_ps(p); }
+inline void store4(float* p, Float4 v) { _mm_store_ps(p, v); }
+inline Float4 add4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 sub4(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+inline Float4 mul4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 div4(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+inline Float4 sqrt4(Float4 v) { return _mm_sqrt_ps(v); }
+inline Float4 min4(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+inline Float4 max4(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+inline Float4 cmpge4(Float4 a, Float4 b) { return _mm_cmpge_ps(a, b); }
+inline Float4 cmplt4(Float4 a, Float4 b) { return _mm_cmplt_ps(a, b); }
+inline Float4 and4(Float4 a, Float4 b) { return _mm_and_ps(a, b); }
+inline bool any4(Float4 mask) { return _mm_movemask_ps(mask) != 0; }
+inline Float4 select4(Float4 mask, Float4 a, Float4 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+inline void selectStore4(uint32_t* p, Float4 mask, uint32_t value) {
+    __m128i m = _mm_castps_si128(mask);
+    __m128i old = _mm_load_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i v = _mm_set1_epi32((int)value);
+    _mm_store_si128(reinterpret_cast<__m128i*>(p), _mm_or_si128(_mm_and_si128(m, v), _mm_andnot_si128(m, old)));
+}
+#elif defined(LUMA_SWR_NEON)
+struct Float4 { float32x4_t v; };
+inline Float4 set4(float v) { return {vdupq_n_f32(v)}; }
+inline Float4 set4(float a, float b, float c, float d) {
+    const float lanes[4] = {a, b, c, d};
+    return {vld1q_f32(lanes)};
+}
+inline Float4 load4(const float* p) { return {vld1q_f32(p)}; }
+inline void store4(float* p, Float4 v) { vst1q_f32(p, v.v); }
+inline Float4 add4(Float4 a, Float4 b) { return {vaddq_f32(a.v, b.v)}; }
+inline Float4 sub4(Float4 a, Float4 b) { return {vsubq_f32(a.v, b.v)}; }
+inline Float4 mul4(Float4 a, Float4 b) { return {vmulq_f32(a.v, b.v)}; }
+inline Float4 div4(Float4 a, Float4 b) { return {vdivq_f32(a.v, b.v)}; }
+inline Float4 sqrt4(Float4 v) { return {vsqrtq_f32(v.v)}; }
+inline Float4 min4(Float4 a, Float4 b) { return {vminq_f32(a.v, b.v)}; }
+inline Float4 max4(Float4 a, Float4 b) { return {vmaxq_f32(a.v, b.v)}; }
+inline Float4 cmpge4(Float4 a, Float4 b) { return {vreinterpretq_f32_u32(vcgeq_f32(a.v, b.v))}; }
+inline Float4 cmplt4(Float4 a, Float4 b) { return {vreinterpretq_f32_u32(vcltq_f32(a.v, b.v))}; }
+inline Float4 and4(Float4 a, Float4 b) {
+    return {vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v)))};
+}
+inline bool any4(Float4 mask) { return vmaxvq_u32(vreinterpretq_u32_f32(mask.v)) != 0; }
+inline Float4 select4(Float4 mask, Float4 a, Float4 b) {
+    return {vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v)};
+}
+inline void selectStore4(uint32_t* p, Float4 mask, uint32_t value) {
+    vst1q_u32(p, vbslq_u32(vreinterpretq_u32_f32(mask.v), vdupq_n_u32(value), vld1q_u32(p)));
+}
+#else
+struct Float4 { float v[4]; };
+inline Float4 set4(float x) { return {{x, x, x, x}}; }
+inline Float4 set4(float a, float b, float c, float d) { return {{a, b, c, d}}; }
+inline Float4 load4(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store4(float* p, Float4 a) { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+inline Float4 add4(Float4 a, Float4 b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+inline Float4 sub4(Float4 a, Float4 b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+inline Float4 mul4(Float4 a, Float4 b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+inline Float4 div4(Float4 a, Float4 b) { return {{a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3]}}; }
+inline Float4 sqrt4(Float4 a) { return {{std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3])}}; }
+inline Float4 min4(Float4 a, Float4 b) {
+    return {{std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1]), std::min(a.v[2], b.v[2]), std::min(a.v[3], b.v[3])}};
+}
+inline Float4 max4(Float4 a, Float4 b) {
+    return {{std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3])}};
+}
+inline Float4 maskOf(bool b0, bool b1, bool b2, bool b3) {
+    Float4 r;
+    const bool bits[4] = {b0, b1, b2, b3};
+    for (int i = 0; i < 4; i++) {
+        uint32_t u = bits[i] ? 0xFFFFFFFFu : 0u;
+        std::memcpy(&r.v[i], &u, 4);
+    }
+    return r;
+}
+inline bool lane(Float4 mask, int i) {
+    uint32_t u;
+    std::memcpy(&u, &mask.v[i], 4);
+    return u != 0;
+}
+inline Float4 cmpge4(Float4 a, Float4 b) {
+    return maskOf(a.v[0] >= b.v[0], a.v[1] >= b.v[1], a.v[2] >= b.v[2], a.v[3] >= b.v[3]);
+}
+inline Float4 cmplt4(Float4 a, Float4 b) {
+    return maskOf(a.v[0] < b.v[0], a.v[1] < b.v[1], a.v[2] < b.v[2], a.v[3] < b.v[3]);
+}
+inline Float4 and4(Float4 a, Float4 b) {
+    return maskOf(lane(a, 0) && lane(b, 0), lane(a, 1) && lane(b, 1), lane(a, 2) && lane(b, 2), lane(a, 3) && lane(b, 3));
+}
+inline bool any4(Float4 mask) { return lane(mask, 0) || lane(mask, 1) || lane(mask, 2) || lane(mask, 3); }
+inline Float4 select4(Float4 mask, Float4 a, Float4 b) {
+    return {{lane(mask, 0) ? a.v[0] : b.v[0], lane(mask, 1) ? a.v[1] : b.v[1],
+             lane(mask, 2) ? a.v[2] : b.v[2], lane(mask, 3) ? a.v[3] : b.v[3]}};
+}
+inline void selectStore4(uint32_t* p, Float4 mask, uint32_t value) {
+    for (int i = 0; i < 4; i++) if (lane(mask, i)) p[i] = value;
+}
+#endif
+
+// ===== Pipeline Data =====
+
+constexpr int kTile = SoftwareBackend::kTileSize;
+constexpr int kTilePixels = kTile * kTile;
+constexpr uint32_t kNoTriangle = 0xFFFFFFFFu;
+constexpr size_t kTrianglesPerChunk = 2048;
+
+// Vertex shader outputs used by the pixel stage
+struct ShadeVertex {
+    float worldPos[3];
+    float normal[3];
+    float uv[2];
+    float color[3];
+};
+
+// Clip-space vertex carrying its barycentrics in the source triangle, so
+// triangles produced by near-plane clipping still shade from the originals
+struct ClipVertex {
+    float x, y, z, w;
+    float b1, b2;
+};
+
+// A screen-space triangle ready for rasterization. Edge j yields the
+// screen-space barycentric of corner j: (dx * (py - oy) - dy * (px - ox)) *
+// scale. Endpoints are put in a canonical order, so two triangles sharing
+// an edge compute the same product and differ only in the sign of scale;
+// with the top-left rule that makes shared edges watertight.
+struct SetupTriangle {
+    float edgeOX[3], edgeOY[3], edgeDX[3], edgeDY[3];
+    float edgeScale[3];
+    float edgeBias[3];   // 0 on top-left edges, FLT_MIN elsewhere (fill rule)
+    float depth0, depthD1, depthD2;  // z = depth0 + depthD1 * l1 + depthD2 * l2
+    float invW[3];
+    float srcB1[3], srcB2[3];
+    uint32_t vertex[3];  // global ShadeVertex ids
+    uint32_t draw;
+    int minX, minY, maxX, maxY;  // inclusive pixel bounds
+};
+
+inline float dot3(const float* a, const float* b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+
+inline void normalize3(float* v) {
+    float len2 = dot3(v, v);
+    float inv = len2 > 1e-20f ? 1.0f / std::sqrt(len2) : 0.0f;
+    v[0] *= inv; v[1] *= inv; v[2] *= inv;
+}
+
+inline uint32_t packColor(float r, float g, float b) {
+    auto q = [](float v) { return (uint32_t)(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f); };
+    return q(r) | (q(g) << 8) | (q(b) << 16) | 0xFF000000u;
+}
+
+// Right-handed look-at (camera looks down -Z)
+Mat4 lookAtRH(const Vec3& eye, const Vec3& target, const Vec3& up) {
+    Vec3 f = (target - eye).normalized();
+    Vec3 s = f.cross(up).normalized();
+    if (s.lengthSquared() < 1e-12f) s = f.cross(Vec3(0.0f, 0.0f, 1.0f)).normalized();
+    Vec3 u = s.cross(f);
+    Mat4 m;
+    m(0, 0) = s.x;  m(0, 1) = s.y;  m(0, 2) = s.z;  m(0, 3) = -s.dot(eye);
+    m(1, 0) = u.x;  m(1, 1) = u.y;  m(1, 2) = u.z;  m(1, 3) = -u.dot(eye);
+    m(2, 0) = -f.x; m(2, 1) = -f.y; m(2, 2) = -f.z; m(2, 3) = f.dot(eye);
+    return m;
+}
+
+// Right-handed perspective with D3D depth range [0, 1]
+Mat4 perspectiveRH(float fovY, float aspect, float nearZ, float farZ) {
+    float yScale = 1.0f / std::tan(fovY * 0.5f);
+    Mat4 m;
+    m(0, 0) = yScale / aspect;
+    m(1, 1) = yScale;
+    m(2, 2) = farZ / (nearZ - farZ);
+    m(2, 3) = nearZ * farZ / (nearZ - farZ);
+    m(3, 2) = -1.0f;
+    m(3, 3) = 0.0f;
+    return m;
+}
+
+// std::floor is a library call on baseline x86-64
+inline int floorToInt(float v) {
+    int i = (int)v;
+    return i - (v < (float)i ? 1 : 0);
+}
+
+// Bilinear, wrapped lookup into an uncooked RGB(A)8 texture
+void sampleTexture(const TextureData& tex, float u, float v, float* rgb) {
+    float fx = (u - (float)floorToInt(u)) * tex.width - 0.5f;
+    float fy = (v - (float)floorToInt(v)) * tex.height - 0.5f;
+    int x0 = floorToInt(fx), y0 = floorToInt(fy);
+    float tx = fx - x0, ty = fy - y0;
+    int x1 = x0 + 1, y1 = y0 + 1;
+    if (x0 < 0) x0 += tex.width;
+    if (y0 < 0) y0 += tex.height;
+    if (x1 >= tex.width) x1 -= tex.width;
+    if (y1 >= tex.height) y1 -= tex.height;
+    const int ch = tex.channels;
+    const uint8_t* row0 = tex.pixels.data() + (size_t)y0 * tex.width * ch;
+    const uint8_t* row1 = tex.pixels.data() + (size_t)y1 * tex.width * ch;
+    for (int c = 0; c < 3; c++) {
+        float top = row0[x0 * ch + c] + (row0[x1 * ch + c] - row0[x0 * ch + c]) * tx;
+        float bottom = row1[x0 * ch + c] + (row1[x1 * ch + c] - row1[x0 * ch + c]) * tx;
+        rgb[c] = (top + (bottom - top) * ty) * (1.0f / 255.0f);
+    }
+}
+
+// Projects a (clipped) triangle to pixel space and builds its edge and
+// depth data. False if it is back-facing, degenerate or its bounds hold no
+// pixel center.
+bool setupTriangle(const ClipVertex* const v[3], const uint32_t vertex[3], uint32_t draw,
+                   uint32_t width, uint32_t height, bool cullBack, SetupTriangle& tri) {
+    float sx[3], sy[3], sz[3], iw[3];
+    for (int j = 0; j < 3; j++) {
+        iw[j] = 1.0f / v[j]->w;
+        sx[j] = (v[j]->x * iw[j] * 0.5f + 0.5f) * (float)width;
+        sy[j] = (0.5f - v[j]->y * iw[j] * 0.5f) * (float)height;
+        sz[j] = v[j]->z * iw[j];
+    }
+    // Signed area in y-down pixel space; counter-clockwise (front-facing)
+    // triangles come out negative
+    float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sx[2] - sx[0]) * (sy[1] - sy[0]);
+    if (!(std::abs(area) > 1e-12f) || (cullBack && area > 0.0f)) return false;
+
+    tri.minX = std::max(0, (int)std::floor(std::min({sx[0], sx[1], sx[2]}) - 0.5f));
+    tri.maxX = std::min((int)width - 1, (int)std::ceil(std::max({sx[0], sx[1], sx[2]}) - 0.5f));
+    tri.minY = std::max(0, (int)std::floor(std::min({sy[0], sy[1], sy[2]}) - 0.5f));
+    tri.maxY = std::min((int)height - 1, (int)std::ceil(std::max({sy[0], sy[1], sy[2]}) - 0.5f));
+    if (tri.minX > tri.maxX || tri.minY > tri.maxY) return false;
+
+    float invArea = 1.0f / area;
+    for (int j = 0; j < 3; j++) {
+        // Edge from corner j+1 to j+2, scaled so it is 1 at corner j
+        int a = (j + 1) % 3, b = (j + 2) % 3;
+        float sign = 1.0f;
+        if (sx[b] < sx[a] || (sx[b] == sx[a] && sy[b] < sy[a])) {
+            std::swap(a, b);
+            sign = -1.0f;
+        }
+        tri.edgeOX[j] = sx[a];
+        tri.edgeOY[j] = sy[a];
+        tri.edgeDX[j] = sx[b] - sx[a];
+        tri.edgeDY[j] = sy[b] - sy[a];
+        tri.edgeScale[j] = sign * invArea;
+        // Inward normal pointing right (left edge) or down (top edge)
+        float gx = -tri.edgeDY[j] * tri.edgeScale[j], gy = tri.edgeDX[j] * tri.edgeScale[j];
+        bool topLeft = gx > 0.0f || (gx == 0.0f && gy > 0.0f);
+        tri.edgeBias[j] = topLeft ? 0.0f : FLT_MIN;
+        tri.invW[j] = iw[j];
+        tri.srcB1[j] = v[j]->b1;
+        tri.srcB2[j] = v[j]->b2;
+        tri.vertex[j] = vertex[j];
+    }
+    tri.depth0 = sz[0];
+    tri.depthD1 = sz[1] - sz[0];
+    tri.depthD2 = sz[2] - sz[0];
+    tri.draw = draw;
+    return true;
+}
+
+// ===== Tile Stage =====
+
+// Everything the per-tile stage reads, shared by all workers
+struct TileFrame {
+    int width = 0, height = 0, tilesX = 0;
+    size_t tileCount = 0, chunkCount = 0;
+    const std::vector<SetupTriangle>* chunkTriangles = nullptr;
+    const std::vector<uint32_t>* bins = nullptr;  // chunk * tileCount + tile
+    const uint32_t* chunkBase = nullptr;          // first triangle id per chunk
+    const ShadeVertex* shade = nullptr;
+    const SoftwareMaterial* const* materials = nullptr;
+    const TextureData* const* textures = nullptr;
+    float toLight[3] = {0.0f, 1.0f, 0.0f};
+    float eye[3] = {0.0f, 0.0f, 0.0f};
+    uint32_t clearColor = 0;
+    uint32_t* color = nullptr;
+    float* depth = nullptr;
+};
+
+// Visibility buffer of one tile: nearest triangle and its screen-space
+// barycentrics per pixel (corner 0's weight is implied)
+struct TileBuffers {
+    alignas(16) float depth[kTilePixels];
+    alignas(16) float l1[kTilePixels];
+    alignas(16) float l2[kTilePixels];
+    alignas(16) uint32_t id[kTilePixels];
+};
+
+struct TileRect {
+    int x0, y0, x1, y1;  // inclusive
+};
+
+inline TileRect tileRect(const TileFrame& f, size_t tile) {
+    TileRect r;
+    r.x0 = (int)(tile % f.tilesX) * kTile;
+    r.y0 = (int)(tile / f.tilesX) * kTile;
+    r.x1 = std::min(r.x0 + kTile, f.width) - 1;
+    r.y1 = std::min(r.y0 + kTile, f.height) - 1;
+    return r;
+}
+
+// Depth-tests every binned triangle four pixels at a time. Bins are walked
+// in submission order, so equal depths resolve to the earlier triangle.
+void rasterizeTile(const TileFrame& f, size_t tile, TileBuffers& tb) {
+    const TileRect r = tileRect(f, tile);
+    std::fill(tb.depth, tb.depth + kTilePixels, 1.0f);
+    std::fill(tb.id, tb.id + kTilePixels, kNoTriangle);
+
+    for (size_t c = 0; c < f.chunkCount; c++) {
+        const SetupTriangle* tris = f.chunkTriangles[c].data();
+        for (uint32_t local : f.bins[c * f.tileCount + tile]) {
+            const SetupTriangle& tri = tris[local];
+            const uint32_t id = f.chunkBase[c] + local;
+            // Tiles start on a multiple of 4, so aligned quads stay inside
+            const int x0 = std::max(tri.minX, r.x0) & ~3;
+            const int x1 = std::min(tri.maxX, r.x1);
+            const int y0 = std::max(tri.minY, r.y0);
+            const int y1 = std::min(tri.maxY, r.y1);
+            const float fx0 = (float)x0 + 0.5f;
+            const Float4 laneX0 = set4(fx0, fx0 + 1.0f, fx0 + 2.0f, fx0 + 3.0f);
+            Float4 originX[3], deltaY[3], scale[3], bias[3];
+            for (int j = 0; j < 3; j++) {
+                originX[j] = set4(tri.edgeOX[j]);
+                deltaY[j] = set4(tri.edgeDY[j]);
+                scale[j] = set4(tri.edgeScale[j]);
+                bias[j] = set4(tri.edgeBias[j]);
+            }
+            const Float4 depth0 = set4(tri.depth0), depthD1 = set4(tri.depthD1), depthD2 = set4(tri.depthD2);
+
+            for (int y = y0; y <= y1; y++) {
+                const float py = (float)y + 0.5f;
+                Float4 rowTerm[3];
+                for (int j = 0; j < 3; j++) rowTerm[j] = set4(tri.edgeDX[j] * (py - tri.edgeOY[j]));
+                const int row = (y - r.y0) * kTile - r.x0;
+                Float4 laneX = laneX0;
+                for (int x = x0; x <= x1; x += 4, laneX = add4(laneX, set4(4.0f))) {
+                    // Evaluated directly rather than stepped, so every pixel
+                    // sees exactly the value its neighbor triangle sees
+                    Float4 e0 = mul4(sub4(rowTerm[0], mul4(deltaY[0], sub4(laneX, originX[0]))), scale[0]);
+                    Float4 e1 = mul4(sub4(rowTerm[1], mul4(deltaY[1], sub4(laneX, originX[1]))), scale[1]);
+                    Float4 e2 = mul4(sub4(rowTerm[2], mul4(deltaY[2], sub4(laneX, originX[2]))), scale[2]);
+                    Float4 mask = and4(and4(cmpge4(e0, bias[0]), cmpge4(e1, bias[1])), cmpge4(e2, bias[2]));
+                    if (!any4(mask)) continue;
+                    const int p = row + x;
+                    Float4 z = add4(depth0, add4(mul4(depthD1, e1), mul4(depthD2, e2)));
+                    Float4 oldDepth = load4(tb.depth + p);
+                    mask = and4(mask, cmplt4(z, oldDepth));
+                    if (!any4(mask)) continue;
+                    store4(tb.depth + p, select4(mask, z, oldDepth));
+                    store4(tb.l1 + p, select4(mask, e1, load4(tb.l1 + p)));
+                    store4(tb.l2 + p, select4(mask, e2, load4(tb.l2 + p)));
+                    selectStore4(tb.id + p, mask, id);
+                }
+            }
+        }
+    }
+}
+
+// pbr.hlsl PSMain inputs for four pixels, structure-of-arrays
+struct PixelQuad {
+    alignas(16) float normal[3][4];
+    alignas(16) float view[3][4];  // cameraPos - worldPos
+    alignas(16) float albedo[3][4];
+    alignas(16) float metallic[4];
+    alignas(16) float roughness[4];
+
+    // Harmless inputs for lanes without a visible triangle
+    void clearLane(int i) {
+        for (int k = 0; k < 3; k++) {
+            normal[k][i] = k == 1 ? 1.0f : 0.0f;
+            view[k][i] = k == 1 ? 1.0f : 0.0f;
+            albedo[k][i] = 0.0f;
+        }
+        metallic[i] = 0.0f;
+        roughness[i] = 1.0f;
+    }
+};
+
+inline Float4 dot4(const Float4* a, const Float4* b) {
+    return add4(add4(mul4(a[0], b[0]), mul4(a[1], b[1])), mul4(a[2], b[2]));
+}
+
+inline void normalize4(Float4* v) {
+    Float4 inv = div4(set4(1.0f), sqrt4(max4(dot4(v, v), set4(1e-20f))));
+    for (int k = 0; k < 3; k++) v[k] = mul4(v[k], inv);
+}
+
+// pbr.hlsl without shadows or IBL: Cook-Torrance (GGX, Smith, Schlick)
+// under one directional light, hemisphere ambient and ACES tonemapping
+void shadeQuad(const PixelQuad& q, const float* toLight, float rgb[3][4]) {
+    const float kPi = 3.14159265359f;
+    static const float kLight[3] = {2.5f, 2.45f, 2.375f};  // (1, 0.98, 0.95) * 2.5
+    static const float kSky[3] = {0.5f, 0.6f, 0.8f};
+    static const float kGround[3] = {0.3f, 0.25f, 0.2f};
+    const Float4 zero = set4(0.0f), one = set4(1.0f);
+
+    Float4 N[3], V[3], L[3], H[3];
+    for (int k = 0; k < 3; k++) {
+        N[k] = load4(q.normal[k]);
+        V[k] = load4(q.view[k]);
+        L[k] = set4(toLight[k]);
+    }
+    normalize4(N);
+    normalize4(V);
+    for (int k = 0; k < 3; k++) H[k] = add4(V[k], L[k]);
+    normalize4(H);
+
+    Float4 NdotL = max4(dot4(N, L), zero);
+    Float4 NdotV = max4(dot4(N, V), set4(0.001f));
+    Float4 NdotH = max4(dot4(N, H), zero);
+    Float4 HdotV = max4(dot4(H, V), zero);
+    Float4 metal = load4(q.metallic);
+    Float4 rough = min4(max4(load4(q.roughness), set4(0.04f)), one);
+
+    Float4 a = mul4(rough, rough);
+    Float4 a2 = mul4(a, a);
+    Float4 denom = add4(mul4(mul4(NdotH, NdotH), sub4(a2, one)), one);
+    Float4 D = div4(a2, add4(mul4(set4(kPi), mul4(denom, denom)), set4(0.0001f)));
+    Float4 roughPlusOne = add4(rough, one);
+    Float4 k = mul4(mul4(roughPlusOne, roughPlusOne), set4(0.125f));
+    Float4 oneMinusK = sub4(one, k);
+    Float4 G = mul4(div4(NdotV, add4(mul4(NdotV, oneMinusK), k)), div4(NdotL, add4(mul4(NdotL, oneMinusK), k)));
+    Float4 f1 = sub4(one, HdotV);
+    Float4 f2 = mul4(f1, f1);
+    Float4 fresnel = mul4(mul4(f2, f2), f1);
+    Float4 specScale = div4(mul4(D, G), add4(mul4(set4(4.0f), mul4(NdotV, NdotL)), set4(0.0001f)));
+    Float4 skyT = add4(mul4(N[1], set4(0.5f)), set4(0.5f));
+    Float4 diffuseScale = mul4(sub4(one, metal), set4(1.0f / kPi));
+
+    for (int ch = 0; ch < 3; ch++) {
+        Float4 albedo = load4(q.albedo[ch]);
+        Float4 F0 = add4(set4(0.04f), mul4(sub4(albedo, set4(0.04f)), metal));
+        Float4 F = add4(F0, mul4(sub4(one, F0), fresnel));
+        Float4 diffuse = mul4(mul4(sub4(one, F), diffuseScale), albedo);
+        Float4 Lo = mul4(add4(diffuse, mul4(specScale, F)), mul4(NdotL, set4(kLight[ch])));
+        Float4 hemisphere = add4(set4(kGround[ch]), mul4(set4(kSky[ch] - kGround[ch]), skyT));
+        Float4 c = add4(mul4(mul4(albedo, hemisphere), set4(0.25f)), Lo);
+        Float4 num = mul4(c, add4(mul4(set4(2.51f), c), set4(0.03f)));
+        Float4 den = add4(mul4(c, add4(mul4(set4(2.43f), c), set4(0.59f))), set4(0.14f));
+        store4(rgb[ch], div4(num, den));
+    }
+}
+
+// Resolves the visibility buffer: interpolates the attributes of each
+// visible pixel, shades quads of four and writes color and depth
+uint64_t shadeTile(const TileFrame& f, size_t tile, const TileBuffers& tb) {
+    const TileRect r = tileRect(f, tile);
+    uint64_t shaded = 0;
+    size_t chunk = 0;
+    PixelQuad quad;
+    alignas(16) float rgb[3][4];
+
+    for (int y = r.y0; y <= r.y1; y++) {
+        uint32_t* colorRow = f.color + (size_t)y * f.width;
+        float* depthRow = f.depth + (size_t)y * f.width;
+        for (int x = r.x0; x <= r.x1; x += 4) {
+            const int lanes = std::min(4, r.x1 - x + 1);
+            bool visible[4] = {false, false, false, false};
+            bool any = false;
+            for (int i = 0; i < 4; i++) {
+                const int p = (y - r.y0) * kTile + (x - r.x0) + i;
+                const uint32_t id = i < lanes ? tb.id[p] : kNoTriangle;
+                if (i < lanes) depthRow[x + i] = tb.depth[p];
+                if (id == kNoTriangle) {
+                    if (i < lanes) colorRow[x + i] = f.clearColor;
+                    quad.clearLane(i);
+                    continue;
+                }
+                visible[i] = any = true;
+                if (id < f.chunkBase[chunk] || id >= f.chunkBase[chunk + 1]) {
+                    chunk = std::upper_bound(f.chunkBase, f.chunkBase + f.chunkCount + 1, id) - f.chunkBase - 1;
+                }
+                const SetupTriangle& tri = f.chunkTriangles[chunk][id - f.chunkBase[chunk]];
+
+                // Perspective-correct barycentrics in the source triangle
+                const float l1 = tb.l1[p], l2 = tb.l2[p];
+                float w0 = (1.0f - l1 - l2) * tri.invW[0], w1 = l1 * tri.invW[1], w2 = l2 * tri.invW[2];
+                const float invSum = 1.0f / (w0 + w1 + w2);
+                w0 *= invSum; w1 *= invSum; w2 *= invSum;
+                const float b1 = w0 * tri.srcB1[0] + w1 * tri.srcB1[1] + w2 * tri.srcB1[2];
+                const float b2 = w0 * tri.srcB2[0] + w1 * tri.srcB2[1] + w2 * tri.srcB2[2];
+                const float b0 = 1.0f - b1 - b2;
+
+                // Corners of clipped triangles still name the source vertices
+                const ShadeVertex& v0 = f.shade[tri.vertex[0]];
+                const ShadeVertex& v1 = f.shade[tri.vertex[1]];
+                const ShadeVertex& v2 = f.shade[tri.vertex[2]];
+                const SoftwareMaterial& mat = *f.materials[tri.draw];
+                for (int k = 0; k < 3; k++) {
+                    quad.normal[k][i] = v0.normal[k] * b0 + v1.normal[k] * b1 + v2.normal[k] * b2;
+                    quad.view[k][i] = f.eye[k] - (v0.worldPos[k] * b0 + v1.worldPos[k] * b1 + v2.worldPos[k] * b2);
+                    quad.albedo[k][i] = (v0.color[k] * b0 + v1.color[k] * b1 + v2.color[k] * b2) * mat.baseColor[k];
+                }
+                if (const TextureData* tex = f.textures[tri.draw]) {
+                    // pbr.hlsl treats a white sample as "no texture"
+                    float texel[3];
+                    sampleTexture(*tex, v0.uv[0] * b0 + v1.uv[0] * b1 + v2.uv[0] * b2,
+                                  v0.uv[1] * b0 + v1.uv[1] * b1 + v2.uv[1] * b2, texel);
+                    if (texel[0] + texel[1] + texel[2] < 2.9f) {
+                        for (int k = 0; k < 3; k++) quad.albedo[k][i] = texel[k];
+                    }
+                }
+                quad.metallic[i] = mat.metallic;
+                quad.roughness[i] = mat.roughness;
+            }
+            if (!any) continue;
+
+            shadeQuad(quad, f.toLight, rgb);
+            for (int i = 0; i < lanes; i++) {
+                if (!visible[i]) continue;
+                colorRow[x + i] = packColor(rgb[0][i], rgb[1][i], rgb[2][i]);
+                shaded++;
+            }
+        }
+    }
+    return shaded;
+}
+
+}  // namespace
+
+// ===== Frame State =====
+struct SoftwareBackend::Impl {
+    explicit Impl(int threads) : pool(threads) {}
+
+    WorkerPool pool;
+
+    // Frame scratch, reused between frames
+    std::vector<float> clip;            // 4 floats per vertex
+    std::vector<ShadeVertex> shade;
+    std::vector<uint32_t> vertexBase;   // per draw, into clip/shade
+    std::vector<size_t> triangleBase;   // per draw, prefix of triangle counts
+    std::vector<std::vector<SetupTriangle>> chunkTriangles;
+    std::vector<std::vector<uint32_t>> bins;  // chunk * tileCount + tile
+    std::vector<uint32_t> chunkBase;          // first global triangle id per chunk
+};
+
+// ===== Backend =====
+
+SoftwareBackend::SoftwareBackend(const NativeWindow& window, int threads) {
+    if (threads <= 0) threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    impl_ = std::make_unique<Impl>(threads);
+    if (window.width > 0 && window.height > 0) {
+        width_ = window.width;
+        height_ = window.height;
+    }
+    allocate_targets();
+}
+
+SoftwareBackend::~SoftwareBackend() = default;
+
+int SoftwareBackend::thread_count() const { return impl_->pool.getThreadCount(); }
+
+void SoftwareBackend::allocate_targets() {
+    color_.assign((size_t)width_ * height_, packColor(clear_[0], clear_[1], clear_[2]));
+    depth_.assign((size_t)width_ * height_, 1.0f);
+}
+
+void SoftwareBackend::resize(uint32_t width, uint32_t height) {
+    if (width == 0 || height == 0 || (width == width_ && height == height_)) return;
+    width_ = width;
+    height_ = height;
+    allocate_targets();
+}
+
+void SoftwareBackend::render_clear(float r, float g, float b) {
+    set_clear_color(r, g, b);
+    std::fill(color_.begin(), color_.end(), packColor(r, g, b));
+    std::fill(depth_.begin(), depth_.end(), 1.0f);
+}
+
+void SoftwareBackend::present() {
+    // Headless: the color target stays readable until the next frame
+    frames_presented_++;
+    backbuffer_state_ = ResourceState::Present;
+}
+
+void SoftwareBackend::transition_backbuffer(ResourceState /*before*/, ResourceState after) {
+    backbuffer_state_ = after;
+}
+
+void SoftwareBackend::bind_material_params(const std::unordered_map<std::string, std::string>& params) {
+    override_metallic_ = override_roughness_ = override_color_ = false;
+    for (const auto& [key, value] : params) {
+        std::istringstream in(value);
+        if (key == "metallic") {
+            override_metallic_ = (bool)(in >> override_material_.metallic);
+        } else if (key == "roughness") {
+            override_roughness_ = (bool)(in >> override_material_.roughness);
+        } else if (key == "baseColor") {
+            float* c = override_material_.baseColor;
+            override_color_ = (bool)(in >> c[0] >> c[1] >> c[2]);
+        }
+    }
+}
+
+void SoftwareBackend::set_camera(const Vec3& eye, const Vec3& target, float fovY, float nearZ, float farZ) {
+    eye_ = eye;
+    target_ = target;
+    fov_y_ = fovY;
+    near_z_ = nearZ;
+    far_z_ = farZ;
+}
+
+void SoftwareBackend::frame_bounds(const Vec3& center, float radius, float yaw, float pitch) {
+    radius = std::max(radius, 1e-4f);
+    float halfFov = fov_y_ * 0.5f;
+    float aspect = (float)width_ / (float)height_;
+    float fitHalf = aspect < 1.0f ? std::atan(std::tan(halfFov) * aspect) : halfFov;
+    float distance = radius / std::sin(fitHalf) * 1.05f;
+    Vec3 dir(std::sin(yaw) * std::cos(pitch), std::sin(pitch), std::cos(yaw) * std::cos(pitch));
+    set_camera(center + dir * distance, center, fov_y_,
+               std::max(distance - radius * 1.5f, distance * 0.01f), distance + radius * 1.5f);
+}
+
+void SoftwareBackend::set_light_dir(const Vec3& dir) { light_dir_ = dir.normalized(); }
+
+void SoftwareBackend::set_clear_color(float r, float g, float b) {
+    clear_[0] = r;
+    clear_[1] = g;
+    clear_[2] = b;
+}
+
+SoftwareMesh SoftwareBackend::create_mesh(const Mesh& mesh) {
+    auto data = std::make_shared<SoftwareMesh::Data>();
+    data->vertices = mesh.vertices;
+    data->indices = mesh.indices;
+    for (size_t i = 0; i + 2 < data->indices.size();) {
+        // Drop triangles with out-of-range indices up front so the frame
+        // loop never has to check
+        if (std::max({data->indices[i], data->indices[i + 1], data->indices[i + 2]}) >= data->vertices.size()) {
+            data->indices.erase(data->indices.begin() + i, data->indices.begin() + i + 3);
+        } else {
+            i += 3;
+        }
+    }
+    data->indices.resize(data->indices.size() / 3 * 3);
+    const TextureData& tex = textureData(mesh.diffuseTexture);
+    if (!tex.pixels.empty() && tex.width > 0 && tex.height > 0 && tex.channels >= 3 &&
+        tex.pixels.size() >= (size_t)tex.width * tex.height * tex.channels) {
+        data->diffuse = mesh.diffuseTexture;
+    }
+    std::copy(mesh.baseColor, mesh.baseColor + 3, data->material.baseColor);
+    data->material.metallic = mesh.metallic;
+    data->material.roughness = mesh.roughness;
+    data->boundsMin = Vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+    data->boundsMax = Vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    for (const auto& v : data->vertices) {
+        Vec3 p(v.position[0], v.position[1], v.position[2]);
+        data->boundsMin = Vec3(std::min(data->boundsMin.x, p.x), std::min(data->boundsMin.y, p.y), std::min(data->boundsMin.z, p.z));
+        data->boundsMax = Vec3(std::max(data->boundsMax.x, p.x), std::max(data->boundsMax.y, p.y), std::max(data->boundsMax.z, p.z));
+    }
+
+    SoftwareMesh result;
+    result.index_count = (uint32_t)data->indices.size();
+    result.data = std::move(data);
+    return result;
+}
+
+void SoftwareBackend::begin_scene(float time) {
+    draws_.clear();
+    scene_world_ = Mat4::fromQuat(Quat::fromAxisAngle(Vec3(0.0f, 1.0f, 0.0f), time));
+    in_scene_ = true;
+    transition_backbuffer(ResourceState::Present, ResourceState::ColorAttachment);
+}
+
+void SoftwareBackend::draw_mesh(const SoftwareMesh& mesh) { draw_mesh(mesh, scene_world_); }
+
+void SoftwareBackend::draw_mesh(const SoftwareMesh& mesh, const Mat4& world) {
+    if (!in_scene_ || !mesh.valid()) return;
+    Draw draw{mesh.data, std::min(mesh.index_count, (uint32_t)mesh.data->indices.size()), world, mesh.data->material};
+    if (override_metallic_) draw.material.metallic = override_material_.metallic;
+    if (override_roughness_) draw.material.roughness = override_material_.roughness;
+    if (override_color_) std::copy(override_material_.baseColor, override_material_.baseColor + 3, draw.material.baseColor);
+    draws_.push_back(std::move(draw));
+}
+
+void SoftwareBackend::end_scene() {
+    if (!in_scene_) return;
+    in_scene_ = false;
+    Impl& im = *impl_;
+    stats_ = {};
+    auto frameStart = Clock::now();
+
+    const int tilesX = ((int)width_ + kTile - 1) / kTile;
+    const int tilesY = ((int)height_ + kTile - 1) / kTile;
+    const size_t tileCount = (size_t)tilesX * tilesY;
+
+    // --- Vertex stage ---
+    auto stageStart = Clock::now();
+    Mat4 viewProj = perspectiveRH(fov_y_, (float)width_ / (float)height_, near_z_, far_z_) *
+                    lookAtRH(eye_, target_, Vec3(0.0f, 1.0f, 0.0f));
+    im.vertexBase.resize(draws_.size() + 1);
+    im.triangleBase.resize(draws_.size() + 1);
+    im.vertexBase[0] = 0;
+    im.triangleBase[0] = 0;
+    for (size_t d = 0; d < draws_.size(); d++) {
+        im.vertexBase[d + 1] = im.vertexBase[d] + (uint32_t)draws_[d].data->vertices.size();
+        im.triangleBase[d + 1] = im.triangleBase[d] + draws_[d].indexCount / 3;
+    }
+    const size_t vertexCount = im.vertexBase.back();
+    const size_t triangleCount = im.triangleBase.back();
+    stats_.trianglesSubmitted = triangleCount;
+    im.clip.resize(vertexCount * 4);
+    im.shade.resize(vertexCount);
+
+    for (size_t d = 0; d < draws_.size(); d++) {
+        const Draw& draw = draws_[d];
+        Mat4 worldViewProj = viewProj * draw.world;
+        const Mat4& w = draw.world;
+        const Vertex* src = draw.data->vertices.data();
+        float* clip = im.clip.data() + (size_t)im.vertexBase[d] * 4;
+        ShadeVertex* shade = im.shade.data() + im.vertexBase[d];
+        auto transform = [&](size_t begin, size_t end) {
+            const float* m = worldViewProj.m;
+            for (size_t i = begin; i < end; i++) {
+                const Vertex& v = src[i];
+                const float x = v.position[0], y = v.position[1], z = v.position[2];
+                for (int r = 0; r < 4; r++) clip[i * 4 + r] = m[r] * x + m[4 + r] * y + m[8 + r] * z + m[12 + r];
+                ShadeVertex& o = shade[i];
+                for (int r = 0; r < 3; r++) {
+                    o.worldPos[r] = w.m[r] * x + w.m[4 + r] * y + w.m[8 + r] * z + w.m[12 + r];
+                    o.normal[r] = w.m[r] * v.normal[0] + w.m[4 + r] * v.normal[1] + w.m[8 + r] * v.normal[2];
+                    o.color[r] = v.color[r];
+                }
+                o.uv[0] = v.uv[0];
+                o.uv[1] = v.uv[1];
+            }
+        };
+        im.pool.parallelFor(draw.data->vertices.size(), 8192, transform);
+    }
+    stats_.vertexMs = msSince(stageStart);
+
+    // --- Setup and binning ---
+    // Chunks are contiguous triangle ranges; each bins into its own lists so
+    // no locking is needed, and walking chunks in order keeps draw order.
+    stageStart = Clock::now();
+    const size_t chunkCount = std::max<size_t>(1, (triangleCount + kTrianglesPerChunk - 1) / kTrianglesPerChunk);
+    if (im.chunkTriangles.size() < chunkCount) im.chunkTriangles.resize(chunkCount);
+    im.bins.resize(std::max(im.bins.size(), chunkCount * tileCount));
+    im.chunkBase.resize(chunkCount + 1);
+
+    const bool cullBack = cull_back_;
+    auto setupChunk = [&](size_t c0, size_t c1) {
+        for (size_t c = c0; c < c1; c++) {
+            auto& chunkTris = im.chunkTriangles[c];
+            chunkTris.clear();
+            for (size_t t = 0; t < tileCount; t++) im.bins[c * tileCount + t].clear();
+            size_t t0 = c * kTrianglesPerChunk;
+            size_t t1 = std::min(triangleCount, t0 + kTrianglesPerChunk);
+            size_t d = std::upper_bound(im.triangleBase.begin(), im.triangleBase.end(), t0) - im.triangleBase.begin() - 1;
+
+            for (size_t t = t0; t < t1; t++) {
+                while (t >= im.triangleBase[d + 1]) d++;
+                const uint32_t* idx = draws_[d].data->indices.data() + (t - im.triangleBase[d]) * 3;
+                uint32_t gv[3] = {im.vertexBase[d] + idx[0], im.vertexBase[d] + idx[1], im.vertexBase[d] + idx[2]};
+                ClipVertex cv[3];
+                static const float kCornerB[3][2] = {{0, 0}, {1, 0}, {0, 1}};
+                for (int k = 0; k < 3; k++) {
+                    const float* p = im.clip.data() + (size_t)gv[k] * 4;
+                    cv[k] = {p[0], p[1], p[2], p[3], kCornerB[k][0], kCornerB[k][1]};
+                }
+                // Trivial reject against one frustum plane
+                auto allOutside = [&](auto outside) { return outside(cv[0]) && outside(cv[1]) && outside(cv[2]); };
+                if (allOutside([](const ClipVertex& v) { return v.x > v.w; }) ||
+                    allOutside([](const ClipVertex& v) { return v.x < -v.w; }) ||
+                    allOutside([](const ClipVertex& v) { return v.y > v.w; }) ||
+                    allOutside([](const ClipVertex& v) { return v.y < -v.w; }) ||
+                    allOutside([](const ClipVertex& v) { return v.z > v.w; }) ||
+                    allOutside([](const ClipVertex& v) { return v.z < 0.0f; })) {
+                    continue;
+                }
+
+                // Near plane (z >= 0) clipping yields a convex polygon of <= 4 vertices
+                ClipVertex poly[4];
+                int n = 0;
+                if (cv[0].z >= 0.0f && cv[1].z >= 0.0f && cv[2].z >= 0.0f) {
+                    poly[0] = cv[0]; poly[1] = cv[1]; poly[2] = cv[2];
+                    n = 3;
+                } else {
+                    for (int k = 0; k < 3; k++) {
+                        const ClipVertex& a = cv[k];
+                        const ClipVertex& b = cv[(k + 1) % 3];
+                        if (a.z >= 0.0f) poly[n++] = a;
+                        if ((a.z >= 0.0f) != (b.z >= 0.0f)) {
+                            // Always inside -> outside, so the neighbor across
+                            // this edge computes the identical point
+                            const ClipVertex& in = a.z >= 0.0f ? a : b;
+                            const ClipVertex& out = a.z >= 0.0f ? b : a;
+                            float s = in.z / (in.z - out.z);
+                            poly[n++] = {in.x + (out.x - in.x) * s, in.y + (out.y - in.y) * s, in.z + (out.z - in.z) * s,
+                                         in.w + (out.w - in.w) * s, in.b1 + (out.b1 - in.b1) * s, in.b2 + (out.b2 - in.b2) * s};
+                        }
+                    }
+                }
+
+                for (int k = 1; k + 1 < n; k++) {
+                    const ClipVertex* corners[3] = {&poly[0], &poly[k], &poly[k + 1]};
+                    SetupTriangle tri;
+                    if (!setupTriangle(corners, gv, (uint32_t)d, width_, height_, cullBack, tri)) continue;
+                    uint32_t local = (uint32_t)chunkTris.size();
+                    chunkTris.push_back(tri);
+                    for (int ty = tri.minY / kTile; ty <= tri.maxY / kTile; ty++) {
+                        for (int tx = tri.minX / kTile; tx <= tri.maxX / kTile; tx++) {
+                            im.bins[c * tileCount + (size_t)ty * tilesX + tx].push_back(local);
+                        }
+                    }
+                }
+            }
+        }
+    };
+    im.pool.parallelFor(chunkCount, 1, setupChunk);
+    im.chunkBase[0] = 0;
+    for (size_t c = 0; c < chunkCount; c++) im.chunkBase[c + 1] = im.chunkBase[c] + (uint32_t)im.chunkTriangles[c].size();
+    stats_.trianglesBinned = im.chunkBase[chunkCount];
+    stats_.binMs = msSince(stageStart);
+
+    // --- Raster + deferred shading per tile ---
+    stageStart = Clock::now();
+    std::vector<const SoftwareMaterial*> materials(draws_.size());
+    std::vector<const TextureData*> textures(draws_.size());
+    for (size_t d = 0; d < draws_.size(); d++) {
+        materials[d] = &draws_[d].material;
+        textures[d] = draws_[d].data->diffuse.get();
+    }
+    TileFrame frame;
+    frame.width = (int)width_;
+    frame.height = (int)height_;
+    frame.tilesX = tilesX;
+    frame.tileCount = tileCount;
+    frame.chunkCount = chunkCount;
+    frame.chunkTriangles = im.chunkTriangles.data();
+    frame.bins = im.bins.data();
+    frame.chunkBase = im.chunkBase.data();
+    frame.shade = im.shade.data();
+    frame.materials = materials.data();
+    frame.textures = textures.data();
+    frame.toLight[0] = -light_dir_.x;
+    frame.toLight[1] = -light_dir_.y;
+    frame.toLight[2] = -light_dir_.z;
+    normalize3(frame.toLight);
+    frame.eye[0] = eye_.x;
+    frame.eye[1] = eye_.y;
+    frame.eye[2] = eye_.z;
+    frame.clearColor = packColor(clear_[0], clear_[1], clear_[2]);
+    frame.color = color_.data();
+    frame.depth = depth_.data();
+
+    std::atomic<uint64_t> shadedPixels{0};
+    auto tileBody = [&](size_t begin, size_t end) {
+        TileBuffers buffers;
+        uint64_t shaded = 0;
+        for (size_t tile = begin; tile < end; tile++) {
+            rasterizeTile(frame, tile, buffers);
+            shaded += shadeTile(frame, tile, buffers);
+        }
+        shadedPixels.fetch_add(shaded, std::memory_order_relaxed);
+    };
+    im.pool.parallelFor(tileCount, 1, tileBody);
+    stats_.pixelsShaded = shadedPixels.load();
+    stats_.rasterShadeMs = msSince(stageStart);
+    stats_.totalMs = msSince(frameStart);
+    draws_.clear();
+}
+
+void SoftwareBackend::read_pixels(std::vector<uint8_t>& rgba) const {
+    rgba.resize(color_.size() * 4);
+    for (size_t i = 0; i < color_.size(); i++) {
+        uint32_t c = color_[i];
+        rgba[i * 4 + 0] = (uint8_t)(c & 0xFF);
+        rgba[i * 4 + 1] = (uint8_t)((c >> 8) & 0xFF);
+        rgba[i * 4 + 2] = (uint8_t)((c >> 16) & 0xFF);
+        rgba[i * 4 + 3] = (uint8_t)(c >> 24);
+    }
+}
+
+std::unique_ptr<Backend> create_software_backend(const NativeWindow& window) {
+    return std::make_unique<SoftwareBackend>(window);
+}
+
+}  // namespace luma::rhi
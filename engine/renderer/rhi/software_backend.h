@@ -0,0 +1,150 @@
+// Software Backend - headless multithreaded CPU rasterizer
+// Renders the PBR forward path (pbr.hlsl) without a GPU: thumbnails,
+// CI golden images and servers without a display.
+//
+// Frame pipeline (end_scene):
+//   1. vertex transform        - parallel over vertices
+//   2. setup + binning         - parallel over triangle chunks; near-plane
+//                                clipping, back-face culling, per-chunk
+//                                32x32 tile bins
+//   3. raster + shade per tile - parallel over tiles; 4-wide edge/depth
+//                                tests write a visibility buffer (triangle
+//                                + barycentrics), then each visible pixel
+//                                is shaded once while the tile is in cache
+// Bins are walked in submission order, so output is identical for any
+// thread count.
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "engine/renderer/rhi/rhi.h"
+#include "engine/renderer/mesh.h"
+#include "engine/foundation/math_types.h"
+
+namespace luma::rhi {
+
+// Material inputs of pbr.hlsl
+struct SoftwareMaterial {
+    float baseColor[3] = {1.0f, 1.0f, 1.0f};
+    float metallic = 0.0f;
+    float roughness = 0.5f;
+};
+
+// CPU-side mesh; copies share the vertex data (like MeshGPU buffers)
+struct SoftwareMesh {
+    struct Data {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+        luma::TextureHandle diffuse;  // sampled only if it carries RGBA8/RGB8 pixels
+        SoftwareMaterial material;
+        Vec3 boundsMin;
+        Vec3 boundsMax;
+    };
+    std::shared_ptr<const Data> data;
+    uint32_t index_count{0};
+
+    bool valid() const { return data && index_count >= 3; }
+};
+
+struct SoftwareFrameStats {
+    double vertexMs = 0.0;
+    double binMs = 0.0;          // setup, clipping, culling and binning
+    double rasterShadeMs = 0.0;  // per-tile raster + deferred shading
+    double totalMs = 0.0;
+    uint64_t trianglesSubmitted = 0;
+    uint64_t trianglesBinned = 0;  // after culling/clipping
+    uint64_t pixelsShaded = 0;
+};
+
+class SoftwareBackend : public Backend {
+public:
+    static constexpr int kTileSize = 32;
+
+    // threads <= 0 uses every hardware thread
+    explicit SoftwareBackend(const NativeWindow& window, int threads = 0);
+    ~SoftwareBackend() override;
+
+    void render_clear(float r, float g, float b) override;
+    void present() override;
+    void transition_backbuffer(ResourceState before, ResourceState after) override;
+    // Recognized keys: metallic, roughness, baseColor ("r g b");
+    // override the mesh material for following draws
+    void bind_material_params(const std::unordered_map<std::string, std::string>& params) override;
+
+    // Mesh rendering (same call sequence as Dx12Backend)
+    SoftwareMesh create_mesh(const Mesh& mesh);
+    void begin_scene(float time);
+    void draw_mesh(const SoftwareMesh& mesh);
+    void draw_mesh(const SoftwareMesh& mesh, const Mat4& world);
+    void end_scene();
+
+    // Camera (right-handed, looks down -Z in view space)
+    void set_camera(const Vec3& eye, const Vec3& target, float fovY = 0.7853982f,
+                    float nearZ = 0.1f, float farZ = 100.0f);
+    // Fit a bounding sphere in view from the given orbit angles (radians)
+    void frame_bounds(const Vec3& center, float radius, float yaw = 0.6f, float pitch = 0.35f);
+    // Direction the light travels (pbr.hlsl lightDir)
+    void set_light_dir(const Vec3& dir);
+    void set_clear_color(float r, float g, float b);
+    void set_cull_back_faces(bool enabled) { cull_back_ = enabled; }
+
+    void resize(uint32_t width, uint32_t height);
+    uint32_t width() const { return width_; }
+    uint32_t height() const { return height_; }
+
+    // RGBA8, row-major, top row first
+    const uint32_t* pixels() const { return color_.data(); }
+    void read_pixels(std::vector<uint8_t>& rgba) const;
+    // Post-projection depth in [0, 1]; 1 where nothing was drawn
+    const float* depth() const { return depth_.data(); }
+
+    const SoftwareFrameStats& stats() const { return stats_; }
+    int thread_count() const;
+    uint64_t frames_presented() const { return frames_presented_; }
+
+private:
+    struct Draw {
+        std::shared_ptr<const SoftwareMesh::Data> data;
+        uint32_t indexCount;
+        Mat4 world;
+        SoftwareMaterial material;
+    };
+    struct Impl;
+
+    void allocate_targets();
+
+    uint32_t width_{1280};
+    uint32_t height_{720};
+    std::vector<uint32_t> color_;
+    std::vector<float> depth_;
+
+    Vec3 eye_{0.0f, 1.5f, 3.0f};
+    Vec3 target_{0.0f, 0.0f, 0.0f};
+    float fov_y_{0.7853982f};
+    float near_z_{0.1f};
+    float far_z_{100.0f};
+    Vec3 light_dir_{-0.5f, -1.0f, -0.5f};
+    float clear_[3] = {0.1f, 0.1f, 0.15f};
+    bool cull_back_{true};
+
+    Mat4 scene_world_;
+    std::vector<Draw> draws_;
+    bool in_scene_{false};
+
+    SoftwareMaterial override_material_;
+    bool override_metallic_{false};
+    bool override_roughness_{false};
+    bool override_color_{false};
+
+    ResourceState backbuffer_state_{ResourceState::Present};
+    uint64_t frames_presented_{0};
+    SoftwareFrameStats stats_;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace luma::rhi
@@ -172,6 +172,8 @@ fragment float4 pbrFragmentMain(
                          abs(normalSample.b - 1.0) > 0.1);
     if (hasNormalMap) {
         float3 normalMap = normalSample.rgb * 2.0 - 1.0;
+        // Rebuild Z so two-channel (BC5) normal maps work too
+        normalMap.z = sqrt(saturate(1.0 - dot(normalMap.xy, normalMap.xy)));
         float3x3 TBN = float3x3(
             normalize(in.tangent),
             normalize(in.bitangent),
@@ -182,6 +182,8 @@ fragment float4 skinnedFragmentMain(
     bool hasNormalMap = (abs(normalSample.r - normalSample.g) > 0.01 || abs(normalSample.b - 1.0) > 0.1);
     if (hasNormalMap) {
         float3 normalMap = normalSample.rgb * 2.0 - 1.0;
+        // Rebuild Z so two-channel (BC5) normal maps work too
+        normalMap.z = sqrt(saturate(1.0 - dot(normalMap.xy, normalMap.xy)));
         float3x3 TBN = float3x3(normalize(in.tangent), normalize(in.bitangent), normalize(in.normal));
         N = normalize(TBN * normalMap);
     } else {
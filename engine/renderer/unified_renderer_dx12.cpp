@@ -350,6 +350,18 @@ static std::string loadShaderFile(const std::string& path) {
     return buffer.str();
 }
 
+// ===== Texture Formats =====
+// Cooked textures keep their block format on the GPU; BC1-BC7 are core in D3D12
+static DXGI_FORMAT dxgiTextureFormat(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::BC1: return DXGI_FORMAT_BC1_UNORM;
+        case TextureFormat::BC3: return DXGI_FORMAT_BC3_UNORM;
+        case TextureFormat::BC5: return DXGI_FORMAT_BC5_UNORM;
+        case TextureFormat::BC7: return DXGI_FORMAT_BC7_UNORM;
+        default: return DXGI_FORMAT_R8G8B8A8_UNORM;
+    }
+}
+
 // ===== Math Helpers =====
 namespace math {
     inline void identity(float* m) {
@@ -544,7 +556,7 @@ struct UnifiedRenderer::Impl {
     struct TextureUploadJob {
         uint32_t meshIndex;
         int slot;  // 0=diffuse, 1=normal, 2=specular
-        TextureData data;
+        TextureHandle data;  // Shared with the mesh, no pixel copy
     };
     std::queue<TextureUploadJob> textureUploadQueue;
     size_t totalTexturesQueued = 0;
@@ -1293,38 +1305,65 @@ struct UnifiedRenderer::Impl {
         std::cout << "[unified/dx12] Grid ready (" << gridVertexCount << " lines)" << std::endl;
     }
     
+    // Plain textures upload level 0 as RGBA8, cooked ones their whole mip chain
     ComPtr<ID3D12Resource> uploadTexture(const TextureData& tex, UINT& outSrvIndex) {
-        if (tex.pixels.empty()) {
+        const bool cooked = tex.isCooked();
+        const UINT levels = cooked ? static_cast<UINT>(tex.mips.size()) : 1;
+        bool valid = cooked || tex.pixels.size() >= static_cast<size_t>(tex.width) * tex.height * 4;
+        for (UINT level = 0; cooked && level < levels; level++) {
+            const TextureMip& mip = tex.mips[level];
+            valid = valid && mip.data.size() >= textureLevelSize(tex.format, mip.width, mip.height);
+        }
+        if (!valid || tex.width <= 0 || tex.height <= 0) {
             outSrvIndex = defaultTextureSrvIndex;
             return defaultTexture;
         }
         
-        const UINT w = tex.width, h = tex.height;
+        // BCn top levels must be whole blocks; other sizes go up decoded
+        std::vector<std::vector<uint8_t>> decoded;
+        if (cooked && isBlockCompressed(tex.format) && (tex.width % 4 != 0 || tex.height % 4 != 0)) {
+            for (UINT level = 0; level < levels; level++) decoded.push_back(textureLevelRGBA8(tex, level));
+        }
+        const DXGI_FORMAT format = cooked && decoded.empty() ? dxgiTextureFormat(tex.format) : DXGI_FORMAT_R8G8B8A8_UNORM;
         
         D3D12_HEAP_PROPERTIES heapProps{}; heapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
         D3D12_RESOURCE_DESC texDesc{};
         texDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-        texDesc.Width = w; texDesc.Height = h; texDesc.DepthOrArraySize = 1; texDesc.MipLevels = 1;
-        texDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM; texDesc.SampleDesc.Count = 1;
+        texDesc.Width = tex.width; texDesc.Height = tex.height; texDesc.DepthOrArraySize = 1;
+        texDesc.MipLevels = static_cast<UINT16>(levels);
+        texDesc.Format = format; texDesc.SampleDesc.Count = 1;
         
         ComPtr<ID3D12Resource> texture;
         device->CreateCommittedResource(&heapProps, D3D12_HEAP_FLAG_NONE, &texDesc, 
             D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&texture));
         
+        // Row counts and sizes are in block rows for BCn levels
+        std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> layouts(levels);
+        std::vector<UINT> rowCounts(levels);
+        std::vector<UINT64> rowSizes(levels);
+        UINT64 uploadSize = 0;
+        device->GetCopyableFootprints(&texDesc, 0, levels, 0, layouts.data(), rowCounts.data(),
+                                      rowSizes.data(), &uploadSize);
+        
         D3D12_HEAP_PROPERTIES uploadHeap{}; uploadHeap.Type = D3D12_HEAP_TYPE_UPLOAD;
         D3D12_RESOURCE_DESC bufDesc{}; bufDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-        UINT rowPitch = (w * 4 + 255) & ~255;
-        bufDesc.Width = rowPitch * h; bufDesc.Height = 1; bufDesc.DepthOrArraySize = 1; bufDesc.MipLevels = 1;
+        bufDesc.Width = uploadSize; bufDesc.Height = 1; bufDesc.DepthOrArraySize = 1; bufDesc.MipLevels = 1;
         bufDesc.SampleDesc.Count = 1; bufDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
         
         ComPtr<ID3D12Resource> uploadBuf;
         device->CreateCommittedResource(&uploadHeap, D3D12_HEAP_FLAG_NONE, &bufDesc, 
             D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&uploadBuf));
         
-        void* mapped;
-        uploadBuf->Map(0, nullptr, &mapped);
-        for (UINT row = 0; row < h; row++) {
-            memcpy((uint8_t*)mapped + row * rowPitch, tex.pixels.data() + row * w * 4, w * 4);
+        uint8_t* mapped;
+        uploadBuf->Map(0, nullptr, reinterpret_cast<void**>(&mapped));
+        for (UINT level = 0; level < levels; level++) {
+            const uint8_t* src = !decoded.empty() ? decoded[level].data()
+                                 : cooked ? tex.mips[level].data.data() : tex.pixels.data();
+            const size_t rowSize = static_cast<size_t>(rowSizes[level]);
+            for (UINT row = 0; row < rowCounts[level]; row++) {
+                memcpy(mapped + layouts[level].Offset + row * layouts[level].Footprint.RowPitch,
+                       src + row * rowSize, rowSize);
+            }
         }
         uploadBuf->Unmap(0, nullptr);
         
@@ -1332,13 +1371,14 @@ struct UnifiedRenderer::Impl {
         allocators[0]->Reset();
         cmdList->Reset(allocators[0].Get(), nullptr);
         
-        D3D12_TEXTURE_COPY_LOCATION dst{}, src{};
-        dst.pResource = texture.Get(); dst.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
-        src.pResource = uploadBuf.Get(); src.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-        src.PlacedFootprint.Footprint.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        src.PlacedFootprint.Footprint.Width = w; src.PlacedFootprint.Footprint.Height = h;
-        src.PlacedFootprint.Footprint.Depth = 1; src.PlacedFootprint.Footprint.RowPitch = rowPitch;
-        cmdList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+        for (UINT level = 0; level < levels; level++) {
+            D3D12_TEXTURE_COPY_LOCATION dst{}, src{};
+            dst.pResource = texture.Get(); dst.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+            dst.SubresourceIndex = level;
+            src.pResource = uploadBuf.Get(); src.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+            src.PlacedFootprint = layouts[level];
+            cmdList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+        }
         
         D3D12_RESOURCE_BARRIER barrier{}; barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
         barrier.Transition.pResource = texture.Get();
@@ -1357,9 +1397,9 @@ struct UnifiedRenderer::Impl {
         srvHandle.ptr += outSrvIndex * srvDescSize;
         D3D12_SHADER_RESOURCE_VIEW_DESC srvViewDesc{}; 
         srvViewDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-        srvViewDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM; 
+        srvViewDesc.Format = format; 
         srvViewDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-        srvViewDesc.Texture2D.MipLevels = 1;
+        srvViewDesc.Texture2D.MipLevels = levels;
         device->CreateShaderResourceView(texture.Get(), &srvViewDesc, srvHandle);
         
         return texture;
@@ -2054,12 +2094,12 @@ RHIGPUMesh UnifiedRenderer::uploadMesh(const Mesh& mesh) {
     dx12Mesh.ibv.SizeInBytes = ibSize;
     dx12Mesh.ibv.Format = DXGI_FORMAT_R32_UINT;
     
-    dx12Mesh.diffuseTexture = impl_->uploadTexture(mesh.diffuseTexture, dx12Mesh.diffuseSrvIndex);
-    gpu.hasDiffuseTexture = !mesh.diffuseTexture.pixels.empty();
-    dx12Mesh.normalTexture = impl_->uploadTexture(mesh.normalTexture, dx12Mesh.normalSrvIndex);
-    gpu.hasNormalTexture = !mesh.normalTexture.pixels.empty();
-    dx12Mesh.specularTexture = impl_->uploadTexture(mesh.specularTexture, dx12Mesh.specularSrvIndex);
-    gpu.hasSpecularTexture = !mesh.specularTexture.pixels.empty();
+    dx12Mesh.diffuseTexture = impl_->uploadTexture(textureData(mesh.diffuseTexture), dx12Mesh.diffuseSrvIndex);
+    gpu.hasDiffuseTexture = hasPixels(mesh.diffuseTexture);
+    dx12Mesh.normalTexture = impl_->uploadTexture(textureData(mesh.normalTexture), dx12Mesh.normalSrvIndex);
+    gpu.hasNormalTexture = hasPixels(mesh.normalTexture);
+    dx12Mesh.specularTexture = impl_->uploadTexture(textureData(mesh.specularTexture), dx12Mesh.specularSrvIndex);
+    gpu.hasSpecularTexture = hasPixels(mesh.specularTexture);
     
     impl_->meshStorage.push_back(std::move(dx12Mesh));
     
@@ -2078,7 +2118,7 @@ bool UnifiedRenderer::loadModel(const std::string& path, RHILoadedModel& outMode
     
     for (const auto& mesh : result->meshes) {
         outModel.meshes.push_back(uploadMesh(mesh));
-        if (!mesh.diffuseTexture.pixels.empty()) outModel.textureCount++;
+        if (hasPixels(mesh.diffuseTexture)) outModel.textureCount++;
     }
     
     outModel.center[0] = (result->minBounds[0] + result->maxBounds[0]) / 2.0f;
@@ -2111,9 +2151,9 @@ bool UnifiedRenderer::loadModelAsync(const std::string& path, RHILoadedModel& ou
     // Count total textures for progress tracking
     size_t totalTextures = 0;
     for (const auto& mesh : result->meshes) {
-        if (!mesh.diffuseTexture.pixels.empty()) totalTextures++;
-        if (!mesh.normalTexture.pixels.empty()) totalTextures++;
-        if (!mesh.specularTexture.pixels.empty()) totalTextures++;
+        if (hasPixels(mesh.diffuseTexture)) totalTextures++;
+        if (hasPixels(mesh.normalTexture)) totalTextures++;
+        if (hasPixels(mesh.specularTexture)) totalTextures++;
     }
     impl_->asyncTexturesLoaded = 0;
     
@@ -2170,16 +2210,16 @@ bool UnifiedRenderer::loadModelAsync(const std::string& path, RHILoadedModel& ou
         uint32_t meshIdx = static_cast<uint32_t>(impl_->meshStorage.size());
         
         // Queue textures for progressive upload (will be uploaded in processAsyncTextures)
-        if (!mesh.diffuseTexture.pixels.empty()) {
+        if (hasPixels(mesh.diffuseTexture)) {
             impl_->textureUploadQueue.push({meshIdx, 0, mesh.diffuseTexture});
             gpu.hasDiffuseTexture = true;
             outModel.textureCount++;
         }
-        if (!mesh.normalTexture.pixels.empty()) {
+        if (hasPixels(mesh.normalTexture)) {
             impl_->textureUploadQueue.push({meshIdx, 1, mesh.normalTexture});
             gpu.hasNormalTexture = true;
         }
-        if (!mesh.specularTexture.pixels.empty()) {
+        if (hasPixels(mesh.specularTexture)) {
             impl_->textureUploadQueue.push({meshIdx, 2, mesh.specularTexture});
             gpu.hasSpecularTexture = true;
         }
@@ -2216,10 +2256,10 @@ void UnifiedRenderer::processAsyncTextures() {
         impl_->textureUploadQueue.pop();
         
         if (job.meshIndex >= impl_->meshStorage.size()) continue;
-        if (job.data.pixels.empty()) continue;
+        if (!hasPixels(job.data)) continue;
         
         UINT srvIndex;
-        ComPtr<ID3D12Resource> texture = impl_->uploadTexture(job.data, srvIndex);
+        ComPtr<ID3D12Resource> texture = impl_->uploadTexture(*job.data, srvIndex);
         
         DX12MeshData& mesh = impl_->meshStorage[job.meshIndex];
         const char* slotName = job.slot == 0 ? "diffuse" : (job.slot == 1 ? "normal" : "specular");
@@ -2243,7 +2283,7 @@ void UnifiedRenderer::processAsyncTextures() {
         uploadsThisFrame++;
         
         std::cout << "[progressive] Uploaded " << slotName << " (" 
-                  << job.data.width << "x" << job.data.height << ") - "
+                  << job.data->width << "x" << job.data->height << ") - "
                   << impl_->textureUploadQueue.size() << " remaining" << std::endl;
     }
 }
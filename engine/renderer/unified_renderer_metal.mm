@@ -152,6 +152,10 @@ struct MetalMeshData {
     float baseColor[3];
     float metallic;
     float roughness;
+    
+    // Texture streaming (slot 0=diffuse, 1=normal, 2=specular)
+    uint32_t streamIds[3] = {0, 0, 0};
+    int streamFirstMip[3] = {0, 0, 0};
 };
 
 // ===== Renderer Implementation =====
@@ -186,6 +190,8 @@ struct UnifiedRenderer::Impl {
     // Async Texture Loading
     // Maps async request ID to (meshIndex, textureSlot: 0=diffuse, 1=normal, 2=specular)
     std::unordered_map<uint32_t, std::pair<uint32_t, int>> pendingTextures;
+    // Uploaded textures the streamer may trim or restore, same mapping
+    std::unordered_map<uint32_t, std::pair<uint32_t, int>> streamedTextures;
     size_t asyncTexturesLoaded = 0;
     
     // Frame State
@@ -815,6 +821,9 @@ struct UnifiedRenderer::Impl {
     }
     
     id<MTLTexture> uploadTexture(const TextureData& tex, const char* name) {
+        if (tex.isCooked()) {
+            return uploadCookedTexture(tex, name);
+        }
         if (tex.pixels.empty()) {
             return defaultTexture;
         }
@@ -835,6 +844,119 @@ struct UnifiedRenderer::Impl {
         return texture;
     }
     
+    // Mip chain from the async cooker, RGBA8 or BCn
+    id<MTLTexture> uploadCookedTexture(const TextureData& tex, const char* name) {
+        MTLPixelFormat format = MTLPixelFormatRGBA8Unorm;
+        bool decode = false;
+        switch (tex.format) {
+            case TextureFormat::RGBA8: format = MTLPixelFormatRGBA8Unorm; break;
+#if TARGET_OS_OSX
+            case TextureFormat::BC1:   format = MTLPixelFormatBC1_RGBA; break;
+            case TextureFormat::BC3:   format = MTLPixelFormatBC3_RGBA; break;
+            case TextureFormat::BC5:   format = MTLPixelFormatBC5_RGUnorm; break;
+            case TextureFormat::BC7:   format = MTLPixelFormatBC7_RGBAUnorm; break;
+#else
+            default:
+                // No BCn on this GPU: decode on the CPU instead of showing white
+                decode = true;
+                break;
+#endif
+        }
+        
+        MTLTextureDescriptor* desc = [MTLTextureDescriptor 
+            texture2DDescriptorWithPixelFormat:format
+                                         width:tex.width
+                                        height:tex.height
+                                     mipmapped:tex.mips.size() > 1];
+        desc.mipmapLevelCount = tex.mips.size();
+        desc.usage = MTLTextureUsageShaderRead;
+        id<MTLTexture> texture = [device newTextureWithDescriptor:desc];
+        if (!texture) {
+            return defaultTexture;
+        }
+        
+        size_t blockBytes = decode ? 0 : textureBlockBytes(tex.format);
+        for (size_t level = 0; level < tex.mips.size(); ++level) {
+            const TextureMip& mip = tex.mips[level];
+            std::vector<uint8_t> rgba;
+            if (decode) {
+                rgba = textureLevelRGBA8(tex, static_cast<int>(level));
+                if (rgba.empty()) return defaultTexture;
+            }
+            NSUInteger bytesPerRow = blockBytes > 0 ? ((mip.width + 3) / 4) * blockBytes : mip.width * 4;
+            MTLRegion region = MTLRegionMake2D(0, 0, mip.width, mip.height);
+            [texture replaceRegion:region mipmapLevel:level withBytes:(decode ? rgba.data() : mip.data.data())
+                       bytesPerRow:bytesPerRow];
+        }
+        
+        std::cout << "[unified/metal] " << name << ": " << tex.width << "x" << tex.height << " "
+                  << textureFormatName(tex.format) << ", " << tex.mips.size() << " mips" << std::endl;
+        return texture;
+    }
+    
+    id<MTLTexture>* textureSlot(MetalMeshData& mesh, int slot) {
+        switch (slot) {
+            case 0: return &mesh.diffuseTexture;
+            case 1: return &mesh.normalTexture;
+            case 2: return &mesh.specularTexture;
+        }
+        return nullptr;
+    }
+    
+    // Drop the top `levels` mips of an uploaded texture with a GPU copy;
+    // the streamer no longer keeps the CPU data around
+    id<MTLTexture> trimTexture(id<MTLTexture> texture, int levels) {
+        NSUInteger mipCount = texture.mipmapLevelCount;
+        if (levels <= 0 || static_cast<NSUInteger>(levels) >= mipCount) return texture;
+        
+        MTLTextureDescriptor* desc = [MTLTextureDescriptor 
+            texture2DDescriptorWithPixelFormat:texture.pixelFormat
+                                         width:std::max<NSUInteger>(1, texture.width >> levels)
+                                        height:std::max<NSUInteger>(1, texture.height >> levels)
+                                     mipmapped:YES];
+        desc.mipmapLevelCount = mipCount - levels;
+        desc.usage = MTLTextureUsageShaderRead;
+        id<MTLTexture> trimmed = [device newTextureWithDescriptor:desc];
+        if (!trimmed) return texture;
+        
+        id<MTLCommandBuffer> commandBuffer = [commandQueue commandBuffer];
+        id<MTLBlitCommandEncoder> blit = [commandBuffer blitCommandEncoder];
+        [blit copyFromTexture:texture sourceSlice:0 sourceLevel:levels
+                    toTexture:trimmed destinationSlice:0 destinationLevel:0
+                   sliceCount:1 levelCount:mipCount - levels];
+        [blit endEncoding];
+        [commandBuffer commit];
+        return trimmed;
+    }
+    
+    // Keep streamed textures of a drawn model resident, ordered by screen size
+    void touchStreamedTextures(const RHILoadedModel& model, const float* worldMatrix) {
+        float center[3];
+        for (int i = 0; i < 3; ++i) {
+            center[i] = model.center[0] * worldMatrix[i] + model.center[1] * worldMatrix[4 + i] +
+                        model.center[2] * worldMatrix[8 + i] + worldMatrix[12 + i];
+        }
+        float dx = center[0] - cameraPos[0];
+        float dy = center[1] - cameraPos[1];
+        float dz = center[2] - cameraPos[2];
+        float screen = projectedScreenSize(sqrtf(dx*dx + dy*dy + dz*dz), model.radius,
+                                           3.14159f / 4.0f, static_cast<float>(height));
+        screen = floorf(screen / 16.0f) * 16.0f;  // Avoid re-sorting the queue every frame
+        
+        auto& asyncLoader = getAsyncTextureLoader();
+        for (const RHIGPUMesh& gpuMesh : model.meshes) {
+            if (gpuMesh.meshIndex >= meshStorage.size()) continue;
+            const MetalMeshData& mesh = meshStorage[gpuMesh.meshIndex];
+            for (int slot = 0; slot < 3; ++slot) {
+                uint32_t id = mesh.streamIds[slot];
+                if (id == 0) continue;
+                TexturePriority level = slot == 0 ? TexturePriority::High : TexturePriority::Normal;
+                asyncLoader.updatePriority(id, texturePriority(level, screen));
+                asyncLoader.touchTexture(id);
+            }
+        }
+    }
+    
     // ===== Post-Processing =====
     
     void createPostProcessResources() {
@@ -1193,6 +1315,11 @@ bool UnifiedRenderer::initialize(void* windowHandle, uint32_t width, uint32_t he
 void UnifiedRenderer::shutdown() {
     if (!impl_) return;
     waitForGPU();
+    auto& asyncLoader = getAsyncTextureLoader();
+    for (const auto& [id, slot] : impl_->pendingTextures) asyncLoader.cancel(id);
+    for (const auto& [id, slot] : impl_->streamedTextures) asyncLoader.releaseTexture(id);
+    impl_->pendingTextures.clear();
+    impl_->streamedTextures.clear();
     impl_->meshStorage.clear();
     impl_->ready = false;
 }
@@ -1228,13 +1355,13 @@ RHIGPUMesh UnifiedRenderer::uploadMesh(const Mesh& mesh) {
                                                        length:mesh.indices.size() * sizeof(uint32_t)
                                                       options:MTLResourceStorageModeShared];
     
-    metalMesh.diffuseTexture = impl_->uploadTexture(mesh.diffuseTexture, "diffuse");
-    metalMesh.normalTexture = impl_->uploadTexture(mesh.normalTexture, "normal");
-    metalMesh.specularTexture = impl_->uploadTexture(mesh.specularTexture, "specular");
+    metalMesh.diffuseTexture = impl_->uploadTexture(textureData(mesh.diffuseTexture), "diffuse");
+    metalMesh.normalTexture = impl_->uploadTexture(textureData(mesh.normalTexture), "normal");
+    metalMesh.specularTexture = impl_->uploadTexture(textureData(mesh.specularTexture), "specular");
     
-    gpu.hasDiffuseTexture = !mesh.diffuseTexture.pixels.empty();
-    gpu.hasNormalTexture = !mesh.normalTexture.pixels.empty();
-    gpu.hasSpecularTexture = !mesh.specularTexture.pixels.empty();
+    gpu.hasDiffuseTexture = hasPixels(mesh.diffuseTexture);
+    gpu.hasNormalTexture = hasPixels(mesh.normalTexture);
+    gpu.hasSpecularTexture = hasPixels(mesh.specularTexture);
     
     impl_->meshStorage.push_back(metalMesh);
     
@@ -1258,7 +1385,7 @@ bool UnifiedRenderer::loadModel(const std::string& path, RHILoadedModel& outMode
         const auto& mesh = result->meshes[i];
         auto gpuMesh = uploadMesh(mesh);
         outModel.meshes.push_back(gpuMesh);
-        if (!mesh.diffuseTexture.pixels.empty()) outModel.textureCount++;
+        if (hasPixels(mesh.diffuseTexture)) outModel.textureCount++;
     }
     
     outModel.center[0] = (result->minBounds[0] + result->maxBounds[0]) / 2.0f;
@@ -1325,24 +1452,26 @@ bool UnifiedRenderer::loadModelAsync(const std::string& path, RHILoadedModel& ou
         
         uint32_t meshIdx = static_cast<uint32_t>(impl_->meshStorage.size());
         
-        // Queue textures for async loading
-        if (!mesh.diffuseTexture.pixels.empty()) {
-            uint32_t reqId = asyncLoader.loadTextureFromMemory(mesh.diffuseTexture.pixels,
-                mesh.diffuseTexture.path.empty() ? "diffuse" : mesh.diffuseTexture.path);
+        // Queue textures for async loading; color first, renderModel refines
+        // the order by screen size once the model is drawn
+        if (hasPixels(mesh.diffuseTexture)) {
+            uint32_t reqId = asyncLoader.cookTexture(mesh.diffuseTexture, TextureRole::Albedo,
+                                                     texturePriority(TexturePriority::High));
             impl_->pendingTextures[reqId] = {meshIdx, 0};  // slot 0 = diffuse
+            metalMesh.streamIds[0] = reqId;
             gpu.hasDiffuseTexture = true;
             outModel.textureCount++;
         }
-        if (!mesh.normalTexture.pixels.empty()) {
-            uint32_t reqId = asyncLoader.loadTextureFromMemory(mesh.normalTexture.pixels,
-                mesh.normalTexture.path.empty() ? "normal" : mesh.normalTexture.path);
+        if (hasPixels(mesh.normalTexture)) {
+            uint32_t reqId = asyncLoader.cookTexture(mesh.normalTexture, TextureRole::Normal);
             impl_->pendingTextures[reqId] = {meshIdx, 1};  // slot 1 = normal
+            metalMesh.streamIds[1] = reqId;
             gpu.hasNormalTexture = true;
         }
-        if (!mesh.specularTexture.pixels.empty()) {
-            uint32_t reqId = asyncLoader.loadTextureFromMemory(mesh.specularTexture.pixels,
-                mesh.specularTexture.path.empty() ? "specular" : mesh.specularTexture.path);
+        if (hasPixels(mesh.specularTexture)) {
+            uint32_t reqId = asyncLoader.cookTexture(mesh.specularTexture, TextureRole::ORM);
             impl_->pendingTextures[reqId] = {meshIdx, 2};  // slot 2 = specular
+            metalMesh.streamIds[2] = reqId;
             gpu.hasSpecularTexture = true;
         }
         
@@ -1370,11 +1499,30 @@ bool UnifiedRenderer::loadModelAsync(const std::string& path, RHILoadedModel& ou
 
 void UnifiedRenderer::processAsyncTextures() {
     auto& asyncLoader = getAsyncTextureLoader();
+    asyncLoader.update();
     
     auto completed = asyncLoader.getCompletedTextures();
     for (auto& result : completed) {
         auto it = impl_->pendingTextures.find(result.id);
-        if (it == impl_->pendingTextures.end()) continue;
+        if (it == impl_->pendingTextures.end()) {
+            // Streaming update of an uploaded texture: trim or full restore
+            auto streamed = impl_->streamedTextures.find(result.id);
+            if (streamed == impl_->streamedTextures.end()) continue;
+            uint32_t meshIdx = streamed->second.first;
+            int slot = streamed->second.second;
+            if (meshIdx >= impl_->meshStorage.size()) continue;
+            
+            MetalMeshData& mesh = impl_->meshStorage[meshIdx];
+            id<MTLTexture>* texture = impl_->textureSlot(mesh, slot);
+            if (result.texture) {
+                *texture = impl_->uploadTexture(*result.texture, "restored");
+                mesh.streamFirstMip[slot] = 0;
+            } else if (result.firstMip > mesh.streamFirstMip[slot]) {
+                *texture = impl_->trimTexture(*texture, result.firstMip - mesh.streamFirstMip[slot]);
+                mesh.streamFirstMip[slot] = result.firstMip;
+            }
+            continue;
+        }
         
         uint32_t meshIdx = it->second.first;
         int slot = it->second.second;
@@ -1384,8 +1532,8 @@ void UnifiedRenderer::processAsyncTextures() {
             continue;
         }
         
-        if (result.success && !result.data.pixels.empty()) {
-            id<MTLTexture> texture = impl_->uploadTexture(result.data, "async");
+        if (result.success && hasPixels(result.texture)) {
+            id<MTLTexture> texture = impl_->uploadTexture(*result.texture, "async");
             
             MetalMeshData& mesh = impl_->meshStorage[meshIdx];
             switch (slot) {
@@ -1400,6 +1548,7 @@ void UnifiedRenderer::processAsyncTextures() {
                     break;
             }
             impl_->asyncTexturesLoaded++;
+            impl_->streamedTextures[result.id] = it->second;
         }
         
         impl_->pendingTextures.erase(it);
@@ -1650,6 +1799,8 @@ void UnifiedRenderer::renderModel(const RHILoadedModel& model, const float* worl
     impl_->constants.iblParams[2] = (float)(impl_->iblSettings.prefilteredMips - 1);
     impl_->constants.iblParams[3] = impl_->iblSettings.enabled && impl_->iblReady ? 1.0f : 0.0f;
     
+    impl_->touchStreamedTextures(model, worldMatrix);
+    
     for (size_t i = 0; i < model.meshes.size(); i++) {
         const RHIGPUMesh& gpuMesh = model.meshes[i];
         
@@ -8,6 +8,7 @@
 #include <cmath>
 #include <algorithm>
 #include <functional>
+#include <unordered_set>
 
 namespace luma {
 
@@ -186,10 +187,12 @@ public:
     // Get the frustum for custom tests
     const Frustum& getFrustum() const { return frustum_; }
     
-    // Cull a list of bounding spheres, return indices of visible objects
-    template<typename T>
+    // Cull a list of bounding spheres, return indices of visible objects.
+    // getBounds is any callable (inlined, no std::function per object); for
+    // retained scenes of thousands of objects use SceneCuller instead
+    template<typename T, typename GetBounds>
     CullResult cull(const std::vector<T>& objects,
-                    std::function<BoundingSphere(const T&)> getBounds,
+                    GetBounds&& getBounds,
                     std::vector<size_t>& outVisibleIndices) const {
         CullResult result;
         result.totalObjects = objects.size();
@@ -235,19 +238,17 @@ public:
     // Process occlusion query results (called after GPU queries complete)
     void processResults(const std::vector<OcclusionQueryResult>& results) {
         visibleObjects_.clear();
+        visibleObjects_.reserve(results.size());
         for (const auto& result : results) {
             if (result.visible && result.pixelCount >= pixelThreshold_) {
-                visibleObjects_.push_back(result.objectId);
+                visibleObjects_.insert(result.objectId);
             }
         }
     }
     
     // Check if object was visible in previous frame
     bool wasVisible(uint32_t objectId) const {
-        for (uint32_t id : visibleObjects_) {
-            if (id == objectId) return true;
-        }
-        return false;
+        return visibleObjects_.count(objectId) != 0;
     }
     
     // Get statistics
@@ -256,7 +257,7 @@ public:
 private:
     bool enabled_ = false;
     uint32_t pixelThreshold_ = 1;
-    std::vector<uint32_t> visibleObjects_;
+    std::unordered_set<uint32_t> visibleObjects_;
 };
 
 // ===== Combined Culling System =====
@@ -0,0 +1,833 @@
+// Scene Culling Implementation
+#include "scene_culling.h"
+#include "engine/foundation/worker_pool.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LUMA_CULL_SSE 1
+#elif defined(__aarch64__) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+#include <arm_neon.h>
+#define LUMA_CULL_NEON 1
+#endif
+
+namespace luma {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+constexpr float kDeadRadius = -1e30f;
+constexpr float kEmpty = 1e30f;
+constexpr uint32_t kNoLeaf = 0xFFFFFFFFu;
+constexpr uint32_t kAllPlanes = (1u << Frustum::PlaneCount) - 1;
+constexpr size_t kPendingGrain = 1024;
+
+// ===== 4-wide Lanes =====
+// Four objects (or four pixels) per step. Masks are all-ones lanes.
+#if defined(LUMA_CULL_SSE)
+using Float4 = __m128;
+inline Float4 set4(float v) { return _mm_set1_ps(v); }
+inline Float4 set4(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+inline Float4 load4(const float* p) { return _mm_loadu_ps(p); }
+inline void store4(float* p, Float4 v) { _mm_storeu_ps(p, v); }
+inline Float4 add4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+inline Float4 mul4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+inline Float4 max4(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+inline Float4 cmpge4(Float4 a, Float4 b) { return _mm_cmpge_ps(a, b); }
+inline Float4 cmplt4(Float4 a, Float4 b) { return _mm_cmplt_ps(a, b); }
+inline Float4 and4(Float4 a, Float4 b) { return _mm_and_ps(a, b); }
+inline int bits4(Float4 mask) { return _mm_movemask_ps(mask); }
+inline Float4 select4(Float4 mask, Float4 a, Float4 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+#elif defined(LUMA_CULL_NEON)
+struct Float4 { float32x4_t v; };
+inline Float4 set4(float v) { return {vdupq_n_f32(v)}; }
+inline Float4 set4(float a, float b, float c, float d) {
+    const float lanes[4] = {a, b, c, d};
+    return {vld1q_f32(lanes)};
+}
+inline Float4 load4(const float* p) { return {vld1q_f32(p)}; }
+inline void store4(float* p, Float4 v) { vst1q_f32(p, v.v); }
+inline Float4 add4(Float4 a, Float4 b) { return {vaddq_f32(a.v, b.v)}; }
+inline Float4 mul4(Float4 a, Float4 b) { return {vmulq_f32(a.v, b.v)}; }
+inline Float4 max4(Float4 a, Float4 b) { return {vmaxq_f32(a.v, b.v)}; }
+inline Float4 cmpge4(Float4 a, Float4 b) { return {vreinterpretq_f32_u32(vcgeq_f32(a.v, b.v))}; }
+inline Float4 cmplt4(Float4 a, Float4 b) { return {vreinterpretq_f32_u32(vcltq_f32(a.v, b.v))}; }
+inline Float4 and4(Float4 a, Float4 b) {
+    return {vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v)))};
+}
+inline int bits4(Float4 mask) {
+    const uint32_t weights[4] = {1, 2, 4, 8};
+    return (int)vaddvq_u32(vandq_u32(vreinterpretq_u32_f32(mask.v), vld1q_u32(weights)));
+}
+inline Float4 select4(Float4 mask, Float4 a, Float4 b) {
+    return {vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v)};
+}
+#else
+struct Float4 { float v[4]; };
+inline Float4 set4(float x) { return {{x, x, x, x}}; }
+inline Float4 set4(float a, float b, float c, float d) { return {{a, b, c, d}}; }
+inline Float4 load4(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+inline void store4(float* p, Float4 a) { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+inline Float4 add4(Float4 a, Float4 b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+inline Float4 mul4(Float4 a, Float4 b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+inline Float4 max4(Float4 a, Float4 b) {
+    return {{std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3])}};
+}
+inline Float4 maskOf(bool b0, bool b1, bool b2, bool b3) {
+    Float4 r;
+    const bool bits[4] = {b0, b1, b2, b3};
+    for (int i = 0; i < 4; i++) {
+        uint32_t u = bits[i] ? 0xFFFFFFFFu : 0u;
+        std::memcpy(&r.v[i], &u, 4);
+    }
+    return r;
+}
+inline bool lane(Float4 mask, int i) {
+    uint32_t u;
+    std::memcpy(&u, &mask.v[i], 4);
+    return u != 0;
+}
+inline Float4 cmpge4(Float4 a, Float4 b) {
+    return maskOf(a.v[0] >= b.v[0], a.v[1] >= b.v[1], a.v[2] >= b.v[2], a.v[3] >= b.v[3]);
+}
+inline Float4 cmplt4(Float4 a, Float4 b) {
+    return maskOf(a.v[0] < b.v[0], a.v[1] < b.v[1], a.v[2] < b.v[2], a.v[3] < b.v[3]);
+}
+inline Float4 and4(Float4 a, Float4 b) {
+    return maskOf(lane(a, 0) && lane(b, 0), lane(a, 1) && lane(b, 1), lane(a, 2) && lane(b, 2), lane(a, 3) && lane(b, 3));
+}
+inline int bits4(Float4 mask) {
+    return (lane(mask, 0) ? 1 : 0) | (lane(mask, 1) ? 2 : 0) | (lane(mask, 2) ? 4 : 0) | (lane(mask, 3) ? 8 : 0);
+}
+inline Float4 select4(Float4 mask, Float4 a, Float4 b) {
+    return {{lane(mask, 0) ? a.v[0] : b.v[0], lane(mask, 1) ? a.v[1] : b.v[1],
+             lane(mask, 2) ? a.v[2] : b.v[2], lane(mask, 3) ? a.v[3] : b.v[3]}};
+}
+#endif
+
+// ===== Plane Tests =====
+
+// Outside if the box corner furthest along the normal is behind the plane;
+// fully inside if the nearest corner is in front
+enum class BoxSide { Outside, Straddles, Inside };
+
+inline BoxSide classifyBox(const Plane& plane, const float* boxMin, const float* boxMax) {
+    const float n[3] = {plane.normal.x, plane.normal.y, plane.normal.z};
+    float furthest = plane.distance, nearest = plane.distance;
+    for (int a = 0; a < 3; a++) {
+        furthest += n[a] * (n[a] >= 0.0f ? boxMax[a] : boxMin[a]);
+        nearest += n[a] * (n[a] >= 0.0f ? boxMin[a] : boxMax[a]);
+    }
+    if (furthest < 0.0f) return BoxSide::Outside;
+    return nearest >= 0.0f ? BoxSide::Inside : BoxSide::Straddles;
+}
+
+// Plane coefficients splatted once per cull, with the box-corner stream
+// each normal component selects
+struct PlaneLanes {
+    Float4 nx, ny, nz, d;
+    int sx, sy, sz;  // stream index of the furthest corner per axis
+};
+
+struct TraversalTask {
+    uint32_t node;       // kNoLeaf for a pending-slot range
+    uint32_t planeMask;  // planes still straddled
+    uint32_t begin, end; // pending slots
+};
+
+struct TaskOutput {
+    std::vector<SceneCuller::Handle> visible;
+    size_t nodesVisited = 0;
+    size_t objectsTested = 0;
+};
+
+// Screen-space occluder triangle, z is post-projection z/w
+struct OccluderTriangle {
+    float x[3], y[3], z[3];
+    int minX, minY, maxX, maxY;
+};
+
+// Homogeneous projection of a world point
+inline void project(const Mat4& m, float x, float y, float z, float out[4]) {
+    out[0] = m.m[0] * x + m.m[4] * y + m.m[8] * z + m.m[12];
+    out[1] = m.m[1] * x + m.m[5] * y + m.m[9] * z + m.m[13];
+    out[2] = m.m[2] * x + m.m[6] * y + m.m[10] * z + m.m[14];
+    out[3] = m.m[3] * x + m.m[7] * y + m.m[11] * z + m.m[15];
+}
+
+}  // namespace
+
+// ===== Frame State =====
+struct SceneCuller::Impl {
+    explicit Impl(int threads) : pool(threads) {}
+
+    WorkerPool pool;
+
+    // Frame scratch, reused between frames
+    std::vector<TraversalTask> tasks;
+    std::vector<TaskOutput> outputs;
+    std::vector<Handle> candidates;
+    std::vector<uint8_t> occluded;
+    std::vector<OccluderTriangle> occluderTriangles;
+};
+
+// ===== Objects =====
+
+SceneCuller::SceneCuller(int threads) {
+    if (threads <= 0) threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    impl_ = std::make_unique<Impl>(threads);
+    setOcclusionResolution(depthWidth_, depthHeight_);
+}
+
+SceneCuller::~SceneCuller() = default;
+
+int SceneCuller::threadCount() const { return impl_->pool.getThreadCount(); }
+
+SceneCuller::Handle SceneCuller::add(const Vec3& boundsMin, const Vec3& boundsMax) {
+    Handle handle;
+    if (!freeHandles_.empty()) {
+        handle = freeHandles_.back();
+        freeHandles_.pop_back();
+    } else {
+        handle = (Handle)alive_.size();
+        boxes_.resize(boxes_.size() + 6);
+        slotOf_.push_back(kInvalidHandle);
+        alive_.push_back(0);
+        occluder_.push_back(0);
+        visibleFrame_.push_back(0);
+    }
+    float* box = &boxes_[handle * 6];
+    box[0] = boundsMin.x; box[1] = boundsMin.y; box[2] = boundsMin.z;
+    box[3] = boundsMax.x; box[4] = boundsMax.y; box[5] = boundsMax.z;
+    alive_[handle] = 1;
+    occluder_[handle] = 0;
+    visibleFrame_[handle] = 0;
+    liveCount_++;
+
+    // Pending until the next rebuild
+    uint32_t slot = allocateSlot();
+    slotOf_[handle] = slot;
+    writeSlot(slot, handle);
+    staleCount_++;
+    return handle;
+}
+
+SceneCuller::Handle SceneCuller::add(const BoundingSphere& sphere) {
+    Vec3 extent(sphere.radius, sphere.radius, sphere.radius);
+    return add(sphere.center - extent, sphere.center + extent);
+}
+
+void SceneCuller::update(Handle handle, const Vec3& boundsMin, const Vec3& boundsMax) {
+    if (handle >= alive_.size() || !alive_[handle]) return;
+    float* box = &boxes_[handle * 6];
+    box[0] = boundsMin.x; box[1] = boundsMin.y; box[2] = boundsMin.z;
+    box[3] = boundsMax.x; box[4] = boundsMax.y; box[5] = boundsMax.z;
+    uint32_t slot = slotOf_[handle];
+    writeSlot(slot, handle);
+    uint32_t leaf = slotLeaf_[slot];
+    if (leaf != kNoLeaf) {
+        nodeDirty_[leaf] = 1;
+        anyDirty_ = true;
+    }
+}
+
+void SceneCuller::update(Handle handle, const BoundingSphere& sphere) {
+    Vec3 extent(sphere.radius, sphere.radius, sphere.radius);
+    update(handle, sphere.center - extent, sphere.center + extent);
+}
+
+void SceneCuller::remove(Handle handle) {
+    if (handle >= alive_.size() || !alive_[handle]) return;
+    killSlot(slotOf_[handle]);
+    if (occluder_[handle]) occluderCount_--;
+    alive_[handle] = 0;
+    occluder_[handle] = 0;
+    slotOf_[handle] = kInvalidHandle;
+    freeHandles_.push_back(handle);
+    liveCount_--;
+    // Leaf bounds stay conservative until the next refit or rebuild
+    staleCount_++;
+}
+
+void SceneCuller::clear() {
+    boxes_.clear();
+    slotOf_.clear();
+    alive_.clear();
+    occluder_.clear();
+    visibleFrame_.clear();
+    freeHandles_.clear();
+    liveCount_ = 0;
+    for (auto& stream : soa_) stream.clear();
+    slotHandle_.clear();
+    slotLeaf_.clear();
+    usedSlots_ = 0;
+    bvhSlots_ = 0;
+    nodes_.clear();
+    nodeDirty_.clear();
+    anyDirty_ = false;
+    needsRebuild_ = false;
+    staleCount_ = 0;
+    occluderCount_ = 0;
+}
+
+void SceneCuller::setOccluder(Handle handle, bool occluder) {
+    if (handle >= alive_.size() || !alive_[handle] || (occluder_[handle] != 0) == occluder) return;
+    occluder_[handle] = occluder ? 1 : 0;
+    if (occluder) occluderCount_++;
+    else occluderCount_--;
+}
+
+void SceneCuller::setOcclusionResolution(uint32_t width, uint32_t height) {
+    auto roundUp = [](uint32_t v) { return std::max<uint32_t>(kHiZTile, (v + kHiZTile - 1) / kHiZTile * kHiZTile); };
+    depthWidth_ = roundUp(width);
+    depthHeight_ = roundUp(height);
+    depth_.assign((size_t)depthWidth_ * depthHeight_, FLT_MAX);
+    hiZ_.assign((size_t)(depthWidth_ / kHiZTile) * (depthHeight_ / kHiZTile), FLT_MAX);
+}
+
+// Slots grow four at a time so every SIMD step reads whole lanes
+uint32_t SceneCuller::allocateSlot() {
+    if (usedSlots_ == slotHandle_.size()) {
+        size_t grown = slotHandle_.size() + 4;
+        for (auto& stream : soa_) stream.resize(grown);
+        slotHandle_.resize(grown);
+        slotLeaf_.resize(grown, kNoLeaf);
+        for (size_t slot = grown - 4; slot < grown; slot++) killSlot((uint32_t)slot);
+    }
+    slotLeaf_[usedSlots_] = kNoLeaf;
+    return usedSlots_++;
+}
+
+void SceneCuller::writeSlot(uint32_t slot, Handle handle) {
+    const float* box = &boxes_[handle * 6];
+    BoundingSphere sphere = BoundingSphere::fromMinMax(Vec3(box[0], box[1], box[2]), Vec3(box[3], box[4], box[5]));
+    soa_[CX][slot] = sphere.center.x;
+    soa_[CY][slot] = sphere.center.y;
+    soa_[CZ][slot] = sphere.center.z;
+    soa_[R][slot] = sphere.radius;
+    for (int a = 0; a < 3; a++) {
+        soa_[MINX + a][slot] = box[a];
+        soa_[MAXX + a][slot] = box[3 + a];
+    }
+    slotHandle_[slot] = handle;
+}
+
+// Dead slots fail every plane: negative radius for the sphere test and an
+// inverted box for the corner test
+void SceneCuller::killSlot(uint32_t slot) {
+    soa_[CX][slot] = soa_[CY][slot] = soa_[CZ][slot] = 0.0f;
+    soa_[R][slot] = kDeadRadius;
+    for (int a = 0; a < 3; a++) {
+        soa_[MINX + a][slot] = kEmpty;
+        soa_[MAXX + a][slot] = -kEmpty;
+    }
+    slotHandle_[slot] = kInvalidHandle;
+}
+
+// ===== BVH =====
+
+namespace {
+
+float boxArea(const float* boxMin, const float* boxMax) {
+    float e[3];
+    for (int a = 0; a < 3; a++) e[a] = std::max(0.0f, boxMax[a] - boxMin[a]);
+    return 2.0f * (e[0] * e[1] + e[1] * e[2] + e[2] * e[0]);
+}
+
+}  // namespace
+
+void SceneCuller::buildBvh() {
+    std::vector<Handle> handles;
+    handles.reserve(liveCount_);
+    for (Handle h = 0; h < (Handle)alive_.size(); h++) {
+        if (alive_[h]) handles.push_back(h);
+    }
+
+    for (auto& stream : soa_) stream.clear();
+    slotHandle_.clear();
+    slotLeaf_.clear();
+    usedSlots_ = 0;
+    nodes_.clear();
+    nodes_.reserve(handles.size() / (kLeafSize / 2) * 2 + 1);
+    if (!handles.empty()) buildNode(handles.data(), (uint32_t)handles.size());
+
+    bvhSlots_ = usedSlots_;
+    nodeDirty_.assign(nodes_.size(), 0);
+    anyDirty_ = false;
+    needsRebuild_ = false;
+    staleCount_ = 0;
+    builtLeafArea_ = 0.0f;
+    for (const Node& node : nodes_) {
+        if (node.count) builtLeafArea_ += boxArea(node.boundsMin, node.boundsMax);
+    }
+}
+
+// Median split on the longest centroid axis; leaves get whole SIMD groups
+uint32_t SceneCuller::buildNode(Handle* handles, uint32_t count) {
+    uint32_t index = (uint32_t)nodes_.size();
+    nodes_.emplace_back();
+    float boundsMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX}, boundsMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    float centroidMin[3] = {FLT_MAX, FLT_MAX, FLT_MAX}, centroidMax[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (uint32_t i = 0; i < count; i++) {
+        const float* box = &boxes_[handles[i] * 6];
+        for (int a = 0; a < 3; a++) {
+            boundsMin[a] = std::min(boundsMin[a], box[a]);
+            boundsMax[a] = std::max(boundsMax[a], box[3 + a]);
+            float c = (box[a] + box[3 + a]) * 0.5f;
+            centroidMin[a] = std::min(centroidMin[a], c);
+            centroidMax[a] = std::max(centroidMax[a], c);
+        }
+    }
+    for (int a = 0; a < 3; a++) {
+        nodes_[index].boundsMin[a] = boundsMin[a];
+        nodes_[index].boundsMax[a] = boundsMax[a];
+    }
+
+    int axis = 0;
+    for (int a = 1; a < 3; a++) {
+        if (centroidMax[a] - centroidMin[a] > centroidMax[axis] - centroidMin[axis]) axis = a;
+    }
+    if (count <= (uint32_t)kLeafSize || centroidMax[axis] <= centroidMin[axis]) {
+        uint32_t first = usedSlots_;
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t slot = allocateSlot();
+            slotOf_[handles[i]] = slot;
+            writeSlot(slot, handles[i]);
+            slotLeaf_[slot] = index;
+        }
+        while (usedSlots_ % 4) slotLeaf_[allocateSlot()] = index;
+        nodes_[index].first = first;
+        nodes_[index].count = usedSlots_ - first;
+        return index;
+    }
+
+    uint32_t half = count / 2;
+    std::nth_element(handles, handles + half, handles + count, [&](Handle a, Handle b) {
+        return boxes_[a * 6 + axis] + boxes_[a * 6 + 3 + axis] < boxes_[b * 6 + axis] + boxes_[b * 6 + 3 + axis];
+    });
+    buildNode(handles, half);
+    uint32_t right = buildNode(handles + half, count - half);
+    nodes_[index].first = right;
+    nodes_[index].count = 0;
+    return index;
+}
+
+// Children follow their parent, so a reverse sweep sees them refitted first
+void SceneCuller::refitBvh() {
+    for (size_t i = nodes_.size(); i-- > 0;) {
+        Node& node = nodes_[i];
+        if (node.count) {
+            if (!nodeDirty_[i]) continue;
+            float boundsMin[3] = {kEmpty, kEmpty, kEmpty}, boundsMax[3] = {-kEmpty, -kEmpty, -kEmpty};
+            for (uint32_t slot = node.first; slot < node.first + node.count; slot++) {
+                if (soa_[R][slot] < 0.0f) continue;
+                for (int a = 0; a < 3; a++) {
+                    boundsMin[a] = std::min(boundsMin[a], soa_[MINX + a][slot]);
+                    boundsMax[a] = std::max(boundsMax[a], soa_[MAXX + a][slot]);
+                }
+            }
+            std::memcpy(node.boundsMin, boundsMin, sizeof(boundsMin));
+            std::memcpy(node.boundsMax, boundsMax, sizeof(boundsMax));
+        } else {
+            const Node& left = nodes_[i + 1];
+            const Node& right = nodes_[node.first];
+            if (!nodeDirty_[i + 1] && !nodeDirty_[node.first]) continue;
+            for (int a = 0; a < 3; a++) {
+                node.boundsMin[a] = std::min(left.boundsMin[a], right.boundsMin[a]);
+                node.boundsMax[a] = std::max(left.boundsMax[a], right.boundsMax[a]);
+            }
+            nodeDirty_[i] = 1;
+        }
+    }
+
+    // Moving objects stretch leaves; rebuild once culling efficiency halves
+    float leafArea = 0.0f;
+    for (size_t i = 0; i < nodes_.size(); i++) {
+        if (nodes_[i].count) leafArea += boxArea(nodes_[i].boundsMin, nodes_[i].boundsMax);
+    }
+    if (leafArea > builtLeafArea_ * 2.0f) needsRebuild_ = true;
+    std::fill(nodeDirty_.begin(), nodeDirty_.end(), 0);
+    anyDirty_ = false;
+}
+
+// ===== Occlusion =====
+
+// Front and back faces of every visible occluder box, clipped to the near
+// plane in world space; rows are then rasterized in parallel bands keeping
+// the nearest z/w, and each band reduces its 8x8 tiles to max depth
+void SceneCuller::rasterizeOccluders(const Frustum& frustum, const Mat4& viewProj,
+                                     const std::vector<Handle>& candidates) {
+    static const int kFaces[6][4] = {
+        {0, 2, 3, 1}, {4, 5, 7, 6},  // -x, +x
+        {0, 1, 5, 4}, {2, 6, 7, 3},  // -y, +y
+        {0, 4, 6, 2}, {1, 3, 7, 5},  // -z, +z
+    };
+    const Plane& nearPlane = frustum.planes[Frustum::Near];
+    const float width = (float)depthWidth_, height = (float)depthHeight_;
+
+    auto& triangles = impl_->occluderTriangles;
+    triangles.clear();
+    for (Handle handle : candidates) {
+        if (!occluder_[handle]) continue;
+        const float* box = &boxes_[handle * 6];
+        Vec3 corners[8];
+        for (int c = 0; c < 8; c++) {
+            corners[c] = Vec3((c & 4) ? box[3] : box[0], (c & 2) ? box[4] : box[1], (c & 1) ? box[5] : box[2]);
+        }
+        for (const auto& face : kFaces) {
+            // Sutherland-Hodgman against the near plane
+            Vec3 polygon[5];
+            int n = 0;
+            for (int e = 0; e < 4; e++) {
+                const Vec3& a = corners[face[e]];
+                const Vec3& b = corners[face[(e + 1) % 4]];
+                float da = nearPlane.distanceToPoint(a), db = nearPlane.distanceToPoint(b);
+                if (da >= 0.0f) polygon[n++] = a;
+                if ((da >= 0.0f) != (db >= 0.0f)) polygon[n++] = a + (b - a) * (da / (da - db));
+            }
+            if (n < 3) continue;
+
+            float sx[5], sy[5], sz[5];
+            for (int v = 0; v < n; v++) {
+                float clip[4];
+                project(viewProj, polygon[v].x, polygon[v].y, polygon[v].z, clip);
+                float invW = 1.0f / std::max(clip[3], 1e-6f);
+                sx[v] = (clip[0] * invW * 0.5f + 0.5f) * width;
+                sy[v] = (clip[1] * invW * 0.5f + 0.5f) * height;
+                sz[v] = clip[2] * invW;
+            }
+            for (int v = 1; v + 1 < n; v++) {
+                OccluderTriangle tri;
+                const int ids[3] = {0, v, v + 1};
+                for (int k = 0; k < 3; k++) {
+                    tri.x[k] = sx[ids[k]];
+                    tri.y[k] = sy[ids[k]];
+                    tri.z[k] = sz[ids[k]];
+                }
+                float area = (tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0]) - (tri.y[1] - tri.y[0]) * (tri.x[2] - tri.x[0]);
+                if (std::fabs(area) < 1e-8f) continue;
+                if (area < 0.0f) {
+                    std::swap(tri.x[1], tri.x[2]);
+                    std::swap(tri.y[1], tri.y[2]);
+                    std::swap(tri.z[1], tri.z[2]);
+                }
+                // Pixel centers x + 0.5 inside [min, max]
+                float minX = std::min({tri.x[0], tri.x[1], tri.x[2]}), maxX = std::max({tri.x[0], tri.x[1], tri.x[2]});
+                float minY = std::min({tri.y[0], tri.y[1], tri.y[2]}), maxY = std::max({tri.y[0], tri.y[1], tri.y[2]});
+                tri.minX = std::max(0, (int)std::ceil(std::max(minX, -1.0f) - 0.5f));
+                tri.minY = std::max(0, (int)std::ceil(std::max(minY, -1.0f) - 0.5f));
+                tri.maxX = std::min((int)depthWidth_ - 1, (int)std::floor(std::min(maxX, width + 1.0f) - 0.5f));
+                tri.maxY = std::min((int)depthHeight_ - 1, (int)std::floor(std::min(maxY, height + 1.0f) - 0.5f));
+                if (tri.minX > tri.maxX || tri.minY > tri.maxY) continue;
+                triangles.push_back(tri);
+            }
+        }
+    }
+    stats_.occluderTriangles = triangles.size();
+
+    const uint32_t tilesX = depthWidth_ / kHiZTile;
+    auto band = [&](size_t begin, size_t end) {
+        for (size_t tileRow = begin; tileRow < end; tileRow++) {
+            int rowBegin = (int)tileRow * kHiZTile, rowEnd = rowBegin + kHiZTile;
+            std::fill(depth_.begin() + (size_t)rowBegin * depthWidth_, depth_.begin() + (size_t)rowEnd * depthWidth_, FLT_MAX);
+            for (const OccluderTriangle& tri : triangles) {
+                int y0 = std::max(tri.minY, rowBegin), y1 = std::min(tri.maxY, rowEnd - 1);
+                if (y0 > y1) continue;
+                // Edge k runs from vertex k to k + 1; E = a * x + b * y + c, >= 0 inside
+                float ea[3], eb[3], ec[3];
+                for (int k = 0; k < 3; k++) {
+                    int j = (k + 1) % 3;
+                    ea[k] = -(tri.y[j] - tri.y[k]);
+                    eb[k] = tri.x[j] - tri.x[k];
+                    ec[k] = -(ea[k] * tri.x[k] + eb[k] * tri.y[k]);
+                }
+                float area = (tri.x[1] - tri.x[0]) * (tri.y[2] - tri.y[0]) - (tri.y[1] - tri.y[0]) * (tri.x[2] - tri.x[0]);
+                float dzdx = ((tri.z[1] - tri.z[0]) * (tri.y[2] - tri.y[0]) - (tri.z[2] - tri.z[0]) * (tri.y[1] - tri.y[0])) / area;
+                float dzdy = ((tri.z[2] - tri.z[0]) * (tri.x[1] - tri.x[0]) - (tri.z[1] - tri.z[0]) * (tri.x[2] - tri.x[0])) / area;
+                float zc = tri.z[0] - dzdx * tri.x[0] - dzdy * tri.y[0];
+                int x0 = tri.minX & ~3;
+                Float4 step = set4(0.5f, 1.5f, 2.5f, 3.5f);
+                for (int y = y0; y <= y1; y++) {
+                    float py = (float)y + 0.5f;
+                    float* row = &depth_[(size_t)y * depthWidth_];
+                    for (int x = x0; x <= tri.maxX; x += 4) {
+                        Float4 px = add4(set4((float)x), step);
+                        Float4 inside = set4(0.0f);
+                        inside = cmpge4(add4(mul4(px, set4(ea[0])), set4(eb[0] * py + ec[0])), inside);
+                        inside = and4(inside, cmpge4(add4(mul4(px, set4(ea[1])), set4(eb[1] * py + ec[1])), set4(0.0f)));
+                        inside = and4(inside, cmpge4(add4(mul4(px, set4(ea[2])), set4(eb[2] * py + ec[2])), set4(0.0f)));
+                        if (!bits4(inside)) continue;
+                        Float4 z = add4(mul4(px, set4(dzdx)), set4(dzdy * py + zc));
+                        Float4 old = load4(row + x);
+                        store4(row + x, select4(and4(inside, cmplt4(z, old)), z, old));
+                    }
+                }
+            }
+            for (uint32_t tx = 0; tx < tilesX; tx++) {
+                Float4 tileMax = set4(-FLT_MAX);
+                for (int y = rowBegin; y < rowEnd; y++) {
+                    const float* row = &depth_[(size_t)y * depthWidth_ + tx * kHiZTile];
+                    tileMax = max4(tileMax, max4(load4(row), load4(row + 4)));
+                }
+                float lanes[4];
+                store4(lanes, tileMax);
+                hiZ_[tileRow * tilesX + tx] = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+            }
+        }
+    };
+    impl_->pool.parallelFor(depthHeight_ / kHiZTile, 1, band);
+}
+
+// ===== Cull =====
+
+CullResult SceneCuller::cull(const Mat4& viewProj, std::vector<Handle>& outVisible) {
+    auto start = Clock::now();
+    Impl& im = *impl_;
+    stats_ = {};
+    stats_.totalObjects = liveCount_;
+    if (++frame_ == 0) {
+        std::fill(visibleFrame_.begin(), visibleFrame_.end(), 0);
+        frame_ = 1;
+    }
+
+    // 1. BVH maintenance
+    auto bvhStart = Clock::now();
+    if (needsRebuild_ || nodes_.empty() != (liveCount_ == 0) ||
+        staleCount_ > std::max<size_t>(64, liveCount_ / 8)) {
+        buildBvh();
+        stats_.rebuilt = true;
+    } else if (anyDirty_) {
+        refitBvh();
+        stats_.refitted = true;
+    }
+    stats_.bvhMs = msSince(bvhStart);
+
+    // 2. Frustum pass. Expand the top of the tree in place (keeps subtree
+    // order) until there is enough parallel work
+    auto frustumStart = Clock::now();
+    Frustum frustum;
+    frustum.extractFromMatrix(viewProj);
+    PlaneLanes planes[Frustum::PlaneCount];
+    for (int p = 0; p < Frustum::PlaneCount; p++) {
+        const Plane& plane = frustum.planes[p];
+        planes[p] = {set4(plane.normal.x), set4(plane.normal.y), set4(plane.normal.z), set4(plane.distance),
+                     plane.normal.x >= 0.0f ? (int)MAXX : (int)MINX,
+                     plane.normal.y >= 0.0f ? (int)MAXY : (int)MINY,
+                     plane.normal.z >= 0.0f ? (int)MAXZ : (int)MINZ};
+    }
+    // Returns false if rejected; clears the bits of planes the node is inside
+    auto testNode = [&](uint32_t nodeIndex, uint32_t& planeMask) {
+        const Node& node = nodes_[nodeIndex];
+        for (int p = 0; p < Frustum::PlaneCount; p++) {
+            if (!(planeMask & (1u << p))) continue;
+            BoxSide side = classifyBox(frustum.planes[p], node.boundsMin, node.boundsMax);
+            if (side == BoxSide::Outside) return false;
+            if (side == BoxSide::Inside) planeMask &= ~(1u << p);
+        }
+        return true;
+    };
+
+    auto& tasks = im.tasks;
+    tasks.clear();
+    size_t topNodes = 0;
+    if (!nodes_.empty()) {
+        uint32_t rootMask = kAllPlanes;
+        topNodes++;
+        if (testNode(0, rootMask)) tasks.push_back({0, rootMask, 0, 0});
+        const size_t target = (size_t)im.pool.getThreadCount() * 8;
+        std::vector<TraversalTask> next;
+        bool expanded = true;
+        while (expanded && !tasks.empty() && tasks.size() < target) {
+            expanded = false;
+            next.clear();
+            for (const TraversalTask& task : tasks) {
+                const Node& node = nodes_[task.node];
+                if (node.count || task.planeMask == 0) {
+                    next.push_back(task);
+                    continue;
+                }
+                expanded = true;
+                for (uint32_t child : {task.node + 1, node.first}) {
+                    uint32_t mask = task.planeMask;
+                    topNodes++;
+                    if (testNode(child, mask)) next.push_back({child, mask, 0, 0});
+                }
+            }
+            tasks.swap(next);
+        }
+    }
+    for (uint32_t begin = bvhSlots_; begin < usedSlots_; begin += (uint32_t)kPendingGrain) {
+        tasks.push_back({kNoLeaf, kAllPlanes, begin, std::min<uint32_t>(usedSlots_, begin + (uint32_t)kPendingGrain)});
+    }
+
+    // Four slots per step: sphere against every straddled plane, then the
+    // box corner furthest along each normal
+    auto testSlots = [&](uint32_t begin, uint32_t end, uint32_t planeMask, TaskOutput& out) {
+        for (uint32_t slot = begin; slot < end; slot += 4) {
+            Float4 visible = cmpge4(load4(&soa_[R][slot]), set4(0.0f));
+            if (planeMask) {
+                Float4 cx = load4(&soa_[CX][slot]), cy = load4(&soa_[CY][slot]), cz = load4(&soa_[CZ][slot]);
+                Float4 negR = mul4(load4(&soa_[R][slot]), set4(-1.0f));
+                for (int p = 0; p < Frustum::PlaneCount; p++) {
+                    if (!(planeMask & (1u << p))) continue;
+                    const PlaneLanes& pl = planes[p];
+                    Float4 d = add4(add4(mul4(pl.nx, cx), mul4(pl.ny, cy)), add4(mul4(pl.nz, cz), pl.d));
+                    visible = and4(visible, cmpge4(d, negR));
+                    Float4 corner = add4(add4(mul4(pl.nx, load4(&soa_[pl.sx][slot])), mul4(pl.ny, load4(&soa_[pl.sy][slot]))),
+                                      add4(mul4(pl.nz, load4(&soa_[pl.sz][slot])), pl.d));
+                    visible = and4(visible, cmpge4(corner, set4(0.0f)));
+                }
+                out.objectsTested += 4;
+            }
+            int bits = bits4(visible);
+            for (int i = 0; bits; i++, bits >>= 1) {
+                if (bits & 1) out.visible.push_back(slotHandle_[slot + i]);
+            }
+        }
+    };
+
+    im.outputs.resize(std::max(im.outputs.size(), tasks.size()));
+    auto traverse = [&](size_t begin, size_t end) {
+        uint32_t stack[128][2];  // two per level of a median-split tree
+        for (size_t t = begin; t < end; t++) {
+            const TraversalTask& task = tasks[t];
+            TaskOutput& out = im.outputs[t];
+            out.visible.clear();
+            out.nodesVisited = 0;
+            out.objectsTested = 0;
+            if (task.node == kNoLeaf) {
+                testSlots(task.begin, task.end, task.planeMask, out);
+                continue;
+            }
+            int depth = 0;
+            stack[depth][0] = task.node;
+            stack[depth][1] = task.planeMask;
+            depth++;
+            while (depth > 0) {
+                depth--;
+                uint32_t nodeIndex = stack[depth][0], mask = stack[depth][1];
+                const Node& node = nodes_[nodeIndex];
+                if (node.count) {
+                    testSlots(node.first, node.first + node.count, mask, out);
+                    continue;
+                }
+                // Right first so the left subtree is emitted first
+                for (uint32_t child : {node.first, nodeIndex + 1}) {
+                    uint32_t childMask = mask;
+                    out.nodesVisited++;
+                    if (childMask == 0 || testNode(child, childMask)) {
+                        stack[depth][0] = child;
+                        stack[depth][1] = childMask;
+                        depth++;
+                    }
+                }
+            }
+        }
+    };
+    im.pool.parallelFor(tasks.size(), 1, traverse);
+
+    auto& candidates = im.candidates;
+    candidates.clear();
+    stats_.nodesVisited = topNodes;
+    for (size_t t = 0; t < tasks.size(); t++) {
+        const TaskOutput& out = im.outputs[t];
+        candidates.insert(candidates.end(), out.visible.begin(), out.visible.end());
+        stats_.nodesVisited += out.nodesVisited;
+        stats_.objectsTested += out.objectsTested;
+    }
+    stats_.frustumCulled = liveCount_ - candidates.size();
+    stats_.frustumMs = msSince(frustumStart);
+
+    // 3 + 4. Occlusion
+    outVisible.clear();
+    if (occlusionEnabled_ && occluderCount_ > 0 && !candidates.empty()) {
+        auto occluderStart = Clock::now();
+        rasterizeOccluders(frustum, viewProj, candidates);
+        stats_.occluderMs = msSince(occluderStart);
+
+        auto occlusionStart = Clock::now();
+        const Plane& nearPlane = frustum.planes[Frustum::Near];
+        const uint32_t tilesX = depthWidth_ / kHiZTile;
+        const float width = (float)depthWidth_, height = (float)depthHeight_;
+        auto isOccluded = [&](Handle handle) {
+            const float* box = &boxes_[handle * 6];
+            float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX, nearest = FLT_MAX;
+            for (int c = 0; c < 8; c++) {
+                Vec3 corner((c & 4) ? box[3] : box[0], (c & 2) ? box[4] : box[1], (c & 1) ? box[5] : box[2]);
+                // Crossing the near plane: nothing can be in front of it
+                if (nearPlane.distanceToPoint(corner) < 0.0f) return false;
+                float clip[4];
+                project(viewProj, corner.x, corner.y, corner.z, clip);
+                float invW = 1.0f / clip[3];
+                float sx = (clip[0] * invW * 0.5f + 0.5f) * width;
+                float sy = (clip[1] * invW * 0.5f + 0.5f) * height;
+                minX = std::min(minX, sx); maxX = std::max(maxX, sx);
+                minY = std::min(minY, sy); maxY = std::max(maxY, sy);
+                nearest = std::min(nearest, clip[2] * invW);
+            }
+            // Every pixel the rect touches must hold a nearer occluder
+            int x0 = std::max(0, (int)std::floor(std::max(minX, -1.0f)));
+            int y0 = std::max(0, (int)std::floor(std::max(minY, -1.0f)));
+            int x1 = std::min((int)depthWidth_ - 1, (int)std::floor(std::min(maxX, width)));
+            int y1 = std::min((int)depthHeight_ - 1, (int)std::floor(std::min(maxY, height)));
+            if (x0 > x1 || y0 > y1) return false;
+            nearest -= 1e-6f;
+            Float4 nearest4 = set4(nearest);
+            for (int ty = y0 / kHiZTile; ty <= y1 / kHiZTile; ty++) {
+                for (int tx = x0 / kHiZTile; tx <= x1 / kHiZTile; tx++) {
+                    if (nearest > hiZ_[ty * tilesX + tx]) continue;
+                    int ya = std::max(y0, ty * kHiZTile), yb = std::min(y1, ty * kHiZTile + kHiZTile - 1);
+                    int xa = std::max(x0, tx * kHiZTile), xb = std::min(x1, tx * kHiZTile + kHiZTile - 1);
+                    for (int y = ya; y <= yb; y++) {
+                        const float* row = &depth_[(size_t)y * depthWidth_];
+                        for (int x = xa & ~3; x <= xb; x += 4) {
+                            Float4 index = set4((float)x, (float)x + 1, (float)x + 2, (float)x + 3);
+                            Float4 inRange = and4(cmpge4(index, set4((float)xa)), cmplt4(index, set4((float)xb + 1)));
+                            if (bits4(and4(inRange, cmpge4(load4(row + x), nearest4)))) return false;
+                        }
+                    }
+                }
+            }
+            return true;
+        };
+
+        auto& occluded = im.occluded;
+        occluded.assign(candidates.size(), 0);
+        auto occlusionTest = [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) occluded[i] = isOccluded(candidates[i]) ? 1 : 0;
+        };
+        im.pool.parallelFor(candidates.size(), 256, occlusionTest);
+        for (size_t i = 0; i < candidates.size(); i++) {
+            if (!occluded[i]) outVisible.push_back(candidates[i]);
+        }
+        stats_.occlusionCulled = candidates.size() - outVisible.size();
+        stats_.occlusionMs = msSince(occlusionStart);
+    } else {
+        outVisible.assign(candidates.begin(), candidates.end());
+    }
+
+    for (Handle handle : outVisible) visibleFrame_[handle] = frame_;
+    stats_.visibleObjects = outVisible.size();
+    stats_.totalMs = msSince(start);
+
+    CullResult result;
+    result.totalObjects = liveCount_;
+    result.visibleObjects = outVisible.size();
+    result.culledObjects = liveCount_ - outVisible.size();
+    return result;
+}
+
+}  // namespace luma
@@ -0,0 +1,143 @@
+// Scene Culling - scene-wide frustum + occlusion culling for large object counts
+// Retained alternative to FrustumCuller::cull: bounds live in SoA arrays
+// ordered by a persistent BVH, so a frame is
+//   1. BVH refit            - only leaves touched by update() since last frame
+//   2. frustum pass         - parallel over BVH subtrees; nodes are rejected or
+//                             accepted whole against the planes they straddle,
+//                             leaves test sphere + AABB four objects per step
+//   3. occluder raster      - solid occluder boxes into a low-res depth buffer
+//                             with an 8x8 max-depth (hi-Z) tile layer
+//   4. occlusion pass       - parallel over frustum survivors; projected box
+//                             rect against hi-Z tiles, then pixels
+// Objects added after the last build are tested linearly until the next
+// rebuild, which happens once they (or removals) exceed 1/8 of the scene.
+#pragma once
+
+#include "engine/rendering/culling.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace luma {
+
+struct SceneCullStats {
+    size_t totalObjects = 0;
+    size_t visibleObjects = 0;
+    size_t frustumCulled = 0;
+    size_t occlusionCulled = 0;
+    size_t nodesVisited = 0;
+    size_t objectsTested = 0;     // objects reaching a per-object test
+    size_t occluderTriangles = 0;
+    bool rebuilt = false;
+    bool refitted = false;
+    double bvhMs = 0.0;           // rebuild or refit
+    double frustumMs = 0.0;
+    double occluderMs = 0.0;
+    double occlusionMs = 0.0;
+    double totalMs = 0.0;
+};
+
+class SceneCuller {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle kInvalidHandle = 0xFFFFFFFFu;
+    static constexpr int kLeafSize = 16;
+    static constexpr int kHiZTile = 8;
+
+    // threads <= 0 uses every hardware thread
+    explicit SceneCuller(int threads = 0);
+    ~SceneCuller();
+
+    SceneCuller(const SceneCuller&) = delete;
+    SceneCuller& operator=(const SceneCuller&) = delete;
+
+    // Objects are world-space AABBs; the bounding sphere is derived
+    Handle add(const Vec3& boundsMin, const Vec3& boundsMax);
+    Handle add(const BoundingSphere& sphere);
+    void update(Handle handle, const Vec3& boundsMin, const Vec3& boundsMax);
+    void update(Handle handle, const BoundingSphere& sphere);
+    void remove(Handle handle);
+    void clear();
+    size_t size() const { return liveCount_; }
+
+    // Occluders are objects whose box is solid (walls, buildings, terrain
+    // blocks); their AABB faces are rasterized into the occlusion buffer
+    void setOccluder(Handle handle, bool occluder);
+    void setOcclusionEnabled(bool enabled) { occlusionEnabled_ = enabled; }
+    bool isOcclusionEnabled() const { return occlusionEnabled_; }
+    // Rounded up to whole hi-Z tiles
+    void setOcclusionResolution(uint32_t width, uint32_t height);
+    uint32_t occlusionWidth() const { return depthWidth_; }
+    uint32_t occlusionHeight() const { return depthHeight_; }
+    // Post-projection z/w of the nearest occluder; +inf where uncovered
+    const float* occlusionDepth() const { return depth_.data(); }
+
+    // Force a full BVH rebuild on the next cull (e.g. after streaming a level)
+    void rebuild() { needsRebuild_ = true; }
+
+    // Visible handles, in BVH order (identical for any thread count)
+    CullResult cull(const Mat4& viewProj, std::vector<Handle>& outVisible);
+    // O(1) result of the last cull()
+    bool wasVisible(Handle handle) const {
+        return handle < visibleFrame_.size() && visibleFrame_[handle] == frame_;
+    }
+
+    const SceneCullStats& stats() const { return stats_; }
+    int threadCount() const;
+
+private:
+    struct Node {
+        float boundsMin[3];
+        float boundsMax[3];
+        uint32_t first;     // leaf: first slot; inner: right child (left is index + 1)
+        uint32_t count;     // leaf: slot count (multiple of 4); inner: 0
+    };
+    struct Impl;
+
+    void buildBvh();
+    void refitBvh();
+    uint32_t buildNode(Handle* handles, uint32_t count);
+    uint32_t allocateSlot();
+    void writeSlot(uint32_t slot, Handle handle);
+    void killSlot(uint32_t slot);
+    void rasterizeOccluders(const Frustum& frustum, const Mat4& viewProj,
+                            const std::vector<Handle>& candidates);
+
+    // Per handle
+    std::vector<float> boxes_;           // min xyz, max xyz
+    std::vector<uint32_t> slotOf_;       // position in the SoA arrays
+    std::vector<uint8_t> alive_;
+    std::vector<uint8_t> occluder_;
+    std::vector<uint32_t> visibleFrame_;
+    std::vector<Handle> freeHandles_;
+    size_t liveCount_ = 0;
+
+    // SoA in BVH leaf order, leaves padded to multiples of 4 with dead slots;
+    // slots past bvhSlots_ hold objects added since the last build
+    enum { CX, CY, CZ, R, MINX, MINY, MINZ, MAXX, MAXY, MAXZ, kStreams };
+    std::vector<float> soa_[kStreams];
+    std::vector<Handle> slotHandle_;
+    std::vector<uint32_t> slotLeaf_;     // owning leaf node, or kInvalidHandle
+    uint32_t usedSlots_ = 0;
+    uint32_t bvhSlots_ = 0;
+    std::vector<Node> nodes_;
+    std::vector<uint8_t> nodeDirty_;
+    bool anyDirty_ = false;
+    bool needsRebuild_ = false;
+    size_t staleCount_ = 0;              // removed or appended since the build
+    float builtLeafArea_ = 0.0f;
+
+    // Occlusion buffer
+    bool occlusionEnabled_ = false;
+    uint32_t depthWidth_ = 256;
+    uint32_t depthHeight_ = 128;
+    std::vector<float> depth_;
+    std::vector<float> hiZ_;
+    size_t occluderCount_ = 0;
+
+    uint32_t frame_ = 0;
+    SceneCullStats stats_;
+    std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace luma
@@ -3,6 +3,7 @@
 
 #include "script_engine.h"
 #include <cstring>
+#include <algorithm>
 
 // Mock Lua types for compilation without Lua library
 #ifndef LUA_VERSION
@@ -349,9 +350,9 @@ void ScriptEngine::callRPC(ScriptInstance* instance, const std::string& rpcName,
     
     // Build network message
     NetworkMessage msg(NetworkMessageType::ScriptRPC);
-    msg.writeUInt32(instance->getNetworkId());
-    msg.writeString(rpcName);
-    msg.writeUInt16((uint16_t)args.size());
+    msg.writeVarUInt(instance->getNetworkId());
+    msg.writeString(rpcName, networkNames_);
+    msg.writeVarUInt(args.size());
     
     for (const auto& arg : args) {
         arg.serialize(msg);
@@ -377,11 +378,12 @@ void ScriptEngine::handleNetworkRPC(uint32_t networkId, const std::string& rpcNa
     if (!rpcDef || rpcDef->luaFuncRef < 0) return;
     
     // Deserialize args
-    uint16_t argCount = argsMsg.readUInt16();
+    uint64_t argCount = argsMsg.readVarUInt();
     std::vector<ScriptValue> args;
-    for (uint16_t i = 0; i < argCount; i++) {
+    for (uint64_t i = 0; i < argCount && !argsMsg.hasReadError(); i++) {
         args.push_back(ScriptValue::deserialize(argsMsg));
     }
+    if (argsMsg.hasReadError()) return;
     
     // Call the RPC function
     if (L_) {
@@ -403,12 +405,15 @@ void ScriptEngine::syncNetworkedProperties(ScriptInstance* instance) {
     if (!cls) return;
     
     // Build sync message with dirty properties
-    NetworkMessage msg(NetworkMessageType::ScriptStateSync);
-    msg.writeUInt32(instance->getNetworkId());
+    uint32_t propCount = 0;
+    for (auto& prop : cls->properties) {
+        if (prop.networked && prop.dirty && instance->propertyValues.count(prop.name)) propCount++;
+    }
+    if (propCount == 0) return;
     
-    uint16_t propCount = 0;
-    size_t countPos = msg.getSize();
-    msg.writeUInt16(0);  // Placeholder
+    NetworkMessage msg(NetworkMessageType::ScriptStateSync);
+    msg.writeVarUInt(instance->getNetworkId());
+    msg.writeVarUInt(propCount);
     
     for (auto& prop : cls->properties) {
         if (!prop.networked || !prop.dirty) continue;
@@ -416,27 +421,24 @@ void ScriptEngine::syncNetworkedProperties(ScriptInstance* instance) {
         auto it = instance->propertyValues.find(prop.name);
         if (it == instance->propertyValues.end()) continue;
         
-        msg.writeString(prop.name);
+        msg.writeString(prop.name, networkNames_);
         it->second.serialize(msg);
-        propCount++;
         prop.dirty = false;
     }
     
-    if (propCount > 0) {
-        // Update count (would need to modify message in real impl)
-        getNetworkManager().broadcast(msg);
-    }
+    getNetworkManager().broadcast(msg);
 }
 
 void ScriptEngine::handlePropertySync(uint32_t networkId, NetworkMessage& msg) {
     ScriptInstance* instance = getInstanceByNetworkId(networkId);
     if (!instance) return;
     
-    uint16_t propCount = msg.readUInt16();
+    uint64_t propCount = msg.readVarUInt();
     
-    for (uint16_t i = 0; i < propCount; i++) {
-        std::string propName = msg.readString();
+    for (uint64_t i = 0; i < propCount; i++) {
+        std::string propName = msg.readString(networkNames_);
         ScriptValue value = ScriptValue::deserialize(msg);
+        if (msg.hasReadError()) return;
         
         instance->propertyValues[propName] = value;
         
@@ -516,22 +518,38 @@ void ScriptEngine::registerNetworkHandlers() {
     auto* peer = netMgr.getPeer();
     if (!peer) return;
     
+    registerNetworkNames();
+    
     // Handle incoming script RPC
     peer->setMessageHandler(NetworkMessageType::ScriptRPC,
         [this](ConnectionId sender, NetworkMessage& msg) {
-            uint32_t networkId = msg.readUInt32();
-            std::string rpcName = msg.readString();
+            uint32_t networkId = (uint32_t)msg.readVarUInt();
+            std::string rpcName = msg.readString(networkNames_);
             handleNetworkRPC(networkId, rpcName, sender, msg);
         });
     
     // Handle property sync
     peer->setMessageHandler(NetworkMessageType::ScriptStateSync,
         [this](ConnectionId sender, NetworkMessage& msg) {
-            uint32_t networkId = msg.readUInt32();
+            uint32_t networkId = (uint32_t)msg.readVarUInt();
             handlePropertySync(networkId, msg);
         });
 }
 
+void ScriptEngine::registerNetworkNames() {
+    // Sorted so the order does not depend on load order or hashing
+    std::vector<std::string> names;
+    for (const auto& [className, cls] : classes_) {
+        for (const auto& rpc : cls->rpcs) names.push_back(rpc.name);
+        for (const auto& prop : cls->properties) {
+            if (prop.networked) names.push_back(prop.name);
+        }
+    }
+    std::sort(names.begin(), names.end());
+    networkNames_.clear();
+    for (const auto& name : names) networkNames_.add(name);
+}
+
 // Binding implementations (stubs)
 void ScriptEngine::bindVec3() {
     // In production: register Vec3 userdata type with metamethods
@@ -9,6 +9,7 @@
 #include <memory>
 #include <unordered_map>
 #include <functional>
+#include <cmath>
 
 // Forward declare Lua types (to avoid including lua.h in header)
 struct lua_State;
@@ -58,38 +59,79 @@ struct ScriptValue {
     bool isVec3() const { return type == ScriptValueType::Vec3; }
     bool isQuat() const { return type == ScriptValueType::Quat; }
     
-    // Serialization for network
+    // Serialization for network: 4-bit type, then
+    //   Boolean 1 bit; Number 2-bit mode + zigzag varint / float / double
+    //   (whichever is exact); Vec3 3 floats; Quat smallest three at 16 bits;
+    //   String and Table keys byte-aligned; Table varint count + pairs
     void serialize(NetworkMessage& msg) const {
-        msg.writeByte((uint8_t)type);
+        msg.writeBits((uint32_t)type, 4);
         switch (type) {
             case ScriptValueType::Boolean:
-                msg.writeByte(boolValue ? 1 : 0);
+                msg.writeBool(boolValue);
                 break;
-            case ScriptValueType::Number:
-                msg.writeFloat((float)numberValue);
+            case ScriptValueType::Number: {
+                double n = numberValue;
+                if (n == std::floor(n) && std::abs(n) < 9007199254740992.0) {
+                    msg.writeBits(0, 2);
+                    msg.writeVarInt((int64_t)n);
+                } else if ((double)(float)n == n) {
+                    msg.writeBits(1, 2);
+                    msg.writeFloat((float)n);
+                } else {
+                    msg.writeBits(2, 2);
+                    msg.writeDouble(n);
+                }
                 break;
+            }
             case ScriptValueType::String:
                 msg.writeString(stringValue);
                 break;
             case ScriptValueType::Vec3:
                 msg.writeVec3(vec3Value);
                 break;
+            case ScriptValueType::Quat:
+                msg.writeQuat(quatValue, 16);
+                break;
+            case ScriptValueType::Table:
+                msg.writeVarUInt(tableValue.size());
+                for (const auto& [key, value] : tableValue) {
+                    msg.writeString(key);
+                    value.serialize(msg);
+                }
+                break;
             default:
                 break;
         }
     }
     
-    static ScriptValue deserialize(NetworkMessage& msg) {
-        ScriptValueType t = (ScriptValueType)msg.readByte();
+    static ScriptValue deserialize(NetworkMessage& msg, int depth = 0) {
+        ScriptValueType t = (ScriptValueType)msg.readBits(4);
         switch (t) {
             case ScriptValueType::Boolean:
-                return ScriptValue(msg.readByte() != 0);
+                return ScriptValue(msg.readBool());
             case ScriptValueType::Number:
-                return ScriptValue((double)msg.readFloat());
+                switch (msg.readBits(2)) {
+                    case 0: return ScriptValue((double)msg.readVarInt());
+                    case 1: return ScriptValue((double)msg.readFloat());
+                    default: return ScriptValue(msg.readDouble());
+                }
             case ScriptValueType::String:
                 return ScriptValue(msg.readString());
             case ScriptValueType::Vec3:
                 return ScriptValue(msg.readVec3());
+            case ScriptValueType::Quat:
+                return ScriptValue(msg.readQuat(16));
+            case ScriptValueType::Table: {
+                ScriptValue table;
+                table.type = ScriptValueType::Table;
+                uint64_t count = msg.readVarUInt();
+                // Nesting and size are bounded by what the message can hold
+                for (uint64_t i = 0; i < count && depth < 32 && !msg.hasReadError(); i++) {
+                    std::string key = msg.readString();
+                    table.tableValue[key] = deserialize(msg, depth + 1);
+                }
+                return table;
+            }
             default:
                 return ScriptValue();
         }
@@ -241,6 +283,12 @@ public:
     // Get instance by network ID
     ScriptInstance* getInstanceByNetworkId(uint32_t networkId);
     
+    // RPC and networked property names, sent as string table indices.
+    // Rebuild after loading scripts; peers with the same scripts get the
+    // same table (compare getNetworkNames().checksum()).
+    void registerNetworkNames();
+    const NetworkStringTable& getNetworkNames() const { return networkNames_; }
+    
     // Bind engine APIs
     void bindVec3();
     void bindQuat();
@@ -269,6 +317,7 @@ private:
     std::unordered_map<std::string, std::unique_ptr<ScriptClass>> classes_;
     std::vector<std::unique_ptr<ScriptInstance>> instances_;
     std::unordered_map<uint32_t, ScriptInstance*> networkIdToInstance_;
+    NetworkStringTable networkNames_;
     
     uint32_t nextNetworkId_ = 1;
     bool networkEnabled_ = false;
@@ -0,0 +1,1048 @@
+// Visual Script VM - Register bytecode compiler and interpreter for VisualScriptGraph
+// Runs visual scripts without Lua: the graph is compiled once into typed register
+// bytecode (constants folded, unreachable nodes dropped) and executed in place.
+#pragma once
+
+#include "engine/script/visual_script.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+
+namespace luma {
+
+// ===== Registers =====
+enum class VSRegType : uint8_t {
+    Bool, Int, Float, String, Vec2, Vec3, Quat, Object, None
+};
+
+inline const char* getRegTypeName(VSRegType type) {
+    switch (type) {
+        case VSRegType::Bool:   return "Bool";
+        case VSRegType::Int:    return "Int";
+        case VSRegType::Float:  return "Float";
+        case VSRegType::String: return "String";
+        case VSRegType::Vec2:   return "Vec2";
+        case VSRegType::Vec3:   return "Vec3";
+        case VSRegType::Quat:   return "Quat";
+        case VSRegType::Object: return "Object";
+        default:                return "None";
+    }
+}
+
+inline VSRegType toRegType(PinType type) {
+    switch (type) {
+        case PinType::Bool:   return VSRegType::Bool;
+        case PinType::Int:    return VSRegType::Int;
+        case PinType::Float:  return VSRegType::Float;
+        case PinType::String: return VSRegType::String;
+        case PinType::Vec2:   return VSRegType::Vec2;
+        case PinType::Vec3:   return VSRegType::Vec3;
+        case PinType::Object: return VSRegType::Object;
+        default:              return VSRegType::None;
+    }
+}
+
+struct VSReg {
+    VSRegType type = VSRegType::None;
+    uint16_t index = 0;
+};
+
+// One file per type; constants, variables and temporaries all live here
+struct VisualScriptRegisters {
+    std::vector<uint8_t> b;
+    std::vector<int32_t> i;
+    std::vector<float> f;
+    std::vector<std::string> s;
+    std::vector<Vec2> v2;
+    std::vector<Vec3> v3;
+    std::vector<Quat> q;
+    std::vector<uint64_t> o;
+
+    size_t size(VSRegType type) const {
+        switch (type) {
+            case VSRegType::Bool:   return b.size();
+            case VSRegType::Int:    return i.size();
+            case VSRegType::Float:  return f.size();
+            case VSRegType::String: return s.size();
+            case VSRegType::Vec2:   return v2.size();
+            case VSRegType::Vec3:   return v3.size();
+            case VSRegType::Quat:   return q.size();
+            case VSRegType::Object: return o.size();
+            default:                return 0;
+        }
+    }
+
+    // Appends a zeroed register
+    uint32_t add(VSRegType type) {
+        switch (type) {
+            case VSRegType::Bool:   b.push_back(0); break;
+            case VSRegType::Int:    i.push_back(0); break;
+            case VSRegType::Float:  f.push_back(0.0f); break;
+            case VSRegType::String: s.emplace_back(); break;
+            case VSRegType::Vec2:   v2.emplace_back(); break;
+            case VSRegType::Vec3:   v3.emplace_back(); break;
+            case VSRegType::Quat:   q.emplace_back(); break;
+            case VSRegType::Object: o.push_back(0); break;
+            default:                return 0;
+        }
+        return (uint32_t)size(type) - 1;
+    }
+
+    // Numeric values convert between Int and Float; monostate leaves the register alone
+    bool store(VSReg reg, const PinValue& value) {
+        if (std::holds_alternative<std::monostate>(value)) return true;
+        switch (reg.type) {
+            case VSRegType::Bool:
+                if (auto* v = std::get_if<bool>(&value)) { b[reg.index] = *v ? 1 : 0; return true; }
+                return false;
+            case VSRegType::Int:
+                if (auto* v = std::get_if<int>(&value)) { i[reg.index] = *v; return true; }
+                if (auto* v = std::get_if<float>(&value)) { i[reg.index] = (int32_t)*v; return true; }
+                return false;
+            case VSRegType::Float:
+                if (auto* v = std::get_if<float>(&value)) { f[reg.index] = *v; return true; }
+                if (auto* v = std::get_if<int>(&value)) { f[reg.index] = (float)*v; return true; }
+                return false;
+            case VSRegType::String:
+                if (auto* v = std::get_if<std::string>(&value)) { s[reg.index] = *v; return true; }
+                return false;
+            case VSRegType::Vec2:
+                if (auto* v = std::get_if<Vec2>(&value)) { v2[reg.index] = *v; return true; }
+                return false;
+            case VSRegType::Vec3:
+                if (auto* v = std::get_if<Vec3>(&value)) { v3[reg.index] = *v; return true; }
+                return false;
+            case VSRegType::Object:
+                if (auto* v = std::get_if<uint64_t>(&value)) { o[reg.index] = *v; return true; }
+                return false;
+            default:
+                return false;
+        }
+    }
+
+    PinValue load(VSReg reg) const {
+        switch (reg.type) {
+            case VSRegType::Bool:   return b[reg.index] != 0;
+            case VSRegType::Int:    return (int)i[reg.index];
+            case VSRegType::Float:  return f[reg.index];
+            case VSRegType::String: return s[reg.index];
+            case VSRegType::Vec2:   return v2[reg.index];
+            case VSRegType::Vec3:   return v3[reg.index];
+            case VSRegType::Object: return o[reg.index];
+            default:                return std::monostate{};
+        }
+    }
+};
+
+// ===== Bytecode =====
+// Operand a is the destination for value-producing ops; b, c, d are sources.
+// Jump targets are in d.
+enum class VSOp : uint8_t {
+    // Moves
+    MovB, MovI, MovF, MovS, MovV2, MovV3, MovQ, MovO,
+    IntToFloat,
+    // Float math
+    AddF, SubF, MulF, DivF, LerpF, ClampF, RandomF,
+    // Logic (EqF..GtF follow the Compare node's output order)
+    AndB, OrB, NotB, EqF, NeF, LtF, GtF,
+    // Vectors and rotations
+    MakeV3, SplitV3, LengthV3, NormalizeV3, DotV3, CrossV3,
+    EulerToQuat, QuatToEuler,
+    // Flow
+    Jump, JumpIfFalse, JumpIfGreaterI, IncI, LoopGuard, Return,
+    // Host calls
+    GetPosition, GetRotation, GetKey, GetAxis, GetMousePosition, Raycast, ExtraArg,
+    SetPosition, SetRotation, Translate, Rotate, LookAt, AddForce, AddImpulse,
+    PlaySound, StopSound, Print, DrawDebugLine
+};
+
+struct VSInstruction {
+    VSOp op = VSOp::Return;
+    uint8_t reserved = 0;
+    uint16_t a = 0, b = 0, c = 0, d = 0;
+};
+
+enum class VisualScriptEvent : uint8_t {
+    Start,
+    Update,
+    Collision,
+    Count
+};
+
+// ===== Host Bindings =====
+// Engine side of the Transform/Physics/Audio/Input/Debug nodes. Unset callbacks
+// are no-ops and queries return zero. Shared by every VM that points at it.
+struct VisualScriptBindings {
+    std::function<Vec3(uint64_t)> getPosition;
+    std::function<void(uint64_t, const Vec3&)> setPosition;
+    std::function<Quat(uint64_t)> getRotation;
+    std::function<void(uint64_t, const Quat&)> setRotation;
+    std::function<void(uint64_t, const Vec3&)> translate;
+    std::function<void(uint64_t, const Quat&)> rotate;
+    std::function<void(uint64_t, const Vec3&)> lookAt;
+    std::function<void(uint64_t, const Vec3&)> addForce;
+    std::function<void(uint64_t, const Vec3&)> addImpulse;
+    // origin, direction, distance -> hit, hit point, hit object
+    std::function<bool(const Vec3&, const Vec3&, float, Vec3&, uint64_t&)> raycast;
+    std::function<void(const std::string&, float)> playSound;
+    std::function<void(const std::string&)> stopSound;
+    // key -> pressed, held, released
+    std::function<void(const std::string&, bool&, bool&, bool&)> getKey;
+    std::function<float(const std::string&)> getAxis;
+    std::function<Vec2()> getMousePosition;
+    std::function<void(const std::string&)> print;
+    std::function<void(const Vec3&, const Vec3&)> drawDebugLine;
+};
+
+// ===== Program =====
+struct VisualScriptCompileOptions {
+    bool foldConstants = true;
+    uint32_t maxLoopIterations = 100000;   // per WhileLoop entry; exceeding it aborts the run
+};
+
+struct VisualScriptCompileStats {
+    uint32_t nodes = 0;          // in the graph
+    uint32_t liveNodes = 0;      // reachable from an event
+    uint32_t foldedNodes = 0;    // live, but evaluated at compile time
+    uint32_t deadNodes = 0;      // never reached, no code emitted
+    uint32_t instructions = 0;
+};
+
+class VisualScriptProgram {
+public:
+    static constexpr uint32_t INVALID = 0xFFFFFFFF;
+
+    // Fails on unknown node types, type mismatches and flow cycles outside loop nodes
+    bool compile(const VisualScriptGraph& graph, const VisualScriptCompileOptions& options = {});
+
+    bool empty() const { return code_.empty(); }
+    bool hasEvent(VisualScriptEvent event) const { return entry_[(size_t)event] != INVALID; }
+    const std::vector<VSInstruction>& getCode() const { return code_; }
+    const VisualScriptCompileStats& getStats() const { return stats_; }
+
+    // Index into the variable table, or -1
+    int findVariable(const std::string& name) const {
+        for (size_t i = 0; i < variables_.size(); i++) {
+            if (variables_[i].name == name) return (int)i;
+        }
+        return -1;
+    }
+
+    const std::string& getLastError() const { return lastError_; }
+
+private:
+    friend class VisualScriptCompiler;
+    friend class VisualScriptVM;
+
+    struct VariableSlot {
+        std::string name;
+        PinType type;
+        VSReg reg;
+    };
+
+    void clear() {
+        code_.clear();
+        registers_ = VisualScriptRegisters();
+        variables_.clear();
+        std::fill(std::begin(entry_), std::end(entry_), INVALID);
+        stats_ = VisualScriptCompileStats();
+    }
+
+    std::vector<VSInstruction> code_;
+    VisualScriptRegisters registers_;     // initial image: constants, variable defaults, zeroed temporaries
+    std::vector<VariableSlot> variables_;
+    uint32_t entry_[(size_t)VisualScriptEvent::Count] = {INVALID, INVALID, INVALID};
+    uint16_t deltaTime_ = 0;              // float register fed by onUpdate
+    uint16_t other_ = 0;                  // object register fed by onCollision
+    uint32_t maxLoopIterations_ = 0;
+    VisualScriptCompileStats stats_;
+    std::string lastError_;
+};
+
+// ===== VM =====
+// One instance per script owner. Holds its own registers (variables persist
+// between events); running an event does not allocate.
+class VisualScriptVM {
+public:
+    VisualScriptVM() = default;
+    explicit VisualScriptVM(const VisualScriptProgram* program) { load(program); }
+
+    void load(const VisualScriptProgram* program) {
+        program_ = program;
+        reset();
+    }
+    // Restores every variable to its default
+    void reset() {
+        if (!program_) return;
+        regs_ = program_->registers_;
+        if (!regs_.o.empty()) regs_.o[0] = self_;
+    }
+
+    // Object used by unconnected Object inputs
+    void setSelf(uint64_t id) {
+        self_ = id;
+        if (!regs_.o.empty()) regs_.o[0] = id;
+    }
+    uint64_t getSelf() const { return self_; }
+
+    void setBindings(const VisualScriptBindings* bindings) { bindings_ = bindings; }
+    void setSeed(uint32_t seed) { rng_ = seed ? seed : 1; }
+
+    bool onStart() { return run(VisualScriptEvent::Start); }
+    bool onUpdate(float deltaTime) {
+        if (program_ && program_->hasEvent(VisualScriptEvent::Update)) regs_.f[program_->deltaTime_] = deltaTime;
+        return run(VisualScriptEvent::Update);
+    }
+    bool onCollision(uint64_t other) {
+        if (program_ && program_->hasEvent(VisualScriptEvent::Collision)) regs_.o[program_->other_] = other;
+        return run(VisualScriptEvent::Collision);
+    }
+
+    // Events the graph has no handler for succeed without doing anything
+    bool run(VisualScriptEvent event) {
+        if (!program_) {
+            lastError_ = "no program loaded";
+            return false;
+        }
+        uint32_t entry = program_->entry_[(size_t)event];
+        if (entry == VisualScriptProgram::INVALID) return true;
+
+        ExecState state;
+        state.bindings = bindings_;
+        state.rng = rng_;
+        state.maxLoopIterations = program_->maxLoopIterations_;
+        bool ok = execute(program_->code_.data(), entry, regs_, state);
+        rng_ = state.rng;
+        executed_ += state.executed;
+        if (!ok) lastError_ = state.error;
+        return ok;
+    }
+
+    bool getVariable(const std::string& name, PinValue& value) const {
+        int index = program_ ? program_->findVariable(name) : -1;
+        if (index < 0) return false;
+        value = regs_.load(program_->variables_[index].reg);
+        return true;
+    }
+    bool setVariable(const std::string& name, const PinValue& value) {
+        int index = program_ ? program_->findVariable(name) : -1;
+        if (index < 0) {
+            lastError_ = "unknown variable: " + name;
+            return false;
+        }
+        if (!regs_.store(program_->variables_[index].reg, value)) {
+            lastError_ = "type mismatch for variable: " + name;
+            return false;
+        }
+        return true;
+    }
+
+    // Total instructions executed by this VM, i.e. node evaluations
+    uint64_t getExecutedInstructions() const { return executed_; }
+    const std::string& getLastError() const { return lastError_; }
+
+private:
+    friend class VisualScriptCompiler;
+
+    struct ExecState {
+        const VisualScriptBindings* bindings = nullptr;
+        uint32_t rng = 1;
+        uint32_t maxLoopIterations = 0;
+        uint64_t executed = 0;
+        const char* error = "";
+    };
+
+    // Runs from pc until Return. Also used by the compiler to fold constants.
+    static bool execute(const VSInstruction* code, uint32_t pc, VisualScriptRegisters& r, ExecState& state);
+
+    const VisualScriptProgram* program_ = nullptr;
+    const VisualScriptBindings* bindings_ = nullptr;
+    VisualScriptRegisters regs_;
+    uint64_t self_ = 0;
+    uint32_t rng_ = 0x9E3779B9u;
+    uint64_t executed_ = 0;
+    std::string lastError_;
+};
+
+inline bool VisualScriptVM::execute(const VSInstruction* code, uint32_t pc,
+                                    VisualScriptRegisters& r, ExecState& state) {
+    uint8_t* B = r.b.data();
+    int32_t* I = r.i.data();
+    float* F = r.f.data();
+    Vec2* V2 = r.v2.data();
+    Vec3* V = r.v3.data();
+    Quat* Q = r.q.data();
+    uint64_t* O = r.o.data();
+    const VisualScriptBindings* host = state.bindings;
+    uint64_t count = 0;
+
+    for (;;) {
+        const VSInstruction& in = code[pc++];
+        count++;
+        switch (in.op) {
+            case VSOp::MovB:  B[in.a] = B[in.b]; break;
+            case VSOp::MovI:  I[in.a] = I[in.b]; break;
+            case VSOp::MovF:  F[in.a] = F[in.b]; break;
+            case VSOp::MovS:  r.s[in.a] = r.s[in.b]; break;
+            case VSOp::MovV2: V2[in.a] = V2[in.b]; break;
+            case VSOp::MovV3: V[in.a] = V[in.b]; break;
+            case VSOp::MovQ:  Q[in.a] = Q[in.b]; break;
+            case VSOp::MovO:  O[in.a] = O[in.b]; break;
+            case VSOp::IntToFloat: F[in.a] = (float)I[in.b]; break;
+
+            case VSOp::AddF:   F[in.a] = F[in.b] + F[in.c]; break;
+            case VSOp::SubF:   F[in.a] = F[in.b] - F[in.c]; break;
+            case VSOp::MulF:   F[in.a] = F[in.b] * F[in.c]; break;
+            case VSOp::DivF:   F[in.a] = F[in.b] / F[in.c]; break;
+            case VSOp::LerpF:  F[in.a] = F[in.b] + (F[in.c] - F[in.b]) * F[in.d]; break;
+            case VSOp::ClampF: F[in.a] = std::min(std::max(F[in.b], F[in.c]), F[in.d]); break;
+            case VSOp::RandomF: {
+                uint32_t x = state.rng;
+                x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+                state.rng = x;
+                float t = (float)(x >> 8) * (1.0f / 16777216.0f);
+                F[in.a] = F[in.b] + (F[in.c] - F[in.b]) * t;
+                break;
+            }
+
+            case VSOp::AndB: B[in.a] = B[in.b] && B[in.c]; break;
+            case VSOp::OrB:  B[in.a] = B[in.b] || B[in.c]; break;
+            case VSOp::NotB: B[in.a] = !B[in.b]; break;
+            case VSOp::EqF:  B[in.a] = F[in.b] == F[in.c]; break;
+            case VSOp::NeF:  B[in.a] = F[in.b] != F[in.c]; break;
+            case VSOp::LtF:  B[in.a] = F[in.b] < F[in.c]; break;
+            case VSOp::GtF:  B[in.a] = F[in.b] > F[in.c]; break;
+
+            case VSOp::MakeV3:      V[in.a] = Vec3(F[in.b], F[in.c], F[in.d]); break;
+            case VSOp::SplitV3:     F[in.a] = in.c == 0 ? V[in.b].x : (in.c == 1 ? V[in.b].y : V[in.b].z); break;
+            case VSOp::LengthV3:    F[in.a] = V[in.b].length(); break;
+            case VSOp::NormalizeV3: V[in.a] = V[in.b].normalized(); break;
+            case VSOp::DotV3:       F[in.a] = V[in.b].dot(V[in.c]); break;
+            case VSOp::CrossV3:     V[in.a] = V[in.b].cross(V[in.c]); break;
+            case VSOp::EulerToQuat: Q[in.a] = Quat::fromEuler(V[in.b].x, V[in.b].y, V[in.b].z); break;
+            case VSOp::QuatToEuler: V[in.a] = Q[in.b].toEuler(); break;
+
+            case VSOp::Jump:        pc = in.d; break;
+            case VSOp::JumpIfFalse: if (!B[in.a]) pc = in.d; break;
+            case VSOp::JumpIfGreaterI: if (I[in.a] > I[in.b]) pc = in.d; break;
+            case VSOp::IncI:        I[in.a]++; break;
+            case VSOp::LoopGuard:
+                if ((uint32_t)++I[in.a] > state.maxLoopIterations) {
+                    state.error = "loop iteration limit exceeded";
+                    state.executed += count;
+                    return false;
+                }
+                break;
+            case VSOp::Return:
+                state.executed += count;
+                return true;
+
+            case VSOp::GetPosition:
+                V[in.a] = host && host->getPosition ? host->getPosition(O[in.b]) : Vec3();
+                break;
+            case VSOp::GetRotation:
+                Q[in.a] = host && host->getRotation ? host->getRotation(O[in.b]) : Quat();
+                break;
+            case VSOp::GetKey: {
+                bool pressed = false, held = false, released = false;
+                if (host && host->getKey) host->getKey(r.s[in.d], pressed, held, released);
+                B[in.a] = pressed;
+                B[in.b] = held;
+                B[in.c] = released;
+                break;
+            }
+            case VSOp::GetAxis:
+                F[in.a] = host && host->getAxis ? host->getAxis(r.s[in.b]) : 0.0f;
+                break;
+            case VSOp::GetMousePosition:
+                V2[in.a] = host && host->getMousePosition ? host->getMousePosition() : Vec2();
+                break;
+            case VSOp::Raycast: {
+                // Inputs travel in the ExtraArg that follows
+                const VSInstruction& args = code[pc++];
+                Vec3 point;
+                uint64_t object = 0;
+                bool hit = host && host->raycast && host->raycast(V[args.a], V[args.b], F[args.c], point, object);
+                B[in.a] = hit;
+                V[in.b] = point;
+                O[in.c] = object;
+                break;
+            }
+            case VSOp::ExtraArg: break;
+
+            case VSOp::SetPosition: if (host && host->setPosition) host->setPosition(O[in.a], V[in.b]); break;
+            case VSOp::SetRotation: if (host && host->setRotation) host->setRotation(O[in.a], Q[in.b]); break;
+            case VSOp::Translate:   if (host && host->translate) host->translate(O[in.a], V[in.b]); break;
+            case VSOp::Rotate:      if (host && host->rotate) host->rotate(O[in.a], Q[in.b]); break;
+            case VSOp::LookAt:      if (host && host->lookAt) host->lookAt(O[in.a], V[in.b]); break;
+            case VSOp::AddForce:    if (host && host->addForce) host->addForce(O[in.a], V[in.b]); break;
+            case VSOp::AddImpulse:  if (host && host->addImpulse) host->addImpulse(O[in.a], V[in.b]); break;
+            case VSOp::PlaySound:   if (host && host->playSound) host->playSound(r.s[in.a], F[in.b]); break;
+            case VSOp::StopSound:   if (host && host->stopSound) host->stopSound(r.s[in.a]); break;
+            case VSOp::Print:       if (host && host->print) host->print(r.s[in.a]); break;
+            case VSOp::DrawDebugLine:
+                if (host && host->drawDebugLine) host->drawDebugLine(V[in.a], V[in.b]);
+                break;
+        }
+    }
+}
+
+// ===== Compiler =====
+// Code is generated by walking execution flow from each event node. Data inputs
+// are pulled on demand in front of the statement that needs them, so nodes no
+// event reaches cost nothing. Pure nodes whose inputs are all constant are run
+// once on the program's register image and become constants themselves.
+class VisualScriptCompiler {
+public:
+    bool compile(const VisualScriptGraph& graph, VisualScriptProgram& program,
+                 const VisualScriptCompileOptions& options = {});
+
+private:
+    struct Value {
+        VSReg reg;
+        bool constant = false;
+    };
+    struct PinRef {
+        const VisualScriptNode* node = nullptr;
+        uint32_t index = 0;
+        bool output = false;
+    };
+
+    bool fail(const std::string& message) {
+        program_->lastError_ = message;
+        return false;
+    }
+    bool fail(const VisualScriptNode& node, const std::string& message) {
+        return fail(node.name + " (node " + std::to_string(node.id) + "): " + message);
+    }
+
+    static int findPin(const std::vector<Pin>& pins, const char* name) {
+        for (size_t i = 0; i < pins.size(); i++) {
+            if (pins[i].name == name) return (int)i;
+        }
+        return -1;
+    }
+
+    const VisualScriptProgram::VariableSlot* variableOf(const VisualScriptNode& node) const;
+    VSRegType pinType(const VisualScriptNode& node, const Pin& pin) const;
+
+    bool alloc(VSRegType type, VSReg& reg);
+    bool emit(VSOp op, uint16_t a = 0, uint16_t b = 0, uint16_t c = 0, uint16_t d = 0);
+    uint16_t here() const { return (uint16_t)program_->code_.size(); }
+    void patch(size_t at) { program_->code_[at].d = here(); }
+    bool apply(VSOp op, VSRegType type, const Value* args, int count,
+               bool pure, Value& out, uint16_t extra = 0);
+    bool constant(const VisualScriptNode& node, const Pin& pin, VSRegType type, Value& out);
+    bool convert(const VisualScriptNode& node, const Value& value, VSRegType want, Value& out);
+
+    bool input(const VisualScriptNode& node, const char* name, VSRegType want, Value& out);
+    bool output(const VisualScriptNode& node, uint32_t index, Value& out);
+    bool evaluate(const VisualScriptNode& node, uint32_t index, Value& out);
+    bool rotation(const VisualScriptNode& getRotation, Value& out);
+    VSReg loopIndex(const VisualScriptNode& node);
+
+    bool follow(const VisualScriptNode& node, const char* flowPin);
+    bool followInto(const VisualScriptNode& node, const char* flowPin);
+    bool statement(const VisualScriptNode& node);
+    bool statementBody(const VisualScriptNode& node);
+
+    VisualScriptProgram* program_ = nullptr;
+    VisualScriptCompileOptions options_;
+    std::unordered_map<uint32_t, PinRef> pins_;
+    std::unordered_map<uint32_t, uint32_t> inputSource_;   // data input pin -> output pin
+    std::unordered_map<uint32_t, uint32_t> flowTarget_;    // flow output pin -> input pin
+    std::unordered_map<uint32_t, Value> constCache_;       // output pin -> folded value
+    std::unordered_map<uint32_t, Value> localCache_;       // output pin -> value, current statement only
+    std::unordered_map<uint32_t, VSReg> loopIndex_;        // ForLoop node -> index register
+    std::unordered_map<uint64_t, uint16_t> emitted_;       // (node, continuation) -> first instruction
+    uint32_t continuation_ = 0;                            // what the current chain falls through to
+    uint32_t nextContinuation_ = 1;
+    std::unordered_set<uint32_t> onStack_;
+    std::unordered_set<uint32_t> reached_;
+    std::unordered_set<uint32_t> folded_;
+    Value zero_[(size_t)VSRegType::None];
+    bool hasZero_[(size_t)VSRegType::None] = {};
+};
+
+inline bool VisualScriptProgram::compile(const VisualScriptGraph& graph, const VisualScriptCompileOptions& options) {
+    VisualScriptCompiler compiler;
+    if (compiler.compile(graph, *this, options)) return true;
+    std::string error = lastError_;
+    clear();
+    lastError_ = error;
+    return false;
+}
+
+inline bool VisualScriptCompiler::compile(const VisualScriptGraph& graph, VisualScriptProgram& program,
+                                          const VisualScriptCompileOptions& options) {
+    program_ = &program;
+    options_ = options;
+    program.clear();
+    program.maxLoopIterations_ = options.maxLoopIterations;
+
+    for (const auto& node : graph.nodes) {
+        for (size_t i = 0; i < node->inputs.size(); i++) {
+            pins_[node->inputs[i].id] = {node.get(), (uint32_t)i, false};
+        }
+        for (size_t i = 0; i < node->outputs.size(); i++) {
+            pins_[node->outputs[i].id] = {node.get(), (uint32_t)i, true};
+        }
+    }
+    for (const auto& link : graph.links) {
+        auto from = pins_.find(link.fromPin);
+        auto to = pins_.find(link.toPin);
+        if (from == pins_.end() || to == pins_.end()) {
+            return fail("link " + std::to_string(link.id) + " references a missing pin");
+        }
+        const Pin& pin = from->second.node->outputs[from->second.index];
+        if (pin.type == PinType::Flow) {
+            flowTarget_.emplace(link.fromPin, link.toPin);   // first link wins, as in compileToLua
+        } else {
+            inputSource_[link.toPin] = link.fromPin;
+        }
+    }
+
+    // Object register 0 is the VM's self
+    VSReg reg;
+    alloc(VSRegType::Object, reg);
+    alloc(VSRegType::Float, reg);
+    program.deltaTime_ = reg.index;
+    alloc(VSRegType::Object, reg);
+    program.other_ = reg.index;
+
+    for (const auto& var : graph.variables) {
+        VSRegType type = toRegType(var.type);
+        if (type == VSRegType::None) return fail("variable " + var.name + " has no register type");
+        if (program.findVariable(var.name) >= 0) return fail("duplicate variable " + var.name);
+        if (!alloc(type, reg)) return false;
+        if (!program.registers_.store(reg, var.defaultValue)) {
+            return fail("default value of variable " + var.name + " does not match its type");
+        }
+        program.variables_.push_back({var.name, var.type, reg});
+    }
+
+    static const char* eventNodes[] = {"OnStart", "OnUpdate", "OnCollision"};
+    for (size_t event = 0; event < (size_t)VisualScriptEvent::Count; event++) {
+        for (const auto& node : graph.nodes) {
+            if (node->name != eventNodes[event]) continue;
+            if (program.entry_[event] == VisualScriptProgram::INVALID) program.entry_[event] = here();
+            reached_.insert(node->id);
+            if (!followInto(*node, "Exec")) return false;
+        }
+        if (program.entry_[event] != VisualScriptProgram::INVALID && !emit(VSOp::Return)) return false;
+    }
+
+    auto& stats = program.stats_;
+    stats.nodes = (uint32_t)graph.nodes.size();
+    stats.liveNodes = (uint32_t)reached_.size();
+    stats.foldedNodes = (uint32_t)folded_.size();
+    stats.deadNodes = stats.nodes - stats.liveNodes;
+    stats.instructions = (uint32_t)program.code_.size();
+    return true;
+}
+
+inline const VisualScriptProgram::VariableSlot* VisualScriptCompiler::variableOf(const VisualScriptNode& node) const {
+    auto it = node.properties.find("VariableName");
+    if (it == node.properties.end()) return nullptr;
+    const std::string* name = std::get_if<std::string>(&it->second);
+    int index = name ? program_->findVariable(*name) : -1;
+    return index >= 0 ? &program_->variables_[index] : nullptr;
+}
+
+inline VSRegType VisualScriptCompiler::pinType(const VisualScriptNode& node, const Pin& pin) const {
+    if (pin.type != PinType::Any) return toRegType(pin.type);
+    const auto* var = variableOf(node);
+    return var ? var->reg.type : VSRegType::None;
+}
+
+inline bool VisualScriptCompiler::alloc(VSRegType type, VSReg& reg) {
+    if (type == VSRegType::None) return fail("value has no register type");
+    if (program_->registers_.size(type) >= 0xFFFF) {
+        return fail(std::string("out of ") + getRegTypeName(type) + " registers");
+    }
+    reg.type = type;
+    reg.index = (uint16_t)program_->registers_.add(type);
+    return true;
+}
+
+inline bool VisualScriptCompiler::emit(VSOp op, uint16_t a, uint16_t b, uint16_t c, uint16_t d) {
+    if (program_->code_.size() >= 0xFFFF) return fail("program exceeds 65535 instructions");
+    VSInstruction in;
+    in.op = op;
+    in.a = a; in.b = b; in.c = c; in.d = d;
+    program_->code_.push_back(in);
+    return true;
+}
+
+inline bool VisualScriptCompiler::apply(VSOp op, VSRegType type,
+                                        const Value* args, int count, bool pure, Value& out, uint16_t extra) {
+    uint16_t src[3] = {extra, extra, extra};
+    bool fold = pure && options_.foldConstants;
+    for (int i = 0; i < count; i++) {
+        src[i] = args[i].reg.index;
+        fold = fold && args[i].constant;
+    }
+    if (!alloc(type, out.reg)) return false;
+    out.constant = fold;
+    if (!fold) return emit(op, out.reg.index, src[0], src[1], src[2]);
+
+    // Evaluate now on the initial image; no code is emitted
+    VSInstruction code[2];
+    code[0].op = op;
+    code[0].a = out.reg.index; code[0].b = src[0]; code[0].c = src[1]; code[0].d = src[2];
+    VisualScriptVM::ExecState state;
+    return VisualScriptVM::execute(code, 0, program_->registers_, state);
+}
+
+inline bool VisualScriptCompiler::constant(const VisualScriptNode& node, const Pin& pin, VSRegType type, Value& out) {
+    if (type == VSRegType::None) return fail(node, "pin " + pin.name + " has no type");
+    bool unset = std::holds_alternative<std::monostate>(pin.defaultValue);
+    if (unset && type == VSRegType::Object) {
+        out.reg = {VSRegType::Object, 0};   // self; differs per VM, so not a constant
+        out.constant = false;
+        return true;
+    }
+    if (unset && hasZero_[(size_t)type]) {
+        out = zero_[(size_t)type];
+        return true;
+    }
+    if (!alloc(type, out.reg)) return false;
+    out.constant = type != VSRegType::Object;
+    if (!program_->registers_.store(out.reg, pin.defaultValue)) {
+        return fail(node, "default value of pin " + pin.name + " is not a " + getRegTypeName(type));
+    }
+    if (unset) {
+        zero_[(size_t)type] = out;
+        hasZero_[(size_t)type] = true;
+    }
+    return true;
+}
+
+inline bool VisualScriptCompiler::convert(const VisualScriptNode& node, const Value& value, VSRegType want, Value& out) {
+    if (value.reg.type == want) {
+        out = value;
+        return true;
+    }
+    if (value.reg.type == VSRegType::Int && want == VSRegType::Float) {
+        return apply(VSOp::IntToFloat, want, &value, 1, true, out);
+    }
+    if (value.reg.type == VSRegType::Vec3 && want == VSRegType::Quat) {
+        return apply(VSOp::EulerToQuat, want, &value, 1, true, out);
+    }
+    return fail(node, std::string("cannot use ") + getRegTypeName(value.reg.type) +
+                " as " + getRegTypeName(want));
+}
+
+inline bool VisualScriptCompiler::input(const VisualScriptNode& node, const char* name, VSRegType want, Value& out) {
+    int index = findPin(node.inputs, name);
+    if (index < 0) return fail(node, std::string("missing input ") + name);
+    const Pin& pin = node.inputs[index];
+
+    Value value;
+    auto source = inputSource_.find(pin.id);
+    if (source == inputSource_.end()) {
+        if (!constant(node, pin, pinType(node, pin), value)) return false;
+    } else {
+        const PinRef& ref = pins_[source->second];
+        // Rotations stay quaternions end to end instead of round-tripping through Euler
+        if (want == VSRegType::Quat && ref.node->name == "GetRotation") {
+            reached_.insert(ref.node->id);
+            return rotation(*ref.node, out);
+        }
+        if (!output(*ref.node, ref.index, value)) return false;
+    }
+    return convert(node, value, want, out);
+}
+
+inline bool VisualScriptCompiler::output(const VisualScriptNode& node, uint32_t index, Value& out) {
+    const Pin& pin = node.outputs[index];
+    if (pin.type == PinType::Flow) return fail(node, "flow pin " + pin.name + " used as data");
+    reached_.insert(node.id);
+
+    auto folded = constCache_.find(pin.id);
+    if (folded != constCache_.end()) {
+        out = folded->second;
+        return true;
+    }
+    auto local = localCache_.find(pin.id);
+    if (local != localCache_.end()) {
+        out = local->second;
+        return true;
+    }
+    if (!evaluate(node, index, out)) return false;
+    if (out.constant) {
+        constCache_[pin.id] = out;
+        folded_.insert(node.id);
+    } else {
+        localCache_[pin.id] = out;
+    }
+    return true;
+}
+
+inline VSReg VisualScriptCompiler::loopIndex(const VisualScriptNode& node) {
+    auto it = loopIndex_.find(node.id);
+    if (it != loopIndex_.end()) return it->second;
+    VSReg reg;
+    alloc(VSRegType::Int, reg);
+    loopIndex_[node.id] = reg;
+    return reg;
+}
+
+inline bool VisualScriptCompiler::rotation(const VisualScriptNode& node, Value& out) {
+    Value object;
+    if (!input(node, "Object", VSRegType::Object, object)) return false;
+    return apply(VSOp::GetRotation, VSRegType::Quat, &object, 1, false, out);
+}
+
+inline bool VisualScriptCompiler::evaluate(const VisualScriptNode& node, uint32_t index, Value& out) {
+    const std::string& type = node.name;
+    const VSRegType F = VSRegType::Float, B = VSRegType::Bool, V = VSRegType::Vec3;
+    Value in[3];
+
+    // Values that live in fixed registers
+    if (type == "OnUpdate") {
+        out.reg = {F, program_->deltaTime_};
+        return true;
+    }
+    if (type == "OnCollision") {
+        out.reg = {VSRegType::Object, program_->other_};
+        return true;
+    }
+    if (type == "ForLoop") {
+        out.reg = loopIndex(node);
+        return true;
+    }
+    if (type == "GetVariable" || type == "SetVariable") {
+        const auto* var = variableOf(node);
+        if (!var) return fail(node, "unknown variable");
+        out.reg = var->reg;
+        return true;
+    }
+
+    // Pure math and logic
+    struct Binary { const char* name; VSOp op; VSRegType in, out; };
+    static const Binary binaries[] = {
+        {"Add", VSOp::AddF, F, F}, {"Subtract", VSOp::SubF, F, F},
+        {"Multiply", VSOp::MulF, F, F}, {"Divide", VSOp::DivF, F, F},
+        {"And", VSOp::AndB, B, B}, {"Or", VSOp::OrB, B, B},
+        {"DotProduct", VSOp::DotV3, V, F}, {"CrossProduct", VSOp::CrossV3, V, V},
+    };
+    for (const auto& bin : binaries) {
+        if (type != bin.name) continue;
+        if (!input(node, "A", bin.in, in[0]) || !input(node, "B", bin.in, in[1])) return false;
+        return apply(bin.op, bin.out, in, 2, true, out);
+    }
+    if (type == "Compare") {
+        if (!input(node, "A", F, in[0]) || !input(node, "B", F, in[1])) return false;
+        return apply((VSOp)((uint8_t)VSOp::EqF + index), B, in, 2, true, out);
+    }
+    if (type == "Lerp") {
+        if (!input(node, "A", F, in[0]) || !input(node, "B", F, in[1]) ||
+            !input(node, "Alpha", F, in[2])) return false;
+        return apply(VSOp::LerpF, F, in, 3, true, out);
+    }
+    if (type == "Clamp") {
+        if (!input(node, "Value", F, in[0]) || !input(node, "Min", F, in[1]) ||
+            !input(node, "Max", F, in[2])) return false;
+        return apply(VSOp::ClampF, F, in, 3, true, out);
+    }
+    if (type == "Random") {
+        if (!input(node, "Min", F, in[0]) || !input(node, "Max", F, in[1])) return false;
+        return apply(VSOp::RandomF, F, in, 2, false, out);
+    }
+    if (type == "Not") {
+        if (!input(node, "Input", B, in[0])) return false;
+        return apply(VSOp::NotB, B, in, 1, true, out);
+    }
+    if (type == "MakeVec3") {
+        if (!input(node, "X", F, in[0]) || !input(node, "Y", F, in[1]) || !input(node, "Z", F, in[2])) return false;
+        return apply(VSOp::MakeV3, V, in, 3, true, out);
+    }
+    if (type == "BreakVec3") {
+        if (!input(node, "Vector", V, in[0])) return false;
+        return apply(VSOp::SplitV3, F, in, 1, true, out, (uint16_t)index);
+    }
+    if (type == "VectorLength") {
+        if (!input(node, "Vector", V, in[0])) return false;
+        return apply(VSOp::LengthV3, F, in, 1, true, out);
+    }
+    if (type == "Normalize") {
+        if (!input(node, "Vector", V, in[0])) return false;
+        return apply(VSOp::NormalizeV3, V, in, 1, true, out);
+    }
+
+    // Host queries, re-run every time a statement needs them
+    if (type == "GetPosition") {
+        if (!input(node, "Object", VSRegType::Object, in[0])) return false;
+        return apply(VSOp::GetPosition, V, in, 1, false, out);
+    }
+    if (type == "GetRotation") {
+        if (!rotation(node, in[0])) return false;
+        return apply(VSOp::QuatToEuler, V, in, 1, false, out);
+    }
+    if (type == "GetAxis") {
+        if (!input(node, "Axis", VSRegType::String, in[0])) return false;
+        return apply(VSOp::GetAxis, F, in, 1, false, out);
+    }
+    if (type == "GetMousePosition") {
+        return apply(VSOp::GetMousePosition, VSRegType::Vec2, in, 0, false, out);
+    }
+    if (type == "GetKey" || type == "Raycast") {
+        // Several outputs from one host call; cache them all for this statement
+        Value results[3];
+        if (type == "GetKey") {
+            if (!input(node, "Key", VSRegType::String, in[0])) return false;
+            for (auto& r : results) {
+                if (!alloc(B, r.reg)) return false;
+            }
+            if (!emit(VSOp::GetKey, results[0].reg.index, results[1].reg.index, results[2].reg.index,
+                      in[0].reg.index)) return false;
+        } else {
+            if (!input(node, "Origin", V, in[0]) || !input(node, "Direction", V, in[1]) ||
+                !input(node, "Distance", F, in[2])) return false;
+            if (!alloc(B, results[0].reg) || !alloc(V, results[1].reg) ||
+                !alloc(VSRegType::Object, results[2].reg)) return false;
+            if (!emit(VSOp::Raycast, results[0].reg.index, results[1].reg.index, results[2].reg.index) ||
+                !emit(VSOp::ExtraArg, in[0].reg.index, in[1].reg.index, in[2].reg.index)) return false;
+        }
+        for (size_t i = 0; i < 3; i++) localCache_[node.outputs[i].id] = results[i];
+        out = results[index];
+        return true;
+    }
+    return fail(node, "node has no data output in bytecode");
+}
+
+// A chain ends by falling through to whatever its caller emits next, so
+// compiled code can be shared between flows that converge on a node only
+// when they also continue the same way afterwards
+inline bool VisualScriptCompiler::follow(const VisualScriptNode& node, const char* flowPin) {
+    int index = findPin(node.outputs, flowPin);
+    if (index < 0) return fail(node, std::string("missing flow output ") + flowPin);
+    auto target = flowTarget_.find(node.outputs[index].id);
+    if (target == flowTarget_.end()) return true;
+    const VisualScriptNode& next = *pins_[target->second].node;
+    auto done = emitted_.find((uint64_t)next.id << 32 | continuation_);
+    if (done != emitted_.end()) return emit(VSOp::Jump, 0, 0, 0, done->second);
+    return statement(next);
+}
+
+// For chains that fall through somewhere else than the current one
+// (a loop body, a Sequence step, an event handler)
+inline bool VisualScriptCompiler::followInto(const VisualScriptNode& node, const char* flowPin) {
+    uint32_t outer = continuation_;
+    continuation_ = nextContinuation_++;
+    bool ok = follow(node, flowPin);
+    continuation_ = outer;
+    return ok;
+}
+
+inline bool VisualScriptCompiler::statement(const VisualScriptNode& node) {
+    if (!onStack_.insert(node.id).second) return fail(node, "execution cycle outside a loop node");
+    reached_.insert(node.id);
+    localCache_.clear();
+    uint16_t start = here();
+    bool ok = statementBody(node);
+    onStack_.erase(node.id);
+    if (ok) emitted_.emplace((uint64_t)node.id << 32 | continuation_, start);
+    return ok;
+}
+
+inline bool VisualScriptCompiler::statementBody(const VisualScriptNode& node) {
+    const std::string& type = node.name;
+    Value in[2];
+
+    if (type == "Branch") {
+        if (!input(node, "Condition", VSRegType::Bool, in[0])) return false;
+        if (in[0].constant) {
+            // Only the taken side is compiled
+            return follow(node, program_->registers_.b[in[0].reg.index] ? "True" : "False");
+        }
+        size_t skipTrue = program_->code_.size();
+        if (!emit(VSOp::JumpIfFalse, in[0].reg.index) || !follow(node, "True")) return false;
+        size_t skipFalse = program_->code_.size();
+        if (!emit(VSOp::Jump)) return false;
+        patch(skipTrue);
+        if (!follow(node, "False")) return false;
+        patch(skipFalse);
+        return true;
+    }
+    if (type == "Sequence") {
+        return followInto(node, "Then 0") && follow(node, "Then 1");
+    }
+    if (type == "ForLoop") {
+        // Inclusive range; End is read once on entry
+        if (!input(node, "Start", VSRegType::Int, in[0]) || !input(node, "End", VSRegType::Int, in[1])) return false;
+        VSReg index = loopIndex(node);
+        if (!emit(VSOp::MovI, index.index, in[0].reg.index)) return false;
+        VSReg end = in[1].reg;
+        if (!in[1].constant) {
+            // End can be a variable's own register, which the body may assign
+            if (!alloc(VSRegType::Int, end) || !emit(VSOp::MovI, end.index, in[1].reg.index)) return false;
+        }
+        uint16_t top = here();
+        size_t exit = program_->code_.size();
+        if (!emit(VSOp::JumpIfGreaterI, index.index, end.index) || !followInto(node, "Loop Body") ||
+            !emit(VSOp::IncI, index.index) || !emit(VSOp::Jump, 0, 0, 0, top)) return false;
+        patch(exit);
+        return follow(node, "Completed");
+    }
+    if (type == "WhileLoop") {
+        VSReg counter;
+        if (!alloc(VSRegType::Int, counter)) return false;
+        Value zero;
+        Pin unset;
+        if (!constant(node, unset, VSRegType::Int, zero) ||
+            !emit(VSOp::MovI, counter.index, zero.reg.index)) return false;
+        uint16_t top = here();
+        if (!input(node, "Condition", VSRegType::Bool, in[0])) return false;
+        bool always = in[0].constant && program_->registers_.b[in[0].reg.index];
+        if (in[0].constant && !always) return follow(node, "Completed");
+        size_t exit = program_->code_.size();
+        if (!always && !emit(VSOp::JumpIfFalse, in[0].reg.index)) return false;
+        if (!emit(VSOp::LoopGuard, counter.index) || !followInto(node, "Loop Body") ||
+            !emit(VSOp::Jump, 0, 0, 0, top)) return false;
+        if (!always) patch(exit);
+        return follow(node, "Completed");
+    }
+    if (type == "SetVariable") {
+        const auto* var = variableOf(node);
+        if (!var) return fail(node, "unknown variable");
+        if (!input(node, "Value", var->reg.type, in[0])) return false;
+        static const VSOp moves[] = {VSOp::MovB, VSOp::MovI, VSOp::MovF, VSOp::MovS,
+                                     VSOp::MovV2, VSOp::MovV3, VSOp::MovQ, VSOp::MovO};
+        if (!emit(moves[(size_t)var->reg.type], var->reg.index, in[0].reg.index)) return false;
+        return follow(node, "Exec");
+    }
+
+    // Host actions: (Object, argument) or (argument[, argument])
+    struct Action { const char* name; VSOp op; const char* arg0; VSRegType type0; const char* arg1; VSRegType type1; };
+    const VSRegType O = VSRegType::Object, V = VSRegType::Vec3, S = VSRegType::String;
+    static const Action actions[] = {
+        {"SetPosition", VSOp::SetPosition, "Object", O, "Position", V},
+        {"SetRotation", VSOp::SetRotation, "Object", O, "Rotation", VSRegType::Quat},
+        {"Translate", VSOp::Translate, "Object", O, "Delta", V},
+        {"Rotate", VSOp::Rotate, "Object", O, "Euler", VSRegType::Quat},
+        {"LookAt", VSOp::LookAt, "Object", O, "Target", V},
+        {"AddForce", VSOp::AddForce, "Object", O, "Force", V},
+        {"AddImpulse", VSOp::AddImpulse, "Object", O, "Impulse", V},
+        {"PlaySound", VSOp::PlaySound, "Sound", S, "Volume", VSRegType::Float},
+        {"StopSound", VSOp::StopSound, "Sound", S, nullptr, VSRegType::None},
+        {"Print", VSOp::Print, "Message", S, nullptr, VSRegType::None},
+        {"DrawDebugLine", VSOp::DrawDebugLine, "Start", V, "End", V},
+    };
+    for (const auto& action : actions) {
+        if (type != action.name) continue;
+        if (!input(node, action.arg0, action.type0, in[0])) return false;
+        if (action.arg1 && !input(node, action.arg1, action.type1, in[1])) return false;
+        if (!emit(action.op, in[0].reg.index, in[1].reg.index)) return false;
+        return follow(node, "Exec");
+    }
+    return fail(node, "node cannot be executed in bytecode");
+}
+
+}  // namespace luma
@@ -20,6 +20,7 @@
 #include "engine/lighting/light.h"
 #include "engine/rendering/lod.h"
 #include "engine/rendering/instancing.h"
+#include "engine/asset/async_texture_loader.h"
 #include "engine/rendering/ssao.h"
 #include "engine/rendering/ssr.h"
 #include "engine/rendering/volumetrics.h"
@@ -2264,6 +2265,37 @@ inline void drawOptimizationStatsPanel(EditorState& state) {
             ImGui::Unindent(10);
         }
         
+        // Texture streaming section
+        if (ImGui::CollapsingHeader("Texture Streaming")) {
+            ImGui::Indent(10);
+            
+            auto& loader = getAsyncTextureLoader();
+            TextureStreamingStats streamStats = loader.getStats();
+            
+            ImGui::Text("Queued: %zu  In Flight: %zu  Workers: %zu",
+                        streamStats.queuedRequests, streamStats.inFlightRequests, streamStats.workerCount);
+            ImGui::Text("Completed: %llu  Coalesced: %llu  Cancelled: %llu",
+                        (unsigned long long)streamStats.completed, (unsigned long long)streamStats.coalesced,
+                        (unsigned long long)streamStats.cancelled);
+            ImGui::Text("Queue Latency: %.1f ms avg, %.1f ms max",
+                        streamStats.avgQueueLatencyMs, streamStats.maxQueueLatencyMs);
+            ImGui::Text("Load Time: %.1f ms avg", streamStats.avgLoadTimeMs);
+            
+            float budgetMB = streamStats.budgetBytes / (1024.0f * 1024.0f);
+            float residentMB = streamStats.residentBytes / (1024.0f * 1024.0f);
+            ImGui::ProgressBar(budgetMB > 0.0f ? residentMB / budgetMB : 0.0f, ImVec2(-1, 0));
+            ImGui::Text("Resident: %zu textures, %.1f / %.0f MB", streamStats.residentTextures, residentMB, budgetMB);
+            ImGui::Text("Trimmed: %zu  Mips Evicted: %llu  Restores: %llu", streamStats.trimmedTextures,
+                        (unsigned long long)streamStats.mipsEvicted, (unsigned long long)streamStats.restores);
+            
+            int budget = static_cast<int>(budgetMB);
+            if (ImGui::SliderInt("Budget (MB)", &budget, 64, 4096)) {
+                loader.setMemoryBudget(static_cast<size_t>(budget) << 20);
+            }
+            
+            ImGui::Unindent(10);
+        }
+        
         // Summary
         ImGui::Separator();
         
@@ -4311,6 +4343,46 @@ inline void drawAudioEditorPanel(AudioEditorState& audioState, EditorState& stat
         ImGui::Text("Playing: %zu sources", audioSystem.getPlayingCount());
     }
     
+    // === Performance ===
+    if (ImGui::CollapsingHeader("Performance")) {
+        int maxReal = audioSystem.getMaxRealVoices();
+        if (ImGui::SliderInt("Max Real Voices", &maxReal, 1, 256)) {
+            audioSystem.setMaxRealVoices(maxReal);
+        }
+        
+        AudioMixStats stats = audioSystem.getMixStats();
+        ImGui::Text("Voices: %u real / %u virtual", stats.realVoices, stats.virtualVoices);
+        ImGui::Text("Mix: %.0f us avg, %.0f us max (deadline %.0f us)",
+                    stats.avgMixUs, stats.maxMixUs, stats.deadlineUs);
+        ImGui::ProgressBar((float)std::min(1.0, stats.load()), ImVec2(-1, 0), "Deadline used");
+        ImGui::Text("Overruns: %llu  Underruns: %llu  Deferred commands: %llu",
+                    (unsigned long long)stats.overruns, (unsigned long long)stats.underruns,
+                    (unsigned long long)stats.commandsDeferred);
+        ImGui::Text("Mix thread: %s", audioSystem.isMixThreadRunning() ? "running" : "device callback");
+        if (ImGui::Button("Reset Stats##audio")) {
+            audioSystem.resetMixStats();
+        }
+        
+        // Clip memory: resident clips hold all samples, streamed ones only
+        // the rings of the voices playing them
+        ImGui::Separator();
+        size_t totalBytes = 0;
+        for (const auto& [name, clip] : audioSystem.getClips()) {
+            size_t bytes = clip->getResidentBytes();
+            totalBytes += bytes;
+            ImGui::Text("%-24s %-9s %8.1f KB  %.1fs", name.c_str(),
+                        clip->isStreaming() ? "streamed" : "resident",
+                        bytes / 1024.0f, clip->getDuration());
+            if (clip->isStreaming() && clip->getStreamUnderruns() > 0) {
+                ImGui::SameLine();
+                ImGui::TextColored(ImVec4(1.0f, 0.5f, 0.2f, 1.0f), "%llu underruns",
+                                   (unsigned long long)clip->getStreamUnderruns());
+            }
+        }
+        ImGui::Text("Clip memory: %.2f MB, %zu active streams",
+                    totalBytes / (1024.0f * 1024.0f), audioSystem.getActiveStreamCount());
+    }
+    
     // === Listener ===
     if (ImGui::CollapsingHeader("Listener")) {
         auto& listener = audioSystem.getListener();
@@ -4472,6 +4544,9 @@ inline void drawAudioEditorPanel(AudioEditorState& audioState, EditorState& stat
             // Debug info
             ImGui::Text("Computed Volume: %.3f", source->computedVolume);
             ImGui::Text("Pan L/R: %.2f / %.2f", source->computedPanL, source->computedPanR);
+            if (source->isPlaying() && source->isVirtual()) {
+                ImGui::TextDisabled("Virtual (not mixed)");
+            }
             
             if (ImGui::Button("Delete Source")) {
                 audioSystem.destroySource(source.get());
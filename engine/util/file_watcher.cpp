@@ -1,8 +1,11 @@
 // File Watcher Implementation
-// Cross-platform file modification time detection
+// inotify on Linux, modification time polling elsewhere
 
 #include "file_watcher.h"
 #include <iostream>
+#include <filesystem>
+#include <system_error>
+#include <unordered_set>
 
 #if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN
@@ -12,10 +15,68 @@
 #include <sys/stat.h>
 #endif
 
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#define LUMA_HAS_INOTIFY 1
+#else
+#define LUMA_HAS_INOTIFY 0
+#endif
+
 namespace luma {
 
-FileWatcher::FileWatcher() = default;
-FileWatcher::~FileWatcher() = default;
+#if LUMA_HAS_INOTIFY
+static constexpr uint32_t kInotifyMask =
+    IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MOVED_FROM;
+#endif
+
+FileWatcher::FileWatcher() {
+    initBackend();
+}
+
+FileWatcher::~FileWatcher() {
+    shutdownBackend();
+}
+
+void FileWatcher::initBackend() {
+#if LUMA_HAS_INOTIFY
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ >= 0) {
+        backend_ = Backend::Inotify;
+        eventBuffer_.resize(64 * 1024);
+        return;
+    }
+    std::cerr << "[filewatcher] inotify unavailable, falling back to polling" << std::endl;
+#endif
+    backend_ = Backend::Polling;
+}
+
+void FileWatcher::shutdownBackend() {
+#if LUMA_HAS_INOTIFY
+    if (inotifyFd_ >= 0) {
+        close(inotifyFd_);  // releases every watch descriptor
+        inotifyFd_ = -1;
+    }
+#endif
+    wdToDir_.clear();
+    dirToWd_.clear();
+    dirRefCount_.clear();
+    rearmParents_.clear();
+}
+
+void FileWatcher::setForcePolling(bool force) {
+    if (!watchedFiles_.empty() || !watchedDirs_.empty()) {
+        std::cerr << "[filewatcher] Warning: backend change ignored while watches are active" << std::endl;
+        return;
+    }
+    shutdownBackend();
+    if (force) {
+        backend_ = Backend::Polling;
+    } else {
+        initBackend();
+    }
+}
 
 uint64_t FileWatcher::getFileModTime(const std::string& path) {
 #if defined(_WIN32)
@@ -41,18 +102,162 @@ uint64_t FileWatcher::getFileModTime(const std::string& path) {
 #endif
 }
 
+std::string FileWatcher::normalizePath(const std::string& path) {
+    std::string result = path;
+    while (result.size() > 1 && (result.back() == '/' || result.back() == '\\')) {
+        result.pop_back();
+    }
+    return result;
+}
+
+std::string FileWatcher::parentDirectory(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    if (slash == std::string::npos) return ".";
+    if (slash == 0) return "/";
+    return path.substr(0, slash);
+}
+
+// ===== Directory watch bookkeeping (inotify) =====
+
+void FileWatcher::addDirectoryWatch(const std::string& dir) {
+#if LUMA_HAS_INOTIFY
+    if (backend_ != Backend::Inotify) return;
+
+    if (dirRefCount_[dir]++ > 0) return;
+
+    int wd = inotify_add_watch(inotifyFd_, dir.c_str(), kInotifyMask);
+    if (wd < 0) {
+        std::cerr << "[filewatcher] Warning: cannot watch directory: " << dir
+                  << " (errno " << errno << ")" << std::endl;
+        dirRefCount_.erase(dir);
+        return;
+    }
+    wdToDir_[wd] = dir;
+    dirToWd_[dir] = wd;
+#else
+    (void)dir;
+#endif
+}
+
+void FileWatcher::removeDirectoryWatch(const std::string& dir) {
+#if LUMA_HAS_INOTIFY
+    if (backend_ != Backend::Inotify) return;
+
+    auto refIt = dirRefCount_.find(dir);
+    if (refIt == dirRefCount_.end()) return;
+    if (--refIt->second > 0) return;
+    dirRefCount_.erase(refIt);
+
+    auto rearmIt = rearmParents_.find(dir);
+    if (rearmIt != rearmParents_.end()) {
+        std::string parent = rearmIt->second;
+        rearmParents_.erase(rearmIt);
+        removeDirectoryWatch(parent);
+    }
+
+    auto wdIt = dirToWd_.find(dir);
+    if (wdIt != dirToWd_.end()) {
+        inotify_rm_watch(inotifyFd_, wdIt->second);
+        wdToDir_.erase(wdIt->second);
+        dirToWd_.erase(wdIt);
+    }
+#else
+    (void)dir;
+#endif
+}
+
+void FileWatcher::addDirectoryTree(const std::string& dir) {
+    addDirectoryWatch(dir);
+
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(dir, ec);
+         !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (it->is_directory(ec)) {
+            addDirectoryWatch(it->path().string());
+        }
+    }
+}
+
+// A referenced directory lost its watch (deleted or moved away). Keep its
+// references and watch the parent so the directory can be re-armed when it
+// is created again.
+void FileWatcher::orphanDirectory(const std::string& dir) {
+#if LUMA_HAS_INOTIFY
+    auto wdIt = dirToWd_.find(dir);
+    if (wdIt != dirToWd_.end()) {
+        wdToDir_.erase(wdIt->second);
+        dirToWd_.erase(wdIt);
+    }
+    if (dirRefCount_.count(dir) == 0 || rearmParents_.count(dir) > 0) return;
+
+    std::string parent = parentDirectory(dir);
+    if (parent == dir) return;
+    addDirectoryWatch(parent);
+    rearmParents_[dir] = parent;
+#else
+    (void)dir;
+#endif
+}
+
+void FileWatcher::rearmDirectory(const std::string& dir, Clock::time_point now) {
+#if LUMA_HAS_INOTIFY
+    auto rearmIt = rearmParents_.find(dir);
+    if (rearmIt == rearmParents_.end()) return;
+
+    int wd = inotify_add_watch(inotifyFd_, dir.c_str(), kInotifyMask);
+    if (wd < 0) return;  // not there yet; try again on the next create event
+    wdToDir_[wd] = dir;
+    dirToWd_[dir] = wd;
+    std::string parent = rearmIt->second;
+    rearmParents_.erase(rearmIt);
+    removeDirectoryWatch(parent);
+
+    // Anything created before the watch was armed produced no event
+    std::error_code ec;
+    for (auto it = std::filesystem::directory_iterator(dir, ec);
+         !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+        std::string path = it->path().string();
+        if (it->is_directory(ec)) {
+            if (rearmParents_.count(path) > 0) {
+                rearmDirectory(path, now);
+            } else if (dirRefCount_.count(path) == 0) {
+                for (const auto& [root, watched] : watchedDirs_) {
+                    if (watched.recursive && isInsideDirectory(path, watched)) {
+                        addDirectoryTree(path);
+                        break;
+                    }
+                }
+            }
+        } else if (isWatched(path)) {
+            queueChange(path, now);
+        }
+    }
+#else
+    (void)dir;
+    (void)now;
+#endif
+}
+
+// ===== Watch management =====
+
 void FileWatcher::watchFile(const std::string& path, FileChangeCallback callback) {
     WatchedFile wf;
     wf.path = path;
     wf.callback = callback;
     wf.lastModTime = getFileModTime(path);
-    
+
     if (wf.lastModTime == 0) {
         std::cerr << "[filewatcher] Warning: file not found: " << path << std::endl;
     }
-    
+
+    bool isNew = watchedFiles_.find(path) == watchedFiles_.end();
     watchedFiles_[path] = std::move(wf);
-    std::cout << "[filewatcher] Watching: " << path << std::endl;
+
+    // Watch the parent directory rather than the file itself so that editors
+    // which save via rename-over-original are still detected
+    if (isNew) {
+        addDirectoryWatch(parentDirectory(path));
+    }
 }
 
 void FileWatcher::watchFiles(const std::vector<std::string>& paths, FileChangeCallback callback) {
@@ -61,32 +266,330 @@ void FileWatcher::watchFiles(const std::vector<std::string>& paths, FileChangeCa
     }
 }
 
+void FileWatcher::watchDirectory(const std::string& path, FileChangeCallback callback, bool recursive) {
+    std::string dir = normalizePath(path);
+
+    std::error_code ec;
+    if (!std::filesystem::is_directory(dir, ec)) {
+        std::cerr << "[filewatcher] Warning: directory not found: " << dir << std::endl;
+        return;
+    }
+
+    unwatchDirectory(dir);
+
+    WatchedDirectory wd;
+    wd.path = dir;
+    wd.callback = std::move(callback);
+    wd.recursive = recursive;
+
+    if (backend_ == Backend::Inotify) {
+        if (recursive) {
+            addDirectoryTree(dir);
+        } else {
+            addDirectoryWatch(dir);
+        }
+    }
+
+    // Seed modification times so the first scan doesn't report every file
+    auto seed = [&](const std::filesystem::directory_entry& entry) {
+        if (entry.is_regular_file(ec)) {
+            std::string file = entry.path().string();
+            wd.fileModTimes[file] = getFileModTime(file);
+        }
+    };
+    if (recursive) {
+        for (auto it = std::filesystem::recursive_directory_iterator(dir, ec);
+             !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+            seed(*it);
+        }
+    } else {
+        for (auto it = std::filesystem::directory_iterator(dir, ec);
+             !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+            seed(*it);
+        }
+    }
+
+    watchedDirs_[dir] = std::move(wd);
+    std::cout << "[filewatcher] Watching directory: " << dir << (recursive ? " (recursive)" : "") << std::endl;
+}
+
 void FileWatcher::unwatchFile(const std::string& path) {
-    watchedFiles_.erase(path);
+    if (watchedFiles_.erase(path) > 0) {
+        removeDirectoryWatch(parentDirectory(path));
+    }
+    pending_.erase(path);
+}
+
+void FileWatcher::unwatchDirectory(const std::string& path) {
+    std::string dir = normalizePath(path);
+    auto it = watchedDirs_.find(dir);
+    if (it == watchedDirs_.end()) return;
+
+    if (backend_ == Backend::Inotify) {
+        // Release every directory watch below this root that we hold a reference for
+        std::vector<std::string> dirs;
+        std::string prefix = dir + "/";
+        for (const auto& [watched, count] : dirRefCount_) {
+            if (watched == dir || (it->second.recursive && watched.compare(0, prefix.size(), prefix) == 0)) {
+                dirs.push_back(watched);
+            }
+        }
+        for (const auto& d : dirs) {
+            removeDirectoryWatch(d);
+        }
+    }
+
+    watchedDirs_.erase(it);
 }
 
 void FileWatcher::unwatchAll() {
     watchedFiles_.clear();
+    watchedDirs_.clear();
+    pending_.clear();
+#if LUMA_HAS_INOTIFY
+    if (backend_ == Backend::Inotify) {
+        for (const auto& [wd, dir] : wdToDir_) {
+            inotify_rm_watch(inotifyFd_, wd);
+        }
+    }
+#endif
+    wdToDir_.clear();
+    dirToWd_.clear();
+    dirRefCount_.clear();
+    rearmParents_.clear();
 }
 
-bool FileWatcher::checkChanges() {
-    bool anyChanged = false;
-    
+// ===== Change detection =====
+
+void FileWatcher::queueChange(const std::string& path, Clock::time_point now) {
+    pending_[path] = now;
+}
+
+void FileWatcher::pollChanges(Clock::time_point now) {
     for (auto& [path, wf] : watchedFiles_) {
         uint64_t currentModTime = getFileModTime(path);
-        
-        if (currentModTime != 0 && currentModTime != wf.lastModTime) {
-            std::cout << "[filewatcher] File changed: " << path << std::endl;
+        if (currentModTime != wf.lastModTime) {
+            // A deleted file is reported to directory watchers only; the
+            // file callback fires once it comes back, as with inotify
+            wf.lastModTime = currentModTime;
+            queueChange(path, now);
+        }
+    }
+
+    for (auto& [dir, wd] : watchedDirs_) {
+        scanDirectory(wd, now);
+    }
+}
+
+// Diff a watched directory against its snapshot and queue every file created,
+// modified or deleted since. On the inotify backend subdirectories that were
+// missed are watched as well.
+void FileWatcher::scanDirectory(WatchedDirectory& wd, Clock::time_point now) {
+    std::error_code ec;
+    std::unordered_set<std::string> seen;
+    auto check = [&](const std::filesystem::directory_entry& entry) {
+        if (wd.recursive && backend_ == Backend::Inotify && entry.is_directory(ec)) {
+            std::string sub = entry.path().string();
+            if (dirRefCount_.count(sub) == 0) addDirectoryWatch(sub);
+            return;
+        }
+        if (!entry.is_regular_file(ec)) return;
+        std::string file = entry.path().string();
+        uint64_t currentModTime = getFileModTime(file);
+        auto [it, inserted] = wd.fileModTimes.try_emplace(file, currentModTime);
+        if (inserted || it->second != currentModTime) {
+            it->second = currentModTime;
+            queueChange(file, now);
+        }
+        seen.insert(file);
+    };
+    if (wd.recursive) {
+        for (auto it = std::filesystem::recursive_directory_iterator(wd.path, ec);
+             !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+            check(*it);
+        }
+    } else {
+        for (auto it = std::filesystem::directory_iterator(wd.path, ec);
+             !ec && it != std::filesystem::directory_iterator(); it.increment(ec)) {
+            check(*it);
+        }
+    }
+
+    // Files missing from a complete scan were deleted
+    bool complete = !ec;
+    if (!complete) {
+        std::error_code existsEc;
+        complete = !std::filesystem::exists(wd.path, existsEc) && !existsEc;
+    }
+    for (auto it = wd.fileModTimes.begin(); complete && it != wd.fileModTimes.end();) {
+        if (seen.count(it->first) == 0) {
+            queueChange(it->first, now);
+            it = wd.fileModTimes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void FileWatcher::readInotifyEvents(Clock::time_point now) {
+#if LUMA_HAS_INOTIFY
+    for (;;) {
+        ssize_t len = read(inotifyFd_, eventBuffer_.data(), eventBuffer_.size());
+        if (len <= 0) {
+            // EAGAIN: queue drained
+            break;
+        }
+
+        for (char* ptr = eventBuffer_.data(); ptr < eventBuffer_.data() + len;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+            ptr += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                // Kernel dropped events; treat every watched file as possibly
+                // changed and diff the watched directories against their snapshots
+                std::cerr << "[filewatcher] Warning: inotify queue overflow" << std::endl;
+                for (const auto& [path, wf] : watchedFiles_) {
+                    queueChange(path, now);
+                }
+                for (auto& [dir, wd] : watchedDirs_) {
+                    scanDirectory(wd, now);
+                }
+                continue;
+            }
+
+            auto dirIt = wdToDir_.find(event->wd);
+            if (dirIt == wdToDir_.end()) continue;
+
+            if (event->mask & IN_IGNORED) {
+                // Directory was removed or unmounted; re-armed if it comes back
+                std::string dir = dirIt->second;
+                orphanDirectory(dir);
+                continue;
+            }
+
+            if (event->len == 0) continue;
+
+            const std::string& dir = dirIt->second;
+            std::string path = (dir == ".") ? std::string(event->name) : dir + "/" + event->name;
+
+            if (event->mask & IN_ISDIR) {
+                if ((event->mask & (IN_CREATE | IN_MOVED_TO)) && rearmParents_.count(path) > 0) {
+                    rearmDirectory(path, now);
+                    continue;
+                }
+                // New subdirectory inside a recursive watch: start watching it as well
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    for (const auto& [root, wd] : watchedDirs_) {
+                        if (wd.recursive && isInsideDirectory(path, wd)) {
+                            addDirectoryTree(path);
+                            break;
+                        }
+                    }
+                }
+                continue;
+            }
+
+            // Siblings of individually watched files share the directory watch
+            if (isWatched(path)) {
+                queueChange(path, now);
+            }
+        }
+    }
+#else
+    (void)now;
+#endif
+}
+
+bool FileWatcher::isInsideDirectory(const std::string& path, const WatchedDirectory& dir) {
+    if (dir.recursive) {
+        return path.size() > dir.path.size() &&
+               path.compare(0, dir.path.size(), dir.path) == 0 &&
+               path[dir.path.size()] == '/';
+    }
+    return parentDirectory(path) == dir.path;
+}
+
+bool FileWatcher::isWatched(const std::string& path) const {
+    if (watchedFiles_.count(path) > 0) return true;
+    for (const auto& [dir, wd] : watchedDirs_) {
+        if (isInsideDirectory(path, wd)) return true;
+    }
+    return false;
+}
+
+bool FileWatcher::dispatchChange(const std::string& path) {
+    bool delivered = false;
+
+    auto fileIt = watchedFiles_.find(path);
+    if (fileIt != watchedFiles_.end()) {
+        WatchedFile& wf = fileIt->second;
+        uint64_t currentModTime = getFileModTime(path);
+        if (currentModTime != 0) {  // deleted files are reported once they come back
             wf.lastModTime = currentModTime;
-            anyChanged = true;
-            
+            std::cout << "[filewatcher] File changed: " << path << std::endl;
             if (wf.callback) {
                 wf.callback(path);
             }
+            delivered = true;
+        }
+    }
+
+    // Keep directory snapshots current so an overflow rescan only reports news
+    uint64_t modTime = watchedDirs_.empty() ? 0 : getFileModTime(path);
+    for (auto& [dir, wd] : watchedDirs_) {
+        if (isInsideDirectory(path, wd)) {
+            if (modTime != 0) {
+                wd.fileModTimes[path] = modTime;
+            } else {
+                wd.fileModTimes.erase(path);
+            }
+            if (wd.callback) {
+                wd.callback(path);
+            }
+            delivered = true;
         }
     }
-    
-    return anyChanged;
+
+    return delivered;
+}
+
+bool FileWatcher::checkChanges() {
+    auto now = Clock::now();
+
+    if (backend_ == Backend::Inotify) {
+        readInotifyEvents(now);
+    } else {
+        pollChanges(now);
+    }
+
+    if (pending_.empty()) return false;
+
+    // Deliver paths that have been quiet for the debounce window
+    std::vector<std::string> ready;
+    for (auto it = pending_.begin(); it != pending_.end();) {
+        if (now - it->second >= debounce_) {
+            ready.push_back(it->first);
+            it = pending_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (ready.empty()) return false;
+
+    std::vector<std::string> delivered;
+    delivered.reserve(ready.size());
+    for (const auto& path : ready) {
+        if (dispatchChange(path)) {
+            delivered.push_back(path);
+        }
+    }
+
+    if (!delivered.empty() && batchCallback_) {
+        batchCallback_(delivered);
+    }
+
+    return !delivered.empty();
 }
 
 std::vector<std::string> FileWatcher::getWatchedFiles() const {
@@ -1,11 +1,20 @@
 // File Watcher - Cross-platform file change detection
-// Used for shader hot-reload
+// Used for shader and asset hot-reload
+//
+// On Linux changes are reported by inotify (one watch per directory, recursive
+// directory watches supported). Other platforms fall back to polling file
+// modification times. In both cases events are coalesced per path, held back
+// for a short debounce window, and delivered in one batch from checkChanges()
+// on the calling (main) thread. Both backends report creations, modifications
+// and deletions; a watched directory that is deleted and recreated is picked up
+// again.
 #pragma once
 
 #include <string>
 #include <vector>
 #include <unordered_map>
 #include <functional>
+#include <chrono>
 #include <cstdint>
 
 namespace luma {
@@ -13,41 +22,121 @@ namespace luma {
 // Callback when file changes: (path) -> void
 using FileChangeCallback = std::function<void(const std::string& path)>;
 
+// Callback with every path delivered by one checkChanges() call
+using FileBatchCallback = std::function<void(const std::vector<std::string>& paths)>;
+
 class FileWatcher {
 public:
+    enum class Backend {
+        Polling,
+        Inotify
+    };
+
     FileWatcher();
     ~FileWatcher();
-    
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
     // Watch a file for changes
     void watchFile(const std::string& path, FileChangeCallback callback);
-    
+
     // Watch multiple files
     void watchFiles(const std::vector<std::string>& paths, FileChangeCallback callback);
-    
+
+    // Watch every file inside a directory; callback receives the changed file path
+    void watchDirectory(const std::string& path, FileChangeCallback callback, bool recursive = true);
+
     // Stop watching a file
     void unwatchFile(const std::string& path);
-    
+
+    // Stop watching a directory
+    void unwatchDirectory(const std::string& path);
+
     // Stop watching all files
     void unwatchAll();
-    
+
     // Check for changes and invoke callbacks (call once per frame)
     // Returns true if any file changed
     bool checkChanges();
-    
+
+    // Called once per checkChanges() with all paths delivered in that call
+    void setBatchCallback(FileBatchCallback callback) { batchCallback_ = std::move(callback); }
+
+    // Events for a path are held until it has been quiet for this long (0 = deliver immediately)
+    void setDebounceTime(std::chrono::milliseconds debounce) { debounce_ = debounce; }
+    std::chrono::milliseconds getDebounceTime() const { return debounce_; }
+
+    // Force the polling backend (must be called before adding watches)
+    void setForcePolling(bool force);
+
+    Backend getBackend() const { return backend_; }
+
     // Get list of watched files
     std::vector<std::string> getWatchedFiles() const;
-    
+
+    size_t getWatchCount() const { return watchedFiles_.size(); }
+    size_t getPendingCount() const { return pending_.size(); }
+
 private:
+    using Clock = std::chrono::steady_clock;
+
     struct WatchedFile {
         std::string path;
         FileChangeCallback callback;
         uint64_t lastModTime = 0;
     };
-    
+
+    struct WatchedDirectory {
+        std::string path;
+        FileChangeCallback callback;
+        bool recursive = true;
+        // Modification times of files seen in the last scan. Polled on the
+        // polling backend; with inotify only rescanned after a queue overflow.
+        std::unordered_map<std::string, uint64_t> fileModTimes;
+    };
+
     std::unordered_map<std::string, WatchedFile> watchedFiles_;
-    
+    std::unordered_map<std::string, WatchedDirectory> watchedDirs_;
+
+    // Coalesced changes waiting for the debounce window: path -> last event time
+    std::unordered_map<std::string, Clock::time_point> pending_;
+
+    FileBatchCallback batchCallback_;
+    std::chrono::milliseconds debounce_{50};
+    Backend backend_ = Backend::Polling;
+
+    // inotify state (Linux only)
+    int inotifyFd_ = -1;
+    std::unordered_map<int, std::string> wdToDir_;
+    std::unordered_map<std::string, int> dirToWd_;
+    std::unordered_map<std::string, int> dirRefCount_;
+    // Directories removed while still referenced -> parent watched until they return
+    std::unordered_map<std::string, std::string> rearmParents_;
+    std::vector<char> eventBuffer_;
+
+    void initBackend();
+    void shutdownBackend();
+
+    void addDirectoryWatch(const std::string& dir);
+    void removeDirectoryWatch(const std::string& dir);
+    void addDirectoryTree(const std::string& dir);
+    void orphanDirectory(const std::string& dir);
+    void rearmDirectory(const std::string& dir, Clock::time_point now);
+
+    void pollChanges(Clock::time_point now);
+    void scanDirectory(WatchedDirectory& dir, Clock::time_point now);
+    void readInotifyEvents(Clock::time_point now);
+    void queueChange(const std::string& path, Clock::time_point now);
+    bool dispatchChange(const std::string& path);
+    bool isWatched(const std::string& path) const;
+
+    static bool isInsideDirectory(const std::string& path, const WatchedDirectory& dir);
+
     // Get file modification time (returns 0 if file doesn't exist)
     static uint64_t getFileModTime(const std::string& path);
+    static std::string parentDirectory(const std::string& path);
+    static std::string normalizePath(const std::string& path);
 };
 
 }  // namespace luma
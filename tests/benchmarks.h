@@ -0,0 +1,2442 @@
+// LUMA Studio - Performance Benchmarks
+// Run with: ./luma_integration_test --bench [filter]
+#pragma once
+
+#include "engine/util/file_watcher.h"
+#include "engine/foundation/log.h"
+#include "engine/asset/texture_cache.h"
+#include "engine/asset/texture_compression.h"
+#include "engine/asset/async_texture_loader.h"
+#include "engine/audio/audio.h"
+#include "engine/animation/lip_sync.h"
+#include "engine/character/ai/ai_inference.h"
+#include "engine/character/skin_deformer.h"
+#include "engine/character/makehuman_integration.h"
+#include "engine/character/auto_rig.h"
+#include "engine/character/uv_mapping.h"
+#include "engine/animation/animation.h"
+#include "engine/renderer/rhi/software_backend.h"
+#include "engine/rendering/culling.h"
+#include "engine/rendering/scene_culling.h"
+#include "engine/network/network.h"
+#include "engine/network/replication.h"
+#include "engine/ai/crowd.h"
+#include "engine/ai/tiled_navmesh.h"
+#include "engine/ai/behavior_tree.h"
+#include "engine/script/visual_script_vm.h"
+#include "engine/game_ui/ui_batch_renderer.h"
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <cmath>
+#include <algorithm>
+
+namespace luma {
+namespace test {
+
+// ===== Benchmark Framework =====
+class BenchmarkRunner {
+public:
+    struct Benchmark {
+        std::string category;
+        std::string name;
+        std::function<void()> run;
+    };
+
+    std::vector<Benchmark> benchmarks;
+
+    void add(const std::string& category, const std::string& name, std::function<void()> fn) {
+        benchmarks.push_back({category, name, fn});
+    }
+
+    void run(const std::string& filter = "") {
+        std::cout << "\n";
+        std::cout << "╔══════════════════════════════════════════╗\n";
+        std::cout << "║      LUMA Studio Benchmarks              ║\n";
+        std::cout << "╚══════════════════════════════════════════╝\n";
+
+        std::string currentCategory;
+        for (const auto& bench : benchmarks) {
+            if (!filter.empty() &&
+                bench.category.find(filter) == std::string::npos &&
+                bench.name.find(filter) == std::string::npos) {
+                continue;
+            }
+            if (bench.category != currentCategory) {
+                currentCategory = bench.category;
+                std::cout << "\n--- " << currentCategory << " ---\n";
+            }
+            std::cout << "[BENCH] " << bench.name << "\n";
+            bench.run();
+        }
+    }
+};
+
+// Wall-clock timer in milliseconds
+class BenchTimer {
+public:
+    BenchTimer() : start_(std::chrono::high_resolution_clock::now()) {}
+
+    double elapsedMs() const {
+        auto now = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double, std::milli>(now - start_).count();
+    }
+
+private:
+    std::chrono::high_resolution_clock::time_point start_;
+};
+
+inline void reportMetric(const std::string& label, double value, const std::string& unit) {
+    std::cout << "    " << std::left << std::setw(36) << label << std::right
+              << std::fixed << std::setprecision(3) << std::setw(14) << value << " " << unit << "\n";
+}
+
+// Scratch directory under the system temp path, removed on destruction
+class ScratchDirectory {
+public:
+    explicit ScratchDirectory(const std::string& name) {
+        path_ = (std::filesystem::temp_directory_path() / ("luma_bench_" + name)).string();
+        std::filesystem::remove_all(path_);
+        std::filesystem::create_directories(path_);
+    }
+    ~ScratchDirectory() {
+        std::error_code ec;
+        std::filesystem::remove_all(path_, ec);
+    }
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+};
+
+// ===== File Watcher Benchmarks =====
+namespace FileWatcherBench {
+
+inline void measureFrameCost(FileWatcher& watcher, const char* label, int frames) {
+    BenchTimer timer;
+    for (int i = 0; i < frames; i++) {
+        watcher.checkChanges();
+    }
+    reportMetric(label, timer.elapsedMs() * 1000.0 / frames, "us/frame");
+}
+
+inline void benchWatch10kFiles() {
+    constexpr int kFileCount = 10000;
+    constexpr int kDirCount = 100;
+    constexpr int kFrames = 60;
+
+    ScratchDirectory scratch("filewatcher");
+    std::vector<std::string> files;
+    files.reserve(kFileCount);
+    for (int d = 0; d < kDirCount; d++) {
+        std::string dir = scratch.path() + "/dir" + std::to_string(d);
+        std::filesystem::create_directories(dir);
+        for (int f = 0; f < kFileCount / kDirCount; f++) {
+            std::string path = dir + "/asset" + std::to_string(f) + ".bin";
+            std::ofstream(path) << "x";
+            files.push_back(path);
+        }
+    }
+
+    auto touch = [](const std::string& path) { std::ofstream(path, std::ios::app) << "y"; };
+
+    // Polling: stat() every watched file on every frame
+    {
+        FileWatcher watcher;
+        watcher.setForcePolling(true);
+        watcher.setDebounceTime(std::chrono::milliseconds(0));
+        int changes = 0;
+        watcher.watchFiles(files, [&](const std::string&) { changes++; });
+        measureFrameCost(watcher, "polling, idle", kFrames);
+
+        touch(files[kFileCount / 2]);
+        watcher.checkChanges();
+        reportMetric("polling, changes detected", changes, "");
+    }
+
+    // Event driven: drain the inotify queue only
+    {
+        FileWatcher watcher;
+        watcher.setDebounceTime(std::chrono::milliseconds(0));
+        if (watcher.getBackend() != FileWatcher::Backend::Inotify) {
+            std::cout << "    (inotify backend unavailable on this platform)\n";
+            return;
+        }
+        int changes = 0;
+        watcher.watchFiles(files, [&](const std::string&) { changes++; });
+        measureFrameCost(watcher, "inotify, idle", kFrames);
+
+        for (int i = 0; i < 100; i++) {
+            touch(files[i * 97]);
+        }
+        BenchTimer timer;
+        watcher.checkChanges();
+        reportMetric("inotify, frame with 100 changes", timer.elapsedMs() * 1000.0, "us");
+        reportMetric("inotify, changes detected", changes, "");
+    }
+}
+
+}  // namespace FileWatcherBench
+
+// ===== Logging Benchmarks =====
+namespace LogBench {
+
+class NullLogSink : public LogSink {
+public:
+    size_t bytes = 0;
+    void write(const LogRecord&, std::string_view line) override { bytes += line.size(); }
+};
+
+inline void benchLogCall() {
+    constexpr int kBatch = 4096;   // below ring capacity so nothing is dropped
+    constexpr int kRounds = 64;
+
+    Logger& logger = Logger::get();
+    logger.flush();
+    logger.clearSinks();
+    logger.addSink(std::make_shared<NullLogSink>());
+
+    // Producer cost only: enqueue a batch, then let the sink thread catch up untimed
+    double producerMs = 0.0;
+    for (int r = 0; r < kRounds; r++) {
+        BenchTimer timer;
+        for (int i = 0; i < kBatch; i++) {
+            LUMA_LOG_INFO(LogCategory::Asset, "Imported mesh {} with {} vertices ({} ms)", i, i * 3, 0.25);
+        }
+        producerMs += timer.elapsedMs();
+        logger.flush();
+    }
+    reportMetric("async, 3 args", producerMs * 1e6 / (double(kBatch) * kRounds), "ns/call");
+
+    // Runtime-filtered call
+    logger.setCategoryLevel(LogCategory::Asset, LogLevel::Warn);
+    {
+        BenchTimer timer;
+        for (int i = 0; i < kBatch * kRounds; i++) {
+            LUMA_LOG_INFO(LogCategory::Asset, "Imported mesh {} with {} vertices ({} ms)", i, i * 3, 0.25);
+        }
+        reportMetric("async, filtered by category", timer.elapsedMs() * 1e6 / (double(kBatch) * kRounds), "ns/call");
+    }
+    logger.setCategoryLevel(LogCategory::Asset, LogLevel::Info);
+
+    // Four producer threads
+    {
+        constexpr int kThreads = 4;
+        std::vector<std::thread> threads;
+        BenchTimer timer;
+        for (int t = 0; t < kThreads; t++) {
+            threads.emplace_back([&]() {
+                for (int i = 0; i < kBatch / kThreads; i++) {
+                    LUMA_LOG_INFO(LogCategory::Asset, "Worker mesh {}", i);
+                }
+            });
+        }
+        for (auto& t : threads) t.join();
+        reportMetric("async, 4 producer threads", timer.elapsedMs() * 1e6 / kBatch, "ns/call");
+        logger.flush();
+    }
+    reportMetric("dropped (ring buffer full)", double(logger.getDroppedCount()), "");
+
+    logger.clearSinks();
+    logger.addSink(std::make_shared<ConsoleLogSink>());
+
+    // Baseline: previous behaviour, synchronous formatting + std::endl per line
+    ScratchDirectory scratch("log");
+    std::ofstream out(scratch.path() + "/sync.log");
+    {
+        BenchTimer timer;
+        for (int i = 0; i < kBatch; i++) {
+            out << "[luma] " << "Imported mesh " + std::to_string(i) + " with " + std::to_string(i * 3) +
+                   " vertices (" + std::to_string(0.25) + " ms)" << std::endl;
+        }
+        reportMetric("sync ostream + endl (baseline)", timer.elapsedMs() * 1e6 / kBatch, "ns/call");
+    }
+}
+
+}  // namespace LogBench
+
+// ===== Texture Cache Benchmarks =====
+namespace TextureBench {
+
+// A character split into many material slots that reuse a handful of 2K maps
+// (body/head/hands share skin textures, clothing pieces share fabric maps)
+inline void benchSharedCharacterTextures() {
+    constexpr int kMeshes = 24;
+    constexpr int kUniqueImages = 6;
+    constexpr int kSize = 2048;
+
+    std::vector<std::vector<uint8_t>> encoded(kUniqueImages);
+    for (int i = 0; i < kUniqueImages; i++) {
+        encoded[i].assign(4096, static_cast<uint8_t>(i));
+    }
+    auto decode = [&](int image) {
+        TextureData tex;
+        tex.width = kSize;
+        tex.height = kSize;
+        tex.channels = 4;
+        tex.pixels.assign(static_cast<size_t>(kSize) * kSize * 4, static_cast<uint8_t>(image));
+        return tex;
+    };
+
+    // Baseline: each mesh decodes and owns its own copy
+    size_t privateBytes = 0;
+    {
+        BenchTimer timer;
+        std::vector<TextureData> copies;
+        for (int m = 0; m < kMeshes; m++) {
+            copies.push_back(decode(m % kUniqueImages));
+            privateBytes += copies.back().pixels.size();
+        }
+        reportMetric("per-mesh copies, load", timer.elapsedMs(), "ms");
+    }
+
+    TextureCache& cache = getTextureCache();
+    cache.resetStats();
+    {
+        BenchTimer timer;
+        std::vector<TextureHandle> handles;
+        for (int m = 0; m < kMeshes; m++) {
+            int image = m % kUniqueImages;
+            handles.push_back(cache.getOrLoadMemory(encoded[image].data(), encoded[image].size(),
+                                                    [&]() { return decode(image); }));
+        }
+        reportMetric("shared cache, load", timer.elapsedMs(), "ms");
+    }
+    TextureCacheStats stats = cache.getStats();
+    reportMetric("per-mesh copies, resident", privateBytes / (1024.0 * 1024.0), "MB");
+    reportMetric("shared cache, resident", stats.decodedBytes / (1024.0 * 1024.0), "MB");
+    reportMetric("decoded bytes saved", stats.bytesSaved / (1024.0 * 1024.0), "MB");
+    reportMetric("hit rate", stats.hitRate() * 100.0, "%");
+}
+
+// Synthetic albedo: gradients, a soft pattern and per-pixel noise
+inline std::vector<uint8_t> makeBenchAlbedo(int size) {
+    std::vector<uint8_t> image(static_cast<size_t>(size) * size * 4);
+    uint32_t seed = 12345;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            seed = seed * 1664525u + 1013904223u;
+            int noise = static_cast<int>((seed >> 24) & 15) - 8;
+            float pattern = 0.5f + 0.5f * std::sin(x * 0.05f) * std::cos(y * 0.07f);
+            uint8_t* p = &image[(static_cast<size_t>(y) * size + x) * 4];
+            p[0] = static_cast<uint8_t>(std::clamp(int(180 * pattern) + 40 + noise, 0, 255));
+            p[1] = static_cast<uint8_t>(std::clamp(int(x * 255 / size) / 2 + 60 + noise, 0, 255));
+            p[2] = static_cast<uint8_t>(std::clamp(int(y * 255 / size) / 3 + 30 + noise, 0, 255));
+            p[3] = 255;
+        }
+    }
+    return image;
+}
+
+// Synthetic tangent-space normal map of overlapping bumps
+inline std::vector<uint8_t> makeBenchNormalMap(int size) {
+    std::vector<uint8_t> image(static_cast<size_t>(size) * size * 4);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            float nx = 0.4f * std::sin(x * 0.09f) + 0.2f * std::sin((x + y) * 0.21f);
+            float ny = 0.4f * std::cos(y * 0.11f) + 0.2f * std::cos((x - y) * 0.17f);
+            float nz = std::sqrt(std::max(0.0f, 1.0f - nx * nx - ny * ny));
+            uint8_t* p = &image[(static_cast<size_t>(y) * size + x) * 4];
+            p[0] = static_cast<uint8_t>((nx * 0.5f + 0.5f) * 255.0f + 0.5f);
+            p[1] = static_cast<uint8_t>((ny * 0.5f + 0.5f) * 255.0f + 0.5f);
+            p[2] = static_cast<uint8_t>((nz * 0.5f + 0.5f) * 255.0f + 0.5f);
+            p[3] = 255;
+        }
+    }
+    return image;
+}
+
+inline void benchBlockCompression() {
+    constexpr int kSize = 1024;
+    const double megapixels = double(kSize) * kSize / 1e6;
+    auto albedo = makeBenchAlbedo(kSize);
+    auto normals = makeBenchNormalMap(kSize);
+
+    struct Case {
+        const char* label;
+        const std::vector<uint8_t>* image;
+        TextureFormat format;
+        TextureQuality quality;
+        int channels;
+    };
+    const Case cases[] = {
+        {"BC1 albedo", &albedo, TextureFormat::BC1, TextureQuality::Fast, 3},
+        {"BC3 albedo", &albedo, TextureFormat::BC3, TextureQuality::Fast, 3},
+        {"BC7 albedo", &albedo, TextureFormat::BC7, TextureQuality::High, 3},
+        {"BC5 normal", &normals, TextureFormat::BC5, TextureQuality::High, 2},
+        {"BC1 normal (for comparison)", &normals, TextureFormat::BC1, TextureQuality::Fast, 2},
+    };
+
+    for (const Case& c : cases) {
+        BenchTimer timer;
+        auto blocks = compressTextureLevel(c.image->data(), kSize, kSize, c.format, c.quality);
+        double ms = timer.elapsedMs();
+        auto decoded = decompressTextureLevel(blocks.data(), kSize, kSize, c.format);
+        double psnr = computePSNR(c.image->data(), decoded.data(), size_t(kSize) * kSize, c.channels);
+        std::string label = c.label;
+        reportMetric(label + ", PSNR", psnr, "dB");
+        reportMetric(label + ", throughput", megapixels / (ms / 1000.0), "MPix/s");
+    }
+
+    BenchTimer timer;
+    auto chain = generateMipChain(albedo.data(), kSize, kSize, TextureRole::Albedo);
+    reportMetric("mip chain (gamma correct), 1024^2", timer.elapsedMs(), "ms");
+}
+
+inline void benchCookedCache() {
+    constexpr int kSize = 1024;
+    TextureData source;
+    source.width = kSize;
+    source.height = kSize;
+    source.pixels = makeBenchAlbedo(kSize);
+
+    ScratchDirectory scratch("cooked");
+    CookedTextureCache cache(scratch.path());
+    TextureCookSettings settings;
+    settings.compress = true;
+    uint64_t key = CookedTextureCache::makeKey(
+        TextureCache::hashPixels(source), TextureRole::Albedo, settings);
+
+    TextureData cooked;
+    {
+        BenchTimer timer;
+        cooked = cookTexture(source, TextureRole::Albedo, settings);
+        cache.store(key, cooked);
+        reportMetric("first load: mips + BC7 + store", timer.elapsedMs(), "ms");
+    }
+    {
+        BenchTimer timer;
+        TextureData loaded;
+        cache.load(key, loaded);
+        reportMetric("next load: cooked cache hit", timer.elapsedMs(), "ms");
+    }
+    reportMetric("RGBA8, no mips", source.pixels.size() / (1024.0 * 1024.0), "MB");
+    reportMetric("BC7 + full mip chain", cooked.byteSize() / (1024.0 * 1024.0), "MB");
+}
+
+// Time until a close-up texture arrives when it is requested behind a
+// level's worth of distant ones
+inline void benchStreamingPriority() {
+    constexpr int kFar = 200;
+    constexpr int kSize = 256;
+
+    for (bool prioritized : {false, true}) {
+        AsyncTextureLoader loader(0);
+        loader.getCookedCache().setEnabled(false);
+        TextureCookSettings settings;
+        settings.compress = true;
+        settings.quality = TextureQuality::Fast;
+        loader.setCookSettings(settings);
+
+        std::vector<TextureHandle> sources;
+        for (int i = 0; i <= kFar; i++) {
+            TextureData tex;
+            tex.width = kSize;
+            tex.height = kSize;
+            tex.pixels = makeBenchAlbedo(kSize);
+            tex.pixels[0] = static_cast<uint8_t>(i);
+            tex.pixels[1] = static_cast<uint8_t>(i >> 8);
+            tex.pixels[2] = prioritized ? 1 : 2;
+            sources.push_back(makeTexture(std::move(tex)));
+        }
+        float farPriority = texturePriority(prioritized ? TexturePriority::Background : TexturePriority::Normal);
+        float heroPriority = texturePriority(prioritized ? TexturePriority::Critical : TexturePriority::Normal);
+        for (int i = 0; i < kFar; i++) {
+            loader.cookTexture(sources[i], TextureRole::Albedo, farPriority);
+        }
+        uint32_t hero = loader.cookTexture(sources[kFar], TextureRole::Albedo, heroPriority);
+
+        BenchTimer timer;
+        loader.setWorkerCount(2);
+        bool arrived = false;
+        while (!arrived) {
+            for (const auto& result : loader.getCompletedTextures()) {
+                arrived |= result.id == hero;
+            }
+            if (!arrived) std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        reportMetric(prioritized ? "hero texture, priority queue" : "hero texture, FIFO",
+                     timer.elapsedMs(), "ms");
+        loader.shutdown();
+    }
+}
+
+}  // namespace TextureBench
+
+// ===== Audio Mixing =====
+namespace AudioBench {
+
+// Mixes one second of 48 kHz stereo in 512-frame callbacks and reports how
+// many such voices one core could keep up with in real time
+inline void benchVoiceMixing() {
+    constexpr int kDeviceRate = 48000;
+    constexpr int kVoices = 64;
+    constexpr size_t kCallback = 512;
+
+    struct Case {
+        const char* label;
+        int clipRate;
+        bool spatialize;
+        float pitch;
+    };
+    const Case cases[] = {
+        {"48k -> 48k", 48000, false, 1.0f},
+        {"44.1k -> 48k", 44100, false, 1.0f},
+        {"3D, pitch 1.3, Doppler", 44100, true, 1.3f},
+    };
+
+    AudioSystem& audio = getAudioSystem();
+    audio.initialize(kDeviceRate, 2);
+    std::vector<float> out(kCallback * 2);
+
+    for (const Case& c : cases) {
+        auto clip = audio.createClip("bench_noise");
+        clip->generateWhiteNoise(2.0f, c.clipRate);
+
+        std::vector<AudioSource*> voices;
+        for (int v = 0; v < kVoices; v++) {
+            AudioSource* source = audio.createSource();
+            source->setClip(clip);
+            source->setLoop(true);
+            source->setPitch(c.pitch);
+            source->getSettings().spatialize = c.spatialize;
+            source->setPosition(Vec3((float)(v % 8) - 4.0f, 0.0f, -(float)(v / 8) - 1.0f));
+            source->setVelocity(Vec3(0.0f, 0.0f, c.spatialize ? 20.0f : 0.0f));
+            source->play();
+            voices.push_back(source);
+        }
+        audio.update(0.016f);
+
+        BenchTimer timer;
+        for (size_t done = 0; done < kDeviceRate; done += kCallback) {
+            audio.mixAudio(out.data(), kCallback);
+        }
+        double ms = timer.elapsedMs();
+        std::string label = c.label;
+        reportMetric(label + ", realtime voices/core", kVoices * 1000.0 / ms, "");
+        reportMetric(label + ", per voice", ms * 1000.0 / kVoices / (kDeviceRate / kCallback), "us/callback");
+
+        for (AudioSource* source : voices) audio.destroySource(source);
+    }
+
+    // A crowded scene: 256 spatialized voices, of which the real-voice cap
+    // lets 64 through; the rest only advance their playback position
+    auto clip = audio.createClip("bench_noise");
+    clip->generateWhiteNoise(2.0f, 44100);
+    std::vector<AudioSource*> crowd;
+    for (int v = 0; v < 256; v++) {
+        AudioSource* source = audio.createSource();
+        source->setClip(clip);
+        source->setLoop(true);
+        source->setPosition(Vec3((float)(v % 16) - 8.0f, 0.0f, -(float)(v / 16) - 1.0f));
+        source->play();
+        crowd.push_back(source);
+    }
+    for (int cap : {256, AudioSystem::kDefaultMaxRealVoices}) {
+        audio.setMaxRealVoices(cap);
+        audio.update(0.016f);
+        audio.resetMixStats();
+        for (size_t done = 0; done < kDeviceRate; done += kCallback) {
+            audio.mixAudio(out.data(), kCallback);
+        }
+        AudioMixStats stats = audio.getMixStats();
+        std::string label = "256 voices, " + std::to_string(stats.realVoices) + " real";
+        reportMetric(label + ", mix time", stats.avgMixUs, "us/callback");
+        reportMetric(label + ", deadline used", stats.load() * 100.0, "%");
+    }
+    audio.shutdown();
+}
+
+// Lip sync analysis cost per second of speech-like audio: 30 ms frames at
+// 44.1 kHz, compared with the direct autocorrelation it replaces
+inline void benchLipSyncAnalysis() {
+    constexpr float kRate = 44100.0f;
+    constexpr int kFrame = 1323;
+    constexpr int kSeconds = 60;
+    std::vector<float> speech((size_t)kRate * kSeconds);
+    uint32_t seed = 1;
+    for (size_t i = 0; i < speech.size(); i++) {
+        seed = seed * 1664525u + 1013904223u;
+        float noise = (float)(seed >> 8) / 16777216.0f - 0.5f;
+        float envelope = 0.5f + 0.5f * sinf(i * 0.0007f);
+        speech[i] = envelope * (sinf(i * 0.031f) + 0.3f * sinf(i * 0.27f) + 0.2f * noise);
+    }
+
+    // Reference: the direct O(n * lags) autocorrelation on one second
+    BenchTimer timer;
+    float sink = 0.0f;
+    for (size_t at = 0; at + kFrame <= (size_t)kRate; at += kFrame / 2) {
+        const float* x = speech.data() + at;
+        for (int lag = (int)(kRate / 500); lag <= (int)(kRate / 80); lag++) {
+            float corr = 0.0f;
+            for (int i = 0; i < kFrame - lag; i++) corr += x[i] * x[i + lag];
+            sink += corr;
+        }
+    }
+    double directMs = timer.elapsedMs();
+
+    AudioAnalyzer analyzer;
+    timer = BenchTimer();
+    for (size_t at = 0; at + kFrame <= (size_t)kRate; at += kFrame / 2) {
+        sink += analyzer.analyze(speech.data() + at, kFrame, kRate, 0.0f).pitch;
+    }
+    double fftMs = timer.elapsedMs();
+    reportMetric("Direct autocorrelation pitch only", directMs, "ms/s audio");
+    reportMetric("FFT pitch + spectrum", fftMs, "ms/s audio");
+
+    StreamingAudioAnalyzer live(kRate, 1024, 512);
+    std::vector<AudioFrame> frames;
+    timer = BenchTimer();
+    for (size_t at = 0; at < (size_t)kRate; at += 512) {
+        live.push(speech.data() + at, 512, frames);
+    }
+    reportMetric("Streaming, 1024 window / 512 hop", timer.elapsedMs(), "ms/s audio");
+    reportMetric("Streaming latency", live.getLatency() * 1000.0f, "ms");
+
+    LipSyncGenerator generator;
+    timer = BenchTimer();
+    LipSyncTrack serial = generator.generate(speech.data(), (int)speech.size(), kRate, {}, 1);
+    double serialMs = timer.elapsedMs();
+    timer = BenchTimer();
+    LipSyncTrack parallel = generator.generate(speech.data(), (int)speech.size(), kRate, {}, 0);
+    double parallelMs = timer.elapsedMs();
+    reportMetric("Generate 60 s, 1 thread", serialMs, "ms");
+    reportMetric("Generate 60 s, all cores", parallelMs, "ms");
+    if (sink == 12345.0f || serial.keyframes.size() != parallel.keyframes.size()) {
+        std::cout << "  (track mismatch)" << std::endl;
+    }
+}
+
+}  // namespace AudioBench
+
+// ===== AI Inference =====
+namespace AIBench {
+
+// A face mesh network shaped like MediaPipe's: 192 x 192 RGB in, residual
+// depthwise-separable blocks with PReLU down to 3 x 3, then 468 x 3 landmark
+// coordinates and a face-presence score. Random weights, He-scaled.
+inline nn::Graph buildFaceMeshNetwork() {
+    uint32_t seed = 5;
+    auto random = [&](size_t count, int fanIn) {
+        std::vector<float> values(count);
+        float scale = std::sqrt(6.0f / (float)fanIn);
+        for (float& v : values) {
+            seed = seed * 1664525u + 1013904223u;
+            v = ((float)(seed >> 8) / 16777216.0f - 0.5f) * scale;
+        }
+        return values;
+    };
+    auto slopes = [](int channels) { return std::vector<float>(channels, 0.25f); };
+
+    nn::Graph graph;
+    int x = graph.input({3, 192, 192});
+    int channels = 16;
+    x = graph.conv(x, channels, 3, 2, 1, random(channels * 27, 27), {}, nn::Activation::PReLU, slopes(channels));
+    const int stageChannels[] = {16, 32, 64, 128, 128, 128};
+    for (int stage = 0; stage < 6; stage++) {
+        int out = stageChannels[stage];
+        if (stage > 0) {
+            // Downsample: strided depthwise, then widen
+            x = graph.depthwise(x, 3, 2, 1, random(channels * 9, 9));
+            x = graph.conv(x, out, 1, 1, 0, random(out * channels, channels), {}, nn::Activation::PReLU, slopes(out));
+            channels = out;
+        }
+        for (int block = 0; block < 2; block++) {
+            int y = graph.depthwise(x, 3, 1, 1, random(channels * 9, 9));
+            y = graph.conv(y, channels, 1, 1, 0, random(channels * channels, channels));
+            x = graph.add(x, y, nn::Activation::ReLU);
+        }
+    }
+    int features = (int)graph.getShape(x).size();
+    int landmarks = graph.dense(x, 468 * 3, random((size_t)468 * 3 * features, features));
+    int presence = graph.dense(graph.globalAvgPool(x), 1, random(channels, channels));
+    graph.output(landmarks);
+    graph.output(presence);
+    return graph;
+}
+
+// One 192 x 192 face mesh inference on the built-in CPU runtime
+inline void benchFaceMeshInference() {
+    nn::Graph graph = buildFaceMeshNetwork();
+    std::vector<float> image(graph.getShape(0).size());
+    for (size_t i = 0; i < image.size(); i++) image[i] = std::sin(i * 0.01f);
+    reportMetric("Network", (double)graph.getMacCount() / 1e6, "MMAC");
+
+    struct Case {
+        const char* label;
+        bool simd;
+        bool int8;
+        int threads;
+    };
+    int cores = (int)std::max(1u, std::thread::hardware_concurrency());
+    const Case cases[] = {
+        {"Scalar, 1 thread", false, false, 1},
+        {"AVX2, 1 thread", true, false, 1},
+        {"AVX2, all cores", true, false, cores},
+        {"AVX2 int8, 1 thread", true, true, 1},
+        {"AVX2 int8, all cores", true, true, cores},
+    };
+
+    std::vector<float> reference;
+    for (const Case& c : cases) {
+        nn::RuntimeOptions options;
+        options.simd = c.simd;
+        options.int8 = c.int8;
+        options.threads = c.threads;
+        nn::Runtime runtime;
+        runtime.compile(graph, options);
+        runtime.run(image.data());  // Warm up
+
+        constexpr int kRuns = 10;
+        BenchTimer timer;
+        for (int i = 0; i < kRuns; i++) runtime.run(image.data());
+        double ms = timer.elapsedMs() / kRuns;
+        reportMetric(std::string(c.label), ms, "ms");
+
+        const float* landmarks = runtime.getOutput(0);
+        if (reference.empty()) {
+            reference.assign(landmarks, landmarks + 468 * 3);
+            const nn::RuntimeStats& stats = runtime.getStats();
+            reportMetric("Activation arena", stats.arenaBytes / 1024.0, "KB");
+            reportMetric("  without buffer reuse", stats.unsharedBytes / 1024.0, "KB");
+            reportMetric("Scratch (im2col)", stats.scratchBytes / 1024.0, "KB");
+        } else if (c.int8) {
+            float error = 0.0f, range = 0.0f;
+            for (size_t i = 0; i < reference.size(); i++) {
+                error = std::max(error, std::abs(landmarks[i] - reference[i]));
+                range = std::max(range, std::abs(reference[i]));
+            }
+            reportMetric("  max landmark error vs float", 100.0 * error / std::max(range, 1e-6f), "% of range");
+        }
+    }
+}
+
+}  // namespace AIBench
+
+// ===== Character Deformation =====
+namespace CharacterBench {
+
+// 16 characters of ~15k vertices, 40 targets (4 full-body, 36 local) and a
+// 64-bone palette with 4 influences per vertex
+inline void benchSkinDeformation() {
+    constexpr int kGrid = 122;
+    constexpr int kCharacters = 16;
+    constexpr int kBones = 64;
+    std::vector<Vertex> base;
+    std::vector<uint32_t> indices;
+    for (int y = 0; y < kGrid; y++) {
+        for (int x = 0; x < kGrid; x++) {
+            Vertex v{};
+            float a = x * 6.2831853f / (kGrid - 1);
+            v.position[0] = std::cos(a) * 0.2f; v.position[1] = y * 1.8f / kGrid; v.position[2] = std::sin(a) * 0.2f;
+            v.normal[0] = std::cos(a); v.normal[2] = std::sin(a);
+            v.tangent[1] = 1.0f; v.tangent[3] = 1.0f;
+            v.uv[0] = x / (float)(kGrid - 1); v.uv[1] = y / (float)(kGrid - 1);
+            base.push_back(v);
+        }
+    }
+    for (int y = 0; y + 1 < kGrid; y++) {
+        for (int x = 0; x + 1 < kGrid; x++) {
+            uint32_t i = y * kGrid + x;
+            indices.insert(indices.end(), {i, i + 1, i + kGrid, i + 1, i + kGrid + 1, i + kGrid});
+        }
+    }
+    uint32_t seed = 3;
+    auto random = [&] {
+        seed = seed * 1664525u + 1013904223u;
+        return (float)(seed >> 8) / 16777216.0f - 0.5f;
+    };
+    BlendShapeMesh shapes;
+    for (int t = 0; t < 40; t++) {
+        BlendShapeTarget target("target" + std::to_string(t));
+        uint32_t start = t < 4 ? 0 : (uint32_t)((t * 911) % (base.size() - 800));
+        uint32_t count = t < 4 ? (uint32_t)base.size() : 800;
+        for (uint32_t i = start; i < start + count; i++) {
+            target.addDelta(BlendShapeDelta(i, Vec3(random(), random(), random()) * 0.02f, Vec3(random(), random(), random()) * 0.1f));
+        }
+        shapes.addTarget(target);
+    }
+    shapes.createChannelsFromTargets();
+    std::vector<SkinVertex> skinData(base.size());
+    for (size_t i = 0; i < base.size(); i++) {
+        for (int k = 0; k < 4; k++) {
+            skinData[i].boneIndices[k] = (uint32_t)((i / kGrid * kBones / kGrid + k) % kBones);
+            skinData[i].boneWeights[k] = 0.4f - 0.1f * k;
+        }
+    }
+    std::vector<Mat4> palette(kBones);
+    auto pose = [&](float time) {
+        for (int b = 0; b < kBones; b++) {
+            palette[b] = Mat4::translation(Vec3(0.01f * b, 0, 0)) *
+                         Mat4::fromQuat(Quat::fromAxisAngle(Vec3(0, 1, 0), 0.3f * std::sin(time + b * 0.1f)));
+        }
+    };
+    std::vector<BlendShapeMesh> crowdShapes(kCharacters, shapes);
+    auto setWeights = [&](int frame) {
+        for (int c = 0; c < kCharacters; c++) {
+            for (int t = 0; t < 40; t += 3) crowdShapes[c].setWeight(t, 0.5f + 0.5f * std::sin(frame * 0.3f + c + t));
+        }
+    };
+
+    // Reference: the previous path, per character
+    // (applyToMesh copy + calculateTangents + per-vertex Mat4 skinning)
+    constexpr int kFrames = 5;
+    std::vector<Vertex> blended, skinned(base.size());
+    BenchTimer timer;
+    for (int frame = 0; frame < kFrames; frame++) {
+        setWeights(frame);
+        pose(frame * 0.1f);
+        for (int c = 0; c < kCharacters; c++) {
+            crowdShapes[c].applyToMesh(base, blended);
+            UVMapper::calculateTangents(blended, indices);
+            for (size_t i = 0; i < blended.size(); i++) {
+                Mat4 m;
+                for (int e = 0; e < 16; e++) m.m[e] = 0.0f;
+                for (int k = 0; k < 4; k++) {
+                    const Mat4& bone = palette[skinData[i].boneIndices[k]];
+                    for (int e = 0; e < 16; e++) m.m[e] += bone.m[e] * skinData[i].boneWeights[k];
+                }
+                const float* p = blended[i].position;
+                skinned[i] = blended[i];
+                for (int r = 0; r < 3; r++) {
+                    skinned[i].position[r] = m(r, 0) * p[0] + m(r, 1) * p[1] + m(r, 2) * p[2] + m(r, 3);
+                }
+            }
+        }
+    }
+    reportMetric("Previous path, weights + pose change", timer.elapsedMs() / kFrames, "ms/frame");
+
+    std::vector<SkinDeformer> crowd(kCharacters);
+    std::vector<std::vector<Vertex>> buffers(kCharacters, std::vector<Vertex>(base.size()));
+    std::vector<SkinDeformerBatch::Job> jobs;
+    for (int c = 0; c < kCharacters; c++) {
+        crowd[c].setBaseMesh(base, indices);
+        crowd[c].setBlendShapes(&crowdShapes[c]);
+        crowd[c].setSkinWeights(skinData);
+        jobs.push_back({&crowd[c], buffers[c].data()});
+    }
+    std::vector<int> threadCounts = {1};
+    int cores = (int)std::max(1u, std::thread::hardware_concurrency());
+    if (cores > 1) threadCounts.push_back(cores);
+    for (int threads : threadCounts) {
+        SkinDeformerBatch batch(threads);
+        batch.run(jobs);    // Warm up
+        DeformBatchStats total;
+        timer = BenchTimer();
+        for (int frame = 0; frame < kFrames; frame++) {
+            setWeights(frame);
+            pose(frame * 0.1f);
+            for (auto& d : crowd) d.setBoneMatrices(palette.data(), palette.size());
+            batch.run(jobs);
+            total.blendMs += batch.getStats().blendMs;
+            total.tangentMs += batch.getStats().tangentMs;
+            total.skinMs += batch.getStats().skinMs;
+        }
+        double both = timer.elapsedMs() / kFrames;
+        timer = BenchTimer();
+        for (int frame = 0; frame < kFrames; frame++) {
+            pose(frame * 0.2f);
+            for (auto& d : crowd) d.setBoneMatrices(palette.data(), palette.size());
+            batch.run(jobs);
+        }
+        double poseOnly = timer.elapsedMs() / kFrames;
+        std::string label = threads == 1 ? "Fused SoA, 1 thread" : "Fused SoA, all cores";
+        reportMetric(label + ", weights + pose change", both, "ms/frame");
+        reportMetric(label + ", pose change only", poseOnly, "ms/frame");
+        if (threads == 1) {
+            reportMetric("  blend stage", total.blendMs / kFrames, "ms/frame");
+            reportMetric("  tangent stage", total.tangentMs / kFrames, "ms/frame");
+            reportMetric("  skin stage", total.skinMs / kFrames, "ms/frame");
+        }
+    }
+}
+
+// Startup cost of 300 MakeHuman-sized targets: text parsing vs. the pack
+inline void benchMakeHumanTargetPack() {
+    constexpr int kTargets = 300;
+    ScratchDirectory scratch("mhpack");
+    std::string targetDir = scratch.path() + "/targets";
+    uint32_t seed = 9;
+    size_t lines = 0;
+    for (int t = 0; t < kTargets; t++) {
+        std::string dir = targetDir + "/category" + std::to_string(t % 12);
+        std::filesystem::create_directories(dir);
+        std::ofstream file(dir + "/target" + std::to_string(t) + ".target");
+        file << "# basemesh hm08\n";
+        int count = t % 10 == 0 ? 12000 : 1500;
+        uint32_t vertex = (uint32_t)(t * 37) % 4000;
+        for (int i = 0; i < count; i++, lines++) {
+            seed = seed * 1664525u + 1013904223u;
+            vertex += 1 + (seed >> 29);
+            float dx = ((seed >> 8) & 0xFFFF) / 65536.0f - 0.5f;
+            file << vertex << " " << dx * 0.02f << " " << dx * -0.01f << " " << dx * 0.005f << "\n";
+        }
+    }
+    reportMetric("Delta lines", (double)lines, "");
+
+    BenchTimer timer;
+    auto text = MakeHumanTargetLoader::loadTargetsFromDirectory(targetDir);
+    reportMetric("Text parse, all targets", timer.elapsedMs(), "ms");
+
+    std::string packPath = scratch.path() + "/targets.mhpack";
+    timer = BenchTimer();
+    MakeHumanTargetPack::build(targetDir, packPath);
+    reportMetric("Pack build (offline)", timer.elapsedMs(), "ms");
+    size_t textBytes = 0;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(targetDir)) {
+        if (entry.is_regular_file()) textBytes += entry.file_size();
+    }
+    reportMetric("Text size", textBytes / 1024.0, "KB");
+    reportMetric("Pack size", std::filesystem::file_size(packPath) / 1024.0, "KB");
+
+    MakeHumanTargetPack pack;
+    timer = BenchTimer();
+    pack.open(packPath);
+    reportMetric("Pack open (index only)", timer.elapsedMs(), "ms");
+    timer = BenchTimer();
+    auto packed = pack.decodeCategory("");
+    reportMetric("Pack decode, all targets", timer.elapsedMs(), "ms");
+    timer = BenchTimer();
+    auto one = pack.decodeCategory("category3");
+    reportMetric("Pack decode, one category", timer.elapsedMs(), "ms");
+    if (packed.size() != text.size() || one.empty()) std::cout << "  (target count mismatch)" << std::endl;
+}
+
+// Humanoid body made of tubes around each bone capsule, at 20k/100k/500k
+// vertices, plus a garment shell over the torso for weight transfer
+inline void benchAutoRig() {
+    HumanoidRigParams rigParams;
+    Skeleton skeleton = StandardHumanoidRig::createSkeleton(rigParams);
+    AutoRigParams params;
+    std::vector<BoneCapsule> capsules = AutoRigGenerator::buildBoneCapsules(skeleton, params);
+    float totalLength = 0.0f;
+    for (const auto& c : capsules) totalLength += (c.end - c.start).length();
+
+    constexpr int kSegments = 16;
+    auto isTorso = [](const BoneCapsule& c) {
+        return c.boneName.find("spine") != std::string::npos ||
+               c.boneName.find("chest") != std::string::npos || c.boneName == "hips";
+    };
+    float torsoLength = 0.0f;
+    for (const auto& c : capsules) if (isTorso(c)) torsoLength += (c.end - c.start).length();
+
+    auto makeBody = [&](size_t targetVertices, float inflate, bool torsoOnly) {
+        Mesh mesh;
+        float selectedLength = torsoOnly ? torsoLength : totalLength;
+        for (const auto& c : capsules) {
+            if (torsoOnly && !isTorso(c)) continue;
+            Vec3 axis = c.end - c.start;
+            float length = axis.length();
+            if (length < 1e-4f) continue;
+            axis = axis * (1.0f / length);
+            Vec3 side = std::abs(axis.y) < 0.9f ? axis.cross(Vec3(0, 1, 0)).normalized()
+                                               : axis.cross(Vec3(1, 0, 0)).normalized();
+            Vec3 up = axis.cross(side);
+            int rings = std::max(2, (int)(targetVertices * length / selectedLength / kSegments));
+            uint32_t first = (uint32_t)mesh.vertices.size();
+            for (int r = 0; r < rings; r++) {
+                Vec3 center = c.start + axis * (length * r / (rings - 1));
+                for (int k = 0; k < kSegments; k++) {
+                    float a = 6.2831853f * k / kSegments;
+                    Vec3 n = side * std::cos(a) + up * std::sin(a);
+                    Vec3 p = center + n * (c.radius * 0.9f + inflate);
+                    Vertex v{};
+                    v.position[0] = p.x; v.position[1] = p.y; v.position[2] = p.z;
+                    v.normal[0] = n.x; v.normal[1] = n.y; v.normal[2] = n.z;
+                    mesh.vertices.push_back(v);
+                }
+            }
+            for (int r = 0; r + 1 < rings; r++) {
+                for (int k = 0; k < kSegments; k++) {
+                    uint32_t a = first + r * kSegments + k, b = first + r * kSegments + (k + 1) % kSegments;
+                    mesh.indices.insert(mesh.indices.end(), {a, a + kSegments, b, b, a + kSegments, b + kSegments});
+                }
+            }
+        }
+        return mesh;
+    };
+
+    // Reference: the previous generator (scan every capsule per vertex,
+    // vector-of-vectors adjacency, hash map per smoothed vertex), with ties
+    // sorted by bone index like the new path so results are comparable
+    auto byWeight = [](const std::pair<int, float>& a, const std::pair<int, float>& b) {
+        return a.second > b.second || (a.second == b.second && a.first < b.first);
+    };
+    auto previousWeights = [&](const Mesh& mesh) {
+        std::vector<VertexSkinning> weights(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); i++) {
+            Vec3 p(mesh.vertices[i].position[0], mesh.vertices[i].position[1], mesh.vertices[i].position[2]);
+            std::vector<std::pair<int, float>> boneWeights;
+            for (const auto& c : capsules) {
+                float w = c.calculateWeight(p, params.falloffPower);
+                if (w > params.minWeight) boneWeights.push_back({c.boneIndex, w});
+            }
+            std::sort(boneWeights.begin(), boneWeights.end(), byWeight);
+            int count = std::min((int)boneWeights.size(), params.maxBonesPerVertex);
+            for (int j = 0; j < count; j++) weights[i].addWeight(boneWeights[j].first, boneWeights[j].second);
+            weights[i].normalize();
+            if (weights[i].influenceCount == 0) {
+                float minDist = FLT_MAX;
+                int nearest = 0;
+                for (const auto& c : capsules) {
+                    float d = c.distanceToPoint(p);
+                    if (d < minDist) { minDist = d; nearest = c.boneIndex; }
+                }
+                weights[i].addWeight(nearest, 1.0f);
+            }
+        }
+        std::vector<std::vector<size_t>> adjacency(mesh.vertices.size());
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+            uint32_t a = mesh.indices[i], b = mesh.indices[i + 1], c = mesh.indices[i + 2];
+            adjacency[a].push_back(b); adjacency[a].push_back(c);
+            adjacency[b].push_back(a); adjacency[b].push_back(c);
+            adjacency[c].push_back(a); adjacency[c].push_back(b);
+        }
+        for (auto& adj : adjacency) {
+            std::sort(adj.begin(), adj.end());
+            adj.erase(std::unique(adj.begin(), adj.end()), adj.end());
+        }
+        for (int iter = 0; iter < params.smoothIterations; iter++) {
+            std::vector<VertexSkinning> smoothed = weights;
+            for (size_t i = 0; i < weights.size(); i++) {
+                if (adjacency[i].empty()) continue;
+                std::unordered_map<int, float> accumulated;
+                for (int j = 0; j < weights[i].influenceCount; j++) {
+                    accumulated[weights[i].weights[j].boneIndex] += weights[i].weights[j].weight * (1.0f - params.smoothStrength);
+                }
+                float neighborFactor = params.smoothStrength / adjacency[i].size();
+                for (size_t ni : adjacency[i]) {
+                    for (int j = 0; j < weights[ni].influenceCount; j++) {
+                        accumulated[weights[ni].weights[j].boneIndex] += weights[ni].weights[j].weight * neighborFactor;
+                    }
+                }
+                smoothed[i].clear();
+                std::vector<std::pair<int, float>> sorted(accumulated.begin(), accumulated.end());
+                std::sort(sorted.begin(), sorted.end(), byWeight);
+                for (int j = 0; j < std::min(params.maxBonesPerVertex, (int)sorted.size()); j++) {
+                    smoothed[i].addWeight(sorted[j].first, sorted[j].second);
+                }
+                smoothed[i].normalize();
+            }
+            weights = std::move(smoothed);
+        }
+        return weights;
+    };
+
+    reportMetric("Bone capsules", (double)capsules.size(), "");
+    reportMetric("Worker threads", (double)std::max(1u, std::thread::hardware_concurrency()), "");
+    for (size_t target : {20000u, 100000u, 500000u}) {
+        Mesh body = makeBody(target, 0.0f, false);
+        Mesh garment = makeBody(target / 4, 0.01f, true);
+        std::string label = std::to_string(body.vertices.size() / 1000) + "k";
+
+        BenchTimer timer;
+        std::vector<VertexSkinning> previous = previousWeights(body);
+        reportMetric(label + ": previous weights + smoothing", timer.elapsedMs(), "ms");
+
+        AutoRigParams noSmoothing = params;
+        noSmoothing.smoothIterations = 0;
+        timer = BenchTimer();
+        MeshSkinData unsmoothed = AutoRigGenerator::generateWeights(body, skeleton, noSmoothing);
+        double weightsMs = timer.elapsedMs();
+        timer = BenchTimer();
+        MeshSkinData skin = AutoRigGenerator::generateWeights(body, skeleton, params);
+        double totalMs = timer.elapsedMs();
+        reportMetric(label + ": BVH + CSR weights + smoothing", totalMs, "ms");
+        reportMetric("  capsule BVH weights", weightsMs, "ms");
+        reportMetric("  CSR smoothing (3 iterations)", totalMs - weightsMs, "ms");
+
+        float maxDiff = 0.0f;
+        for (size_t i = 0; i < previous.size(); i++) {
+            for (int j = 0; j < previous[i].influenceCount; j++) {
+                float match = 0.0f;
+                const VertexSkinning& vs = skin.vertexWeights[i];
+                for (int k = 0; k < vs.influenceCount; k++) {
+                    if (vs.weights[k].boneIndex == previous[i].weights[j].boneIndex) match = vs.weights[k].weight;
+                }
+                maxDiff = std::max(maxDiff, std::abs(match - previous[i].weights[j].weight));
+            }
+        }
+        reportMetric("  max weight difference", maxDiff, "");
+
+        // Garment transfer: previous nearest-vertex scan is O(garment * body)
+        std::string garmentLabel = "  garment (" + std::to_string(garment.vertices.size() / 1000) + "k)";
+        if ((double)garment.vertices.size() * body.vertices.size() <= 5e8) {
+            timer = BenchTimer();
+            std::vector<VertexSkinning> nearest(garment.vertices.size());
+            for (size_t i = 0; i < garment.vertices.size(); i++) {
+                const float* g = garment.vertices[i].position;
+                float best = FLT_MAX;
+                size_t bestIdx = 0;
+                for (size_t j = 0; j < body.vertices.size(); j++) {
+                    const float* b = body.vertices[j].position;
+                    float d = (Vec3(g[0], g[1], g[2]) - Vec3(b[0], b[1], b[2])).length();
+                    if (d < best) { best = d; bestIdx = j; }
+                }
+                nearest[i] = skin.vertexWeights[bestIdx];
+            }
+            reportMetric(garmentLabel + " nearest-vertex scan", timer.elapsedMs(), "ms");
+        }
+        timer = BenchTimer();
+        MeshSkinData transferred = AutoRigGenerator::transferWeights(garment, body, skin);
+        reportMetric(garmentLabel + " closest-point BVH", timer.elapsedMs(), "ms");
+        if (!AutoRigGenerator::validateWeights(transferred)) std::cout << "  (invalid transferred weights)" << std::endl;
+    }
+}
+
+}  // namespace CharacterBench
+
+// ===== Render Benchmarks =====
+namespace RenderBench {
+
+// Lat-long sphere with a checker texture; rings * segments * 2 triangles
+inline Mesh makeCheckerSphere(int rings, int segments) {
+    Mesh mesh;
+    for (int r = 0; r <= rings; r++) {
+        for (int s = 0; s <= segments; s++) {
+            float theta = 3.14159265f * r / rings, phi = 6.2831853f * s / segments;
+            Vertex v{};
+            v.normal[0] = std::sin(theta) * std::cos(phi);
+            v.normal[1] = std::cos(theta);
+            v.normal[2] = -std::sin(theta) * std::sin(phi);
+            for (int k = 0; k < 3; k++) {
+                v.position[k] = v.normal[k] * 0.5f;
+                v.color[k] = 1.0f;
+            }
+            v.uv[0] = (float)s / segments;
+            v.uv[1] = (float)r / rings;
+            mesh.vertices.push_back(v);
+        }
+    }
+    for (int r = 0; r < rings; r++) {
+        for (int s = 0; s < segments; s++) {
+            uint32_t a = r * (segments + 1) + s, b = a + segments + 1;
+            mesh.indices.insert(mesh.indices.end(), {a, b, a + 1, a + 1, b, b + 1});
+        }
+    }
+    TextureData checker;
+    checker.width = checker.height = 64;
+    checker.pixels.resize(64 * 64 * 4);
+    for (int i = 0; i < 64 * 64; i++) {
+        bool dark = (((i % 64) / 8) + ((i / 64) / 8)) & 1;
+        checker.pixels[i * 4 + 0] = dark ? 40 : 200;
+        checker.pixels[i * 4 + 1] = dark ? 40 : 120;
+        checker.pixels[i * 4 + 2] = 60;
+        checker.pixels[i * 4 + 3] = 255;
+    }
+    mesh.diffuseTexture = makeTexture(std::move(checker));
+    return mesh;
+}
+
+// Asset-browser thumbnails of a mixed library (primitives up to 800k
+// triangles) on the software backend, plus a 720p CI frame
+inline void benchSoftwareThumbnails() {
+    std::vector<Mesh> library;
+    library.push_back(create_cube());
+    library.push_back(create_cylinder(0.4f, 1.0f, 64));
+    library.push_back(makeCheckerSphere(32, 64));     // 4k triangles
+    library.push_back(makeCheckerSphere(100, 200));   // 40k
+    library.push_back(makeCheckerSphere(250, 500));   // 250k
+    library.push_back(makeCheckerSphere(450, 900));   // 810k
+    size_t triangles = 0;
+    for (const auto& mesh : library) triangles += mesh.indices.size() / 3;
+    reportMetric("Library meshes", (double)library.size(), "");
+    reportMetric("Library triangles", (double)triangles, "");
+
+    auto renderLibrary = [&](rhi::SoftwareBackend& backend, int rounds, rhi::SoftwareFrameStats* heaviest) {
+        std::vector<rhi::SoftwareMesh> meshes;
+        for (const auto& mesh : library) meshes.push_back(backend.create_mesh(mesh));
+        BenchTimer timer;
+        for (int round = 0; round < rounds; round++) {
+            for (const auto& mesh : meshes) {
+                const auto& data = *mesh.data;
+                backend.begin_scene(0.0f);
+                backend.frame_bounds((data.boundsMin + data.boundsMax) * 0.5f,
+                                     (data.boundsMax - data.boundsMin).length() * 0.5f);
+                backend.draw_mesh(mesh, Mat4::identity());
+                backend.end_scene();
+                if (heaviest && &mesh == &meshes.back()) *heaviest = backend.stats();
+            }
+        }
+        return rounds * meshes.size() * 1000.0 / timer.elapsedMs();
+    };
+
+    for (uint32_t size : {128u, 256u}) {
+        rhi::NativeWindow window;
+        window.width = window.height = size;
+        rhi::SoftwareBackend single(window, 1);
+        rhi::SoftwareBackend pooled(window);
+        rhi::SoftwareFrameStats stats;
+        double singleRate = renderLibrary(single, 3, nullptr);
+        double pooledRate = renderLibrary(pooled, 3, &stats);
+        std::string label = std::to_string(size) + "px";
+        reportMetric(label + " thumbnails, 1 thread", singleRate, "thumbs/s");
+        reportMetric(label + " thumbnails, all threads (" + std::to_string(pooled.thread_count()) + ")", pooledRate, "thumbs/s");
+        reportMetric(label + " 810k: vertex", stats.vertexMs, "ms");
+        reportMetric(label + " 810k: setup + bin", stats.binMs, "ms");
+        reportMetric(label + " 810k: raster + shade", stats.rasterShadeMs, "ms");
+    }
+
+    rhi::NativeWindow window;
+    window.width = 1280;
+    window.height = 720;
+    rhi::SoftwareBackend backend(window);
+    std::vector<rhi::SoftwareMesh> meshes;
+    for (const auto& mesh : library) meshes.push_back(backend.create_mesh(mesh));
+    const int frames = 5;
+    BenchTimer timer;
+    for (int frame = 0; frame < frames; frame++) {
+        backend.begin_scene(0.1f * frame);
+        backend.frame_bounds(Vec3(0, 0, 0), 2.2f);
+        for (size_t i = 0; i < meshes.size(); i++) {
+            float angle = 6.2831853f * i / meshes.size();
+            backend.draw_mesh(meshes[i], Mat4::translation(Vec3(std::cos(angle) * 1.4f, 0, std::sin(angle) * 1.4f)));
+        }
+        backend.end_scene();
+    }
+    reportMetric("720p frame, whole library", timer.elapsedMs() / frames, "ms");
+    reportMetric("720p pixels shaded", (double)backend.stats().pixelsShaded, "");
+}
+
+// 100k-object city: 2.5k solid buildings (occluders) and props over
+// 2 km x 2 km, camera at street level turning in place
+inline void benchSceneCulling100k() {
+    const int objectCount = 100000;
+    const int buildingGrid = 50;
+    std::vector<Vec3> lows, highs;
+    for (int gx = 0; gx < buildingGrid; gx++) {
+        for (int gz = 0; gz < buildingGrid; gz++) {
+            float x = -1000.0f + gx * 40.0f + 8.0f, z = -1000.0f + gz * 40.0f + 8.0f;
+            float h = 15.0f + (float)((gx * 7 + gz * 13) % 6) * 10.0f;
+            lows.push_back(Vec3(x, 0, z));
+            highs.push_back(Vec3(x + 24.0f, h, z + 24.0f));
+        }
+    }
+    const size_t buildings = lows.size();
+    uint32_t seed = 99;
+    auto random = [&]() { seed = seed * 1664525u + 1013904223u; return (float)(seed >> 8) / 16777216.0f; };
+    while (lows.size() < (size_t)objectCount) {
+        Vec3 lo(random() * 2000.0f - 1000.0f, random() * 4.0f, random() * 2000.0f - 1000.0f);
+        lows.push_back(lo);
+        highs.push_back(lo + Vec3(0.5f + random() * 2.0f, 0.5f + random() * 2.0f, 0.5f + random() * 2.0f));
+    }
+
+    Mat4 proj;
+    const float f = 1.0f / std::tan(0.5f), nearZ = 0.5f, farZ = 1500.0f;
+    proj.m[0] = f / (16.0f / 9.0f);
+    proj.m[5] = f;
+    proj.m[10] = (farZ + nearZ) / (nearZ - farZ);
+    proj.m[11] = -1.0f;
+    proj.m[14] = 2.0f * farZ * nearZ / (nearZ - farZ);
+    proj.m[15] = 0.0f;
+    const int frames = 36;
+    auto viewProj = [&](int frame) {
+        Quat yaw = Quat::fromAxisAngle(Vec3(0, 1, 0), -6.2831853f * frame / frames);
+        return proj * Mat4::fromQuat(yaw) * Mat4::translation(Vec3(-4.0f, -1.7f, -4.0f));
+    };
+    reportMetric("Objects", (double)objectCount, "");
+
+    // Baseline: per-object FrustumCuller
+    FrustumCuller frustumCuller;
+    std::vector<size_t> visibleIndices;
+    size_t baselineVisible = 0;
+    std::function<BoundingSphere(const size_t&)> getBounds = [&](const size_t& i) {
+        return BoundingSphere::fromMinMax(lows[i], highs[i]);
+    };
+    std::vector<size_t> ids(lows.size());
+    for (size_t i = 0; i < ids.size(); i++) ids[i] = i;
+    BenchTimer timer;
+    for (int frame = 0; frame < frames; frame++) {
+        frustumCuller.updateFrustum(viewProj(frame));
+        baselineVisible += frustumCuller.cull(ids, getBounds, visibleIndices).visibleObjects;
+    }
+    reportMetric("FrustumCuller::cull", timer.elapsedMs() / frames, "ms/frame");
+
+    std::vector<SceneCuller::Handle> visible;
+    for (int threads : {1, 0}) {
+        SceneCuller culler(threads);
+        BenchTimer build;
+        for (size_t i = 0; i < lows.size(); i++) culler.add(lows[i], highs[i]);
+        culler.cull(viewProj(0), visible);
+        std::string suffix = threads == 1 ? ", 1 thread" : ", all threads (" + std::to_string(culler.threadCount()) + ")";
+        if (threads == 1) reportMetric("Add 100k + BVH build", build.elapsedMs(), "ms");
+
+        size_t sceneVisible = 0;
+        BenchTimer frustumOnly;
+        for (int frame = 0; frame < frames; frame++) sceneVisible += culler.cull(viewProj(frame), visible).visibleObjects;
+        reportMetric("SceneCuller frustum" + suffix, frustumOnly.elapsedMs() / frames, "ms/frame");
+        if (threads == 1) {
+            reportMetric("Visible (frustum)", (double)sceneVisible / frames, "avg");
+            reportMetric("Baseline visible (sphere only)", (double)baselineVisible / frames, "avg");
+            reportMetric("Objects reaching leaf tests", (double)culler.stats().objectsTested, "");
+        }
+
+        for (size_t i = 0; i < buildings; i++) culler.setOccluder((SceneCuller::Handle)i, true);
+        culler.setOcclusionEnabled(true);
+        culler.setOcclusionResolution(320, 180);
+        size_t occluded = 0;
+        double occluderMs = 0.0, occlusionMs = 0.0;
+        BenchTimer withOcclusion;
+        for (int frame = 0; frame < frames; frame++) {
+            culler.cull(viewProj(frame), visible);
+            occluded += culler.stats().occlusionCulled;
+            occluderMs += culler.stats().occluderMs;
+            occlusionMs += culler.stats().occlusionMs;
+        }
+        reportMetric("+ occlusion" + suffix, withOcclusion.elapsedMs() / frames, "ms/frame");
+        if (threads == 1) {
+            reportMetric("  occluder raster", occluderMs / frames, "ms/frame");
+            reportMetric("  occludee tests", occlusionMs / frames, "ms/frame");
+            reportMetric("  occlusion culled", (double)occluded / frames, "avg");
+            reportMetric("  visible after occlusion", (double)visible.size(), "last frame");
+        }
+
+        // 5% of the props move each frame (occlusion still on): refit, no rebuild
+        BenchTimer moving;
+        double bvhMs = 0.0;
+        for (int frame = 0; frame < frames; frame++) {
+            for (size_t i = buildings + frame; i < lows.size(); i += 20) {
+                Vec3 offset(0.05f, 0.0f, 0.0f);
+                culler.update((SceneCuller::Handle)i, lows[i] + offset * (float)frame, highs[i] + offset * (float)frame);
+            }
+            culler.cull(viewProj(frame), visible);
+            bvhMs += culler.stats().bvhMs;
+        }
+        reportMetric("5% moving" + suffix, moving.elapsedMs() / frames, "ms/frame");
+        if (threads == 1) reportMetric("  BVH refit", bvhMs / frames, "ms/frame");
+    }
+}
+
+}  // namespace RenderBench
+
+// ===== Network Benchmarks =====
+namespace NetworkBench {
+
+// Client streams 64-byte reliable-ordered messages to a server over
+// loopback; latency is send -> handler on one clock. Throughput is measured
+// saturated, latency at a paced 60 Hz x 32 messages so it excludes queueing.
+inline void benchUdpSoak() {
+    using Clock = std::chrono::steady_clock;
+    auto seconds = [](Clock::time_point t) { return std::chrono::duration<double>(t.time_since_epoch()).count(); };
+    
+    struct SoakResult {
+        bool ok = false;
+        bool inOrder = true;
+        double messagesPerSecond = 0.0;
+        std::vector<double> latencies;
+        ReliableConnectionStats stats;
+    };
+    // perTick 0 saturates (bounded by 1024 messages in flight)
+    auto soak = [&](const NetworkConditions& conditions, uint32_t perTick, double duration) {
+        SoakResult result;
+        NetworkServer server;
+        NetworkClient client;
+        if (!server.start("127.0.0.1", 0) || !client.start("127.0.0.1", server.getLocalPort())) {
+            std::cout << "    (UDP unavailable: " << server.getLastError() << client.getLastError() << ")\n";
+            return result;
+        }
+        server.setNetworkConditions(conditions, 3);
+        client.setNetworkConditions(conditions, 5);
+        
+        uint32_t expected = 0;
+        result.latencies.reserve(1 << 20);
+        server.setMessageHandler(NetworkMessageType::Custom, [&](ConnectionId, NetworkMessage& msg) {
+            uint32_t index = msg.readUInt32();
+            uint64_t bits = msg.readUInt32();
+            bits |= (uint64_t)msg.readUInt32() << 32;
+            double sentAt;
+            std::memcpy(&sentAt, &bits, sizeof(sentAt));
+            result.latencies.push_back(seconds(Clock::now()) - sentAt);
+            result.inOrder &= index == expected++;
+        });
+        
+        constexpr double kTick = 1.0 / 60.0;
+        uint32_t sent = 0;
+        auto start = Clock::now();
+        auto last = start;
+        double nextTick = 0.0;
+        double elapsed = 0.0;
+        while (elapsed < duration) {
+            auto now = Clock::now();
+            elapsed = std::chrono::duration<double>(now - start).count();
+            double dt = std::chrono::duration<double>(now - last).count();
+            last = now;
+            
+            uint32_t burst = 0;
+            if (client.isConnected()) {
+                if (perTick == 0) {
+                    burst = std::min<uint32_t>(64, 1024 - std::min<uint32_t>(1024, sent - expected));
+                } else if (elapsed >= nextTick) {
+                    burst = perTick;
+                    nextTick += kTick;
+                }
+            }
+            for (uint32_t i = 0; i < burst; i++) {
+                NetworkMessage msg(NetworkMessageType::Custom);
+                double t = seconds(Clock::now());
+                uint64_t bits;
+                std::memcpy(&bits, &t, sizeof(bits));
+                msg.writeUInt32(sent++);
+                msg.writeUInt32((uint32_t)bits);
+                msg.writeUInt32((uint32_t)(bits >> 32));
+                for (int pad = 0; pad < 48; pad++) msg.writeByte(0);
+                client.send(SERVER_CONNECTION, msg);
+            }
+            client.update(dt);
+            server.update(dt);
+            if (perTick != 0) server.waitForPackets(0.0005);
+        }
+        result.ok = true;
+        result.messagesPerSecond = result.latencies.size() / elapsed;
+        if (const ReliableConnectionStats* stats = client.getTransportStats(SERVER_CONNECTION)) result.stats = *stats;
+        std::sort(result.latencies.begin(), result.latencies.end());
+        return result;
+    };
+    auto percentile = [](const std::vector<double>& sorted, double p) {
+        return sorted.empty() ? 0.0 : sorted[std::min(sorted.size() - 1, (size_t)(p * sorted.size()))] * 1000.0;
+    };
+    
+    NetworkConditions lossy;
+    lossy.lossPercent = 5.0f;
+    lossy.latencyMs = 10.0f;
+    lossy.jitterMs = 5.0f;
+    const std::pair<const char*, NetworkConditions> cases[] = {{"clean", NetworkConditions{}}, {"5% loss, 10+-5 ms", lossy}};
+    
+    for (const auto& [name, conditions] : cases) {
+        SoakResult saturated = soak(conditions, 0, 1.0);
+        if (!saturated.ok) return;
+        SoakResult paced = soak(conditions, 32, 1.0);
+        std::string label = name;
+        reportMetric(label + ": saturated", saturated.messagesPerSecond, "msg/s");
+        reportMetric("  packets lost", (double)saturated.stats.packetsLost, "total");
+        reportMetric("  fragments resent", (double)saturated.stats.fragmentsResent, "total");
+        reportMetric("  paced 60 Hz x 32 latency p50", percentile(paced.latencies, 0.50), "ms");
+        reportMetric("  paced 60 Hz x 32 latency p99", percentile(paced.latencies, 0.99), "ms");
+        reportMetric("  smoothed rtt", paced.stats.rtt * 1000.0, "ms");
+        if (!saturated.inOrder || !paced.inOrder) std::cout << "    ERROR: messages delivered out of order\n";
+    }
+}
+
+// Entity snapshot encoding: the previous byte-at-a-time format (u32 id,
+// full floats, a fresh vector per message) against the bit-packed one
+// (varint id, 18-bit positions over +-512 m, smallest-three rotation,
+// 12-bit velocities, 7-bit health) through pooled buffers
+inline void benchMessageEncoding() {
+    struct EntityState {
+        uint32_t id;
+        Vec3 position;
+        Quat rotation;
+        Vec3 velocity;
+        uint8_t health;
+    };
+    constexpr int kEntities = 1000;
+    constexpr int kRounds = 200;
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<float> pos(-500.0f, 500.0f), unit(-1.0f, 1.0f);
+    std::vector<EntityState> entities(kEntities);
+    for (int i = 0; i < kEntities; i++) {
+        EntityState& e = entities[i];
+        e.id = 1000 + i;
+        e.position = Vec3(pos(rng), pos(rng) * 0.1f, pos(rng));
+        Quat q = Quat::fromAxisAngle(Vec3(unit(rng), 1.0f, unit(rng)).normalized(), unit(rng) * 3.14159f);
+        e.rotation = q;
+        e.velocity = Vec3(unit(rng) * 10.0f, unit(rng) * 10.0f, unit(rng) * 10.0f);
+        e.health = (uint8_t)(rng() % 101);
+    }
+    
+    // Previous NetworkMessage write/read path
+    struct LegacyMessage {
+        std::vector<uint8_t> data;
+        size_t readPos = 0;
+        void writeUInt32(uint32_t v) { for (int i = 0; i < 4; i++) data.push_back((v >> (i * 8)) & 0xFF); }
+        void writeFloat(float f) { uint32_t b; std::memcpy(&b, &f, 4); writeUInt32(b); }
+        uint8_t readByte() { return readPos < data.size() ? data[readPos++] : 0; }
+        uint32_t readUInt32() { uint32_t v = 0; for (int i = 0; i < 4; i++) v |= (uint32_t)readByte() << (i * 8); return v; }
+        float readFloat() { uint32_t b = readUInt32(); float f; std::memcpy(&f, &b, 4); return f; }
+    };
+    
+    const Vec3 worldMin(-512, -512, -512), worldMax(512, 512, 512);
+    const Vec3 velMin(-20, -20, -20), velMax(20, 20, 20);
+    volatile float sink = 0.0f;
+    
+    size_t legacyBytes = 0;
+    BenchTimer legacyEncode;
+    for (int round = 0; round < kRounds; round++) {
+        LegacyMessage msg;
+        for (const EntityState& e : entities) {
+            msg.writeUInt32(e.id);
+            msg.writeFloat(e.position.x); msg.writeFloat(e.position.y); msg.writeFloat(e.position.z);
+            msg.writeFloat(e.rotation.x); msg.writeFloat(e.rotation.y);
+            msg.writeFloat(e.rotation.z); msg.writeFloat(e.rotation.w);
+            msg.writeFloat(e.velocity.x); msg.writeFloat(e.velocity.y); msg.writeFloat(e.velocity.z);
+            msg.data.push_back(e.health);
+        }
+        legacyBytes = msg.data.size();
+        sink = sink + msg.data[round % msg.data.size()];
+    }
+    double legacyEncodeMs = legacyEncode.elapsedMs();
+    
+    LegacyMessage legacy;
+    for (const EntityState& e : entities) {
+        legacy.writeUInt32(e.id);
+        for (int k = 0; k < 10; k++) legacy.writeFloat(1.0f);
+        legacy.data.push_back(e.health);
+    }
+    BenchTimer legacyDecode;
+    for (int round = 0; round < kRounds; round++) {
+        legacy.readPos = 0;
+        float sum = 0.0f;
+        for (int i = 0; i < kEntities; i++) {
+            sum += (float)legacy.readUInt32();
+            for (int k = 0; k < 10; k++) sum += legacy.readFloat();
+            sum += legacy.readByte();
+        }
+        sink = sink + sum;
+    }
+    double legacyDecodeMs = legacyDecode.elapsedMs();
+    
+    auto encode = [&](NetworkMessage& msg) {
+        uint32_t previousId = 0;
+        for (const EntityState& e : entities) {
+            msg.writeVarUInt(e.id - previousId);  // ids delta coded
+            previousId = e.id;
+            msg.writeQuantizedVec3(e.position, worldMin, worldMax, 18);
+            msg.writeQuat(e.rotation);
+            msg.writeQuantizedVec3(e.velocity, velMin, velMax, 12);
+            msg.writeBits(e.health, 7);
+        }
+    };
+    size_t packedBytes = 0;
+    BenchTimer packedEncode;
+    for (int round = 0; round < kRounds; round++) {
+        NetworkMessage msg(NetworkMessageType::StateUpdate);
+        encode(msg);
+        packedBytes = msg.getSize();
+        sink = sink + msg.getData()[round % msg.getSize()];
+    }
+    double packedEncodeMs = packedEncode.elapsedMs();
+    
+    NetworkMessage packed(NetworkMessageType::StateUpdate);
+    encode(packed);
+    float maxPositionError = 0.0f, maxRotationError = 0.0f;
+    BenchTimer packedDecode;
+    for (int round = 0; round < kRounds; round++) {
+        packed.resetRead();
+        float sum = 0.0f;
+        uint32_t id = 0;
+        for (int i = 0; i < kEntities; i++) {
+            id += (uint32_t)packed.readVarUInt();
+            Vec3 p = packed.readQuantizedVec3(worldMin, worldMax, 18);
+            Quat q = packed.readQuat();
+            Vec3 v = packed.readQuantizedVec3(velMin, velMax, 12);
+            uint32_t health = packed.readBits(7);
+            sum += (float)id + p.x + q.w + v.y + (float)health;
+            if (round == 0) {
+                const EntityState& e = entities[i];
+                maxPositionError = std::max(maxPositionError, (p - e.position).length());
+                float dot = std::abs(q.x * e.rotation.x + q.y * e.rotation.y + q.z * e.rotation.z + q.w * e.rotation.w);
+                maxRotationError = std::max(maxRotationError, 2.0f * std::acos(std::min(1.0f, dot)) * 57.29578f);
+            }
+        }
+        sink = sink + sum;
+    }
+    double packedDecodeMs = packedDecode.elapsedMs();
+    
+    const double perEntity = 1e6 / ((double)kRounds * kEntities);
+    reportMetric("byte-wise: bytes/entity", (double)legacyBytes / kEntities, "B");
+    reportMetric("  encode", legacyEncodeMs * perEntity, "ns/entity");
+    reportMetric("  decode", legacyDecodeMs * perEntity, "ns/entity");
+    reportMetric("bit-packed: bytes/entity", (double)packedBytes / kEntities, "B");
+    reportMetric("  encode", packedEncodeMs * perEntity, "ns/entity");
+    reportMetric("  decode", packedDecodeMs * perEntity, "ns/entity");
+    reportMetric("  max position error", maxPositionError * 1000.0f, "mm");
+    reportMetric("  max rotation error", maxRotationError, "deg");
+    
+    // RPC names: inline string vs string table index
+    NetworkStringTable table;
+    table.add("PlayerFireWeapon");
+    NetworkMessage inlineName, indexedName;
+    inlineName.writeString("PlayerFireWeapon");
+    indexedName.writeString("PlayerFireWeapon", table);
+    reportMetric("RPC name inline", (double)inlineName.getBitSize(), "bits");
+    reportMetric("RPC name via string table", (double)indexedName.getBitSize(), "bits");
+    (void)sink;
+}
+
+// 1000 entities (half moving in circles, half static) replicated over
+// loopback to 16 clients at 30 Hz, each interested in a 60 m radius.
+// "full state" is the same quantized fields written without deltas for
+// every relevant entity every tick.
+inline void benchReplication() {
+    constexpr int kEntities = 1000;
+    constexpr int kClients = 16;
+    constexpr int kTicks = 150;
+    constexpr double kDt = 1.0 / 30.0;
+    constexpr float kRadius = 60.0f;
+    
+    NetworkServer server;
+    if (!server.start("127.0.0.1", 0)) return;
+    std::vector<std::unique_ptr<NetworkClient>> clients;
+    for (int c = 0; c < kClients; c++) {
+        clients.push_back(std::make_unique<NetworkClient>());
+        if (!clients.back()->start("127.0.0.1", server.getLocalPort())) return;
+    }
+    auto pump = [&]() {
+        server.update(kDt);
+        for (auto& client : clients) client->update(kDt);
+        server.waitForPackets(0.0005);
+    };
+    for (int i = 0; i < 500 && server.getClientCount() < (size_t)kClients; i++) pump();
+    if (server.getClientCount() < (size_t)kClients) return;
+    
+    ReplicationServer replication(server);
+    std::vector<std::unique_ptr<ReplicationClient>> replicas;
+    for (auto& client : clients) replicas.push_back(std::make_unique<ReplicationClient>(*client));
+    
+    std::mt19937 rng(21);
+    std::uniform_real_distribution<float> area(-200.0f, 200.0f), phase(0.0f, 6.2831853f);
+    struct Mover { Vec3 center; float radius; float speed; float phase; bool moving; };
+    std::vector<Mover> movers(kEntities);
+    auto stateAt = [&](const Mover& m, double time) {
+        ReplicatedState s;
+        float a = m.moving ? m.phase + (float)(time * m.speed) : m.phase;
+        s.position = m.center + Vec3(std::cos(a), 0.0f, std::sin(a)) * m.radius;
+        s.rotation = Quat::fromAxisAngle(Vec3(0, 1, 0), a);
+        if (m.moving) s.velocity = Vec3(-std::sin(a), 0.0f, std::cos(a)) * (m.radius * m.speed);
+        return s;
+    };
+    for (int i = 0; i < kEntities; i++) {
+        movers[i] = {Vec3(area(rng), 0.0f, area(rng)), 3.0f, 0.8f, phase(rng), (i & 1) == 0};
+        replication.addEntity(1 + i, 1, stateAt(movers[i], 0.0));
+    }
+    std::vector<ConnectionId> ids;
+    for (const auto& [id, conn] : server.getConnections()) ids.push_back(id);
+    std::vector<Vec3> centers;
+    for (ConnectionId id : ids) {
+        centers.push_back(Vec3(area(rng), 0.0f, area(rng)));
+        replication.setInterest(id, centers.back(), kRadius);
+    }
+    
+    double tickMs = 0.0;
+    size_t bytes = 0, fullBytes = 0, sent = 0, deferred = 0;
+    std::vector<double> errors;
+    NetworkMessage full;
+    for (int tick = 1; tick <= kTicks; tick++) {
+        const double time = tick * kDt;
+        for (int i = 0; i < kEntities; i++) {
+            if (movers[i].moving) replication.setState(1 + i, stateAt(movers[i], time));
+        }
+        replication.tick(kDt);
+        pump();
+        for (auto& replica : replicas) replica->update(kDt);
+        if (tick <= 30) continue;  // initial spawn burst
+        
+        const ReplicationServerStats& stats = replication.stats();
+        tickMs += stats.tickMs;
+        bytes += stats.bytesSent;
+        sent += stats.entitiesSent;
+        deferred += stats.entitiesDeferred;
+        for (const Vec3& center : centers) {
+            full.clear();
+            for (int i = 0; i < kEntities; i++) {
+                ReplicatedState s = stateAt(movers[i], time);
+                float dx = s.position.x - center.x, dz = s.position.z - center.z;
+                if (dx * dx + dz * dz > kRadius * kRadius) continue;
+                QuantizedState q = QuantizedState::quantize(s);
+                full.writeVarUInt(1 + i);
+                for (int k = 0; k < 3; k++) full.writeVarInt(q.position[k]);
+                full.writeUInt32(q.rotation);
+                for (int k = 0; k < 3; k++) full.writeVarInt(q.velocity[k]);
+                full.writeVarUInt(q.userData);
+            }
+            fullBytes += full.getSize();
+        }
+        // Interpolated position against the analytic path at render time
+        const double renderTime = replicas[0]->getRenderTick() * kDt;
+        for (int i = 0; i < kEntities; i++) {
+            ReplicatedState s;
+            if (!replicas[0]->getInterpolatedState(1 + i, s)) continue;
+            errors.push_back((s.position - stateAt(movers[i], renderTime).position).length());
+        }
+    }
+    
+    const double ticks = kTicks - 30;
+    const double perClientTick = 1.0 / (ticks * kClients);
+    reportMetric("server tick (1000 ent, 16 clients)", tickMs / ticks, "ms");
+    reportMetric("delta snapshot bytes/client/tick", bytes * perClientTick, "B");
+    reportMetric("full state bytes/client/tick", fullBytes * perClientTick, "B");
+    reportMetric("entities sent/client/tick", sent * perClientTick, "");
+    reportMetric("entities deferred/client/tick", deferred * perClientTick, "");
+    // Re-entering entities start at their first sample, so the tail is
+    // bounded by speed x interpolation delay
+    std::sort(errors.begin(), errors.end());
+    auto percentile = [&](double p) { return errors.empty() ? 0.0 : errors[(size_t)(p * (errors.size() - 1))] * 1000.0; };
+    reportMetric("interpolation error p50", percentile(0.50), "mm");
+    reportMetric("interpolation error p99", percentile(0.99), "mm");
+    reportMetric("baseline misses (client 0)", (double)replicas[0]->stats().baselineMisses, "total");
+}
+
+}  // namespace NetworkBench
+
+// ===== Navigation Benchmarks =====
+namespace NavigationBench {
+
+struct CrowdRun {
+    CrowdStats phases;          // averaged over measured ticks
+    double pathsPerTick = 0.0;
+    size_t maxQueued = 0;
+    double overlapsPerTick = 0.0;
+    int threads = 1;
+};
+
+// Agents wander between random points on a 200 m square navmesh
+inline CrowdRun runCrowd(const NavMesh& navMesh, int agents, int ticks) {
+    constexpr float kDt = 1.0f / 30.0f;
+    constexpr int kWarmup = 60;  // drains the initial path burst
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> area(-90.0f, 90.0f);
+    
+    NavAgentSettings settings;
+    settings.speed = 3.0f;
+    settings.acceleration = 12.0f;
+    settings.avoidanceRadius = 0.4f;
+    CrowdSettings crowdSettings;
+    crowdSettings.maxPathRequestsPerTick = 128;
+    Crowd crowd(crowdSettings);
+    crowd.setNavMesh(&navMesh);
+    std::vector<Crowd::AgentId> ids;
+    for (int i = 0; i < agents; i++) {
+        ids.push_back(crowd.addAgent(Vec3(area(rng), 0.0f, area(rng)), settings));
+        crowd.setDestination(ids.back(), Vec3(area(rng), 0.0f, area(rng)));
+    }
+    
+    CrowdRun run;
+    run.threads = crowd.getThreadCount();
+    SpatialHashGrid grid;
+    std::vector<float> x(agents), z(agents);
+    size_t overlaps = 0, paths = 0;
+    for (int tick = 0; tick < kWarmup + ticks; tick++) {
+        for (auto id : ids) {
+            NavAgentState state = crowd.getState(id);
+            if (state == NavAgentState::Arrived || state == NavAgentState::Stuck) {
+                crowd.setDestination(id, Vec3(area(rng), 0.0f, area(rng)));
+            }
+        }
+        crowd.update(kDt);
+        if (tick < kWarmup) continue;
+        
+        const CrowdStats& stats = crowd.getStats();
+        run.phases.updateMs += stats.updateMs;
+        run.phases.pathMs += stats.pathMs;
+        run.phases.gridMs += stats.gridMs;
+        run.phases.avoidanceMs += stats.avoidanceMs;
+        run.phases.integrateMs += stats.integrateMs;
+        paths += stats.pathsSolved;
+        run.maxQueued = std::max(run.maxQueued, stats.pathsQueued);
+        
+        // Pairs closer than 90% of the combined radius
+        for (int i = 0; i < agents; i++) {
+            Vec3 p = crowd.getPosition(ids[i]);
+            x[i] = p.x;
+            z[i] = p.z;
+        }
+        grid.build(x.data(), z.data(), agents, 1.0f);
+        const float minDist = 0.9f * 2.0f * settings.avoidanceRadius;
+        for (int i = 0; i < agents; i++) {
+            grid.query(x[i], z[i], minDist, [&](uint32_t j) {
+                if ((int)j <= i) return;
+                float dx = x[j] - x[i], dz = z[j] - z[i];
+                if (dx * dx + dz * dz < minDist * minDist) overlaps++;
+            });
+        }
+    }
+    const double inv = 1.0 / ticks;
+    run.phases.updateMs *= inv;
+    run.phases.pathMs *= inv;
+    run.phases.gridMs *= inv;
+    run.phases.avoidanceMs *= inv;
+    run.phases.integrateMs *= inv;
+    run.pathsPerTick = paths * inv;
+    run.overlapsPerTick = overlaps * inv;
+    return run;
+}
+
+inline void benchCrowd5k() {
+    constexpr int kRes = 17;
+    std::vector<float> heights(kRes * kRes, 0.0f);
+    NavMesh navMesh;
+    if (!navMesh.buildFromHeightmap(heights.data(), kRes, kRes, 200.0f, 200.0f, 1.0f, NavMeshBuildSettings())) return;
+    
+    CrowdRun small = runCrowd(navMesh, 1000, 120);
+    CrowdRun large = runCrowd(navMesh, 5000, 120);
+    reportMetric("crowd tick, 1000 agents", small.phases.updateMs, "ms");
+    reportMetric("crowd tick, 5000 agents", large.phases.updateMs, "ms");
+    reportMetric("  path requests", large.phases.pathMs, "ms");
+    reportMetric("  spatial hash build", large.phases.gridMs, "ms");
+    reportMetric("  steering + ORCA", large.phases.avoidanceMs, "ms");
+    reportMetric("  integration", large.phases.integrateMs, "ms");
+    reportMetric("  cost per agent", large.phases.updateMs * 1000.0 / 5000.0, "us");
+    reportMetric("  threads", (double)large.threads, "");
+    reportMetric("  paths solved/tick", large.pathsPerTick, "");
+    reportMetric("  max queued path requests", (double)large.maxQueued, "");
+    reportMetric("  overlapping pairs/tick", large.overlapsPerTick, "");
+}
+
+inline void benchPathQueries() {
+    // 300 m terrain with a grid of steep blocks; about 7000 polygons
+    constexpr int kRes = 65;
+    std::vector<float> heights(kRes * kRes, 0.0f);
+    for (int z = 0; z < kRes; z++) {
+        for (int x = 0; x < kRes; x++) {
+            if ((x / 6) % 2 && (z / 6) % 2 && x % 6 && z % 6) heights[z * kRes + x] = 1.0f;
+        }
+    }
+    NavMesh navMesh;
+    if (!navMesh.buildFromHeightmap(heights.data(), kRes, kRes, 300.0f, 300.0f, 30.0f, NavMeshBuildSettings())) return;
+    
+    // 64 groups of 8 agents asking for nearly the same path
+    constexpr int kGroups = 64, kPerGroup = 8;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> area(-145.0f, 145.0f), jitter(-0.3f, 0.3f);
+    std::vector<std::pair<Vec3, Vec3>> requests;
+    NavPathQueryService locator(&navMesh);
+    while (requests.size() < (size_t)kGroups * kPerGroup) {
+        Vec3 start(area(rng), 0.0f, area(rng)), end(area(rng), 0.0f, area(rng));
+        NavPath probe;
+        if (!locator.findPath(start, end, probe)) continue;  // inside a block
+        for (int i = 0; i < kPerGroup; i++) {
+            requests.push_back({start + Vec3(jitter(rng), 0.0f, jitter(rng)), end + Vec3(jitter(rng), 0.0f, jitter(rng))});
+        }
+    }
+    const double perQuery = 1000.0 / requests.size();
+    
+    double baseLength = 0.0;
+    {
+        BenchTimer timer;
+        for (const auto& r : requests) {
+            NavPathfinder pathfinder(&navMesh);  // fresh pool every call
+            NavPath path;
+            pathfinder.findPath(r.first, r.second, path);
+            baseLength += path.totalLength;
+        }
+        reportMetric("new NavPathfinder per query", timer.elapsedMs() * perQuery, "us");
+    }
+    {
+        NavPathfinder pathfinder(&navMesh);
+        NavPath path;
+        BenchTimer timer;
+        for (const auto& r : requests) pathfinder.findPath(r.first, r.second, path);
+        reportMetric("reused NavPathfinder", timer.elapsedMs() * perQuery, "us");
+    }
+    auto runService = [&](const char* label, size_t minPolys, size_t cache, double* length) {
+        NavPathQuerySettings settings;
+        settings.hierarchicalMinPolys = minPolys;
+        settings.cacheCapacity = cache;
+        NavPathQueryService queries(&navMesh, settings);
+        NavPath path;
+        double total = 0.0;
+        BenchTimer timer;
+        for (const auto& r : requests) {
+            queries.findPath(r.first, r.second, path);
+            total += path.totalLength;
+        }
+        reportMetric(label, timer.elapsedMs() * perQuery, "us");
+        if (length) *length = total;
+        return queries.getStats();
+    };
+    runService("service, flat, no cache", ~size_t(0), 0, nullptr);
+    double clusterLength = 0.0;
+    runService("service, clusters, no cache", 0, 0, &clusterLength);
+    NavPathQueryStats cached = runService("service, clusters + cache", 0, 1024, nullptr);
+    reportMetric("  cache hit rate", 100.0 * cached.cacheHits / (cached.cacheHits + cached.cacheMisses), "%");
+    reportMetric("  clusters", (double)cached.clusters, "");
+    reportMetric("  path length vs. flat", 100.0 * clusterLength / baseLength, "%");
+    
+    // Asynchronous: workers drain the queue while this thread waits
+    {
+        NavPathQuerySettings settings;
+        settings.threads = (int)std::max(2u, std::thread::hardware_concurrency());
+        settings.hierarchicalMinPolys = 0;
+        NavPathQueryService queries(&navMesh, settings);
+        std::vector<NavPathQueryService::QueryId> ids;
+        BenchTimer timer;
+        for (const auto& r : requests) ids.push_back(queries.request(r.first, r.second));
+        queries.flush();
+        double ms = timer.elapsedMs();
+        NavPath path;
+        for (auto id : ids) queries.takeResult(id, path);
+        reportMetric("async batch of 512", ms, "ms");
+        reportMetric("  worker threads", (double)queries.getThreadCount(), "");
+    }
+    // Time-sliced: 0.5 ms per frame on the calling thread
+    {
+        NavPathQuerySettings settings;
+        settings.hierarchicalMinPolys = 0;
+        NavPathQueryService queries(&navMesh, settings);
+        for (const auto& r : requests) queries.request(r.first, r.second);
+        int frames = 0;
+        double worst = 0.0;
+        while (queries.getPendingCount() > 0) {
+            BenchTimer timer;
+            queries.update(0.5);
+            worst = std::max(worst, timer.elapsedMs());
+            frames++;
+        }
+        reportMetric("time-sliced frames for 512", (double)frames, "frames");
+        reportMetric("  worst slice (0.5 ms budget)", worst, "ms");
+    }
+}
+
+inline void benchTiledNavMesh() {
+    // 400 m terrain at 257 x 257 samples, 64 tiles; about 130k polygons
+    constexpr int kRes = 257;
+    std::vector<float> heights(kRes * kRes);
+    for (int z = 0; z < kRes; z++) {
+        for (int x = 0; x < kRes; x++) {
+            heights[z * kRes + x] = 0.5f + 0.25f * std::sin(x * 0.05f) * std::cos(z * 0.07f);
+        }
+    }
+    {
+        NavMesh navMesh;
+        BenchTimer timer;
+        navMesh.buildFromHeightmap(heights.data(), kRes, kRes, 400.0f, 400.0f, 20.0f, NavMeshBuildSettings());
+        reportMetric("single NavMesh build", timer.elapsedMs(), "ms");
+    }
+    
+    TiledNavMesh tiled;
+    tiled.setHeightmap(heights.data(), kRes, kRes, 400.0f, 400.0f, 20.0f, NavMeshBuildSettings());
+    {
+        BenchTimer timer;
+        tiled.rebuild();
+        reportMetric("tiled full build", timer.elapsedMs(), "ms");
+        reportMetric("  tiles", (double)tiled.getStats().tiles, "");
+        reportMetric("  polygons", (double)tiled.getStats().polygons, "");
+    }
+    
+    // A door opening and closing: one obstacle moving inside one tile
+    int door = tiled.addObstacle(Vec3(-20, 0, -20), Vec3(-18, 5, -14));
+    tiled.rebuild();
+    constexpr int kEdits = 20;
+    double buildMs = 0.0, stitchMs = 0.0;
+    size_t built = 0;
+    BenchTimer editTimer;
+    for (int i = 0; i < kEdits; i++) {
+        float offset = (i % 2) ? 2.0f : 0.0f;
+        tiled.moveObstacle(door, Vec3(-20 + offset, 0, -20), Vec3(-18 + offset, 5, -14));
+        tiled.rebuild();
+        buildMs += tiled.getStats().buildMs;
+        stitchMs += tiled.getStats().stitchMs;
+        built += tiled.getStats().tilesBuilt;
+    }
+    reportMetric("obstacle edit + rebuild", editTimer.elapsedMs() / kEdits, "ms");
+    reportMetric("  tiles rebuilt per edit", (double)built / kEdits, "");
+    reportMetric("  tile build", buildMs / kEdits, "ms");
+    reportMetric("  stitch", stitchMs / kEdits, "ms");
+    
+    std::string cachePath = (std::filesystem::temp_directory_path() / "luma_bench_navtiles.bin").string();
+    tiled.saveCache(cachePath);
+    {
+        TiledNavMesh loaded;
+        BenchTimer timer;
+        loaded.setHeightmap(heights.data(), kRes, kRes, 400.0f, 400.0f, 20.0f, NavMeshBuildSettings());
+        loaded.addObstacle(Vec3(-18, 0, -20), Vec3(-16, 5, -14));  // where the door ended up
+        loaded.loadCache(cachePath);
+        reportMetric("level load from tile cache", timer.elapsedMs(), "ms");
+        reportMetric("  tiles from cache", (double)loaded.getStats().tilesFromCache, "");
+        reportMetric("  cache size", std::filesystem::file_size(cachePath) / (1024.0 * 1024.0), "MB");
+    }
+    std::filesystem::remove(cachePath);
+}
+
+}  // namespace NavigationBench
+
+// ===== Behavior Trees =====
+namespace BehaviorTreeBench {
+
+// Guard: chase a seen target, idle at home, otherwise walk home.
+// Keys are std::string or BBKey, to compare both blackboard paths.
+template<typename VecKey, typename BoolKey>
+inline std::unique_ptr<BTNode> buildGuardTree(VecKey target, VecKey home, BoolKey alert) {
+    return BTBuilder()
+        .selector()
+            .sequence()
+                .condition(BTActions::checkBool(alert))
+                .condition(BTActions::inRange(target, 20.0f))
+                .action(BTActions::moveTo(target))
+            .end()
+            .sequence()
+                .condition(BTActions::inRange(home, 2.0f))
+                .wait(2.0f)
+            .end()
+            .action(BTActions::moveTo(home))
+        .build();
+}
+
+inline void benchBehaviorTrees10k() {
+    constexpr int kAgents = 10000, kTicks = 20;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> area(-50.0f, 50.0f);
+    // Agents stand at the origin (BehaviorTree has no owner position)
+    std::vector<Vec3> targets(kAgents), homes(kAgents);
+    for (int i = 0; i < kAgents; i++) {
+        targets[i] = Vec3(area(rng) * 0.5f, 0.0f, area(rng) * 0.5f);
+        homes[i] = Vec3(area(rng) * 0.05f, 0.0f, 0.0f);
+    }
+    auto report = [](const char* label, double ms) {
+        reportMetric(label, kAgents * kTicks / ms, "agents/ms");
+    };
+    
+    // One node tree and string-keyed blackboard per agent
+    {
+        std::vector<std::unique_ptr<BehaviorTree>> trees;
+        for (int i = 0; i < kAgents; i++) {
+            trees.push_back(std::make_unique<BehaviorTree>());
+            trees.back()->setRoot(buildGuardTree(std::string("target"), std::string("home"), std::string("alert")));
+            Blackboard& bb = trees.back()->getBlackboard();
+            bb.set("target", targets[i]);
+            bb.set("home", homes[i]);
+            bb.set("alert", i % 2 == 0);
+        }
+        BenchTimer timer;
+        for (int t = 0; t < kTicks; t++) {
+            for (auto& tree : trees) tree->tick(0.016f);
+        }
+        report("node trees, string keys", timer.elapsedMs());
+    }
+    
+    // One compiled tree; still string-keyed blackboards
+    CompiledBehaviorTree stringTree;
+    stringTree.compile(buildGuardTree(std::string("target"), std::string("home"), std::string("alert")).get());
+    {
+        std::vector<Blackboard> blackboards(kAgents);
+        BTAgentGroup group(&stringTree);
+        for (int i = 0; i < kAgents; i++) {
+            blackboards[i].set("target", targets[i]);
+            blackboards[i].set("home", homes[i]);
+            blackboards[i].set("alert", i % 2 == 0);
+            group.addAgent(&blackboards[i]);
+        }
+        BenchTimer timer;
+        for (int t = 0; t < kTicks; t++) group.tick(0.016f);
+        report("compiled, string keys", timer.elapsedMs());
+    }
+    
+    // Compiled tree with interned keys
+    BlackboardSchema schema;
+    BBKey<Vec3> target = schema.add<Vec3>("target");
+    BBKey<Vec3> home = schema.add<Vec3>("home");
+    BBKey<bool> alert = schema.add<bool>("alert");
+    CompiledBehaviorTree keyedTree;
+    keyedTree.compile(buildGuardTree(target, home, alert).get());
+    {
+        std::vector<Blackboard> blackboards(kAgents, Blackboard(&schema));
+        BTAgentGroup group(&keyedTree);
+        for (int i = 0; i < kAgents; i++) {
+            blackboards[i].set(target, targets[i]);
+            blackboards[i].set(home, homes[i]);
+            blackboards[i].set(alert, i % 2 == 0);
+            group.addAgent(&blackboards[i]);
+        }
+        BenchTimer timer;
+        for (int t = 0; t < kTicks; t++) group.tick(0.016f);
+        double ms = timer.elapsedMs();
+        report("compiled group, interned keys", ms);
+        reportMetric("  per tick, 10k agents", ms / kTicks, "ms");
+        reportMetric("  node state per agent", (double)(keyedTree.getNodeCount() * sizeof(BTNodeState)), "bytes");
+    }
+}
+
+}  // namespace BehaviorTreeBench
+
+// ===== Animation State Machines =====
+namespace AnimationBench {
+
+// Every character runs the locomotion and combat presets; parameters are
+// set every frame like gameplay code would
+inline void benchStateMachines1000() {
+    constexpr int kCharacters = 1000, kFrames = 300;
+    constexpr float kDt = 1.0f / 60.0f;
+    AnimationClip idle, walk, run, attack1, attack2, block, hit;
+    idle.duration = 2.0f;
+    walk.duration = 1.0f;
+    run.duration = 0.7f;
+    attack1.duration = 0.8f;
+    attack2.duration = 1.0f;
+    block.duration = 1.5f;
+    hit.duration = 0.5f;
+    auto speedAt = [](int c, int f) { return 0.5f + 0.5f * std::sin(c * 0.37f + f * 0.05f); };
+    auto movingAt = [](int c, int f) { return (c + f) % 120 < 90; };
+    auto attackAt = [](int c, int f) { return (c * 7 + f) % 45 == 0; };
+    auto hitAt = [](int c, int f) { return (c * 13 + f) % 170 == 0; };
+    
+    double referenceMs = 0.0;
+    {
+        std::vector<std::unique_ptr<AnimationStateMachine>> locomotion, combat;
+        for (int c = 0; c < kCharacters; c++) {
+            locomotion.push_back(StateMachinePresets::createLocomotionSM(&idle, &walk, &run));
+            combat.push_back(StateMachinePresets::createCombatSM(&idle, &attack1, &attack2, &block, &hit));
+        }
+        BenchTimer timer;
+        for (int f = 0; f < kFrames; f++) {
+            for (int c = 0; c < kCharacters; c++) {
+                locomotion[c]->setFloat("Speed", speedAt(c, f));
+                locomotion[c]->setBool("IsMoving", movingAt(c, f));
+                if (attackAt(c, f)) combat[c]->setTrigger("Attack");
+                if (hitAt(c, f)) combat[c]->setTrigger("Hit");
+                locomotion[c]->update(kDt);
+                combat[c]->update(kDt);
+            }
+        }
+        referenceMs = timer.elapsedMs() / kFrames;
+        reportMetric("AnimationStateMachine x2 per char", referenceMs * 1000.0, "us/frame");
+    }
+    
+    CompiledStateMachine locomotion, combat;
+    locomotion.compile(*StateMachinePresets::createLocomotionSM(&idle, &walk, &run));
+    combat.compile(*StateMachinePresets::createCombatSM(&idle, &attack1, &attack2, &block, &hit));
+    int speed = locomotion.findParameter("Speed"), moving = locomotion.findParameter("IsMoving");
+    int attack = combat.findParameter("Attack"), hitParam = combat.findParameter("Hit");
+    std::vector<StateMachineInstance> locomotionInstances(kCharacters), combatInstances(kCharacters);
+    for (int c = 0; c < kCharacters; c++) {
+        locomotion.initInstance(locomotionInstances[c]);
+        combat.initInstance(combatInstances[c]);
+    }
+    size_t changes = 0;
+    BenchTimer timer;
+    for (int f = 0; f < kFrames; f++) {
+        for (int c = 0; c < kCharacters; c++) {
+            locomotionInstances[c].setFloat(speed, speedAt(c, f));
+            locomotionInstances[c].setBool(moving, movingAt(c, f));
+            if (attackAt(c, f)) combatInstances[c].setTrigger(attack);
+            if (hitAt(c, f)) combatInstances[c].setTrigger(hitParam);
+        }
+        locomotion.updateBatch(locomotionInstances.data(), kCharacters, kDt);
+        combat.updateBatch(combatInstances.data(), kCharacters, kDt);
+        for (int c = 0; c < kCharacters; c++) changes += combatInstances[c].stateChanged;
+    }
+    double compiledMs = timer.elapsedMs() / kFrames;
+    reportMetric("compiled, batched", compiledMs * 1000.0, "us/frame");
+    reportMetric("  speedup", referenceMs / compiledMs, "x");
+    reportMetric("  combat state changes", (double)changes, "");
+}
+
+}  // namespace AnimationBench
+
+namespace VisualScriptBench {
+
+inline void connect(VisualScriptGraph& graph, VisualScriptNode* from, const char* out, VisualScriptNode* to, const char* in) {
+    graph.createLink(from->id, from->findOutputByName(out)->id, to->id, to->findInputByName(in)->id);
+}
+
+// Floating pickup: accumulates time, sums a small wave over 8 samples, bobs
+// and spins. Speed/amplitude come from a constant subgraph, and a few
+// leftover nodes hang off nothing.
+inline void buildPickupScript(VisualScriptGraph& graph) {
+    graph.addVariable("Time", PinType::Float);
+    graph.addVariable("Wave", PinType::Float);
+    auto variable = [&](const char* type, const char* name) {
+        auto* node = graph.createNode(type);
+        node->properties["VariableName"] = std::string(name);
+        return node;
+    };
+    auto* update = graph.createNode("OnUpdate");
+    auto* getTime = variable("GetVariable", "Time");
+    auto* addTime = graph.createNode("Add");
+    auto* setTime = variable("SetVariable", "Time");
+    connect(graph, getTime, "Value", addTime, "A");
+    connect(graph, update, "DeltaTime", addTime, "B");
+    connect(graph, addTime, "Result", setTime, "Value");
+    connect(graph, update, "Exec", setTime, "Exec");
+    
+    // Wave = 0; for i in 0..7: Wave += clamp(lerp(i, Time, speed), 0, amplitude)
+    auto* resetWave = variable("SetVariable", "Wave");
+    auto* loop = graph.createNode("ForLoop");
+    loop->findInputByName("End")->defaultValue = 7;
+    auto* speed = graph.createNode("Multiply");
+    speed->findInputByName("A")->defaultValue = 0.25f;
+    speed->findInputByName("B")->defaultValue = 2.0f;
+    auto* amplitude = graph.createNode("Divide");
+    amplitude->findInputByName("A")->defaultValue = 3.0f;
+    amplitude->findInputByName("B")->defaultValue = 4.0f;
+    auto* lerp = graph.createNode("Lerp");
+    auto* clamp = graph.createNode("Clamp");
+    auto* getWave = variable("GetVariable", "Wave");
+    auto* addWave = graph.createNode("Add");
+    auto* setWave = variable("SetVariable", "Wave");
+    connect(graph, setTime, "Exec", resetWave, "Exec");
+    connect(graph, resetWave, "Exec", loop, "Exec");
+    connect(graph, loop, "Index", lerp, "A");
+    connect(graph, getTime, "Value", lerp, "B");
+    connect(graph, speed, "Result", lerp, "Alpha");
+    connect(graph, lerp, "Result", clamp, "Value");
+    connect(graph, amplitude, "Result", clamp, "Max");
+    connect(graph, getWave, "Value", addWave, "A");
+    connect(graph, clamp, "Result", addWave, "B");
+    connect(graph, addWave, "Result", setWave, "Value");
+    connect(graph, loop, "Loop Body", setWave, "Exec");
+    
+    // Bob when the wave is high, otherwise nudge upwards; spin every frame
+    auto* compare = graph.createNode("Compare");
+    compare->findInputByName("B")->defaultValue = 2.0f;
+    auto* branch = graph.createNode("Branch");
+    auto* getPosition = graph.createNode("GetPosition");
+    auto* offset = graph.createNode("MakeVec3");
+    auto* base = graph.createNode("BreakVec3");
+    auto* height = graph.createNode("Add");
+    auto* bob = graph.createNode("MakeVec3");
+    auto* setPosition = graph.createNode("SetPosition");
+    auto* translate = graph.createNode("Translate");
+    auto* spin = graph.createNode("Rotate");
+    spin->findInputByName("Euler")->defaultValue = Vec3(0.0f, 0.02f, 0.0f);
+    connect(graph, loop, "Completed", branch, "Exec");
+    connect(graph, getWave, "Value", compare, "A");
+    connect(graph, compare, ">", branch, "Condition");
+    connect(graph, getPosition, "Position", base, "Vector");
+    connect(graph, base, "X", bob, "X");
+    connect(graph, base, "Z", bob, "Z");
+    connect(graph, getWave, "Value", height, "A");
+    connect(graph, base, "Y", height, "B");
+    connect(graph, height, "Result", bob, "Y");
+    connect(graph, bob, "Vector", setPosition, "Position");
+    connect(graph, branch, "True", setPosition, "Exec");
+    connect(graph, speed, "Result", offset, "Y");
+    connect(graph, offset, "Vector", translate, "Delta");
+    connect(graph, branch, "False", translate, "Exec");
+    connect(graph, setPosition, "Exec", spin, "Exec");
+    
+    // Leftovers from editing
+    auto* unused = graph.createNode("Normalize");
+    connect(graph, graph.createNode("CrossProduct"), "Result", unused, "Vector");
+    graph.createNode("Print");
+}
+
+inline void benchPickupScripts1000() {
+    constexpr int kObjects = 1000, kFrames = 300;
+    constexpr float kDt = 1.0f / 60.0f;
+    VisualScriptGraph graph;
+    buildPickupScript(graph);
+    std::vector<Vec3> positions(kObjects);
+    VisualScriptBindings host;
+    host.getPosition = [&](uint64_t id) { return positions[id]; };
+    host.setPosition = [&](uint64_t id, const Vec3& p) { positions[id] = p; };
+    host.translate = [&](uint64_t id, const Vec3& d) { positions[id] = positions[id] + d; };
+    host.rotate = [](uint64_t, const Quat&) {};
+    
+    double baselineMs = 0.0;
+    for (int fold = 0; fold < 2; fold++) {
+        VisualScriptCompileOptions options;
+        options.foldConstants = fold != 0;
+        VisualScriptProgram program;
+        if (!program.compile(graph, options)) {
+            std::cout << "  compile failed: " << program.getLastError() << std::endl;
+            return;
+        }
+        std::vector<VisualScriptVM> vms(kObjects);
+        for (int i = 0; i < kObjects; i++) {
+            positions[i] = Vec3((float)i, 0.0f, 0.0f);
+            vms[i].load(&program);
+            vms[i].setBindings(&host);
+            vms[i].setSelf((uint64_t)i);
+        }
+        BenchTimer timer;
+        for (int f = 0; f < kFrames; f++) {
+            for (auto& vm : vms) vm.onUpdate(kDt);
+        }
+        double ms = timer.elapsedMs();
+        uint64_t evaluations = 0;
+        for (const auto& vm : vms) evaluations += vm.getExecutedInstructions();
+        double rate = evaluations / (ms * 1000.0);
+        const auto& stats = program.getStats();
+        if (!fold) {
+            baselineMs = ms;
+            reportMetric("bytecode, no folding", ms * 1000.0 / kFrames, "us/frame");
+            reportMetric("  node evaluations", rate, "M/s");
+            reportMetric("  instructions", stats.instructions, "");
+            continue;
+        }
+        reportMetric("bytecode, folded", ms * 1000.0 / kFrames, "us/frame");
+        reportMetric("  node evaluations", rate, "M/s");
+        reportMetric("  instructions", stats.instructions, "");
+        reportMetric("  per update", (double)evaluations / ((double)kObjects * kFrames), "instr");
+        reportMetric("  folded nodes", stats.foldedNodes, "");
+        reportMetric("  dead nodes", stats.deadNodes, "");
+        reportMetric("  speedup from folding", baselineMs / ms, "x");
+        reportMetric("  object 0 height", positions[0].y, "");
+    }
+}
+
+}  // namespace VisualScriptBench
+
+// ===== Game UI =====
+namespace GameUIBench {
+
+// 256 inventory rows: panel, icon, name, count and a cooldown bar, plus a button
+inline void buildHUD(ui::UICanvas* canvas, std::vector<ui::UILabel*>& counts,
+                     std::vector<ui::UIProgressBar*>& bars) {
+    for (int i = 0; i < 256; i++) {
+        auto row = std::make_shared<ui::UIPanel>();
+        row->setRect({10.0f + (i % 4) * 470.0f, 10.0f + (i / 4) * 16.0f, 460, 15});
+        auto icon = std::make_shared<ui::UIImage>();
+        icon->setRect({2, 1, 13, 13});
+        icon->setTextureHandle(1);
+        icon->setUVRect((i % 16) / 16.0f, 0, 1 / 16.0f, 1);
+        auto name = std::make_shared<ui::UILabel>("Item " + std::to_string(i));
+        name->setRect({20, 0, 150, 15});
+        name->setFontSize(12.0f);
+        auto count = std::make_shared<ui::UILabel>("x" + std::to_string(100 + i));
+        count->setRect({170, 0, 60, 15});
+        count->setFontSize(12.0f);
+        auto bar = std::make_shared<ui::UIProgressBar>();
+        bar->setRect({240, 2, 150, 11});
+        bar->setAnimated(false);
+        bar->setValue((i % 10) / 10.0f);
+        auto use = std::make_shared<ui::UIButton>("Use");
+        use->setRect({400, 0, 56, 15});
+        use->getLabel()->setFontSize(12.0f);
+        row->addChild(icon);
+        row->addChild(name);
+        row->addChild(count);
+        row->addChild(bar);
+        row->addChild(use);
+        canvas->addWidget(row);
+        counts.push_back(count.get());
+        bars.push_back(bar.get());
+    }
+}
+
+inline void benchHUD() {
+    auto& system = ui::getUISystem();
+    system.setScreenSize(1920, 1080);
+    ui::UICanvas* canvas = system.createCanvas("BenchHUD");
+    std::vector<ui::UILabel*> counts;
+    std::vector<ui::UIProgressBar*> bars;
+    buildHUD(canvas, counts, bars);
+    system.update(0.0f);
+    
+    size_t widgets = 0;
+    std::function<void(ui::UIWidget*)> countWidgets = [&](ui::UIWidget* w) {
+        widgets++;
+        for (const auto& c : w->getChildren()) countWidgets(c.get());
+    };
+    countWidgets(canvas->getRoot());
+    reportMetric("widgets", (double)widgets, "");
+    
+    const int kFrames = 200;
+    
+    // Baseline: command list rebuilt every frame. Frame timings below
+    // include the layout update so the two paths compare directly.
+    ui::UICommandRenderer commands;
+    BenchTimer timer;
+    for (int f = 0; f < kFrames; f++) {
+        system.update(0.016f);
+        system.render(&commands);
+    }
+    double commandUs = timer.elapsedMs() * 1000.0 / kFrames;
+    reportMetric("command renderer, idle", commandUs, "us/frame");
+    reportMetric("  commands", (double)commands.getCommands().size(), "");
+    
+    // Batched: cold first frame rasterizes glyphs, then full rebuilds on a warm atlas
+    ui::UIBatchRenderer batched;
+    timer = BenchTimer();
+    batched.render(system);
+    reportMetric("batched, first frame", timer.elapsedMs() * 1000.0, "us");
+    reportMetric("  glyphs rasterized", batched.getStats().glyphsRasterized, "");
+    reportMetric("  draw calls", batched.getStats().drawCalls, "");
+    reportMetric("  vertices", batched.getStats().vertices, "");
+    
+    timer = BenchTimer();
+    for (int f = 0; f < kFrames; f++) {
+        system.update(0.016f);
+        batched.invalidate();
+        batched.render(system);
+    }
+    reportMetric("batched, full rebuild", timer.elapsedMs() * 1000.0 / kFrames, "us/frame");
+    reportMetric("  text run hits", batched.getStats().textRunHits, "");
+    
+    timer = BenchTimer();
+    for (int f = 0; f < kFrames; f++) {
+        system.update(0.016f);
+        batched.render(system);
+    }
+    double idleUs = timer.elapsedMs() * 1000.0 / kFrames;
+    reportMetric("batched, idle", idleUs, "us/frame");
+    reportMetric("  vs. command renderer", commandUs / idleUs, "x");
+    
+    // One counter ticks per frame: same glyph count, patched in place
+    uint32_t rebuilt = 0, patched = 0;
+    timer = BenchTimer();
+    for (int f = 0; f < kFrames; f++) {
+        counts[f % counts.size()]->setText("x" + std::to_string(500 + f));
+        system.update(0.016f);
+        batched.render(system);
+        rebuilt += batched.getStats().widgetsRebuilt;
+        patched += batched.getStats().widgetsPatched;
+    }
+    reportMetric("batched, one label/frame", timer.elapsedMs() * 1000.0 / kFrames, "us/frame");
+    reportMetric("  widgets rebuilt per frame", (double)rebuilt / kFrames, "");
+    reportMetric("  patched in place per frame", (double)patched / kFrames, "");
+    
+    // Eight cooldown bars move per frame
+    timer = BenchTimer();
+    for (int f = 0; f < kFrames; f++) {
+        for (int b = 0; b < 8; b++) {
+            bars[(f * 8 + b) % bars.size()]->setValue(((f + b) % 100) / 100.0f);
+        }
+        system.update(0.016f);
+        batched.render(system);
+    }
+    double barsUs = timer.elapsedMs() * 1000.0 / kFrames;
+    reportMetric("batched, 8 bars/frame", barsUs, "us/frame");
+    reportMetric("  draw calls", batched.getStats().drawCalls, "");
+    reportMetric("  vs. command renderer", commandUs / barsUs, "x");
+    
+    system.removeCanvas("BenchHUD");
+}
+
+}  // namespace GameUIBench
+
+// ===== Register All Benchmarks =====
+inline void registerAllBenchmarks(BenchmarkRunner& runner) {
+    runner.add("FileWatcher", "Per-frame cost at 10k watched files", FileWatcherBench::benchWatch10kFiles);
+    runner.add("Logging", "Cost per log call", LogBench::benchLogCall);
+    runner.add("Texture", "Shared textures on a multi-material character", TextureBench::benchSharedCharacterTextures);
+    runner.add("Texture", "BCn quality and throughput", TextureBench::benchBlockCompression);
+    runner.add("Texture", "Cooked cache vs. cooking", TextureBench::benchCookedCache);
+    runner.add("Texture", "Streaming: hero texture behind 200 far ones", TextureBench::benchStreamingPriority);
+    runner.add("Audio", "Voice mixing throughput", AudioBench::benchVoiceMixing);
+    runner.add("Audio", "Lip sync analysis", AudioBench::benchLipSyncAnalysis);
+    runner.add("AI", "Face mesh inference (192x192, 468 landmarks)", AIBench::benchFaceMeshInference);
+    runner.add("Character", "Blend shapes + skinning, 16 characters", CharacterBench::benchSkinDeformation);
+    runner.add("Character", "MakeHuman targets: text vs. binary pack", CharacterBench::benchMakeHumanTargetPack);
+    runner.add("Character", "Auto-rig weights and garment transfer", CharacterBench::benchAutoRig);
+    runner.add("Render", "Software rasterizer thumbnails", RenderBench::benchSoftwareThumbnails);
+    runner.add("Render", "Scene culling, 100k objects", RenderBench::benchSceneCulling100k);
+    runner.add("Network", "UDP reliable soak over loopback", NetworkBench::benchUdpSoak);
+    runner.add("Network", "Entity state encoding", NetworkBench::benchMessageEncoding);
+    runner.add("Network", "Snapshot replication, 1000 entities", NetworkBench::benchReplication);
+    runner.add("Navigation", "Crowd, 5000 agents", NavigationBench::benchCrowd5k);
+    runner.add("Navigation", "Path queries, 7k polygons", NavigationBench::benchPathQueries);
+    runner.add("Navigation", "Tiled navmesh build, edit and cache", NavigationBench::benchTiledNavMesh);
+    runner.add("AI", "Behavior trees, 10k agents", BehaviorTreeBench::benchBehaviorTrees10k);
+    runner.add("Animation", "State machines, 1000 characters", AnimationBench::benchStateMachines1000);
+    runner.add("Script", "Visual scripts, 1000 objects", VisualScriptBench::benchPickupScripts1000);
+    runner.add("GameUI", "Batched HUD, 256 rows", GameUIBench::benchHUD);
+}
+
+// ===== Run All Benchmarks =====
+inline void runAllBenchmarks(const std::string& filter = "") {
+    BenchmarkRunner runner;
+    registerAllBenchmarks(runner);
+    runner.run(filter);
+}
+
+}  // namespace test
+}  // namespace luma
@@ -3,11 +3,14 @@
 
 #include "integration_test.h"
 #include "unit_tests.h"
+#include "benchmarks.h"
 
 int main(int argc, char* argv[]) {
     bool showManual = false;
     bool runUnit = true;
     bool runIntegration = true;
+    bool runBench = false;
+    std::string benchFilter;
     
     // Parse arguments
     for (int i = 1; i < argc; i++) {
@@ -27,6 +30,14 @@ int main(int argc, char* argv[]) {
             runUnit = true;
             runIntegration = true;
         }
+        if (arg == "--bench" || arg == "-b") {
+            runBench = true;
+            runUnit = false;
+            runIntegration = false;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                benchFilter = argv[++i];
+            }
+        }
         if (arg == "--help" || arg == "-h") {
             std::cout << "LUMA Studio Test Suite\n";
             std::cout << "Usage: " << argv[0] << " [options]\n";
@@ -35,6 +46,7 @@ int main(int argc, char* argv[]) {
             std::cout << "  --integration, -i Run integration tests only\n";
             std::cout << "  --all, -a         Run all tests (default)\n";
             std::cout << "  --manual, -m      Show manual test checklist\n";
+            std::cout << "  --bench, -b [f]   Run benchmarks (optionally matching filter)\n";
             std::cout << "  --help, -h        Show this help\n";
             return 0;
         }
@@ -54,6 +66,11 @@ int main(int argc, char* argv[]) {
         allPassed = allPassed && integrationPassed;
     }
     
+    // Run benchmarks
+    if (runBench) {
+        luma::test::runAllBenchmarks(benchFilter);
+    }
+    
     // Show manual checklist if requested
     if (showManual) {
         luma::test::printManualTestChecklist();
@@ -5,10 +5,31 @@
 #include "engine/foundation/math_types.h"
 #include "engine/animation/animation.h"
 #include "engine/rendering/culling.h"
+#include "engine/rendering/scene_culling.h"
 #include "engine/rendering/lod.h"
 #include "engine/rendering/ssao.h"
 #include "engine/rendering/ibl.h"
 #include "engine/rendering/advanced_shadows.h"
+#include "engine/renderer/rhi/software_backend.h"
+#include "engine/util/file_watcher.h"
+#include "engine/foundation/log.h"
+#include "engine/asset/texture_cache.h"
+#include "engine/asset/texture_compression.h"
+#include "engine/asset/async_texture_loader.h"
+#include "engine/audio/audio.h"
+#include "engine/animation/lip_sync.h"
+#include "engine/character/ai/ai_inference.h"
+#include "engine/character/skin_deformer.h"
+#include "engine/character/makehuman_integration.h"
+#include "engine/character/auto_rig.h"
+#include "engine/network/network.h"
+#include "engine/network/replication.h"
+#include "engine/script/script_engine.h"
+#include "engine/ai/crowd.h"
+#include "engine/ai/tiled_navmesh.h"
+#include "engine/ai/behavior_tree.h"
+#include "engine/script/visual_script_vm.h"
+#include "engine/game_ui/ui_batch_renderer.h"
 
 #include <iostream>
 #include <cassert>
@@ -17,6 +38,11 @@
 #include <string>
 #include <functional>
 #include <chrono>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <fstream>
+#include <unordered_set>
 
 namespace luma {
 namespace test {
@@ -374,6 +400,47 @@ inline bool testStateMachine() {
     // Should transition (or be transitioning)
     EXPECT_TRUE(sm.getCurrentStateName() == "Walk" || sm.isTransitioning());
     
+    // Sampling a blend is const and safe from several threads at once
+    constexpr int kBones = 64;
+    AnimationClip idleClip, walkClip;
+    idleClip.duration = walkClip.duration = 1.0f;
+    for (int b = 0; b < kBones; b++) {
+        AnimationChannel& a = idleClip.addChannel("b" + std::to_string(b));
+        a.targetBoneIndex = b;
+        a.positionKeys.push_back({0.0f, Vec3((float)b, 0, 0), Vec3(), Vec3()});
+        AnimationChannel& w = walkClip.addChannel("b" + std::to_string(b));
+        w.targetBoneIndex = b;
+        w.positionKeys.push_back({0.0f, Vec3(0, (float)b, 0), Vec3(), Vec3()});
+    }
+    idle->clip = &idleClip;
+    walk->clip = &walkClip;
+    sm.update(0.05f);  // a quarter into the 0.2 s crossfade
+    EXPECT_TRUE(sm.isTransitioning());
+    
+    const AnimationStateMachine& shared = sm;
+    std::vector<Vec3> refPos(kBones), refScl(kBones);
+    std::vector<Quat> refRot(kBones);
+    shared.sample(refPos.data(), refRot.data(), refScl.data(), kBones);
+    EXPECT_TRUE(refPos[10].x > 0.0f && refPos[10].y > 0.0f);
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t] {
+            std::vector<Vec3> pos(kBones), scl(kBones);
+            std::vector<Quat> rot(kBones);
+            StateMachineSampleScratch own;
+            for (int i = 0; i < 200; i++) {
+                if (t % 2) shared.sample(pos.data(), rot.data(), scl.data(), kBones, own);
+                else shared.sample(pos.data(), rot.data(), scl.data(), kBones);
+                for (int b = 0; b < kBones; b++) {
+                    if ((pos[b] - refPos[b]).length() > 1e-5f) mismatches++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(mismatches.load(), 0);
+    
     return true;
 }
 
@@ -417,6 +484,96 @@ inline bool testBoneMask() {
     return true;
 }
 
+inline bool testCompiledStateMachine() {
+    AnimationClip idle, attack1, attack2, block, hit;
+    idle.duration = 2.0f;
+    attack1.duration = 0.8f;
+    attack2.duration = 1.0f;
+    block.duration = 1.5f;
+    hit.duration = 0.5f;
+    auto reference = StateMachinePresets::createCombatSM(&idle, &attack1, &attack2, &block, &hit);
+    
+    CompiledStateMachine compiled;
+    EXPECT_TRUE(compiled.compile(*reference));
+    EXPECT_EQ(compiled.getStateCount(), (size_t)5);
+    EXPECT_EQ(compiled.getParameterCount(), (size_t)4);
+    int attack = compiled.findParameter("Attack");
+    int blocking = compiled.findParameter("Block");
+    int hitParam = compiled.findParameter("Hit");
+    EXPECT_TRUE(attack >= 0 && blocking >= 0 && hitParam >= 0);
+    EXPECT_EQ(compiled.findParameter("Missing"), -1);
+    
+    // Same states, transitions and trigger consumption frame by frame
+    StateMachineInstance instance;
+    compiled.initInstance(instance);
+    int changes = 0;
+    for (int frame = 0; frame < 240; frame++) {
+        if (frame == 5 || frame == 25 || frame == 70) {
+            reference->setTrigger("Attack");
+            instance.setTrigger(attack);
+        }
+        bool blockDown = frame >= 110 && frame < 140;
+        reference->setBool("Block", blockDown);
+        instance.setBool(blocking, blockDown);
+        if (frame == 160 || frame == 200) {
+            reference->setTrigger("Hit");
+            instance.setTrigger(hitParam);
+        }
+        reference->update(1.0f / 30.0f);
+        compiled.update(instance, 1.0f / 30.0f);
+        changes += instance.stateChanged;
+        EXPECT_EQ(compiled.getStateName(instance.currentState), reference->getCurrentStateName());
+        EXPECT_EQ(instance.transitioning, reference->isTransitioning());
+        EXPECT_NEAR(instance.transitionProgress, reference->getTransitionProgress(), 1e-5f);
+    }
+    EXPECT_TRUE(changes >= 8);
+    
+    // A batch of instances matches one-by-one updates
+    std::vector<StateMachineInstance> batch(64);
+    for (auto& inst : batch) compiled.initInstance(inst);
+    for (int frame = 0; frame < 60; frame++) {
+        for (size_t i = 0; i < batch.size(); i++) {
+            if (frame == (int)(i % 20)) batch[i].setTrigger(attack);
+        }
+        compiled.updateBatch(batch.data(), batch.size(), 1.0f / 30.0f);
+    }
+    for (size_t i = 0; i < batch.size(); i++) {
+        StateMachineInstance single;
+        compiled.initInstance(single);
+        for (int frame = 0; frame < 60; frame++) {
+            if (frame == (int)(i % 20)) single.setTrigger(attack);
+            compiled.update(single, 1.0f / 30.0f);
+        }
+        EXPECT_EQ(single.currentState, batch[i].currentState);
+        EXPECT_NEAR(single.currentTime, batch[i].currentTime, 1e-6f);
+    }
+    
+    // Locomotion: floats and bools
+    auto locomotion = StateMachinePresets::createLocomotionSM(&idle, &attack1, &attack2);
+    EXPECT_TRUE(compiled.compile(*locomotion));
+    compiled.initInstance(instance);
+    int speed = compiled.findParameter("Speed"), moving = compiled.findParameter("IsMoving");
+    for (int frame = 0; frame < 120; frame++) {
+        float v = 0.5f + 0.5f * std::sin(frame * 0.1f);
+        bool isMoving = frame % 50 < 40;
+        locomotion->setFloat("Speed", v);
+        locomotion->setBool("IsMoving", isMoving);
+        instance.setFloat(speed, v);
+        instance.setBool(moving, isMoving);
+        locomotion->update(1.0f / 30.0f);
+        compiled.update(instance, 1.0f / 30.0f);
+        EXPECT_EQ(compiled.getStateName(instance.currentState), locomotion->getCurrentStateName());
+    }
+    
+    // Transitions to unknown states don't compile
+    AnimationStateMachine broken;
+    broken.createState("A")->addTransition("Nowhere");
+    EXPECT_FALSE(compiled.compile(broken));
+    EXPECT_FALSE(compiled.getLastError().empty());
+    EXPECT_EQ(compiled.getStateCount(), (size_t)0);
+    return true;
+}
+
 }  // namespace AnimationTests
 
 // ===== Rendering Tests =====
@@ -577,6 +734,219 @@ inline bool testVolumetricFogDensity() {
     return true;
 }
 
+
+inline bool testSoftwareRasterizer() {
+    const uint32_t size = 64;
+    rhi::NativeWindow window;
+    window.width = size;
+    window.height = size;
+    auto channel = [](uint32_t pixel, int c) { return (int)((pixel >> (c * 8)) & 0xFF); };
+
+    rhi::SoftwareBackend backend(window, 1);
+    backend.render_clear(0.0f, 0.0f, 0.0f);
+    const uint32_t clear = backend.pixels()[0];
+    rhi::SoftwareMesh cube = backend.create_mesh(create_cube());
+    EXPECT_TRUE(cube.valid());
+
+    // Framed cube covers the center, not the corners
+    backend.begin_scene(0.0f);
+    backend.frame_bounds(Vec3(0, 0, 0), 0.87f);
+    backend.draw_mesh(cube);
+    backend.end_scene();
+    const size_t center = (size / 2) * size + size / 2;
+    EXPECT_TRUE(backend.pixels()[center] != clear);
+    EXPECT_TRUE(backend.depth()[center] > 0.0f && backend.depth()[center] < 1.0f);
+    EXPECT_EQ(backend.pixels()[0], clear);
+    EXPECT_EQ(backend.depth()[size * size - 1], 1.0f);
+    EXPECT_TRUE(backend.stats().trianglesBinned > 0 && backend.stats().trianglesBinned < 12);  // back faces culled
+
+    // Depth test, not draw order, decides: the near blue cube hides the red one
+    Mesh redMesh = create_cube();
+    redMesh.baseColor[1] = redMesh.baseColor[2] = 0.0f;
+    Mesh blueMesh = create_cube();
+    blueMesh.baseColor[0] = blueMesh.baseColor[1] = 0.0f;
+    rhi::SoftwareMesh red = backend.create_mesh(redMesh);
+    rhi::SoftwareMesh blue = backend.create_mesh(blueMesh);
+    backend.set_camera(Vec3(0, 0, 4), Vec3(0, 0, 0));
+    backend.begin_scene(0.0f);
+    backend.draw_mesh(blue, Mat4::translation(Vec3(0, 0, 1)) * Mat4::scale(Vec3(0.5f, 0.5f, 0.5f)));
+    backend.draw_mesh(red, Mat4::translation(Vec3(0, 0, 0)));
+    backend.end_scene();
+    EXPECT_TRUE(channel(backend.pixels()[center], 2) > channel(backend.pixels()[center], 0));
+    EXPECT_TRUE(channel(backend.pixels()[center - 9 * size], 0) > channel(backend.pixels()[center - 9 * size], 2));  // red rim
+
+    // Material params override the mesh material
+    backend.bind_material_params({{"baseColor", "0 1 0"}});
+    backend.begin_scene(0.0f);
+    backend.draw_mesh(red);
+    backend.end_scene();
+    backend.bind_material_params({});
+    EXPECT_TRUE(channel(backend.pixels()[center], 1) > channel(backend.pixels()[center], 0));
+
+    // A quad split into two triangles covers every pixel exactly once (no
+    // cracks along the shared edge), and near-plane clipping keeps a camera
+    // inside a cube fully enclosed
+    Mesh quad;
+    quad.vertices = {
+        {{-4, -4, 0}, {0, 0, 1}, {1, 0, 0, 1}, {0, 0}, {1, 1, 1}},
+        {{4, -4, 0}, {0, 0, 1}, {1, 0, 0, 1}, {1, 0}, {1, 1, 1}},
+        {{4, 4, 0}, {0, 0, 1}, {1, 0, 0, 1}, {1, 1}, {1, 1, 1}},
+        {{-4, 4, 0}, {0, 0, 1}, {1, 0, 0, 1}, {0, 1}, {1, 1, 1}},
+    };
+    quad.indices = {0, 1, 2, 2, 3, 0};
+    rhi::SoftwareMesh quadMesh = backend.create_mesh(quad);
+    backend.set_camera(Vec3(0.13f, -0.07f, 2), Vec3(0.13f, -0.07f, 0));
+    backend.begin_scene(0.0f);
+    backend.draw_mesh(quadMesh, Mat4::identity());
+    backend.end_scene();
+    EXPECT_EQ(backend.stats().pixelsShaded, (uint64_t)size * size);
+
+    backend.set_cull_back_faces(false);
+    backend.set_camera(Vec3(0, 0, 0.45f), Vec3(0, 0, -1), 1.5f, 0.1f, 10.0f);
+    backend.begin_scene(0.0f);
+    backend.draw_mesh(cube, Mat4::identity());
+    backend.end_scene();
+    EXPECT_EQ(backend.stats().pixelsShaded, (uint64_t)size * size);
+    backend.set_cull_back_faces(true);
+
+    // Identical output for any thread count and tile split
+    Mesh cylinder = create_cylinder(0.3f, 1.2f, 48);
+    auto render = [&](int threads, std::vector<uint8_t>& out) {
+        rhi::NativeWindow wide;
+        wide.width = 150;
+        wide.height = 97;
+        rhi::SoftwareBackend b(wide, threads);
+        rhi::SoftwareMesh c = b.create_mesh(create_cube());
+        rhi::SoftwareMesh cyl = b.create_mesh(cylinder);
+        b.begin_scene(0.7f);
+        b.frame_bounds(Vec3(0, 0, 0), 1.0f);
+        b.draw_mesh(c);
+        b.draw_mesh(cyl, Mat4::translation(Vec3(0.4f, 0.1f, 0.3f)));
+        b.end_scene();
+        b.read_pixels(out);
+    };
+    std::vector<uint8_t> single, multi;
+    render(1, single);
+    render(3, multi);
+    EXPECT_EQ(single.size(), (size_t)150 * 97 * 4);
+    EXPECT_TRUE(single == multi);
+    return true;
+}
+
+// Right-handed GL-style projection looking down -Z from the origin
+inline Mat4 cullTestViewProj(float fovY, float nearZ, float farZ) {
+    Mat4 proj;
+    float f = 1.0f / std::tan(fovY * 0.5f);
+    proj.m[0] = f;
+    proj.m[5] = f;
+    proj.m[10] = (farZ + nearZ) / (nearZ - farZ);
+    proj.m[11] = -1.0f;
+    proj.m[14] = 2.0f * farZ * nearZ / (nearZ - farZ);
+    proj.m[15] = 0.0f;
+    return proj;
+}
+
+inline bool testSceneCuller() {
+    const Mat4 viewProj = cullTestViewProj(1.5707963f, 0.1f, 100.0f);
+    Frustum frustum;
+    frustum.extractFromMatrix(viewProj);
+    auto boxVisible = [&](const Vec3& lo, const Vec3& hi) {
+        if (!frustum.containsSphere(BoundingSphere::fromMinMax(lo, hi))) return false;
+        for (const Plane& plane : frustum.planes) {
+            Vec3 corner(plane.normal.x >= 0 ? hi.x : lo.x, plane.normal.y >= 0 ? hi.y : lo.y,
+                        plane.normal.z >= 0 ? hi.z : lo.z);
+            if (plane.distanceToPoint(corner) < 0.0f) return false;
+        }
+        return true;
+    };
+
+    // BVH + SIMD result matches a brute-force test, for any thread count
+    std::vector<Vec3> lows;
+    uint32_t seed = 12345;
+    auto random = [&]() { seed = seed * 1664525u + 1013904223u; return (float)(seed >> 8) / 16777216.0f; };
+    for (int i = 0; i < 3000; i++) {
+        lows.push_back(Vec3(random() * 240 - 120, random() * 240 - 120, random() * 240 - 160));
+    }
+    const Vec3 extent(1.5f, 1.0f, 2.0f);
+    std::vector<SceneCuller::Handle> expected, single, pooled;
+    SceneCuller culler(1), threaded(3);
+    for (const Vec3& lo : lows) {
+        culler.add(lo, lo + extent);
+        threaded.add(lo, lo + extent);
+    }
+    for (size_t i = 0; i < lows.size(); i++) {
+        if (boxVisible(lows[i], lows[i] + extent)) expected.push_back((SceneCuller::Handle)i);
+    }
+    CullResult result = culler.cull(viewProj, single);
+    threaded.cull(viewProj, pooled);
+    EXPECT_TRUE(culler.stats().rebuilt);
+    EXPECT_EQ(result.totalObjects, lows.size());
+    EXPECT_EQ(result.visibleObjects, expected.size());
+    EXPECT_TRUE(single == pooled);
+    std::sort(single.begin(), single.end());
+    EXPECT_TRUE(single == expected);
+    EXPECT_TRUE(culler.stats().objectsTested < lows.size());  // hierarchical rejection
+    for (SceneCuller::Handle h : expected) EXPECT_TRUE(culler.wasVisible(h));
+
+    // Incremental edits: refit on move, pending adds, removals
+    SceneCuller::Handle moved = expected.front();
+    culler.update(moved, Vec3(0, 0, 150), Vec3(1, 1, 151));  // behind the camera
+    SceneCuller::Handle added = culler.add(Vec3(-1, -1, -30), Vec3(1, 1, -28));
+    SceneCuller::Handle removed = expected.back();
+    culler.remove(removed);
+    culler.cull(viewProj, single);
+    EXPECT_TRUE(culler.stats().refitted);
+    EXPECT_FALSE(culler.stats().rebuilt);
+    EXPECT_FALSE(culler.wasVisible(moved));
+    EXPECT_FALSE(culler.wasVisible(removed));
+    EXPECT_TRUE(culler.wasVisible(added));
+    EXPECT_EQ(single.size(), expected.size() - 1);
+    culler.rebuild();
+    culler.cull(viewProj, pooled);
+    EXPECT_TRUE(culler.stats().rebuilt);
+    std::sort(single.begin(), single.end());
+    std::sort(pooled.begin(), pooled.end());
+    EXPECT_TRUE(single == pooled);
+
+    // Occlusion: a solid wall hides what is behind it, not what is beside
+    // or in front of it
+    SceneCuller scene(2);
+    SceneCuller::Handle wall = scene.add(Vec3(-5, -5, -10.5f), Vec3(5, 5, -10));
+    SceneCuller::Handle hidden = scene.add(Vec3(-0.5f, -0.5f, -20.5f), Vec3(0.5f, 0.5f, -19.5f));
+    SceneCuller::Handle beside = scene.add(Vec3(14.5f, -0.5f, -20.5f), Vec3(15.5f, 0.5f, -19.5f));
+    SceneCuller::Handle front = scene.add(Vec3(-0.5f, -0.5f, -5.5f), Vec3(0.5f, 0.5f, -4.5f));
+    SceneCuller::Handle straddle = scene.add(Vec3(9, -0.5f, -20.5f), Vec3(11, 0.5f, -19.5f));
+    scene.setOccluder(wall, true);
+    scene.setOcclusionEnabled(true);
+    scene.setOcclusionResolution(100, 60);
+    EXPECT_EQ(scene.occlusionWidth(), 104u);
+    std::vector<SceneCuller::Handle> visible;
+    result = scene.cull(viewProj, visible);
+    EXPECT_EQ(result.visibleObjects, (size_t)4);
+    EXPECT_EQ(scene.stats().occlusionCulled, (size_t)1);
+    EXPECT_FALSE(scene.wasVisible(hidden));
+    EXPECT_TRUE(scene.wasVisible(wall));
+    EXPECT_TRUE(scene.wasVisible(beside));
+    EXPECT_TRUE(scene.wasVisible(front));
+    EXPECT_TRUE(scene.wasVisible(straddle));
+    EXPECT_TRUE(scene.occlusionDepth()[30 * 104 + 52] < 1.0f);
+    EXPECT_TRUE(scene.occlusionDepth()[0] > 1.0f);
+    scene.setOccluder(wall, false);
+    scene.cull(viewProj, visible);
+    EXPECT_TRUE(scene.wasVisible(hidden));
+
+    // Occlusion query results are looked up by id
+    OcclusionCuller occlusion;
+    occlusion.setPixelThreshold(4);
+    occlusion.processResults({{7, true, 10}, {9, true, 2}, {11, false, 50}, {13, true, 4}});
+    EXPECT_EQ(occlusion.getVisibleCount(), (size_t)2);
+    EXPECT_TRUE(occlusion.wasVisible(7));
+    EXPECT_TRUE(occlusion.wasVisible(13));
+    EXPECT_FALSE(occlusion.wasVisible(9));
+    EXPECT_FALSE(occlusion.wasVisible(11));
+    return true;
+}
+
 }  // namespace RenderingTests
 
 // ===== IK Tests =====
@@ -717,6 +1087,2849 @@ inline bool testTimelineMarkers() {
 
 }  // namespace TimelineTests
 
+// ===== Util Tests =====
+namespace UtilTests {
+
+inline bool testFileWatcherBatching() {
+    auto dir = std::filesystem::temp_directory_path() / "luma_test_filewatcher";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir / "sub");
+    std::string file = (dir / "a.txt").string();
+    std::ofstream(file) << "a";
+    
+    FileWatcher watcher;
+    watcher.setDebounceTime(std::chrono::milliseconds(0));
+    
+    int fileEvents = 0;
+    std::vector<std::string> dirEvents;
+    size_t batches = 0;
+    watcher.watchFile(file, [&](const std::string&) { fileEvents++; });
+    watcher.watchDirectory((dir / "sub").string(), [&](const std::string& p) { dirEvents.push_back(p); });
+    watcher.setBatchCallback([&](const std::vector<std::string>&) { batches++; });
+    
+    EXPECT_FALSE(watcher.checkChanges());
+    
+    // Several writes to the same file coalesce into one delivery
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    for (int i = 0; i < 3; i++) {
+        std::ofstream(file, std::ios::app) << i;
+    }
+    std::ofstream((dir / "sub" / "b.txt").string()) << "b";
+    
+    EXPECT_TRUE(watcher.checkChanges());
+    EXPECT_EQ(fileEvents, 1);
+    EXPECT_EQ(dirEvents.size(), 1u);
+    EXPECT_EQ(batches, 1u);
+    
+    watcher.unwatchAll();
+    std::filesystem::remove_all(dir);
+    return true;
+}
+
+// Deletions are reported the same way by both backends, and a watched
+// directory that is deleted and recreated keeps being watched
+inline bool testFileWatcherDeleteRecreate() {
+    auto root = std::filesystem::temp_directory_path() / "luma_test_filewatcher_rearm";
+    for (int polling = 0; polling < 2; polling++) {
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(root / "assets");
+        std::filesystem::create_directories(root / "shaders");
+        std::string texture = (root / "assets" / "a.png").string();
+        std::string shader = (root / "shaders" / "s.glsl").string();
+        std::ofstream(texture) << "a";
+        std::ofstream(shader) << "s";
+        
+        FileWatcher watcher;
+        watcher.setForcePolling(polling != 0);
+        watcher.setDebounceTime(std::chrono::milliseconds(0));
+        int fileEvents = 0;
+        std::vector<std::string> dirEvents;
+        watcher.watchFile(texture, [&](const std::string&) { fileEvents++; });
+        watcher.watchDirectory((root / "shaders").string(), [&](const std::string& p) { dirEvents.push_back(p); });
+        EXPECT_FALSE(watcher.checkChanges());
+        
+        // Deleting a file in a watched directory is reported
+        std::filesystem::remove(shader);
+        EXPECT_TRUE(watcher.checkChanges());
+        EXPECT_EQ(dirEvents.size(), 1u);
+        EXPECT_TRUE(dirEvents[0] == shader);
+        
+        // Deleting the watched file's directory reports nothing to the file callback...
+        std::filesystem::remove_all(root / "assets");
+        watcher.checkChanges();
+        EXPECT_EQ(fileEvents, 0);
+        
+        // ...and recreating it is picked up again
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::filesystem::create_directories(root / "assets");
+        watcher.checkChanges();
+        std::ofstream(texture) << "b";
+        watcher.checkChanges();
+        EXPECT_EQ(fileEvents, 1);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::ofstream(texture, std::ios::app) << "c";
+        EXPECT_TRUE(watcher.checkChanges());
+        EXPECT_EQ(fileEvents, 2);
+        
+        watcher.unwatchAll();
+    }
+    std::filesystem::remove_all(root);
+    return true;
+}
+
+// Events lost to an inotify queue overflow are recovered by diffing the
+// watched directory against its snapshot
+inline bool testFileWatcherOverflow() {
+    auto dir = std::filesystem::temp_directory_path() / "luma_test_filewatcher_overflow";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::string stable = (dir / "stable.txt").string();
+    std::ofstream(stable) << "s";
+    
+    FileWatcher watcher;
+    if (watcher.getBackend() != FileWatcher::Backend::Inotify) {
+        std::filesystem::remove_all(dir);
+        return true;
+    }
+    watcher.setDebounceTime(std::chrono::milliseconds(0));
+    std::unordered_set<std::string> dirEvents;
+    watcher.watchDirectory(dir.string(), [&](const std::string& p) { dirEvents.insert(p); });
+    
+    // More events than the default kernel queue (16384) holds
+    std::string noise[2] = {(dir / "noise0.txt").string(), (dir / "noise1.txt").string()};
+    for (int i = 0; i < 12000; i++) {
+        std::ofstream(noise[i % 2], std::ios::app) << 'n';
+    }
+    std::string late = (dir / "late.txt").string();
+    std::ofstream(late) << "l";
+    
+    watcher.checkChanges();
+    EXPECT_TRUE(dirEvents.count(late) == 1);
+    EXPECT_TRUE(dirEvents.count(noise[0]) == 1 && dirEvents.count(noise[1]) == 1);
+    EXPECT_TRUE(dirEvents.count(stable) == 0);
+    
+    watcher.unwatchAll();
+    std::filesystem::remove_all(dir);
+    return true;
+}
+
+class CaptureLogSink : public LogSink {
+public:
+    std::vector<std::string> lines;
+    void write(const LogRecord&, std::string_view line) override { lines.emplace_back(line); }
+};
+
+inline bool testAsyncLogger() {
+    Logger& logger = Logger::get();
+    auto capture = std::make_shared<CaptureLogSink>();
+    logger.flush();
+    logger.clearSinks();
+    logger.addSink(capture);
+    logger.setCategoryLevel(LogCategory::Audio, LogLevel::Error);
+    
+    LUMA_LOG_INFO(LogCategory::Asset, "Loaded {} ({} meshes, {} ms, ok={})", std::string("hero.fbx"), 3, 1.5, true);
+    LUMA_LOG_INFO(LogCategory::Audio, "filtered {}", 1);
+    LUMA_LOG_ERROR(LogCategory::Audio, "device lost");
+    // Longer than a ring slot holds: goes through the heap, not truncated
+    std::string longMessage(LogRecord::kPayloadSize * 3, 'x');
+    longMessage += "end";
+    log_info(longMessage);
+    std::thread([]() { LUMA_LOG_INFO(LogCategory::General, "from worker"); }).join();
+    logger.flush();
+    
+    logger.clearSinks();
+    logger.addSink(std::make_shared<ConsoleLogSink>());
+    logger.setCategoryLevel(LogCategory::Audio, LogLevel::Info);
+    
+    EXPECT_EQ(capture->lines.size(), 4u);
+    EXPECT_TRUE(capture->lines[0].find("[info][asset] Loaded hero.fbx (3 meshes, 1.5 ms, ok=true)") != std::string::npos);
+    EXPECT_TRUE(capture->lines[1].find("[error][audio] device lost") != std::string::npos);
+    EXPECT_TRUE(capture->lines[2].size() > longMessage.size());
+    EXPECT_TRUE(capture->lines[2].compare(capture->lines[2].size() - longMessage.size(), longMessage.size(), longMessage) == 0);
+    
+    // Lines carry the producing thread
+    auto threadTag = [](const std::string& line) {
+        size_t start = line.find("][t") + 2;
+        return line.substr(start, line.find(']', start) - start);
+    };
+    EXPECT_TRUE(threadTag(capture->lines[0]) == threadTag(capture->lines[1]));
+    EXPECT_TRUE(threadTag(capture->lines[0]) != threadTag(capture->lines[3]));
+    return true;
+}
+
+}  // namespace UtilTests
+
+// ===== Asset Tests =====
+namespace AssetTests {
+
+inline TextureData makeSolidTexture(int size, uint8_t value) {
+    TextureData tex;
+    tex.width = size;
+    tex.height = size;
+    tex.channels = 4;
+    tex.pixels.assign(static_cast<size_t>(size) * size * 4, value);
+    return tex;
+}
+
+inline bool testTextureCacheDedup() {
+    TextureCache& cache = getTextureCache();
+    cache.resetStats();
+    
+    // Identical encoded payloads decode once
+    std::vector<uint8_t> encoded = {0x89, 'P', 'N', 'G', 1, 2, 3, 4};
+    int decodes = 0;
+    auto decoder = [&]() { decodes++; return makeSolidTexture(16, 7); };
+    TextureHandle a = cache.getOrLoadMemory(encoded.data(), encoded.size(), decoder);
+    TextureHandle b = cache.getOrLoadMemory(encoded.data(), encoded.size(), decoder);
+    EXPECT_TRUE(hasPixels(a));
+    EXPECT_TRUE(a == b);
+    EXPECT_EQ(decodes, 1);
+    
+    // Identical decoded pixels share one copy, different pixels do not
+    TextureHandle c = cache.insert(makeSolidTexture(8, 1));
+    TextureHandle d = cache.insert(makeSolidTexture(8, 1));
+    TextureHandle e = cache.insert(makeSolidTexture(8, 2));
+    EXPECT_TRUE(c == d);
+    EXPECT_TRUE(c != e);
+    
+    // Same bytes laid out differently are a different texture
+    TextureData wide = makeSolidTexture(8, 1);
+    wide.width = 16;
+    wide.height = 4;
+    EXPECT_TRUE(cache.insert(std::move(wide)) != c);
+    
+    TextureCacheStats stats = cache.getStats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.bytesSaved, 16u * 16 * 4 + 8u * 8 * 4);
+    
+    // Processed pixels are keyed the same way, layout included
+    TextureData square = makeSolidTexture(8, 3);
+    TextureData strip = square;
+    strip.width = 16;
+    strip.height = 4;
+    int cooks = 0;
+    auto cook = [&]() { cooks++; return makeSolidTexture(4, 3); };
+    TextureHandle f = cache.getOrLoadPixels(square, cook, "cooked");
+    EXPECT_TRUE(cache.getOrLoadPixels(square, cook, "cooked") == f);
+    EXPECT_TRUE(cache.getOrLoadPixels(strip, cook, "cooked") != f);
+    EXPECT_EQ(cooks, 2);
+    EXPECT_TRUE(TextureCache::hashPixels(square) != TextureCache::hashPixels(strip));
+    
+    // Entries do not keep textures alive
+    a.reset(); b.reset();
+    cache.collectGarbage();
+    decodes = 0;
+    cache.getOrLoadMemory(encoded.data(), encoded.size(), decoder);
+    EXPECT_EQ(decodes, 1);
+    
+    // Invalidated files decode again; handles already given out stay valid
+    std::string path = (std::filesystem::temp_directory_path() / "luma_test_cache.png").string();
+    decodes = 0;
+    TextureHandle raw = cache.getOrLoadFile(path, decoder);
+    TextureHandle cooked = cache.getOrLoadFile(path, decoder, "cooked");
+    EXPECT_EQ(cache.invalidateFile(path), 2u);
+    EXPECT_TRUE(cache.findFile(path) == nullptr);
+    EXPECT_TRUE(cache.getOrLoadFile(path, decoder) != raw);
+    EXPECT_EQ(decodes, 3);
+    EXPECT_TRUE(hasPixels(raw) && hasPixels(cooked));
+    return true;
+}
+
+inline bool testTextureCooking() {
+    // Non power of two chains go down to 1x1
+    std::vector<uint8_t> odd(13 * 7 * 4, 128);
+    auto chain = generateMipChain(odd.data(), 13, 7, TextureRole::Generic);
+    EXPECT_EQ(chain.size(), 4u);
+    EXPECT_EQ(chain[1].width, 6);
+    EXPECT_EQ(chain[3].width, 1);
+    EXPECT_EQ(chain[3].height, 1);
+    
+    // Albedo is averaged in linear space: black/white -> sRGB ~188, not 128
+    std::vector<uint8_t> checker = {0, 0, 0, 255,  255, 255, 255, 255,
+                                    255, 255, 255, 255,  0, 0, 0, 255};
+    auto albedo = generateMipChain(checker.data(), 2, 2, TextureRole::Albedo);
+    EXPECT_NEAR(albedo[1].data[0], 188, 1);
+    EXPECT_EQ(albedo[1].data[3], 255);
+    
+    // Block formats round trip a gradient with acceptable loss (2D gradients
+    // inside one block are the worst case for single-line endpoints)
+    const int size = 32;
+    std::vector<uint8_t> image(size * size * 4);
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            uint8_t* p = &image[(y * size + x) * 4];
+            p[0] = static_cast<uint8_t>(x * 8);
+            p[1] = static_cast<uint8_t>(y * 8);
+            p[2] = static_cast<uint8_t>(255 - x * 4);
+            p[3] = static_cast<uint8_t>(128 + y * 4);
+        }
+    }
+    const TextureFormat formats[] = {TextureFormat::BC1, TextureFormat::BC3, TextureFormat::BC5, TextureFormat::BC7};
+    for (TextureFormat format : formats) {
+        auto blocks = compressTextureLevel(image.data(), size, size, format);
+        EXPECT_EQ(blocks.size(), textureLevelSize(format, size, size));
+        auto decoded = decompressTextureLevel(blocks.data(), size, size, format);
+        int channels = format == TextureFormat::BC5 ? 2 : 3;
+        EXPECT_TRUE(computePSNR(image.data(), decoded.data(), size * size, channels) > 30.0);
+    }
+    
+    // Cooked cache round trip
+    CookedTextureCache cache((std::filesystem::temp_directory_path() / "luma_test_cooked").string());
+    TextureData source;
+    source.width = size;
+    source.height = size;
+    source.pixels = image;
+    TextureCookSettings settings;
+    settings.compress = true;
+    TextureData cooked = cookTexture(source, TextureRole::Albedo, settings);
+    EXPECT_EQ(cooked.format, TextureFormat::BC7);
+    EXPECT_EQ(cooked.mips.size(), 6u);
+    EXPECT_TRUE(cooked.pixels.empty());
+    
+    uint64_t key = CookedTextureCache::makeKey(42, TextureRole::Albedo, settings);
+    EXPECT_TRUE(cache.store(key, cooked));
+    TextureData loaded;
+    EXPECT_TRUE(cache.load(key, loaded));
+    EXPECT_EQ(loaded.mips.size(), cooked.mips.size());
+    EXPECT_TRUE(loaded.mips.back().data == cooked.mips.back().data);
+    EXPECT_FALSE(cache.load(CookedTextureCache::makeKey(42, TextureRole::Normal, settings), loaded));
+    cache.clear();
+    
+    // RGBA8 readback for consumers without BCn: cooked levels and RGB sources
+    std::vector<uint8_t> level1 = textureLevelRGBA8(cooked, 1);
+    EXPECT_EQ(level1.size(), 16u * 16 * 4);
+    EXPECT_TRUE(textureLevelRGBA8(cooked, 6).empty());
+    TextureData rgb;
+    rgb.width = 2;
+    rgb.height = 1;
+    rgb.channels = 3;
+    rgb.pixels = {10, 20, 30, 40, 50, 60};
+    std::vector<uint8_t> expanded = textureLevelRGBA8(rgb);
+    EXPECT_EQ(expanded.size(), 8u);
+    EXPECT_EQ(expanded[4], 40);
+    EXPECT_EQ(expanded[7], 255);
+    return true;
+}
+
+inline bool testTextureStreaming() {
+    // No workers yet, so the whole queue is ordered before anything runs
+    AsyncTextureLoader loader(0);
+    loader.getCookedCache().setEnabled(false);
+    TextureCookSettings settings;
+    settings.compress = false;
+    loader.setCookSettings(settings);
+    
+    std::vector<TextureHandle> sources;
+    for (int i = 0; i < 4; i++) {
+        sources.push_back(makeTexture(makeSolidTexture(128, static_cast<uint8_t>(10 + i))));
+    }
+    uint32_t far = loader.cookTexture(sources[0], TextureRole::Albedo, texturePriority(TexturePriority::Low));
+    uint32_t hero = loader.cookTexture(sources[1], TextureRole::Albedo, texturePriority(TexturePriority::Normal));
+    uint32_t dropped = loader.cookTexture(sources[2], TextureRole::Albedo, texturePriority(TexturePriority::Normal));
+    uint32_t shared = loader.cookTexture(sources[0], TextureRole::Albedo, texturePriority(TexturePriority::Low));
+    uint32_t mid = loader.cookTexture(sources[3], TextureRole::Albedo, texturePriority(TexturePriority::Normal, 50.0f));
+    loader.updatePriority(hero, texturePriority(TexturePriority::Critical));
+    EXPECT_TRUE(loader.cancel(dropped));
+    EXPECT_EQ(loader.getPendingCount(), 3u);
+    
+    loader.setWorkerCount(1);
+    loader.waitForAll();
+    auto results = loader.getCompletedTextures();
+    EXPECT_EQ(results.size(), 4u);
+    EXPECT_EQ(results[0].id, hero);
+    EXPECT_EQ(results[1].id, mid);
+    EXPECT_TRUE((results[2].id == far && results[3].id == shared) || (results[2].id == shared && results[3].id == far));
+    EXPECT_TRUE(results[2].texture == results[3].texture);
+    for (const auto& result : results) {
+        EXPECT_TRUE(result.success);
+        EXPECT_TRUE(result.id != dropped);
+    }
+    EXPECT_FALSE(loader.cancel(hero));
+    
+    TextureStreamingStats stats = loader.getStats();
+    EXPECT_EQ(stats.coalesced, 1u);
+    EXPECT_EQ(stats.cancelled, 1u);
+    EXPECT_EQ(stats.completed, 3u);
+    EXPECT_EQ(stats.residentTextures, 4u);
+    size_t fullBytes = stats.residentBytes;
+    
+    // Over budget: the textures not used this frame lose their top mips first
+    loader.touchTexture(hero);
+    loader.setMemoryBudget(fullBytes - 1);
+    loader.update();
+    auto trims = loader.getCompletedTextures();
+    EXPECT_TRUE(!trims.empty());
+    for (const auto& trim : trims) {
+        EXPECT_TRUE(trim.id != hero);
+        EXPECT_TRUE(!trim.texture && trim.firstMip > 0);
+    }
+    stats = loader.getStats();
+    EXPECT_TRUE(stats.residentBytes < fullBytes);
+    EXPECT_TRUE(stats.mipsEvicted > 0);
+    
+    // Room again: a trimmed texture in use streams its full chain back in
+    uint32_t trimmed = trims[0].id;
+    loader.setMemoryBudget(fullBytes * 2);
+    loader.touchTexture(trimmed);
+    loader.update();
+    loader.waitForAll();
+    auto restored = loader.getCompletedTextures();
+    EXPECT_EQ(restored.size(), 1u);
+    EXPECT_EQ(restored[0].id, trimmed);
+    EXPECT_EQ(restored[0].firstMip, 0);
+    EXPECT_EQ(restored[0].texture->mips.size(), 8u);
+    EXPECT_EQ(loader.getStats().restores, 1u);
+    return true;
+}
+
+inline void writeSolidPPM(const std::string& path, int size, uint8_t value) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << "P6\n" << size << " " << size << "\n255\n";
+    std::vector<char> pixels(static_cast<size_t>(size) * size * 3, static_cast<char>(value));
+    file.write(pixels.data(), static_cast<std::streamsize>(pixels.size()));
+}
+
+inline bool testTextureHotReload() {
+    std::string path = (std::filesystem::temp_directory_path() / "luma_test_reload.ppm").string();
+    writeSolidPPM(path, 4, 40);
+    
+    // Declared first so the loader detaches before the watcher goes away
+    FileWatcher watcher;
+    watcher.setDebounceTime(std::chrono::milliseconds(0));
+    AsyncTextureLoader loader(1);
+    TextureCookSettings settings;
+    settings.generateMips = false;
+    settings.compress = false;
+    loader.setCookSettings(settings);
+    loader.setFileWatcher(&watcher);
+    
+    uint32_t id = loader.loadTexture(path);
+    loader.waitForAll();
+    auto results = loader.getCompletedTextures();
+    EXPECT_EQ(results.size(), 1u);
+    EXPECT_TRUE(results[0].success);
+    EXPECT_EQ(results[0].texture->width, 4);
+    EXPECT_EQ(watcher.getWatchCount(), 1u);
+    
+    // An edit on disk is delivered again under the same ID, at its new size
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    writeSolidPPM(path, 8, 200);
+    std::vector<TextureLoadResult> reloaded;
+    for (int i = 0; i < 200 && reloaded.empty(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        watcher.checkChanges();
+        loader.waitForAll();
+        reloaded = loader.getCompletedTextures();
+    }
+    EXPECT_EQ(reloaded.size(), 1u);
+    EXPECT_EQ(reloaded[0].id, id);
+    EXPECT_EQ(reloaded[0].texture->width, 8);
+    EXPECT_EQ(reloaded[0].texture->pixels[0], 200);
+    EXPECT_EQ(loader.getStats().residentBytes, 8u * 8 * 4);
+    
+    // A broken file keeps the current texture
+    { std::ofstream truncate(path, std::ios::trunc); }
+    EXPECT_EQ(loader.reloadFile(path), 1u);
+    loader.waitForAll();
+    EXPECT_TRUE(loader.getCompletedTextures().empty());
+    EXPECT_EQ(loader.getStats().residentBytes, 8u * 8 * 4);
+    
+    loader.releaseTexture(id);
+    EXPECT_EQ(watcher.getWatchCount(), 0u);
+    std::filesystem::remove(path);
+    return true;
+}
+
+}  // namespace AssetTests
+
+// ===== Audio Tests =====
+namespace AudioTests {
+
+// Largest deviation of the left channel from a sine of `frequency`
+inline float sineError(const std::vector<float>& interleaved, float frequency, int sampleRate, size_t skip) {
+    float maxError = 0.0f;
+    for (size_t i = skip; i < interleaved.size() / 2; i++) {
+        float expected = sinf(2.0f * 3.14159f * frequency * (float)i / sampleRate);
+        maxError = std::max(maxError, std::abs(interleaved[i * 2] - expected));
+    }
+    return maxError;
+}
+
+inline bool testResamplingMixer() {
+    AudioSystem& audio = getAudioSystem();
+    audio.initialize(44100, 2);
+    std::vector<float> out(4096 * 2);
+    
+    auto clip = audio.createClip("sine_1k");
+    clip->generateSineWave(1000.0f, 0.5f, 22050);
+    EXPECT_EQ(clip->getFrameCount(), 11025u);
+    
+    AudioSource* source = audio.createSource();
+    source->setClip(clip);
+    source->getSettings().spatialize = false;
+    source->play();
+    audio.update(0.016f);
+    
+    // 22.05 kHz clip on a 44.1 kHz device keeps its pitch
+    audio.mixAudio(out.data(), 4096);
+    EXPECT_TRUE(sineError(out, 1000.0f, 44100, 16) < 0.01f);
+    EXPECT_NEAR(out[1001], out[1000], 1e-6f);
+    
+    // Pitch is realized by the resampler
+    source->setPitch(1.5f);
+    source->play();
+    audio.update(0.016f);
+    audio.mixAudio(out.data(), 4096);
+    EXPECT_TRUE(sineError(out, 1500.0f, 44100, 16) < 0.01f);
+    
+    // Pitching 10 kHz up 3x would alias; the band-limited kernel removes it
+    auto high = audio.createClip("sine_10k");
+    high->generateSineWave(10000.0f, 0.5f, 44100);
+    source->setClip(high);
+    source->setPitch(3.0f);
+    source->play();
+    audio.update(0.016f);
+    audio.mixAudio(out.data(), 4096);
+    float energy = 0.0f;
+    for (size_t i = 64; i < 4096; i++) energy += out[i * 2] * out[i * 2];
+    EXPECT_TRUE(sqrtf(energy / 4032) < 0.005f);
+    
+    // An 8x rate drop: the cutoff follows the step, so 30 kHz would fold
+    // back into the band while 5 kHz passes
+    auto ultrasonic = audio.createClip("sine_30k");
+    ultrasonic->generateSineWave(30000.0f, 0.2f, 352800);
+    source->setClip(ultrasonic);
+    source->setPitch(1.0f);
+    source->play();
+    audio.update(0.016f);
+    audio.mixAudio(out.data(), 4096);
+    energy = 0.0f;
+    for (size_t i = 64; i < 4096; i++) energy += out[i * 2] * out[i * 2];
+    EXPECT_TRUE(sqrtf(energy / 4032) < 0.005f);
+    auto audible = audio.createClip("sine_5k");
+    audible->generateSineWave(5000.0f, 0.2f, 352800);
+    source->setClip(audible);
+    source->play();
+    audio.update(0.016f);
+    audio.mixAudio(out.data(), 4096);
+    EXPECT_TRUE(sineError(out, 5000.0f, 44100, 16) < 0.01f);
+    
+    // Non-looping voices stop at the end, looping ones wrap
+    auto blip = audio.createClip("blip");
+    blip->generateSineWave(440.0f, 0.01f, 44100);
+    source->setClip(blip);
+    source->setPitch(1.0f);
+    source->play();
+    audio.update(0.016f);
+    audio.mixAudio(out.data(), 1024);
+    audio.update(0.016f);
+    EXPECT_FALSE(source->isPlaying());
+    source->setLoop(true);
+    source->play();
+    audio.update(0.016f);
+    audio.mixAudio(out.data(), 4096);
+    audio.update(0.016f);
+    EXPECT_TRUE(source->isPlaying());
+    EXPECT_TRUE(source->getPlaybackPosition() < blip->getFrameCount());
+    
+    // Approaching sources are pitched up by Doppler
+    source->getSettings().spatialize = true;
+    source->setPosition(Vec3(0, 0, -20));
+    source->setVelocity(Vec3(0, 0, 30));
+    audio.update(0.016f);
+    EXPECT_TRUE(source->computedPitch > 1.05f);
+    
+    audio.destroySource(source);
+    audio.shutdown();
+    return true;
+}
+
+inline bool testVoiceVirtualization() {
+    AudioSystem& audio = getAudioSystem();
+    audio.initialize(48000, 2, 512, 64);
+    audio.setMaxRealVoices(4);
+    std::vector<float> out(512 * 2);
+    
+    auto clip = audio.createClip("tone");
+    clip->generateSineWave(440.0f, 1.0f, 48000);
+    
+    // Eight loud voices and one that is too quiet to hear
+    std::vector<AudioSource*> voices;
+    for (int i = 0; i < 9; i++) {
+        AudioSource* source = audio.createSource();
+        source->setClip(clip);
+        source->setLoop(true);
+        source->getSettings().spatialize = false;
+        source->getSettings().priority = i < 2 ? 0 : 128;
+        source->setVolume(i == 8 ? 0.00001f : 0.1f + i * 0.01f);
+        source->play();
+        voices.push_back(source);
+    }
+    // Commands only reach the mixer through update()
+    audio.mixAudio(out.data(), 512);
+    EXPECT_NEAR(out[200], 0.0f, 1e-6f);
+    audio.update(0.016f);
+    
+    AudioMixStats stats = audio.getMixStats();
+    EXPECT_EQ(stats.realVoices, 4u);
+    EXPECT_EQ(stats.virtualVoices, 5u);
+    // Priority wins over loudness, then the loudest of the rest
+    EXPECT_FALSE(voices[0]->isVirtual());
+    EXPECT_FALSE(voices[1]->isVirtual());
+    EXPECT_FALSE(voices[7]->isVirtual());
+    EXPECT_FALSE(voices[6]->isVirtual());
+    EXPECT_TRUE(voices[2]->isVirtual());
+    EXPECT_TRUE(voices[8]->isVirtual());
+    
+    // Only the real voices are heard; virtual ones keep their place
+    for (int i = 0; i < 10; i++) audio.mixAudio(out.data(), 512);
+    audio.update(0.016f);
+    float expected = (0.1f + 0.11f + 0.16f + 0.17f) * sinf(2.0f * 3.14159f * 440.0f * 4864.0f / 48000.0f);
+    EXPECT_NEAR(out[512], expected, 0.01f);
+    EXPECT_EQ(voices[2]->getPlaybackPosition(), 10u * 512u);
+    EXPECT_EQ(voices[0]->getPlaybackPosition(), 10u * 512u);
+    
+    // Stopping a real voice promotes the next one
+    voices[7]->stop();
+    audio.update(0.016f);
+    EXPECT_FALSE(voices[5]->isVirtual());
+    EXPECT_EQ(audio.getMixStats().realVoices, 4u);
+    EXPECT_EQ(audio.getMixStats().buffersMixed, 11u);
+    
+    // The mix thread feeds the device side; the game thread keeps sending commands
+    audio.startMixThread(2048);
+    std::vector<float> device(256 * 2);
+    for (int i = 0; i < 200; i++) {
+        voices[i % 8]->setPitch(1.0f + (i % 5) * 0.1f);
+        if (i % 7 == 0) voices[3]->play();
+        audio.update(0.016f);
+        audio.readOutput(device.data(), 256);
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    audio.stopMixThread();
+    stats = audio.getMixStats();
+    EXPECT_TRUE(stats.buffersMixed > 11u);
+    EXPECT_TRUE(stats.avgMixUs > 0.0 && stats.deadlineUs > 0.0);
+    EXPECT_EQ(stats.commandsDeferred, 0u);
+    
+    // Finished one-shots clean up after themselves
+    auto blip = audio.createClip("blip");
+    blip->generateSineWave(440.0f, 0.005f, 48000);
+    size_t sourceCount = audio.getSources().size();
+    audio.playOneShot(blip, Vec3(0, 0, 0));
+    audio.update(0.016f);
+    audio.mixAudio(out.data(), 512);
+    audio.update(0.016f);
+    EXPECT_EQ(audio.getSources().size(), sourceCount);
+    
+    audio.shutdown();
+    return true;
+}
+
+inline bool testFinishUnderLoad() {
+    // Every voice restarted onto a short clip at once: the replaced clip, the
+    // end of the voice and the finished clip are more events than the queue holds
+    AudioSystem& audio = getAudioSystem();
+    audio.initialize(48000, 2, 512, 200);
+    audio.setMaxRealVoices(200);
+    std::vector<float> out(512 * 2);
+    
+    auto tone = audio.createClip("tone");
+    tone->generateSineWave(440.0f, 1.0f, 48000);
+    auto blip = audio.createClip("blip");
+    blip->generateSineWave(440.0f, 0.002f, 48000);
+    std::vector<AudioSource*> sources;
+    for (int i = 0; i < 200; i++) {
+        AudioSource* source = audio.createSource();
+        source->setClip(tone);
+        source->getSettings().spatialize = false;
+        source->play();
+        sources.push_back(source);
+    }
+    audio.update(0.016f);
+    audio.mixAudio(out.data(), 512);
+    
+    for (AudioSource* source : sources) {
+        source->setClip(blip);
+        source->play();
+    }
+    audio.update(0.016f);
+    audio.mixAudio(out.data(), 512);
+    audio.update(0.016f);
+    // Finishes that did not fit are sent with the next mix
+    audio.mixAudio(out.data(), 512);
+    audio.update(0.016f);
+    int playing = 0;
+    for (AudioSource* source : sources) playing += source->isPlaying() ? 1 : 0;
+    EXPECT_EQ(playing, 0);
+    
+    audio.shutdown();
+    return true;
+}
+
+// 16-bit PCM WAV with a different tone per channel
+inline void writeTestWav(const std::string& path, size_t frames, int sampleRate, int channels) {
+    std::vector<uint8_t> bytes;
+    auto put32 = [&](uint32_t v) { for (int i = 0; i < 4; i++) bytes.push_back((uint8_t)(v >> (i * 8))); };
+    auto put16 = [&](uint32_t v) { bytes.push_back((uint8_t)v); bytes.push_back((uint8_t)(v >> 8)); };
+    uint32_t dataSize = (uint32_t)(frames * channels * 2);
+    bytes.insert(bytes.end(), {'R', 'I', 'F', 'F'});
+    put32(36 + dataSize);
+    bytes.insert(bytes.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    put32(16);
+    put16(1);
+    put16(channels);
+    put32(sampleRate);
+    put32(sampleRate * channels * 2);
+    put16(channels * 2);
+    put16(16);
+    bytes.insert(bytes.end(), {'d', 'a', 't', 'a'});
+    put32(dataSize);
+    for (size_t i = 0; i < frames; i++) {
+        for (int c = 0; c < channels; c++) {
+            float t = (float)i / sampleRate;
+            put16((uint16_t)(int16_t)(sinf(2.0f * 3.14159f * (220.0f + 110.0f * c) * t) * 20000.0f));
+        }
+    }
+    std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+inline bool testStreamingClip() {
+    AudioSystem& audio = getAudioSystem();
+    audio.initialize(48000, 2, 512);
+    std::string path = (std::filesystem::temp_directory_path() / "luma_test_stream.wav").string();
+    writeTestWav(path, 44100 * 10, 44100, 2);
+    
+    auto resident = audio.loadClip("music_resident", path);
+    auto streamed = audio.loadClip("music_streamed", path, true);
+    EXPECT_TRUE(resident && streamed);
+    EXPECT_TRUE(streamed->isStreaming());
+    EXPECT_EQ(streamed->getFrameCount(), resident->getFrameCount());
+    EXPECT_EQ(resident->getResidentBytes(), 44100u * 10u * 2u * sizeof(float));
+    EXPECT_EQ(streamed->getResidentBytes(), 0u);
+    
+    // Record one clip from `seconds` on, 44.1k -> 48k through the resampler
+    AudioSource* source = audio.createSource();
+    source->getSettings().spatialize = false;
+    auto record = [&](std::shared_ptr<AudioClip> clip, float seconds, bool loop) {
+        std::vector<float> block(512 * 2), out;
+        source->setClip(clip);
+        source->setLoop(loop);
+        source->play();
+        source->setTime(seconds);
+        audio.update(0.016f);
+        for (int i = 0; i < 40; i++) {
+            audio.mixAudio(block.data(), 512);
+            audio.pumpStreams();
+            out.insert(out.end(), block.begin(), block.end());
+        }
+        return out;
+    };
+    auto maxDifference = [](const std::vector<float>& a, const std::vector<float>& b) {
+        float diff = 0.0f;
+        for (size_t i = 0; i < a.size(); i++) diff = std::max(diff, std::abs(a[i] - b[i]));
+        return diff;
+    };
+    
+    // Streaming plays the same samples from a seek point...
+    auto expected = record(resident, 2.5f, false);
+    auto actual = record(streamed, 2.5f, false);
+    EXPECT_TRUE(maxDifference(expected, std::vector<float>(expected.size())) > 0.5f);
+    EXPECT_TRUE(maxDifference(expected, actual) < 1e-6f);
+    EXPECT_TRUE(streamed->getResidentBytes() <= AudioStream::kRingFrames * 2 * sizeof(float));
+    EXPECT_TRUE(streamed->getResidentBytes() * 20 < resident->getResidentBytes());
+    
+    // ...and across the loop point without a seam
+    expected = record(resident, 9.8f, true);
+    actual = record(streamed, 9.8f, true);
+    EXPECT_TRUE(maxDifference(expected, actual) < 1e-6f);
+    audio.update(0.016f);
+    EXPECT_TRUE(source->isPlaying());
+    EXPECT_TRUE(source->getTime() < 1.0f);
+    EXPECT_EQ(streamed->getStreamUnderruns(), 0u);
+    std::vector<float> block(512 * 2);
+    
+    // A seek while playing lands, and the replaced stream is handed back
+    source->setTime(5.0f);
+    audio.update(0.016f);
+    for (int i = 0; i < 4; i++) {
+        audio.mixAudio(block.data(), 512);
+        audio.pumpStreams();
+    }
+    audio.update(0.016f);
+    audio.pumpStreams();
+    EXPECT_NEAR(source->getTime(), 5.0f + 4 * 512 / 48000.0f, 0.01f);
+    EXPECT_EQ(audio.getActiveStreamCount(), 1u);
+    
+    // Stopping hands the ring back
+    source->stop();
+    audio.update(0.016f);
+    audio.mixAudio(block.data(), 512);
+    audio.update(0.016f);
+    audio.pumpStreams();
+    EXPECT_EQ(streamed->getResidentBytes(), 0u);
+    EXPECT_EQ(audio.getActiveStreamCount(), 0u);
+    
+    audio.shutdown();
+    std::filesystem::remove(path);
+    return true;
+}
+
+inline bool testSpectrumAnalysis() {
+    // Real FFT against a direct DFT, and back
+    constexpr size_t N = 64;
+    std::vector<float> signal(N), re(N / 2 + 1), im(N / 2 + 1), back(N);
+    for (size_t i = 0; i < N; i++) signal[i] = sinf(i * 0.37f) + 0.5f * cosf(i * 1.9f) + (i % 5) * 0.1f;
+    dsp::RealFFT fft(N);
+    fft.forward(signal.data(), re.data(), im.data());
+    float maxError = 0.0f;
+    for (size_t k = 0; k <= N / 2; k++) {
+        double sr = 0.0, si = 0.0;
+        for (size_t n = 0; n < N; n++) {
+            sr += signal[n] * cos(-2.0 * 3.14159265358979 * k * n / N);
+            si += signal[n] * sin(-2.0 * 3.14159265358979 * k * n / N);
+        }
+        maxError = std::max({maxError, std::abs(re[k] - (float)sr), std::abs(im[k] - (float)si)});
+    }
+    EXPECT_TRUE(maxError < 1e-3f);
+    fft.inverse(re.data(), im.data(), back.data());
+    for (size_t i = 0; i < N; i++) EXPECT_NEAR(back[i], signal[i], 1e-4f);
+    
+    // Octave bands hold real band energy: a 1 kHz tone lands in 800-1600 Hz
+    const float rate = 44100.0f;
+    std::vector<float> tone(1470);
+    for (size_t i = 0; i < tone.size(); i++) tone[i] = 0.5f * sinf(2.0f * 3.14159265f * 1000.0f * i / rate);
+    AudioAnalyzer analyzer;
+    AudioFrame frame = analyzer.analyze(tone.data(), (int)tone.size(), rate, 0.0f);
+    int peak = (int)(std::max_element(frame.spectrum.begin(), frame.spectrum.end()) - frame.spectrum.begin());
+    EXPECT_EQ(peak, 3);
+    EXPECT_NEAR(frame.spectrum[3], frame.amplitude, 0.05f);
+    EXPECT_TRUE(frame.spectrum[0] < frame.spectrum[3] * 0.05f);
+    EXPECT_NEAR(frame.spectralCentroid, 1000.0f, 100.0f);
+    
+    // Pitch from the FFT autocorrelation
+    for (size_t i = 0; i < tone.size(); i++) tone[i] = sinf(2.0f * 3.14159265f * 220.0f * i / rate);
+    frame = analyzer.analyze(tone.data(), (int)tone.size(), rate, 0.0f);
+    EXPECT_NEAR(frame.pitch, 220.0f, 5.0f);
+    
+    // Mel bands rise with frequency
+    auto mel = dsp::FilterBank::mel(24, 1024, rate, 80.0f, 8000.0f);
+    std::vector<float> power(513, 0.0f), bands(24);
+    power[(size_t)(500.0f / rate * 1024)] = 1.0f;
+    mel.apply(power.data(), bands.data());
+    int low = (int)(std::max_element(bands.begin(), bands.end()) - bands.begin());
+    std::fill(power.begin(), power.end(), 0.0f);
+    power[(size_t)(4000.0f / rate * 1024)] = 1.0f;
+    mel.apply(power.data(), bands.data());
+    int high = (int)(std::max_element(bands.begin(), bands.end()) - bands.begin());
+    EXPECT_TRUE(low < high);
+    
+    // Live blocks of any size give the same frames as whole windows
+    std::vector<float> speech((size_t)rate);
+    for (size_t i = 0; i < speech.size(); i++) {
+        float envelope = 0.5f + 0.5f * sinf(i * 0.0005f);
+        speech[i] = envelope * (sinf(i * 0.031f) + 0.3f * sinf(i * 0.27f));
+    }
+    StreamingAudioAnalyzer live(rate, 1024, 441);
+    std::vector<AudioFrame> frames;
+    for (size_t at = 0; at < speech.size(); at += 137) {
+        live.push(speech.data() + at, std::min<size_t>(137, speech.size() - at), frames);
+    }
+    EXPECT_EQ(frames.size(), (speech.size() - 1024) / 441 + 1);
+    EXPECT_NEAR(frames[10].timestamp, 4410.0f / rate, 1e-5f);
+    AudioFrame direct = analyzer.analyze(speech.data() + 4410, 1024, rate, 0.0f);
+    EXPECT_NEAR(frames[10].amplitude, direct.amplitude, 1e-5f);
+    EXPECT_NEAR(frames[10].spectrum[2], direct.spectrum[2], 1e-5f);
+    EXPECT_TRUE(live.getLatency() <= 1024 / rate + 1e-6f);
+    
+    // Offline generation gives the same track on any number of threads
+    std::vector<float> recording;
+    for (int i = 0; i < 8; i++) recording.insert(recording.end(), speech.begin(), speech.end());
+    LipSyncGenerator generator;
+    LipSyncTrack serial = generator.generate(recording.data(), (int)recording.size(), rate, {}, 1);
+    LipSyncTrack parallel = generator.generate(recording.data(), (int)recording.size(), rate, {}, 4);
+    EXPECT_TRUE(serial.keyframes.size() > 10);
+    EXPECT_EQ(serial.keyframes.size(), parallel.keyframes.size());
+    bool same = true;
+    for (size_t i = 0; i < serial.keyframes.size() && i < parallel.keyframes.size(); i++) {
+        same &= serial.keyframes[i].viseme == parallel.keyframes[i].viseme &&
+                serial.keyframes[i].weight == parallel.keyframes[i].weight;
+    }
+    EXPECT_TRUE(same);
+    return true;
+}
+
+}  // namespace AudioTests
+
+// ===== AI Tests =====
+namespace AITests {
+
+inline bool testTensorRuntime() {
+    uint32_t seed = 11;
+    auto random = [&](size_t count, float scale) {
+        std::vector<float> values(count);
+        for (float& v : values) {
+            seed = seed * 1664525u + 1013904223u;
+            v = ((float)(seed >> 8) / 16777216.0f - 0.5f) * scale;
+        }
+        return values;
+    };
+    // Direct convolution (groups == channels for depthwise), ReLU applied
+    auto reference = [](const std::vector<float>& in, nn::Shape s, int outC, int k, int stride, int pad,
+                        const std::vector<float>& w, const std::vector<float>& b, int groups) {
+        int oh = (s.h + 2 * pad - k) / stride + 1, ow = (s.w + 2 * pad - k) / stride + 1;
+        int perGroup = s.c / groups;
+        std::vector<float> out((size_t)outC * oh * ow);
+        for (int o = 0; o < outC; o++) {
+            int g = o / (outC / groups);
+            for (int y = 0; y < oh; y++) {
+                for (int x = 0; x < ow; x++) {
+                    float acc = b[o];
+                    for (int c = 0; c < perGroup; c++) {
+                        for (int ky = 0; ky < k; ky++) {
+                            for (int kx = 0; kx < k; kx++) {
+                                int iy = y * stride - pad + ky, ix = x * stride - pad + kx;
+                                if (iy < 0 || iy >= s.h || ix < 0 || ix >= s.w) continue;
+                                acc += w[((o * perGroup + c) * k + ky) * k + kx] *
+                                       in[((g * perGroup + c) * s.h + iy) * s.w + ix];
+                            }
+                        }
+                    }
+                    out[(o * oh + y) * ow + x] = std::max(acc, 0.0f);
+                }
+            }
+        }
+        return out;
+    };
+    
+    // Odd sizes so every kernel hits its tail paths
+    nn::Shape shape{5, 21, 19};
+    std::vector<float> input = random(shape.size(), 2.0f);
+    std::vector<float> convW = random(9 * 5 * 9, 0.5f), convB = random(9, 0.2f);
+    std::vector<float> dwW = random(5 * 9, 0.5f), dwB = random(5, 0.2f);
+    std::vector<float> denseW = random(10 * 6 * 11 * 10, 0.1f);
+    
+    nn::Graph graph;
+    int x = graph.input(shape);
+    int conv = graph.conv(x, 9, 3, 2, 1, convW, convB, nn::Activation::ReLU);
+    int dw = graph.depthwise(x, 3, 1, 1, dwW, dwB, nn::Activation::ReLU);
+    int pointwise = graph.conv(dw, 6, 1, 1, 0, random(6 * 5, 0.5f));
+    int pooled = graph.maxPool(conv, 2, 2);
+    int dense = graph.dense(graph.conv(conv, 6, 1, 1, 0, random(6 * 9, 0.5f)), 10, denseW);
+    graph.output(conv);
+    graph.output(dw);
+    graph.output(dense);
+    EXPECT_TRUE(graph.valid());
+    EXPECT_TRUE(pointwise > 0 && pooled > 0);
+    EXPECT_EQ(graph.getShape(conv).h, 11);
+    EXPECT_EQ(graph.getShape(conv).w, 10);
+    
+    // Bad parameters leave the graph unusable
+    nn::Graph broken;
+    EXPECT_TRUE(broken.conv(broken.input(shape), 4, 3, 1, 1, random(10, 1.0f)) < 0);
+    EXPECT_FALSE(broken.valid());
+    EXPECT_FALSE(nn::Runtime().compile(broken));
+    
+    // A kernel larger than the padded input has no output size; stride 2 must
+    // not round (2 - 3) / 2 + 1 up to one
+    for (int op = 0; op < 3; op++) {
+        nn::Graph small;
+        int tiny = small.input(nn::Shape{1, 2, 2});
+        int result = op == 0 ? small.conv(tiny, 1, 3, 2, 0, random(9, 1.0f))
+                   : op == 1 ? small.depthwise(tiny, 3, 2, 0, random(9, 1.0f))
+                             : small.maxPool(tiny, 3, 2);
+        EXPECT_TRUE(result < 0);
+        EXPECT_FALSE(small.getError().empty());
+    }
+    
+    std::vector<float> expectConv = reference(input, shape, 9, 3, 2, 1, convW, convB, 1);
+    std::vector<float> expectDw = reference(input, shape, 5, 3, 1, 1, dwW, dwB, 5);
+    auto maxError = [](const float* a, const std::vector<float>& b) {
+        float error = 0.0f;
+        for (size_t i = 0; i < b.size(); i++) error = std::max(error, std::abs(a[i] - b[i]));
+        return error;
+    };
+    
+    // SIMD and scalar, one and several threads, agree with the reference
+    std::vector<float> denseResult;
+    for (int variant = 0; variant < 3; variant++) {
+        nn::RuntimeOptions options;
+        options.simd = variant != 1;
+        options.threads = variant == 2 ? 3 : 1;
+        nn::Runtime runtime;
+        EXPECT_TRUE(runtime.compile(graph, options));
+        EXPECT_TRUE(runtime.run(input.data()));
+        EXPECT_TRUE(maxError(runtime.getOutput(0), expectConv) < 1e-4f);
+        EXPECT_TRUE(maxError(runtime.getOutput(1), expectDw) < 1e-4f);
+        if (variant == 0) denseResult.assign(runtime.getOutput(2), runtime.getOutput(2) + 10);
+        EXPECT_TRUE(maxError(runtime.getOutput(2), denseResult) < 1e-4f);
+        
+        // Values whose lifetimes do not overlap share the arena
+        EXPECT_TRUE(runtime.getStats().arenaBytes < runtime.getStats().unsharedBytes);
+    }
+    
+    // int8 stays within a few quantization steps
+    nn::RuntimeOptions quantized;
+    quantized.int8 = true;
+    nn::Runtime runtime;
+    EXPECT_TRUE(runtime.compile(graph, quantized));
+    runtime.run(input.data());
+    EXPECT_TRUE(maxError(runtime.getOutput(0), expectConv) < 0.05f);
+    EXPECT_TRUE(maxError(runtime.getOutput(0), expectConv) > 0.0f);
+    
+    // Model file roundtrip through a session
+    auto dir = std::filesystem::temp_directory_path() / "luma_test_nn";
+    std::filesystem::create_directories(dir);
+    std::string path = (dir / "net.lnn").string();
+    EXPECT_TRUE(graph.save(path));
+    InferenceSession session;
+    session.setNumThreads(2);
+    EXPECT_TRUE(session.loadModel(path));
+    EXPECT_EQ(session.getModelInfo().name, std::string("net"));
+    EXPECT_EQ(session.getModelInfo().outputs.size(), (size_t)3);
+    std::vector<Tensor> outputs;
+    EXPECT_TRUE(session.run({Tensor::fromVector({1, 5, 21, 19}, input)}, outputs));
+    EXPECT_EQ(outputs[2].numElements(), (size_t)10);
+    EXPECT_TRUE(maxError(outputs[2].dataAs<float>(), denseResult) < 1e-4f);
+    EXPECT_FALSE(session.run({Tensor::fromVector({1, 3}, std::vector<float>(3))}, outputs));
+    
+    // Anything that is not a .lnn file is rejected with a reason
+    std::ofstream(dir / "model.onnx") << "not a network";
+    InferenceSession onnx;
+    EXPECT_FALSE(onnx.loadModel((dir / "model.onnx").string()));
+    EXPECT_FALSE(onnx.isLoaded());
+    EXPECT_FALSE(onnx.getLastError().empty());
+    std::filesystem::remove_all(dir);
+    return true;
+}
+
+}  // namespace AITests
+
+// ===== Character Tests =====
+namespace CharacterTests {
+
+inline bool testSkinDeformer() {
+    // 21 x 21 grid in the XY plane, facing +Z
+    constexpr int kGrid = 21;
+    std::vector<Vertex> base;
+    std::vector<uint32_t> indices;
+    for (int y = 0; y < kGrid; y++) {
+        for (int x = 0; x < kGrid; x++) {
+            Vertex v{};
+            v.position[0] = x * 0.1f; v.position[1] = y * 0.1f; v.position[2] = 0.0f;
+            v.normal[2] = 1.0f;
+            v.tangent[0] = 1.0f; v.tangent[3] = 1.0f;
+            v.uv[0] = x / (float)(kGrid - 1); v.uv[1] = y / (float)(kGrid - 1);
+            base.push_back(v);
+        }
+    }
+    for (int y = 0; y + 1 < kGrid; y++) {
+        for (int x = 0; x + 1 < kGrid; x++) {
+            uint32_t i = y * kGrid + x;
+            indices.insert(indices.end(), {i, i + 1, i + kGrid, i + 1, i + kGrid + 1, i + kGrid});
+        }
+    }
+
+    // Dense bulge (positions + normals) and a sparse dent (positions only)
+    BlendShapeMesh shapes;
+    BlendShapeTarget bulge("bulge");
+    for (uint32_t i = 0; i < base.size(); i++) {
+        float px = base[i].position[0] - 1.0f, py = base[i].position[1] - 1.0f;
+        bulge.addDelta(BlendShapeDelta(i, Vec3(0, 0, 0.5f * std::exp(-(px * px + py * py))), Vec3(px * 0.3f, py * 0.3f, 0)));
+    }
+    BlendShapeTarget dent("dent");
+    for (uint32_t i = 0; i < base.size(); i += 37) dent.addDelta(BlendShapeDelta(i, Vec3(0.01f, 0, -0.2f)));
+    shapes.addTarget(bulge);
+    shapes.addTarget(dent);
+    shapes.createChannelsFromTargets();
+    shapes.setWeight("bulge", 0.6f);
+    shapes.setWeight("dent", 0.3f);
+
+    SkinDeformer deformer;
+    deformer.setBaseMesh(base, indices);
+    deformer.setBlendShapes(&shapes);
+    EXPECT_TRUE(deformer.update());
+    EXPECT_TRUE(deformer.getTimings().reblended);
+    EXPECT_EQ(deformer.getActiveTargetCount(), (size_t)2);
+
+    std::vector<Vertex> expected;
+    shapes.applyToMesh(base, expected);
+    const std::vector<Vertex>& out = deformer.getOutput();
+    EXPECT_EQ(out.size(), base.size());
+    float maxError = 0.0f, maxTangentDot = 0.0f, minTangentLength = 2.0f;
+    for (size_t i = 0; i < out.size(); i++) {
+        for (int a = 0; a < 3; a++) {
+            maxError = std::max(maxError, std::abs(out[i].position[a] - expected[i].position[a]));
+            maxError = std::max(maxError, std::abs(out[i].normal[a] - expected[i].normal[a]));
+        }
+        const float* t = out[i].tangent;
+        const float* n = out[i].normal;
+        maxTangentDot = std::max(maxTangentDot, std::abs(t[0] * n[0] + t[1] * n[1] + t[2] * n[2]));
+        minTangentLength = std::min(minTangentLength, std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]));
+        EXPECT_NEAR(out[i].uv[0], base[i].uv[0], 1e-6f);
+    }
+    EXPECT_TRUE(maxError < 1e-4f);
+    EXPECT_TRUE(maxTangentDot < 1e-3f);
+    EXPECT_TRUE(minTangentLength > 0.999f);
+
+    // Same weights: nothing to do. New weight: blend again.
+    EXPECT_FALSE(deformer.update());
+    shapes.setWeight("dent", 0.0f);
+    EXPECT_TRUE(deformer.update());
+    EXPECT_EQ(deformer.getActiveTargetCount(), (size_t)1);
+    shapes.setWeight("bulge", 0.0f);
+
+    // Two bones: identity and a quarter turn about Z plus an offset
+    std::vector<SkinVertex> skinData(base.size());
+    for (size_t i = 0; i < base.size(); i++) {
+        float t = base[i].position[0] / 2.0f;
+        skinData[i].boneIndices[0] = 0; skinData[i].boneWeights[0] = 1.0f - t;
+        skinData[i].boneIndices[1] = 1; skinData[i].boneWeights[1] = t;
+    }
+    Mat4 bones[2];
+    bones[1] = Mat4::translation(Vec3(0.0f, 0.0f, 1.0f)) * Mat4::fromQuat(Quat::fromAxisAngle(Vec3(0, 0, 1), 1.5707963f));
+    deformer.setSkinWeights(skinData);
+    deformer.setBoneMatrices(bones, 2);
+    EXPECT_TRUE(deformer.update());
+    std::vector<Vertex> linear = deformer.getOutput();
+    for (size_t i = 0; i < base.size(); i++) {
+        float w = skinData[i].boneWeights[1];
+        float x = base[i].position[0], y = base[i].position[1];
+        EXPECT_NEAR(linear[i].position[0], (1 - w) * x - w * y, 1e-4f);
+        EXPECT_NEAR(linear[i].position[1], (1 - w) * y + w * x, 1e-4f);
+        EXPECT_NEAR(linear[i].position[2], w, 1e-4f);
+    }
+
+    // Rigid vertices agree between the two modes; blended ones keep their
+    // distance from the rotation axis under dual quaternions
+    deformer.setMode(SkinningMode::DualQuaternion);
+    EXPECT_TRUE(deformer.update());
+    const std::vector<Vertex>& dq = deformer.getOutput();
+    for (size_t i = 0; i < base.size(); i++) {
+        float w = skinData[i].boneWeights[1];
+        if (w < 1e-6f || w > 1.0f - 1e-6f) {
+            for (int a = 0; a < 3; a++) EXPECT_NEAR(dq[i].position[a], linear[i].position[a], 1e-4f);
+        }
+        float radius = std::sqrt(base[i].position[0] * base[i].position[0] + base[i].position[1] * base[i].position[1]);
+        EXPECT_NEAR(std::sqrt(dq[i].position[0] * dq[i].position[0] + dq[i].position[1] * dq[i].position[1]), radius, 1e-3f);
+        EXPECT_NEAR(dq[i].normal[2], 1.0f, 1e-4f);
+    }
+
+    // Batch: same results as serial updates, from several threads
+    std::vector<BlendShapeMesh> crowdShapes(6, shapes);
+    std::vector<SkinDeformer> crowd(6);
+    std::vector<std::vector<Vertex>> serial(6);
+    for (int c = 0; c < 6; c++) {
+        crowdShapes[c].setWeight("bulge", 0.1f * c);
+        crowd[c].setBaseMesh(base, indices);
+        crowd[c].setBlendShapes(&crowdShapes[c]);
+        crowd[c].setSkinWeights(skinData);
+        crowd[c].setBoneMatrices(bones, 2);
+        crowd[c].update();
+        serial[c] = crowd[c].getOutput();
+        crowd[c].setBoneMatrices(bones, 2);
+    }
+    SkinDeformerBatch batch(3);
+    std::vector<SkinDeformerBatch::Job> jobs;
+    std::vector<std::vector<Vertex>> parallel(6, std::vector<Vertex>(base.size()));
+    for (int c = 0; c < 6; c++) jobs.push_back({&crowd[c], parallel[c].data()});
+    batch.run(jobs);
+    EXPECT_EQ(batch.getStats().characters, (size_t)6);
+    EXPECT_EQ(batch.getStats().updated, (size_t)6);
+    for (int c = 0; c < 6; c++) {
+        EXPECT_TRUE(std::memcmp(parallel[c].data(), serial[c].data(), base.size() * sizeof(Vertex)) == 0);
+    }
+    return true;
+}
+
+inline bool testMakeHumanTargetPack() {
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / "luma_test_mhpack";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "targets" / "nose");
+    fs::create_directories(dir / "targets" / "macrodetails" / "Age");
+    {
+        std::ofstream(dir / "targets" / "nose" / "nose-width-incr.target")
+            << "# nose\n12 0.0125 -0.003 0.5\n40 -0.25 0.0 0.001\n\n41 0.0 0.0 0.0\n";
+        std::ofstream(dir / "targets" / "macrodetails" / "Age" / "age-old.target")
+            << "70000 1.5 2.0 -3.0\n3 0.1 0.2 0.3\n";
+        std::ofstream(dir / "targets" / "empty.target") << "# no deltas\n";
+    }
+    std::string packPath = (dir / "targets.mhpack").string();
+    std::string error;
+    size_t count = 0;
+    EXPECT_TRUE(MakeHumanTargetPack::build((dir / "targets").string(), packPath, &error, &count));
+    EXPECT_EQ(count, (size_t)2);
+
+    MakeHumanTargetPack pack;
+    EXPECT_TRUE(pack.open(packPath));
+    EXPECT_EQ(pack.getTargetCount(), (size_t)2);
+    EXPECT_TRUE(pack.getName(0) == "age-old");
+    EXPECT_TRUE(pack.getCategory(0) == "macrodetails/Age");
+    EXPECT_EQ(pack.findTarget("nose-width-incr"), 1);
+    EXPECT_EQ(pack.findTarget("missing"), -1);
+
+    // Decoded deltas match the text parser within the quantization step
+    for (const char* name : {"nose-width-incr", "age-old"}) {
+        int index = pack.findTarget(name);
+        BlendShapeTarget packed, text;
+        EXPECT_TRUE(pack.decodeTarget(name, packed));
+        fs::path source = std::string(name) == "age-old" ? dir / "targets" / "macrodetails" / "Age" / "age-old.target"
+                                                         : dir / "targets" / "nose" / "nose-width-incr.target";
+        EXPECT_TRUE(MakeHumanTargetLoader::loadTarget(source.string(), text));
+        EXPECT_EQ(packed.deltas.size(), text.deltas.size());
+        Vec3 step = pack.getQuantizationError(index);
+        for (size_t i = 0; i < text.deltas.size(); i++) {
+            EXPECT_EQ(packed.deltas[i].vertexIndex, text.deltas[i].vertexIndex);
+            EXPECT_NEAR(packed.deltas[i].positionDelta.x, text.deltas[i].positionDelta.x, step.x + 1e-7f);
+            EXPECT_NEAR(packed.deltas[i].positionDelta.y, text.deltas[i].positionDelta.y, step.y + 1e-7f);
+            EXPECT_NEAR(packed.deltas[i].positionDelta.z, text.deltas[i].positionDelta.z, step.z + 1e-7f);
+        }
+    }
+    EXPECT_EQ(pack.decodeCategory("macrodetails").size(), (size_t)1);
+    EXPECT_EQ(pack.decodeCategory("macro").size(), (size_t)0);
+    EXPECT_EQ(pack.decodeCategory("").size(), (size_t)2);
+    pack.close();
+
+    // Truncated and foreign files are rejected
+    std::string truncated = (dir / "truncated.mhpack").string();
+    {
+        std::ifstream in(packPath, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream(truncated, std::ios::binary).write(bytes.data(), bytes.size() - 10);
+    }
+    EXPECT_FALSE(pack.open(truncated));
+    EXPECT_FALSE(pack.open((dir / "targets" / "nose" / "nose-width-incr.target").string()));
+    EXPECT_FALSE(pack.getError().empty());
+
+    // Sizes and offsets chosen so that offset + size wraps around to a small value
+    auto patched = [&](size_t at, uint64_t value) {
+        std::ifstream in(packPath, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::memcpy(&bytes[at], &value, sizeof(value));
+        std::string path = (dir / "patched.mhpack").string();
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size());
+        return path;
+    };
+    uint64_t entriesOffset = 0;
+    {
+        std::ifstream in(packPath, std::ios::binary);
+        in.seekg(16);
+        in.read(reinterpret_cast<char*>(&entriesOffset), sizeof(entriesOffset));
+    }
+    EXPECT_FALSE(pack.open(patched(32, ~0ull)));                   // stringsSize
+    EXPECT_FALSE(pack.open(patched(48, ~0ull)));                   // dataSize
+    EXPECT_FALSE(pack.open(patched(entriesOffset + 24, ~0ull - 8)));  // First entry's dataOffset
+    EXPECT_TRUE(pack.open(packPath));
+
+    fs::remove_all(dir);
+    return true;
+}
+
+inline bool testAutoRigAcceleration() {
+    uint32_t seed = 12345;
+    auto rnd = [&seed](float lo, float hi) {
+        seed = seed * 1664525u + 1013904223u;
+        return lo + (hi - lo) * ((seed >> 8) / 16777216.0f);
+    };
+
+    // Capsule BVH reach/nearest queries match a linear scan
+    std::vector<CapsuleBVH::Capsule> capsules(40);
+    for (auto& c : capsules) {
+        c.start = Vec3(rnd(-1, 1), rnd(-1, 1), rnd(-1, 1));
+        c.end = c.start + Vec3(rnd(-0.3f, 0.3f), rnd(-0.3f, 0.3f), rnd(-0.3f, 0.3f));
+        c.reach = rnd(0.05f, 0.4f);
+    }
+    CapsuleBVH capsuleBvh;
+    capsuleBvh.build(capsules);
+    for (int q = 0; q < 500; q++) {
+        Vec3 p(rnd(-1.2f, 1.2f), rnd(-1.2f, 1.2f), rnd(-1.2f, 1.2f));
+        std::vector<uint32_t> found;
+        capsuleBvh.forEachInReach(p, [&](uint32_t i, float) { found.push_back(i); });
+        std::sort(found.begin(), found.end());
+        std::vector<uint32_t> expected;
+        int nearest = -1;
+        float nearestDist = FLT_MAX;
+        for (uint32_t i = 0; i < capsules.size(); i++) {
+            float d = capsuleBvh.distance(i, p);
+            if (d < capsules[i].reach) expected.push_back(i);
+            if (d < nearestDist) { nearestDist = d; nearest = (int)i; }
+        }
+        EXPECT_TRUE(found == expected);
+        float bvhDist = 0.0f;
+        EXPECT_EQ(capsuleBvh.nearest(p, &bvhDist), nearest);
+        EXPECT_NEAR(bvhDist, nearestDist, 1e-6f);
+    }
+
+    // Triangle BVH closest point matches per-triangle queries on a noisy sphere
+    constexpr int kRings = 12, kSegs = 16;
+    std::vector<Vertex> sphere;
+    std::vector<uint32_t> sphereIdx;
+    for (int r = 0; r <= kRings; r++) {
+        for (int s = 0; s < kSegs; s++) {
+            float theta = 3.14159265f * r / kRings, phi = 6.2831853f * s / kSegs;
+            float rad = 0.5f + rnd(-0.05f, 0.05f);
+            Vertex v{};
+            v.position[0] = rad * std::sin(theta) * std::cos(phi);
+            v.position[1] = rad * std::cos(theta);
+            v.position[2] = rad * std::sin(theta) * std::sin(phi);
+            sphere.push_back(v);
+        }
+    }
+    for (int r = 0; r < kRings; r++) {
+        for (int s = 0; s < kSegs; s++) {
+            uint32_t a = r * kSegs + s, b = r * kSegs + (s + 1) % kSegs;
+            sphereIdx.insert(sphereIdx.end(), {a, a + kSegs, b, b, a + kSegs, b + kSegs});
+        }
+    }
+    constexpr size_t kStride = sizeof(Vertex) / sizeof(float);
+    TriangleBVH triBvh;
+    triBvh.build(sphere[0].position, kStride, sphere.size(), sphereIdx.data(), sphereIdx.size());
+    std::vector<TriangleBVH> single(sphereIdx.size() / 3);
+    for (size_t t = 0; t < single.size(); t++) {
+        single[t].build(sphere[0].position, kStride, sphere.size(), &sphereIdx[t * 3], 3);
+    }
+    for (int q = 0; q < 200; q++) {
+        Vec3 p(rnd(-0.8f, 0.8f), rnd(-0.8f, 0.8f), rnd(-0.8f, 0.8f));
+        TriangleBVH::Hit hit = triBvh.closestPoint(p);
+        float best = FLT_MAX;
+        for (const auto& one : single) best = std::min(best, one.closestPoint(p).distanceSq);
+        EXPECT_TRUE(hit.valid());
+        EXPECT_NEAR(hit.distanceSq, best, 1e-6f);
+        // Barycentrics reconstruct the reported point
+        Vec3 rebuilt(0, 0, 0);
+        for (int k = 0; k < 3; k++) {
+            const float* c = sphere[sphereIdx[hit.triangle * 3 + k]].position;
+            rebuilt = rebuilt + Vec3(c[0], c[1], c[2]) * hit.bary[k];
+        }
+        EXPECT_NEAR((rebuilt - hit.point).length(), 0.0f, 1e-5f);
+    }
+
+    // CSR adjacency: sorted unique symmetric neighbors, 6 for interior grid vertices
+    MeshAdjacency adjacency;
+    adjacency.build(sphere.size(), sphereIdx.data(), sphereIdx.size());
+    for (size_t v = 0; v < sphere.size(); v++) {
+        for (const uint32_t* n = adjacency.begin(v); n != adjacency.end(v); ++n) {
+            EXPECT_TRUE(*n != v);
+            if (n + 1 != adjacency.end(v)) EXPECT_TRUE(n[0] < n[1]);
+            EXPECT_TRUE(std::binary_search(adjacency.begin(*n), adjacency.end(*n), (uint32_t)v));
+        }
+    }
+    EXPECT_EQ(adjacency.degree(5 * kSegs + 3), 6u);
+
+    // generateWeights (no smoothing) matches scanning every capsule
+    HumanoidRigParams rigParams;
+    Skeleton skeleton = StandardHumanoidRig::createSkeleton(rigParams);
+    Mesh body;
+    body.vertices = sphere;
+    body.indices = sphereIdx;
+    for (auto& v : body.vertices) {
+        v.position[0] *= 0.6f;
+        v.position[1] = v.position[1] * 1.8f + 0.9f;
+        v.position[2] *= 0.6f;
+    }
+    AutoRigParams params;
+    params.smoothIterations = 0;
+    MeshSkinData skin = AutoRigGenerator::generateWeights(body, skeleton, params);
+    std::vector<BoneCapsule> boneCapsules = AutoRigGenerator::buildBoneCapsules(skeleton, params);
+    for (size_t i = 0; i < body.vertices.size(); i++) {
+        Vec3 p(body.vertices[i].position[0], body.vertices[i].position[1], body.vertices[i].position[2]);
+        std::vector<std::pair<int, float>> all;
+        for (const auto& c : boneCapsules) {
+            float w = c.calculateWeight(p, params.falloffPower);
+            if (w > params.minWeight) all.push_back({c.boneIndex, w});
+        }
+        std::sort(all.begin(), all.end(), [](const auto& a, const auto& b) {
+            return a.second > b.second || (a.second == b.second && a.first < b.first);
+        });
+        const VertexSkinning& vs = skin.vertexWeights[i];
+        if (all.empty()) {
+            EXPECT_EQ(vs.influenceCount, 1);
+            continue;
+        }
+        EXPECT_EQ(vs.influenceCount, std::min((int)all.size(), params.maxBonesPerVertex));
+        float total = 0.0f;
+        for (int j = 0; j < vs.influenceCount; j++) total += all[j].second;
+        for (int j = 0; j < vs.influenceCount; j++) {
+            EXPECT_EQ(vs.weights[j].boneIndex, all[j].first);
+            EXPECT_NEAR(vs.weights[j].weight, all[j].second / total, 1e-5f);
+        }
+    }
+
+    // Smoothed weights stay valid, and a copy of the body inherits them exactly
+    params.smoothIterations = 3;
+    params.threadCount = 3;
+    skin = AutoRigGenerator::generateWeights(body, skeleton, params);
+    EXPECT_TRUE(AutoRigGenerator::validateWeights(skin));
+    MeshSkinData copied = AutoRigGenerator::transferWeights(body, body, skin);
+    EXPECT_TRUE(AutoRigGenerator::validateWeights(copied));
+    for (size_t i = kSegs; i < body.vertices.size() - kSegs; i++) {     // Poles are stacked vertices
+        const VertexSkinning& a = skin.vertexWeights[i];
+        const VertexSkinning& b = copied.vertexWeights[i];
+        EXPECT_EQ(a.influenceCount, b.influenceCount);
+        for (int j = 0; j < a.influenceCount; j++) {
+            float match = 0.0f;
+            for (int k = 0; k < b.influenceCount; k++) {
+                if (b.weights[k].boneIndex == a.weights[j].boneIndex) match = b.weights[k].weight;
+            }
+            EXPECT_NEAR(match, a.weights[j].weight, 1e-5f);
+        }
+    }
+
+    skin.applyToMesh(body);
+    EXPECT_TRUE(body.hasSkeleton);
+    EXPECT_EQ(body.skinnedVertices.size(), body.vertices.size());
+    return true;
+}
+
+}  // namespace CharacterTests
+
+// ===== Network Tests =====
+namespace NetworkTests {
+
+// Loopback server + client, both sending through 10% loss and jitter
+inline bool testUdpReliability() {
+    NetworkConditions conditions;
+    conditions.lossPercent = 10.0f;
+    conditions.latencyMs = 5.0f;
+    conditions.jitterMs = 4.0f;
+    
+    NetworkServer server;
+    EXPECT_TRUE(server.start("127.0.0.1", 0));
+    EXPECT_TRUE(server.getLocalPort() != 0);
+    server.setNetworkConditions(conditions, 7);
+    
+    NetworkClient client;
+    EXPECT_TRUE(client.start("127.0.0.1", server.getLocalPort()));
+    client.setNetworkConditions(conditions, 11);
+    
+    constexpr uint32_t kOrdered = 200;
+    constexpr uint32_t kUnordered = 100;
+    constexpr size_t kLargeSize = 20000;
+    std::vector<uint32_t> ordered;
+    std::vector<int> unordered(kUnordered, 0);
+    std::vector<uint32_t> sequenced;
+    std::vector<uint8_t> large;
+    int largeCount = 0;
+    int connects = 0;
+    ConnectionId clientId = INVALID_CONNECTION;
+    
+    server.setOnConnect([&](ConnectionId id, const NetworkConnection&) { connects++; clientId = id; });
+    server.setMessageHandler(NetworkMessageType::Custom, [&](ConnectionId, NetworkMessage& msg) {
+        ordered.push_back(msg.readUInt32());
+    });
+    server.setMessageHandler(NetworkMessageType::StateUpdate, [&](ConnectionId, NetworkMessage& msg) {
+        uint32_t i = msg.readUInt32();
+        if (i < kUnordered) unordered[i]++;
+    });
+    server.setMessageHandler(NetworkMessageType::StateFull, [&](ConnectionId, NetworkMessage& msg) {
+        large = msg.readBytes();
+        largeCount++;
+    });
+    server.setMessageHandler(NetworkMessageType::ScriptStateSync, [&](ConnectionId, NetworkMessage& msg) {
+        sequenced.push_back(msg.readUInt32());
+    });
+    
+    // Queued while connecting, then drained after the handshake
+    for (uint32_t i = 0; i < kOrdered; i++) {
+        NetworkMessage msg(NetworkMessageType::Custom);
+        msg.writeUInt32(i);
+        client.send(SERVER_CONNECTION, msg);
+    }
+    for (uint32_t i = 0; i < kUnordered; i++) {
+        NetworkMessage msg(NetworkMessageType::StateUpdate);
+        msg.writeUInt32(i);
+        client.send(SERVER_CONNECTION, msg, NetworkChannel::Reliable);
+    }
+    std::vector<uint8_t> payload(kLargeSize);
+    for (size_t i = 0; i < kLargeSize; i++) payload[i] = (uint8_t)(i * 31 + 7);
+    NetworkMessage largeMsg(NetworkMessageType::StateFull);
+    largeMsg.writeBytes(payload.data(), payload.size());
+    client.send(SERVER_CONNECTION, largeMsg);
+    
+    auto start = std::chrono::steady_clock::now();
+    auto last = start;
+    uint32_t tick = 0;
+    auto allUnordered = [&] {
+        for (int c : unordered) if (c != 1) return false;
+        return true;
+    };
+    while (ordered.size() < kOrdered || largeCount == 0 || !allUnordered()) {
+        auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration<double>(now - start).count() > 10.0) break;
+        double dt = std::chrono::duration<double>(now - last).count();
+        last = now;
+        if (client.isConnected()) {
+            NetworkMessage msg(NetworkMessageType::ScriptStateSync);
+            msg.writeUInt32(tick++);
+            client.send(SERVER_CONNECTION, msg, NetworkChannel::UnreliableSequenced);
+        }
+        client.update(dt);
+        server.update(dt);
+        server.waitForPackets(0.001);
+    }
+    
+    EXPECT_TRUE(client.isConnected());
+    EXPECT_EQ(connects, 1);
+    EXPECT_EQ(server.getClientCount(), (size_t)1);
+    
+    // Exactly once, in order
+    EXPECT_EQ(ordered.size(), (size_t)kOrdered);
+    for (uint32_t i = 0; i < ordered.size(); i++) EXPECT_EQ(ordered[i], i);
+    EXPECT_TRUE(allUnordered());
+    EXPECT_EQ(largeCount, 1);
+    EXPECT_TRUE(large == payload);
+    
+    // Sequenced: some lost, none older than the last delivered
+    for (size_t i = 1; i < sequenced.size(); i++) EXPECT_TRUE(sequenced[i] > sequenced[i - 1]);
+    
+    // Loss was actually simulated and detected
+    const ReliableConnectionStats* stats = client.getTransportStats(SERVER_CONNECTION);
+    EXPECT_TRUE(stats != nullptr);
+    EXPECT_TRUE(stats->packetsLost > 0);
+    EXPECT_TRUE(stats->fragmentsResent > 0);
+    EXPECT_TRUE(server.getConnection(clientId) != nullptr);
+    
+    // Disconnect reaches the server
+    int disconnects = 0;
+    server.setOnDisconnect([&](ConnectionId, const NetworkConnection&) { disconnects++; });
+    server.setNetworkConditions(NetworkConditions{});
+    client.setNetworkConditions(NetworkConditions{});
+    client.stop();
+    for (int i = 0; i < 200 && disconnects == 0; i++) {
+        server.waitForPackets(0.005);
+        server.update(0.005);
+    }
+    EXPECT_EQ(disconnects, 1);
+    EXPECT_EQ(server.getClientCount(), (size_t)0);
+    return true;
+}
+
+// Two ReliableConnections wired back to back, no sockets
+inline bool testReliableConnection() {
+    ReliableConnection a, b;
+    double now = 0.0;
+    size_t largestPacket = 0;
+    auto pump = [&](ReliableConnection& from, ReliableConnection& to, int dropEvery) {
+        int n = 0;
+        from.writePackets(now, [&](const uint8_t* data, size_t size) {
+            largestPacket = std::max(largestPacket, size);
+            if (dropEvery == 0 || (++n % dropEvery) != 0) to.receivePacket(data, size, now);
+        });
+    };
+    
+    // Oversized and empty messages are rejected
+    EXPECT_FALSE(a.send(NetworkChannel::Reliable, nullptr, 0));
+    
+    std::vector<uint8_t> big(ReliableConnection::kFragmentSize * 5 + 3);
+    for (size_t i = 0; i < big.size(); i++) big[i] = (uint8_t)(i ^ (i >> 8));
+    EXPECT_TRUE(a.send(NetworkChannel::ReliableOrdered, big.data(), big.size()));
+    for (uint8_t i = 0; i < 50; i++) EXPECT_TRUE(a.send(NetworkChannel::ReliableOrdered, &i, 1));
+    
+    std::vector<std::vector<uint8_t>> got;
+    NetworkChannel channel;
+    std::vector<uint8_t> out;
+    for (int step = 0; step < 400 && got.size() < 51; step++) {
+        now += 0.01;
+        pump(a, b, 3);
+        pump(b, a, 4);
+        while (b.popMessage(channel, out)) {
+            EXPECT_TRUE(channel == NetworkChannel::ReliableOrdered);
+            got.push_back(out);
+        }
+    }
+    EXPECT_EQ(got.size(), (size_t)51);
+    EXPECT_TRUE(got[0] == big);
+    EXPECT_TRUE(largestPacket <= ReliableConnection::kPacketBudget + 16);
+    for (size_t i = 1; i < got.size(); i++) EXPECT_EQ((int)got[i][0], (int)(i - 1));
+    
+    // Everything is acked once traffic flows without loss; the dropped
+    // packets are counted lost once they leave the 32-packet ack field
+    for (int step = 0; step < 100; step++) {
+        now += 0.03;
+        pump(a, b, 0);
+        now += 0.02;  // reply delay shows up as round trip time
+        pump(b, a, 0);
+    }
+    EXPECT_EQ(a.pendingReliable(), (size_t)0);
+    EXPECT_TRUE(a.stats().packetsLost > 0);
+    EXPECT_NEAR(a.stats().rtt, 0.02, 0.005);
+    
+    // Garbage is rejected, not crashed on
+    uint8_t junk[7] = {1, 2, 3, 4, 5, 6, 7};
+    EXPECT_FALSE(b.receivePacket(junk, sizeof(junk), now));
+    return true;
+}
+
+inline bool testBitPackedMessage() {
+    // Byte-sized writes keep the plain little-endian layout
+    NetworkMessage bytes;
+    bytes.writeUInt32(0x04030201u);
+    bytes.writeUInt16(0x0605);
+    EXPECT_EQ(bytes.getSize(), (size_t)6);
+    for (uint8_t i = 0; i < 6; i++) EXPECT_EQ(bytes.getData()[i], (uint8_t)(i + 1));
+    
+    NetworkMessage msg(NetworkMessageType::StateUpdate);
+    msg.writeBool(true);
+    msg.writeBits(5, 3);
+    msg.writeVarUInt(300);
+    msg.writeVarInt(-5);
+    msg.writeUInt32(0xDEADBEEFu);
+    msg.writeQuantizedFloat(0.25f, -1.0f, 1.0f, 12);
+    msg.writeQuantizedVec3(Vec3(10.0f, -3.5f, 999.0f), Vec3(-512, -512, -512), Vec3(512, 512, 512), 18);
+    msg.writeString("hello");
+    const uint8_t blob[5] = {9, 8, 7, 6, 5};
+    msg.writeBytes(blob, sizeof(blob));
+    msg.writeBits(3, 2);
+    msg.writeDouble(1.0 / 3.0);
+    
+    // Through the wire format and back
+    std::vector<uint8_t> wire = msg.serialize();
+    NetworkMessage in;
+    EXPECT_TRUE(in.deserializeFrom(wire.data(), wire.size()));
+    EXPECT_TRUE(in.getType() == NetworkMessageType::StateUpdate);
+    EXPECT_TRUE(in.readBool());
+    EXPECT_EQ(in.readBits(3), 5u);
+    EXPECT_EQ(in.readVarUInt(), (uint64_t)300);
+    EXPECT_EQ(in.readVarInt(), (int64_t)-5);
+    EXPECT_EQ(in.readUInt32(), 0xDEADBEEFu);
+    EXPECT_NEAR(in.readQuantizedFloat(-1.0f, 1.0f, 12), 0.25f, 0.0005f);
+    Vec3 v = in.readQuantizedVec3(Vec3(-512, -512, -512), Vec3(512, 512, 512), 18);
+    EXPECT_NEAR(v.x, 10.0f, 0.004f);
+    EXPECT_NEAR(v.y, -3.5f, 0.004f);
+    EXPECT_NEAR(v.z, 512.0f, 0.004f);  // clamped
+    EXPECT_TRUE(in.readString() == "hello");
+    std::vector<uint8_t> readBlob;
+    in.readBytes(readBlob);
+    EXPECT_TRUE(readBlob == std::vector<uint8_t>(blob, blob + 5));
+    EXPECT_EQ(in.readBits(2), 3u);
+    EXPECT_TRUE(in.readDouble() == 1.0 / 3.0);
+    EXPECT_FALSE(in.hasReadError());
+    
+    // Reading past the end is flagged, not undefined
+    in.readUInt32();
+    EXPECT_TRUE(in.hasReadError());
+    NetworkMessage truncated;
+    EXPECT_FALSE(truncated.deserializeFrom(wire.data(), 2));
+    
+    // Byte-aligned writes (including empty ones) at every bit offset: the
+    // alignment padding must not carry stale bits into the next word
+    for (int offset = 0; offset <= 40; offset++) {
+        NetworkMessage raw;
+        int low = std::min(offset, 32);
+        if (low > 0) raw.writeBits(0xFFFFFFFFu, low);
+        if (offset > 32) raw.writeBits(0xFFu, offset - 32);
+        raw.writeString("");
+        raw.writeByte(0xAB);
+        raw.writeUInt32(0xDEADBEEFu);
+        raw.writeBytes(blob, 3);
+        raw.writeBits(5, 3);
+        raw.writeRaw(blob, 0);
+        raw.writeUInt16(0x1234);
+        
+        if (low > 0) EXPECT_EQ(raw.readBits(low), low == 32 ? 0xFFFFFFFFu : (1u << low) - 1);
+        if (offset > 32) EXPECT_EQ(raw.readBits(offset - 32), (1u << (offset - 32)) - 1);
+        EXPECT_TRUE(raw.readString().empty());
+        EXPECT_EQ(raw.readByte(), 0xAB);
+        EXPECT_EQ(raw.readUInt32(), 0xDEADBEEFu);
+        raw.readBytes(readBlob);
+        EXPECT_TRUE(readBlob == std::vector<uint8_t>(blob, blob + 3));
+        EXPECT_EQ(raw.readBits(3), 5u);
+        raw.alignRead();
+        EXPECT_EQ(raw.readUInt16(), 0x1234);
+        EXPECT_FALSE(raw.hasReadError());
+    }
+    
+    // Smallest three, including q and -q
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (int i = 0; i < 200; i++) {
+        Quat q(dist(rng), dist(rng), dist(rng), dist(rng));
+        float length = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+        q = Quat(q.x / length, q.y / length, q.z / length, q.w / length);
+        NetworkMessage qm;
+        qm.writeQuat(q);
+        EXPECT_EQ(qm.getBitSize(), (size_t)32);
+        Quat r = qm.readQuat();
+        float dot = std::abs(q.x * r.x + q.y * r.y + q.z * r.z + q.w * r.w);
+        EXPECT_TRUE(dot > 0.9999f);
+    }
+    
+    // String table: registered names cost a bit and an index
+    NetworkStringTable table;
+    table.add("fire");
+    table.add("reload");
+    NetworkStringTable other;
+    other.add("fire");
+    EXPECT_TRUE(table.checksum() != other.checksum());
+    other.add("reload");
+    EXPECT_EQ(table.checksum(), other.checksum());
+    NetworkMessage names;
+    names.writeString("reload", table);
+    names.writeString("jump", table);
+    EXPECT_TRUE(names.readString(other) == "reload");
+    EXPECT_TRUE(names.readString(other) == "jump");
+    EXPECT_FALSE(names.hasReadError());
+    
+    // Script values on top of the bit stream
+    ScriptValue table2;
+    table2.type = ScriptValueType::Table;
+    table2.tableValue["hp"] = ScriptValue(75.0);
+    table2.tableValue["name"] = ScriptValue(std::string("orc"));
+    std::vector<ScriptValue> values = {ScriptValue(true), ScriptValue(-42.0), ScriptValue(0.1), ScriptValue(0.5),
+                                       ScriptValue(std::string("text")), ScriptValue(Vec3(1, 2, 3)),
+                                       ScriptValue(Quat(0, 0.7071068f, 0, 0.7071068f)), table2, ScriptValue()};
+    NetworkMessage sv;
+    for (const auto& value : values) value.serialize(sv);
+    for (const auto& value : values) {
+        ScriptValue r = ScriptValue::deserialize(sv);
+        EXPECT_TRUE(r.type == value.type);
+        if (value.isBool()) EXPECT_EQ(r.boolValue, value.boolValue);
+        if (value.isNumber()) EXPECT_TRUE(r.numberValue == value.numberValue);
+        if (value.isString()) EXPECT_TRUE(r.stringValue == value.stringValue);
+        if (value.isVec3()) EXPECT_NEAR(r.vec3Value.z, 3.0f, 1e-6f);
+        if (value.isQuat()) EXPECT_NEAR(r.quatValue.y, 0.7071068f, 1e-4f);
+        if (value.isTable()) {
+            EXPECT_TRUE(r.tableValue["hp"].numberValue == 75.0);
+            EXPECT_TRUE(r.tableValue["name"].stringValue == "orc");
+        }
+    }
+    EXPECT_FALSE(sv.hasReadError());
+    
+    // Buffers go back to the pool and are reused
+    size_t pooled = getNetworkBufferPool().pooledCount();
+    { NetworkMessage temp; temp.writeUInt32(1); }
+    EXPECT_EQ(getNetworkBufferPool().pooledCount(), pooled + 1);
+    { NetworkMessage temp; temp.writeUInt32(1); }
+    EXPECT_EQ(getNetworkBufferPool().pooledCount(), pooled + 1);
+    return true;
+}
+
+// Loopback server + two clients with different interest areas
+inline bool testReplication() {
+    constexpr double kDt = 1.0 / 30.0;
+    NetworkServer server;
+    EXPECT_TRUE(server.start("127.0.0.1", 0));
+    NetworkClient clientA, clientB;
+    std::vector<ConnectionId> ids;
+    server.setOnConnect([&](ConnectionId id, const NetworkConnection&) { ids.push_back(id); });
+    auto pump = [&](int steps) {
+        for (int i = 0; i < steps; i++) {
+            server.update(kDt);
+            clientA.update(kDt);
+            clientB.update(kDt);
+            server.waitForPackets(0.002);
+        }
+    };
+    EXPECT_TRUE(clientA.start("127.0.0.1", server.getLocalPort()));
+    for (int i = 0; i < 200 && ids.size() < 1; i++) pump(1);
+    EXPECT_TRUE(clientB.start("127.0.0.1", server.getLocalPort()));
+    for (int i = 0; i < 200 && ids.size() < 2; i++) pump(1);
+    EXPECT_EQ(ids.size(), (size_t)2);
+    
+    ReplicationServer replication(server);
+    ReplicationClient replicaA(clientA), replicaB(clientB);
+    int despawnsA = 0;
+    replicaA.setOnDespawn([&](uint32_t) { despawnsA++; });
+    std::vector<uint32_t> spawnTypesB;
+    replicaB.setOnSpawn([&](uint32_t, uint32_t typeId) { spawnTypesB.push_back(typeId); });
+    
+    // 50 entities on the x axis, 4 m apart; one far away owned by B
+    std::vector<ReplicatedState> states(50);
+    for (uint32_t i = 0; i < 50; i++) {
+        states[i].position = Vec3(i * 4.0f, 1.0f, 0.3f);
+        states[i].rotation = Quat::fromAxisAngle(Vec3(0, 1, 0), i * 0.1f);
+        states[i].velocity = Vec3(1.0f, 0.0f, -0.5f);
+        states[i].userData = i;
+        EXPECT_TRUE(replication.addEntity(100 + i, 7, states[i]));
+    }
+    ReplicatedState owned;
+    owned.position = Vec3(1000.0f, 0.0f, 0.0f);
+    EXPECT_TRUE(replication.addEntity(999, 9, owned, ids[1]));
+    EXPECT_FALSE(replication.addEntity(999, 9, owned));
+    replication.setInterest(ids[0], Vec3(0, 0, 0), 50.0f);
+    replication.setInterest(ids[1], Vec3(0, 0, 0), 22.0f);
+    
+    auto run = [&](int ticks) {
+        for (int i = 0; i < ticks; i++) {
+            replication.tick(kDt);
+            pump(1);
+            replicaA.update(kDt);
+            replicaB.update(kDt);
+        }
+    };
+    auto matches = [&](ReplicationClient& replica, uint32_t id, const ReplicatedState& state) {
+        ReplicatedState got;
+        if (!replica.getLatestState(id, got)) return false;
+        ReplicatedState expected = QuantizedState::quantize(state).dequantize();
+        return got.position.x == expected.position.x && got.position.z == expected.position.z &&
+               got.velocity.z == expected.velocity.z && got.rotation.w == expected.rotation.w &&
+               got.userData == state.userData;
+    };
+    
+    // Interest radius, plus the owned entity outside it
+    run(20);
+    EXPECT_EQ(replicaA.getEntityCount(), (size_t)13);
+    EXPECT_EQ(replicaB.getEntityCount(), (size_t)7);
+    EXPECT_TRUE(replicaB.hasEntity(999));
+    EXPECT_FALSE(replicaA.hasEntity(999));
+    EXPECT_EQ(spawnTypesB.size(), (size_t)7);
+    EXPECT_EQ(std::count(spawnTypesB.begin(), spawnTypesB.end(), 9u), 1);
+    for (uint32_t i = 0; i < 13; i++) EXPECT_TRUE(matches(replicaA, 100 + i, states[i]));
+    EXPECT_TRUE(matches(replicaB, 103, states[3]));
+    
+    // Acked and unchanged entities cost nothing; a change is a small delta
+    EXPECT_EQ(replication.stats().entitiesSent, (size_t)0);
+    EXPECT_TRUE(replication.stats().bytesSent < 16);
+    states[2].position.x += 0.5f;
+    replication.setState(102, states[2]);
+    replication.tick(kDt);
+    EXPECT_EQ(replication.stats().entitiesSent, (size_t)2);
+    EXPECT_TRUE(replication.stats().bytesSent < 32);
+    run(5);
+    EXPECT_TRUE(matches(replicaA, 102, states[2]));
+    EXPECT_TRUE(matches(replicaB, 102, states[2]));
+    
+    // Removed and out-of-interest entities are despawned
+    replication.removeEntity(100);
+    states[1].position.x = 300.0f;
+    replication.setState(101, states[1]);
+    run(10);
+    EXPECT_FALSE(replicaA.hasEntity(100));
+    EXPECT_FALSE(replicaA.hasEntity(101));
+    EXPECT_FALSE(replicaB.hasEntity(101));
+    EXPECT_EQ(despawnsA, 2);
+    EXPECT_EQ(replication.getEntityCount(), (size_t)50);
+    
+    // Byte cap: a burst of spawns spreads over several snapshots
+    replication.setBytesPerClient(120);
+    for (uint32_t i = 0; i < 40; i++) {
+        ReplicatedState s;
+        s.position = Vec3(-(float)i, 0.0f, 2.0f);
+        s.velocity = Vec3(0.0f, 0.0f, (float)i);
+        EXPECT_TRUE(replication.addEntity(2000 + i, 3, s));
+    }
+    replication.tick(kDt);
+    EXPECT_TRUE(replication.stats().entitiesDeferred > 0);
+    EXPECT_TRUE(replication.stats().bytesSent <= 2 * 120);
+    run(30);
+    EXPECT_TRUE(replicaA.hasEntity(2039));
+    EXPECT_EQ(replicaA.getEntityCount(), (size_t)51);
+    EXPECT_EQ(replicaB.getEntityCount(), (size_t)27);
+    replication.setBytesPerClient(1000);
+    
+    // Interpolation follows linear motion between snapshots
+    for (int step = 0; step < 20; step++) {
+        states[5].position.x = 20.0f + 0.1f * (replication.getTick() + 1);
+        replication.setState(105, states[5]);
+        run(1);
+    }
+    for (int half = 0; half < 2; half++) {
+        ReplicatedState s;
+        EXPECT_TRUE(replicaA.getInterpolatedState(105, s));
+        EXPECT_NEAR(s.position.x, 20.0f + 0.1f * (float)replicaA.getRenderTick(), 0.004f);
+        replicaA.update(kDt * 0.5);
+    }
+    EXPECT_TRUE(replicaA.getRenderTick() < replicaA.getLatestTick());
+    
+    // Loss: deltas only build on acked baselines, so replicas converge
+    NetworkConditions lossy;
+    lossy.lossPercent = 25.0f;
+    server.setNetworkConditions(lossy, 3);
+    clientA.setNetworkConditions(lossy, 4);
+    std::mt19937 rng(12);
+    std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+    for (int step = 0; step < 40; step++) {
+        for (uint32_t i = 2; i < 13; i++) {
+            states[i].position.x += jitter(rng);
+            states[i].rotation = Quat::fromAxisAngle(Vec3(0, 1, 0), jitter(rng));
+            states[i].userData += 1;
+            replication.setState(100 + i, states[i]);
+        }
+        run(1);
+    }
+    EXPECT_TRUE(replicaA.stats().snapshotsReceived > 0);
+    server.setNetworkConditions(NetworkConditions{});
+    clientA.setNetworkConditions(NetworkConditions{});
+    run(15);
+    for (uint32_t i = 2; i < 13; i++) EXPECT_TRUE(matches(replicaA, 100 + i, states[i]));
+    return true;
+}
+
+}  // namespace NetworkTests
+
+// ===== Navigation Tests =====
+namespace NavigationTests {
+
+// Smallest distance between any two crowd agents
+inline float minSeparation(const Crowd& crowd, const std::vector<Crowd::AgentId>& ids) {
+    float best = 1e9f;
+    for (size_t i = 0; i < ids.size(); i++) {
+        for (size_t j = i + 1; j < ids.size(); j++) {
+            Vec3 d = crowd.getPosition(ids[i]) - crowd.getPosition(ids[j]);
+            best = std::min(best, std::sqrt(d.x * d.x + d.z * d.z));
+        }
+    }
+    return best;
+}
+
+inline bool testCrowdAvoidance() {
+    NavAgentSettings settings;
+    settings.speed = 2.0f;
+    settings.acceleration = 20.0f;
+    settings.avoidanceRadius = 0.5f;
+    settings.stoppingDistance = 0.2f;
+    
+    // Two lines of 12 walk through each other, every agent head-on with one
+    CrowdSettings crowdSettings;
+    crowdSettings.threads = 2;
+    Crowd crowd(crowdSettings);
+    std::vector<Crowd::AgentId> ids;
+    for (int side = 0; side < 2; side++) {
+        for (int i = 0; i < 12; i++) {
+            float x = side ? 10.0f : -10.0f;
+            float z = (i - 5.5f) * 1.5f;
+            ids.push_back(crowd.addAgent(Vec3(x, 0.0f, z), settings));
+            EXPECT_TRUE(crowd.setDestination(ids.back(), Vec3(-x, 0.0f, z)));
+        }
+    }
+    EXPECT_EQ(crowd.getState(ids[0]), NavAgentState::Waiting);
+    float closest = 1e9f;
+    int arrived = 0;
+    for (int step = 0; step < 400 && arrived < 24; step++) {
+        crowd.update(0.05f);
+        closest = std::min(closest, minSeparation(crowd, ids));
+        arrived = 0;
+        for (auto id : ids) arrived += crowd.getState(id) == NavAgentState::Arrived;
+    }
+    EXPECT_EQ(arrived, 24);
+    EXPECT_TRUE(closest > 0.9f);  // combined radius 1.0, small slack for the acceleration limit
+    for (auto id : ids) {
+        Vec3 d = crowd.getPosition(id) - crowd.getDestination(id);
+        EXPECT_TRUE(std::sqrt(d.x * d.x + d.z * d.z) <= 0.5f);
+    }
+    
+    // Without avoidance they go straight through each other
+    settings.avoidObstacles = false;
+    Crowd ghosts(crowdSettings);
+    Crowd::AgentId a = ghosts.addAgent(Vec3(-5, 0, 0), settings);
+    Crowd::AgentId b = ghosts.addAgent(Vec3(5, 0, 0), settings);
+    ghosts.setDestination(a, Vec3(5, 0, 0));
+    ghosts.setDestination(b, Vec3(-5, 0, 0));
+    closest = 1e9f;
+    for (int step = 0; step < 200; step++) {
+        ghosts.update(0.05f);
+        closest = std::min(closest, minSeparation(ghosts, {a, b}));
+    }
+    EXPECT_TRUE(closest < 0.1f);
+    
+    // Ids stay valid across swap-removal and are not reused
+    Crowd::AgentId c = ghosts.addAgent(Vec3(1, 2, 3), settings);
+    ghosts.removeAgent(a);
+    EXPECT_FALSE(ghosts.isValid(a));
+    EXPECT_TRUE(ghosts.isValid(c));
+    EXPECT_NEAR(ghosts.getPosition(c).z, 3.0f, 1e-6f);
+    Crowd::AgentId d = ghosts.addAgent(Vec3(0, 0, 0), settings);
+    EXPECT_TRUE(d != a);
+    EXPECT_FALSE(ghosts.isValid(a));
+    EXPECT_EQ(ghosts.getAgentCount(), (size_t)3);
+    return true;
+}
+
+inline bool testCrowdPathBudget() {
+    // L-shaped corridor: (0..10, 0..2) then (8..10, 2..10)
+    NavMesh navMesh;
+    const Vec3 q0[4] = {Vec3(0, 0, 0), Vec3(0, 0, 2), Vec3(8, 0, 2), Vec3(8, 0, 0)};
+    const Vec3 q1[4] = {Vec3(8, 0, 0), Vec3(8, 0, 2), Vec3(10, 0, 2), Vec3(10, 0, 0)};
+    const Vec3 q2[4] = {Vec3(8, 0, 2), Vec3(8, 0, 10), Vec3(10, 0, 10), Vec3(10, 0, 2)};
+    navMesh.addPolygon(q0, 4);
+    navMesh.addPolygon(q1, 4);
+    navMesh.addPolygon(q2, 4);
+    navMesh.connectPolygons();
+    
+    NavAgentSettings settings;
+    settings.speed = 3.0f;
+    settings.avoidanceRadius = 0.2f;
+    CrowdSettings crowdSettings;
+    crowdSettings.maxPathRequestsPerTick = 4;
+    crowdSettings.threads = 1;
+    Crowd crowd(crowdSettings);
+    crowd.setNavMesh(&navMesh);
+    std::vector<Crowd::AgentId> ids;
+    for (int i = 0; i < 10; i++) {
+        ids.push_back(crowd.addAgent(Vec3(0.5f + i * 0.6f, 0.0f, 1.0f), settings));
+        crowd.setDestination(ids.back(), Vec3(9.0f, 0.0f, 9.0f));
+    }
+    crowd.setDestination(ids[0], Vec3(9.0f, 0.0f, 9.5f));  // still one request
+    EXPECT_EQ(crowd.getPendingPathRequests(), (size_t)10);
+    crowd.update(0.05f);
+    EXPECT_EQ(crowd.getStats().pathsSolved, (size_t)4);
+    EXPECT_EQ(crowd.getPendingPathRequests(), (size_t)6);
+    EXPECT_EQ(crowd.getState(ids[0]), NavAgentState::Moving);
+    EXPECT_EQ(crowd.getState(ids[9]), NavAgentState::Waiting);
+    
+    // Everyone follows the corridor around the corner
+    bool leftCorridor = false;
+    int arrived = 0;
+    for (int step = 0; step < 600 && arrived < 10; step++) {
+        crowd.update(0.05f);
+        arrived = 0;
+        for (auto id : ids) {
+            Vec3 p = crowd.getPosition(id);
+            if (p.x < 7.0f && p.z > 3.0f) leftCorridor = true;
+            arrived += crowd.getState(id) == NavAgentState::Arrived;
+        }
+    }
+    EXPECT_EQ(arrived, 10);
+    EXPECT_FALSE(leftCorridor);
+    
+    // Unreachable destinations leave the agent stuck
+    Crowd::AgentId lost = crowd.addAgent(Vec3(1, 0, 1), settings);
+    crowd.setDestination(lost, Vec3(100.0f, 0.0f, 100.0f));
+    crowd.update(0.05f);
+    EXPECT_EQ(crowd.getState(lost), NavAgentState::Stuck);
+    return true;
+}
+
+inline bool testNavAgentManagerAvoidance() {
+    NavMesh navMesh;
+    const Vec3 floor[4] = {Vec3(-20, 0, -20), Vec3(-20, 0, 20), Vec3(20, 0, 20), Vec3(20, 0, -20)};
+    navMesh.addPolygon(floor, 4);
+    
+    auto run = [&](bool avoid, float& closest) {
+        NavAgentManager manager;
+        NavAgent* a = manager.createAgent();
+        NavAgent* b = manager.createAgent();
+        for (NavAgent* agent : {a, b}) {
+            agent->getSettings().speed = 2.0f;
+            agent->getSettings().avoidanceRadius = 0.5f;
+            agent->getSettings().avoidObstacles = avoid;
+        }
+        a->setPosition(Vec3(-5, 0, 0));
+        b->setPosition(Vec3(5, 0, 0));
+        a->setDestination(Vec3(5, 0, 0));
+        b->setDestination(Vec3(-5, 0, 0));
+        closest = 1e9f;
+        for (int step = 0; step < 300; step++) {
+            manager.update(0.05f, navMesh);
+            closest = std::min(closest, (a->getPosition() - b->getPosition()).length());
+        }
+        return a->getState() == NavAgentState::Arrived && b->getState() == NavAgentState::Arrived;
+    };
+    float withAvoidance = 0.0f, without = 0.0f;
+    EXPECT_TRUE(run(true, withAvoidance));
+    EXPECT_TRUE(run(false, without));
+    EXPECT_TRUE(withAvoidance > 0.9f);
+    EXPECT_TRUE(without < 0.2f);
+    
+    // Id lookup through the index
+    NavAgentManager manager;
+    NavAgent* first = manager.createAgent();
+    NavAgent* second = manager.createAgent();
+    uint32_t firstId = first->getId();
+    EXPECT_TRUE(manager.getAgentById(second->getId()) == second);
+    manager.destroyAgent(first);
+    EXPECT_TRUE(manager.getAgentById(firstId) == nullptr);
+    EXPECT_TRUE(manager.getAgentById(second->getId()) == second);
+    return true;
+}
+
+inline bool testPathQueries() {
+    std::vector<float> heights(33 * 33, 0.0f);
+    NavMesh navMesh;
+    EXPECT_TRUE(navMesh.buildFromHeightmap(heights.data(), 33, 33, 100.0f, 100.0f, 1.0f, NavMeshBuildSettings()));
+    EXPECT_EQ(navMesh.getPolyCount(), (size_t)2048);
+    
+    // The reused node pool gives the same answer every time
+    NavPathfinder pathfinder(&navMesh);
+    NavPath first, again;
+    EXPECT_TRUE(pathfinder.findPath(Vec3(-40, 0, -40), Vec3(40, 0, 30), first));
+    EXPECT_TRUE(pathfinder.findPath(Vec3(-40, 0, -40), Vec3(40, 0, 30), again));
+    EXPECT_EQ(first.points.size(), again.points.size());
+    EXPECT_NEAR(first.totalLength, again.totalLength, 1e-4f);
+    
+    NavPathQuerySettings settings;
+    settings.hierarchicalMinPolys = 0;
+    settings.clusterSize = 32;
+    NavPathQueryService queries(&navMesh, settings);
+    EXPECT_TRUE(queries.getStats().clusters > 1);
+    
+    // The cluster-limited search stays close to the flat one
+    NavPath path;
+    EXPECT_TRUE(queries.findPath(Vec3(-40, 0, -40), Vec3(40, 0, 30), path));
+    EXPECT_TRUE(path.totalLength < first.totalLength * 1.1f);
+    EXPECT_EQ(queries.getStats().hierarchical, (size_t)1);
+    EXPECT_EQ(queries.getStats().cacheMisses, (size_t)1);
+    
+    // Endpoints in the same polygons reuse the cached corridor
+    EXPECT_TRUE(queries.findPath(Vec3(-40.1f, 0, -40.1f), Vec3(40.1f, 0, 30.1f), path));
+    EXPECT_EQ(queries.getStats().cacheHits, (size_t)1);
+    EXPECT_NEAR(path.points.back().position.x, 40.1f, 1e-4f);
+    
+    // Time-sliced: each update solves at least one query
+    NavPathQueryService::QueryId a = queries.request(Vec3(-45, 0, 0), Vec3(45, 0, 0));
+    NavPathQueryService::QueryId b = queries.request(Vec3(0, 0, -45), Vec3(0, 0, 45));
+    NavPathQueryService::QueryId c = queries.request(Vec3(-45, 0, 45), Vec3(45, 0, -45));
+    EXPECT_EQ(queries.getStatus(a), NavPathQueryStatus::Pending);
+    EXPECT_FALSE(queries.takeResult(a, path));
+    EXPECT_EQ(queries.update(0.0), (size_t)1);
+    EXPECT_EQ(queries.getStatus(a), NavPathQueryStatus::Succeeded);
+    EXPECT_EQ(queries.getStatus(b), NavPathQueryStatus::Pending);
+    queries.cancel(b);
+    EXPECT_EQ(queries.getStatus(b), NavPathQueryStatus::Invalid);
+    queries.flush();
+    EXPECT_EQ(queries.getPendingCount(), (size_t)0);
+    EXPECT_TRUE(queries.takeResult(c, path));
+    EXPECT_TRUE(path.valid);
+    EXPECT_EQ(queries.getStatus(c), NavPathQueryStatus::Invalid);
+    
+    // Editing the mesh drops clusters and cached corridors
+    size_t clusters = queries.getStats().clusters;
+    size_t misses = queries.getStats().cacheMisses;
+    std::vector<float> coarse(17 * 17, 0.0f);
+    navMesh.buildFromHeightmap(coarse.data(), 17, 17, 100.0f, 100.0f, 1.0f, NavMeshBuildSettings());
+    EXPECT_TRUE(queries.findPath(Vec3(-40, 0, -40), Vec3(40, 0, 30), path));
+    EXPECT_TRUE(queries.getStats().clusters < clusters);
+    EXPECT_EQ(queries.getStats().cacheMisses, misses + 1);
+    
+    // Worker threads agree with synchronous queries (without a cache, which
+    // would make results depend on the order queries finish in)
+    settings.cacheCapacity = 0;
+    NavPathQueryService reference(&navMesh, settings);
+    settings.threads = 2;
+    NavPathQueryService threaded(&navMesh, settings);
+    EXPECT_EQ(threaded.getThreadCount(), 2);
+    std::vector<NavPathQueryService::QueryId> ids;
+    for (int i = 0; i < 32; i++) {
+        float t = i / 31.0f;
+        ids.push_back(threaded.request(Vec3(-45, 0, -45 + 90 * t), Vec3(45, 0, 45 - 90 * t)));
+    }
+    threaded.flush();
+    for (int i = 0; i < 32; i++) {
+        float t = i / 31.0f;
+        NavPath expected;
+        EXPECT_TRUE(reference.findPath(Vec3(-45, 0, -45 + 90 * t), Vec3(45, 0, 45 - 90 * t), expected));
+        EXPECT_TRUE(threaded.takeResult(ids[i], path));
+        EXPECT_TRUE(path.valid);
+        EXPECT_NEAR(path.totalLength, expected.totalLength, 1e-3f);
+    }
+    
+    // A crowd can hand its path requests to the service; the time-sliced
+    // one is updated by its owner every frame
+    CrowdSettings crowdSettings;
+    crowdSettings.threads = 1;
+    Crowd crowd(crowdSettings);
+    crowd.setNavMesh(&navMesh);
+    crowd.setPathQueryService(&queries);
+    NavAgentSettings agentSettings;
+    agentSettings.speed = 10.0f;
+    agentSettings.avoidanceRadius = 0.5f;
+    std::vector<Crowd::AgentId> agents;
+    for (int i = 0; i < 8; i++) {
+        agents.push_back(crowd.addAgent(Vec3(-40.0f, 0.0f, -20.0f + i * 5.0f), agentSettings));
+        crowd.setDestination(agents.back(), Vec3(40.0f, 0.0f, -20.0f + i * 5.0f));
+    }
+    int arrived = 0;
+    crowd.update(0.05f);
+    EXPECT_EQ(crowd.getPendingPathRequests(), (size_t)8);
+    for (int step = 0; step < 400 && arrived < 8; step++) {
+        queries.update(1.0);
+        crowd.update(0.05f);
+        arrived = 0;
+        for (auto id : agents) {
+            arrived += crowd.getState(id) == NavAgentState::Arrived;
+            EXPECT_TRUE(crowd.getPosition(id).x < 41.0f);
+        }
+    }
+    EXPECT_EQ(arrived, 8);
+    EXPECT_EQ(crowd.getPendingPathRequests(), (size_t)0);
+    return true;
+}
+
+inline bool testTiledNavMesh() {
+    std::vector<float> heights(65 * 65, 0.0f);
+    NavMesh monolithic;
+    EXPECT_TRUE(monolithic.buildFromHeightmap(heights.data(), 65, 65, 100.0f, 100.0f, 1.0f, NavMeshBuildSettings()));
+    
+    // Stitched tiles link up exactly like the single mesh
+    NavTileSettings tileSettings;
+    tileSettings.tileCells = 16;
+    tileSettings.threads = 2;
+    TiledNavMesh tiled;
+    EXPECT_TRUE(tiled.setHeightmap(heights.data(), 65, 65, 100.0f, 100.0f, 1.0f, NavMeshBuildSettings(), tileSettings));
+    EXPECT_TRUE(tiled.rebuild());
+    EXPECT_EQ(tiled.getStats().tiles, (size_t)16);
+    EXPECT_EQ(tiled.getStats().tilesBuilt, (size_t)16);
+    EXPECT_EQ(tiled.getNavMesh().getPolyCount(), monolithic.getPolyCount());
+    EXPECT_EQ(tiled.getNavMesh().getEdges().size(), monolithic.getEdges().size());
+    EXPECT_EQ(tiled.getPolyTile(0), 0);
+    EXPECT_EQ(tiled.getPolyTile((int)monolithic.getPolyCount() - 1), 15);
+    
+    NavPathfinder reference(&monolithic), pathfinder(&tiled.getNavMesh());
+    NavPath expected, path;
+    EXPECT_TRUE(reference.findPath(Vec3(-45, 0, -40), Vec3(42, 0, 45), expected));
+    EXPECT_TRUE(pathfinder.findPath(Vec3(-45, 0, -40), Vec3(42, 0, 45), path));
+    EXPECT_NEAR(path.totalLength, expected.totalLength, 1e-3f);
+    
+    // Obstacles only dirty the tiles under them
+    int box = tiled.addObstacle(Vec3(-15, 0, -15), Vec3(-10, 2, -10));
+    EXPECT_EQ(tiled.getStats().dirtyTiles, (size_t)1);
+    EXPECT_TRUE(tiled.rebuild());
+    EXPECT_EQ(tiled.getStats().tilesBuilt, (size_t)1);
+    EXPECT_TRUE(tiled.getNavMesh().getPolyCount() < monolithic.getPolyCount());
+    EXPECT_TRUE(tiled.moveObstacle(box, Vec3(10, 0, 10), Vec3(15, 2, 15)));
+    EXPECT_EQ(tiled.getStats().dirtyTiles, (size_t)2);
+    EXPECT_TRUE(tiled.rebuild());
+    EXPECT_EQ(tiled.getStats().tilesBuilt, (size_t)2);
+    EXPECT_TRUE(tiled.removeObstacle(box));
+    EXPECT_FALSE(tiled.removeObstacle(box));
+    
+    // A wall across several tiles forces a detour through the gap
+    int wall = tiled.addObstacle(Vec3(-50, 0, -1), Vec3(30, 2, 1));
+    EXPECT_TRUE(tiled.rebuild());
+    EXPECT_TRUE(pathfinder.findPath(Vec3(0, 0, -20), Vec3(0, 0, 20), path));
+    EXPECT_TRUE(path.totalLength > 70.0f);
+    
+    // Cache round trip: unchanged tiles load, edited ones are rebuilt
+    std::string cachePath = (std::filesystem::temp_directory_path() / "luma_test_navtiles.bin").string();
+    EXPECT_TRUE(tiled.saveCache(cachePath));
+    TiledNavMesh loaded;
+    loaded.setHeightmap(heights.data(), 65, 65, 100.0f, 100.0f, 1.0f, NavMeshBuildSettings(), tileSettings);
+    loaded.addObstacle(Vec3(-50, 0, -1), Vec3(30, 2, 1));
+    EXPECT_TRUE(loaded.loadCache(cachePath));
+    EXPECT_EQ(loaded.getStats().tilesFromCache, (size_t)16);
+    EXPECT_EQ(loaded.getStats().tilesBuilt, (size_t)0);
+    EXPECT_EQ(loaded.getNavMesh().getPolyCount(), tiled.getNavMesh().getPolyCount());
+    EXPECT_EQ(loaded.getNavMesh().getEdges().size(), tiled.getNavMesh().getEdges().size());
+    
+    TiledNavMesh edited;
+    edited.setHeightmap(heights.data(), 65, 65, 100.0f, 100.0f, 1.0f, NavMeshBuildSettings(), tileSettings);
+    edited.addObstacle(Vec3(-50, 0, -1), Vec3(30, 2, 1));
+    float bump = 0.01f;
+    EXPECT_TRUE(edited.setHeights(40, 40, 1, 1, &bump));
+    EXPECT_TRUE(edited.loadCache(cachePath));
+    EXPECT_EQ(edited.getStats().tilesFromCache, (size_t)15);
+    EXPECT_EQ(edited.getStats().tilesBuilt, (size_t)1);
+    
+    // Removing the wall restores the straight path
+    EXPECT_TRUE(tiled.removeObstacle(wall));
+    EXPECT_TRUE(tiled.rebuild());
+    EXPECT_TRUE(pathfinder.findPath(Vec3(0, 0, -20), Vec3(0, 0, 20), path));
+    EXPECT_NEAR(path.totalLength, 40.0f, 0.1f);
+    
+    // Truncated or foreign files are rejected
+    {
+        std::ofstream corrupt(cachePath, std::ios::binary | std::ios::trunc);
+        corrupt << "LNVT";
+    }
+    EXPECT_FALSE(loaded.loadCache(cachePath));
+    EXPECT_FALSE(loaded.getLastError().empty());
+    std::filesystem::remove(cachePath);
+    return true;
+}
+
+}  // namespace NavigationTests
+
+// ===== Behavior Tree Tests =====
+namespace BehaviorTreeTests {
+
+inline bool testBlackboardKeys() {
+    BlackboardSchema schema;
+    BBKey<float> health = schema.add<float>("health", 100.0f);
+    BBKey<Vec3> target = schema.add<Vec3>("target");
+    BBKey<bool> alert = schema.add<bool>("alert");
+    EXPECT_EQ(schema.add<float>("health").slot, health.slot);
+    EXPECT_FALSE(schema.add<int>("health").valid());
+    EXPECT_FALSE(schema.find<Vec3>("missing").valid());
+    
+    Blackboard bb(&schema);
+    EXPECT_NEAR(bb.get(health), 100.0f, 1e-6f);
+    EXPECT_FALSE(bb.has(health));
+    bb.set(health, 42.0f);
+    bb.set(target, Vec3(1, 2, 3));
+    EXPECT_TRUE(bb.has(health));
+    EXPECT_NEAR(bb.get(health), 42.0f, 1e-6f);
+    EXPECT_NEAR(bb.get(target).z, 3.0f, 1e-6f);
+    
+    // String keys reach the same slots; other types and names use the map
+    EXPECT_NEAR(bb.get<float>("health"), 42.0f, 1e-6f);
+    bb.set("alert", true);
+    EXPECT_TRUE(bb.get(alert));
+    bb.set<std::string>("name", "guard");
+    EXPECT_EQ(bb.get<std::string>("name"), std::string("guard"));
+    EXPECT_EQ(bb.get<int>("name", 7), 7);     // wrong type: default, no throw
+    EXPECT_EQ(bb.get<int>("health", 7), 7);   // slot holds a float
+    EXPECT_TRUE(bb.has("name"));
+    
+    bb.remove("health");
+    EXPECT_FALSE(bb.has(health));
+    EXPECT_NEAR(bb.get(health), 100.0f, 1e-6f);
+    bb.remove(target);
+    EXPECT_FALSE(bb.has("target"));
+    
+    // Keys added later are picked up by existing blackboards
+    BBKey<int> ammo = schema.add<int>("ammo", 30);
+    EXPECT_EQ(bb.get(ammo), 30);
+    bb.set(ammo, 12);
+    EXPECT_EQ(bb.get(ammo), 12);
+    
+    bb.clear();
+    EXPECT_FALSE(bb.has(ammo));
+    EXPECT_FALSE(bb.has("name"));
+    EXPECT_EQ(bb.get(ammo), 30);
+    
+    // Invalid keys are ignored
+    bb.set(BBKey<int>(), 5);
+    EXPECT_EQ(bb.get(BBKey<int>()), 0);
+    return true;
+}
+
+// Node mix covering every compiled node type
+inline std::unique_ptr<BTNode> buildTestTree() {
+    auto bump = [](const char* key, int every) {
+        return [key, every](BTContext& ctx) {
+            int n = ctx.blackboard->get<int>(key) + 1;
+            ctx.blackboard->set(key, n);
+            return n % every == 0 ? BTStatus::Success : BTStatus::Running;
+        };
+    };
+    return BTBuilder()
+        .sequence("Root")
+            .selector()
+                .sequence()
+                    .condition(BTActions::checkBool("alert"))
+                    .action(bump("attack", 3))
+                .end()
+                .repeater(2)
+                    .action(bump("patrol", 1))
+                .end()
+            .end()
+            .parallel(BTParallel::Policy::RequireAll, BTParallel::Policy::RequireOne)
+                .wait(0.1f)
+                .action(bump("scan", 1))
+            .end()
+            .inverter()
+                .condition(BTActions::checkBool("retreat"))
+            .end()
+        .build();
+}
+
+inline bool testCompiledBehaviorTree() {
+    // Compiled and node-based trees agree tick by tick
+    BehaviorTree tree;
+    tree.setRoot(buildTestTree());
+    CompiledBehaviorTree compiled;
+    EXPECT_TRUE(compiled.compile(tree.getRoot()));
+    EXPECT_EQ(compiled.getNodeCount(), (size_t)12);
+    
+    Blackboard bb;
+    std::vector<BTNodeState> state(compiled.getNodeCount());
+    BTContext context;
+    context.blackboard = &bb;
+    context.deltaTime = 0.05f;
+    for (int i = 0; i < 40; i++) {
+        bool alert = i >= 10 && i < 25, retreat = i % 7 == 6;
+        tree.getBlackboard().set("alert", alert);
+        tree.getBlackboard().set("retreat", retreat);
+        bb.set("alert", alert);
+        bb.set("retreat", retreat);
+        EXPECT_EQ(compiled.tick(state.data(), context), tree.tick(0.05f));
+    }
+    for (const char* key : {"attack", "patrol", "scan"}) {
+        EXPECT_EQ(bb.get<int>(key), tree.getBlackboard().get<int>(key));
+    }
+    EXPECT_TRUE(bb.get<int>("attack") > 0);
+    
+    // Limiter counts survive ticks until reset
+    CompiledBehaviorTree limited;
+    auto limiterRoot = std::make_unique<BTLimiter>(2);
+    limiterRoot->addChild(std::make_unique<BTLog>("hi"));
+    EXPECT_TRUE(limited.compile(limiterRoot.get()));
+    std::vector<BTNodeState> limiterState(limited.getNodeCount());
+    EXPECT_EQ(limited.tick(limiterState.data(), context), BTStatus::Success);
+    EXPECT_EQ(limited.tick(limiterState.data(), context), BTStatus::Success);
+    EXPECT_EQ(limited.tick(limiterState.data(), context), BTStatus::Failure);
+    limited.reset(limiterState.data());
+    EXPECT_EQ(limited.tick(limiterState.data(), context), BTStatus::Success);
+    
+    // Custom node classes are rejected
+    struct CustomNode : BTNode {
+        CustomNode() : BTNode(BTNodeType::Custom, "Custom") {}
+        BTStatus update(BTContext&) override { return BTStatus::Success; }
+    };
+    auto custom = BTBuilder().sequence().build();
+    custom->addChild(std::make_unique<CustomNode>());
+    EXPECT_FALSE(limited.compile(custom.get()));
+    EXPECT_FALSE(limited.getLastError().empty());
+    EXPECT_TRUE(limited.empty());
+    
+    // Many agents share one tree; interned keys need no string lookups
+    BlackboardSchema schema;
+    BBKey<Vec3> target = schema.add<Vec3>("target");
+    CompiledBehaviorTree chase;
+    EXPECT_TRUE(chase.compile(BTBuilder()
+        .selector()
+            .sequence()
+                .condition(BTActions::inRange(target, 5.0f))
+                .action(BTActions::moveTo(target))
+            .end()
+            .wait(0.95f)
+        .build().get()));
+    std::vector<Blackboard> blackboards(64, Blackboard(&schema));
+    BTAgentGroup group(&chase);
+    for (size_t i = 0; i < blackboards.size(); i++) {
+        blackboards[i].set(target, Vec3(i % 2 ? 3.0f : 30.0f, 0.0f, 0.0f));
+        EXPECT_EQ(group.addAgent(&blackboards[i]), i);
+    }
+    group.tick(0.1f);
+    for (size_t i = 0; i < group.getAgentCount(); i++) {
+        EXPECT_EQ(group.getStatus(i), BTStatus::Running);   // moving or waiting
+    }
+    group.getContext(1).ownerPosition = Vec3(3.0f, 0.0f, 0.0f);
+    group.tick(0.1f);
+    EXPECT_EQ(group.getStatus(1), BTStatus::Success);
+    EXPECT_EQ(group.getStatus(3), BTStatus::Running);
+    for (int i = 0; i < 8; i++) group.tick(0.1f);
+    EXPECT_EQ(group.getStatus(0), BTStatus::Success);        // waited 10 ticks
+    group.removeAgent(0);
+    EXPECT_EQ(group.getAgentCount(), (size_t)63);
+    EXPECT_TRUE(group.getContext(0).blackboard == &blackboards[63]);
+    return true;
+}
+
+}  // namespace BehaviorTreeTests
+
+namespace VisualScriptTests {
+
+inline bool link(VisualScriptGraph& graph, VisualScriptNode* from, const char* out, VisualScriptNode* to, const char* in) {
+    return graph.createLink(from->id, from->findOutputByName(out)->id, to->id, to->findInputByName(in)->id);
+}
+
+inline VisualScriptNode* variableNode(VisualScriptGraph& graph, const char* type, const char* variable) {
+    VisualScriptNode* node = graph.createNode(type);
+    node->properties["VariableName"] = std::string(variable);
+    return node;
+}
+
+inline bool testBytecodeVM() {
+    VisualScriptGraph graph;
+    graph.addVariable("Counter", PinType::Int);
+    graph.addVariable("Total", PinType::Float);
+    
+    // OnStart: Counter = 5
+    auto* start = graph.createNode("OnStart");
+    auto* setCounter = variableNode(graph, "SetVariable", "Counter");
+    setCounter->findInputByName("Value")->defaultValue = 5;
+    EXPECT_TRUE(link(graph, start, "Exec", setCounter, "Exec"));
+    
+    // OnUpdate: for i in 1..4: Total += i * dt; then Total > 5 ? SetPosition(Total, 2*3, 0) : Print
+    auto* update = graph.createNode("OnUpdate");
+    auto* loop = graph.createNode("ForLoop");
+    loop->findInputByName("Start")->defaultValue = 1;
+    loop->findInputByName("End")->defaultValue = 4;
+    auto* getTotal = variableNode(graph, "GetVariable", "Total");
+    auto* mul = graph.createNode("Multiply");
+    auto* add = graph.createNode("Add");
+    auto* setTotal = variableNode(graph, "SetVariable", "Total");
+    auto* compare = graph.createNode("Compare");
+    compare->findInputByName("B")->defaultValue = 5.0f;
+    auto* branch = graph.createNode("Branch");
+    auto* six = graph.createNode("Multiply");
+    six->findInputByName("A")->defaultValue = 2.0f;
+    six->findInputByName("B")->defaultValue = 3.0f;
+    auto* make = graph.createNode("MakeVec3");
+    auto* setPosition = graph.createNode("SetPosition");
+    auto* print = graph.createNode("Print");
+    print->findInputByName("Message")->defaultValue = std::string("low");
+    EXPECT_TRUE(link(graph, update, "Exec", loop, "Exec"));
+    EXPECT_TRUE(link(graph, loop, "Index", mul, "A"));              // Int -> Float
+    EXPECT_TRUE(link(graph, update, "DeltaTime", mul, "B"));
+    EXPECT_TRUE(link(graph, getTotal, "Value", add, "A"));
+    EXPECT_TRUE(link(graph, mul, "Result", add, "B"));
+    EXPECT_TRUE(link(graph, add, "Result", setTotal, "Value"));
+    EXPECT_TRUE(link(graph, loop, "Loop Body", setTotal, "Exec"));
+    EXPECT_TRUE(link(graph, getTotal, "Value", compare, "A"));
+    EXPECT_TRUE(link(graph, compare, ">", branch, "Condition"));
+    EXPECT_TRUE(link(graph, loop, "Completed", branch, "Exec"));
+    EXPECT_TRUE(link(graph, getTotal, "Value", make, "X"));
+    EXPECT_TRUE(link(graph, six, "Result", make, "Y"));
+    EXPECT_TRUE(link(graph, make, "Vector", setPosition, "Position"));
+    EXPECT_TRUE(link(graph, branch, "True", setPosition, "Exec"));
+    EXPECT_TRUE(link(graph, branch, "False", print, "Exec"));
+    
+    // OnCollision: Other.rotation = self.rotation; rotate self by a constant Euler
+    auto* collision = graph.createNode("OnCollision");
+    auto* getRotation = graph.createNode("GetRotation");
+    auto* setRotation = graph.createNode("SetRotation");
+    auto* rotate = graph.createNode("Rotate");
+    rotate->findInputByName("Euler")->defaultValue = Vec3(0.0f, 1.5f, 0.0f);
+    EXPECT_TRUE(link(graph, collision, "Exec", setRotation, "Exec"));
+    EXPECT_TRUE(link(graph, collision, "Other", setRotation, "Object"));
+    EXPECT_TRUE(link(graph, getRotation, "Rotation", setRotation, "Rotation"));
+    EXPECT_TRUE(link(graph, setRotation, "Exec", rotate, "Exec"));
+    
+    // Not reachable from any event
+    auto* orphan = graph.createNode("Add");
+    auto* orphanPrint = graph.createNode("Print");
+    EXPECT_TRUE(orphan && orphanPrint);
+    
+    VisualScriptProgram program;
+    EXPECT_TRUE(program.compile(graph));
+    EXPECT_EQ(program.getStats().deadNodes, 2u);
+    EXPECT_TRUE(program.getStats().foldedNodes >= 1u);
+    size_t muls = 0;
+    for (const auto& in : program.getCode()) {
+        // Constant Euler folded to a quaternion; GetRotation -> SetRotation never leaves Quat
+        EXPECT_TRUE(in.op != VSOp::EulerToQuat && in.op != VSOp::QuatToEuler);
+        muls += in.op == VSOp::MulF;
+    }
+    EXPECT_EQ(muls, (size_t)1);   // 2 * 3 folded
+    
+    uint64_t positionObject = 0, rotationObject = 0;
+    Vec3 position;
+    Quat rotation, rotated;
+    int prints = 0;
+    VisualScriptBindings host;
+    host.setPosition = [&](uint64_t id, const Vec3& p) { positionObject = id; position = p; };
+    host.getRotation = [](uint64_t) { return Quat(0.0f, 0.6f, 0.0f, 0.8f); };
+    host.setRotation = [&](uint64_t id, const Quat& q) { rotationObject = id; rotation = q; };
+    host.rotate = [&](uint64_t, const Quat& q) { rotated = q; };
+    host.print = [&](const std::string& message) { prints += message == "low"; };
+    
+    VisualScriptVM vm(&program), other(&program);
+    vm.setBindings(&host);
+    vm.setSelf(7);
+    EXPECT_TRUE(vm.onStart());
+    PinValue value;
+    EXPECT_TRUE(vm.getVariable("Counter", value));
+    EXPECT_EQ(std::get<int>(value), 5);
+    
+    EXPECT_TRUE(vm.onUpdate(0.5f));                 // Total = 5, not > 5
+    EXPECT_EQ(prints, 1);
+    EXPECT_EQ(positionObject, 0u);
+    EXPECT_TRUE(vm.onUpdate(0.5f));                 // Total = 10
+    EXPECT_EQ(positionObject, 7u);
+    EXPECT_NEAR(position.x, 10.0f, 1e-5f);
+    EXPECT_NEAR(position.y, 6.0f, 1e-5f);
+    EXPECT_TRUE(other.getVariable("Total", value));
+    EXPECT_NEAR(std::get<float>(value), 0.0f, 1e-6f);   // registers are per VM
+    
+    EXPECT_TRUE(vm.onCollision(99));
+    EXPECT_EQ(rotationObject, 99u);
+    EXPECT_NEAR(rotation.y, 0.6f, 1e-6f);
+    Quat expected = Quat::fromEuler(0.0f, 1.5f, 0.0f);
+    EXPECT_NEAR(rotated.y, expected.y, 1e-6f);
+    EXPECT_NEAR(rotated.w, expected.w, 1e-6f);
+    EXPECT_TRUE(vm.getExecutedInstructions() > 0);
+    
+    vm.reset();
+    EXPECT_TRUE(vm.getVariable("Total", value));
+    EXPECT_NEAR(std::get<float>(value), 0.0f, 1e-6f);
+    EXPECT_TRUE(vm.setVariable("Total", 4.0f));
+    EXPECT_FALSE(vm.setVariable("Total", std::string("x")));
+    EXPECT_FALSE(vm.setVariable("Missing", 1.0f));
+    return true;
+}
+
+inline bool testBytecodeErrors() {
+    // Endless while loop stops at the iteration cap
+    VisualScriptGraph graph;
+    auto* start = graph.createNode("OnStart");
+    auto* loop = graph.createNode("WhileLoop");
+    loop->findInputByName("Condition")->defaultValue = true;
+    auto* print = graph.createNode("Print");
+    EXPECT_TRUE(link(graph, start, "Exec", loop, "Exec"));
+    EXPECT_TRUE(link(graph, loop, "Loop Body", print, "Exec"));
+    
+    VisualScriptCompileOptions options;
+    options.maxLoopIterations = 50;
+    VisualScriptProgram program;
+    EXPECT_TRUE(program.compile(graph, options));
+    int prints = 0;
+    VisualScriptBindings host;
+    host.print = [&](const std::string&) { prints++; };
+    VisualScriptVM vm(&program);
+    vm.setBindings(&host);
+    EXPECT_FALSE(vm.onStart());
+    EXPECT_FALSE(vm.getLastError().empty());
+    EXPECT_EQ(prints, 50);
+    EXPECT_TRUE(vm.onUpdate(0.1f));                 // no handler: nothing to do
+    
+    // Unknown variables and execution cycles are compile errors
+    auto* set = variableNode(graph, "SetVariable", "Missing");
+    EXPECT_TRUE(link(graph, print, "Exec", set, "Exec"));
+    EXPECT_FALSE(program.compile(graph, options));
+    EXPECT_FALSE(program.getLastError().empty());
+    EXPECT_TRUE(program.empty());
+    
+    graph.addVariable("Missing", PinType::Float);
+    EXPECT_TRUE(program.compile(graph, options));
+    // createLink keeps one link per input, so a cycle has to be written directly
+    Link back;
+    back.id = graph.nextLinkId++;
+    back.fromNode = set->id;
+    back.fromPin = set->findOutputByName("Exec")->id;
+    back.toNode = print->id;
+    back.toPin = print->findInputByName("Exec")->id;
+    graph.links.push_back(back);
+    EXPECT_FALSE(program.compile(graph, options));
+    return true;
+}
+
+// Second flow link into an input that already has one (createLink would replace it)
+inline void mergeLink(VisualScriptGraph& graph, VisualScriptNode* from, const char* out, VisualScriptNode* to) {
+    Link merge;
+    merge.id = graph.nextLinkId++;
+    merge.fromNode = from->id;
+    merge.fromPin = from->findOutputByName(out)->id;
+    merge.toNode = to->id;
+    merge.toPin = to->findInputByName("Exec")->id;
+    graph.links.push_back(merge);
+}
+
+inline bool testBytecodeConvergingFlow() {
+    // 20 chained diamonds: Branch -> Print "a" / Print "b" -> next Branch
+    constexpr int kStages = 20;
+    VisualScriptGraph graph;
+    graph.addVariable("Flag", PinType::Bool);
+    auto* start = graph.createNode("OnStart");
+    VisualScriptNode* tails[2] = {start, nullptr};
+    for (int stage = 0; stage < kStages; stage++) {
+        auto* branch = graph.createNode("Branch");
+        auto* flag = variableNode(graph, "GetVariable", "Flag");
+        EXPECT_TRUE(link(graph, flag, "Value", branch, "Condition"));
+        if (stage == 0) {
+            EXPECT_TRUE(link(graph, start, "Exec", branch, "Exec"));
+        } else {
+            EXPECT_TRUE(link(graph, tails[0], "Exec", branch, "Exec"));
+            mergeLink(graph, tails[1], "Exec", branch);
+        }
+        auto* a = graph.createNode("Print");
+        auto* b = graph.createNode("Print");
+        a->findInputByName("Message")->defaultValue = std::string("a");
+        b->findInputByName("Message")->defaultValue = std::string("b");
+        EXPECT_TRUE(link(graph, branch, "True", a, "Exec"));
+        EXPECT_TRUE(link(graph, branch, "False", b, "Exec"));
+        tails[0] = a;
+        tails[1] = b;
+    }
+    
+    // Both Sequence steps reach the same Print: it still runs twice
+    auto* update = graph.createNode("OnUpdate");
+    auto* sequence = graph.createNode("Sequence");
+    auto* twice = graph.createNode("Print");
+    twice->findInputByName("Message")->defaultValue = std::string("twice");
+    EXPECT_TRUE(link(graph, update, "Exec", sequence, "Exec"));
+    EXPECT_TRUE(link(graph, sequence, "Then 0", twice, "Exec"));
+    mergeLink(graph, sequence, "Then 1", twice);
+    
+    VisualScriptProgram program;
+    EXPECT_TRUE(program.compile(graph));
+    EXPECT_TRUE(program.getCode().size() < (size_t)kStages * 10);   // linear, not 2^stages
+    
+    int as = 0, bs = 0, twices = 0;
+    VisualScriptBindings host;
+    host.print = [&](const std::string& message) {
+        as += message == "a";
+        bs += message == "b";
+        twices += message == "twice";
+    };
+    VisualScriptVM vm(&program);
+    vm.setBindings(&host);
+    EXPECT_TRUE(vm.onStart());
+    EXPECT_EQ(as, 0);
+    EXPECT_EQ(bs, kStages);
+    EXPECT_TRUE(vm.setVariable("Flag", true));
+    EXPECT_TRUE(vm.onStart());
+    EXPECT_EQ(as, kStages);
+    EXPECT_TRUE(vm.onUpdate(0.1f));
+    EXPECT_EQ(twices, 2);
+    
+    // ForLoop End is read once, even when the body assigns its variable
+    VisualScriptGraph loopGraph;
+    loopGraph.addVariable("Count", PinType::Int);
+    auto* loopStart = loopGraph.createNode("OnStart");
+    auto* setCount = variableNode(loopGraph, "SetVariable", "Count");
+    setCount->findInputByName("Value")->defaultValue = 3;
+    auto* loop = loopGraph.createNode("ForLoop");
+    loop->findInputByName("Start")->defaultValue = 1;
+    auto* count = variableNode(loopGraph, "GetVariable", "Count");
+    auto* body = loopGraph.createNode("Print");
+    auto* grow = variableNode(loopGraph, "SetVariable", "Count");
+    grow->findInputByName("Value")->defaultValue = 10;
+    EXPECT_TRUE(link(loopGraph, loopStart, "Exec", setCount, "Exec"));
+    EXPECT_TRUE(link(loopGraph, setCount, "Exec", loop, "Exec"));
+    EXPECT_TRUE(link(loopGraph, count, "Value", loop, "End"));
+    EXPECT_TRUE(link(loopGraph, loop, "Loop Body", body, "Exec"));
+    EXPECT_TRUE(link(loopGraph, body, "Exec", grow, "Exec"));
+    EXPECT_TRUE(program.compile(loopGraph));
+    int iterations = 0;
+    host.print = [&](const std::string&) { iterations++; };
+    VisualScriptVM loopVM(&program);
+    loopVM.setBindings(&host);
+    EXPECT_TRUE(loopVM.onStart());
+    EXPECT_EQ(iterations, 3);
+    return true;
+}
+
+}  // namespace VisualScriptTests
+
+// ===== Game UI Batch Renderer Tests =====
+namespace GameUITests {
+
+inline bool testBatchedGeometry() {
+    ui::UICanvas canvas("HUD");
+    canvas.setScreenSize(800, 600);
+    
+    auto panel = std::make_shared<ui::UIPanel>();
+    panel->setRect({10, 10, 200, 100});
+    panel->setCornerRadius(8.0f);
+    auto label = std::make_shared<ui::UILabel>("Hello");
+    label->setRect({0, 0, 200, 30});
+    panel->addChild(label);
+    auto icon = std::make_shared<ui::UIImage>();
+    icon->setRect({220, 10, 32, 32});
+    icon->setTextureHandle(7);
+    auto footer = std::make_shared<ui::UIPanel>();
+    footer->setRect({10, 120, 200, 20});
+    footer->setBorderWidth(0.0f);
+    footer->setCornerRadius(0.0f);
+    canvas.addWidget(panel);
+    canvas.addWidget(icon);
+    canvas.addWidget(footer);
+    canvas.update(0.0f);
+    
+    // Panel + label share the atlas; the image splits the stream
+    ui::UIBatchRenderer renderer;
+    const ui::UIDrawList& list = renderer.renderCanvas(canvas);
+    EXPECT_EQ(renderer.getStats().widgetsRebuilt, 4u);
+    EXPECT_EQ(renderer.getStats().drawCalls, 3u);
+    EXPECT_EQ(list.batches[1].texture, (uint64_t)7);
+    EXPECT_EQ(list.batches[1].indexCount, 6u);
+    EXPECT_EQ(list.indices.size(), list.vertices.size() / 4 * 6);
+    uint32_t indexed = 0;
+    for (const auto& batch : list.batches) {
+        EXPECT_EQ(batch.firstIndex, indexed);
+        indexed += batch.indexCount;
+    }
+    EXPECT_EQ(indexed, (uint32_t)list.indices.size());
+    EXPECT_EQ(renderer.getStats().textRunsShaped, 1u);
+    EXPECT_EQ(renderer.getStats().glyphsRasterized, 4u);   // H e l o
+    size_t vertexCount = list.vertices.size();
+    
+    // Idle frame reuses everything
+    canvas.update(0.0f);
+    renderer.renderCanvas(canvas);
+    EXPECT_EQ(renderer.getStats().widgetsRebuilt, 0u);
+    EXPECT_EQ(renderer.getStats().canvasesRestitched, 0u);
+    EXPECT_EQ(renderer.getStats().drawCalls, 3u);
+    
+    // Same glyph count: only the label is rebuilt and patched in place
+    label->setText("World");
+    canvas.update(0.0f);
+    renderer.renderCanvas(canvas);
+    EXPECT_EQ(renderer.getStats().widgetsRebuilt, 1u);
+    EXPECT_EQ(renderer.getStats().widgetsPatched, 1u);
+    EXPECT_EQ(renderer.getStats().canvasesRestitched, 0u);
+    EXPECT_EQ(list.vertices.size(), vertexCount);
+    
+    // Switching back hits the text run cache
+    label->setText("Hello");
+    canvas.update(0.0f);
+    renderer.renderCanvas(canvas);
+    EXPECT_EQ(renderer.getStats().textRunHits, 1u);
+    EXPECT_EQ(renderer.getStats().textRunsShaped, 0u);
+    EXPECT_EQ(renderer.getStats().glyphsRasterized, 0u);
+    
+    // Moving a widget rebuilds just that widget
+    footer->setPosition(10, 130);
+    canvas.update(0.0f);
+    renderer.renderCanvas(canvas);
+    EXPECT_EQ(renderer.getStats().widgetsRebuilt, 1u);
+    EXPECT_NEAR(list.vertices.back().y, 150.0f, 0.001f);
+    
+    // Longer text changes the batch layout and restitches
+    label->setText("Hello!");
+    canvas.update(0.0f);
+    renderer.renderCanvas(canvas);
+    EXPECT_EQ(renderer.getStats().canvasesRestitched, 1u);
+    EXPECT_EQ(list.vertices.size(), vertexCount + 4);
+    
+    // Hiding the image lets the neighbouring atlas batches merge
+    icon->setVisible(false);
+    canvas.update(0.0f);
+    renderer.renderCanvas(canvas);
+    EXPECT_EQ(renderer.getStats().drawCalls, 1u);
+    EXPECT_EQ(renderer.getStats().widgetsRebuilt, 0u);
+    
+    // An atlas too small for the text is cleared and retried once, then reports it
+    ui::UIBatchRenderer tiny(nullptr, 128);
+    std::string many;
+    for (int c = 33; c < 127; c++) many += (char)c;
+    auto big = std::make_shared<ui::UILabel>(many);
+    big->setFontSize(32.0f);
+    ui::UICanvas other("Other");
+    other.addWidget(big);
+    other.update(0.0f);
+    tiny.renderCanvas(other);
+    EXPECT_FALSE(tiny.getLastError().empty());
+    EXPECT_TRUE(tiny.getAtlas().getGeneration() > 1);
+    return true;
+}
+
+inline bool testBatchedClipping() {
+    auto& system = ui::getUISystem();
+    ui::UICanvas* back = system.createCanvas("BatchTestBack");
+    ui::UICanvas* front = system.createCanvas("BatchTestFront");
+    front->setRenderOrder(1);
+    back->setRenderOrder(2);
+    
+    auto scroll = std::make_shared<ui::UIScrollView>();
+    scroll->setRect({300, 300, 100, 100});
+    scroll->setContentSize(100, 400);
+    auto inside = std::make_shared<ui::UIPanel>();
+    inside->setRect({0, 0, 100, 50});
+    auto below = std::make_shared<ui::UIPanel>();
+    below->setRect({0, 200, 100, 50});
+    scroll->addContentChild(inside);
+    scroll->addContentChild(below);
+    back->addWidget(scroll);
+    front->addWidget(std::make_shared<ui::UIPanel>());
+    system.update(0.0f);
+    
+    ui::UIBatchRenderer renderer;
+    renderer.render(system);
+    EXPECT_EQ(renderer.getDrawLists().size(), system.getSortedCanvases().size());
+    EXPECT_TRUE(system.getSortedCanvases().back() == back);
+    const ui::UIDrawList* list = renderer.getDrawList(back);
+    EXPECT_TRUE(list != nullptr);
+    EXPECT_EQ(list->batches.size(), (size_t)1);
+    EXPECT_NEAR(list->batches[0].clip.y, 300.0f, 0.001f);
+    EXPECT_NEAR(list->batches[0].clip.height, 100.0f, 0.001f);
+    size_t visibleQuads = list->vertices.size() / 4;
+    
+    // Scrolling brings the second panel in and the first out
+    scroll->setScroll(0, 180);
+    system.update(0.0f);
+    renderer.render(system);
+    EXPECT_EQ(list->vertices.size() / 4, visibleQuads);
+    EXPECT_NEAR(list->vertices.front().y, 320.0f, 0.001f);
+    
+    // Render order changes re-sort the canvas list
+    back->setRenderOrder(0);
+    EXPECT_TRUE(system.getSortedCanvases().back() == front);
+    renderer.render(system);
+    EXPECT_TRUE(renderer.getDrawLists().back() == renderer.getDrawList(front));
+    
+    system.removeCanvas("BatchTestBack");
+    system.removeCanvas("BatchTestFront");
+    renderer.render(system);
+    EXPECT_TRUE(renderer.getDrawList(back) == nullptr);
+    return true;
+}
+
+}  // namespace GameUITests
+
 // ===== Register All Tests =====
 inline void registerAllTests(UnitTestRunner& runner) {
     // Math Tests
@@ -739,6 +3952,7 @@ inline void registerAllTests(UnitTestRunner& runner) {
     runner.addTest("Animation", "Animator Playback", AnimationTests::testAnimatorPlayback);
     runner.addTest("Animation", "BlendTree 1D", AnimationTests::testBlendTree1D);
     runner.addTest("Animation", "State Machine", AnimationTests::testStateMachine);
+    runner.addTest("Animation", "Compiled State Machine", AnimationTests::testCompiledStateMachine);
     runner.addTest("Animation", "Animation Layer", AnimationTests::testAnimationLayer);
     runner.addTest("Animation", "Bone Mask", AnimationTests::testBoneMask);
     
@@ -752,6 +3966,8 @@ inline void registerAllTests(UnitTestRunner& runner) {
     runner.addTest("Rendering", "CSM Cascades", RenderingTests::testCSMCascades);
     runner.addTest("Rendering", "PCSS Samples", RenderingTests::testPCSSSamples);
     runner.addTest("Rendering", "Volumetric Fog", RenderingTests::testVolumetricFogDensity);
+    runner.addTest("Rendering", "Software Rasterizer", RenderingTests::testSoftwareRasterizer);
+    runner.addTest("Rendering", "Scene Culler", RenderingTests::testSceneCuller);
     
     // IK Tests
     runner.addTest("IK", "Two-Bone IK", IKTests::testTwoBoneIK);
@@ -762,6 +3978,59 @@ inline void registerAllTests(UnitTestRunner& runner) {
     runner.addTest("Timeline", "Animation Curve", TimelineTests::testAnimationCurve);
     runner.addTest("Timeline", "Timeline Playback", TimelineTests::testTimeline);
     runner.addTest("Timeline", "Timeline Markers", TimelineTests::testTimelineMarkers);
+    
+    // Util Tests
+    runner.addTest("Util", "FileWatcher Batching", UtilTests::testFileWatcherBatching);
+    runner.addTest("Util", "FileWatcher Delete/Recreate", UtilTests::testFileWatcherDeleteRecreate);
+    runner.addTest("Util", "FileWatcher Overflow", UtilTests::testFileWatcherOverflow);
+    runner.addTest("Util", "Async Logger", UtilTests::testAsyncLogger);
+    
+    // Asset Tests
+    runner.addTest("Asset", "Texture Cache Dedup", AssetTests::testTextureCacheDedup);
+    runner.addTest("Asset", "Texture Cooking", AssetTests::testTextureCooking);
+    runner.addTest("Asset", "Texture Streaming", AssetTests::testTextureStreaming);
+    runner.addTest("Asset", "Texture Hot Reload", AssetTests::testTextureHotReload);
+    
+    // Audio Tests
+    runner.addTest("Audio", "Resampling Mixer", AudioTests::testResamplingMixer);
+    runner.addTest("Audio", "Voice Virtualization", AudioTests::testVoiceVirtualization);
+    runner.addTest("Audio", "Finish Under Load", AudioTests::testFinishUnderLoad);
+    runner.addTest("Audio", "Streaming Clip", AudioTests::testStreamingClip);
+    runner.addTest("Audio", "Spectrum Analysis", AudioTests::testSpectrumAnalysis);
+    
+    // AI Tests
+    runner.addTest("AI", "Tensor Runtime", AITests::testTensorRuntime);
+    
+    // Character Tests
+    runner.addTest("Character", "Skin Deformer", CharacterTests::testSkinDeformer);
+    runner.addTest("Character", "MakeHuman Target Pack", CharacterTests::testMakeHumanTargetPack);
+    runner.addTest("Character", "Auto Rig Acceleration", CharacterTests::testAutoRigAcceleration);
+    
+    // Network Tests
+    runner.addTest("Network", "Reliable Connection", NetworkTests::testReliableConnection);
+    runner.addTest("Network", "UDP Reliability Loopback", NetworkTests::testUdpReliability);
+    runner.addTest("Network", "Bit-Packed Message", NetworkTests::testBitPackedMessage);
+    runner.addTest("Network", "Snapshot Replication", NetworkTests::testReplication);
+    
+    // Navigation Tests
+    runner.addTest("Navigation", "Crowd Avoidance", NavigationTests::testCrowdAvoidance);
+    runner.addTest("Navigation", "Crowd Path Budget", NavigationTests::testCrowdPathBudget);
+    runner.addTest("Navigation", "NavAgentManager Avoidance", NavigationTests::testNavAgentManagerAvoidance);
+    runner.addTest("Navigation", "Path Queries", NavigationTests::testPathQueries);
+    runner.addTest("Navigation", "Tiled NavMesh", NavigationTests::testTiledNavMesh);
+    
+    // Behavior Tree Tests
+    runner.addTest("AI", "Blackboard Keys", BehaviorTreeTests::testBlackboardKeys);
+    runner.addTest("AI", "Compiled Behavior Tree", BehaviorTreeTests::testCompiledBehaviorTree);
+    
+    // Visual Script Tests
+    runner.addTest("Script", "Visual Script Bytecode", VisualScriptTests::testBytecodeVM);
+    runner.addTest("Script", "Visual Script Errors", VisualScriptTests::testBytecodeErrors);
+    runner.addTest("Script", "Visual Script Converging Flow", VisualScriptTests::testBytecodeConvergingFlow);
+    
+    // Game UI Tests
+    runner.addTest("GameUI", "Batched Geometry", GameUITests::testBatchedGeometry);
+    runner.addTest("GameUI", "Batched Clipping", GameUITests::testBatchedClipping);
 }
 
 // ===== Run All Unit Tests =====
@@ -0,0 +1,28 @@
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+#include "engine/character/makehuman_integration.h"
+
+namespace fs = std::filesystem;
+
+// Converts a MakeHuman targets/ directory into targets.mhpack
+// usage: luma_mhpack [targets_dir] [output.mhpack]
+int main(int argc, char** argv) {
+    const fs::path targetDir = (argc > 1) ? fs::path(argv[1]) : fs::path("assets/makehuman/targets");
+    const fs::path packPath = (argc > 2) ? fs::path(argv[2]) : targetDir.parent_path() / "targets.mhpack";
+
+    auto start = std::chrono::steady_clock::now();
+    std::string error;
+    size_t count = 0;
+    if (!luma::MakeHumanTargetPack::build(targetDir.string(), packPath.string(), &error, &count)) {
+        std::cerr << "mhpack: " << error << "\n";
+        return 1;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Packed " << count << " targets into " << packPath << " ("
+              << fs::file_size(packPath) / 1024 << " KB, " << (int)ms << " ms)\n";
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+#include "engine/asset/model_loader.h"
+#include "engine/renderer/rhi/software_backend.h"
+
+namespace fs = std::filesystem;
+
+// Renders a PNG thumbnail for every model in a directory on the CPU
+// usage: luma_thumbnails [models_dir] [output_dir] [size]
+int main(int argc, char** argv) {
+    const fs::path modelDir = (argc > 1) ? fs::path(argv[1]) : fs::path("assets/models");
+    const fs::path outDir = (argc > 2) ? fs::path(argv[2]) : fs::path("thumbnails");
+    const uint32_t size = (argc > 3) ? (uint32_t)std::max(16, std::atoi(argv[3])) : 256;
+
+    const auto extensions = luma::get_supported_extensions();
+    std::vector<fs::path> models;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(modelDir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file()) continue;
+        const std::string ext = it->path().extension().string();
+        if (std::find(extensions.begin(), extensions.end(), ext) != extensions.end()) models.push_back(it->path());
+    }
+    std::sort(models.begin(), models.end());
+    if (models.empty()) {
+        std::cerr << "thumbnails: no models under " << modelDir << "\n";
+        return 1;
+    }
+    fs::create_directories(outDir);
+
+    luma::rhi::NativeWindow window;
+    window.width = size;
+    window.height = size;
+    luma::rhi::SoftwareBackend backend(window);
+    backend.set_clear_color(0.16f, 0.16f, 0.18f);
+
+    std::vector<uint8_t> rgba;
+    double renderMs = 0.0;
+    size_t written = 0;
+    for (const auto& path : models) {
+        auto model = luma::load_model(path.string());
+        if (!model || model->meshes.empty()) {
+            std::cerr << "thumbnails: failed to load " << path << "\n";
+            continue;
+        }
+        const luma::Vec3 lo(model->minBounds[0], model->minBounds[1], model->minBounds[2]);
+        const luma::Vec3 hi(model->maxBounds[0], model->maxBounds[1], model->maxBounds[2]);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<luma::rhi::SoftwareMesh> meshes;
+        for (const auto& mesh : model->meshes) meshes.push_back(backend.create_mesh(mesh));
+        backend.begin_scene(0.0f);
+        backend.frame_bounds((lo + hi) * 0.5f, std::max((hi - lo).length() * 0.5f, 1e-3f));
+        for (const auto& mesh : meshes) backend.draw_mesh(mesh, luma::Mat4::identity());
+        backend.end_scene();
+        renderMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        backend.read_pixels(rgba);
+        const fs::path out = outDir / (path.stem().string() + ".png");
+        if (!stbi_write_png(out.string().c_str(), (int)size, (int)size, 4, rgba.data(), (int)size * 4)) {
+            std::cerr << "thumbnails: failed to write " << out << "\n";
+            continue;
+        }
+        written++;
+    }
+
+    std::cout << "Rendered " << written << " thumbnails (" << size << "x" << size << ") on "
+              << backend.thread_count() << " threads, "
+              << (renderMs > 0.0 ? written * 1000.0 / renderMs : 0.0) << " thumbnails/s excluding load\n";
+    return written == models.size() ? 0 : 1;
+}